@@ -583,6 +583,84 @@ static tb_void_t tb_hash_map_test_walk_perf()
     // exit
     tb_hash_map_exit(hash);
 }
+static tb_size_t tb_hash_map_test_resize_percent(tb_size_t const* histogram, tb_size_t maxn, tb_size_t count, tb_size_t percent)
+{
+    tb_size_t i;
+    tb_size_t n = 0;
+    tb_size_t need = (tb_size_t)(((tb_hize_t)count * percent + 9999) / 10000);
+    for (i = 0; i < maxn; i++)
+    {
+        n += histogram[i];
+        if (n >= need) break;
+    }
+    return i;
+}
+static tb_void_t tb_hash_map_test_resize_perf(tb_char_t const* name, tb_size_t load_factor, tb_bool_t reserve)
+{
+    // the item count and the batch count for measuring latency, we measure 32 insertions at once
+    tb_size_t const count = 1 << 20;
+    tb_size_t const batch = 32;
+    tb_size_t const maxn = 1 << 16;
+
+    // init histogram of the batch latency, us
+    tb_size_t* histogram = tb_nalloc0_type(maxn, tb_size_t);
+    tb_assert_and_check_return(histogram);
+
+    // init hash
+    tb_hash_map_ref_t hash = tb_hash_map_init(0, tb_element_long(), tb_element_long());
+    if (hash)
+    {
+        // init load factor
+        tb_hash_map_load_factor_set(hash, load_factor);
+        if (reserve) tb_hash_map_reserve(hash, count);
+
+        // insert items
+        tb_size_t i = 0;
+        tb_size_t j = 0;
+        tb_hong_t t = tb_mclock();
+        tb_random_reset(tb_true);
+        for (i = 0; i < count; i += batch)
+        {
+            tb_hong_t b = tb_uclock();
+            for (j = 0; j < batch; j++)
+            {
+                tb_size_t v = tb_random_value();
+                tb_hash_map_test_insert_i2i(hash, v);
+            }
+            b = tb_uclock() - b;
+            histogram[b < maxn? (tb_size_t)b : maxn - 1]++;
+        }
+        t = tb_mclock() - t;
+
+        // check items
+        tb_size_t failed = 0;
+        tb_random_reset(tb_true);
+        for (i = 0; i < count; i++)
+        {
+            tb_size_t v = tb_random_value();
+            if (v != (tb_size_t)tb_hash_map_get(hash, (tb_pointer_t)v)) failed++;
+        }
+
+        // trace
+        tb_size_t batchs = count / batch;
+        tb_trace_i("resize(%s): size: %lu, failed: %lu, time: %lld ms, latency of %lu insertions: p50: %lu us, p99: %lu us, p99.9: %lu us, max: %lu us"
+                , name, tb_hash_map_size(hash), failed, t, batch
+                , tb_hash_map_test_resize_percent(histogram, maxn, batchs, 5000)
+                , tb_hash_map_test_resize_percent(histogram, maxn, batchs, 9900)
+                , tb_hash_map_test_resize_percent(histogram, maxn, batchs, 9990)
+                , tb_hash_map_test_resize_percent(histogram, maxn, batchs, 10000));
+
+        // clear it and the buckets will be shrunk
+        tb_hash_map_clear(hash);
+        tb_assert(!tb_hash_map_size(hash));
+
+        // exit hash
+        tb_hash_map_exit(hash);
+    }
+
+    // exit histogram
+    tb_free(histogram);
+}
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * main
@@ -609,5 +687,13 @@ tb_int_t tb_demo_container_hash_map_main(tb_int_t argc, tb_char_t** argv)
     tb_hash_map_test_walk_perf();
 #endif
 
+    // bench the bucket growth, e.g. xmake r demo container_hash_map resize
+    if (argv[1] && !tb_strcmp(argv[1], "resize"))
+    {
+        tb_hash_map_test_resize_perf("fixed", 0, tb_false);
+        tb_hash_map_test_resize_perf("incremental", TB_HASH_MAP_LOAD_FACTOR_NORMAL, tb_false);
+        tb_hash_map_test_resize_perf("reserve", TB_HASH_MAP_LOAD_FACTOR_NORMAL, tb_true);
+    }
+
     return 0;
 }
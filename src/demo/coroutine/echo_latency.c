@@ -0,0 +1,220 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the round trip count of each test
+#define TB_DEMO_COUNT           (20000)
+
+// the message size
+#define TB_DEMO_SIZE            (13)
+
+// the maximum spinning budget (us) for the busy polling mode
+#define TB_DEMO_BUSY_POLL       (50)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the test mode
+typedef enum __tb_demo_mode_e
+{
+    TB_DEMO_MODE_PARK           = 0     //!< block to wait events directly
+,   TB_DEMO_MODE_SPIN           = 1     //!< tb_co_scheduler_busy_poll()
+,   TB_DEMO_MODE_SPIN_SOCKET    = 2     //!< tb_co_scheduler_busy_poll() and TB_SOCKET_CTRL_SET_BUSY_POLL
+
+}tb_demo_mode_e;
+
+// the test context type
+typedef struct __tb_demo_context_t
+{
+    // the mode
+    tb_size_t               mode;
+
+    // the listener
+    tb_socket_ref_t         sock;
+
+    // the listened address
+    tb_ipaddr_t             addr;
+
+    // the round trip latencies (us)
+    tb_long_t*              latencies;
+
+    // the server stats
+    tb_co_scheduler_stats_t stats;
+
+}tb_demo_context_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_coroutine_echo(tb_cpointer_t priv)
+{
+    // check
+    tb_demo_context_t* context = (tb_demo_context_t*)priv;
+    tb_assert_and_check_return(context);
+
+    // accept the client
+    tb_socket_ref_t sock = tb_null;
+    while (!(sock = tb_socket_accept(context->sock, tb_null)))
+    {
+        if (tb_socket_wait(context->sock, TB_SOCKET_EVENT_ACPT, -1) <= 0) return ;
+    }
+
+    // enable busy polling for the socket
+    tb_socket_ctrl(sock, TB_SOCKET_CTRL_SET_TCP_NODELAY, tb_true);
+    if (context->mode == TB_DEMO_MODE_SPIN_SOCKET)
+        tb_socket_ctrl(sock, TB_SOCKET_CTRL_SET_BUSY_POLL, TB_DEMO_BUSY_POLL);
+
+    // echo data until it is closed
+    tb_byte_t data[TB_DEMO_SIZE];
+    while (tb_socket_brecv(sock, data, sizeof(data)))
+    {
+        if (!tb_socket_bsend(sock, data, sizeof(data))) break;
+    }
+
+    // exit socket
+    tb_socket_exit(sock);
+}
+static tb_void_t tb_demo_coroutine_ping(tb_cpointer_t priv)
+{
+    // check
+    tb_demo_context_t* context = (tb_demo_context_t*)priv;
+    tb_assert_and_check_return(context);
+
+    // init socket
+    tb_socket_ref_t sock = tb_socket_init(TB_SOCKET_TYPE_TCP, TB_IPADDR_FAMILY_IPV4);
+    tb_assert_and_check_return(sock);
+
+    // connect it
+    tb_long_t ok = -1;
+    while (!(ok = tb_socket_connect(sock, &context->addr)))
+    {
+        if (tb_socket_wait(sock, TB_SOCKET_EVENT_CONN, -1) <= 0) break;
+    }
+    if (ok > 0)
+    {
+        // enable busy polling for the socket
+        tb_socket_ctrl(sock, TB_SOCKET_CTRL_SET_TCP_NODELAY, tb_true);
+        if (context->mode == TB_DEMO_MODE_SPIN_SOCKET)
+            tb_socket_ctrl(sock, TB_SOCKET_CTRL_SET_BUSY_POLL, TB_DEMO_BUSY_POLL);
+
+        // ping-pong
+        tb_size_t i;
+        tb_byte_t data[TB_DEMO_SIZE] = {0};
+        for (i = 0; i < TB_DEMO_COUNT; i++)
+        {
+            tb_hong_t time = tb_uclock();
+            if (!tb_socket_bsend(sock, data, sizeof(data))) break;
+            if (!tb_socket_brecv(sock, data, sizeof(data))) break;
+            context->latencies[i] = (tb_long_t)(tb_uclock() - time);
+        }
+    }
+
+    // exit socket
+    tb_socket_exit(sock);
+}
+static tb_int_t tb_demo_server_loop(tb_cpointer_t priv)
+{
+    // check
+    tb_demo_context_t* context = (tb_demo_context_t*)priv;
+    tb_assert_and_check_return_val(context, -1);
+
+    // init scheduler
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    if (scheduler)
+    {
+        // enable the busy polling mode
+        if (context->mode != TB_DEMO_MODE_PARK)
+            tb_co_scheduler_busy_poll(scheduler, TB_DEMO_BUSY_POLL);
+
+        // run the echo server
+        tb_coroutine_start(scheduler, tb_demo_coroutine_echo, context, 0);
+        tb_co_scheduler_loop(scheduler, tb_false);
+
+        // get stats
+        tb_co_scheduler_stats(scheduler, &context->stats);
+
+        // exit scheduler
+        tb_co_scheduler_exit(scheduler);
+    }
+    return 0;
+}
+static tb_void_t tb_demo_echo_latency_test(tb_size_t mode)
+{
+    // the mode names
+    static tb_char_t const* s_names[] = {"park", "spin", "spin + SO_BUSY_POLL"};
+
+    // init context
+    tb_demo_context_t context;
+    tb_memset(&context, 0, sizeof(context));
+    context.mode        = mode;
+    context.latencies   = tb_nalloc0_type(TB_DEMO_COUNT, tb_long_t);
+    context.sock        = tb_socket_init(TB_SOCKET_TYPE_TCP, TB_IPADDR_FAMILY_IPV4);
+
+    // init the client scheduler
+    tb_thread_ref_t         thread = tb_null;
+    tb_co_scheduler_ref_t   scheduler = tb_co_scheduler_init();
+    do
+    {
+        // check
+        tb_assert_and_check_break(context.latencies && context.sock && scheduler);
+
+        // listen it
+        tb_ipaddr_set(&context.addr, "127.0.0.1", 0, TB_IPADDR_FAMILY_IPV4);
+        if (!tb_socket_bind(context.sock, &context.addr) || !tb_socket_local(context.sock, &context.addr) || !tb_socket_listen(context.sock, 16)) break;
+
+        // start the server thread
+        thread = tb_thread_init(tb_null, tb_demo_server_loop, &context, 0);
+        tb_assert_and_check_break(thread);
+
+        // run the client
+        if (mode != TB_DEMO_MODE_PARK) tb_co_scheduler_busy_poll(scheduler, TB_DEMO_BUSY_POLL);
+        tb_coroutine_start(scheduler, tb_demo_coroutine_ping, &context, 0);
+        tb_co_scheduler_loop(scheduler, tb_true);
+
+        // wait the server
+        tb_thread_wait(thread, -1, tb_null);
+
+        // sort latencies
+        tb_array_iterator_t array_iterator;
+        tb_iterator_ref_t   iterator = tb_array_iterator_init_long(&array_iterator, context.latencies, TB_DEMO_COUNT);
+        tb_sort_all(iterator, tb_null);
+
+        // trace
+        tb_co_scheduler_stats_t stats;
+        tb_co_scheduler_stats(scheduler, &stats);
+        tb_trace_i("%s: p50: %ld us, p99: %ld us, p999: %ld us, client: spin/park: %llu/%llu, server: spin/park: %llu/%llu, budget: %lu us, interval: %lu us"
+                   , s_names[mode]
+                   , context.latencies[TB_DEMO_COUNT / 2], context.latencies[TB_DEMO_COUNT * 99 / 100], context.latencies[TB_DEMO_COUNT * 999 / 1000]
+                   , stats.spin, stats.park, context.stats.spin, context.stats.park, context.stats.budget, context.stats.interval);
+
+    } while (0);
+
+    // exit thread
+    if (thread) tb_thread_exit(thread);
+
+    // exit scheduler
+    if (scheduler) tb_co_scheduler_exit(scheduler);
+
+    // exit listener
+    if (context.sock) tb_socket_exit(context.sock);
+
+    // exit latencies
+    if (context.latencies) tb_free(context.latencies);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_coroutine_echo_latency_main(tb_int_t argc, tb_char_t** argv)
+{
+    tb_demo_echo_latency_test(TB_DEMO_MODE_PARK);
+    tb_demo_echo_latency_test(TB_DEMO_MODE_SPIN);
+    tb_demo_echo_latency_test(TB_DEMO_MODE_SPIN_SOCKET);
+    return 0;
+}
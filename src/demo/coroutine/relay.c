@@ -0,0 +1,292 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+#include <time.h>
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the relayed data size
+#define TB_DEMO_DATA_SIZE       (1024 * 1024 * 1024)
+
+// the sent block size
+#define TB_DEMO_BLOCK_SIZE      (1 << 16)
+
+// the stack size
+#define TB_DEMO_STACKSIZE       (8192 << 3)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the relay mode
+typedef enum __tb_demo_mode_e
+{
+    TB_DEMO_MODE_COPY       = 0     //!< copy data by the user buffer, the same as echo_server
+,   TB_DEMO_MODE_SPLICE     = 1     //!< relay data by tb_socket_relay()
+,   TB_DEMO_MODE_ZEROCOPY   = 2     //!< relay data by tb_socket_relay() and send it by MSG_ZEROCOPY
+
+}tb_demo_mode_e;
+
+// the test context type
+typedef struct __tb_demo_context_t
+{
+    // the mode
+    tb_size_t               mode;
+
+    // the proxy listener
+    tb_socket_ref_t         proxy;
+
+    // the sink listener
+    tb_socket_ref_t         sink;
+
+    // the proxy address
+    tb_ipaddr_t             proxy_addr;
+
+    // the sink address
+    tb_ipaddr_t             sink_addr;
+
+    // the received size of the sink
+    tb_hize_t               size;
+
+    // the zero-copy sending has been copied by the kernel?
+    tb_bool_t               copied;
+
+}tb_demo_context_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_socket_ref_t tb_demo_socket_connect(tb_ipaddr_ref_t addr)
+{
+    // init socket
+    tb_socket_ref_t sock = tb_socket_init(TB_SOCKET_TYPE_TCP, TB_IPADDR_FAMILY_IPV4);
+    tb_assert_and_check_return_val(sock, tb_null);
+
+    // connect it
+    tb_long_t ok = -1;
+    while (!(ok = tb_socket_connect(sock, addr)))
+    {
+        if (tb_socket_wait(sock, TB_SOCKET_EVENT_CONN, -1) <= 0) break;
+    }
+    if (ok <= 0)
+    {
+        tb_socket_exit(sock);
+        sock = tb_null;
+    }
+    return sock;
+}
+static tb_socket_ref_t tb_demo_socket_accept(tb_socket_ref_t sock)
+{
+    // accept it
+    tb_socket_ref_t client = tb_null;
+    while (!(client = tb_socket_accept(sock, tb_null)))
+    {
+        if (tb_socket_wait(sock, TB_SOCKET_EVENT_ACPT, -1) <= 0) break;
+    }
+    return client;
+}
+static tb_long_t tb_demo_socket_recv(tb_socket_ref_t sock, tb_byte_t* data, tb_size_t size)
+{
+    while (1)
+    {
+        // recv it
+        tb_long_t real = tb_socket_recv(sock, data, size);
+        tb_check_return_val(!real, real);
+
+        // wait it
+        if (tb_socket_wait(sock, TB_SOCKET_EVENT_RECV, -1) <= 0) return -1;
+        real = tb_socket_recv(sock, data, size);
+        tb_check_return_val(!real, real);
+
+        /* no data after waiting? the socket is closed or the edge-triggered event was cached before reading,
+         * so we poll it directly to distinguish them
+         */
+        if (tb_socket_wait(sock, TB_SOCKET_EVENT_RECV, 0) <= 0) continue;
+        real = tb_socket_recv(sock, data, size);
+        return real > 0? real : -1;
+    }
+    return -1;
+}
+static tb_void_t tb_demo_coroutine_source(tb_cpointer_t priv)
+{
+    // check
+    tb_demo_context_t* context = (tb_demo_context_t*)priv;
+    tb_assert_and_check_return(context);
+
+    // connect the proxy
+    tb_socket_ref_t sock = tb_demo_socket_connect(&context->proxy_addr);
+    tb_assert_and_check_return(sock);
+
+    // send data
+    tb_byte_t*  data = tb_malloc0_bytes(TB_DEMO_BLOCK_SIZE);
+    tb_hize_t   send = 0;
+    if (data && context->mode == TB_DEMO_MODE_ZEROCOPY && tb_socket_ctrl(sock, TB_SOCKET_CTRL_SET_ZEROCOPY, tb_true))
+    {
+        // the data is not changed, so we need not wait for the completion before sending the next block
+        tb_uint32_t sent = 0;
+        tb_uint32_t reaped = 0;
+        tb_uint32_t last = 0;
+        tb_size_t   offset = 0;
+        while (send < TB_DEMO_DATA_SIZE)
+        {
+            tb_long_t real = tb_socket_send_zerocopy(sock, data + offset, TB_DEMO_BLOCK_SIZE - offset);
+            if (real > 0)
+            {
+                sent++;
+                send += real;
+                offset = (offset + real) % TB_DEMO_BLOCK_SIZE;
+            }
+            else if (real == -2)
+            {
+                // too many pinned pages? reap the completions, or wait them if no completion now
+                tb_long_t count = tb_socket_zerocopy_reap(sock, &last, &context->copied);
+                if (count > 0) reaped += count;
+                else if (count < 0 || tb_socket_wait(sock, TB_SOCKET_EVENT_EALL, -1) <= 0) break;
+                continue;
+            }
+            else if (real < 0 || tb_socket_wait(sock, TB_SOCKET_EVENT_SEND, -1) <= 0) break;
+
+            // reap the completions
+            tb_long_t count = tb_socket_zerocopy_reap(sock, &last, &context->copied);
+            if (count > 0) reaped += count;
+        }
+
+        // wait all completions
+        while (reaped < sent)
+        {
+            tb_long_t count = tb_socket_zerocopy_reap(sock, &last, &context->copied);
+            if (count > 0) reaped += count;
+            else if (count < 0) break;
+            else tb_msleep(1);
+        }
+    }
+    else if (data)
+    {
+        while (send < TB_DEMO_DATA_SIZE && tb_socket_bsend(sock, data, TB_DEMO_BLOCK_SIZE))
+            send += TB_DEMO_BLOCK_SIZE;
+    }
+
+    // exit data
+    if (data) tb_free(data);
+
+    // exit socket
+    tb_socket_exit(sock);
+}
+static tb_void_t tb_demo_coroutine_proxy(tb_cpointer_t priv)
+{
+    // check
+    tb_demo_context_t* context = (tb_demo_context_t*)priv;
+    tb_assert_and_check_return(context);
+
+    // accept the source and connect the sink
+    tb_socket_ref_t isock = tb_demo_socket_accept(context->proxy);
+    tb_socket_ref_t osock = tb_demo_socket_connect(&context->sink_addr);
+    if (isock && osock)
+    {
+        // relay data
+        if (context->mode == TB_DEMO_MODE_COPY)
+        {
+            tb_byte_t data[8192];
+            tb_long_t real = 0;
+            while ((real = tb_demo_socket_recv(isock, data, sizeof(data))) > 0)
+            {
+                if (!tb_socket_bsend(osock, data, real)) break;
+            }
+        }
+        else tb_socket_relay(isock, osock, -1);
+    }
+
+    // exit sockets
+    if (isock) tb_socket_exit(isock);
+    if (osock) tb_socket_exit(osock);
+}
+static tb_void_t tb_demo_coroutine_sink(tb_cpointer_t priv)
+{
+    // check
+    tb_demo_context_t* context = (tb_demo_context_t*)priv;
+    tb_assert_and_check_return(context);
+
+    // accept the proxy
+    tb_socket_ref_t sock = tb_demo_socket_accept(context->sink);
+    tb_assert_and_check_return(sock);
+
+    // recv data until it is closed
+    tb_byte_t data[8192];
+    tb_long_t real = 0;
+    while ((real = tb_demo_socket_recv(sock, data, sizeof(data))) > 0)
+        context->size += real;
+
+    // exit socket
+    tb_socket_exit(sock);
+}
+static tb_socket_ref_t tb_demo_socket_listen(tb_ipaddr_ref_t addr)
+{
+    // init socket
+    tb_socket_ref_t sock = tb_socket_init(TB_SOCKET_TYPE_TCP, TB_IPADDR_FAMILY_IPV4);
+    tb_assert_and_check_return_val(sock, tb_null);
+
+    // bind and listen it
+    tb_ipaddr_set(addr, "127.0.0.1", 0, TB_IPADDR_FAMILY_IPV4);
+    if (!tb_socket_bind(sock, addr) || !tb_socket_local(sock, addr) || !tb_socket_listen(sock, 16))
+    {
+        tb_socket_exit(sock);
+        sock = tb_null;
+    }
+    return sock;
+}
+static tb_void_t tb_demo_relay_test(tb_size_t mode)
+{
+    // the mode names
+    static tb_char_t const* s_names[] = {"copy", "splice", "splice + zerocopy"};
+
+    // init context
+    tb_demo_context_t context;
+    tb_memset(&context, 0, sizeof(context));
+    context.mode  = mode;
+    context.proxy = tb_demo_socket_listen(&context.proxy_addr);
+    context.sink  = tb_demo_socket_listen(&context.sink_addr);
+
+    // init scheduler
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    if (scheduler && context.proxy && context.sink)
+    {
+        // start coroutines
+        tb_coroutine_start(scheduler, tb_demo_coroutine_sink, &context, TB_DEMO_STACKSIZE);
+        tb_coroutine_start(scheduler, tb_demo_coroutine_proxy, &context, TB_DEMO_STACKSIZE);
+        tb_coroutine_start(scheduler, tb_demo_coroutine_source, &context, TB_DEMO_STACKSIZE);
+
+        // run scheduler
+        tb_hong_t   time = tb_mclock();
+        clock_t     cpu = clock();
+        tb_co_scheduler_loop(scheduler, tb_true);
+        cpu = clock() - cpu;
+        time = tb_mclock() - time;
+
+        // trace
+        tb_hong_t cpu_ms = (tb_hong_t)cpu * 1000 / CLOCKS_PER_SEC;
+        tb_trace_i("%s: %llu MB in %lld ms, %lld MB/s, cpu: %lld ms%s", s_names[mode], context.size >> 20
+                   , time, time > 0? (tb_hong_t)((context.size >> 20) * 1000 / time) : 0, cpu_ms
+                   , mode == TB_DEMO_MODE_ZEROCOPY && context.copied? " (copied by the kernel)" : "");
+    }
+
+    // exit scheduler
+    if (scheduler) tb_co_scheduler_exit(scheduler);
+
+    // exit listeners
+    if (context.proxy) tb_socket_exit(context.proxy);
+    if (context.sink) tb_socket_exit(context.sink);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_coroutine_relay_main(tb_int_t argc, tb_char_t** argv)
+{
+    tb_demo_relay_test(TB_DEMO_MODE_COPY);
+    tb_demo_relay_test(TB_DEMO_MODE_SPLICE);
+    tb_demo_relay_test(TB_DEMO_MODE_ZEROCOPY);
+    return 0;
+}
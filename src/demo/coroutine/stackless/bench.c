@@ -0,0 +1,259 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the default connections count
+#define TB_DEMO_CONN_MAXN       (4000)
+
+// the switch count of each coroutine
+#define TB_DEMO_SWITCH_COUNT    (1000)
+
+// the waiting timeout (ms)
+#define TB_DEMO_TIMEOUT         (60000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the stackless connection type
+typedef struct __tb_demo_lo_conn_t
+{
+    // the socket
+    tb_socket_ref_t         sock;
+
+}tb_demo_lo_conn_t;
+
+// the stackless switch type
+typedef struct __tb_demo_lo_switch_t
+{
+    // the count
+    tb_size_t               count;
+
+}tb_demo_lo_switch_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the socket pairs
+static tb_socket_ref_t*     g_pairs = tb_null;
+
+// the connections count
+static tb_size_t            g_count = 0;
+
+// the finished connections count
+static tb_size_t            g_finished = 0;
+
+// the resident memory size after all connections are waiting
+static tb_size_t            g_rss = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_size_t tb_demo_memory_rss()
+{
+    // get the resident memory size from procfs
+    tb_size_t rss = 0;
+#ifdef TB_CONFIG_OS_LINUX
+    tb_file_ref_t file = tb_file_init("/proc/self/statm", TB_FILE_MODE_RO);
+    if (file)
+    {
+        tb_char_t data[256] = {0};
+        if (tb_file_read(file, (tb_byte_t*)data, sizeof(data) - 1) > 0)
+        {
+            tb_char_t const* p = tb_strchr(data, ' ');
+            if (p) rss = tb_atoi(p + 1) * tb_page_size();
+        }
+        tb_file_exit(file);
+    }
+#endif
+    return rss;
+}
+static tb_void_t tb_demo_wakeup_all()
+{
+    // save the resident memory size first, all connections are waiting now
+    g_rss = tb_demo_memory_rss();
+
+    // wake up all connections
+    tb_size_t i;
+    for (i = 0; i < g_count; i++)
+        tb_socket_send(g_pairs[i << 1], (tb_byte_t const*)"x", 1);
+}
+static tb_void_t tb_demo_lo_coroutine_conn(tb_lo_coroutine_ref_t coroutine, tb_cpointer_t priv)
+{
+    // check
+    tb_demo_lo_conn_t* conn = (tb_demo_lo_conn_t*)priv;
+
+    // enter coroutine
+    tb_lo_coroutine_enter(coroutine)
+    {
+        // wait data with timeout
+        tb_lo_coroutine_wait_sock(conn->sock, TB_SOCKET_EVENT_RECV, TB_DEMO_TIMEOUT);
+        if (tb_lo_coroutine_wait_result() > 0)
+        {
+            tb_byte_t data[1];
+            if (tb_socket_recv(conn->sock, data, 1) == 1) g_finished++;
+        }
+    }
+}
+static tb_void_t tb_demo_lo_coroutine_wakeup(tb_lo_coroutine_ref_t coroutine, tb_cpointer_t priv)
+{
+    // enter coroutine
+    tb_lo_coroutine_enter(coroutine)
+    {
+        tb_demo_wakeup_all();
+    }
+}
+static tb_void_t tb_demo_coroutine_conn(tb_cpointer_t priv)
+{
+    // wait data with timeout
+    tb_socket_ref_t sock = (tb_socket_ref_t)priv;
+    if (tb_socket_wait(sock, TB_SOCKET_EVENT_RECV, TB_DEMO_TIMEOUT) > 0)
+    {
+        tb_byte_t data[1];
+        if (tb_socket_recv(sock, data, 1) == 1) g_finished++;
+    }
+}
+static tb_void_t tb_demo_coroutine_wakeup(tb_cpointer_t priv)
+{
+    tb_demo_wakeup_all();
+}
+static tb_void_t tb_demo_coroutine_conn_bench(tb_bool_t stackless)
+{
+    // the resident memory size before starting connections
+    tb_size_t rss = tb_demo_memory_rss();
+
+    // run all connections, the last coroutine wakes up them after all of them are waiting
+    tb_size_t i;
+    tb_hong_t time = 0;
+    g_finished = 0;
+    if (stackless)
+    {
+        tb_lo_scheduler_ref_t scheduler = tb_lo_scheduler_init();
+        if (scheduler)
+        {
+            for (i = 0; i < g_count; i++)
+                tb_lo_coroutine_start(scheduler, tb_demo_lo_coroutine_conn, tb_lo_coroutine_pass_pool1(scheduler, tb_demo_lo_conn_t, sock, g_pairs[(i << 1) + 1]));
+            tb_lo_coroutine_start(scheduler, tb_demo_lo_coroutine_wakeup, tb_null, tb_null);
+
+            time = tb_mclock();
+            tb_lo_scheduler_loop(scheduler, tb_true);
+            time = tb_mclock() - time;
+            tb_lo_scheduler_exit(scheduler);
+        }
+    }
+    else
+    {
+        tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+        if (scheduler)
+        {
+            for (i = 0; i < g_count; i++)
+                tb_coroutine_start(scheduler, tb_demo_coroutine_conn, g_pairs[(i << 1) + 1], 0);
+            tb_coroutine_start(scheduler, tb_demo_coroutine_wakeup, tb_null, 0);
+
+            time = tb_mclock();
+            tb_co_scheduler_loop(scheduler, tb_true);
+            time = tb_mclock() - time;
+            tb_co_scheduler_exit(scheduler);
+        }
+    }
+
+    // trace
+    tb_trace_i("%s: %lu/%lu connections in %lld ms, memory: %lu bytes/connection", stackless? "stackless" : "stackful"
+               , g_finished, g_count, time, g_rss > rss? (g_rss - rss) / g_count : 0);
+}
+static tb_void_t tb_demo_lo_coroutine_switch(tb_lo_coroutine_ref_t coroutine, tb_cpointer_t priv)
+{
+    // check
+    tb_demo_lo_switch_t* test = (tb_demo_lo_switch_t*)priv;
+
+    // enter coroutine
+    tb_lo_coroutine_enter(coroutine)
+    {
+        for (test->count = TB_DEMO_SWITCH_COUNT; test->count; test->count--)
+            tb_lo_coroutine_yield();
+    }
+}
+static tb_void_t tb_demo_coroutine_switch(tb_cpointer_t priv)
+{
+    tb_size_t count = TB_DEMO_SWITCH_COUNT;
+    while (count--) tb_coroutine_yield();
+}
+static tb_void_t tb_demo_coroutine_switch_bench(tb_bool_t stackless)
+{
+    // run all coroutines
+    tb_size_t i;
+    tb_hong_t time = 0;
+    if (stackless)
+    {
+        tb_lo_scheduler_ref_t scheduler = tb_lo_scheduler_init();
+        if (scheduler)
+        {
+            for (i = 0; i < g_count; i++)
+                tb_lo_coroutine_start(scheduler, tb_demo_lo_coroutine_switch, tb_lo_coroutine_pass_pool(scheduler, tb_demo_lo_switch_t));
+
+            time = tb_mclock();
+            tb_lo_scheduler_loop(scheduler, tb_true);
+            time = tb_mclock() - time;
+            tb_lo_scheduler_exit(scheduler);
+        }
+    }
+    else
+    {
+        tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+        if (scheduler)
+        {
+            for (i = 0; i < g_count; i++)
+                tb_coroutine_start(scheduler, tb_demo_coroutine_switch, tb_null, 0);
+
+            time = tb_mclock();
+            tb_co_scheduler_loop(scheduler, tb_true);
+            time = tb_mclock() - time;
+            tb_co_scheduler_exit(scheduler);
+        }
+    }
+
+    // trace
+    tb_hize_t count = (tb_hize_t)g_count * TB_DEMO_SWITCH_COUNT;
+    tb_trace_i("%s: %llu switches with %lu coroutines in %lld ms, %lld switches per second", stackless? "stackless" : "stackful"
+               , count, g_count, time, time > 0? (tb_hong_t)(count * 1000 / time) : 0);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_lo_coroutine_bench_main(tb_int_t argc, tb_char_t** argv)
+{
+    // init socket pairs
+    tb_size_t i = 0;
+    g_count = argc > 1 && argv[1]? tb_atoi(argv[1]) : TB_DEMO_CONN_MAXN;
+    g_pairs = tb_nalloc0_type(g_count << 1, tb_socket_ref_t);
+    tb_assert_and_check_return_val(g_count && g_pairs, -1);
+    for (i = 0; i < g_count; i++)
+    {
+        if (!tb_socket_pair(TB_SOCKET_TYPE_TCP, g_pairs + (i << 1))) break;
+    }
+    if (i == g_count)
+    {
+        // the stackless coroutines are run first, because the memory freed by them may be reused by others
+        tb_demo_coroutine_conn_bench(tb_true);
+        tb_demo_coroutine_conn_bench(tb_false);
+        tb_demo_coroutine_switch_bench(tb_true);
+        tb_demo_coroutine_switch_bench(tb_false);
+    }
+    else tb_trace_e("init socket pairs failed, please increase the file limit or decrease the connections count: %lu", g_count);
+
+    // exit socket pairs
+    for (i = 0; i < (g_count << 1); i++)
+    {
+        if (g_pairs[i]) tb_socket_exit(g_pairs[i]);
+    }
+    tb_free(g_pairs);
+    g_pairs = tb_null;
+    return 0;
+}
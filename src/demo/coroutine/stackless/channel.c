@@ -0,0 +1,253 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the pass count
+#define COUNT       (10000000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the channel test type
+typedef struct __tb_demo_lo_channel_t
+{
+    // the channel
+    tb_lo_channel_ref_t     channel;
+
+    // the count
+    tb_size_t               count;
+
+    // the data
+    tb_pointer_t            data;
+
+}tb_demo_lo_channel_t;
+
+// the select test type
+typedef struct __tb_demo_lo_select_t
+{
+    // the channels
+    tb_lo_channel_ref_t*    channels;
+
+    // the count
+    tb_size_t               count;
+
+    // the received channel index
+    tb_size_t               index;
+
+    // the data
+    tb_pointer_t            data;
+
+}tb_demo_lo_select_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_lo_coroutine_channel_test_send(tb_lo_coroutine_ref_t coroutine, tb_cpointer_t priv)
+{
+    // check
+    tb_demo_lo_channel_t* test = (tb_demo_lo_channel_t*)priv;
+
+    // enter coroutine
+    tb_lo_coroutine_enter(coroutine)
+    {
+        // loop
+        for (test->count = 10; test->count; test->count--)
+        {
+            // trace
+            tb_trace_i("[coroutine: %p]: send: %lu", tb_lo_coroutine_self(), test->count);
+
+            // send data
+            tb_lo_channel_send(test->channel, (tb_cpointer_t)test->count);
+
+            // trace
+            tb_trace_i("[coroutine: %p]: send: %lu ok", tb_lo_coroutine_self(), test->count);
+        }
+    }
+}
+static tb_void_t tb_demo_lo_coroutine_channel_test_recv(tb_lo_coroutine_ref_t coroutine, tb_cpointer_t priv)
+{
+    // check
+    tb_demo_lo_channel_t* test = (tb_demo_lo_channel_t*)priv;
+
+    // enter coroutine
+    tb_lo_coroutine_enter(coroutine)
+    {
+        // loop
+        for (test->count = 10; test->count; test->count--)
+        {
+            // trace
+            tb_trace_i("[coroutine: %p]: recv: ..", tb_lo_coroutine_self());
+
+            // recv data
+            tb_lo_channel_recv(test->channel, &test->data);
+
+            // trace
+            tb_trace_i("[coroutine: %p]: recv: %lu ok", tb_lo_coroutine_self(), (tb_size_t)test->data);
+        }
+    }
+}
+static tb_void_t tb_demo_lo_coroutine_channel_test(tb_size_t size)
+{
+    // trace
+    tb_trace_i("test: %lu", size);
+
+    // init scheduler
+    tb_lo_scheduler_ref_t scheduler = tb_lo_scheduler_init();
+    if (scheduler)
+    {
+        // init channel
+        tb_lo_channel_ref_t channel = tb_lo_channel_init(size, tb_null, tb_null);
+        tb_assert(channel);
+
+        // start coroutines
+        tb_lo_coroutine_start(scheduler, tb_demo_lo_coroutine_channel_test_send, tb_lo_coroutine_pass_pool1(scheduler, tb_demo_lo_channel_t, channel, channel));
+        tb_lo_coroutine_start(scheduler, tb_demo_lo_coroutine_channel_test_send, tb_lo_coroutine_pass_pool1(scheduler, tb_demo_lo_channel_t, channel, channel));
+        tb_lo_coroutine_start(scheduler, tb_demo_lo_coroutine_channel_test_send, tb_lo_coroutine_pass_pool1(scheduler, tb_demo_lo_channel_t, channel, channel));
+        tb_lo_coroutine_start(scheduler, tb_demo_lo_coroutine_channel_test_recv, tb_lo_coroutine_pass_pool1(scheduler, tb_demo_lo_channel_t, channel, channel));
+        tb_lo_coroutine_start(scheduler, tb_demo_lo_coroutine_channel_test_recv, tb_lo_coroutine_pass_pool1(scheduler, tb_demo_lo_channel_t, channel, channel));
+        tb_lo_coroutine_start(scheduler, tb_demo_lo_coroutine_channel_test_recv, tb_lo_coroutine_pass_pool1(scheduler, tb_demo_lo_channel_t, channel, channel));
+
+        // run scheduler
+        tb_lo_scheduler_loop(scheduler, tb_true);
+
+        // exit channel
+        tb_lo_channel_exit(channel);
+
+        // exit scheduler
+        tb_lo_scheduler_exit(scheduler);
+    }
+}
+static tb_void_t tb_demo_lo_coroutine_channel_select_recv(tb_lo_coroutine_ref_t coroutine, tb_cpointer_t priv)
+{
+    // check
+    tb_demo_lo_select_t* test = (tb_demo_lo_select_t*)priv;
+
+    // enter coroutine
+    tb_lo_coroutine_enter(coroutine)
+    {
+        // loop
+        for (test->count = 20; test->count; test->count--)
+        {
+            // recv data from one of the channels
+            tb_lo_channel_select(test->channels, 2, &test->index, &test->data);
+
+            // trace
+            tb_trace_i("[coroutine: %p]: select: channel[%lu]: %lu ok", tb_lo_coroutine_self(), test->index, (tb_size_t)test->data);
+        }
+    }
+}
+static tb_void_t tb_demo_lo_coroutine_channel_select()
+{
+    // trace
+    tb_trace_i("select");
+
+    // init scheduler
+    tb_lo_scheduler_ref_t scheduler = tb_lo_scheduler_init();
+    if (scheduler)
+    {
+        // init channels
+        tb_lo_channel_ref_t channels[2];
+        channels[0] = tb_lo_channel_init(1, tb_null, tb_null);
+        channels[1] = tb_lo_channel_init(0, tb_null, tb_null);
+        tb_assert(channels[0] && channels[1]);
+
+        // start coroutines
+        tb_lo_channel_ref_t* pchannels = channels;
+        tb_lo_coroutine_start(scheduler, tb_demo_lo_coroutine_channel_select_recv, tb_lo_coroutine_pass_pool1(scheduler, tb_demo_lo_select_t, channels, pchannels));
+        tb_lo_coroutine_start(scheduler, tb_demo_lo_coroutine_channel_test_send, tb_lo_coroutine_pass_pool1(scheduler, tb_demo_lo_channel_t, channel, channels[0]));
+        tb_lo_coroutine_start(scheduler, tb_demo_lo_coroutine_channel_test_send, tb_lo_coroutine_pass_pool1(scheduler, tb_demo_lo_channel_t, channel, channels[1]));
+
+        // run scheduler
+        tb_lo_scheduler_loop(scheduler, tb_true);
+
+        // exit channels
+        tb_lo_channel_exit(channels[0]);
+        tb_lo_channel_exit(channels[1]);
+
+        // exit scheduler
+        tb_lo_scheduler_exit(scheduler);
+    }
+}
+static tb_void_t tb_demo_lo_coroutine_channel_perf_send(tb_lo_coroutine_ref_t coroutine, tb_cpointer_t priv)
+{
+    // check
+    tb_demo_lo_channel_t* test = (tb_demo_lo_channel_t*)priv;
+
+    // enter coroutine
+    tb_lo_coroutine_enter(coroutine)
+    {
+        // loop
+        for (test->count = COUNT; test->count; test->count--)
+            tb_lo_channel_send(test->channel, (tb_cpointer_t)test->count);
+    }
+}
+static tb_void_t tb_demo_lo_coroutine_channel_perf_recv(tb_lo_coroutine_ref_t coroutine, tb_cpointer_t priv)
+{
+    // check
+    tb_demo_lo_channel_t* test = (tb_demo_lo_channel_t*)priv;
+
+    // enter coroutine
+    tb_lo_coroutine_enter(coroutine)
+    {
+        // loop
+        for (test->count = COUNT; test->count; test->count--)
+            tb_lo_channel_recv(test->channel, &test->data);
+    }
+}
+static tb_void_t tb_demo_lo_coroutine_channel_perf(tb_size_t size)
+{
+    // trace
+    tb_trace_i("perf: %lu", size);
+
+    // init scheduler
+    tb_lo_scheduler_ref_t scheduler = tb_lo_scheduler_init();
+    if (scheduler)
+    {
+        // init channel
+        tb_lo_channel_ref_t channel = tb_lo_channel_init(size, tb_null, tb_null);
+        tb_assert(channel);
+
+        // start coroutine
+        tb_lo_coroutine_start(scheduler, tb_demo_lo_coroutine_channel_perf_send, tb_lo_coroutine_pass_pool1(scheduler, tb_demo_lo_channel_t, channel, channel));
+        tb_lo_coroutine_start(scheduler, tb_demo_lo_coroutine_channel_perf_recv, tb_lo_coroutine_pass_pool1(scheduler, tb_demo_lo_channel_t, channel, channel));
+
+        // init the start time
+        tb_hong_t startime = tb_mclock();
+
+        // run scheduler
+        tb_lo_scheduler_loop(scheduler, tb_true);
+
+        // computing time
+        tb_hong_t duration = tb_mclock() - startime;
+
+        // exit channel
+        tb_lo_channel_exit(channel);
+
+        // trace
+        tb_trace_i("%d passes in %lld ms, %lld passes per second", COUNT, duration, (((tb_hong_t)1000 * COUNT) / (duration? duration : 1)));
+
+        // exit scheduler
+        tb_lo_scheduler_exit(scheduler);
+    }
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_lo_coroutine_channel_main(tb_int_t argc, tb_char_t** argv)
+{
+    tb_demo_lo_coroutine_channel_test(0);
+    tb_demo_lo_coroutine_channel_test(1);
+    tb_demo_lo_coroutine_channel_test(5);
+    tb_demo_lo_coroutine_channel_select();
+
+    tb_demo_lo_coroutine_channel_perf(1);
+    tb_demo_lo_coroutine_channel_perf(10);
+    return 0;
+}
@@ -0,0 +1,269 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the message count
+#define COUNT           (1000000)
+
+// the ping-pong count
+#define COUNT_PINGPONG  (100000)
+
+// the worker count of thread pool
+#define WORKERS         (4)
+
+// the batch size
+#define BATCH           (64)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the throughput test type
+typedef struct __tb_demo_throughput_t
+{
+    // the channel
+    tb_co_thread_channel_ref_t  channel;
+
+    // the send batch size
+    tb_size_t                   batch;
+
+    // the sent message count
+    tb_atomic_t                 sent;
+
+    // the sent times (us) of all messages
+    tb_hong_t*                  stimes;
+
+    // the latencies (us) of all messages
+    tb_hong_t*                  latencies;
+
+}tb_demo_throughput_t;
+
+// the ping-pong test type
+typedef struct __tb_demo_pingpong_t
+{
+    // the request channel, coroutine -> thread
+    tb_co_thread_channel_ref_t  request;
+
+    // the response channel, thread -> coroutine
+    tb_co_thread_channel_ref_t  response;
+
+    // the latencies (us) of all round-trips
+    tb_hong_t*                  latencies;
+
+}tb_demo_pingpong_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_int_t tb_demo_latency_comp(tb_cpointer_t ldata, tb_cpointer_t rdata)
+{
+    tb_hong_t l = *((tb_hong_t const*)ldata);
+    tb_hong_t r = *((tb_hong_t const*)rdata);
+    return l < r? -1 : (l > r);
+}
+static tb_void_t tb_demo_latency_dump(tb_char_t const* name, tb_hong_t* latencies, tb_size_t count, tb_hong_t duration)
+{
+    // sort latencies
+    qsort(latencies, count, sizeof(tb_hong_t), (tb_int_t (*)(tb_cpointer_t, tb_cpointer_t))tb_demo_latency_comp);
+
+    // trace
+    tb_trace_i("%s: %lu messages in %lld ms, %lld messages per second, latency: p50 %lld us, p99 %lld us, max %lld us"
+                , name, count, duration, duration? ((tb_hong_t)1000 * count) / duration : 0
+                , latencies[count / 2], latencies[(count * 99) / 100], latencies[count - 1]);
+}
+static tb_void_t tb_demo_throughput_send(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // check
+    tb_demo_throughput_t* test = (tb_demo_throughput_t*)priv;
+    tb_assert_and_check_return(test && test->channel);
+
+    // send all messages for this worker, the message is (index + 1)
+    tb_size_t     i;
+    tb_size_t     n = 0;
+    tb_cpointer_t list[BATCH];
+    for (i = 0; i < COUNT / WORKERS; i++)
+    {
+        tb_size_t index = tb_atomic_fetch_and_add(&test->sent, 1);
+        test->stimes[index] = tb_uclock();
+        list[n++] = tb_u2p(index + 1);
+        if (n == test->batch)
+        {
+            if (tb_co_thread_channel_send_batch(test->channel, list, n, -1) != n) break;
+            n = 0;
+        }
+    }
+    if (n) tb_co_thread_channel_send_batch(test->channel, list, n, -1);
+}
+static tb_void_t tb_demo_throughput_recv(tb_cpointer_t priv)
+{
+    // check
+    tb_demo_throughput_t* test = (tb_demo_throughput_t*)priv;
+    tb_assert_and_check_return(test && test->channel);
+
+    // recv all messages
+    tb_size_t    i;
+    tb_size_t    count = 0;
+    tb_pointer_t list[256];
+    while (count < COUNT)
+    {
+        tb_size_t real = tb_co_thread_channel_recv_batch(test->channel, list, tb_arrayn(list), -1);
+        tb_check_break(real);
+
+        tb_hong_t now = tb_uclock();
+        for (i = 0; i < real; i++)
+        {
+            tb_size_t index = tb_p2u32(list[i]) - 1;
+            test->latencies[count++] = now - test->stimes[index];
+        }
+    }
+}
+static tb_void_t tb_demo_throughput(tb_size_t maxn, tb_size_t batch)
+{
+    // init scheduler
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    tb_thread_pool_ref_t  pool = tb_thread_pool_init(WORKERS, 0);
+    if (scheduler && pool)
+    {
+        // init test
+        tb_demo_throughput_t test;
+        test.batch      = batch;
+        test.channel    = tb_co_thread_channel_init(maxn, tb_null, tb_null);
+        test.stimes     = tb_nalloc0_type(COUNT, tb_hong_t);
+        test.latencies  = tb_nalloc0_type(COUNT, tb_hong_t);
+        tb_atomic_init(&test.sent, 0);
+        tb_assert(test.channel && test.stimes && test.latencies);
+
+        // start the receiver coroutine
+        tb_coroutine_start(scheduler, tb_demo_throughput_recv, &test, 0);
+
+        // init the start time
+        tb_hong_t startime = tb_mclock();
+
+        // post the sender tasks
+        tb_size_t i;
+        for (i = 0; i < WORKERS; i++)
+            tb_thread_pool_task_post(pool, "send", tb_demo_throughput_send, tb_null, &test, tb_false);
+
+        // run scheduler
+        tb_co_scheduler_loop(scheduler, tb_true);
+
+        // computing time
+        tb_hong_t duration = tb_mclock() - startime;
+
+        // wait all senders
+        tb_thread_pool_task_wait_all(pool, -1);
+
+        // trace
+        tb_char_t name[64];
+        tb_snprintf(name, sizeof(name), "thread -> coroutine(maxn: %lu, batch: %lu)", maxn, batch);
+        tb_demo_latency_dump(name, test.latencies, COUNT, duration);
+
+        // exit test
+        tb_co_thread_channel_exit(test.channel);
+        tb_free(test.stimes);
+        tb_free(test.latencies);
+    }
+    if (pool) tb_thread_pool_exit(pool);
+    if (scheduler) tb_co_scheduler_exit(scheduler);
+}
+static tb_int_t tb_demo_pingpong_thread(tb_cpointer_t priv)
+{
+    // check
+    tb_demo_pingpong_t* test = (tb_demo_pingpong_t*)priv;
+    tb_assert_and_check_return_val(test, -1);
+
+    // echo all requests until the request channel is closed
+    tb_pointer_t data = tb_null;
+    while (tb_co_thread_channel_recv(test->request, &data, -1))
+    {
+        if (!tb_co_thread_channel_send(test->response, data, -1)) break;
+    }
+    return 0;
+}
+static tb_void_t tb_demo_pingpong_coroutine(tb_cpointer_t priv)
+{
+    // check
+    tb_demo_pingpong_t* test = (tb_demo_pingpong_t*)priv;
+    tb_assert_and_check_return(test);
+
+    // ping-pong
+    tb_size_t    i;
+    tb_pointer_t data = tb_null;
+    for (i = 0; i < COUNT_PINGPONG; i++)
+    {
+        tb_hong_t stime = tb_uclock();
+        if (!tb_co_thread_channel_send(test->request, tb_u2p(i + 1), -1)) break;
+        if (!tb_co_thread_channel_recv(test->response, &data, -1)) break;
+        tb_assert(tb_p2u32(data) == i + 1);
+        test->latencies[i] = tb_uclock() - stime;
+    }
+
+    // close the request channel to stop the thread
+    tb_co_thread_channel_close(test->request);
+}
+static tb_void_t tb_demo_pingpong(tb_size_t maxn)
+{
+    // init scheduler
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    if (scheduler)
+    {
+        // init test
+        tb_demo_pingpong_t test;
+        test.request    = tb_co_thread_channel_init(maxn, tb_null, tb_null);
+        test.response   = tb_co_thread_channel_init(maxn, tb_null, tb_null);
+        test.latencies  = tb_nalloc0_type(COUNT_PINGPONG, tb_hong_t);
+        tb_assert(test.request && test.response && test.latencies);
+
+        // start the echo thread
+        tb_thread_ref_t thread = tb_thread_init(tb_null, tb_demo_pingpong_thread, &test, 0);
+        if (thread)
+        {
+            // start the ping-pong coroutine
+            tb_coroutine_start(scheduler, tb_demo_pingpong_coroutine, &test, 0);
+
+            // run scheduler
+            tb_hong_t startime = tb_mclock();
+            tb_co_scheduler_loop(scheduler, tb_true);
+            tb_hong_t duration = tb_mclock() - startime;
+
+            // wait and exit thread
+            tb_thread_wait(thread, -1, tb_null);
+            tb_thread_exit(thread);
+
+            // trace
+            tb_char_t name[64];
+            tb_snprintf(name, sizeof(name), "coroutine <-> thread(maxn: %lu)", maxn);
+            tb_demo_latency_dump(name, test.latencies, COUNT_PINGPONG, duration);
+        }
+
+        // exit test
+        tb_co_thread_channel_exit(test.request);
+        tb_co_thread_channel_exit(test.response);
+        tb_free(test.latencies);
+
+        // exit scheduler
+        tb_co_scheduler_exit(scheduler);
+    }
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_coroutine_thread_channel_main(tb_int_t argc, tb_char_t** argv)
+{
+    // thread pool -> coroutine scheduler
+    tb_demo_throughput(0, 1);
+    tb_demo_throughput(0, BATCH);
+    tb_demo_throughput(1024, 1);
+    tb_demo_throughput(1024, BATCH);
+
+    // coroutine scheduler <-> thread
+    tb_demo_pingpong(0);
+    tb_demo_pingpong(1);
+    return 0;
+}
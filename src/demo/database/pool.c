@@ -0,0 +1,249 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the row count
+#define TB_DEMO_ROW_COUNT           (1000)
+
+// the connection maxn
+#define TB_DEMO_POOL_MAXN           (2)
+
+// the thread count
+#define TB_DEMO_THREAD_COUNT        (4)
+
+// the coroutine count
+#define TB_DEMO_COROUTINE_COUNT     (16)
+
+// the query count of each thread or coroutine
+#define TB_DEMO_QUERY_COUNT         (2000)
+
+// the query count for comparing the statement cache
+#define TB_DEMO_PREPARE_COUNT       (100000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_bool_t tb_demo_database_pool_query(tb_database_sql_ref_t database, tb_size_t id)
+{
+    // init statement, it will be reused from the statement cache
+    tb_database_sql_statement_ref_t statement = tb_database_sql_statement_init(database, "select name, number from table1 where id = ?");
+    tb_check_return_val(statement, tb_false);
+
+    // select it
+    tb_bool_t ok = tb_false;
+    do
+    {
+        // bind id
+        tb_database_sql_value_t list[1];
+        tb_database_sql_value_set_int32(&list[0], (tb_int32_t)id);
+        if (!tb_database_sql_statement_bind(database, statement, list, tb_arrayn(list))) break;
+
+        // done statement
+        if (!tb_database_sql_statement_done(database, statement)) break;
+
+        // load result
+        tb_iterator_ref_t result = tb_database_sql_result_load(database, tb_false);
+        tb_check_break(result);
+
+        // check number
+        tb_for_all_if (tb_iterator_ref_t, row, result, row)
+        {
+            tb_database_sql_value_t const* number = (tb_database_sql_value_t const*)tb_iterator_item(row, 1);
+            if (number && tb_database_sql_value_int32(number) == (tb_int32_t)(id * 7)) ok = tb_true;
+        }
+
+        // exit result
+        tb_database_sql_result_exit(database, result);
+
+    } while (0);
+
+    // exit statement, it will be reset and kept in the statement cache
+    tb_database_sql_statement_exit(database, statement);
+    return ok;
+}
+static tb_size_t tb_demo_database_pool_queries(tb_database_sql_pool_ref_t pool)
+{
+    // checkout a connection for each query
+    tb_size_t   i;
+    tb_size_t   failed = 0;
+    tb_uint32_t seed = (tb_uint32_t)tb_p2u32(&i);
+    for (i = 0; i < TB_DEMO_QUERY_COUNT; i++)
+    {
+        tb_database_sql_ref_t database = tb_database_sql_pool_checkout(pool, -1);
+        if (database)
+        {
+            seed = seed * 1103515245 + 12345;
+            if (!tb_demo_database_pool_query(database, (seed >> 8) % TB_DEMO_ROW_COUNT)) failed++;
+            tb_database_sql_pool_checkin(pool, database);
+        }
+        else failed++;
+    }
+    return failed;
+}
+static tb_int_t tb_demo_database_pool_thread(tb_cpointer_t priv)
+{
+    return tb_demo_database_pool_queries((tb_database_sql_pool_ref_t)priv)? -1 : 0;
+}
+#ifdef TB_CONFIG_MODULE_HAVE_COROUTINE
+static tb_void_t tb_demo_database_pool_coroutine(tb_cpointer_t priv)
+{
+    if (tb_demo_database_pool_queries((tb_database_sql_pool_ref_t)priv))
+        tb_trace_e("coroutine: %p failed", tb_coroutine_self());
+}
+#endif
+static tb_void_t tb_demo_database_pool_trace(tb_char_t const* name, tb_database_sql_pool_ref_t pool, tb_hong_t time, tb_size_t count, tb_size_t failed)
+{
+    // get stat
+    tb_database_sql_pool_stat_t stat;
+    tb_database_sql_pool_stat(pool, &stat);
+
+    // trace
+    tb_trace_i("%s: %lu queries in %lld ms, failed: %lu", name, count, time, failed);
+    tb_trace_i("%s: connections: %lu, idle: %lu, opened: %llu, closed: %llu", name, stat.size, stat.idle, stat.opened, stat.closed);
+    tb_trace_i("%s: checkouts: %llu, waits: %llu, timeouts: %llu, wait time: %lld ms, avg: %lld us, max: %lld ms", name, stat.checkouts, stat.waits, stat.timeouts, stat.wait_time, stat.waits? stat.wait_time * 1000 / (tb_hong_t)stat.waits : 0, stat.wait_maxn);
+    tb_trace_i("%s: statement cache: hits: %llu, misses: %llu", name, stat.statement_hits, stat.statement_misses);
+}
+static tb_void_t tb_demo_database_pool_threads(tb_database_sql_pool_ref_t pool)
+{
+    // start threads
+    tb_size_t       i;
+    tb_size_t       failed = 0;
+    tb_thread_ref_t threads[TB_DEMO_THREAD_COUNT] = {0};
+    tb_hong_t       time = tb_mclock();
+    for (i = 0; i < TB_DEMO_THREAD_COUNT; i++)
+        threads[i] = tb_thread_init(tb_null, tb_demo_database_pool_thread, pool, 0);
+
+    // wait threads
+    for (i = 0; i < TB_DEMO_THREAD_COUNT; i++)
+    {
+        tb_int_t retval = -1;
+        if (threads[i])
+        {
+            tb_thread_wait(threads[i], -1, &retval);
+            tb_thread_exit(threads[i]);
+        }
+        if (retval) failed++;
+    }
+    time = tb_mclock() - time;
+
+    // trace
+    tb_demo_database_pool_trace("threads", pool, time, TB_DEMO_THREAD_COUNT * TB_DEMO_QUERY_COUNT, failed);
+}
+#ifdef TB_CONFIG_MODULE_HAVE_COROUTINE
+static tb_void_t tb_demo_database_pool_coroutines(tb_database_sql_pool_ref_t pool)
+{
+    // init scheduler
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    if (scheduler)
+    {
+        // start coroutines
+        tb_size_t i;
+        tb_hong_t time = tb_mclock();
+        for (i = 0; i < TB_DEMO_COROUTINE_COUNT; i++)
+            tb_coroutine_start(scheduler, tb_demo_database_pool_coroutine, pool, 0);
+
+        // run scheduler
+        tb_co_scheduler_loop(scheduler, tb_true);
+        time = tb_mclock() - time;
+
+        // trace
+        tb_demo_database_pool_trace("coroutines", pool, time, TB_DEMO_COROUTINE_COUNT * TB_DEMO_QUERY_COUNT, 0);
+
+        // exit scheduler
+        tb_co_scheduler_exit(scheduler);
+    }
+}
+#endif
+static tb_void_t tb_demo_database_pool_prepare(tb_database_sql_ref_t database, tb_size_t cache_maxn)
+{
+    // set the statement cache
+    tb_database_sql_statement_cache_set(database, cache_maxn);
+
+    // done queries
+    tb_size_t i;
+    tb_size_t failed = 0;
+    tb_hong_t time = tb_mclock();
+    for (i = 0; i < TB_DEMO_PREPARE_COUNT; i++)
+    {
+        if (!tb_demo_database_pool_query(database, i % TB_DEMO_ROW_COUNT)) failed++;
+    }
+    time = tb_mclock() - time;
+
+    // trace
+    tb_database_sql_statement_cache_stat_t stat;
+    tb_database_sql_statement_cache_stat(database, &stat);
+    tb_trace_i("prepare: cache: %lu, %lu queries in %lld ms, %lld queries/s, failed: %lu, hits: %llu, misses: %llu", cache_maxn, i, time, time? (tb_hong_t)i * 1000 / time : 0, failed, stat.hits, stat.misses);
+}
+static tb_bool_t tb_demo_database_pool_init(tb_database_sql_ref_t database)
+{
+    // create table
+    if (!tb_database_sql_done(database, "drop table if exists table1")) return tb_false;
+    if (!tb_database_sql_done(database, "create table table1(id int primary key, name text, number int)")) return tb_false;
+
+    // insert rows
+    tb_bool_t                       ok = tb_false;
+    tb_database_sql_statement_ref_t statement = tb_database_sql_statement_init(database, "insert into table1 values(?, 'name', ?)");
+    tb_database_sql_value_t*        list = tb_nalloc0_type(TB_DEMO_ROW_COUNT * 2, tb_database_sql_value_t);
+    if (statement && list)
+    {
+        tb_size_t i;
+        for (i = 0; i < TB_DEMO_ROW_COUNT; i++)
+        {
+            tb_database_sql_value_set_int32(&list[i * 2], (tb_int32_t)i);
+            tb_database_sql_value_set_int32(&list[i * 2 + 1], (tb_int32_t)(i * 7));
+        }
+        ok = tb_database_sql_statement_bulk(database, statement, list, 2, TB_DEMO_ROW_COUNT);
+    }
+    if (list) tb_free(list);
+    if (statement) tb_database_sql_statement_exit(database, statement);
+    return ok;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_database_pool_main(tb_int_t argc, tb_char_t** argv)
+{
+    // the database url, we use a temporary sqlite3 database by default
+    tb_char_t url[TB_PATH_MAXN];
+    if (argc > 1 && argv[1]) tb_strlcpy(url, argv[1], sizeof(url));
+    else if (tb_directory_temporary(url, sizeof(url))) tb_strcat(url, "/tbox_demo_pool.sqlite3");
+    else return -1;
+
+    // init pool
+    tb_database_sql_pool_ref_t pool = tb_database_sql_pool_init(url, TB_DEMO_POOL_MAXN, 0);
+    if (pool)
+    {
+        // init table
+        tb_database_sql_ref_t database = tb_database_sql_pool_checkout(pool, -1);
+        if (database)
+        {
+            tb_bool_t ok = tb_demo_database_pool_init(database);
+            if (ok)
+            {
+                // compare the statement cache
+                tb_demo_database_pool_prepare(database, 0);
+                tb_demo_database_pool_prepare(database, 16);
+            }
+            tb_database_sql_pool_checkin(pool, database);
+
+            // done queries in threads and coroutines
+            if (ok)
+            {
+                tb_demo_database_pool_threads(pool);
+#ifdef TB_CONFIG_MODULE_HAVE_COROUTINE
+                tb_demo_database_pool_coroutines(pool);
+#endif
+            }
+        }
+
+        // exit pool
+        tb_database_sql_pool_exit(pool);
+    }
+    return 0;
+}
@@ -3,6 +3,16 @@
  */
 #include "../demo.h"
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the row count of inserting one by one
+#define TB_DEMO_ROW_COUNT_ONE       (1000)
+
+// the row count of inserting in bulk
+#define TB_DEMO_ROW_COUNT_BULK      (100000)
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * test
  */
@@ -249,6 +259,140 @@ static tb_void_t tb_demo_database_sql_test_statement_done_insert(tb_database_sql
     if (stream) tb_stream_exit(stream);
 }
 
+static tb_bool_t tb_demo_database_sql_bench_insert(tb_database_sql_ref_t database, tb_size_t count, tb_bool_t bulk)
+{
+    // init statement
+    tb_database_sql_statement_ref_t statement = tb_database_sql_statement_init(database, "insert into table3 values(?, ?, ?)");
+    tb_check_return_val(statement, tb_false);
+
+    // make rows
+    tb_size_t                   i;
+    tb_database_sql_value_t*    list = tb_nalloc0_type(count * 3, tb_database_sql_value_t);
+    if (list)
+    {
+        for (i = 0; i < count; i++)
+        {
+            tb_database_sql_value_set_int64(&list[i * 3], (tb_int64_t)i);
+            tb_database_sql_value_set_text(&list[i * 3 + 1], "name", 4);
+            tb_database_sql_value_set_int32(&list[i * 3 + 2], (tb_int32_t)(i * 7));
+        }
+    }
+
+    // insert rows
+    tb_bool_t ok = tb_false;
+    tb_hong_t time = tb_mclock();
+    if (list)
+    {
+        if (bulk) ok = tb_database_sql_statement_bulk(database, statement, list, 3, count);
+        else
+        {
+            for (i = 0; i < count; i++)
+            {
+                if (!tb_database_sql_statement_bind(database, statement, list + i * 3, 3)) break;
+                if (!tb_database_sql_statement_done(database, statement)) break;
+            }
+            ok = (i == count);
+        }
+    }
+    time = tb_mclock() - time;
+
+    // trace
+    tb_trace_i("insert: %s: %lu rows in %lld ms, %lld rows/s: %s", bulk? "bulk" : "one by one", count, time, time? (tb_hong_t)count * 1000 / time : 0, ok? "ok" : "failed");
+
+    // exit rows
+    if (list) tb_free(list);
+
+    // exit statement
+    tb_database_sql_statement_exit(database, statement);
+    return ok;
+}
+static tb_void_t tb_demo_database_sql_bench_select(tb_database_sql_ref_t database, tb_char_t const* sql, tb_bool_t batched, tb_bool_t prepared)
+{
+    // done sql or statement
+    tb_database_sql_statement_ref_t statement = tb_null;
+    if (prepared)
+    {
+        statement = tb_database_sql_statement_init(database, sql);
+        if (!statement || !tb_database_sql_statement_done(database, statement))
+        {
+            if (statement) tb_database_sql_statement_exit(database, statement);
+            return ;
+        }
+    }
+    else if (!tb_database_sql_done(database, sql)) return ;
+
+    // select rows
+    tb_size_t count = 0;
+    tb_hong_t total = 0;
+    tb_hong_t time = tb_mclock();
+    if (batched)
+    {
+        tb_database_sql_batch_ref_t batch = tb_database_sql_batch_init(0);
+        if (batch)
+        {
+            tb_long_t size = 0;
+            while ((size = tb_database_sql_result_fetch(database, batch)) > 0)
+            {
+                // sum the number column and the name sizes
+                tb_long_t                       i;
+                tb_database_sql_column_t const* name = tb_database_sql_batch_column(batch, 1);
+                tb_database_sql_column_t const* number = tb_database_sql_batch_column(batch, 2);
+                for (i = 0; i < size; i++)
+                {
+                    if (number->types[i] == TB_DATABASE_SQL_VALUE_TYPE_INT64) total += number->ints[i];
+                    else if (number->types[i] == TB_DATABASE_SQL_VALUE_TYPE_TEXT) total += tb_stoi64((tb_char_t const*)number->datas[i]);
+                    total += name->sizes[i];
+                }
+                count += size;
+            }
+            tb_database_sql_batch_exit(batch);
+        }
+    }
+    else
+    {
+        tb_iterator_ref_t result = tb_database_sql_result_load(database, tb_false);
+        if (result)
+        {
+            tb_for_all_if (tb_iterator_ref_t, row, result, row)
+            {
+                tb_database_sql_value_t const* name = (tb_database_sql_value_t const*)tb_iterator_item(row, 1);
+                if (name) total += tb_database_sql_value_size(name);
+
+                tb_database_sql_value_t const* number = (tb_database_sql_value_t const*)tb_iterator_item(row, 2);
+                if (number) total += tb_database_sql_value_int64(number);
+                count++;
+            }
+            tb_database_sql_result_exit(database, result);
+        }
+    }
+    time = tb_mclock() - time;
+
+    // trace
+    tb_trace_i("select: %s, %s: %lu rows in %lld ms, %lld rows/s, total: %lld", prepared? "statement" : "sql", batched? "batch" : "iterator", count, time, time? (tb_hong_t)count * 1000 / time : 0, total);
+
+    // exit statement
+    if (statement) tb_database_sql_statement_exit(database, statement);
+}
+static tb_void_t tb_demo_database_sql_bench(tb_database_sql_ref_t database)
+{
+    // trace
+    tb_trace_i("==============================================================================");
+
+    // create table
+    if (!tb_database_sql_done(database, "drop table if exists table3")) return ;
+    if (!tb_database_sql_done(database, "create table table3(id bigint, name text, number int)")) return ;
+
+    // insert rows
+    if (!tb_demo_database_sql_bench_insert(database, TB_DEMO_ROW_COUNT_ONE, tb_false)) return ;
+    if (!tb_demo_database_sql_bench_insert(database, TB_DEMO_ROW_COUNT_BULK, tb_true)) return ;
+
+    // select rows
+    tb_demo_database_sql_bench_select(database, "select * from table3", tb_false, tb_false);
+    tb_demo_database_sql_bench_select(database, "select * from table3", tb_true, tb_false);
+    tb_demo_database_sql_bench_select(database, "select * from table3", tb_false, tb_true);
+    tb_demo_database_sql_bench_select(database, "select * from table3", tb_true, tb_true);
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * main
  */
@@ -272,6 +416,8 @@ tb_int_t tb_demo_database_sql_main(tb_int_t argc, tb_char_t** argv)
             tb_demo_database_sql_test_done(database, "insert into table1 values(6, 'name6', 21000)");
             tb_demo_database_sql_test_done(database, "insert into table1 values(7, 'name7', 21600)");
             tb_demo_database_sql_test_done(database, "select * from table1");
+            tb_demo_database_sql_test_done(database, "update table1 set number = number + 1 where id = 1; select * from table1 where id < 3");
+            tb_demo_database_sql_test_done(database, "select * from table1 where id = 1; select * from table1 where id = 2");
 
             // remove first
             tb_demo_database_sql_test_statement_done(database, "drop table if exists table2");
@@ -296,6 +442,9 @@ tb_int_t tb_demo_database_sql_main(tb_int_t argc, tb_char_t** argv)
                 // select
                 tb_demo_database_sql_test_statement_done(database, "select * from table2");
             }
+
+            // benchmark
+            tb_demo_database_sql_bench(database);
         }
         else
         {
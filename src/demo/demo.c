@@ -37,6 +37,7 @@ static tb_demo_t g_demo[] =
 ,   TB_DEMO_MAIN_ITEM(libc_wchar)
 ,   TB_DEMO_MAIN_ITEM(libc_string)
 ,   TB_DEMO_MAIN_ITEM(libc_stdlib)
+,   TB_DEMO_MAIN_ITEM(libc_stdio)
 ,   TB_DEMO_MAIN_ITEM(libc_wcstombs)
 ,   TB_DEMO_MAIN_ITEM(libc_mbstowcs)
 
@@ -50,6 +51,7 @@ static tb_demo_t g_demo[] =
     // database
 #ifdef TB_CONFIG_MODULE_HAVE_DATABASE
 ,   TB_DEMO_MAIN_ITEM(database_sql)
+,   TB_DEMO_MAIN_ITEM(database_pool)
 #endif
 
     // xml
@@ -79,6 +81,7 @@ static tb_demo_t g_demo[] =
 #endif
 ,   TB_DEMO_MAIN_ITEM(utils_base32)
 ,   TB_DEMO_MAIN_ITEM(utils_base64)
+,   TB_DEMO_MAIN_ITEM(utils_metrics)
 
     // hash
 #ifdef TB_CONFIG_MODULE_HAVE_HASH
@@ -93,6 +96,9 @@ static tb_demo_t g_demo[] =
 ,   TB_DEMO_MAIN_ITEM(hash_fnv32)
 ,   TB_DEMO_MAIN_ITEM(hash_fnv64)
 ,   TB_DEMO_MAIN_ITEM(hash_adler32)
+,   TB_DEMO_MAIN_ITEM(hash_wyhash)
+,   TB_DEMO_MAIN_ITEM(hash_xxhash)
+,   TB_DEMO_MAIN_ITEM(hash_quality)
 ,   TB_DEMO_MAIN_ITEM(hash_benchmark)
 #endif
 
@@ -119,8 +125,11 @@ static tb_demo_t g_demo[] =
 ,   TB_DEMO_MAIN_ITEM(stream)
 ,   TB_DEMO_MAIN_ITEM(stream_null)
 ,   TB_DEMO_MAIN_ITEM(stream_cache)
+,   TB_DEMO_MAIN_ITEM(stream_mmap)
+,   TB_DEMO_MAIN_ITEM(stream_transfer)
 ,   TB_DEMO_MAIN_ITEM(stream_charset)
 ,   TB_DEMO_MAIN_ITEM(stream_zip)
+,   TB_DEMO_MAIN_ITEM(stream_zip_bench)
 
     // string
 ,   TB_DEMO_MAIN_ITEM(string_string)
@@ -171,11 +180,13 @@ static tb_demo_t g_demo[] =
 ,   TB_DEMO_MAIN_ITEM(platform_hostname)
 ,   TB_DEMO_MAIN_ITEM(platform_backtrace)
 ,   TB_DEMO_MAIN_ITEM(platform_directory)
+,   TB_DEMO_MAIN_ITEM(platform_directory_walk)
 ,   TB_DEMO_MAIN_ITEM(platform_cache_time)
 ,   TB_DEMO_MAIN_ITEM(platform_environment)
 ,   TB_DEMO_MAIN_ITEM(platform_pipe_pair)
 ,   TB_DEMO_MAIN_ITEM(platform_named_pipe)
 ,   TB_DEMO_MAIN_ITEM(platform_lock)
+,   TB_DEMO_MAIN_ITEM(platform_lock_bench)
 ,   TB_DEMO_MAIN_ITEM(platform_timer)
 ,   TB_DEMO_MAIN_ITEM(platform_ltimer)
 ,   TB_DEMO_MAIN_ITEM(platform_event)
@@ -183,10 +194,13 @@ static tb_demo_t g_demo[] =
 ,   TB_DEMO_MAIN_ITEM(platform_thread)
 ,   TB_DEMO_MAIN_ITEM(platform_thread_pool)
 ,   TB_DEMO_MAIN_ITEM(platform_thread_local)
+,   TB_DEMO_MAIN_ITEM(platform_reclaim)
 ,   TB_DEMO_MAIN_ITEM(platform_poller_pipe)
 ,   TB_DEMO_MAIN_ITEM(platform_poller_client)
 ,   TB_DEMO_MAIN_ITEM(platform_poller_server)
 ,   TB_DEMO_MAIN_ITEM(platform_poller_process)
+,   TB_DEMO_MAIN_ITEM(platform_poller_bench)
+,   TB_DEMO_MAIN_ITEM(platform_udp_batch)
 #ifdef TB_CONFIG_MODULE_HAVE_COROUTINE
 ,   TB_DEMO_MAIN_ITEM(platform_context)
 #endif
@@ -224,21 +238,26 @@ static tb_demo_t g_demo[] =
 ,   TB_DEMO_MAIN_ITEM(coroutine_switch)
 ,   TB_DEMO_MAIN_ITEM(coroutine_thread)
 ,   TB_DEMO_MAIN_ITEM(coroutine_channel)
+,   TB_DEMO_MAIN_ITEM(coroutine_thread_channel)
 ,   TB_DEMO_MAIN_ITEM(coroutine_semaphore)
 ,   TB_DEMO_MAIN_ITEM(coroutine_process)
 ,   TB_DEMO_MAIN_ITEM(coroutine_process_pipe)
 ,   TB_DEMO_MAIN_ITEM(coroutine_echo_server)
 ,   TB_DEMO_MAIN_ITEM(coroutine_echo_client)
+,   TB_DEMO_MAIN_ITEM(coroutine_echo_latency)
 ,   TB_DEMO_MAIN_ITEM(coroutine_unix_echo_server)
 ,   TB_DEMO_MAIN_ITEM(coroutine_unix_echo_client)
 ,   TB_DEMO_MAIN_ITEM(coroutine_file_server)
 ,   TB_DEMO_MAIN_ITEM(coroutine_file_client)
 ,   TB_DEMO_MAIN_ITEM(coroutine_http_server)
+,   TB_DEMO_MAIN_ITEM(coroutine_relay)
 ,   TB_DEMO_MAIN_ITEM(coroutine_spider)
 
     // stackless coroutine
 ,   TB_DEMO_MAIN_ITEM(lo_coroutine_nest)
 ,   TB_DEMO_MAIN_ITEM(lo_coroutine_lock)
+,   TB_DEMO_MAIN_ITEM(lo_coroutine_bench)
+,   TB_DEMO_MAIN_ITEM(lo_coroutine_channel)
 ,   TB_DEMO_MAIN_ITEM(lo_coroutine_sleep)
 ,   TB_DEMO_MAIN_ITEM(lo_coroutine_switch)
 ,   TB_DEMO_MAIN_ITEM(lo_coroutine_process)
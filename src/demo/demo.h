@@ -41,6 +41,7 @@ __tb_extern_c_enter__
 
 // database
 TB_DEMO_MAIN_DECL(database_sql);
+TB_DEMO_MAIN_DECL(database_pool);
 
 // regex
 TB_DEMO_MAIN_DECL(regex);
@@ -55,6 +56,7 @@ TB_DEMO_MAIN_DECL(libc_time);
 TB_DEMO_MAIN_DECL(libc_wchar);
 TB_DEMO_MAIN_DECL(libc_string);
 TB_DEMO_MAIN_DECL(libc_stdlib);
+TB_DEMO_MAIN_DECL(libc_stdio);
 TB_DEMO_MAIN_DECL(libc_mbstowcs);
 TB_DEMO_MAIN_DECL(libc_wcstombs);
 
@@ -74,6 +76,7 @@ TB_DEMO_MAIN_DECL(utils_dump);
 TB_DEMO_MAIN_DECL(utils_option);
 TB_DEMO_MAIN_DECL(utils_base32);
 TB_DEMO_MAIN_DECL(utils_base64);
+TB_DEMO_MAIN_DECL(utils_metrics);
 
 // hash
 TB_DEMO_MAIN_DECL(hash_md5);
@@ -87,6 +90,9 @@ TB_DEMO_MAIN_DECL(hash_crc32);
 TB_DEMO_MAIN_DECL(hash_fnv32);
 TB_DEMO_MAIN_DECL(hash_fnv64);
 TB_DEMO_MAIN_DECL(hash_adler32);
+TB_DEMO_MAIN_DECL(hash_wyhash);
+TB_DEMO_MAIN_DECL(hash_xxhash);
+TB_DEMO_MAIN_DECL(hash_quality);
 TB_DEMO_MAIN_DECL(hash_benchmark);
 
 // other
@@ -110,8 +116,11 @@ TB_DEMO_MAIN_DECL(stream_async_transfer);
 TB_DEMO_MAIN_DECL(stream_async_stream);
 TB_DEMO_MAIN_DECL(stream);
 TB_DEMO_MAIN_DECL(stream_zip);
+TB_DEMO_MAIN_DECL(stream_zip_bench);
 TB_DEMO_MAIN_DECL(stream_null);
 TB_DEMO_MAIN_DECL(stream_cache);
+TB_DEMO_MAIN_DECL(stream_mmap);
+TB_DEMO_MAIN_DECL(stream_transfer);
 TB_DEMO_MAIN_DECL(stream_charset);
 TB_DEMO_MAIN_DECL(stream_async_stream_zip);
 TB_DEMO_MAIN_DECL(stream_async_stream_null);
@@ -154,6 +163,7 @@ TB_DEMO_MAIN_DECL(network_impl_date);
 // platform
 TB_DEMO_MAIN_DECL(platform_file);
 TB_DEMO_MAIN_DECL(platform_lock);
+TB_DEMO_MAIN_DECL(platform_lock_bench);
 TB_DEMO_MAIN_DECL(platform_path);
 TB_DEMO_MAIN_DECL(platform_sched);
 TB_DEMO_MAIN_DECL(platform_event);
@@ -173,6 +183,7 @@ TB_DEMO_MAIN_DECL(platform_pipe_pair);
 TB_DEMO_MAIN_DECL(platform_named_pipe);
 TB_DEMO_MAIN_DECL(platform_backtrace);
 TB_DEMO_MAIN_DECL(platform_directory);
+TB_DEMO_MAIN_DECL(platform_directory_walk);
 TB_DEMO_MAIN_DECL(platform_exception);
 TB_DEMO_MAIN_DECL(platform_semaphore);
 TB_DEMO_MAIN_DECL(platform_cache_time);
@@ -180,10 +191,13 @@ TB_DEMO_MAIN_DECL(platform_environment);
 TB_DEMO_MAIN_DECL(platform_thread);
 TB_DEMO_MAIN_DECL(platform_thread_pool);
 TB_DEMO_MAIN_DECL(platform_thread_local);
+TB_DEMO_MAIN_DECL(platform_reclaim);
 TB_DEMO_MAIN_DECL(platform_poller_pipe);
 TB_DEMO_MAIN_DECL(platform_poller_client);
 TB_DEMO_MAIN_DECL(platform_poller_server);
 TB_DEMO_MAIN_DECL(platform_poller_process);
+TB_DEMO_MAIN_DECL(platform_poller_bench);
+TB_DEMO_MAIN_DECL(platform_udp_batch);
 TB_DEMO_MAIN_DECL(platform_context);
 
 // container
@@ -214,22 +228,27 @@ TB_DEMO_MAIN_DECL(coroutine_spider);
 TB_DEMO_MAIN_DECL(coroutine_stream);
 TB_DEMO_MAIN_DECL(coroutine_switch);
 TB_DEMO_MAIN_DECL(coroutine_channel);
+TB_DEMO_MAIN_DECL(coroutine_thread_channel);
 TB_DEMO_MAIN_DECL(coroutine_semaphore);
 TB_DEMO_MAIN_DECL(coroutine_thread);
 TB_DEMO_MAIN_DECL(coroutine_pipe);
 TB_DEMO_MAIN_DECL(coroutine_process);
 TB_DEMO_MAIN_DECL(coroutine_process_pipe);
 TB_DEMO_MAIN_DECL(coroutine_echo_client);
+TB_DEMO_MAIN_DECL(coroutine_echo_latency);
 TB_DEMO_MAIN_DECL(coroutine_echo_server);
 TB_DEMO_MAIN_DECL(coroutine_unix_echo_client);
 TB_DEMO_MAIN_DECL(coroutine_unix_echo_server);
 TB_DEMO_MAIN_DECL(coroutine_file_client);
 TB_DEMO_MAIN_DECL(coroutine_file_server);
 TB_DEMO_MAIN_DECL(coroutine_http_server);
+TB_DEMO_MAIN_DECL(coroutine_relay);
 
 // stackless coroutine
 TB_DEMO_MAIN_DECL(lo_coroutine_nest);
 TB_DEMO_MAIN_DECL(lo_coroutine_lock);
+TB_DEMO_MAIN_DECL(lo_coroutine_bench);
+TB_DEMO_MAIN_DECL(lo_coroutine_channel);
 TB_DEMO_MAIN_DECL(lo_coroutine_sleep);
 TB_DEMO_MAIN_DECL(lo_coroutine_switch);
 TB_DEMO_MAIN_DECL(lo_coroutine_process);
@@ -3,6 +3,16 @@
  */
 #include "../demo.h"
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the data size of the digest benchmark
+#define TB_DEMO_DIGEST_SIZE         (64 * 1024 * 1024)
+
+// the small messages count of the multi-buffer benchmark
+#define TB_DEMO_DIGEST_MULTI_COUNT  (64 * 1024)
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
@@ -125,11 +135,123 @@ static tb_void_t tb_demo_hash32_test()
     tb_free(data);
 }
 
+static tb_void_t tb_demo_digest_trace(tb_char_t const* name, tb_byte_t const* digest, tb_hize_t size, tb_hong_t time)
+{
+    // the speed in 1/100 GB/s
+    tb_hong_t speed = (tb_hong_t)(size * 100 * 1000 / ((tb_hize_t)(time? time : 1) << 30));
+    tb_trace_i("[digest]: %-28s: %02x%02x%02x%02x.. %5lld ms, %lld.%02lld GB/s", name, digest[0], digest[1], digest[2], digest[3], time, speed / 100, speed % 100);
+}
+static tb_void_t tb_demo_digest_test()
+{
+    // init data
+    tb_size_t   size = TB_DEMO_DIGEST_SIZE;
+    tb_byte_t*  data = tb_malloc_bytes(size);
+    tb_assert_and_check_return(data);
+
+    // make data
+    tb_size_t i = 0;
+    for (i = 0; i < size; i++) data[i] = (tb_byte_t)tb_random_range(0, 0xff);
+
+    // the portable and accelerated digests of the large data
+    tb_byte_t   digest[32];
+    tb_hong_t   t;
+    tb_size_t   features;
+    tb_trace_i("[digest]: cpu features: %lx", tb_cpu_features());
+    for (features = ~(tb_size_t)0; ; features = 0)
+    {
+        tb_cpu_features_disable(features);
+        tb_char_t const* impl = features? "portable" : "accelerated";
+        tb_char_t name[64];
+
+        t = tb_mclock();
+        tb_md5_make(data, size, digest, sizeof(digest));
+        t = tb_mclock() - t;
+        tb_snprintf(name, sizeof(name), "md5(%s)", impl);
+        tb_demo_digest_trace(name, digest, size, t);
+
+        t = tb_mclock();
+        tb_sha_make(TB_SHA_MODE_SHA1_160, data, size, digest, sizeof(digest));
+        t = tb_mclock() - t;
+        tb_snprintf(name, sizeof(name), "sha1(%s)", impl);
+        tb_demo_digest_trace(name, digest, size, t);
+
+        t = tb_mclock();
+        tb_sha_make(TB_SHA_MODE_SHA2_256, data, size, digest, sizeof(digest));
+        t = tb_mclock() - t;
+        tb_snprintf(name, sizeof(name), "sha256(%s)", impl);
+        tb_demo_digest_trace(name, digest, size, t);
+
+        tb_check_break(features);
+    }
+    tb_cpu_features_disable(TB_CPU_FEATURE_NONE);
+
+    // the tree digest of the large data in the thread pool
+    t = tb_mclock();
+    tb_sha_make_tree(TB_SHA_MODE_SHA2_256, data, size, digest, sizeof(digest), 0);
+    t = tb_mclock() - t;
+    tb_demo_digest_trace("sha256(tree)", digest, size, t);
+
+    // the digests of many small messages, 64 ~ 512 bytes
+    tb_size_t           count = TB_DEMO_DIGEST_MULTI_COUNT;
+    tb_byte_t const**   datas = tb_nalloc_type(count, tb_byte_t const*);
+    tb_size_t*          sizes = tb_nalloc_type(count, tb_size_t);
+    tb_byte_t*          digests = tb_malloc_bytes(count * 20);
+    tb_byte_t*          digests2 = tb_malloc_bytes(count * 20);
+    if (datas && sizes && digests && digests2)
+    {
+        // init messages
+        tb_hize_t total = 0;
+        for (i = 0; i < count; i++)
+        {
+            sizes[i] = tb_random_range(64, 512);
+            datas[i] = data + tb_random_range(0, size - 512);
+            total += sizes[i];
+        }
+
+        // md5 one by one
+        t = tb_mclock();
+        for (i = 0; i < count; i++) tb_md5_make(datas[i], sizes[i], digests + (i << 4), 16);
+        t = tb_mclock() - t;
+        tb_demo_digest_trace("md5(small x 64K)", digests, total, t);
+
+        // md5 in the parallel lanes
+        t = tb_mclock();
+        tb_md5_make_multi(datas, sizes, count, digests2);
+        t = tb_mclock() - t;
+        tb_demo_digest_trace("md5(small x 64K, multi)", digests2, total, t);
+        if (tb_memcmp(digests, digests2, count << 4)) tb_trace_e("[digest]: md5(multi) failed!");
+
+        // sha1 one by one
+        t = tb_mclock();
+        for (i = 0; i < count; i++) tb_sha_make(TB_SHA_MODE_SHA1_160, datas[i], sizes[i], digests + i * 20, 20);
+        t = tb_mclock() - t;
+        tb_demo_digest_trace("sha1(small x 64K)", digests, total, t);
+
+        // sha1 in the parallel lanes, we disable the sha extensions to force to use the avx2 lanes
+        tb_cpu_features_disable(TB_CPU_FEATURE_SHA);
+        t = tb_mclock();
+        tb_sha_make_multi(TB_SHA_MODE_SHA1_160, datas, sizes, count, digests2);
+        t = tb_mclock() - t;
+        tb_cpu_features_disable(TB_CPU_FEATURE_NONE);
+        tb_demo_digest_trace("sha1(small x 64K, multi)", digests2, total, t);
+        if (tb_memcmp(digests, digests2, count * 20)) tb_trace_e("[digest]: sha1(multi) failed!");
+    }
+
+    // exit data
+    if (datas) tb_free(datas);
+    if (sizes) tb_free(sizes);
+    if (digests) tb_free(digests);
+    if (digests2) tb_free(digests2);
+    tb_free(data);
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * main
  */
 tb_int_t tb_demo_hash_benchmark_main(tb_int_t argc, tb_char_t** argv)
 {
     tb_demo_hash32_test();
+    tb_trace_i("");
+    tb_demo_digest_test();
     return 0;
 }
@@ -0,0 +1,388 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the keys count of each key set
+#define TB_DEMO_QUALITY_KEYS        (1 << 16)
+
+// the buckets count, it is 16 keys per bucket
+#define TB_DEMO_QUALITY_BUCKETS     (1 << 12)
+
+// the maximum key size
+#define TB_DEMO_QUALITY_KEY_MAXN    (128)
+
+// the samples count of the avalanche test
+#define TB_DEMO_QUALITY_SAMPLES     (2048)
+
+// the data size of the speed test
+#define TB_DEMO_QUALITY_DATA_SIZE   (16 * 1024 * 1024)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the hash entry type
+typedef struct __tb_demo_quality_entry_t
+{
+    // the hash name
+    tb_char_t const*        name;
+
+    // the hash bits
+    tb_size_t               bits;
+
+    // the hash function
+    tb_uint64_t             (*hash)(tb_byte_t const* data, tb_size_t size);
+
+}tb_demo_quality_entry_t, *tb_demo_quality_entry_ref_t;
+
+// the key set type
+typedef struct __tb_demo_quality_keys_t
+{
+    // the key datas, the stride of each key is TB_DEMO_QUALITY_KEY_MAXN
+    tb_byte_t*              data;
+
+    // the key sizes
+    tb_size_t*              size;
+
+}tb_demo_quality_keys_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * wrapers
+ */
+static tb_uint64_t tb_demo_quality_bkdr(tb_byte_t const* data, tb_size_t size)
+{
+    return (tb_uint32_t)tb_bkdr_make(data, size, 0);
+}
+static tb_uint64_t tb_demo_quality_fnv32_1a(tb_byte_t const* data, tb_size_t size)
+{
+    return tb_fnv32_1a_make(data, size, 0);
+}
+static tb_uint64_t tb_demo_quality_murmur(tb_byte_t const* data, tb_size_t size)
+{
+    return (tb_uint32_t)tb_murmur_make(data, size, 0);
+}
+static tb_uint64_t tb_demo_quality_crc32(tb_byte_t const* data, tb_size_t size)
+{
+    return tb_crc32_le_make(data, size, 0);
+}
+static tb_uint64_t tb_demo_quality_fnv64_1a(tb_byte_t const* data, tb_size_t size)
+{
+    return tb_fnv64_1a_make(data, size, 0);
+}
+static tb_uint64_t tb_demo_quality_xxhash3(tb_byte_t const* data, tb_size_t size)
+{
+    return tb_xxhash3_make(data, size, 0);
+}
+static tb_uint64_t tb_demo_quality_xxhash3_128(tb_byte_t const* data, tb_size_t size)
+{
+    // we test the high half, the low half is used as the first hash of the double hashing
+    tb_uint64_t hash[2];
+    tb_xxhash3_make128(data, size, 0, hash);
+    return hash[1];
+}
+static tb_uint64_t tb_demo_quality_wyhash(tb_byte_t const* data, tb_size_t size)
+{
+    return tb_wyhash_make(data, size, 0);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+static tb_demo_quality_entry_t g_quality_entries[] =
+{
+    { "bkdr       ",    32, tb_demo_quality_bkdr            }
+,   { "fnv32-1a   ",    32, tb_demo_quality_fnv32_1a        }
+,   { "murmur     ",    32, tb_demo_quality_murmur          }
+,   { "crc32-le   ",    32, tb_demo_quality_crc32           }
+,   { "fnv64-1a   ",    64, tb_demo_quality_fnv64_1a        }
+,   { "xxhash3    ",    64, tb_demo_quality_xxhash3         }
+,   { "xxhash3-128",    64, tb_demo_quality_xxhash3_128     }
+,   { "wyhash     ",    64, tb_demo_quality_wyhash          }
+,   { tb_null,          0,  tb_null                         }
+};
+
+// the key set names
+static tb_char_t const* g_quality_keys_names[] =
+{
+    "words", "numbers", "urls", "paths", "uint32", "pointers"
+};
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * keys
+ */
+static tb_size_t tb_demo_quality_word(tb_char_t* data, tb_size_t index)
+{
+    // the unique word of the syllables, e.g. kabe, tosi, ...
+    static tb_char_t const* s_consonants = "bcdfghjklmnprstvwxyz";
+    static tb_char_t const* s_vowels = "aeiou";
+    tb_size_t n = 0;
+    do
+    {
+        tb_size_t syllable = index % 100;
+        data[n++] = s_consonants[syllable / 5];
+        data[n++] = s_vowels[syllable % 5];
+        index /= 100;
+
+    } while (index);
+    return n;
+}
+static tb_bool_t tb_demo_quality_keys_init(tb_demo_quality_keys_t* keys, tb_size_t kind)
+{
+    // init keys
+    keys->data = tb_malloc_bytes(TB_DEMO_QUALITY_KEYS * TB_DEMO_QUALITY_KEY_MAXN);
+    keys->size = tb_nalloc_type(TB_DEMO_QUALITY_KEYS, tb_size_t);
+    tb_assert_and_check_return_val(keys->data && keys->size, tb_false);
+
+    // make the unique keys like the real-world keys
+    tb_size_t i = 0;
+    for (i = 0; i < TB_DEMO_QUALITY_KEYS; i++)
+    {
+        tb_char_t*  data = (tb_char_t*)keys->data + i * TB_DEMO_QUALITY_KEY_MAXN;
+        tb_long_t   size = 0;
+        switch (kind)
+        {
+        case 0:
+            size = tb_demo_quality_word(data, i);
+            break;
+        case 1:
+            size = tb_snprintf(data, TB_DEMO_QUALITY_KEY_MAXN, "%lu", i + 100000);
+            break;
+        case 2:
+            size = tb_snprintf(data, TB_DEMO_QUALITY_KEY_MAXN, "https://www.tboox.org/api/v1/users/%lu/profile?tab=%lu", i >> 2, i & 3);
+            break;
+        case 3:
+            size = tb_snprintf(data, TB_DEMO_QUALITY_KEY_MAXN, "/home/ruki/projects/tbox/src/module%lu/file%lu.c", i >> 6, i & 63);
+            break;
+        case 4:
+            tb_bits_set_u32_ne(data, (tb_uint32_t)i);
+            size = sizeof(tb_uint32_t);
+            break;
+        default:
+            // the aligned heap addresses
+            tb_bits_set_u64_ne(data, 0x7f3a5c000000ULL + ((tb_uint64_t)i << 4));
+            size = sizeof(tb_uint64_t);
+            break;
+        }
+        keys->size[i] = (tb_size_t)size;
+    }
+    return tb_true;
+}
+static tb_void_t tb_demo_quality_keys_exit(tb_demo_quality_keys_t* keys)
+{
+    if (keys->data) tb_free(keys->data);
+    if (keys->size) tb_free(keys->size);
+    keys->data = tb_null;
+    keys->size = tb_null;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * test
+ */
+static tb_void_t tb_demo_quality_buckets_test()
+{
+    // init buckets
+    tb_uint32_t* buckets = tb_nalloc0_type(TB_DEMO_QUALITY_BUCKETS, tb_uint32_t);
+    tb_assert_and_check_return(buckets);
+
+    // the chi-square / buckets of each key set, it is ~1.00 for the uniform hash, and the larger is worse
+    tb_trace_i("[buckets]: chi-square / buckets of %d keys in %d buckets (ideal: ~1.00)", TB_DEMO_QUALITY_KEYS, TB_DEMO_QUALITY_BUCKETS);
+    tb_char_t   line[256];
+    tb_size_t   kind = 0;
+    tb_size_t   chis[tb_arrayn(g_quality_entries)][tb_arrayn(g_quality_keys_names)];
+    for (kind = 0; kind < tb_arrayn(g_quality_keys_names); kind++)
+    {
+        // init keys
+        tb_demo_quality_keys_t keys = {0};
+        if (tb_demo_quality_keys_init(&keys, kind))
+        {
+            tb_size_t e = 0;
+            for (e = 0; g_quality_entries[e].name; e++)
+            {
+                // put keys to the buckets with the low bits, like the hash table
+                tb_size_t i = 0;
+                tb_memset(buckets, 0, TB_DEMO_QUALITY_BUCKETS * sizeof(tb_uint32_t));
+                for (i = 0; i < TB_DEMO_QUALITY_KEYS; i++)
+                    buckets[g_quality_entries[e].hash(keys.data + i * TB_DEMO_QUALITY_KEY_MAXN, keys.size[i]) & (TB_DEMO_QUALITY_BUCKETS - 1)]++;
+
+                // compute the chi-square
+                tb_hize_t expect = TB_DEMO_QUALITY_KEYS / TB_DEMO_QUALITY_BUCKETS;
+                tb_hize_t square = 0;
+                for (i = 0; i < TB_DEMO_QUALITY_BUCKETS; i++)
+                {
+                    tb_hong_t diff = (tb_hong_t)buckets[i] - (tb_hong_t)expect;
+                    square += (tb_hize_t)(diff * diff);
+                }
+                chis[e][kind] = (tb_size_t)(square * 100 / (expect * TB_DEMO_QUALITY_BUCKETS));
+            }
+        }
+        tb_demo_quality_keys_exit(&keys);
+    }
+
+    // trace
+    tb_size_t e = 0;
+    for (e = 0; g_quality_entries[e].name; e++)
+    {
+        tb_size_t n = tb_snprintf(line, sizeof(line), "[buckets]: %s:", g_quality_entries[e].name);
+        for (kind = 0; kind < tb_arrayn(g_quality_keys_names) && n < sizeof(line); kind++)
+            n += tb_snprintf(line + n, sizeof(line) - n, " %s: %lu.%02lu", g_quality_keys_names[kind], chis[e][kind] / 100, chis[e][kind] % 100);
+        tb_trace_i("%s", line);
+    }
+
+    // exit buckets
+    tb_free(buckets);
+}
+static tb_void_t tb_demo_quality_avalanche_test()
+{
+    // init counts, counts[input bit][output bit]
+    tb_size_t       maxn = 64;
+    tb_uint32_t*    counts = tb_nalloc_type(maxn * 8 * 64, tb_uint32_t);
+    tb_assert_and_check_return(counts);
+
+    // flip every input bit and count the flipped output bits, the bias is 0% for the perfect avalanche and 50% for the worst
+    tb_trace_i("[avalanche]: the worst bias of all input and output bits, %d samples (ideal: < ~4%%)", TB_DEMO_QUALITY_SAMPLES);
+    tb_demo_quality_entry_ref_t entry = g_quality_entries;
+    for (; entry && entry->name; entry++)
+    {
+        tb_char_t   line[256];
+        tb_size_t   n = tb_snprintf(line, sizeof(line), "[avalanche]: %s:", entry->name);
+        tb_size_t   size = 4;
+        for (size = 4; size <= maxn; size <<= 2)
+        {
+            // count the flipped output bits
+            tb_size_t   i = 0;
+            tb_size_t   j = 0;
+            tb_size_t   k = 0;
+            tb_byte_t   data[64];
+            tb_memset(counts, 0, maxn * 8 * 64 * sizeof(tb_uint32_t));
+            for (i = 0; i < TB_DEMO_QUALITY_SAMPLES; i++)
+            {
+                for (j = 0; j < size; j++) data[j] = (tb_byte_t)tb_random_range(0, 256);
+                tb_uint64_t hash = entry->hash(data, size);
+                for (j = 0; j < (size << 3); j++)
+                {
+                    data[j >> 3] ^= (tb_byte_t)(1 << (j & 7));
+                    tb_uint64_t diff = hash ^ entry->hash(data, size);
+                    data[j >> 3] ^= (tb_byte_t)(1 << (j & 7));
+                    for (k = 0; k < entry->bits; k++) counts[(j << 6) + k] += (tb_uint32_t)((diff >> k) & 1);
+                }
+            }
+
+            // get the worst bias in 0.01%
+            tb_size_t worst = 0;
+            for (j = 0; j < (size << 3); j++)
+            {
+                for (k = 0; k < entry->bits; k++)
+                {
+                    tb_long_t diff = 2 * (tb_long_t)counts[(j << 6) + k] - TB_DEMO_QUALITY_SAMPLES;
+                    tb_size_t bias = (tb_size_t)tb_abs(diff) * 10000 / (2 * TB_DEMO_QUALITY_SAMPLES);
+                    if (bias > worst) worst = bias;
+                }
+            }
+            if (n < sizeof(line)) n += tb_snprintf(line + n, sizeof(line) - n, " %2lu bytes: %2lu.%02lu%%", size, worst / 100, worst % 100);
+        }
+        tb_trace_i("%s", line);
+    }
+
+    // exit counts
+    tb_free(counts);
+}
+static tb_void_t tb_demo_quality_speed_test()
+{
+    // init data
+    tb_size_t   size = TB_DEMO_QUALITY_DATA_SIZE;
+    tb_byte_t*  data = tb_malloc_bytes(size);
+    tb_assert_and_check_return(data);
+
+    // make data
+    tb_size_t i = 0;
+    for (i = 0; i < size; i++) data[i] = (tb_byte_t)tb_random_range(0, 0xff);
+
+    // the short keys in M/s and the large data in GB/s
+    tb_trace_i("[speed]: the short keys in M hashes/s and the large data (%d MB) in GB/s", TB_DEMO_QUALITY_DATA_SIZE >> 20);
+    tb_demo_quality_entry_ref_t entry = g_quality_entries;
+    for (; entry && entry->name; entry++)
+    {
+        tb_char_t           line[256];
+        tb_size_t           n = tb_snprintf(line, sizeof(line), "[speed]: %s:", entry->name);
+        tb_size_t           keysize = 8;
+        __tb_volatile__ tb_uint64_t v = 0;
+        for (keysize = 8; keysize <= 128; keysize <<= 2)
+        {
+            tb_size_t count = 4 * 1024 * 1024;
+            tb_hong_t t = tb_mclock();
+            for (i = 0; i < count; i++) v += entry->hash(data + ((i * 64) & (size - 1)), keysize);
+            t = tb_mclock() - t;
+            if (n < sizeof(line)) n += tb_snprintf(line + n, sizeof(line) - n, " %3lu bytes: %4lld M/s", keysize, (tb_hong_t)count / ((t? t : 1) * 1000));
+        }
+
+        // the large data
+        tb_hong_t t = tb_mclock();
+        for (i = 0; i < 4; i++) v += entry->hash(data, size);
+        t = tb_mclock() - t;
+        tb_hong_t speed = (tb_hong_t)((tb_hize_t)size * 4 * 100 * 1000 / ((tb_hize_t)(t? t : 1) << 30));
+        if (n < sizeof(line)) tb_snprintf(line + n, sizeof(line) - n, ", large: %lld.%02lld GB/s", speed / 100, speed % 100);
+        tb_trace_i("%s", line);
+    }
+
+    // exit data
+    tb_free(data);
+}
+static tb_void_t tb_demo_quality_bloom_test()
+{
+    // the false positive rate of the bloom filter with the double hashing of the element hash
+    static tb_char_t const* s_algos[] = {"legacy", "xxhash3", "wyhash"};
+    tb_size_t algo_saved = tb_element_hash_algo();
+    tb_size_t algo = 0;
+    tb_trace_i("[bloom]: the false positive rate of %d urls, 3 hashes, expected: ~0.10%%", TB_DEMO_QUALITY_KEYS);
+    for (algo = 0; algo < tb_arrayn(s_algos); algo++)
+    {
+        // the element hash algorithm is saved to the element when creating it
+        tb_element_hash_algo_set(algo);
+        tb_bloom_filter_ref_t filter = tb_bloom_filter_init(TB_BLOOM_FILTER_PROBABILITY_0_001, 3, TB_DEMO_QUALITY_KEYS, tb_element_str(tb_true));
+        if (filter)
+        {
+            // set the urls
+            tb_char_t   data[TB_DEMO_QUALITY_KEY_MAXN];
+            tb_size_t   i = 0;
+            for (i = 0; i < TB_DEMO_QUALITY_KEYS; i++)
+            {
+                tb_snprintf(data, sizeof(data), "https://www.tboox.org/api/v1/users/%lu/profile", i);
+                tb_bloom_filter_set(filter, data);
+            }
+
+            // get the other urls
+            tb_size_t positive = 0;
+            for (i = 0; i < TB_DEMO_QUALITY_KEYS; i++)
+            {
+                tb_snprintf(data, sizeof(data), "https://www.tboox.org/api/v1/users/%lu/profile", i + TB_DEMO_QUALITY_KEYS);
+                if (tb_bloom_filter_get(filter, data)) positive++;
+            }
+
+            // trace
+            tb_size_t rate = positive * 10000 / TB_DEMO_QUALITY_KEYS;
+            tb_trace_i("[bloom]: %-7s: %lu.%02lu%%", s_algos[algo], rate / 100, rate % 100);
+            tb_bloom_filter_exit(filter);
+        }
+    }
+    tb_element_hash_algo_set(algo_saved);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_hash_quality_main(tb_int_t argc, tb_char_t** argv)
+{
+    tb_demo_quality_buckets_test();
+    tb_trace_i("");
+    tb_demo_quality_avalanche_test();
+    tb_trace_i("");
+    tb_demo_quality_bloom_test();
+    tb_trace_i("");
+    tb_demo_quality_speed_test();
+    return 0;
+}
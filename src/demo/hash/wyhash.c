@@ -0,0 +1,14 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_hash_wyhash_main(tb_int_t argc, tb_char_t** argv)
+{
+    // trace
+    tb_trace_i("[wyhash]: %016llx", tb_wyhash_make_from_cstr(argv[1], 0));
+    return 0;
+}
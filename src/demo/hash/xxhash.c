@@ -0,0 +1,28 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_hash_xxhash_main(tb_int_t argc, tb_char_t** argv)
+{
+    // make it
+    tb_uint64_t hash[2];
+    tb_byte_t const* data = (tb_byte_t const*)argv[1];
+    tb_size_t size = tb_strlen(argv[1]);
+    tb_xxhash3_make128(data, size, 0, hash);
+
+    // make it with the streaming state
+    tb_xxhash3_t xxhash;
+    tb_xxhash3_init(&xxhash, 0);
+    tb_xxhash3_spak(&xxhash, data, size >> 1);
+    tb_xxhash3_spak(&xxhash, data + (size >> 1), size - (size >> 1));
+
+    // trace
+    tb_trace_i("[xxhash3]:     %016llx", tb_xxhash3_make(data, size, 0));
+    tb_trace_i("[xxhash3-128]: %016llx%016llx", hash[1], hash[0]);
+    tb_trace_i("[xxhash3(streaming)]: %016llx", tb_xxhash3_exit(&xxhash));
+    return 0;
+}
@@ -0,0 +1,269 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the check count
+#define TB_DEMO_CHECK_COUNT     (1000000)
+
+// the bench count
+#define TB_DEMO_BENCH_COUNT     (1000000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+#ifdef TB_CONFIG_TYPE_HAVE_FLOAT
+static tb_uint64_t tb_demo_stdio_random(tb_uint64_t* pseed)
+{
+    // xorshift64, we need the random bits of the whole double
+    tb_uint64_t x = *pseed;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *pseed = x;
+    return x;
+}
+static tb_size_t tb_demo_stdio_shortest(tb_double_t num, tb_bool_t isfloat)
+{
+    // get the shortest significant digits which can be parsed to the same number by libc
+    tb_char_t   data[64];
+    tb_size_t   digits = 1;
+    tb_size_t   maxn = isfloat? 9 : 17;
+    for (digits = 1; digits < maxn; digits++)
+    {
+        snprintf(data, sizeof(data), "%.*e", (tb_int_t)digits - 1, num);
+        if (isfloat? (strtof(data, tb_null) == (tb_float_t)num) : (strtod(data, tb_null) == num)) break;
+    }
+    return digits;
+}
+static tb_size_t tb_demo_stdio_digits(tb_char_t const* data)
+{
+    // count the significant digits, e.g. -0.00123e+10 => 3
+    tb_size_t digits = 0;
+    tb_size_t zeros = 0;
+    for (; *data && *data != 'e' && *data != 'E'; data++)
+    {
+        if (!tb_isdigit10(*data)) continue;
+        if (*data == '0')
+        {
+            if (digits) zeros++;
+        }
+        else
+        {
+            digits += zeros + 1;
+            zeros = 0;
+        }
+    }
+    return digits;
+}
+static tb_void_t tb_demo_stdio_check_double()
+{
+    // check the round-trip and the shortest digits of %lg and %.16le
+    tb_uint64_t seed = 88172645463325252ULL;
+    tb_size_t   count = 0;
+    tb_size_t   failed = 0;
+    tb_size_t   longer = 0;
+    tb_size_t   i = 0;
+    tb_char_t   data[64];
+    for (i = 0; i < TB_DEMO_CHECK_COUNT; i++)
+    {
+        // make a random double with the random bits, skip inf and nan
+        tb_ieee_double_t ieee;
+        tb_uint64_t bits = tb_demo_stdio_random(&seed);
+        ieee.i.l = (tb_uint32_t)bits;
+        ieee.i.h = (tb_uint32_t)(bits >> 32);
+        if (tb_isinf(ieee.d) || tb_isnan(ieee.d)) continue;
+        count++;
+
+        // check the shortest form
+        tb_snprintf(data, sizeof(data), "%lg", ieee.d);
+        if (strtod(data, tb_null) != ieee.d)
+        {
+            if (failed++ < 10) tb_trace_e("%%lg: %s != %.17g", data, ieee.d);
+        }
+        else if (ieee.d != 0 && tb_demo_stdio_digits(data) > tb_demo_stdio_shortest(ieee.d, tb_false))
+        {
+            if (longer++ < 10) tb_trace_e("%%lg: %s is not the shortest, %.17g", data, ieee.d);
+        }
+
+        // check the exponent form with 17 significant digits
+        tb_snprintf(data, sizeof(data), "%.16le", ieee.d);
+        if (strtod(data, tb_null) != ieee.d)
+        {
+            if (failed++ < 10) tb_trace_e("%%.16le: %s != %.17g", data, ieee.d);
+        }
+    }
+    tb_trace_i("double: %lu numbers, %lu failed, %lu not shortest", count, failed, longer);
+}
+static tb_void_t tb_demo_stdio_check_float()
+{
+    // check the round-trip and the shortest digits of %g
+    tb_uint64_t seed = 88172645463325252ULL;
+    tb_size_t   count = 0;
+    tb_size_t   failed = 0;
+    tb_size_t   longer = 0;
+    tb_size_t   i = 0;
+    tb_char_t   data[64];
+    for (i = 0; i < TB_DEMO_CHECK_COUNT; i++)
+    {
+        // make a random float with the random bits, skip inf and nan
+        tb_ieee_float_t ieee;
+        ieee.i = (tb_uint32_t)tb_demo_stdio_random(&seed);
+        if (tb_isinff(ieee.f) || tb_isnanf(ieee.f)) continue;
+        count++;
+
+        // check it
+        tb_snprintf(data, sizeof(data), "%g", ieee.f);
+        if (strtof(data, tb_null) != ieee.f)
+        {
+            if (failed++ < 10) tb_trace_e("%%g: %s != %.9g", data, ieee.f);
+        }
+        else if (ieee.f != 0 && tb_demo_stdio_digits(data) > tb_demo_stdio_shortest(ieee.f, tb_true))
+        {
+            if (longer++ < 10) tb_trace_e("%%g: %s is not the shortest, %.9g", data, ieee.f);
+        }
+    }
+    tb_trace_i("float: %lu numbers, %lu failed, %lu not shortest", count, failed, longer);
+}
+static tb_void_t tb_demo_stdio_check_format()
+{
+    // the format and the expected result
+    static struct
+    {
+        tb_char_t const*    format;
+        tb_double_t         number;
+        tb_char_t const*    result;
+
+    } s_items[] =
+    {
+        { "%lf",        3.1415926,      "3.141593"          }
+    ,   { "%.0lf",      3.5,            "4"                 }
+    ,   { "%.2lf",      0.0049,         "0.00"              }
+    ,   { "%.2lf",      9.996,          "10.00"             }
+    ,   { "%.2lf",      1.005,          "1.00"              }
+    ,   { "%.2lf",      0.995,          "0.99"              }
+    ,   { "%.1lf",      0.15,           "0.1"               }
+    ,   { "%.1lf",      0.25,           "0.2"               }
+    ,   { "%.0lf",      2.5,            "2"                 }
+    ,   { "%.0lf",      0.5,            "0"                 }
+    ,   { "%.0lf",      1.5,            "2"                 }
+    ,   { "%lf",        0.0000005,      "0.000000"          }
+    ,   { "%.20lf",     0.1,            "0.10000000000000000555" }
+    ,   { "%10.3lf",    -3.1415926,     "    -3.142"        }
+    ,   { "%-10.3lf",   3.1415926,      "3.142     "        }
+    ,   { "%010.2lf",   -3.1415926,     "-000003.14"        }
+    ,   { "%+lf",       0.5,            "+0.500000"         }
+    ,   { "%lf",        1e20,           "100000000000000000000.000000" }
+    ,   { "%le",        1234.5678,      "1.234568e+03"      }
+    ,   { "%.0lE",      0.00015,        "1E-04"             }
+    ,   { "%le",        1e-300,         "1.000000e-300"     }
+    ,   { "%.2le",      1.005e10,       "1.00e+10"          }
+    ,   { "%.3le",      5e-324,         "4.941e-324"        }
+    ,   { "%lg",        0.1,            "0.1"               }
+    ,   { "%lg",        -0.0,           "-0"                }
+    ,   { "%lg",        1e21,           "1e+21"             }
+    ,   { "%lg",        123456789.125,  "123456789.125"     }
+    ,   { "%lg",        0.00001234,     "1.234e-05"         }
+    ,   { "%.3lg",      1234.5,         "1.23e+03"          }
+    ,   { "%.3lg",      0.0001234,      "0.000123"          }
+    ,   { "%#.3lg",     1.0,            "1.00"              }
+    ,   { "%#lg",       0.5,            "0.500000"          }
+    ,   { "%.17lg",     0.1,            "0.10000000000000001" }
+    ,   { "%lG",        1.5e-10,        "1.5E-10"           }
+    };
+
+    // check them
+    tb_size_t i = 0;
+    tb_size_t failed = 0;
+    tb_char_t data[256];
+    for (i = 0; i < tb_arrayn(s_items); i++)
+    {
+        tb_snprintf(data, sizeof(data), s_items[i].format, s_items[i].number);
+        if (tb_strcmp(data, s_items[i].result))
+        {
+            tb_trace_e("%s: %s != %s", s_items[i].format, data, s_items[i].result);
+            failed++;
+        }
+    }
+    tb_trace_i("format: %lu items, %lu failed", tb_arrayn(s_items), failed);
+}
+#endif
+static tb_void_t tb_demo_stdio_bench()
+{
+    // init numbers
+    tb_size_t   i = 0;
+    tb_size_t   n = 0;
+    tb_char_t   data[256];
+#ifdef TB_CONFIG_TYPE_HAVE_FLOAT
+    tb_double_t numbers[256];
+    for (i = 0; i < tb_arrayn(numbers); i++)
+        numbers[i] = (tb_double_t)tb_random_range(0, 100000000) / (tb_double_t)tb_random_range(1, 10000);
+#endif
+
+    // bench tb_snprintf and snprintf
+    tb_hong_t t[8] = {0};
+#ifdef TB_CONFIG_TYPE_HAVE_FLOAT
+    t[0] = tb_mclock();
+    for (i = 0; i < TB_DEMO_BENCH_COUNT; i++) n += tb_snprintf(data, sizeof(data), "%lf", numbers[i & 0xff]);
+    t[0] = tb_mclock() - t[0];
+
+    t[1] = tb_mclock();
+    for (i = 0; i < TB_DEMO_BENCH_COUNT; i++) n += snprintf(data, sizeof(data), "%lf", numbers[i & 0xff]);
+    t[1] = tb_mclock() - t[1];
+
+    t[2] = tb_mclock();
+    for (i = 0; i < TB_DEMO_BENCH_COUNT; i++) n += tb_snprintf(data, sizeof(data), "%lg", numbers[i & 0xff]);
+    t[2] = tb_mclock() - t[2];
+
+    t[3] = tb_mclock();
+    for (i = 0; i < TB_DEMO_BENCH_COUNT; i++) n += snprintf(data, sizeof(data), "%.17lg", numbers[i & 0xff]);
+    t[3] = tb_mclock() - t[3];
+#endif
+
+    t[4] = tb_mclock();
+    for (i = 0; i < TB_DEMO_BENCH_COUNT; i++) n += tb_snprintf(data, sizeof(data), "%d: %llu", (tb_int_t)i, (tb_uint64_t)i * 2654435761ULL);
+    t[4] = tb_mclock() - t[4];
+
+    t[5] = tb_mclock();
+    for (i = 0; i < TB_DEMO_BENCH_COUNT; i++) n += snprintf(data, sizeof(data), "%d: %llu", (tb_int_t)i, (unsigned long long)i * 2654435761ULL);
+    t[5] = tb_mclock() - t[5];
+
+    t[6] = tb_mclock();
+    for (i = 0; i < TB_DEMO_BENCH_COUNT; i++) n += tb_snprintf(data, sizeof(data), "Content-Length: %lu\r\nHost: %s\r\n", i, "www.tboox.org");
+    t[6] = tb_mclock() - t[6];
+
+    t[7] = tb_mclock();
+    for (i = 0; i < TB_DEMO_BENCH_COUNT; i++) n += snprintf(data, sizeof(data), "Content-Length: %lu\r\nHost: %s\r\n", (unsigned long)i, "www.tboox.org");
+    t[7] = tb_mclock() - t[7];
+
+    // trace
+#ifdef TB_CONFIG_TYPE_HAVE_FLOAT
+    tb_trace_i("%%lf: tb_snprintf: %lld ms, snprintf: %lld ms", t[0], t[1]);
+    tb_trace_i("%%lg: tb_snprintf: %lld ms, snprintf(%%.17lg): %lld ms", t[2], t[3]);
+#endif
+    tb_trace_i("%%d %%llu: tb_snprintf: %lld ms, snprintf: %lld ms", t[4], t[5]);
+    tb_trace_i("header: tb_snprintf: %lld ms, snprintf: %lld ms, %lu bytes", t[6], t[7], n);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_libc_stdio_main(tb_int_t argc, tb_char_t** argv)
+{
+#ifdef TB_CONFIG_TYPE_HAVE_FLOAT
+    // check
+    tb_demo_stdio_check_format();
+    tb_demo_stdio_check_double();
+    tb_demo_stdio_check_float();
+#endif
+
+    // bench
+    tb_demo_stdio_bench();
+    return 0;
+}
@@ -3,6 +3,8 @@
  */
 #include "../demo.h"
 #include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * macros
@@ -19,6 +21,12 @@
 #define TB_TEST_STOI32          (1)
 #define TB_TEST_STOU32          (1)
 
+#define TB_TEST_S10TOD_N        (1)
+#define TB_TEST_S10TOU64_N      (1)
+
+// the check and bench count
+#define TB_TEST_COUNT           (1000000)
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
@@ -96,6 +104,131 @@ static tb_void_t tb_test_stoi32(tb_char_t const* s, tb_int32_t val)
 {
     tb_printf("stoi32(%s) = %d [?= %d]\n", s, tb_stoi32(s), val);
 }
+static tb_uint64_t tb_test_random(tb_uint64_t* pseed)
+{
+    // xorshift64, we need the random bits of the whole double
+    tb_uint64_t x = *pseed;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *pseed = x;
+    return x;
+}
+#if TB_TEST_S10TOD_N && defined(TB_CONFIG_TYPE_HAVE_FLOAT)
+static tb_void_t tb_test_s10tod_n()
+{
+    // make the random numbers with the different forms
+    tb_uint64_t seed = 88172645463325252ULL;
+    tb_char_t*  data = (tb_char_t*)tb_malloc_bytes(TB_TEST_COUNT * 48);
+    tb_size_t*  size = tb_nalloc_type(TB_TEST_COUNT, tb_size_t);
+    if (data && size)
+    {
+        tb_size_t i = 0;
+        while (i < TB_TEST_COUNT)
+        {
+            // skip inf and nan
+            tb_ieee_double_t ieee;
+            tb_uint64_t bits = tb_test_random(&seed);
+            ieee.i.l = (tb_uint32_t)bits;
+            ieee.i.h = (tb_uint32_t)(bits >> 32);
+            if (tb_isinf(ieee.d) || tb_isnan(ieee.d)) continue;
+
+            // %.17g, the shortest and the long digits with the halfway cases
+            tb_char_t* p = data + i * 48;
+            switch (i & 3)
+            {
+            case 0: size[i] = snprintf(p, 48, "%.17g", ieee.d); break;
+            case 1: size[i] = snprintf(p, 48, "%lg", (tb_double_t)(bits >> 40) / 1000); break;
+            case 2: size[i] = tb_snprintf(p, 48, "%lg", ieee.d); break;
+            default: size[i] = snprintf(p, 48, "%.30e", ieee.d); break;
+            }
+            i++;
+        }
+
+        // check it with strtod
+        tb_size_t failed = 0;
+        for (i = 0; i < TB_TEST_COUNT; i++)
+        {
+            tb_char_t const*    p = data + i * 48;
+            tb_double_t         value = 0;
+            tb_size_t           n = tb_s10tod_n(p, size[i], &value);
+            tb_double_t         expected = strtod(p, tb_null);
+            if (n != size[i] || tb_memcmp(&value, &expected, sizeof(tb_double_t)))
+            {
+                if (failed++ < 10) tb_printf("[e] s10tod_n(%s) = %.17g [?= %.17g]\n", p, value, expected);
+            }
+        }
+        tb_printf("s10tod_n: %lu numbers, %lu failed\n", (tb_size_t)TB_TEST_COUNT, failed);
+
+        // bench it
+        tb_double_t sum = 0;
+        tb_hong_t   t0 = tb_mclock();
+        for (i = 0; i < TB_TEST_COUNT; i++)
+        {
+            tb_double_t value = 0;
+            tb_s10tod_n(data + i * 48, size[i], &value);
+            sum += value;
+        }
+        t0 = tb_mclock() - t0;
+        tb_hong_t t1 = tb_mclock();
+        for (i = 0; i < TB_TEST_COUNT; i++) sum += strtod(data + i * 48, tb_null);
+        t1 = tb_mclock() - t1;
+        tb_printf("s10tod_n: %lld ms, strtod: %lld ms, %lf\n", t0, t1, sum);
+    }
+    if (data) tb_free(data);
+    if (size) tb_free(size);
+}
+#endif
+#if TB_TEST_S10TOU64_N
+static tb_void_t tb_test_s10tou64_n()
+{
+    // make the random numbers
+    tb_uint64_t     seed = 88172645463325252ULL;
+    tb_char_t*      data = (tb_char_t*)tb_malloc_bytes(TB_TEST_COUNT * 24);
+    tb_size_t*      size = tb_nalloc_type(TB_TEST_COUNT, tb_size_t);
+    tb_uint64_t*    nums = tb_nalloc_type(TB_TEST_COUNT, tb_uint64_t);
+    if (data && size && nums)
+    {
+        tb_size_t i = 0;
+        for (i = 0; i < TB_TEST_COUNT; i++)
+        {
+            nums[i] = tb_test_random(&seed) >> (tb_test_random(&seed) & 63);
+            size[i] = tb_snprintf(data + i * 24, 24, "%llu", nums[i]);
+        }
+
+        // check it
+        tb_size_t failed = 0;
+        for (i = 0; i < TB_TEST_COUNT; i++)
+        {
+            tb_uint64_t value = 0;
+            tb_size_t   n = tb_s10tou64_n(data + i * 24, size[i], &value);
+            if (n != size[i] || value != nums[i])
+            {
+                if (failed++ < 10) tb_printf("[e] s10tou64_n(%s) = %llu\n", data + i * 24, value);
+            }
+        }
+        tb_printf("s10tou64_n: %lu numbers, %lu failed\n", (tb_size_t)TB_TEST_COUNT, failed);
+
+        // bench it
+        tb_uint64_t sum = 0;
+        tb_hong_t   t0 = tb_mclock();
+        for (i = 0; i < TB_TEST_COUNT; i++)
+        {
+            tb_uint64_t value = 0;
+            tb_s10tou64_n(data + i * 24, size[i], &value);
+            sum += value;
+        }
+        t0 = tb_mclock() - t0;
+        tb_hong_t t1 = tb_mclock();
+        for (i = 0; i < TB_TEST_COUNT; i++) sum += strtoull(data + i * 24, tb_null, 10);
+        t1 = tb_mclock() - t1;
+        tb_printf("s10tou64_n: %lld ms, strtoull: %lld ms, %llu\n", t0, t1, sum);
+    }
+    if (data) tb_free(data);
+    if (size) tb_free(size);
+    if (nums) tb_free(nums);
+}
+#endif
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * main
@@ -217,5 +350,15 @@ tb_int_t tb_demo_libc_stdlib_main(tb_int_t argc, tb_char_t** argv)
     tb_test_stoi32("-31415926", -31415926);
     tb_test_stoi32("-0x1dcc666", -31415926);
 #endif
+
+#if TB_TEST_S10TOD_N && defined(TB_CONFIG_TYPE_HAVE_FLOAT)
+    tb_printf("===============================\n");
+    tb_test_s10tod_n();
+#endif
+
+#if TB_TEST_S10TOU64_N
+    tb_printf("===============================\n");
+    tb_test_s10tou64_n();
+#endif
     return 0;
 }
@@ -159,6 +159,46 @@ tb_void_t tb_demo_large_allocator_real(tb_size_t size)
     // exit pool
     if (pool) tb_allocator_exit(pool);
 }
+tb_void_t tb_demo_large_allocator_ralloc(tb_noarg_t);
+tb_void_t tb_demo_large_allocator_ralloc()
+{
+    // done
+    tb_allocator_ref_t pool = tb_null;
+    do
+    {
+        // init the native large allocator, it will switch between the native and virtual memory
+        pool = tb_large_allocator_init(tb_null, 0);
+        tb_assert_and_check_break(pool);
+
+        // make data from the native memory
+        tb_size_t   i = 0;
+        tb_size_t   small = 1024;
+        tb_size_t   large = 512 * 1024;
+        tb_byte_t*  data = (tb_byte_t*)tb_allocator_large_malloc(pool, small, tb_null);
+        tb_assert_and_check_break(data);
+        for (i = 0; i < small; i++) data[i] = (tb_byte_t)i;
+
+        // grow it to the virtual memory
+        data = (tb_byte_t*)tb_allocator_large_ralloc(pool, data, large, tb_null);
+        tb_assert_and_check_break(data);
+        for (i = small; i < large; i++) data[i] = (tb_byte_t)i;
+
+        // shrink it to the native memory
+        data = (tb_byte_t*)tb_allocator_large_ralloc(pool, data, small, tb_null);
+        tb_assert_and_check_break(data);
+
+        // check data
+        for (i = 0; i < small && data[i] == (tb_byte_t)i; i++) ;
+        tb_trace_i("ralloc: %lu => %lu => %lu: %s", small, large, small, i == small? "ok" : "failed");
+
+        // exit data
+        tb_allocator_large_free(pool, data);
+
+    } while (0);
+
+    // exit pool
+    if (pool) tb_allocator_exit(pool);
+}
 tb_void_t tb_demo_large_allocator_perf(tb_noarg_t);
 tb_void_t tb_demo_large_allocator_perf()
 {
@@ -234,6 +274,7 @@ tb_int_t tb_demo_memory_large_allocator_main(tb_int_t argc, tb_char_t** argv)
 {
 #if 1
     tb_demo_large_allocator_perf();
+    tb_demo_large_allocator_ralloc();
 #endif
 
 #if 0
@@ -4,35 +4,202 @@
 #include "../demo.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
- * main
+ * macros
  */
-tb_int_t tb_demo_memory_string_pool_main(tb_int_t argc, tb_char_t** argv)
+
+// the thread count
+#define TB_DEMO_THREAD_COUNT        (4)
+
+// the different string count
+#define TB_DEMO_STRING_COUNT        (10000)
+
+// the insertion count of each thread
+#define TB_DEMO_INSERT_COUNT        (1000000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the demo context type
+typedef struct __tb_demo_context_t
+{
+    // the string pool
+    tb_string_pool_ref_t    pool;
+
+    // the locked hash map for comparing
+    tb_hash_map_ref_t       hash;
+
+    // the lock of hash map
+    tb_spinlock_t           lock;
+
+    // the interned strings, we compare them by pointers
+    tb_char_t const**       names;
+
+    // the failed count
+    tb_atomic_t             failed;
+
+}tb_demo_context_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the test strings
+static tb_char_t            g_strings[TB_DEMO_STRING_COUNT][32];
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_int_t tb_demo_pool_thread(tb_cpointer_t priv)
+{
+    // check
+    tb_demo_context_t* context = (tb_demo_context_t*)priv;
+    tb_assert_and_check_return_val(context, -1);
+
+    // intern strings, we keep a reference of each string in main thread, so the interned pointers are not changed
+    tb_size_t i;
+    tb_uint32_t seed = (tb_uint32_t)tb_p2u32(tb_thread_self());
+    for (i = 0; i < TB_DEMO_INSERT_COUNT; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        tb_size_t        index = (seed >> 8) % TB_DEMO_STRING_COUNT;
+        tb_char_t const* cstr = tb_string_pool_insert(context->pool, g_strings[index]);
+        if (cstr != context->names[index]) tb_atomic_fetch_and_add(&context->failed, 1);
+        tb_string_pool_remove(context->pool, cstr);
+    }
+    return 0;
+}
+static tb_int_t tb_demo_hash_thread(tb_cpointer_t priv)
+{
+    // check
+    tb_demo_context_t* context = (tb_demo_context_t*)priv;
+    tb_assert_and_check_return_val(context, -1);
+
+    // find strings in the locked hash map
+    tb_size_t i;
+    tb_uint32_t seed = (tb_uint32_t)tb_p2u32(tb_thread_self());
+    for (i = 0; i < TB_DEMO_INSERT_COUNT; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        tb_size_t index = (seed >> 8) % TB_DEMO_STRING_COUNT;
+        tb_spinlock_enter(&context->lock);
+        tb_size_t itor = tb_hash_map_find(context->hash, g_strings[index]);
+        if (itor == tb_iterator_tail(context->hash)) tb_atomic_fetch_and_add(&context->failed, 1);
+        tb_spinlock_leave(&context->lock);
+    }
+    return 0;
+}
+static tb_void_t tb_demo_run(tb_char_t const* name, tb_demo_context_t* context, tb_thread_func_t func, tb_size_t count)
+{
+    // start threads
+    tb_size_t       i;
+    tb_thread_ref_t threads[TB_DEMO_THREAD_COUNT] = {0};
+    tb_hong_t       time = tb_mclock();
+    for (i = 0; i < count; i++)
+        threads[i] = tb_thread_init(tb_null, func, context, 0);
+
+    // wait threads
+    for (i = 0; i < count; i++)
+    {
+        if (threads[i])
+        {
+            tb_thread_wait(threads[i], -1, tb_null);
+            tb_thread_exit(threads[i]);
+        }
+    }
+    time = tb_mclock() - time;
+
+    // trace
+    tb_hize_t total = (tb_hize_t)TB_DEMO_INSERT_COUNT * count;
+    tb_trace_i("%s: threads: %lu, %llu ops in %lld ms, %lld ops/ms, failed: %ld", name, count, total, time, time? (tb_hong_t)total / time : 0, tb_atomic_get(&context->failed));
+}
+static tb_void_t tb_demo_pool_test(tb_char_t const* name, tb_size_t flags)
+{
+    // init context
+    tb_demo_context_t context;
+    tb_memset(&context, 0, sizeof(context));
+    context.pool  = tb_string_pool_init_with(flags);
+    context.names = tb_nalloc0_type(TB_DEMO_STRING_COUNT, tb_char_t const*);
+    if (context.pool && context.names)
+    {
+        // intern all strings
+        tb_size_t i;
+        for (i = 0; i < TB_DEMO_STRING_COUNT; i++)
+            context.names[i] = tb_string_pool_insert(context.pool, g_strings[i]);
+
+        // run threads
+        tb_demo_run(name, &context, tb_demo_pool_thread, 1);
+        tb_demo_run(name, &context, tb_demo_pool_thread, TB_DEMO_THREAD_COUNT);
+
+        // remove all strings
+        for (i = 0; i < TB_DEMO_STRING_COUNT; i++)
+            tb_string_pool_remove(context.pool, context.names[i]);
+    }
+    if (context.names) tb_free(context.names);
+    if (context.pool) tb_string_pool_exit(context.pool);
+}
+static tb_void_t tb_demo_hash_test()
 {
-#if 0
-    // hello
-    tb_char_t const* hello = tb_string_pool_insert(tb_string_pool(), "hello world");
-    tb_trace_i("hello: %s", hello);
+    // init context
+    tb_demo_context_t context;
+    tb_memset(&context, 0, sizeof(context));
+    tb_spinlock_init(&context.lock);
+    context.hash = tb_hash_map_init(0, tb_element_str(tb_true), tb_element_size());
+    if (context.hash)
+    {
+        // insert all strings
+        tb_size_t i;
+        for (i = 0; i < TB_DEMO_STRING_COUNT; i++)
+            tb_hash_map_insert(context.hash, g_strings[i], tb_u2p(1));
 
-    // performance
-    tb_char_t s[256] = {0};
-    tb_hong_t t = tb_mclock();
-    __tb_volatile__ tb_size_t n = 1000000;
-    while (n--)
+        // run threads
+        tb_demo_run("locked hash map", &context, tb_demo_hash_thread, 1);
+        tb_demo_run("locked hash map", &context, tb_demo_hash_thread, TB_DEMO_THREAD_COUNT);
+
+        // exit hash
+        tb_hash_map_exit(context.hash);
+    }
+    tb_spinlock_exit(&context.lock);
+}
+static tb_void_t tb_demo_pool_element()
+{
+    // init pool
+    tb_string_pool_ref_t pool = tb_string_pool_init_with(TB_STRING_POOL_FLAG_NOCASE);
+    if (pool)
     {
-        tb_int_t r = tb_snprintf(s, 256, "%u", tb_random_range(0, 10000));
-        s[r] = '\0';
-#if 1
-        tb_string_pool_insert(tb_string_pool(), s);
-        if (!(n & 15)) tb_string_pool_remove(tb_string_pool(), s);
-#else
-        tb_free(tb_strdup(s));
-#endif
+        // the interned strings are same if they are equal without case
+        tb_char_t const* name1 = tb_string_pool_insert(pool, "Content-Type");
+        tb_char_t const* name2 = tb_string_pool_insert(pool, "content-type");
+        tb_trace_i("%s == %s: %s, size: %lu", name1, name2, name1 == name2? "ok" : "failed", tb_string_pool_cstr_size(name1));
+
+        // key hash map by the interned strings
+        tb_hash_map_ref_t hash = tb_hash_map_init(0, tb_element_istr(), tb_element_size());
+        if (hash)
+        {
+            tb_hash_map_insert(hash, name1, tb_u2p(1));
+            tb_trace_i("%s: %lu", name2, (tb_size_t)tb_hash_map_get(hash, tb_string_pool_find(pool, "CONTENT-TYPE")));
+            tb_hash_map_exit(hash);
+        }
+        tb_string_pool_exit(pool);
     }
-    t = tb_mclock() - t;
-    tb_trace_i("time: %lld", t);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_memory_string_pool_main(tb_int_t argc, tb_char_t** argv)
+{
+    // init strings
+    tb_size_t i;
+    for (i = 0; i < TB_DEMO_STRING_COUNT; i++)
+        tb_snprintf(g_strings[i], sizeof(g_strings[i]), "x-header-name-%lu", i);
+
+    // key hash map by the interned strings
+    tb_demo_pool_element();
 
-    // del hello
-    tb_string_pool_remove(tb_string_pool(), hello);
-#endif
+    // intern strings in some threads
+    tb_demo_hash_test();
+    tb_demo_pool_test("string pool", TB_STRING_POOL_FLAG_NONE);
+    tb_demo_pool_test("string pool(reclaim)", TB_STRING_POOL_FLAG_RECLAIM);
     return 0;
 }
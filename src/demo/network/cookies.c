@@ -1,5 +1,136 @@
 #include "../demo.h"
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the domain count
+#define TB_DEMO_DOMAIN_COUNT        (100000)
+
+// the cookie count of each domain
+#define TB_DEMO_DOMAIN_COOKIES      (10)
+
+// the thread count
+#define TB_DEMO_THREAD_COUNT        (4)
+
+// the get count of each thread
+#define TB_DEMO_GET_COUNT           (200000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_int_t tb_demo_cookies_get_thread(tb_cpointer_t priv)
+{
+    // check
+    tb_cookies_ref_t cookies = (tb_cookies_ref_t)priv;
+    tb_assert_and_check_return_val(cookies, -1);
+
+    // get the cookies of the random urls
+    tb_size_t   i;
+    tb_size_t   count = 0;
+    tb_char_t   url[256];
+    tb_uint32_t seed = (tb_uint32_t)tb_p2u32(tb_thread_self());
+    tb_string_t value;
+    tb_string_init(&value);
+    for (i = 0; i < TB_DEMO_GET_COUNT; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        tb_size_t domain = (seed >> 8) % TB_DEMO_DOMAIN_COUNT;
+        tb_snprintf(url, sizeof(url), "http://www.mail.site%lu.com/path%lu/index.html", domain, (seed >> 4) % TB_DEMO_DOMAIN_COOKIES);
+        if (tb_cookies_get_from_url(cookies, url, &value)) count++;
+    }
+    tb_string_exit(&value);
+    return count == TB_DEMO_GET_COUNT? 0 : -1;
+}
+static tb_void_t tb_demo_cookies_get(tb_cookies_ref_t cookies, tb_size_t count)
+{
+    // start threads
+    tb_size_t       i;
+    tb_size_t       failed = 0;
+    tb_thread_ref_t threads[TB_DEMO_THREAD_COUNT] = {0};
+    tb_hong_t       time = tb_mclock();
+    for (i = 0; i < count; i++)
+        threads[i] = tb_thread_init(tb_null, tb_demo_cookies_get_thread, cookies, 0);
+
+    // wait threads
+    for (i = 0; i < count; i++)
+    {
+        tb_int_t retval = -1;
+        if (threads[i])
+        {
+            tb_thread_wait(threads[i], -1, &retval);
+            tb_thread_exit(threads[i]);
+        }
+        if (retval) failed++;
+    }
+    time = tb_mclock() - time;
+
+    // trace
+    tb_hize_t total = (tb_hize_t)TB_DEMO_GET_COUNT * count;
+    tb_trace_i("get: threads: %lu, %llu urls in %lld ms, %lld urls/ms, failed: %lu", count, total, time, time? (tb_hong_t)total / time : 0, failed);
+}
+static tb_void_t tb_demo_cookies_bench()
+{
+    // init cookies
+    tb_cookies_ref_t cookies = tb_cookies_init();
+    tb_assert_and_check_return(cookies);
+
+    // set 1M cookies, e.g. "name3=value3; domain=mail.site3.com; path=/path3", the first cookie of each domain is at "/"
+    tb_size_t i;
+    tb_size_t j;
+    tb_char_t data[256];
+    tb_char_t path[TB_PATH_MAXN];
+    tb_hong_t time = tb_mclock();
+    for (i = 0; i < TB_DEMO_DOMAIN_COUNT; i++)
+    {
+        for (j = 0; j < TB_DEMO_DOMAIN_COOKIES; j++)
+        {
+            if (j) tb_snprintf(path, sizeof(path), "/path%lu", j);
+            else tb_strlcpy(path, "/", sizeof(path));
+            tb_snprintf(data, sizeof(data), "name%lu=value%lu; max-age=86400; expires=Sun, 18 Jan 2037 00:00:00 GMT; domain=%ssite%lu.com; path=%s", j, i, (j & 1)? "mail." : "", i, path);
+            tb_cookies_set(cookies, tb_null, tb_null, tb_false, data);
+        }
+    }
+    time = tb_mclock() - time;
+    tb_trace_i("set: %lu cookies in %lld ms", i * j, time);
+
+    // get cookies
+    tb_string_t value;
+    tb_string_init(&value);
+    tb_trace_i("get: %s", tb_cookies_get_from_url(cookies, "http://www.mail.site3.com/path3/index.html", &value));
+    tb_demo_cookies_get(cookies, 1);
+    tb_demo_cookies_get(cookies, TB_DEMO_THREAD_COUNT);
+
+    // save and load the snapshot
+    if (tb_directory_temporary(path, sizeof(path)))
+    {
+        tb_strcat(path, "/tbox_demo_cookies.dat");
+
+        // save it
+        time = tb_mclock();
+        tb_bool_t ok = tb_cookies_save(cookies, path);
+        time = tb_mclock() - time;
+        tb_trace_i("save: %s in %lld ms", ok? "ok" : "failed", time);
+
+        // load it to the new cookies
+        tb_cookies_ref_t loaded = tb_cookies_init();
+        if (loaded)
+        {
+            time = tb_mclock();
+            ok = tb_cookies_load(loaded, path);
+            time = tb_mclock() - time;
+            tb_trace_i("load: %s in %lld ms", ok? "ok" : "failed", time);
+            tb_trace_i("get: %s", tb_cookies_get_from_url(loaded, "http://www.mail.site3.com/path3/index.html", &value));
+            tb_cookies_exit(loaded);
+        }
+        tb_file_remove(path);
+    }
+    tb_string_exit(&value);
+
+    // exit cookies
+    tb_cookies_exit(cookies);
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * main
  */
@@ -31,5 +162,7 @@ tb_int_t tb_demo_network_cookies_main(tb_int_t argc, tb_char_t** argv)
     tb_trace_i("%s", tb_cookies_get_from_url(tb_cookies(), "http://mail.163.com:2000/?Session=LZBMQVW&View=Menu", &value));
     tb_string_exit(&value);
 
+    // benchmark, e.g. xmake r demo network_cookies bench
+    if (argv[1] && !tb_strcmp(argv[1], "bench")) tb_demo_cookies_bench();
     return 0;
 }
@@ -3,9 +3,132 @@
  */
 #include "../demo.h"
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the request count of the benchmark
+#define TB_DEMO_REQUEST_COUNT       (100000)
+
+// the response of the local server
+#define TB_DEMO_RESPONSE            "HTTP/1.1 200 OK\r\n" \
+                                    "Date: Fri, 23 Apr 2010 05:25:45 GMT\r\n" \
+                                    "Server: Apache/2.2.9 (Ubuntu) PHP/5.2.6-2ubuntu4.5 with Suhosin-Patch\r\n" \
+                                    "Last-Modified: Mon, 08 Mar 2010 09:58:09 GMT\r\n" \
+                                    "ETag: \"6cc014-8f47f-481471a322e40\"\r\n" \
+                                    "Cache-Control: max-age=3600, public\r\n" \
+                                    "Accept-Ranges: bytes\r\n" \
+                                    "Vary: Accept-Encoding\r\n" \
+                                    "X-Powered-By: tbox\r\n" \
+                                    "Content-Type: text/plain; charset=utf-8\r\n" \
+                                    "Content-Length: 13\r\n" \
+                                    "Connection: keep-alive\r\n" \
+                                    "\r\n" \
+                                    "hello world!\n"
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
+static tb_int_t tb_http_demo_server(tb_cpointer_t priv)
+{
+    // check
+    tb_socket_ref_t sock = (tb_socket_ref_t)priv;
+    tb_assert_and_check_return_val(sock, -1);
+
+    // accept the client connections
+    tb_size_t       count = 0;
+    tb_socket_ref_t client = tb_null;
+    while (count < TB_DEMO_REQUEST_COUNT && tb_socket_wait(sock, TB_SOCKET_EVENT_ACPT, -1) > 0 && (client = tb_socket_accept(sock, tb_null)))
+    {
+        // recv the request and send the response, the request only has head
+        tb_char_t data[8192];
+        tb_size_t size = 0;
+        while (count < TB_DEMO_REQUEST_COUNT)
+        {
+            // recv data
+            tb_long_t real = tb_socket_recv(client, (tb_byte_t*)data + size, sizeof(data) - size - 1);
+            if (!real && tb_socket_wait(client, TB_SOCKET_EVENT_RECV, -1) > 0) continue;
+            tb_check_break(real > 0);
+            size += real;
+            data[size] = '\0';
+
+            // the request end?
+            tb_char_t const* end = tb_strstr(data, "\r\n\r\n");
+            tb_check_continue(end);
+            tb_assert_and_check_break(end + 4 == data + size);
+
+            // send the response
+            if (!tb_socket_bsend(client, (tb_byte_t const*)TB_DEMO_RESPONSE, sizeof(TB_DEMO_RESPONSE) - 1)) break;
+            size = 0;
+            count++;
+        }
+
+        // exit client
+        tb_socket_exit(client);
+    }
+    return 0;
+}
+static tb_void_t tb_http_demo_bench()
+{
+    // init the local server
+    tb_ipaddr_t     addr;
+    tb_thread_ref_t thread = tb_null;
+    tb_socket_ref_t sock = tb_socket_init(TB_SOCKET_TYPE_TCP, TB_IPADDR_FAMILY_IPV4);
+    tb_http_ref_t   http = tb_http_init();
+    do
+    {
+        // bind and listen the random port
+        tb_check_break(sock && http);
+        tb_ipaddr_set(&addr, "127.0.0.1", 0, TB_IPADDR_FAMILY_IPV4);
+        if (!tb_socket_bind(sock, &addr) || !tb_socket_local(sock, &addr)) break;
+        if (!tb_socket_listen(sock, 5)) break;
+
+        // start the server
+        thread = tb_thread_init(tb_null, tb_http_demo_server, sock, 0);
+        tb_assert_and_check_break(thread);
+
+        // init url and head
+        tb_char_t url[256];
+        tb_snprintf(url, sizeof(url), "http://127.0.0.1:%u/path/index.html?a=1&b=2", tb_ipaddr_port(&addr));
+        if (!tb_http_ctrl(http, TB_HTTP_OPTION_SET_URL, url)) break;
+        if (!tb_http_ctrl(http, TB_HTTP_OPTION_SET_HEAD, "User-Agent", "tbox")) break;
+        if (!tb_http_ctrl(http, TB_HTTP_OPTION_SET_HEAD, "Accept-Encoding", "identity")) break;
+        if (!tb_http_ctrl(http, TB_HTTP_OPTION_SET_HEAD, "X-Request-Id", "0123456789abcdef")) break;
+
+        // done requests with keep-alive
+        tb_size_t i;
+        tb_size_t failed = 0;
+        tb_byte_t data[64];
+        tb_hong_t time = tb_mclock();
+        for (i = 0; i < TB_DEMO_REQUEST_COUNT; i++)
+        {
+            if (tb_http_open(http))
+            {
+                tb_size_t size = (tb_size_t)tb_http_status(http)->content_size;
+                if (size > sizeof(data) || !tb_http_bread(http, data, size)) failed++;
+                tb_http_close(http);
+            }
+            else failed++;
+        }
+        time = tb_mclock() - time;
+
+        // trace
+        tb_trace_i("bench: %lu requests in %lld ms, %lld req/s, failed: %lu", i, time, time? (tb_hong_t)i * 1000 / time : 0, failed);
+
+    } while (0);
+
+    // exit the client first, the server will exit after the connection is closed
+    if (http) tb_http_exit(http);
+
+    // exit the server
+    if (thread)
+    {
+        if (sock) tb_socket_kill(sock, TB_SOCKET_KILL_RW);
+        tb_thread_wait(thread, -1, tb_null);
+        tb_thread_exit(thread);
+    }
+    if (sock) tb_socket_exit(sock);
+}
 static tb_bool_t tb_http_demo_head_func(tb_char_t const* line, tb_cpointer_t priv)
 {
     // check
@@ -23,6 +146,13 @@ static tb_bool_t tb_http_demo_head_func(tb_char_t const* line, tb_cpointer_t pri
  */
 tb_int_t tb_demo_network_http_main(tb_int_t argc, tb_char_t** argv)
 {
+    // no url? benchmark it with the local server
+    if (argc < 2 || !argv[1])
+    {
+        tb_http_demo_bench();
+        return 0;
+    }
+
     // done
     tb_http_ref_t http = tb_null;
     do
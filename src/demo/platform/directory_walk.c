@@ -0,0 +1,126 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the directories count of each level
+#define TB_DEMO_DIRS_COUNT      (10)
+
+// the files count of each directory
+#define TB_DEMO_FILES_COUNT     (30)
+
+// the directory depth
+#define TB_DEMO_DEPTH           (3)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the walked entries count
+static tb_atomic_t  g_count = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_bool_t tb_demo_directory_walk_func(tb_char_t const* path, tb_file_info_t const* info, tb_cpointer_t priv)
+{
+    tb_atomic_fetch_and_add(&g_count, 1);
+    return tb_true;
+}
+static tb_bool_t tb_demo_directory_walk_batch_func(tb_directory_entry_t const* entries, tb_size_t count, tb_cpointer_t priv)
+{
+    tb_atomic_fetch_and_add(&g_count, count);
+    return tb_true;
+}
+static tb_void_t tb_demo_directory_make(tb_char_t const* path, tb_size_t depth)
+{
+    // make directory
+    tb_directory_create(path);
+
+    // make files
+    tb_size_t i = 0;
+    tb_char_t temp[TB_PATH_MAXN];
+    for (i = 0; i < TB_DEMO_FILES_COUNT; i++)
+    {
+        tb_snprintf(temp, sizeof(temp), "%s/file%lu.txt", path, i);
+        tb_file_ref_t file = tb_file_init(temp, TB_FILE_MODE_RW | TB_FILE_MODE_CREAT | TB_FILE_MODE_TRUNC);
+        if (file)
+        {
+            tb_file_writ(file, (tb_byte_t const*)temp, tb_strlen(temp));
+            tb_file_exit(file);
+        }
+    }
+
+    // make subdirectories
+    if (depth)
+    {
+        for (i = 0; i < TB_DEMO_DIRS_COUNT; i++)
+        {
+            tb_snprintf(temp, sizeof(temp), "%s/dir%lu", path, i);
+            tb_demo_directory_make(temp, depth - 1);
+        }
+    }
+}
+static tb_void_t tb_demo_directory_walk_bench(tb_char_t const* name, tb_char_t const* path, tb_size_t flags, tb_bool_t batch)
+{
+    // walk it
+    tb_atomic_set(&g_count, 0);
+    tb_hong_t time = tb_mclock();
+    if (batch) tb_directory_walk_batch(path, -1, flags, tb_demo_directory_walk_batch_func, tb_null);
+    else tb_directory_walk(path, -1, tb_false, tb_demo_directory_walk_func, tb_null);
+    time = tb_mclock() - time;
+
+    // trace
+    tb_size_t count = (tb_size_t)tb_atomic_get(&g_count);
+    tb_trace_i("%s: %lu entries in %lld ms, %lld entries per second", name, count, time, (tb_hong_t)count * 1000 / (time? time : 1));
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_platform_directory_walk_main(tb_int_t argc, tb_char_t** argv)
+{
+    // the test directory
+    tb_char_t path[TB_PATH_MAXN] = {0};
+    if (argc > 1 && argv[1]) tb_strlcpy(path, argv[1], sizeof(path));
+    else
+    {
+        tb_char_t temp[TB_PATH_MAXN] = {0};
+        tb_directory_temporary(temp, sizeof(temp));
+        tb_snprintf(path, sizeof(path), "%s/tbox_directory_walk", temp);
+
+        // make the test directory tree
+        tb_hong_t time = tb_mclock();
+        tb_demo_directory_make(path, TB_DEMO_DEPTH);
+        tb_trace_i("make %s in %lld ms", path, tb_mclock() - time);
+    }
+
+    // walk it, run it twice to warm up the directory cache
+    tb_demo_directory_walk_bench("walk", path, 0, tb_false);
+    tb_demo_directory_walk_bench("walk", path, 0, tb_false);
+    tb_demo_directory_walk_bench("walk_batch", path, TB_DIRECTORY_WALK_FLAG_NONE, tb_true);
+    tb_demo_directory_walk_bench("walk_batch(typeonly)", path, TB_DIRECTORY_WALK_FLAG_TYPEONLY, tb_true);
+    tb_demo_directory_walk_bench("walk_batch(typeonly|parallel)", path, TB_DIRECTORY_WALK_FLAG_TYPEONLY | TB_DIRECTORY_WALK_FLAG_PARALLEL, tb_true);
+
+    // copy and remove the generated directory tree
+    if (argc < 2)
+    {
+        tb_char_t dest[TB_PATH_MAXN];
+        tb_snprintf(dest, sizeof(dest), "%s_copy", path);
+
+        tb_hong_t time = tb_mclock();
+        tb_bool_t ok = tb_directory_copy(path, dest);
+        tb_trace_i("copy: %s in %lld ms", ok? "ok" : "failed", tb_mclock() - time);
+        tb_demo_directory_walk_bench("walk_batch(copied)", dest, TB_DIRECTORY_WALK_FLAG_TYPEONLY, tb_true);
+
+        time = tb_mclock();
+        ok = tb_directory_remove(dest);
+        tb_trace_i("remove: %s in %lld ms", ok? "ok" : "failed", tb_mclock() - time);
+        tb_directory_remove(path);
+    }
+    return 0;
+}
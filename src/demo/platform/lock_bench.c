@@ -0,0 +1,332 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the maximum thread count
+#define TB_DEMO_THREAD_MAXN         (64)
+
+// the operation count of each thread
+#define TB_DEMO_OPERATIONS          (200000)
+
+// the round trip count of the semaphore ping-pong
+#define TB_DEMO_ROUND_TRIPS         (100000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the lock type
+typedef enum __tb_demo_lock_e
+{
+    TB_DEMO_LOCK_SPINLOCK       = 0
+,   TB_DEMO_LOCK_MCSLOCK        = 1
+,   TB_DEMO_LOCK_MUTEX          = 2
+,   TB_DEMO_LOCK_FUTEX_MUTEX    = 3
+,   TB_DEMO_LOCK_RWLOCK         = 4
+
+}tb_demo_lock_e;
+
+// the bench context type
+typedef struct __tb_demo_context_t
+{
+    // the lock type
+    tb_size_t                   type;
+
+    // the read percent
+    tb_size_t                   reads;
+
+    // the spinlock
+    tb_spinlock_t               spinlock;
+
+    // the mcs lock
+    tb_mcslock_t                mcslock;
+
+    // the mutex
+    tb_mutex_ref_t              mutex;
+
+    // the futex mutex
+    tb_futex_mutex_t            futex_mutex;
+
+    // the reader-writer lock
+    tb_rwlock_ref_t             rwlock;
+
+    // the shared counter, it's protected by the lock
+    tb_size_t                   counter;
+
+    // the shared value for readers
+    tb_size_t                   values[8];
+
+    // the write count
+    tb_atomic_t                 writes;
+
+}tb_demo_context_t;
+
+// the ping-pong context type
+typedef struct __tb_demo_pingpong_t
+{
+    // the semaphores
+    tb_semaphore_ref_t          ping;
+    tb_semaphore_ref_t          pong;
+
+    // the events
+    tb_event_ref_t              event_ping;
+    tb_event_ref_t              event_pong;
+
+}tb_demo_pingpong_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_lock_enter(tb_demo_context_t* context, tb_mcslock_node_ref_t node, tb_bool_t read)
+{
+    switch (context->type)
+    {
+    case TB_DEMO_LOCK_SPINLOCK:     tb_spinlock_enter(&context->spinlock); break;
+    case TB_DEMO_LOCK_MCSLOCK:      tb_mcslock_enter(&context->mcslock, node); break;
+    case TB_DEMO_LOCK_MUTEX:        tb_mutex_enter(context->mutex); break;
+    case TB_DEMO_LOCK_FUTEX_MUTEX:  tb_futex_mutex_enter(&context->futex_mutex); break;
+    case TB_DEMO_LOCK_RWLOCK:
+        if (read) tb_rwlock_enter_read(context->rwlock);
+        else tb_rwlock_enter_write(context->rwlock);
+        break;
+    default: break;
+    }
+}
+static tb_void_t tb_demo_lock_leave(tb_demo_context_t* context, tb_mcslock_node_ref_t node, tb_bool_t read)
+{
+    switch (context->type)
+    {
+    case TB_DEMO_LOCK_SPINLOCK:     tb_spinlock_leave(&context->spinlock); break;
+    case TB_DEMO_LOCK_MCSLOCK:      tb_mcslock_leave(&context->mcslock, node); break;
+    case TB_DEMO_LOCK_MUTEX:        tb_mutex_leave(context->mutex); break;
+    case TB_DEMO_LOCK_FUTEX_MUTEX:  tb_futex_mutex_leave(&context->futex_mutex); break;
+    case TB_DEMO_LOCK_RWLOCK:
+        if (read) tb_rwlock_leave_read(context->rwlock);
+        else tb_rwlock_leave_write(context->rwlock);
+        break;
+    default: break;
+    }
+}
+static tb_int_t tb_demo_lock_loop(tb_cpointer_t priv)
+{
+    // run all operations
+    tb_demo_context_t*  context = (tb_demo_context_t*)priv;
+    tb_mcslock_node_t   node;
+    tb_size_t           writes = 0;
+    tb_size_t           errors = 0;
+    tb_size_t           i = 0;
+    tb_uint32_t         seed = (tb_uint32_t)tb_thread_self();
+    for (i = 0; i < TB_DEMO_OPERATIONS; i++)
+    {
+        // read or write?
+        seed = seed * 1103515245 + 12345;
+        tb_bool_t read = ((seed >> 16) % 100) < context->reads;
+
+        // enter it
+        tb_demo_lock_enter(context, &node, read);
+
+        // read all values, they need be always equal
+        if (read)
+        {
+            tb_size_t j = 0;
+            for (j = 1; j < tb_arrayn(context->values); j++)
+            {
+                if (context->values[j] != context->values[0]) errors++;
+            }
+        }
+        // write all values
+        else
+        {
+            tb_size_t j = 0;
+            context->counter++;
+            for (j = 0; j < tb_arrayn(context->values); j++)
+                context->values[j] = context->counter;
+            writes++;
+        }
+
+        // leave it
+        tb_demo_lock_leave(context, &node, read);
+    }
+
+    // save the write count
+    tb_atomic_fetch_and_add(&context->writes, (tb_long_t)writes);
+    if (errors) tb_trace_e("%lu inconsistent reads!", errors);
+    return 0;
+}
+static tb_void_t tb_demo_lock_bench(tb_char_t const* name, tb_size_t type, tb_size_t reads, tb_size_t threads_maxn)
+{
+    // init context
+    tb_demo_context_t context;
+    tb_memset(&context, 0, sizeof(context));
+    context.type    = type;
+    context.reads   = reads;
+    context.mutex   = tb_mutex_init();
+    context.rwlock  = tb_rwlock_init();
+    tb_spinlock_init(&context.spinlock);
+    tb_mcslock_init(&context.mcslock);
+    tb_futex_mutex_init(&context.futex_mutex);
+    tb_assert_and_check_return(context.mutex && context.rwlock);
+
+    // run it with 1 ~ maxn threads
+    tb_size_t count = 1;
+    for (count = 1; count <= threads_maxn; count <<= 1)
+    {
+        // reset counter
+        context.counter = 0;
+        tb_atomic_set(&context.writes, 0);
+
+        // run threads
+        tb_size_t       i = 0;
+        tb_size_t       n = 0;
+        tb_thread_ref_t threads[TB_DEMO_THREAD_MAXN] = {0};
+        tb_hong_t       time = tb_mclock();
+        for (i = 0; i < count; i++)
+        {
+            if ((threads[n] = tb_thread_init(tb_null, tb_demo_lock_loop, &context, 0))) n++;
+        }
+        for (i = 0; i < n; i++)
+        {
+            tb_thread_wait(threads[i], -1, tb_null);
+            tb_thread_exit(threads[i]);
+        }
+        time = tb_mclock() - time;
+
+        // trace
+        tb_bool_t ok = context.counter == (tb_size_t)tb_atomic_get(&context.writes);
+        tb_trace_i("%-12s: reads: %2lu%%, threads: %2lu, %6lld Kops/s, %s", name, reads, n
+                   , (tb_hong_t)(n * TB_DEMO_OPERATIONS) / (time? time : 1), ok? "ok" : "failed");
+    }
+
+    // exit context
+    tb_mutex_exit(context.mutex);
+    tb_rwlock_exit(context.rwlock);
+    tb_mcslock_exit(&context.mcslock);
+    tb_futex_mutex_exit(&context.futex_mutex);
+    tb_spinlock_exit(&context.spinlock);
+}
+static tb_int_t tb_demo_pingpong_loop(tb_cpointer_t priv)
+{
+    // pong it
+    tb_demo_pingpong_t* pingpong = (tb_demo_pingpong_t*)priv;
+    tb_size_t           i = 0;
+    for (i = 0; i < TB_DEMO_ROUND_TRIPS; i++)
+    {
+        if (tb_semaphore_wait(pingpong->ping, -1) <= 0) break;
+        tb_semaphore_post(pingpong->pong, 1);
+    }
+    for (i = 0; i < TB_DEMO_ROUND_TRIPS; i++)
+    {
+        if (tb_event_wait(pingpong->event_ping, -1) <= 0) break;
+        tb_event_post(pingpong->event_pong);
+    }
+    return 0;
+}
+static tb_void_t tb_demo_pingpong_bench()
+{
+    // init semaphores and events
+    tb_demo_pingpong_t pingpong;
+    pingpong.ping       = tb_semaphore_init(0);
+    pingpong.pong       = tb_semaphore_init(0);
+    pingpong.event_ping = tb_event_init();
+    pingpong.event_pong = tb_event_init();
+    if (pingpong.ping && pingpong.pong && pingpong.event_ping && pingpong.event_pong)
+    {
+        // check timeout
+        tb_hong_t time = tb_mclock();
+        tb_long_t wait = tb_semaphore_wait(pingpong.ping, 10);
+        time = tb_mclock() - time;
+        tb_trace_i("semaphore: wait timeout: %ld, %lld ms", wait, time);
+
+        // ping it
+        tb_thread_ref_t thread = tb_thread_init(tb_null, tb_demo_pingpong_loop, &pingpong, 0);
+        if (thread)
+        {
+            tb_size_t i = 0;
+            time = tb_mclock();
+            for (i = 0; i < TB_DEMO_ROUND_TRIPS; i++)
+            {
+                tb_semaphore_post(pingpong.ping, 1);
+                if (tb_semaphore_wait(pingpong.pong, -1) <= 0) break;
+            }
+            time = tb_mclock() - time;
+            tb_trace_i("semaphore: %lu round trips, %lld ns/trip", i, time * 1000000 / (i? i : 1));
+
+            time = tb_mclock();
+            for (i = 0; i < TB_DEMO_ROUND_TRIPS; i++)
+            {
+                tb_event_post(pingpong.event_ping);
+                if (tb_event_wait(pingpong.event_pong, -1) <= 0) break;
+            }
+            time = tb_mclock() - time;
+            tb_trace_i("event: %lu round trips, %lld ns/trip", i, time * 1000000 / (i? i : 1));
+
+            tb_thread_wait(thread, -1, tb_null);
+            tb_thread_exit(thread);
+        }
+    }
+
+    // exit semaphores and events
+    if (pingpong.ping) tb_semaphore_exit(pingpong.ping);
+    if (pingpong.pong) tb_semaphore_exit(pingpong.pong);
+    if (pingpong.event_ping) tb_event_exit(pingpong.event_ping);
+    if (pingpong.event_pong) tb_event_exit(pingpong.event_pong);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_platform_lock_bench_main(tb_int_t argc, tb_char_t** argv)
+{
+    // the maximum thread count
+    tb_size_t maxn = argv[1]? tb_atoi(argv[1]) : 16;
+    maxn = tb_max(tb_min(maxn, TB_DEMO_THREAD_MAXN), 1);
+
+    // sample the locks, e.g. platform_lock_bench 16 100
+#ifdef TB_LOCK_PROFILER_SAMPLE_ENABLE
+    tb_size_t rate = argv[1] && argv[2]? tb_atoi(argv[2]) : 0;
+    if (rate) tb_lock_profiler_sample(rate);
+#endif
+
+    // the exclusive locks
+    tb_demo_lock_bench("spinlock",      TB_DEMO_LOCK_SPINLOCK,      0, maxn);
+    tb_demo_lock_bench("mcslock",       TB_DEMO_LOCK_MCSLOCK,       0, maxn);
+    tb_demo_lock_bench("mutex",         TB_DEMO_LOCK_MUTEX,         0, maxn);
+    tb_demo_lock_bench("futex_mutex",   TB_DEMO_LOCK_FUTEX_MUTEX,   0, maxn);
+    tb_demo_lock_bench("rwlock",        TB_DEMO_LOCK_RWLOCK,        0, maxn);
+
+    // the read-mostly locks
+    tb_demo_lock_bench("spinlock",      TB_DEMO_LOCK_SPINLOCK,      90, maxn);
+    tb_demo_lock_bench("futex_mutex",   TB_DEMO_LOCK_FUTEX_MUTEX,   90, maxn);
+    tb_demo_lock_bench("rwlock",        TB_DEMO_LOCK_RWLOCK,        90, maxn);
+    tb_demo_lock_bench("rwlock",        TB_DEMO_LOCK_RWLOCK,        99, maxn);
+
+    // the semaphore and event
+    tb_demo_pingpong_bench();
+
+    // dump the sampled locks
+#ifdef TB_LOCK_PROFILER_SAMPLE_ENABLE
+    if (rate)
+    {
+        // dump them as text
+        tb_lock_profiler_dump(tb_lock_profiler());
+
+        // write them as json
+#ifdef TB_CONFIG_MODULE_HAVE_OBJECT
+        tb_char_t path[TB_PATH_MAXN];
+        tb_size_t size = tb_directory_temporary(path, sizeof(path));
+        if (size && size + 32 < sizeof(path))
+        {
+            tb_strcat(path, "/lock_profiler.json");
+            tb_trace_i("%s: %ld bytes", path, tb_lock_profiler_writ_to_url(tb_lock_profiler(), path, TB_OBJECT_FORMAT_JSON));
+        }
+#endif
+        tb_lock_profiler_sample(0);
+    }
+#endif
+    return 0;
+}
@@ -0,0 +1,133 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the default idle socket pairs count
+#define TB_DEMO_IDLE_MAXN       (8000)
+
+// the hot socket pairs count
+#define TB_DEMO_HOT_MAXN        (64)
+
+// the waiting count of each test
+#define TB_DEMO_WAIT_COUNT      (200000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the socket pair type
+typedef struct __tb_demo_pair_t
+{
+    // the sockets
+    tb_socket_ref_t         sock[2];
+
+    // the triggered count
+    tb_size_t               count;
+
+}tb_demo_pair_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_poller_event(tb_poller_ref_t poller, tb_poller_object_ref_t object, tb_long_t events, tb_cpointer_t priv)
+{
+    // count it
+    tb_demo_pair_t* pair = (tb_demo_pair_t*)priv;
+    if (pair && (events & TB_POLLER_EVENT_RECV)) pair->count++;
+}
+static tb_void_t tb_demo_poller_bench(tb_demo_pair_t* pairs, tb_size_t count, tb_bool_t batch)
+{
+    // init poller
+    tb_poller_ref_t poller = tb_poller_init(tb_null);
+    tb_assert_and_check_return(poller);
+
+    // insert all sockets, the hot sockets are always readable with the level trigger
+    tb_size_t i;
+    for (i = 0; i < count; i++)
+    {
+        pairs[i].count = 0;
+        if (!tb_poller_insert_sock(poller, pairs[i].sock[1], TB_POLLER_EVENT_RECV, &pairs[i])) break;
+    }
+
+    // wait events
+    if (i == count)
+    {
+        tb_poller_event_t   list[TB_DEMO_HOT_MAXN];
+        tb_hize_t           total = 0;
+        tb_hong_t           time = tb_mclock();
+        for (i = 0; i < TB_DEMO_WAIT_COUNT; i++)
+        {
+            tb_long_t wait = 0;
+            if (batch)
+            {
+                wait = tb_poller_wait_events(poller, list, tb_arrayn(list), -1);
+                tb_long_t j;
+                for (j = 0; j < wait; j++)
+                    tb_demo_poller_event(poller, &list[j].object, list[j].events, list[j].priv);
+            }
+            else wait = tb_poller_wait(poller, tb_demo_poller_event, -1);
+            tb_check_break(wait > 0);
+            total += wait;
+        }
+        time = tb_mclock() - time;
+
+        // check
+        tb_hize_t hits = 0;
+        for (i = 0; i < count; i++) hits += pairs[i].count;
+
+        // trace
+        tb_trace_i("%s: %lu sockets, %llu events in %lld ms, %lld events/s, hits: %llu", batch? "tb_poller_wait_events" : "tb_poller_wait"
+                   , count, total, time, time > 0? (tb_hong_t)(total * 1000 / time) : 0, hits);
+    }
+
+    // exit poller
+    tb_poller_exit(poller);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_platform_poller_bench_main(tb_int_t argc, tb_char_t** argv)
+{
+    // the idle count
+    tb_size_t idle = argc > 1 && argv[1]? tb_atoi(argv[1]) : TB_DEMO_IDLE_MAXN;
+
+    // init socket pairs, the hot sockets are at the end of the list
+    tb_size_t       i = 0;
+    tb_size_t       count = idle + TB_DEMO_HOT_MAXN;
+    tb_demo_pair_t* pairs = tb_nalloc0_type(count, tb_demo_pair_t);
+    tb_assert_and_check_return_val(pairs, -1);
+    for (i = 0; i < count; i++)
+    {
+        if (!tb_socket_pair(TB_SOCKET_TYPE_TCP, pairs[i].sock)) break;
+    }
+    if (i == count)
+    {
+        // make the hot sockets readable
+        for (i = idle; i < count; i++)
+            tb_socket_send(pairs[i].sock[0], (tb_byte_t const*)"x", 1);
+
+        // wait the sent data
+        for (i = idle; i < count; i++)
+            tb_socket_wait(pairs[i].sock[1], TB_SOCKET_EVENT_RECV, -1);
+
+        // run benchmarks
+        tb_demo_poller_bench(pairs, count, tb_false);
+        tb_demo_poller_bench(pairs, count, tb_true);
+    }
+    else tb_trace_e("init socket pairs failed, please increase the file limit or decrease the idle count: %lu", idle);
+
+    // exit socket pairs
+    for (i = 0; i < count; i++)
+    {
+        if (pairs[i].sock[0]) tb_socket_exit(pairs[i].sock[0]);
+        if (pairs[i].sock[1]) tb_socket_exit(pairs[i].sock[1]);
+    }
+    tb_free(pairs);
+    return 0;
+}
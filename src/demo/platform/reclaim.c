@@ -0,0 +1,349 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the magic of the alive data
+#define TB_DEMO_DATA_ALIVE          (0x600dda7a)
+
+// the magic of the freed data
+#define TB_DEMO_DATA_FREED          (0xdeadda7a)
+
+// the maximum thread count
+#define TB_DEMO_THREAD_MAXN         (64)
+
+// the stress update count of each writer
+#define TB_DEMO_STRESS_UPDATES      (200000)
+
+// the bench read count of each reader
+#define TB_DEMO_BENCH_READS         (1000000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the shared data type
+typedef struct __tb_demo_data_t
+{
+    // the magic
+    tb_uint32_t                 magic;
+
+    // the value, it's always equal to the magic xor the sequence
+    tb_size_t                   value;
+
+    // the sequence
+    tb_size_t                   sequence;
+
+}tb_demo_data_t;
+
+// the reclaim mode
+typedef enum __tb_demo_mode_e
+{
+    TB_DEMO_MODE_SPINLOCK       = 0
+,   TB_DEMO_MODE_RCU            = 1
+,   TB_DEMO_MODE_HAZARD         = 2
+
+}tb_demo_mode_e;
+
+// the test context type
+typedef struct __tb_demo_context_t
+{
+    // the mode
+    tb_size_t                   mode;
+
+    // the read count of each reader
+    tb_size_t                   reads;
+
+    // the update count of each writer, it will update it until all readers have finished if it's zero
+    tb_size_t                   updates;
+
+    // the running reader count
+    tb_atomic_t                 readers;
+
+    // the total read count
+    tb_atomic_t                 total;
+
+    // the bad read count
+    tb_atomic_t                 errors;
+
+}tb_demo_context_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the allocated and freed data count
+static tb_atomic_t              g_allocated = 0;
+static tb_atomic_t              g_freed = 0;
+
+// the spinlock and the shared data for the spinlock mode
+static tb_spinlock_t            g_lock = TB_SPINLOCK_INIT;
+static tb_demo_data_t*          g_data = tb_null;
+
+// the shared data for the rcu mode
+static tb_rcu_pointer_t         g_rcu = TB_RCU_POINTER_INIT;
+
+// the shared data for the hazard pointer mode
+static tb_atomic_t              g_hazard = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_demo_data_t* tb_demo_data_init(tb_size_t sequence)
+{
+    tb_demo_data_t* data = tb_malloc0_type(tb_demo_data_t);
+    if (data)
+    {
+        data->magic    = TB_DEMO_DATA_ALIVE;
+        data->sequence = sequence;
+        data->value    = TB_DEMO_DATA_ALIVE ^ sequence;
+        tb_atomic_fetch_and_add_explicit(&g_allocated, 1, TB_ATOMIC_RELAXED);
+    }
+    return data;
+}
+static tb_void_t tb_demo_data_free(tb_pointer_t priv)
+{
+    // poison it first, the readers will see the freed magic if it's freed too early
+    tb_demo_data_t* data = (tb_demo_data_t*)priv;
+    data->magic = TB_DEMO_DATA_FREED;
+    data->value = 0;
+    tb_atomic_fetch_and_add_explicit(&g_freed, 1, TB_ATOMIC_RELAXED);
+    tb_free(data);
+}
+static __tb_inline__ tb_bool_t tb_demo_data_check(tb_demo_data_t const* data)
+{
+    return data && data->magic == TB_DEMO_DATA_ALIVE && data->value == (TB_DEMO_DATA_ALIVE ^ data->sequence);
+}
+static tb_bool_t tb_demo_read(tb_size_t mode)
+{
+    tb_bool_t ok = tb_false;
+    switch (mode)
+    {
+    case TB_DEMO_MODE_SPINLOCK:
+        {
+            tb_spinlock_enter(&g_lock);
+            ok = tb_demo_data_check(g_data);
+            tb_spinlock_leave(&g_lock);
+        }
+        break;
+    case TB_DEMO_MODE_RCU:
+        if (tb_rcu_read_enter())
+        {
+            ok = tb_demo_data_check((tb_demo_data_t const*)tb_rcu_pointer_get(&g_rcu));
+            tb_rcu_read_leave();
+        }
+        break;
+    case TB_DEMO_MODE_HAZARD:
+        {
+            ok = tb_demo_data_check((tb_demo_data_t const*)tb_hazard_pointer_protect(0, &g_hazard));
+            tb_hazard_pointer_clear(0);
+        }
+        break;
+    default:
+        break;
+    }
+    return ok;
+}
+static tb_void_t tb_demo_update(tb_size_t mode, tb_size_t sequence)
+{
+    tb_demo_data_t* data = tb_demo_data_init(sequence);
+    tb_assert_and_check_return(data);
+    switch (mode)
+    {
+    case TB_DEMO_MODE_SPINLOCK:
+        {
+            tb_spinlock_enter(&g_lock);
+            tb_demo_data_t* old = g_data;
+            g_data = data;
+            tb_spinlock_leave(&g_lock);
+            if (old) tb_demo_data_free(old);
+        }
+        break;
+    case TB_DEMO_MODE_RCU:
+        tb_rcu_pointer_set(&g_rcu, data);
+        break;
+    case TB_DEMO_MODE_HAZARD:
+        {
+            tb_demo_data_t* old = (tb_demo_data_t*)tb_atomic_fetch_and_set(&g_hazard, (tb_long_t)data);
+            if (old) tb_hazard_pointer_retire(old, tb_demo_data_free);
+        }
+        break;
+    default:
+        break;
+    }
+}
+static tb_int_t tb_demo_reader(tb_cpointer_t priv)
+{
+    // read it
+    tb_demo_context_t*  context = (tb_demo_context_t*)priv;
+    tb_size_t           errors = 0;
+    tb_size_t           i = 0;
+    for (i = 0; i < context->reads; i++)
+    {
+        if (!tb_demo_read(context->mode)) errors++;
+    }
+
+    // save results
+    tb_atomic_fetch_and_add(&context->total, (tb_long_t)context->reads);
+    tb_atomic_fetch_and_add(&context->errors, (tb_long_t)errors);
+    tb_atomic_fetch_and_sub(&context->readers, 1);
+    return 0;
+}
+static tb_int_t tb_demo_writer(tb_cpointer_t priv)
+{
+    // update it, we update it slowly if it's running until all readers have finished
+    tb_demo_context_t*  context = (tb_demo_context_t*)priv;
+    tb_size_t           sequence = tb_thread_self();
+    if (context->updates)
+    {
+        tb_size_t i = 0;
+        for (i = 0; i < context->updates; i++)
+            tb_demo_update(context->mode, sequence + i);
+    }
+    else
+    {
+        while (tb_atomic_get(&context->readers))
+        {
+            tb_demo_update(context->mode, sequence++);
+            tb_usleep(100);
+        }
+    }
+    return 0;
+}
+static tb_void_t tb_demo_init(tb_size_t mode)
+{
+    switch (mode)
+    {
+    case TB_DEMO_MODE_SPINLOCK:
+        g_data = tb_demo_data_init(0);
+        break;
+    case TB_DEMO_MODE_RCU:
+        tb_rcu_pointer_init(&g_rcu, tb_demo_data_init(0), tb_demo_data_free);
+        break;
+    case TB_DEMO_MODE_HAZARD:
+        tb_atomic_set(&g_hazard, (tb_long_t)tb_demo_data_init(0));
+        break;
+    default:
+        break;
+    }
+}
+static tb_void_t tb_demo_exit(tb_size_t mode)
+{
+    switch (mode)
+    {
+    case TB_DEMO_MODE_SPINLOCK:
+        if (g_data) tb_demo_data_free(g_data);
+        g_data = tb_null;
+        break;
+    case TB_DEMO_MODE_RCU:
+        tb_rcu_pointer_exit(&g_rcu);
+        tb_ebr_reclaim(tb_true);
+        break;
+    case TB_DEMO_MODE_HAZARD:
+        {
+            tb_demo_data_t* data = (tb_demo_data_t*)tb_atomic_fetch_and_set(&g_hazard, 0);
+            if (data) tb_demo_data_free(data);
+            tb_hazard_pointer_scan();
+        }
+        break;
+    default:
+        break;
+    }
+}
+static tb_hong_t tb_demo_run(tb_demo_context_t* context, tb_size_t readers, tb_size_t writers)
+{
+    // init data
+    tb_demo_init(context->mode);
+    tb_atomic_set(&context->readers, (tb_long_t)readers);
+    tb_atomic_set(&context->total, 0);
+    tb_atomic_set(&context->errors, 0);
+
+    // run all readers and writers
+    tb_size_t       i = 0;
+    tb_size_t       n = 0;
+    tb_thread_ref_t threads[TB_DEMO_THREAD_MAXN + 4] = {0};
+    tb_hong_t       time = tb_mclock();
+    for (i = 0; i < writers; i++)
+    {
+        if ((threads[n] = tb_thread_init(tb_null, tb_demo_writer, context, 0))) n++;
+    }
+    for (i = 0; i < readers; i++)
+    {
+        if ((threads[n] = tb_thread_init(tb_null, tb_demo_reader, context, 0))) n++;
+        else tb_atomic_fetch_and_sub(&context->readers, 1);
+    }
+    for (i = 0; i < n; i++)
+    {
+        tb_thread_wait(threads[i], -1, tb_null);
+        tb_thread_exit(threads[i]);
+    }
+    time = tb_mclock() - time;
+
+    // exit data
+    tb_demo_exit(context->mode);
+    return time;
+}
+static tb_void_t tb_demo_stress(tb_size_t mode, tb_char_t const* name)
+{
+    // run 8 readers and 2 writers
+    tb_demo_context_t context = {0};
+    tb_atomic_set(&g_allocated, 0);
+    tb_atomic_set(&g_freed, 0);
+    context.mode    = mode;
+    context.reads   = TB_DEMO_BENCH_READS;
+    context.updates = TB_DEMO_STRESS_UPDATES;
+    tb_hong_t time = tb_demo_run(&context, 8, 2);
+
+    /* trace
+     *
+     * some retired data may be still pending in the records of the exited threads,
+     * they will be freed by the next threads or tb_exit()
+     */
+    tb_size_t allocated = (tb_size_t)tb_atomic_get(&g_allocated);
+    tb_size_t freed = (tb_size_t)tb_atomic_get(&g_freed);
+    tb_trace_i("stress: %-8s: reads: %ld, errors: %ld, allocated: %lu, freed: %lu, pending: %lu, %lld ms", name
+               , tb_atomic_get(&context.total), tb_atomic_get(&context.errors), allocated, freed, allocated - freed, time);
+}
+static tb_void_t tb_demo_bench(tb_size_t mode, tb_char_t const* name)
+{
+    // run 1 writer and 1 ~ 64 readers
+    tb_size_t readers = 1;
+    for (readers = 1; readers <= TB_DEMO_THREAD_MAXN; readers <<= 1)
+    {
+        tb_demo_context_t context = {0};
+        context.mode  = mode;
+        context.reads = TB_DEMO_BENCH_READS / 4;
+        tb_hong_t time = tb_demo_run(&context, readers, 1);
+        tb_trace_i("bench: %-8s: readers: %2lu, %6lld Kreads/s, errors: %ld", name, readers
+                   , (tb_hong_t)tb_atomic_get(&context.total) / (time? time : 1), tb_atomic_get(&context.errors));
+    }
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_platform_reclaim_main(tb_int_t argc, tb_char_t** argv)
+{
+    // the modes
+    static tb_char_t const* s_names[] = {"spinlock", "rcu", "hazard"};
+
+    // stress test
+    tb_size_t mode = 0;
+    if (!argv[1] || !tb_strcmp(argv[1], "stress"))
+    {
+        for (mode = TB_DEMO_MODE_RCU; mode < tb_arrayn(s_names); mode++)
+            tb_demo_stress(mode, s_names[mode]);
+    }
+
+    // read scaling bench
+    if (!argv[1] || !tb_strcmp(argv[1], "bench"))
+    {
+        for (mode = 0; mode < tb_arrayn(s_names); mode++)
+            tb_demo_bench(mode, s_names[mode]);
+    }
+    return 0;
+}
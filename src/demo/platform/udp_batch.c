@@ -0,0 +1,214 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the datagram size
+#define TB_DEMO_DGRAM_SIZE      (64)
+
+// the batched datagram count
+#define TB_DEMO_BATCH_MAXN      (32)
+
+// the gso segment count of each message
+#define TB_DEMO_GSO_MAXN        (32)
+
+// the sent datagram count of each test
+#define TB_DEMO_DGRAM_COUNT     (1000000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the test mode
+typedef enum __tb_demo_mode_e
+{
+    TB_DEMO_MODE_SINGLE     = 0
+,   TB_DEMO_MODE_BATCH      = 1
+,   TB_DEMO_MODE_GSO        = 2
+
+}tb_demo_mode_e;
+
+// the receiver type
+typedef struct __tb_demo_receiver_t
+{
+    // the socket
+    tb_socket_ref_t         sock;
+
+    // the mode
+    tb_size_t               mode;
+
+    // the received datagram count
+    tb_hize_t               count;
+
+    // the truncated datagram count
+    tb_hize_t               truncated;
+
+    // the time of the first and last datagram
+    tb_hong_t               time[2];
+
+}tb_demo_receiver_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_int_t tb_demo_receiver_loop(tb_cpointer_t priv)
+{
+    // check
+    tb_demo_receiver_t* receiver = (tb_demo_receiver_t*)priv;
+    tb_assert_and_check_return_val(receiver, -1);
+
+    // init messages, the gro data may be coalesced from the multiple datagrams
+    tb_size_t           i;
+    tb_size_t           size = receiver->mode == TB_DEMO_MODE_GSO? TB_DEMO_DGRAM_SIZE * TB_DEMO_GSO_MAXN : TB_DEMO_DGRAM_SIZE;
+    tb_socket_umsg_t    list[TB_DEMO_BATCH_MAXN];
+    tb_byte_t*          data = tb_malloc_bytes(size * TB_DEMO_BATCH_MAXN);
+    tb_assert_and_check_return_val(data, -1);
+    for (i = 0; i < TB_DEMO_BATCH_MAXN; i++)
+    {
+        list[i].data    = data + i * size;
+        list[i].size    = size;
+        list[i].segment = 0;
+    }
+
+    // recv datagrams until it is idle
+    while (1)
+    {
+        // recv them
+        tb_long_t real = 0;
+        if (receiver->mode == TB_DEMO_MODE_SINGLE)
+        {
+            real = tb_socket_urecv(receiver->sock, &list[0].addr, list[0].data, list[0].size);
+            if (real > 0)
+            {
+                list[0].real = real;
+                list[0].truncated = tb_false;
+                list[0].segment = 0;
+                real = 1;
+            }
+        }
+        else real = tb_socket_urecvm(receiver->sock, list, TB_DEMO_BATCH_MAXN);
+        tb_check_break(real >= 0);
+
+        // no data? wait it
+        if (!real)
+        {
+            if (tb_socket_wait(receiver->sock, TB_SOCKET_EVENT_RECV, 500) <= 0) break;
+            continue;
+        }
+
+        // count the datagrams
+        if (!receiver->count) receiver->time[0] = tb_mclock();
+        for (i = 0; i < (tb_size_t)real; i++)
+        {
+            receiver->count += list[i].segment? (list[i].real + list[i].segment - 1) / list[i].segment : 1;
+            if (list[i].truncated) receiver->truncated++;
+        }
+        receiver->time[1] = tb_mclock();
+    }
+
+    // exit data
+    tb_free(data);
+    return 0;
+}
+static tb_void_t tb_demo_udp_batch_test(tb_size_t mode)
+{
+    // the mode names
+    static tb_char_t const* s_names[] = {"usend/urecv", "usendm/urecvm", "usendm/urecvm (gso/gro)"};
+
+    // done
+    tb_demo_receiver_t  receiver = {0};
+    tb_socket_ref_t     sock = tb_null;
+    tb_thread_ref_t     thread = tb_null;
+    tb_byte_t*          data = tb_null;
+    do
+    {
+        // init the receiver socket
+        tb_ipaddr_t addr;
+        tb_ipaddr_set(&addr, "127.0.0.1", 0, TB_IPADDR_FAMILY_IPV4);
+        receiver.mode = mode;
+        receiver.sock = tb_socket_init(TB_SOCKET_TYPE_UDP, TB_IPADDR_FAMILY_IPV4);
+        tb_assert_and_check_break(receiver.sock);
+        if (!tb_socket_bind(receiver.sock, &addr)) break;
+        if (!tb_socket_local(receiver.sock, &addr)) break;
+        tb_socket_ctrl(receiver.sock, TB_SOCKET_CTRL_SET_RECV_BUFF_SIZE, 8 << 20);
+        if (mode == TB_DEMO_MODE_GSO) tb_socket_ctrl(receiver.sock, TB_SOCKET_CTRL_SET_UDP_GRO, tb_true);
+
+        // init the sender socket
+        sock = tb_socket_init(TB_SOCKET_TYPE_UDP, TB_IPADDR_FAMILY_IPV4);
+        tb_assert_and_check_break(sock);
+
+        // start the receiver
+        thread = tb_thread_init(tb_null, tb_demo_receiver_loop, &receiver, 0);
+        tb_assert_and_check_break(thread);
+
+        // init messages
+        tb_size_t           i;
+        tb_size_t           size = mode == TB_DEMO_MODE_GSO? TB_DEMO_DGRAM_SIZE * TB_DEMO_GSO_MAXN : TB_DEMO_DGRAM_SIZE;
+        tb_socket_umsg_t    list[TB_DEMO_BATCH_MAXN];
+        data = tb_malloc0_bytes(size);
+        tb_assert_and_check_break(data);
+        for (i = 0; i < TB_DEMO_BATCH_MAXN; i++)
+        {
+            tb_ipaddr_copy(&list[i].addr, &addr);
+            list[i].data    = data;
+            list[i].size    = size;
+            list[i].segment = mode == TB_DEMO_MODE_GSO? TB_DEMO_DGRAM_SIZE : 0;
+        }
+
+        // send datagrams
+        tb_hize_t sent = 0;
+        tb_hong_t time = tb_mclock();
+        while (sent < TB_DEMO_DGRAM_COUNT)
+        {
+            // send them
+            tb_long_t real = 0;
+            if (mode == TB_DEMO_MODE_SINGLE) real = tb_socket_usend(sock, &addr, data, size) > 0? 1 : 0;
+            else real = tb_socket_usendm(sock, list, TB_DEMO_BATCH_MAXN);
+            tb_check_break(real >= 0);
+
+            // no space? wait it
+            if (!real)
+            {
+                if (tb_socket_wait(sock, TB_SOCKET_EVENT_SEND, -1) <= 0) break;
+                continue;
+            }
+            sent += mode == TB_DEMO_MODE_GSO? real * TB_DEMO_GSO_MAXN : real;
+        }
+        time = tb_mclock() - time;
+
+        // wait the receiver
+        tb_thread_wait(thread, -1, tb_null);
+
+        // trace
+        tb_hong_t rtime = receiver.time[1] - receiver.time[0];
+        tb_trace_i("%s: sent %llu in %lld ms, %lld pps, received %llu in %lld ms, %lld pps, truncated %llu", s_names[mode]
+                   , sent, time, time > 0? (tb_hong_t)(sent * 1000 / time) : 0
+                   , receiver.count, rtime, rtime > 0? (tb_hong_t)(receiver.count * 1000 / rtime) : 0, receiver.truncated);
+
+    } while (0);
+
+    // exit thread
+    if (thread) tb_thread_exit(thread);
+
+    // exit data
+    if (data) tb_free(data);
+
+    // exit sockets
+    if (sock) tb_socket_exit(sock);
+    if (receiver.sock) tb_socket_exit(receiver.sock);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_platform_udp_batch_main(tb_int_t argc, tb_char_t** argv)
+{
+    tb_demo_udp_batch_test(TB_DEMO_MODE_SINGLE);
+    tb_demo_udp_batch_test(TB_DEMO_MODE_BATCH);
+    tb_demo_udp_batch_test(TB_DEMO_MODE_GSO);
+    return 0;
+}
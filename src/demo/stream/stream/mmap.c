@@ -0,0 +1,150 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the default test file size
+#define TB_DEMO_FILE_SIZE       (64 << 20)
+
+// the block size
+#define TB_DEMO_BLOCK_SIZE      (4096)
+
+// the random read count
+#define TB_DEMO_RANDOM_COUNT    (100000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_bool_t tb_demo_file_make(tb_char_t const* path, tb_size_t size)
+{
+    tb_file_ref_t file = tb_file_init(path, TB_FILE_MODE_RW | TB_FILE_MODE_CREAT | TB_FILE_MODE_TRUNC);
+    tb_check_return_val(file, tb_false);
+
+    tb_size_t i;
+    tb_size_t writ = 0;
+    tb_byte_t data[TB_DEMO_BLOCK_SIZE];
+    for (i = 0; i < sizeof(data); i++) data[i] = (tb_byte_t)i;
+    while (writ < size)
+    {
+        tb_long_t real = tb_file_writ(file, data, tb_min(sizeof(data), size - writ));
+        tb_check_break(real > 0);
+        writ += real;
+    }
+    tb_file_exit(file);
+    return writ == size;
+}
+static tb_hize_t tb_demo_checksum(tb_byte_t const* data, tb_size_t size)
+{
+    tb_size_t i;
+    tb_hize_t sum = 0;
+    for (i = 0; i < size; i += 64) sum += data[i];
+    return sum;
+}
+static tb_void_t tb_demo_stream_read_seq(tb_char_t const* path, tb_bool_t bmmap)
+{
+    tb_stream_ref_t stream = tb_stream_init_from_file(path, TB_FILE_MODE_RO);
+    if (stream)
+    {
+        tb_stream_ctrl(stream, TB_STREAM_CTRL_FILE_SET_MMAP, bmmap);
+        if (tb_stream_open(stream))
+        {
+            tb_bool_t mapped = tb_false;
+            tb_stream_ctrl(stream, TB_STREAM_CTRL_FILE_GET_MMAP, &mapped);
+
+            // read all data
+            tb_hize_t  sum = 0;
+            tb_hize_t  read = 0;
+            tb_byte_t* data = tb_null;
+            tb_hong_t  time = tb_mclock();
+            while (1)
+            {
+                tb_long_t real = tb_stream_peek(stream, &data, TB_DEMO_BLOCK_SIZE);
+                if (real > 0)
+                {
+                    sum += tb_demo_checksum(data, real);
+                    read += real;
+                    if (!tb_stream_skip(stream, real)) break;
+                }
+                else if (!real)
+                {
+                    real = tb_stream_wait(stream, TB_STREAM_WAIT_READ, -1);
+                    tb_check_break(real > 0);
+                }
+                else break;
+            }
+            time = tb_mclock() - time;
+
+            // trace
+            tb_trace_i("stream(%s): sequential peek: %llu bytes in %lld ms, %lld MB/s, checksum: %llu"
+                       , mapped? "mmap" : "read", read, time, time? ((tb_hong_t)read / 1000 / time) : 0, sum);
+        }
+        tb_stream_exit(stream);
+    }
+}
+static tb_void_t tb_demo_stream_read_rand(tb_char_t const* path, tb_bool_t bmmap)
+{
+    tb_stream_ref_t stream = tb_stream_init_from_file(path, TB_FILE_MODE_RO);
+    if (stream)
+    {
+        tb_stream_ctrl(stream, TB_STREAM_CTRL_FILE_SET_MMAP, bmmap);
+        if (tb_stream_open(stream))
+        {
+            tb_bool_t mapped = tb_false;
+            tb_stream_ctrl(stream, TB_STREAM_CTRL_FILE_GET_MMAP, &mapped);
+
+            // read the random blocks
+            tb_size_t  i;
+            tb_hize_t  sum = 0;
+            tb_byte_t* data = tb_null;
+            tb_long_t  maxn = (tb_long_t)(tb_stream_size(stream) / TB_DEMO_BLOCK_SIZE);
+            tb_hong_t  time = tb_mclock();
+            tb_random_seed(0);
+            for (i = 0; i < TB_DEMO_RANDOM_COUNT; i++)
+            {
+                tb_hize_t offset = (tb_hize_t)tb_random_range(0, maxn) * TB_DEMO_BLOCK_SIZE;
+                if (!tb_stream_seek(stream, offset)) break;
+                if (!tb_stream_need(stream, &data, TB_DEMO_BLOCK_SIZE)) break;
+                sum += tb_demo_checksum(data, TB_DEMO_BLOCK_SIZE);
+            }
+            time = tb_mclock() - time;
+
+            // trace
+            tb_trace_i("stream(%s): random need: %lu blocks in %lld ms, %lld blocks per second, checksum: %llu"
+                       , mapped? "mmap" : "read", i, time, time? ((tb_hong_t)i * 1000 / time) : 0, sum);
+        }
+        tb_stream_exit(stream);
+    }
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_stream_mmap_main(tb_int_t argc, tb_char_t** argv)
+{
+    // the test file, we make a temporary file if no given file
+    tb_char_t        temp[TB_PATH_MAXN];
+    tb_char_t const* path = argv[1];
+    if (!path)
+    {
+        if (!tb_directory_temporary(temp, sizeof(temp))) return -1;
+        tb_strcat(temp, "/tbox_demo_stream_mmap.dat");
+        if (!tb_demo_file_make(temp, TB_DEMO_FILE_SIZE)) return -1;
+        path = temp;
+    }
+
+    // sequential read
+    tb_demo_stream_read_seq(path, tb_false);
+    tb_demo_stream_read_seq(path, tb_true);
+
+    // random read
+    tb_demo_stream_read_rand(path, tb_false);
+    tb_demo_stream_read_rand(path, tb_true);
+
+    // remove the temporary file
+    if (path == temp) tb_file_remove(temp);
+    return 0;
+}
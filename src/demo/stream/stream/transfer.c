@@ -0,0 +1,269 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the port of the local http server
+#define TB_DEMO_PORT            (9092)
+
+// the document size
+#define TB_DEMO_SIZE            (32 << 20)
+
+// the rate limit of each server connection, it simulates the bandwidth of a remote link
+#define TB_DEMO_CONN_RATE       (16 << 20)
+
+// the send block size
+#define TB_DEMO_BLOCK           (1 << 16)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the document data
+static tb_byte_t*       g_document = tb_null;
+
+// stop the server?
+static tb_atomic32_t    g_stop = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_bool_t tb_demo_server_send(tb_socket_ref_t sock, tb_byte_t const* data, tb_size_t size)
+{
+    tb_size_t send = 0;
+    while (send < size)
+    {
+        tb_long_t real = tb_socket_send(sock, data + send, size - send);
+        if (real > 0) send += real;
+        else if (!real)
+        {
+            if (tb_socket_wait(sock, TB_SOCKET_EVENT_SEND, -1) <= 0) break;
+        }
+        else break;
+    }
+    return send == size;
+}
+static tb_void_t tb_demo_server_session(tb_cpointer_t priv)
+{
+    // check
+    tb_socket_ref_t sock = (tb_socket_ref_t)priv;
+    tb_assert_and_check_return(sock);
+
+    // recv the request header
+    tb_char_t head[4096];
+    tb_size_t size = 0;
+    while (size < sizeof(head) - 1)
+    {
+        tb_long_t real = tb_socket_recv(sock, (tb_byte_t*)head + size, sizeof(head) - 1 - size);
+        if (real > 0)
+        {
+            size += real;
+            head[size] = '\0';
+            if (tb_strstr(head, "\r\n\r\n")) break;
+        }
+        else if (!real)
+        {
+            if (tb_socket_wait(sock, TB_SOCKET_EVENT_RECV, -1) <= 0) break;
+        }
+        else break;
+    }
+    head[size] = '\0';
+
+    // parse range, e.g. "Range: bytes=100-200"
+    tb_hize_t        bof = 0;
+    tb_hize_t        eof = TB_DEMO_SIZE - 1;
+    tb_bool_t        range = tb_false;
+    tb_char_t const* p = tb_strstr(head, "Range: bytes=");
+    if (p)
+    {
+        p += 13;
+        bof = tb_stou64(p);
+        while (*p && *p != '-') p++;
+        if (*p == '-' && tb_isdigit(p[1])) eof = tb_stou64(p + 1);
+        if (eof >= TB_DEMO_SIZE) eof = TB_DEMO_SIZE - 1;
+        range = tb_true;
+    }
+
+    // send the response header
+    tb_char_t resp[512];
+    tb_long_t resp_size = 0;
+    if (range)
+    {
+        resp_size = tb_snprintf(resp, sizeof(resp), "HTTP/1.1 206 Partial Content\r\n"
+                                                    "Accept-Ranges: bytes\r\n"
+                                                    "Content-Range: bytes %llu-%llu/%llu\r\n"
+                                                    "Content-Length: %llu\r\n"
+                                                    "Connection: close\r\n\r\n"
+                                                    , bof, eof, (tb_hize_t)TB_DEMO_SIZE, eof - bof + 1);
+    }
+    else
+    {
+        resp_size = tb_snprintf(resp, sizeof(resp), "HTTP/1.1 200 OK\r\n"
+                                                    "Accept-Ranges: bytes\r\n"
+                                                    "Content-Length: %llu\r\n"
+                                                    "Connection: close\r\n\r\n"
+                                                    , (tb_hize_t)TB_DEMO_SIZE);
+    }
+
+    // send the response data with the limited rate
+    if (resp_size > 0 && tb_demo_server_send(sock, (tb_byte_t const*)resp, resp_size))
+    {
+        tb_hize_t send = 0;
+        tb_hize_t left = eof - bof + 1;
+        tb_hong_t base = tb_mclock();
+        while (send < left)
+        {
+            tb_size_t need = (tb_size_t)tb_min(left - send, TB_DEMO_BLOCK);
+            if (!tb_demo_server_send(sock, g_document + bof + send, need)) break;
+            send += need;
+
+            tb_hong_t wait = (tb_hong_t)((send * 1000) / TB_DEMO_CONN_RATE) - (tb_mclock() - base);
+            if (wait > 0) tb_msleep((tb_size_t)wait);
+        }
+    }
+
+    // exit socket
+    tb_socket_exit(sock);
+}
+static tb_void_t tb_demo_server_listen(tb_cpointer_t priv)
+{
+    // init socket
+    tb_socket_ref_t sock = tb_socket_init(TB_SOCKET_TYPE_TCP, TB_IPADDR_FAMILY_IPV4);
+    if (sock)
+    {
+        // bind and listen socket
+        tb_ipaddr_t addr;
+        tb_ipaddr_set(&addr, "127.0.0.1", TB_DEMO_PORT, TB_IPADDR_FAMILY_IPV4);
+        if (tb_socket_bind(sock, &addr) && tb_socket_listen(sock, 100))
+        {
+            // accept client sockets until stopped
+            tb_socket_ref_t client = tb_null;
+            while (!tb_atomic32_get(&g_stop))
+            {
+                if ((client = tb_socket_accept(sock, tb_null)))
+                {
+                    if (!tb_coroutine_start(tb_null, tb_demo_server_session, client, 0)) break;
+                }
+                else if (tb_socket_wait(sock, TB_SOCKET_EVENT_ACPT, 100) < 0) break;
+            }
+        }
+        tb_socket_exit(sock);
+    }
+}
+static tb_int_t tb_demo_server_thread(tb_cpointer_t priv)
+{
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    if (scheduler)
+    {
+        tb_coroutine_start(scheduler, tb_demo_server_listen, tb_null, 0);
+        tb_co_scheduler_loop(scheduler, tb_true);
+        tb_co_scheduler_exit(scheduler);
+    }
+    return 0;
+}
+static tb_bool_t tb_demo_transfer_func(tb_size_t state, tb_hize_t offset, tb_hong_t size, tb_hize_t save, tb_size_t rate, tb_cpointer_t priv)
+{
+    tb_trace_i("%s: save: %llu bytes, rate: %lu bytes/s", (tb_char_t const*)priv, save, rate);
+    return tb_true;
+}
+static tb_bool_t tb_demo_file_check(tb_char_t const* path, tb_size_t size)
+{
+    tb_bool_t     ok = tb_false;
+    tb_file_ref_t file = tb_file_init(path, TB_FILE_MODE_RO);
+    if (file)
+    {
+        tb_byte_t* data = tb_file_size(file) == size? tb_file_mmap(file, 0, size, TB_FILE_MMAP_READ) : tb_null;
+        if (data)
+        {
+            ok = !tb_memcmp_(data, g_document, size);
+            tb_file_munmap(data, size);
+        }
+        tb_file_exit(file);
+    }
+    return ok;
+}
+static tb_void_t tb_demo_transfer(tb_char_t const* name, tb_char_t const* iurl, tb_char_t const* ourl, tb_size_t count, tb_size_t lrate)
+{
+    tb_hong_t time = tb_mclock();
+    tb_hong_t save = count? tb_transfer_url_parallel(iurl, ourl, count, lrate, tb_demo_transfer_func, name) : tb_transfer_url(iurl, ourl, lrate, tb_demo_transfer_func, name);
+    time = tb_mclock() - time;
+    tb_trace_i("%s: %lld bytes in %lld ms, %lld KB/s, %s", name, save, time, time? (save / time) : 0, tb_demo_file_check(ourl, TB_DEMO_SIZE)? "ok" : "failed");
+}
+static tb_void_t tb_demo_transfer_stream(tb_char_t const* name, tb_char_t const* ipath, tb_char_t const* opath)
+{
+    tb_stream_ref_t istream = tb_stream_init_from_file(ipath, TB_FILE_MODE_RO);
+    tb_stream_ref_t ostream = tb_stream_init_from_file(opath, TB_FILE_MODE_RW | TB_FILE_MODE_CREAT | TB_FILE_MODE_TRUNC);
+    if (istream && ostream)
+    {
+        tb_hong_t time = tb_mclock();
+        tb_hong_t save = tb_transfer(istream, ostream, 0, tb_null, tb_null);
+        time = tb_mclock() - time;
+        tb_stream_clos(ostream);
+        tb_trace_i("%s: %lld bytes in %lld ms, %s", name, save, time, tb_demo_file_check(opath, TB_DEMO_SIZE)? "ok" : "failed");
+    }
+    if (istream) tb_stream_exit(istream);
+    if (ostream) tb_stream_exit(ostream);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_stream_transfer_main(tb_int_t argc, tb_char_t** argv)
+{
+    // init document
+    tb_size_t i;
+    g_document = tb_malloc_bytes(TB_DEMO_SIZE);
+    tb_assert_and_check_return_val(g_document, -1);
+    tb_random_seed(0);
+    for (i = 0; i < TB_DEMO_SIZE; i++) g_document[i] = (tb_byte_t)tb_random_value();
+
+    // start the local http server
+    tb_thread_ref_t server = tb_thread_init(tb_null, tb_demo_server_thread, tb_null, 0);
+    if (server)
+    {
+        // the urls
+        tb_char_t iurl[64];
+        tb_char_t temp[TB_PATH_MAXN];
+        tb_char_t path0[TB_PATH_MAXN];
+        tb_char_t path1[TB_PATH_MAXN];
+        tb_snprintf(iurl, sizeof(iurl), "http://127.0.0.1:%d/document", TB_DEMO_PORT);
+        if (tb_directory_temporary(temp, sizeof(temp)))
+        {
+            tb_snprintf(path0, sizeof(path0), "%s/tbox_demo_transfer0.dat", temp);
+            tb_snprintf(path1, sizeof(path1), "%s/tbox_demo_transfer1.dat", temp);
+
+            // wait the server
+            tb_msleep(100);
+
+            // transfer http to file
+            tb_demo_transfer("serial", iurl, path0, 0, 0);
+            tb_demo_transfer("parallel(2)", iurl, path0, 2, 0);
+            tb_demo_transfer("parallel(4)", iurl, path0, 4, 0);
+            tb_demo_transfer("parallel(8)", iurl, path0, 8, 0);
+
+            // transfer it with the limited rate of all connections
+            tb_demo_transfer("parallel(4, 8MB/s)", iurl, path0, 4, 8 << 20);
+
+            // transfer file to file in the kernel
+            tb_demo_transfer_stream("file -> file", path0, path1);
+
+            // remove files
+            tb_file_remove(path0);
+            tb_file_remove(path1);
+        }
+
+        // stop server
+        tb_atomic32_set(&g_stop, 1);
+        tb_thread_wait(server, -1, tb_null);
+        tb_thread_exit(server);
+    }
+
+    // exit document
+    tb_free(g_document);
+    g_document = tb_null;
+    return 0;
+}
@@ -0,0 +1,224 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the default test data size
+#define TB_DEMO_DATA_SIZE       (16 * 1024 * 1024)
+
+// the input chunk size, like reading from the stream
+#define TB_DEMO_CHUNK_SIZE      (64 * 1024)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the bench item type
+typedef struct __tb_demo_zip_item_t
+{
+    // the name
+    tb_char_t const*        name;
+
+    // the deflate algo
+    tb_size_t               algo;
+
+    // the inflate algo, @note the zlib algo only inflates the raw data, so we use zlibraw to inflate the zlib data
+    tb_size_t               algo_inflate;
+
+    // the level
+    tb_uint8_t              level;
+
+    // the parallel threads
+    tb_uint16_t             parallel;
+
+}tb_demo_zip_item_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+#ifdef TB_CONFIG_MODULE_HAVE_ZIP
+static tb_long_t tb_demo_zip_spak(tb_zip_ref_t zip, tb_byte_t* idata, tb_size_t isize, tb_byte_t* odata, tb_size_t omaxn)
+{
+    // spak all data chunk by chunk, end it at the last chunk
+    tb_size_t ipos = 0;
+    tb_size_t opos = 0;
+    while (opos < omaxn)
+    {
+        // init the input and output stream
+        tb_size_t           size = tb_min(isize - ipos, TB_DEMO_CHUNK_SIZE);
+        tb_long_t           sync = ipos + size == isize? -1 : 0;
+        tb_static_stream_t  ist;
+        tb_static_stream_t  ost;
+        tb_static_stream_init(&ist, idata + ipos, size);
+        tb_static_stream_init(&ost, odata + opos, omaxn - opos);
+
+        // spak it
+        tb_long_t r = tb_zip_spak(zip, &ist, &ost, sync);
+        ipos += tb_static_stream_offset(&ist);
+        opos += tb_static_stream_offset(&ost);
+
+        // end?
+        if (r < 0 || (!r && ipos == isize)) break;
+    }
+    return ipos == isize? (tb_long_t)opos : -1;
+}
+static tb_void_t tb_demo_zip_check(tb_char_t const* tool, tb_char_t const* suffix, tb_byte_t const* data, tb_size_t size)
+{
+    // save data to the temporary file
+    tb_char_t temp[TB_PATH_MAXN] = {0};
+    tb_char_t path[TB_PATH_MAXN] = {0};
+    tb_directory_temporary(temp, sizeof(temp));
+    tb_snprintf(path, sizeof(path), "%s/tbox_zip_bench%s", temp, suffix);
+    tb_file_ref_t file = tb_file_init(path, TB_FILE_MODE_RW | TB_FILE_MODE_CREAT | TB_FILE_MODE_TRUNC);
+    if (file)
+    {
+        tb_file_writ(file, data, size);
+        tb_file_exit(file);
+    }
+
+    // test it with the external tool, e.g. gzip -t, lz4 -t
+    tb_char_t const* argv[] = {tool, "-t", path, tb_null};
+    tb_long_t status = tb_process_run(tool, argv, tb_null);
+    tb_trace_i("%s -t %s: %s", tool, path, status == 0? "ok" : (status < 0? "not found" : "failed"));
+    tb_file_remove(path);
+}
+static tb_void_t tb_demo_zip_bench(tb_demo_zip_item_t const* item, tb_byte_t* idata, tb_size_t isize, tb_byte_t* zdata, tb_size_t zmaxn, tb_byte_t* odata)
+{
+    // init option
+    tb_zip_option_t option = {0};
+    option.level    = item->level;
+    option.parallel = item->parallel;
+
+    // deflate it
+    tb_long_t   zsize = -1;
+    tb_hong_t   time = tb_mclock();
+    tb_zip_ref_t zip = tb_zip_init_with_option(item->algo, TB_ZIP_ACTION_DEFLATE, &option);
+    if (zip)
+    {
+        zsize = tb_demo_zip_spak(zip, idata, isize, zdata, zmaxn);
+        tb_zip_exit(zip);
+    }
+    time = tb_mclock() - time;
+    if (zsize <= 0)
+    {
+        tb_trace_e("%s: deflate failed", item->name);
+        return ;
+    }
+
+    // inflate it
+    tb_long_t   osize = -1;
+    tb_hong_t   time2 = tb_mclock();
+    zip = tb_zip_init(item->algo_inflate, TB_ZIP_ACTION_INFLATE);
+    if (zip)
+    {
+        osize = tb_demo_zip_spak(zip, zdata, (tb_size_t)zsize, odata, isize + 1);
+        tb_zip_exit(zip);
+    }
+    time2 = tb_mclock() - time2;
+
+    // trace
+    tb_bool_t ok = osize == (tb_long_t)isize && !tb_memcmp(idata, odata, isize);
+    tb_trace_i("%-16s: ratio: %3ld%%, deflate: %5lld MB/s, inflate: %5lld MB/s, %s", item->name
+               , (tb_long_t)(zsize * 100 / isize), (tb_hong_t)isize * 1000 / ((time? time : 1) << 20)
+               , (tb_hong_t)isize * 1000 / ((time2? time2 : 1) << 20), ok? "ok" : "failed");
+
+    // check the output with the external tools
+    if (item->algo == TB_ZIP_ALGO_GZIP && item->parallel > 1)
+        tb_demo_zip_check("gzip", ".gz", zdata, (tb_size_t)zsize);
+    else if (item->algo == TB_ZIP_ALGO_LZ4 && item->level != TB_ZIP_LEVEL_FASTEST)
+        tb_demo_zip_check("lz4", ".lz4", zdata, (tb_size_t)zsize);
+}
+static tb_size_t tb_demo_zip_data_init(tb_byte_t* data, tb_size_t size)
+{
+    // make the text data with the repeated words and numbers, it is like the log file
+    static tb_char_t const* s_words[] =
+    {
+        "the", "quick", "brown", "fox", "jumps", "over", "lazy", "dog", "stream", "filter"
+    ,   "zip", "deflate", "inflate", "block", "thread", "pool", "error", "warning", "info", "debug"
+    };
+    tb_size_t pos = 0;
+    while (pos + 32 < size)
+    {
+        tb_long_t n = tb_snprintf((tb_char_t*)data + pos, size - pos, "%s %s %lu ", s_words[tb_random_range(0, tb_arrayn(s_words))], s_words[tb_random_range(0, tb_arrayn(s_words))], tb_random_range(0, 100000));
+        if (n <= 0) break;
+        pos += n;
+        if (tb_random_range(0, 8) == 0) data[pos++] = '\n';
+    }
+    while (pos < size) data[pos++] = '\n';
+    return size;
+}
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+#ifdef TB_CONFIG_MODULE_HAVE_ZIP
+tb_int_t tb_demo_stream_zip_bench_main(tb_int_t argc, tb_char_t** argv)
+{
+    // the bench items
+    tb_uint16_t threads = (tb_uint16_t)tb_max(tb_cpu_count(), 2);
+    tb_demo_zip_item_t items[] =
+    {
+#ifdef TB_CONFIG_PACKAGE_HAVE_ZLIB
+        {"gzip(1)",         TB_ZIP_ALGO_GZIP,   TB_ZIP_ALGO_GZIP,       TB_ZIP_LEVEL_FASTEST,   0       }
+    ,   {"gzip(6)",         TB_ZIP_ALGO_GZIP,   TB_ZIP_ALGO_GZIP,       TB_ZIP_LEVEL_DEFAULT,   0       }
+    ,   {"gzip(1,parallel)",TB_ZIP_ALGO_GZIP,   TB_ZIP_ALGO_GZIP,       TB_ZIP_LEVEL_FASTEST,   threads }
+    ,   {"gzip(6,parallel)",TB_ZIP_ALGO_GZIP,   TB_ZIP_ALGO_GZIP,       TB_ZIP_LEVEL_DEFAULT,   threads }
+    ,   {"zlib(6,parallel)",TB_ZIP_ALGO_ZLIB,   TB_ZIP_ALGO_ZLIBRAW,    TB_ZIP_LEVEL_DEFAULT,   threads }
+    ,
+#endif
+        {"lz4",             TB_ZIP_ALGO_LZ4,    TB_ZIP_ALGO_LZ4,        TB_ZIP_LEVEL_DEFAULT,   0       }
+    ,   {"lz4(fastest)",    TB_ZIP_ALGO_LZ4,    TB_ZIP_ALGO_LZ4,        TB_ZIP_LEVEL_FASTEST,   0       }
+    };
+
+    // init data
+    tb_size_t isize = TB_DEMO_DATA_SIZE;
+    tb_byte_t* idata = tb_null;
+    if (argc > 1 && argv[1])
+    {
+        tb_file_ref_t file = tb_file_init(argv[1], TB_FILE_MODE_RO);
+        if (file)
+        {
+            isize = (tb_size_t)tb_file_size(file);
+            idata = tb_malloc_bytes(isize + 1);
+            if (idata && !tb_file_read(file, idata, isize))
+            {
+                tb_free(idata);
+                idata = tb_null;
+            }
+            tb_file_exit(file);
+        }
+    }
+    else
+    {
+        idata = tb_malloc_bytes(isize);
+        if (idata) tb_demo_zip_data_init(idata, isize);
+    }
+    tb_size_t   zmaxn = isize + (isize >> 3) + 4096;
+    tb_byte_t*  zdata = tb_malloc_bytes(zmaxn);
+    tb_byte_t*  odata = tb_malloc_bytes(isize + 1);
+    if (idata && isize && zdata && odata)
+    {
+        // run all bench items
+        tb_trace_i("data: %lu bytes, threads: %u", isize, threads);
+        tb_size_t i;
+        for (i = 0; i < tb_arrayn(items); i++)
+            tb_demo_zip_bench(&items[i], idata, isize, zdata, zmaxn, odata);
+    }
+
+    // exit data
+    if (idata) tb_free(idata);
+    if (zdata) tb_free(zdata);
+    if (odata) tb_free(odata);
+    return 0;
+}
+#else
+tb_int_t tb_demo_stream_zip_bench_main(tb_int_t argc, tb_char_t** argv)
+{
+    return 0;
+}
+#endif
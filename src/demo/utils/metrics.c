@@ -0,0 +1,195 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the update count of each thread
+#define TB_DEMO_UPDATE_COUNT        (10000000)
+
+// the maximum thread count
+#define TB_DEMO_THREAD_MAXN         (16)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the update mode
+typedef enum __tb_demo_mode_e
+{
+    TB_DEMO_MODE_ATOMIC         = 0
+,   TB_DEMO_MODE_COUNTER        = 1
+,   TB_DEMO_MODE_HISTOGRAM      = 2
+
+}tb_demo_mode_e;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the shared atomic counter
+static tb_atomic_t              g_atomic = 0;
+
+// the counter and histogram
+static tb_metric_ref_t          g_counter = tb_null;
+static tb_metric_ref_t          g_histogram = tb_null;
+
+// the update mode
+static tb_size_t                g_mode = TB_DEMO_MODE_ATOMIC;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_int_t tb_demo_update_loop(tb_cpointer_t priv)
+{
+    tb_size_t i = 0;
+    switch (g_mode)
+    {
+    case TB_DEMO_MODE_ATOMIC:
+        for (i = 0; i < TB_DEMO_UPDATE_COUNT; i++) tb_atomic_fetch_and_add_explicit(&g_atomic, 1, TB_ATOMIC_RELAXED);
+        break;
+    case TB_DEMO_MODE_COUNTER:
+        for (i = 0; i < TB_DEMO_UPDATE_COUNT; i++) tb_metrics_add(g_counter, 1);
+        break;
+    case TB_DEMO_MODE_HISTOGRAM:
+        for (i = 0; i < TB_DEMO_UPDATE_COUNT; i++) tb_metrics_record(g_histogram, i & 0xfff);
+        break;
+    default:
+        break;
+    }
+    return 0;
+}
+static tb_void_t tb_demo_update_bench(tb_char_t const* name, tb_size_t mode, tb_size_t maxn)
+{
+    // run 1 ~ maxn threads
+    tb_size_t count = 1;
+    for (count = 1; count <= maxn; count <<= 1)
+    {
+        // clear values
+        tb_metrics_clear();
+        tb_atomic_set(&g_atomic, 0);
+        g_mode = mode;
+
+        // run threads
+        tb_size_t       i = 0;
+        tb_size_t       n = 0;
+        tb_thread_ref_t threads[TB_DEMO_THREAD_MAXN] = {0};
+        tb_hong_t       time = tb_mclock();
+        for (i = 0; i < count; i++)
+        {
+            if ((threads[n] = tb_thread_init(tb_null, tb_demo_update_loop, tb_null, 0))) n++;
+        }
+        for (i = 0; i < n; i++)
+        {
+            tb_thread_wait(threads[i], -1, tb_null);
+            tb_thread_exit(threads[i]);
+        }
+        time = tb_mclock() - time;
+
+        // the aggregated value
+        tb_hong_t value = 0;
+        if (mode == TB_DEMO_MODE_ATOMIC) value = tb_atomic_get(&g_atomic);
+        else value = tb_metrics_value(mode == TB_DEMO_MODE_COUNTER? g_counter : g_histogram);
+
+        // trace
+        tb_trace_i("bench: %-9s: threads: %2lu, %4lld ns/op, value: %lld, expected: %lu", name, n
+                   , (time * 1000000) / (tb_hong_t)(n * TB_DEMO_UPDATE_COUNT), value, n * TB_DEMO_UPDATE_COUNT);
+    }
+}
+static tb_void_t tb_demo_task_done(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    tb_usleep((tb_size_t)priv);
+}
+static tb_void_t tb_demo_builtin_thread_pool()
+{
+    // post some tasks with the different time
+    tb_size_t i = 0;
+    for (i = 0; i < 100; i++)
+        tb_thread_pool_task_post(tb_thread_pool(), "metrics", tb_demo_task_done, tb_null, (tb_cpointer_t)(tb_size_t)((i % 10) * 100), tb_false);
+
+    // the queue depth
+    tb_trace_i("thread_pool: queue_depth: %lld", tb_metrics_value(tb_metrics_builtin(TB_METRICS_BUILTIN_THREAD_POOL_QUEUE_DEPTH)));
+
+    // wait them
+    tb_thread_pool_task_wait_all(tb_thread_pool(), -1);
+    tb_trace_i("thread_pool: queue_depth: %lld, p99 latency: %llu us", tb_metrics_value(tb_metrics_builtin(TB_METRICS_BUILTIN_THREAD_POOL_QUEUE_DEPTH))
+               , tb_metrics_percentile(tb_metrics_builtin(TB_METRICS_BUILTIN_THREAD_POOL_TASK_LATENCY), 9900));
+}
+static tb_void_t tb_demo_builtin_stream()
+{
+    // read and write some data
+    tb_byte_t       data[4096] = {0};
+    tb_stream_ref_t istream = tb_stream_init_from_data(data, sizeof(data));
+    tb_stream_ref_t ostream = tb_stream_init_from_data(data, sizeof(data));
+    if (istream && ostream && tb_stream_open(istream) && tb_stream_open(ostream))
+    {
+        tb_byte_t buff[1024];
+        while (tb_stream_bread(istream, buff, sizeof(buff)))
+            tb_stream_bwrit(ostream, buff, sizeof(buff));
+    }
+    if (istream) tb_stream_exit(istream);
+    if (ostream) tb_stream_exit(ostream);
+}
+#ifdef TB_CONFIG_MODULE_HAVE_COROUTINE
+static tb_void_t tb_demo_coroutine_func(tb_cpointer_t priv)
+{
+    tb_size_t i = 0;
+    for (i = 0; i < 1000; i++) tb_coroutine_yield();
+}
+static tb_void_t tb_demo_builtin_coroutine()
+{
+    // switch some coroutines
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    if (scheduler)
+    {
+        tb_size_t i = 0;
+        for (i = 0; i < 10; i++)
+            tb_coroutine_start(scheduler, tb_demo_coroutine_func, tb_null, 0);
+        tb_co_scheduler_loop(scheduler, tb_true);
+        tb_co_scheduler_exit(scheduler);
+    }
+}
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_utils_metrics_main(tb_int_t argc, tb_char_t** argv)
+{
+    // init metrics
+    g_counter   = tb_metrics_counter("demo.counter");
+    g_histogram = tb_metrics_histogram("demo.histogram");
+    tb_assert_and_check_return_val(g_counter && g_histogram, -1);
+
+    // bench the update cost
+    tb_size_t maxn = argv[1]? tb_min(tb_atoi(argv[1]), TB_DEMO_THREAD_MAXN) : 4;
+    tb_demo_update_bench("atomic",      TB_DEMO_MODE_ATOMIC,    maxn);
+    tb_demo_update_bench("counter",     TB_DEMO_MODE_COUNTER,   maxn);
+    tb_demo_update_bench("histogram",   TB_DEMO_MODE_HISTOGRAM, maxn);
+    tb_trace_i("histogram: p50: %llu, p99: %llu, expected: ~2048, ~4055 (the relative error < 1/16)", tb_metrics_percentile(g_histogram, 5000), tb_metrics_percentile(g_histogram, 9900));
+
+    // update the builtin metrics
+    tb_demo_builtin_thread_pool();
+    tb_demo_builtin_stream();
+#ifdef TB_CONFIG_MODULE_HAVE_COROUTINE
+    tb_demo_builtin_coroutine();
+#endif
+
+    // dump them as text
+    tb_metrics_dump();
+
+    // write them as json
+#ifdef TB_CONFIG_MODULE_HAVE_OBJECT
+    tb_char_t path[TB_PATH_MAXN];
+    tb_size_t size = tb_directory_temporary(path, sizeof(path));
+    if (size && size + 32 < sizeof(path))
+    {
+        tb_strcat(path, "/metrics.json");
+        tb_trace_i("%s: %ld bytes", path, tb_metrics_writ_to_url(path, TB_OBJECT_FORMAT_JSON));
+    }
+#endif
+    return 0;
+}
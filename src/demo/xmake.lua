@@ -73,7 +73,7 @@ target("demo")
     if has_config("charset") then add_files("other/charset.c") end
 
     -- add the source files for the database module
-    if has_config("database") then add_files("database/sql.c") end
+    if has_config("database") then add_files("database/*.c") end
 
     -- enable xp compatibility mode
     if is_plat("windows") then
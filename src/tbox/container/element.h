@@ -174,10 +174,20 @@ typedef enum __tb_element_type_t
 ,   TB_ELEMENT_TYPE_MEM            = 8     //!< memory
 ,   TB_ELEMENT_TYPE_OBJ            = 9     //!< object
 ,   TB_ELEMENT_TYPE_TRUE           = 10    //!< true
-,   TB_ELEMENT_TYPE_USER           = 11    //!< the user-defined type
+,   TB_ELEMENT_TYPE_USER           = 11    //!< the user-defined type, e.g. TB_ELEMENT_TYPE_USER + n
+,   TB_ELEMENT_TYPE_ISTR           = 0x8000 //!< interned string, it is reserved above the user-defined types
 
 }tb_element_type_t;
 
+/// the element hash algorithm of the string and memory elements
+typedef enum __tb_element_hash_algo_e
+{
+    TB_ELEMENT_HASH_ALGO_LEGACY    = 0     //!< the legacy hashes: bkdr, fnv32-1a, adler32, ...
+,   TB_ELEMENT_HASH_ALGO_XXHASH3   = 1     //!< xxhash3, the next hashes are the double hashing of the 128-bits halves
+,   TB_ELEMENT_HASH_ALGO_WYHASH    = 2     //!< wyhash, the next hashes are the double hashing of the 32-bits halves
+
+}tb_element_hash_algo_e;
+
 /// the element type
 typedef struct __tb_element_t
 {
@@ -190,6 +200,9 @@ typedef struct __tb_element_t
     /// the element size
     tb_uint16_t                 size;
 
+    /// the hash algorithm of the string and memory elements, it is fixed when creating them
+    tb_uint16_t                 algo;
+
     /// the priv data
     tb_cpointer_t               priv;
 
@@ -287,6 +300,15 @@ tb_element_t        tb_element_uint32(tb_noarg_t);
  */
 tb_element_t        tb_element_str(tb_bool_t is_case);
 
+/*! the interned string element
+ *
+ * the strings must be interned by tb_string_pool_insert(), and we compare them by pointers
+ * and use their precomputed hash, the container does not hold the references of them.
+ *
+ * @return          the element
+ */
+tb_element_t        tb_element_istr(tb_noarg_t);
+
 /*! the pointer element
  *
  * @note if the free function have been hooked, the nfree need hook too.
@@ -314,6 +336,23 @@ tb_element_t        tb_element_obj(tb_noarg_t);
  */
 tb_element_t        tb_element_mem(tb_size_t size, tb_element_free_func_t free, tb_cpointer_t priv);
 
+/*! set the hash algorithm of the new string and memory elements
+ *
+ * the integer elements are not affected, and the default algorithm is wyhash.
+ *
+ * @note the algorithm is saved to the element when creating it by tb_element_str() or tb_element_mem(),
+ * so the existing elements and containers (hash map, hash set, bloom filter, ...) will be not affected.
+ *
+ * @param algo      the hash algorithm
+ */
+tb_void_t           tb_element_hash_algo_set(tb_size_t algo);
+
+/*! get the hash algorithm of the new string and memory elements
+ *
+ * @return          the hash algorithm
+ */
+tb_size_t           tb_element_hash_algo(tb_noarg_t);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
@@ -23,6 +23,14 @@
  */
 #include "hash.h"
 #include "../../hash/hash.h"
+#include "../../platform/atomic.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the hash algorithm of the new string and memory elements
+static tb_atomic_t g_element_hash_algo = TB_ELEMENT_HASH_ALGO_WYHASH;
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * data hash implementation
@@ -103,6 +111,27 @@ static tb_size_t tb_element_hash_data_func_15(tb_byte_t const* data, tb_size_t s
 }
 #endif
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * modern data hash implementation
+ */
+static tb_size_t tb_element_hash_data_modern(tb_size_t algo, tb_byte_t const* data, tb_size_t size, tb_size_t index)
+{
+    // the double hashing: h(i) = h1 + i * h2, the h2 is odd to visit all slots of the power-of-two table
+    if (algo == TB_ELEMENT_HASH_ALGO_XXHASH3)
+    {
+        if (!index) return (tb_size_t)tb_xxhash3_make(data, size, 0);
+
+        tb_uint64_t hash[2];
+        tb_xxhash3_make128(data, size, 0, hash);
+        return (tb_size_t)(hash[0] + (tb_uint64_t)index * (hash[1] | 1));
+    }
+
+    // wyhash
+    tb_uint64_t hash = tb_wyhash_make(data, size, 0);
+    if (!index) return (tb_size_t)hash;
+    return (tb_size_t)((tb_uint32_t)hash + (tb_uint64_t)index * ((hash >> 32) | 1));
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * cstr hash implementation
  */
@@ -176,6 +205,18 @@ static tb_size_t tb_element_hash_uint64_func_0(tb_uint64_t value)
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
+tb_void_t tb_element_hash_algo_set(tb_size_t algo)
+{
+    // check
+    tb_assert_and_check_return(algo <= TB_ELEMENT_HASH_ALGO_WYHASH);
+
+    // set it
+    tb_atomic_set(&g_element_hash_algo, (tb_long_t)algo);
+}
+tb_size_t tb_element_hash_algo()
+{
+    return (tb_size_t)tb_atomic_get(&g_element_hash_algo);
+}
 tb_size_t tb_element_hash_uint8(tb_uint8_t value, tb_size_t mask, tb_size_t index)
 {
     // check
@@ -245,7 +286,7 @@ tb_size_t tb_element_hash_uint32(tb_uint32_t value, tb_size_t mask, tb_size_t in
     }
 
     // done
-    return tb_element_hash_data((tb_byte_t const*)&value, sizeof(tb_uint32_t), mask, index - 3);
+    return tb_element_hash_data(TB_ELEMENT_HASH_ALGO_LEGACY, (tb_byte_t const*)&value, sizeof(tb_uint32_t), mask, index - 3);
 }
 tb_size_t tb_element_hash_uint64(tb_uint64_t value, tb_size_t mask, tb_size_t index)
 {
@@ -268,11 +309,14 @@ tb_size_t tb_element_hash_uint64(tb_uint64_t value, tb_size_t mask, tb_size_t in
     tb_size_t hash1 = tb_element_hash_uint32((tb_uint32_t)(value >> 32), mask, index);
     return ((hash0 ^ hash1) & mask);
 }
-tb_size_t tb_element_hash_data(tb_byte_t const* data, tb_size_t size, tb_size_t mask, tb_size_t index)
+tb_size_t tb_element_hash_data(tb_size_t algo, tb_byte_t const* data, tb_size_t size, tb_size_t mask, tb_size_t index)
 {
     // check
     tb_assert_and_check_return_val(data && size && mask, 0);
 
+    // using the modern hash
+    if (algo != TB_ELEMENT_HASH_ALGO_LEGACY) return tb_element_hash_data_modern(algo, data, size, index) & mask;
+
     // the func
     static tb_size_t (*s_func[])(tb_byte_t const* , tb_size_t) =
     {
@@ -300,11 +344,14 @@ tb_size_t tb_element_hash_data(tb_byte_t const* data, tb_size_t size, tb_size_t
     // done
     return s_func[index](data, size) & mask;
 }
-tb_size_t tb_element_hash_cstr(tb_char_t const* cstr, tb_size_t mask, tb_size_t index)
+tb_size_t tb_element_hash_cstr(tb_size_t algo, tb_char_t const* cstr, tb_size_t mask, tb_size_t index)
 {
     // check
     tb_assert_and_check_return_val(cstr && mask, 0);
 
+    // using the modern hash
+    if (algo != TB_ELEMENT_HASH_ALGO_LEGACY) return tb_element_hash_data_modern(algo, (tb_byte_t const*)cstr, tb_strlen(cstr), index) & mask;
+
     // for optimization
     if (index < 2)
     {
@@ -321,5 +368,5 @@ tb_size_t tb_element_hash_cstr(tb_char_t const* cstr, tb_size_t mask, tb_size_t
     }
 
     // using the data hash
-    return tb_element_hash_data((tb_byte_t const*)cstr, tb_strlen(cstr), mask, index);
+    return tb_element_hash_data(TB_ELEMENT_HASH_ALGO_LEGACY, (tb_byte_t const*)cstr, tb_strlen(cstr), mask, index);
 }
@@ -77,6 +77,7 @@ tb_size_t           tb_element_hash_uint64(tb_uint64_t value, tb_size_t mask, tb
 
 /* compute the data hash
  *
+ * @param algo      the hash algorithm, see tb_element_hash_algo_e
  * @param data      the data
  * @param size      the size
  * @param mask      the mask
@@ -84,17 +85,18 @@ tb_size_t           tb_element_hash_uint64(tb_uint64_t value, tb_size_t mask, tb
  *
  * @return          the hash value
  */
-tb_size_t           tb_element_hash_data(tb_byte_t const* data, tb_size_t size, tb_size_t mask, tb_size_t index);
+tb_size_t           tb_element_hash_data(tb_size_t algo, tb_byte_t const* data, tb_size_t size, tb_size_t mask, tb_size_t index);
 
 /* compute the cstring hash
  *
+ * @param algo      the hash algorithm, see tb_element_hash_algo_e
  * @param cstr      the cstring
  * @param mask      the mask
  * @param index     the hash func index
  *
  * @return          the hash value
  */
-tb_size_t           tb_element_hash_cstr(tb_char_t const* cstr, tb_size_t mask, tb_size_t index);
+tb_size_t           tb_element_hash_cstr(tb_size_t algo, tb_char_t const* cstr, tb_size_t mask, tb_size_t index);
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
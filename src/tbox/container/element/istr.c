@@ -0,0 +1,60 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        istr.c
+ * @ingroup     container
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "hash.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_size_t tb_element_istr_hash(tb_element_ref_t element, tb_cpointer_t data, tb_size_t mask, tb_size_t index)
+{
+    // check
+    tb_assert_and_check_return_val(data, 0);
+
+    // use the precomputed hash first
+    tb_size_t hash = tb_string_pool_cstr_hash((tb_char_t const*)data);
+    return !index? (hash & mask) : tb_element_hash_uint32((tb_uint32_t)hash, mask, index);
+}
+static tb_char_t const* tb_element_istr_cstr(tb_element_ref_t element, tb_cpointer_t data, tb_char_t* cstr, tb_size_t maxn)
+{
+    // the c-string
+    return (tb_char_t const*)data;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+tb_element_t tb_element_istr()
+{
+    // init element, it is same as the pointer element
+    tb_element_t element = tb_element_ptr(tb_null, tb_null);
+    element.type   = TB_ELEMENT_TYPE_ISTR;
+    element.hash   = tb_element_istr_hash;
+    element.cstr   = tb_element_istr_cstr;
+
+    // ok
+    return element;
+}
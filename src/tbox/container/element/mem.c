@@ -32,7 +32,7 @@
  */
 static tb_size_t tb_element_mem_hash(tb_element_ref_t element, tb_cpointer_t data, tb_size_t mask, tb_size_t index)
 {
-    return tb_element_hash_data((tb_byte_t const*)data, element->size, mask, index);
+    return tb_element_hash_data(element->algo, (tb_byte_t const*)data, element->size, mask, index);
 }
 static tb_long_t tb_element_mem_comp(tb_element_ref_t element, tb_cpointer_t ldata, tb_cpointer_t rdata)
 {
@@ -153,6 +153,7 @@ tb_element_t tb_element_mem(tb_size_t size, tb_element_free_func_t free, tb_cpoi
     tb_element_t element = {0};
     element.type   = TB_ELEMENT_TYPE_MEM;
     element.flag   = 0;
+    element.algo   = (tb_uint16_t)tb_element_hash_algo();
     element.hash   = tb_element_mem_hash;
     element.comp   = tb_element_mem_comp;
     element.data   = tb_element_mem_data;
@@ -31,7 +31,7 @@
  */
 static tb_size_t tb_element_str_hash(tb_element_ref_t element, tb_cpointer_t data, tb_size_t mask, tb_size_t index)
 {
-    return tb_element_hash_cstr((tb_char_t const*)data, mask, index);
+    return tb_element_hash_cstr(element->algo, (tb_char_t const*)data, mask, index);
 }
 static tb_long_t tb_element_str_comp(tb_element_ref_t element, tb_cpointer_t ldata, tb_cpointer_t rdata)
 {
@@ -189,6 +189,7 @@ tb_element_t tb_element_str(tb_bool_t bcase)
     tb_element_t element = {0};
     element.type   = TB_ELEMENT_TYPE_STR;
     element.flag   = !!bcase;
+    element.algo   = (tb_uint16_t)tb_element_hash_algo();
     element.hash   = tb_element_str_hash;
     element.comp   = tb_element_str_comp;
     element.data   = tb_element_str_data;
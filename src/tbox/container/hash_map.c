@@ -61,11 +61,21 @@
 #endif
 
 // the self bucket maximum size
-#define TB_HASH_MAP_BUCKET_MAXN                         (1 << 16)
+#if TB_CPU_BIT64
+#   define TB_HASH_MAP_BUCKET_MAXN                      (1 << 24)
+#else
+#   define TB_HASH_MAP_BUCKET_MAXN                      (1 << 16)
+#endif
 
 // the self bucket item maximum size
 #define TB_HASH_MAP_BUCKET_ITEM_MAXN                    (1 << 16)
 
+// the self bucket item initial size
+#define TB_HASH_MAP_BUCKET_ITEM_INIT                    (4)
+
+// the maximum split count of buckets for each insertion
+#define TB_HASH_MAP_SPLIT_STEP                          (4)
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
@@ -90,9 +100,26 @@ typedef struct __tb_hash_map_t
     // the hash list
     tb_hash_map_item_list_t**       hash_list;
 
-    // the hash list size
+    /* the hash list size, it will be grown one bucket by one bucket (linear hashing)
+     *
+     * hash_mask + 1 <= hash_size <= (hash_mask + 1) << 1
+     *
+     * the buckets [0, hash_size - hash_mask - 1) have been split to [hash_mask + 1, hash_size)
+     */
     tb_size_t                       hash_size;
 
+    // the hash mask of the current round
+    tb_size_t                       hash_mask;
+
+    // the hash list maxn
+    tb_size_t                       hash_maxn;
+
+    // the initial hash list size
+    tb_size_t                       hash_init;
+
+    // the load factor, no automatic growth if be zero
+    tb_size_t                       load_factor;
+
     // the current item for iterator
     tb_hash_map_item_t              item;
 
@@ -116,6 +143,125 @@ typedef struct __tb_hash_map_t
 /* //////////////////////////////////////////////////////////////////////////////////////
  * private implementation
  */
+static __tb_inline__ tb_size_t tb_hash_map_bucket(tb_hash_map_t* hash_map, tb_cpointer_t name)
+{
+    /* compute the bucket of the next round first, and use the bucket of the current round if it has not been split
+     *
+     * @note the element hash is always (hash & mask), so the bucket of the current round is (buck & hash_mask)
+     */
+    tb_size_t buck = hash_map->element_name.hash(&hash_map->element_name, name, (hash_map->hash_mask << 1) | 1, 0);
+    if (buck >= hash_map->hash_size) buck &= hash_map->hash_mask;
+    return buck;
+}
+static tb_bool_t tb_hash_map_split(tb_hash_map_t* hash_map)
+{
+    // check
+    tb_assert_and_check_return_val(hash_map && hash_map->hash_list, tb_false);
+
+    // no more buckets? the bucket index + 1 must be able to be stored in the itor
+    tb_check_return_val(hash_map->hash_size + 1 < TB_HASH_MAP_BUCKET_MAXN, tb_false);
+
+    // get step
+    tb_size_t step = hash_map->element_name.size + hash_map->element_data.size;
+    tb_assert_and_check_return_val(step, tb_false);
+
+    // grow the hash list, we only need to copy the bucket pointers
+    if (hash_map->hash_size >= hash_map->hash_maxn)
+    {
+        // compute the new maxn
+        tb_size_t hash_maxn = hash_map->hash_maxn << 1;
+        tb_assert_and_check_return_val(hash_maxn > hash_map->hash_size, tb_false);
+
+        // realloc it
+        tb_hash_map_item_list_t** hash_list = (tb_hash_map_item_list_t**)tb_ralloc(hash_map->hash_list, hash_maxn * sizeof(tb_size_t));
+        tb_assert_and_check_return_val(hash_list, tb_false);
+
+        // update the hash list
+        hash_map->hash_list = hash_list;
+        hash_map->hash_maxn = hash_maxn;
+    }
+
+    // the split bucket and the new bucket
+    tb_size_t mask = (hash_map->hash_mask << 1) | 1;
+    tb_size_t buck = hash_map->hash_size - hash_map->hash_mask - 1;
+    tb_size_t newb = hash_map->hash_size;
+    tb_assert(buck <= hash_map->hash_mask);
+
+    // move the items of the next round bucket to the new bucket, the both lists are still sorted
+    tb_hash_map_item_list_t* list = hash_map->hash_list[buck];
+    tb_hash_map_item_list_t* newl = tb_null;
+    if (list && list->size)
+    {
+        tb_size_t  i = 0;
+        tb_size_t  j = 0;
+        tb_size_t  n = list->size;
+        tb_byte_t* data = (tb_byte_t*)&list[1];
+        for (i = 0; i < n; i++)
+        {
+            // the item
+            tb_byte_t* item = data + i * step;
+
+            // keep this item?
+            if (hash_map->element_name.hash(&hash_map->element_name, hash_map->element_name.data(&hash_map->element_name, item), mask, 0) != newb)
+            {
+                if (j != i) tb_memcpy(data + j * step, item, step);
+                j++;
+                continue;
+            }
+
+            // make the new list, the rest items are the most items which will be moved
+            if (!newl)
+            {
+                tb_size_t maxn = tb_align_pow2(n - i);
+                newl = (tb_hash_map_item_list_t*)tb_malloc0(sizeof(tb_hash_map_item_list_t) + maxn * step);
+                tb_assert_and_check_break(newl);
+
+                // init list
+                newl->size = 0;
+                newl->maxn = maxn;
+
+                // update the hash_map item maxn
+                hash_map->item_maxn += maxn;
+            }
+
+            // move this item
+            tb_memcpy(((tb_byte_t*)&newl[1]) + newl->size * step, item, step);
+            newl->size++;
+        }
+
+        // make the new list failed? no item has been moved
+        tb_check_return_val(i == n, tb_false);
+
+        // update the list size
+        list->size = j;
+    }
+
+    // attach the new bucket
+    hash_map->hash_list[newb] = newl;
+    hash_map->hash_size++;
+
+    // all buckets of the current round have been split? enter the next round
+    if (hash_map->hash_size == mask + 1) hash_map->hash_mask = mask;
+
+    // ok
+    return tb_true;
+}
+static tb_void_t tb_hash_map_grow(tb_hash_map_t* hash_map, tb_size_t item_size)
+{
+    // no automatic growth?
+    tb_check_return(hash_map->load_factor);
+
+    /* split some buckets if the load factor will be exceeded
+     *
+     * we only split a few buckets for each insertion, so the cost of growth is amortized
+     * and the insertion latency is stable, there is no stop-the-world rehash
+     */
+    tb_size_t step = 0;
+    while (step++ < TB_HASH_MAP_SPLIT_STEP && (tb_hize_t)item_size * 100 > (tb_hize_t)hash_map->hash_size * hash_map->load_factor)
+    {
+        if (!tb_hash_map_split(hash_map)) break;
+    }
+}
 #if 0
 // linear finder
 static tb_bool_t tb_hash_map_item_find(tb_hash_map_t* hash_map, tb_cpointer_t name, tb_size_t* pbuck, tb_size_t* pitem)
@@ -127,7 +273,7 @@ static tb_bool_t tb_hash_map_item_find(tb_hash_map_t* hash_map, tb_cpointer_t na
     tb_assert_and_check_return_val(step, tb_false);
 
     // comupte hash_map from name
-    tb_size_t buck = hash_map->element_name.hash(&hash_map->element_name, name, hash_map->hash_size - 1, 0);
+    tb_size_t buck = tb_hash_map_bucket(hash_map, name);
     tb_assert_and_check_return_val(buck < hash_map->hash_size, tb_false);
 
     // update buck
@@ -169,7 +315,7 @@ static tb_bool_t tb_hash_map_item_find(tb_hash_map_t* hash_map, tb_cpointer_t na
     tb_assert_and_check_return_val(step, tb_false);
 
     // comupte hash_map from name
-    tb_size_t buck = hash_map->element_name.hash(&hash_map->element_name, name, hash_map->hash_size - 1, 0);
+    tb_size_t buck = tb_hash_map_bucket(hash_map, name);
     tb_assert_and_check_return_val(buck < hash_map->hash_size, tb_false);
 
     // update buck
@@ -523,12 +669,18 @@ tb_hash_map_ref_t tb_hash_map_init(tb_size_t bucket_size, tb_element_t element_n
 
         // init self size
         hash_map->hash_size = tb_align_pow2(bucket_size);
+        hash_map->hash_mask = hash_map->hash_size - 1;
+        hash_map->hash_maxn = hash_map->hash_size;
+        hash_map->hash_init = hash_map->hash_size;
         tb_assert_and_check_break(hash_map->hash_size <= TB_HASH_MAP_BUCKET_MAXN);
 
         // init self list
-        hash_map->hash_list = (tb_hash_map_item_list_t**)tb_nalloc0(hash_map->hash_size, sizeof(tb_size_t));
+        hash_map->hash_list = (tb_hash_map_item_list_t**)tb_nalloc0(hash_map->hash_maxn, sizeof(tb_size_t));
         tb_assert_and_check_break(hash_map->hash_list);
 
+        // init load factor, the buckets are fixed by default
+        hash_map->load_factor = 0;
+
         // init item grow
         hash_map->item_grow = tb_isqrti((tb_uint32_t)bucket_size);
         if (hash_map->item_grow < 8) hash_map->item_grow = 8;
@@ -602,6 +754,25 @@ tb_void_t tb_hash_map_clear(tb_hash_map_ref_t self)
         hash_map->hash_list[i] = tb_null;
     }
 
+    // shrink the hash list to the initial size
+    if (hash_map->hash_maxn > hash_map->hash_init)
+    {
+        tb_hash_map_item_list_t** hash_list = (tb_hash_map_item_list_t**)tb_nalloc0(hash_map->hash_init, sizeof(tb_size_t));
+        if (hash_list)
+        {
+            tb_free(hash_map->hash_list);
+            hash_map->hash_list = hash_list;
+            hash_map->hash_maxn = hash_map->hash_init;
+        }
+    }
+
+    // reset the hash size, all buckets are empty now
+    if (hash_map->hash_size > hash_map->hash_init)
+    {
+        hash_map->hash_size = hash_map->hash_init;
+        hash_map->hash_mask = hash_map->hash_init - 1;
+    }
+
     // reset info
     hash_map->item_size = 0;
     hash_map->item_maxn = 0;
@@ -643,6 +814,9 @@ tb_size_t tb_hash_map_insert(tb_hash_map_ref_t self, tb_cpointer_t name, tb_cpoi
     tb_size_t step = hash_map->element_name.size + hash_map->element_data.size;
     tb_assert_and_check_return_val(step, 0);
 
+    // grow buckets first, the returned itor will be not changed by splitting buckets
+    tb_hash_map_grow(hash_map, hash_map->item_size + 1);
+
     // find it
     tb_size_t buck = 0;
     tb_size_t item = 0;
@@ -675,8 +849,8 @@ tb_size_t tb_hash_map_insert(tb_hash_map_ref_t self, tb_cpointer_t name, tb_cpoi
                 // check
                 tb_assert_and_check_return_val(hash_map->item_grow, 0);
 
-                // resize maxn
-                tb_size_t maxn = tb_align_pow2(list->maxn + hash_map->item_grow);
+                // resize maxn, double it for the small list
+                tb_size_t maxn = list->maxn < hash_map->item_grow? (list->maxn << 1) : tb_align_pow2(list->maxn + hash_map->item_grow);
                 tb_assert_and_check_return_val(maxn > list->maxn, 0);
 
                 // realloc it
@@ -710,12 +884,12 @@ tb_size_t tb_hash_map_insert(tb_hash_map_ref_t self, tb_cpointer_t name, tb_cpoi
             tb_assert_and_check_return_val(hash_map->item_grow, 0);
 
             // make list
-            list = (tb_hash_map_item_list_t*)tb_malloc0(sizeof(tb_hash_map_item_list_t) + hash_map->item_grow * step);
+            list = (tb_hash_map_item_list_t*)tb_malloc0(sizeof(tb_hash_map_item_list_t) + TB_HASH_MAP_BUCKET_ITEM_INIT * step);
             tb_assert_and_check_return_val(list, 0);
 
             // init list
             list->size = 1;
-            list->maxn = hash_map->item_grow;
+            list->maxn = TB_HASH_MAP_BUCKET_ITEM_INIT;
             hash_map->element_name.dupl(&hash_map->element_name, ((tb_byte_t*)&list[1]), name);
             hash_map->element_data.dupl(&hash_map->element_data, ((tb_byte_t*)&list[1]) + hash_map->element_name.size, data);
 
@@ -763,6 +937,59 @@ tb_size_t tb_hash_map_maxn(tb_hash_map_ref_t self)
     // the maxn
     return hash_map->item_maxn;
 }
+tb_bool_t tb_hash_map_reserve(tb_hash_map_ref_t self, tb_size_t size)
+{
+    // check
+    tb_hash_map_t* hash_map = (tb_hash_map_t*)self;
+    tb_assert_and_check_return_val(hash_map && hash_map->hash_list, tb_false);
+
+    // compute the needed bucket size
+    tb_size_t load_factor = hash_map->load_factor? hash_map->load_factor : TB_HASH_MAP_LOAD_FACTOR_NORMAL;
+    tb_hize_t hash_size = ((tb_hize_t)size * 100 + load_factor - 1) / load_factor;
+
+    // the last split needs hash_size + 1 < TB_HASH_MAP_BUCKET_MAXN, so we keep one bucket for it
+    if (hash_size > TB_HASH_MAP_BUCKET_MAXN - 2) hash_size = TB_HASH_MAP_BUCKET_MAXN - 2;
+    tb_check_return_val(hash_size > hash_map->hash_size, tb_true);
+
+    // grow the hash list only once
+    tb_size_t hash_maxn = tb_align_pow2((tb_size_t)hash_size);
+    if (hash_maxn > hash_map->hash_maxn)
+    {
+        tb_hash_map_item_list_t** hash_list = (tb_hash_map_item_list_t**)tb_ralloc(hash_map->hash_list, hash_maxn * sizeof(tb_size_t));
+        tb_assert_and_check_return_val(hash_list, tb_false);
+
+        // update the hash list
+        hash_map->hash_list = hash_list;
+        hash_map->hash_maxn = hash_maxn;
+    }
+
+    // split buckets
+    while (hash_map->hash_size < hash_size)
+    {
+        if (!tb_hash_map_split(hash_map)) return tb_false;
+    }
+
+    // ok
+    return tb_true;
+}
+tb_size_t tb_hash_map_load_factor(tb_hash_map_ref_t self)
+{
+    // check
+    tb_hash_map_t const* hash_map = (tb_hash_map_t const*)self;
+    tb_assert_and_check_return_val(hash_map, 0);
+
+    // the load factor
+    return hash_map->load_factor;
+}
+tb_void_t tb_hash_map_load_factor_set(tb_hash_map_ref_t self, tb_size_t load_factor)
+{
+    // check
+    tb_hash_map_t* hash_map = (tb_hash_map_t*)self;
+    tb_assert_and_check_return(hash_map);
+
+    // set the load factor
+    hash_map->load_factor = load_factor;
+}
 #ifdef __tb_debug__
 tb_void_t tb_hash_map_dump(tb_hash_map_ref_t self)
 {
@@ -47,6 +47,9 @@ __tb_extern_c_enter__
 /// the large hash bucket size
 #define TB_HASH_MAP_BUCKET_SIZE_LARGE                 (65536)
 
+/// the normal load factor for the automatic growth, the average item count of each bucket * 100
+#define TB_HASH_MAP_LOAD_FACTOR_NORMAL                (200)
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
@@ -88,7 +91,20 @@ typedef struct __tb_hash_map_item_t
  *
  * </pre>
  *
- * @note the itor of the same item is mutable
+ * the bucket size is fixed by default, but the buckets will be grown incrementally (linear hashing)
+ * if the load factor has been set by tb_hash_map_load_factor_set() and it is exceeded,
+ * we split only a few buckets for each insertion, so there is no stop-the-world rehash.
+ *
+ * @note the itor of the same item is mutable, it is the position of this item in its bucket:
+ *
+ * - inserting a new item moves the items behind it in the same bucket
+ * - removing an item moves the items behind it in the same bucket
+ * - splitting buckets moves items to the new buckets, it may be done by tb_hash_map_insert()
+ *   if the load factor is not zero (even if the name exists) and by tb_hash_map_reserve()
+ * - tb_hash_map_clear() invalidates all itors
+ *
+ * so the itor returned by tb_hash_map_insert() or tb_hash_map_find() is valid until the next insertion,
+ * removal, reservation or clearing, and the data replacement by tb_iterator_copy() never moves items.
  */
 typedef tb_iterator_ref_t tb_hash_map_ref_t;
 
@@ -98,7 +114,7 @@ typedef tb_iterator_ref_t tb_hash_map_ref_t;
 
 /*! init hash map
  *
- * @param bucket_size   the hash bucket size, using the default size if be zero
+ * @param bucket_size   the initial hash bucket size, using the default size if be zero
  * @param element_name  the item for name
  * @param element_data  the item for data
  *
@@ -113,6 +129,8 @@ tb_hash_map_ref_t       tb_hash_map_init(tb_size_t bucket_size, tb_element_t ele
 tb_void_t               tb_hash_map_exit(tb_hash_map_ref_t hash_map);
 
 /*! clear hash map
+ *
+ * @note the buckets will be shrunk to the initial bucket size
  *
  * @param hash_map      the hash map
  */
@@ -161,7 +179,7 @@ tb_pointer_t            tb_hash_map_get(tb_hash_map_ref_t hash_map, tb_cpointer_
  * @param hash_map      the hash map
  * @param name          the item name
  *
- * @return              the item itor, @note: the itor of the same item is mutable
+ * @return              the item itor, @note: the itor of the same item is mutable, see tb_hash_map_ref_t
  */
 tb_size_t               tb_hash_map_find(tb_hash_map_ref_t hash_map, tb_cpointer_t name);
 
@@ -173,7 +191,7 @@ tb_size_t               tb_hash_map_find(tb_hash_map_ref_t hash_map, tb_cpointer
  * @param name          the item name
  * @param data          the item data
  *
- * @return              the item itor, @note: the itor of the same item is mutable
+ * @return              the item itor, @note: the itor of the same item is mutable, see tb_hash_map_ref_t
  */
 tb_size_t               tb_hash_map_insert(tb_hash_map_ref_t hash_map, tb_cpointer_t name, tb_cpointer_t data);
 
@@ -200,6 +218,34 @@ tb_size_t               tb_hash_map_size(tb_hash_map_ref_t hash_map);
  */
 tb_size_t               tb_hash_map_maxn(tb_hash_map_ref_t hash_map);
 
+/*! reserve buckets for the given item count
+ *
+ * it will grow buckets at once to avoid splitting buckets when inserting these items
+ *
+ * @param hash_map      the hash map
+ * @param size          the item count
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_hash_map_reserve(tb_hash_map_ref_t hash_map, tb_size_t size);
+
+/*! the hash map load factor
+ *
+ * @param hash_map      the hash map
+ *
+ * @return              the load factor, it is zero (fixed buckets) by default
+ */
+tb_size_t               tb_hash_map_load_factor(tb_hash_map_ref_t hash_map);
+
+/*! set the hash map load factor
+ *
+ * the buckets will be grown if the average item count of each bucket * 100 exceeds it
+ *
+ * @param hash_map      the hash map
+ * @param load_factor   the load factor, e.g. TB_HASH_MAP_LOAD_FACTOR_NORMAL, disable the automatic growth if be zero
+ */
+tb_void_t               tb_hash_map_load_factor_set(tb_hash_map_ref_t hash_map, tb_size_t load_factor);
+
 #ifdef __tb_debug__
 /*! dump hash
  *
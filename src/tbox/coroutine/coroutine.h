@@ -27,6 +27,7 @@
  */
 #include "lock.h"
 #include "channel.h"
+#include "thread_channel.h"
 #include "semaphore.h"
 #include "scheduler.h"
 #include "../platform/poller.h"
@@ -32,6 +32,7 @@
 #include "scheduler.h"
 #include "coroutine.h"
 #include "scheduler_io.h"
+#include "../../utils/metrics.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * macros
@@ -57,6 +58,9 @@ static tb_void_t tb_co_scheduler_make_dead(tb_co_scheduler_t* scheduler, tb_coro
 
     // remove this coroutine from the ready coroutines
     tb_list_entry_remove(&scheduler->coroutines_ready, (tb_list_entry_ref_t)coroutine);
+#ifdef TB_METRICS_ENABLE
+    tb_metrics_add(tb_metrics_builtin(TB_METRICS_BUILTIN_COROUTINE_READY), -1);
+#endif
 
     // append this coroutine to dead coroutines
     tb_list_entry_insert_tail(&scheduler->coroutines_dead, (tb_list_entry_ref_t)coroutine);
@@ -77,6 +81,11 @@ static tb_void_t tb_co_scheduler_make_ready(tb_co_scheduler_t* scheduler, tb_cor
         // .. -> coroutine(inserted) -> running -> ..
         tb_list_entry_insert_prev(&scheduler->coroutines_ready, (tb_list_entry_ref_t)scheduler->running, (tb_list_entry_ref_t)coroutine);
     }
+
+    // update the ready coroutines count
+#ifdef TB_METRICS_ENABLE
+    tb_metrics_add(tb_metrics_builtin(TB_METRICS_BUILTIN_COROUTINE_READY), 1);
+#endif
 }
 static tb_void_t tb_co_scheduler_make_suspend(tb_co_scheduler_t* scheduler, tb_coroutine_t* coroutine)
 {
@@ -88,6 +97,9 @@ static tb_void_t tb_co_scheduler_make_suspend(tb_co_scheduler_t* scheduler, tb_c
 
     // remove this coroutine from the ready coroutines
     tb_list_entry_remove(&scheduler->coroutines_ready, (tb_list_entry_ref_t)coroutine);
+#ifdef TB_METRICS_ENABLE
+    tb_metrics_add(tb_metrics_builtin(TB_METRICS_BUILTIN_COROUTINE_READY), -1);
+#endif
 
     // append this coroutine to suspend coroutines
     tb_list_entry_insert_tail(&scheduler->coroutines_suspend, (tb_list_entry_ref_t)coroutine);
@@ -347,6 +359,11 @@ tb_void_t tb_co_scheduler_switch(tb_co_scheduler_t* scheduler, tb_coroutine_t* c
     // mark the given coroutine as running
     scheduler->running = coroutine;
 
+    // update the switches count
+#ifdef TB_METRICS_ENABLE
+    tb_metrics_add(tb_metrics_builtin(TB_METRICS_BUILTIN_COROUTINE_SWITCHES), 1);
+#endif
+
     // trace
     tb_trace_d("switch to coroutine(%p) from coroutine(%p)", coroutine, running);
 
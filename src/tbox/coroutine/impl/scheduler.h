@@ -68,6 +68,9 @@ typedef struct __tb_co_scheduler_t
     // is stopped
     tb_bool_t                       stopped;
 
+    // the maximum spinning budget (us) for the busy polling mode, 0: disabled
+    tb_size_t                       busy_poll;
+
     // the running coroutine
     tb_coroutine_t*                 running;
 
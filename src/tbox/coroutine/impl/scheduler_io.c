@@ -46,12 +46,8 @@
 // the timer grow
 #define TB_SCHEDULER_IO_TIMER_GROW          (TB_SCHEDULER_IO_LTIMER_GROW >> 4)
 
-// the poller object data grow
-#ifdef __tb_small__
-#   define TB_SCHEDULER_IO_POLLERDATA_GROW    (64)
-#else
-#   define TB_SCHEDULER_IO_POLLERDATA_GROW    (4096)
-#endif
+// the maximum skipped spinning count after missing the io events for the busy polling mode
+#define TB_SCHEDULER_IO_SPIN_BACKOFF_MAXN   (1024)
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * private implementation
@@ -98,7 +94,7 @@ static tb_void_t tb_co_scheduler_io_timeout(tb_bool_t killed, tb_cpointer_t priv
         else if (object_type)
         {
             tb_co_scheduler_io_ref_t   scheduler_io = tb_co_scheduler_io(scheduler);
-            tb_co_pollerdata_io_ref_t  pollerdata = (tb_co_pollerdata_io_ref_t)(scheduler_io? tb_pollerdata_get(&scheduler_io->pollerdata, &coroutine->rs.wait.object) : tb_null);
+            tb_co_pollerdata_io_ref_t  pollerdata = (tb_co_pollerdata_io_ref_t)(scheduler_io? tb_polleritems_get(&scheduler_io->pollerdata, &coroutine->rs.wait.object) : tb_null);
             if (pollerdata)
             {
                 if (coroutine == pollerdata->co_recv)
@@ -112,17 +108,20 @@ static tb_void_t tb_co_scheduler_io_timeout(tb_bool_t killed, tb_cpointer_t priv
         tb_co_scheduler_io_resume(scheduler, coroutine, TB_POLLER_EVENT_NONE);
     }
 }
-static tb_void_t tb_co_scheduler_io_events(tb_poller_ref_t poller, tb_poller_object_ref_t object, tb_long_t events, tb_cpointer_t priv)
+static tb_void_t tb_co_scheduler_io_events(tb_co_scheduler_io_ref_t scheduler_io, tb_poller_event_ref_t event)
 {
     // check
-    tb_co_scheduler_io_ref_t scheduler_io = (tb_co_scheduler_io_ref_t)tb_poller_priv(poller);
-    tb_assert(scheduler_io && scheduler_io->scheduler && object);
+    tb_assert(scheduler_io && scheduler_io->scheduler && event);
+
+    // the object and events
+    tb_poller_object_ref_t  object = &event->object;
+    tb_long_t               events = event->events;
 
     // is process object?
     if (object->type == TB_POLLER_OBJECT_PROC)
     {
         // resume coroutine and return the process exit status
-        tb_coroutine_t* coroutine = (tb_coroutine_t*)priv;
+        tb_coroutine_t* coroutine = (tb_coroutine_t*)event->priv;
         tb_assert(coroutine);
         coroutine->rs.wait.proc_status = (tb_int_t)events;
 
@@ -137,7 +136,7 @@ static tb_void_t tb_co_scheduler_io_events(tb_poller_ref_t poller, tb_poller_obj
     }
 
     // get pollerdata data
-    tb_co_pollerdata_io_ref_t pollerdata = (tb_co_pollerdata_io_ref_t)tb_pollerdata_get(&scheduler_io->pollerdata, object);
+    tb_co_pollerdata_io_ref_t pollerdata = (tb_co_pollerdata_io_ref_t)tb_polleritems_get(&scheduler_io->pollerdata, object);
     tb_assert(pollerdata);
 
     // get poller object events
@@ -211,6 +210,63 @@ static tb_bool_t tb_co_scheduler_io_timer_spak(tb_co_scheduler_io_ref_t schedule
     // pk
     return tb_true;
 }
+static tb_long_t tb_co_scheduler_io_spin(tb_co_scheduler_io_ref_t scheduler_io, tb_size_t delay)
+{
+    // no spinning budget? park it directly
+    tb_size_t budget = scheduler_io->spin_budget;
+    tb_check_return_val(budget, 0);
+
+    // the recent spinning has been missed? we skip some spinning to avoid wasting cpu
+    if (scheduler_io->spin_skip)
+    {
+        scheduler_io->spin_skip--;
+        return 0;
+    }
+
+    // we cannot spin over the next timer
+    if (delay < budget / 1000) budget = delay * 1000;
+
+    // poll the io events without blocking until the budget is exhausted
+    tb_long_t count = 0;
+    tb_hong_t time = scheduler_io->spin_time + budget;
+    do
+    {
+        count = tb_poller_wait_events(scheduler_io->poller, scheduler_io->events, tb_arrayn(scheduler_io->events), 0);
+        scheduler_io->stats.polls++;
+        tb_check_break(!count);
+
+    } while (tb_uclock() < time);
+
+    // has events? reset the backoff
+    if (count > 0)
+    {
+        scheduler_io->stats.spin++;
+        scheduler_io->spin_backoff = 0;
+    }
+    /* missed? the events may be produced by the peer which is waiting for the cpu (e.g. single core),
+     * so we increase the backoff exponentially and skip the next spinning
+     */
+    else if (!count)
+    {
+        scheduler_io->spin_backoff = scheduler_io->spin_backoff? tb_min(scheduler_io->spin_backoff << 1, TB_SCHEDULER_IO_SPIN_BACKOFF_MAXN) : 1;
+        scheduler_io->spin_skip = scheduler_io->spin_backoff;
+    }
+    return count;
+}
+static tb_void_t tb_co_scheduler_io_spin_tune(tb_co_scheduler_io_ref_t scheduler_io, tb_size_t maxn)
+{
+    // update the average idle time before the io events arrive, ewma: 1/8
+    tb_hong_t interval = tb_uclock() - scheduler_io->spin_time;
+    if (interval < 0) interval = 0;
+    scheduler_io->stats.interval = (tb_size_t)(((tb_hong_t)scheduler_io->stats.interval * 7 + interval) >> 3);
+
+    /* spin twice of the average idle time if the io events come frequently,
+     * otherwise it is only wasting cpu and we park it directly
+     */
+    interval = scheduler_io->stats.interval;
+    scheduler_io->spin_budget = interval <= maxn? (tb_size_t)tb_max(tb_min(interval << 1, maxn), 1) : 0;
+    scheduler_io->stats.budget = scheduler_io->spin_budget;
+}
 static tb_void_t tb_co_scheduler_io_loop(tb_cpointer_t priv)
 {
     // check
@@ -247,13 +303,35 @@ static tb_void_t tb_co_scheduler_io_loop(tb_cpointer_t priv)
         // trace
         tb_trace_d("loop: wait %lu ms, %lu pending coroutines ..", tb_min(delay, ldelay), tb_co_scheduler_suspend_count(scheduler));
 
+        // spin to poll the io events first if the busy polling mode is enabled
+        tb_long_t count = 0;
+        tb_size_t busy_poll = scheduler->busy_poll;
+        if (busy_poll)
+        {
+            scheduler_io->spin_time = tb_uclock();
+            count = tb_co_scheduler_io_spin(scheduler_io, tb_min(delay, ldelay));
+        }
+
         // no more ready coroutines? wait io events and timers
-        if (tb_poller_wait(poller, tb_co_scheduler_io_events, tb_min(delay, ldelay)) < 0)
+        if (!count)
+        {
+            count = tb_poller_wait_events(poller, scheduler_io->events, tb_arrayn(scheduler_io->events), tb_min(delay, ldelay));
+            scheduler_io->stats.park++;
+        }
+        if (count < 0)
         {
             tb_trace_e("loop: wait poller failed!");
             break;
         }
 
+        // handle the triggered events
+        tb_long_t i;
+        for (i = 0; i < count; i++)
+            tb_co_scheduler_io_events(scheduler_io, &scheduler_io->events[i]);
+
+        // tune the spinning budget for the busy polling mode
+        if (busy_poll && count > 0) tb_co_scheduler_io_spin_tune(scheduler_io, busy_poll);
+
         // trace
         tb_trace_d("loop: wait ok, left %lu pending coroutines ..", tb_co_scheduler_suspend_count(scheduler));
 
@@ -294,12 +372,11 @@ tb_co_scheduler_io_ref_t tb_co_scheduler_io_init(tb_co_scheduler_t* scheduler)
         // attach poller
         tb_poller_attach(scheduler_io->poller);
 
-        // init poller object data pool
-        scheduler_io->pollerdata_pool = tb_fixed_pool_init(tb_null, TB_SCHEDULER_IO_POLLERDATA_GROW, sizeof(tb_co_pollerdata_io_t), tb_null, tb_null, tb_null);
-        tb_assert_and_check_break(scheduler_io->pollerdata_pool);
+        // init the spinning budget for the busy polling mode
+        scheduler_io->spin_budget = scheduler->busy_poll;
 
         // init poller object data
-        tb_pollerdata_init(&scheduler_io->pollerdata);
+        tb_polleritems_init(&scheduler_io->pollerdata, sizeof(tb_co_pollerdata_io_t));
 
         // start the io loop coroutine
         if (!tb_co_scheduler_start(scheduler_io->scheduler, tb_co_scheduler_io_loop, scheduler_io, 0)) break;
@@ -326,11 +403,7 @@ tb_void_t tb_co_scheduler_io_exit(tb_co_scheduler_io_ref_t scheduler_io)
     tb_assert_and_check_return(scheduler_io);
 
     // exit poller object data
-    tb_pollerdata_exit(&scheduler_io->pollerdata);
-
-    // exit poller object data pool
-    if (scheduler_io->pollerdata_pool) tb_fixed_pool_exit(scheduler_io->pollerdata_pool);
-    scheduler_io->pollerdata_pool = tb_null;
+    tb_polleritems_exit(&scheduler_io->pollerdata);
 
     // exit poller
     if (scheduler_io->poller) tb_poller_exit(scheduler_io->poller);
@@ -437,14 +510,8 @@ tb_long_t tb_co_scheduler_io_wait(tb_co_scheduler_io_ref_t scheduler_io, tb_poll
     // trace
     tb_trace_d("coroutine(%p): wait events(%lu) with %ld ms for object(%p) ..", coroutine, events, timeout, object->ref.ptr);
 
-    // get and allocate a poller object data
-    tb_co_pollerdata_io_ref_t pollerdata = (tb_co_pollerdata_io_ref_t)tb_pollerdata_get(&scheduler_io->pollerdata, object);
-    if (!pollerdata)
-    {
-        tb_assert(scheduler_io->pollerdata_pool);
-        pollerdata = (tb_co_pollerdata_io_ref_t)tb_fixed_pool_malloc0(scheduler_io->pollerdata_pool);
-        tb_pollerdata_set(&scheduler_io->pollerdata, object, pollerdata);
-    }
+    // get the poller object data
+    tb_co_pollerdata_io_ref_t pollerdata = (tb_co_pollerdata_io_ref_t)tb_polleritems_need(&scheduler_io->pollerdata, object);
     tb_assert_and_check_return_val(pollerdata, -1);
 
     // enable edge-trigger mode if be supported
@@ -650,7 +717,7 @@ tb_bool_t tb_co_scheduler_io_cancel(tb_co_scheduler_io_ref_t scheduler_io, tb_po
     }
 
     // reset the pollerdata data
-    tb_co_pollerdata_io_ref_t pollerdata = (tb_co_pollerdata_io_ref_t)tb_pollerdata_get(&scheduler_io->pollerdata, object);
+    tb_co_pollerdata_io_ref_t pollerdata = (tb_co_pollerdata_io_ref_t)tb_polleritems_get(&scheduler_io->pollerdata, object);
     if (pollerdata)
     {
         // clear the waiting coroutines
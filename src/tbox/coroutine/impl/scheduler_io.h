@@ -26,7 +26,6 @@
  * includes
  */
 #include "scheduler.h"
-#include "../../memory/fixed_pool.h"
 #include "../../platform/poller.h"
 #include "../../platform/impl/pollerdata.h"
 
@@ -35,6 +34,17 @@
  */
 __tb_extern_c_enter__
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the maximum count of the poller events for each waiting
+#ifdef __tb_small__
+#   define TB_SCHEDULER_IO_EVENTS_MAXN      (32)
+#else
+#   define TB_SCHEDULER_IO_EVENTS_MAXN      (256)
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
@@ -74,11 +84,26 @@ typedef struct __tb_co_scheduler_io_t
     // the low-precision timer (faster)
     tb_ltimer_ref_t     ltimer;
 
-    // the poller data
-    tb_pollerdata_t     pollerdata;
+    // the poller data (fd => tb_co_pollerdata_io_t)
+    tb_polleritems_t    pollerdata;
+
+    // the triggered poller events
+    tb_poller_event_t   events[TB_SCHEDULER_IO_EVENTS_MAXN];
+
+    // the spinning budget (us) for the busy polling mode
+    tb_size_t           spin_budget;
+
+    // the time (us) before waiting the io events
+    tb_hong_t           spin_time;
+
+    // the skipped spinning count
+    tb_size_t           spin_skip;
+
+    // the spinning backoff after missing the io events
+    tb_size_t           spin_backoff;
 
-    // the poller data pool
-    tb_fixed_pool_ref_t pollerdata_pool;
+    // the stats
+    tb_co_scheduler_stats_t stats;
 
 }tb_co_scheduler_io_t, *tb_co_scheduler_io_ref_t;
 
@@ -42,11 +42,11 @@ typedef struct __tb_lo_coroutine_rs_wait_t
     tb_poller_object_t          object;
 
 #ifndef TB_CONFIG_MICRO_ENABLE
-    // the timer task pointer for ltimer or timer
-    tb_cpointer_t               task;
+    // the timeout entry in the timer wheel of the io scheduler, it's not in the wheel if next is null
+    tb_list_entry_t             timeout;
 
-    // is ltimer?
-    tb_sint32_t                 is_ltimer     : 1;
+    // the timeout time (ms)
+    tb_hong_t                   timeout_when;
 
     // the process status
     tb_int_t                    proc_status;
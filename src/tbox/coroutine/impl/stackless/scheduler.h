@@ -42,6 +42,13 @@
 // get the io scheduler
 #define tb_lo_scheduler_io(scheduler)                  ((scheduler)->scheduler_io)
 
+// the maximum count of the user private data pools for tb_lo_coroutine_pass_pool()
+#ifdef __tb_small__
+#   define TB_SCHEDULER_POOLS_MAXN                     (4)
+#else
+#   define TB_SCHEDULER_POOLS_MAXN                     (16)
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
@@ -80,6 +87,12 @@ typedef struct __tb_lo_scheduler_t
     // the suspend coroutines
     tb_list_entry_head_t            coroutines_suspend;
 
+    // the coroutine pool
+    tb_fixed_pool_ref_t             pool;
+
+    // the user private data pools with the different item sizes for tb_lo_coroutine_pass_pool()
+    tb_fixed_pool_ref_t             pools[TB_SCHEDULER_POOLS_MAXN];
+
 }tb_lo_scheduler_t;
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -104,6 +117,15 @@ tb_bool_t               tb_lo_scheduler_start(tb_lo_scheduler_t* scheduler, tb_l
  */
 tb_void_t               tb_lo_scheduler_resume(tb_lo_scheduler_t* scheduler, tb_lo_coroutine_t* coroutine);
 
+/* get the user private data pool with the given item size
+ *
+ * @param scheduler     the scheduler
+ * @param size          the item size
+ *
+ * @return              the pool, tb_null if there are too many different item sizes
+ */
+tb_fixed_pool_ref_t     tb_lo_scheduler_pool(tb_lo_scheduler_t* scheduler, tb_size_t size);
+
 /* get the current scheduler
  *
  * @return              the scheduler
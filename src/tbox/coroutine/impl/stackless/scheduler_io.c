@@ -34,44 +34,57 @@
 #include "../../stackless/coroutine.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
- * macros
+ * private implementation
  */
+#ifndef TB_CONFIG_MICRO_ENABLE
+static __tb_inline__ tb_void_t tb_lo_scheduler_io_timeout_insert(tb_lo_scheduler_io_ref_t scheduler_io, tb_lo_coroutine_t* coroutine, tb_long_t timeout)
+{
+    // check
+    tb_assert(scheduler_io && coroutine && timeout >= 0 && !coroutine->rs.wait.timeout.next);
+
+    // get the timeout time, the expired slots will not be visited again
+    tb_hong_t when = tb_cache_time_mclock() + timeout;
+    if (when < scheduler_io->wheel_time) when = scheduler_io->wheel_time;
+
+    // insert it to the tail of the slot
+    tb_list_entry_ref_t slot  = &scheduler_io->wheel[when & (TB_SCHEDULER_IO_WHEEL_MAXN - 1)];
+    tb_list_entry_ref_t entry = &coroutine->rs.wait.timeout;
+    entry->next         = slot;
+    entry->prev         = slot->prev;
+    slot->prev->next    = entry;
+    slot->prev          = entry;
+    coroutine->rs.wait.timeout_when = when;
+    scheduler_io->wheel_count++;
+}
+static __tb_inline__ tb_void_t tb_lo_scheduler_io_timeout_remove(tb_lo_scheduler_io_ref_t scheduler_io, tb_lo_coroutine_t* coroutine)
+{
+    // check
+    tb_assert(scheduler_io && coroutine);
 
-// the ltimer grow
-#ifdef __tb_small__
-#   define TB_SCHEDULER_IO_LTIMER_GROW      (64)
-#else
-#   define TB_SCHEDULER_IO_LTIMER_GROW      (4096)
-#endif
-
-// the timer grow
-#define TB_SCHEDULER_IO_TIMER_GROW          (TB_SCHEDULER_IO_LTIMER_GROW >> 4)
-
-// the poller data grow
-#ifdef __tb_small__
-#   define TB_SCHEDULER_IO_POLLERDATA_GROW    (64)
-#else
-#   define TB_SCHEDULER_IO_POLLERDATA_GROW    (4096)
+    // remove it from the slot if exists
+    tb_list_entry_ref_t entry = &coroutine->rs.wait.timeout;
+    if (entry->next)
+    {
+        entry->prev->next = entry->next;
+        entry->next->prev = entry->prev;
+        entry->next = tb_null;
+        entry->prev = tb_null;
+        scheduler_io->wheel_count--;
+    }
+}
 #endif
-
-/* //////////////////////////////////////////////////////////////////////////////////////
- * private implementation
- */
 static tb_void_t tb_lo_scheduler_io_resume(tb_lo_scheduler_t* scheduler, tb_lo_coroutine_t* coroutine, tb_size_t events)
 {
 #ifndef TB_CONFIG_MICRO_ENABLE
-    // exists the timer task? remove it
-    tb_cpointer_t task = coroutine->rs.wait.task;
-    if (task)
+    // remove the timeout entry if exists
+    if (coroutine->rs.wait.timeout.next)
     {
         // get io scheduler
         tb_lo_scheduler_io_ref_t scheduler_io = tb_lo_scheduler_io(scheduler);
-        tb_assert(scheduler_io && scheduler_io->poller);
+        tb_assert(scheduler_io);
 
-        // remove the timer task
-        if (coroutine->rs.wait.is_ltimer) tb_ltimer_task_exit(scheduler_io->ltimer, (tb_ltimer_task_ref_t)task);
-        else tb_timer_task_exit(scheduler_io->timer, (tb_timer_task_ref_t)task);
-        coroutine->rs.wait.task = tb_null;
+        // remove it
+        tb_lo_scheduler_io_timeout_remove(scheduler_io, coroutine);
     }
 #endif
 
@@ -82,59 +95,49 @@ static tb_void_t tb_lo_scheduler_io_resume(tb_lo_scheduler_t* scheduler, tb_lo_c
     tb_lo_scheduler_resume(scheduler, coroutine);
 }
 #ifndef TB_CONFIG_MICRO_ENABLE
-static tb_void_t tb_lo_scheduler_io_timeout(tb_bool_t killed, tb_cpointer_t priv)
+static tb_void_t tb_lo_scheduler_io_timeout(tb_lo_scheduler_io_ref_t scheduler_io, tb_lo_coroutine_t* coroutine)
 {
     // check
-    tb_lo_coroutine_t* coroutine = (tb_lo_coroutine_t*)priv;
-    tb_assert(coroutine);
-
-    // get scheduler
-    tb_lo_scheduler_t* scheduler = (tb_lo_scheduler_t*)coroutine->scheduler;
-    tb_assert(scheduler);
+    tb_assert(scheduler_io && coroutine);
 
     // trace
-    tb_trace_d("coroutine(%p): timer(%s) %s", coroutine, coroutine->rs.wait.object.type? "poller" : "sleep", killed? "killed" : "timeout");
+    tb_trace_d("coroutine(%p): timer(%s) timeout", coroutine, coroutine->rs.wait.object.type? "poller" : "sleep");
 
-    // resume the waited coroutine if timer task has been not canceled
-    if (!killed)
+    // reset the waited coroutines in the poller data
+    tb_size_t object_type = coroutine->rs.wait.object.type;
+    if (object_type == TB_POLLER_OBJECT_PROC)
+        coroutine->rs.wait.proc_waiting = 0;
+    else if (object_type)
     {
-        // reset the waited coroutines in the poller data
-        tb_size_t object_type = coroutine->rs.wait.object.type;
-#ifndef TB_CONFIG_MICRO_ENABLE
-        if (object_type == TB_POLLER_OBJECT_PROC)
-            coroutine->rs.wait.proc_waiting = 0;
-        else
-#endif
-        if (object_type)
+        tb_lo_pollerdata_io_ref_t pollerdata = (tb_lo_pollerdata_io_ref_t)tb_polleritems_get(&scheduler_io->pollerdata, &coroutine->rs.wait.object);
+        if (pollerdata)
         {
-            tb_lo_scheduler_io_ref_t scheduler_io = tb_lo_scheduler_io(scheduler);
-            tb_lo_pollerdata_io_ref_t  pollerdata = (tb_lo_pollerdata_io_ref_t)(scheduler_io? tb_pollerdata_get(&scheduler_io->pollerdata, &coroutine->rs.wait.object) : tb_null);
-            if (pollerdata)
-            {
-                if (coroutine == pollerdata->lo_recv)
-                    pollerdata->lo_recv = tb_null;
-                if (coroutine == pollerdata->lo_send)
-                    pollerdata->lo_send = tb_null;
-            }
+            if (coroutine == pollerdata->lo_recv)
+                pollerdata->lo_recv = tb_null;
+            if (coroutine == pollerdata->lo_send)
+                pollerdata->lo_send = tb_null;
         }
-
-        // resume the coroutine
-        tb_lo_scheduler_io_resume(scheduler, coroutine, TB_POLLER_EVENT_NONE);
     }
+
+    // resume the coroutine
+    tb_lo_scheduler_io_resume(scheduler_io->scheduler, coroutine, TB_POLLER_EVENT_NONE);
 }
 #endif
-static tb_void_t tb_lo_scheduler_io_events(tb_poller_ref_t poller, tb_poller_object_ref_t object, tb_long_t events, tb_cpointer_t priv)
+static tb_void_t tb_lo_scheduler_io_events(tb_lo_scheduler_io_ref_t scheduler_io, tb_poller_event_ref_t event)
 {
     // check
-    tb_lo_scheduler_io_ref_t scheduler_io = (tb_lo_scheduler_io_ref_t)tb_poller_priv(poller);
-    tb_assert(scheduler_io && scheduler_io->scheduler && object);
+    tb_assert(scheduler_io && scheduler_io->scheduler && event);
+
+    // the object and events
+    tb_poller_object_ref_t  object = &event->object;
+    tb_long_t               events = event->events;
 
 #ifndef TB_CONFIG_MICRO_ENABLE
     // is process object?
     if (object->type == TB_POLLER_OBJECT_PROC)
     {
         // resume coroutine and return the process exit status
-        tb_lo_coroutine_t* coroutine = (tb_lo_coroutine_t*)priv;
+        tb_lo_coroutine_t* coroutine = (tb_lo_coroutine_t*)event->priv;
         tb_assert(coroutine);
         coroutine->rs.wait.proc_status = (tb_int_t)events;
 
@@ -150,7 +153,7 @@ static tb_void_t tb_lo_scheduler_io_events(tb_poller_ref_t poller, tb_poller_obj
 #endif
 
     // get pollerdata data
-    tb_lo_pollerdata_io_ref_t pollerdata = (tb_lo_pollerdata_io_ref_t)tb_pollerdata_get(&scheduler_io->pollerdata, object);
+    tb_lo_pollerdata_io_ref_t pollerdata = (tb_lo_pollerdata_io_ref_t)tb_polleritems_get(&scheduler_io->pollerdata, object);
     tb_assert(pollerdata);
 
     // get poller events
@@ -211,33 +214,61 @@ static tb_void_t tb_lo_scheduler_io_events(tb_poller_ref_t poller, tb_poller_obj
 static tb_bool_t tb_lo_scheduler_io_timer_spak(tb_lo_scheduler_io_ref_t scheduler_io)
 {
     // check
-    tb_assert(scheduler_io && scheduler_io->timer && scheduler_io->ltimer);
+    tb_assert(scheduler_io);
+
+    // stopped?
+    tb_check_return_val(!scheduler_io->stop, tb_false);
 
     // spak ctime
     tb_cache_time_spak();
 
-    // spak timer
-    if (!tb_timer_spak(scheduler_io->timer)) return tb_false;
+    // visit all expired slots, we need only visit all slots once if the elapsed time is too long
+    tb_hong_t now  = tb_cache_time_mclock();
+    tb_hong_t time = scheduler_io->wheel_time;
+    tb_hong_t last = now - time >= TB_SCHEDULER_IO_WHEEL_MAXN? time + TB_SCHEDULER_IO_WHEEL_MAXN - 1 : now;
+    for (; time <= last && scheduler_io->wheel_count; time++)
+    {
+        tb_list_entry_ref_t slot  = &scheduler_io->wheel[time & (TB_SCHEDULER_IO_WHEEL_MAXN - 1)];
+        tb_list_entry_ref_t entry = slot->next;
+        while (entry != slot)
+        {
+            // the next entry, the current entry may be removed
+            tb_list_entry_ref_t next = entry->next;
+
+            // timeout? the later entries in the same slot may be in the next rounds
+            tb_lo_coroutine_t* coroutine = tb_container_of(tb_lo_coroutine_t, rs.wait.timeout, entry);
+            if (coroutine->rs.wait.timeout_when <= now)
+                tb_lo_scheduler_io_timeout(scheduler_io, coroutine);
+            entry = next;
+        }
+    }
 
-    // spak ltimer
-    if (!tb_ltimer_spak(scheduler_io->ltimer)) return tb_false;
+    // all slots before now have been expired
+    if (now > scheduler_io->wheel_time) scheduler_io->wheel_time = now;
 
-    // pk
+    // ok
     return tb_true;
 }
 static tb_long_t tb_lo_scheduler_io_timer_delay(tb_lo_scheduler_io_ref_t scheduler_io)
 {
     // check
-    tb_assert(scheduler_io && scheduler_io->timer && scheduler_io->ltimer);
+    tb_assert(scheduler_io);
 
-    // the delay
-    tb_size_t delay = tb_timer_delay(scheduler_io->timer);
+    // no timeout? wait it infinitely
+    tb_check_return_val(scheduler_io->wheel_count, -1);
 
-    // the ldelay
-    tb_size_t ldelay = tb_ltimer_delay(scheduler_io->ltimer);
+    // find the first non-empty slot, it may be only contains the entries of the next rounds, but it's harmless
+    tb_size_t i = 0;
+    tb_hong_t time = scheduler_io->wheel_time;
+    for (i = 0; i < TB_SCHEDULER_IO_WHEEL_MAXN; i++, time++)
+    {
+        tb_list_entry_ref_t slot = &scheduler_io->wheel[time & (TB_SCHEDULER_IO_WHEEL_MAXN - 1)];
+        if (slot->next != slot) break;
+    }
 
-    // return the timer delay
-    return tb_min(delay, ldelay);
+    // get the delay
+    tb_hong_t now = tb_cache_time_mclock();
+    return time > now? (tb_long_t)(time - now) : 0;
 }
 #else
 static __tb_inline__ tb_long_t tb_lo_scheduler_io_timer_delay(tb_lo_scheduler_io_ref_t scheduler_io)
@@ -255,6 +286,10 @@ static tb_void_t tb_lo_scheduler_io_loop(tb_lo_coroutine_ref_t coroutine, tb_cpo
     tb_lo_scheduler_t* scheduler = scheduler_io->scheduler;
     tb_assert(scheduler);
 
+    // the events count
+    tb_long_t i = 0;
+    tb_long_t count = 0;
+
     // enter coroutine
     tb_lo_coroutine_enter(coroutine)
     {
@@ -280,7 +315,12 @@ static tb_void_t tb_lo_scheduler_io_loop(tb_lo_coroutine_ref_t coroutine, tb_cpo
             tb_trace_d("loop: wait %ld ms ..", tb_lo_scheduler_io_timer_delay(scheduler_io));
 
             // no more ready coroutines? wait io events and timers (TODO)
-            if (tb_poller_wait(scheduler_io->poller, tb_lo_scheduler_io_events, tb_lo_scheduler_io_timer_delay(scheduler_io)) < 0) break;
+            count = tb_poller_wait_events(scheduler_io->poller, scheduler_io->events, tb_arrayn(scheduler_io->events), tb_lo_scheduler_io_timer_delay(scheduler_io));
+            tb_check_break(count >= 0);
+
+            // handle the triggered events, we need not keep them after yielding
+            for (i = 0; i < count; i++)
+                tb_lo_scheduler_io_events(scheduler_io, &scheduler_io->events[i]);
 
 #ifndef TB_CONFIG_MICRO_ENABLE
             // spak timer
@@ -315,21 +355,18 @@ tb_lo_scheduler_io_ref_t tb_lo_scheduler_io_init(tb_lo_scheduler_t* scheduler)
         tb_poller_attach(scheduler_io->poller);
 
 #ifndef TB_CONFIG_MICRO_ENABLE
-        // init timer and using cache time
-        scheduler_io->timer = tb_timer_init(TB_SCHEDULER_IO_TIMER_GROW, tb_true);
-        tb_assert_and_check_break(scheduler_io->timer);
-
-        // init ltimer and using cache time
-        scheduler_io->ltimer = tb_ltimer_init(TB_SCHEDULER_IO_LTIMER_GROW, TB_LTIMER_TICK_S, tb_true);
-        tb_assert_and_check_break(scheduler_io->ltimer);
+        // init timer wheel and using cache time
+        tb_size_t i = 0;
+        for (i = 0; i < TB_SCHEDULER_IO_WHEEL_MAXN; i++)
+        {
+            scheduler_io->wheel[i].next = &scheduler_io->wheel[i];
+            scheduler_io->wheel[i].prev = &scheduler_io->wheel[i];
+        }
+        scheduler_io->wheel_time = tb_cache_time_mclock();
 #endif
 
-        // init poller data pool
-        scheduler_io->pollerdata_pool = tb_fixed_pool_init(tb_null, TB_SCHEDULER_IO_POLLERDATA_GROW, sizeof(tb_lo_pollerdata_io_t), tb_null, tb_null, tb_null);
-        tb_assert_and_check_break(scheduler_io->pollerdata_pool);
-
         // init poller data
-        tb_pollerdata_init(&scheduler_io->pollerdata);
+        tb_polleritems_init(&scheduler_io->pollerdata, sizeof(tb_lo_pollerdata_io_t));
 
         // start the io loop coroutine
         if (!tb_lo_coroutine_start((tb_lo_scheduler_ref_t)scheduler, tb_lo_scheduler_io_loop, scheduler_io, tb_null)) break;
@@ -356,26 +393,12 @@ tb_void_t tb_lo_scheduler_io_exit(tb_lo_scheduler_io_ref_t scheduler_io)
     tb_assert_and_check_return(scheduler_io);
 
     // exit poller data
-    tb_pollerdata_exit(&scheduler_io->pollerdata);
-
-    // exit poller data pool
-    if (scheduler_io->pollerdata_pool) tb_fixed_pool_exit(scheduler_io->pollerdata_pool);
-    scheduler_io->pollerdata_pool = tb_null;
+    tb_polleritems_exit(&scheduler_io->pollerdata);
 
     // exit poller
     if (scheduler_io->poller) tb_poller_exit(scheduler_io->poller);
     scheduler_io->poller = tb_null;
 
-#ifndef TB_CONFIG_MICRO_ENABLE
-    // exit timer
-    if (scheduler_io->timer) tb_timer_exit(scheduler_io->timer);
-    scheduler_io->timer = tb_null;
-
-    // exit ltimer
-    if (scheduler_io->ltimer) tb_ltimer_exit(scheduler_io->ltimer);
-    scheduler_io->ltimer = tb_null;
-#endif
-
     // clear scheduler
     scheduler_io->scheduler = tb_null;
 
@@ -405,13 +428,8 @@ tb_void_t tb_lo_scheduler_io_kill(tb_lo_scheduler_io_ref_t scheduler_io)
     // trace
     tb_trace_d("kill: ..");
 
-#ifndef TB_CONFIG_MICRO_ENABLE
-    // kill timer
-    if (scheduler_io->timer) tb_timer_kill(scheduler_io->timer);
-
-    // kill ltimer
-    if (scheduler_io->ltimer) tb_ltimer_kill(scheduler_io->ltimer);
-#endif
+    // stop it
+    scheduler_io->stop = tb_true;
 
     // kill poller
     if (scheduler_io->poller) tb_poller_kill(scheduler_io->poller);
@@ -429,26 +447,11 @@ tb_void_t tb_lo_scheduler_io_sleep(tb_lo_scheduler_io_ref_t scheduler_io, tb_lon
     // trace
     tb_trace_d("coroutine(%p): sleep %ld ms ..", coroutine, interval);
 
-    // clear waiting task first
-    coroutine->rs.wait.task = tb_null;
+    // clear waiting object first
     coroutine->rs.wait.object.type = TB_POLLER_OBJECT_NONE;
 
-    // infinity?
-    if (interval > 0)
-    {
-        // high-precision interval?
-        if (interval % 1000)
-        {
-            // post task to timer
-            tb_timer_task_post(scheduler_io->timer, interval, tb_false, tb_lo_scheduler_io_timeout, coroutine);
-        }
-        // low-precision interval?
-        else
-        {
-            // post task to ltimer (faster)
-            tb_ltimer_task_post(scheduler_io->ltimer, interval, tb_false, tb_lo_scheduler_io_timeout, coroutine);
-        }
-    }
+    // insert timeout if be not infinity
+    if (interval > 0) tb_lo_scheduler_io_timeout_insert(scheduler_io, coroutine, interval);
 #else
     // not impl
     tb_trace_noimpl();
@@ -471,13 +474,7 @@ tb_bool_t tb_lo_scheduler_io_wait(tb_lo_scheduler_io_ref_t scheduler_io, tb_poll
     tb_trace_d("coroutine(%p): wait events(%lu) with %ld ms for poller(%p) ..", coroutine, events, timeout, object->ref.ptr);
 
     // get and allocate a poller data
-    tb_lo_pollerdata_io_ref_t pollerdata = (tb_lo_pollerdata_io_ref_t)tb_pollerdata_get(&scheduler_io->pollerdata, object);
-    if (!pollerdata)
-    {
-        tb_assert(scheduler_io->pollerdata_pool);
-        pollerdata = (tb_lo_pollerdata_io_ref_t)tb_fixed_pool_malloc0(scheduler_io->pollerdata_pool);
-        tb_pollerdata_set(&scheduler_io->pollerdata, object, pollerdata);
-    }
+    tb_lo_pollerdata_io_ref_t pollerdata = (tb_lo_pollerdata_io_ref_t)tb_polleritems_need(&scheduler_io->pollerdata, object);
     tb_assert_and_check_return_val(pollerdata, -1);
 
     // enable edge-trigger mode if be supported
@@ -547,33 +544,8 @@ tb_bool_t tb_lo_scheduler_io_wait(tb_lo_scheduler_io_ref_t scheduler_io, tb_poll
     }
 
 #ifndef TB_CONFIG_MICRO_ENABLE
-    // exists timeout?
-    tb_cpointer_t   task = tb_null;
-    tb_bool_t       is_ltimer = tb_false;
-    if (timeout >= 0)
-    {
-        // high-precision interval?
-        if (timeout % 1000)
-        {
-            // init task for timer
-            task = tb_timer_task_init(scheduler_io->timer, timeout, tb_false, tb_lo_scheduler_io_timeout, coroutine);
-            tb_assert_and_check_return_val(task, tb_false);
-        }
-        // low-precision interval?
-        else
-        {
-            // init task for ltimer (faster)
-            task = tb_ltimer_task_init(scheduler_io->ltimer, timeout, tb_false, tb_lo_scheduler_io_timeout, coroutine);
-            tb_assert_and_check_return_val(task, tb_false);
-
-            // mark as low-precision timer
-            is_ltimer = tb_true;
-        }
-    }
-
-    // save the timer task to coroutine
-    coroutine->rs.wait.task = task;
-    coroutine->rs.wait.is_ltimer = is_ltimer;
+    // insert timeout if exists
+    if (timeout >= 0) tb_lo_scheduler_io_timeout_insert(scheduler_io, coroutine, timeout);
 #endif
     coroutine->rs.wait.object = *object;
     coroutine->rs.wait.result = 0;
@@ -624,34 +596,11 @@ tb_bool_t tb_lo_scheduler_io_wait_proc(tb_lo_scheduler_io_ref_t scheduler_io, tb
         return tb_false;
     }
 
-    // exists timeout?
-    tb_cpointer_t   task = tb_null;
-    tb_bool_t       is_ltimer = tb_false;
-    if (timeout >= 0)
-    {
-        // high-precision interval?
-        if (timeout % 1000)
-        {
-            // init task for timer
-            task = tb_timer_task_init(scheduler_io->timer, timeout, tb_false, tb_lo_scheduler_io_timeout, coroutine);
-            tb_assert_and_check_return_val(task, tb_false);
-        }
-        // low-precision interval?
-        else
-        {
-            // init task for ltimer (faster)
-            task = tb_ltimer_task_init(scheduler_io->ltimer, timeout, tb_false, tb_lo_scheduler_io_timeout, coroutine);
-            tb_assert_and_check_return_val(task, tb_false);
-
-            // mark as low-precision timer
-            is_ltimer = tb_true;
-        }
-    }
+    // insert timeout if exists
+    if (timeout >= 0) tb_lo_scheduler_io_timeout_insert(scheduler_io, coroutine, timeout);
 
-    // save the timer task to coroutine
-    coroutine->rs.wait.task         = task;
+    // save the waited object to coroutine
     coroutine->rs.wait.object       = *object;
-    coroutine->rs.wait.is_ltimer    = is_ltimer;
     coroutine->rs.wait.proc_status  = 0;
     coroutine->rs.wait.proc_pending = 0;
     coroutine->rs.wait.proc_waiting = 1;
@@ -693,7 +642,7 @@ tb_bool_t tb_lo_scheduler_io_cancel(tb_lo_scheduler_io_ref_t scheduler_io, tb_po
 #endif
 
     // reset the pollerdata data
-    tb_lo_pollerdata_io_ref_t pollerdata = (tb_lo_pollerdata_io_ref_t)tb_pollerdata_get(&scheduler_io->pollerdata, object);
+    tb_lo_pollerdata_io_ref_t pollerdata = (tb_lo_pollerdata_io_ref_t)tb_polleritems_get(&scheduler_io->pollerdata, object);
     if (pollerdata)
     {
         // clear the waiting coroutines
@@ -26,7 +26,6 @@
  * includes
  */
 #include "scheduler.h"
-#include "../../../memory/fixed_pool.h"
 #include "../../../platform/poller.h"
 #include "../../../platform/impl/pollerdata.h"
 
@@ -35,6 +34,24 @@
  */
 __tb_extern_c_enter__
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the maximum count of the poller events for each waiting
+#ifdef __tb_small__
+#   define TB_SCHEDULER_IO_EVENTS_MAXN      (32)
+#else
+#   define TB_SCHEDULER_IO_EVENTS_MAXN      (256)
+#endif
+
+// the slots count of the timer wheel, must be power of 2
+#ifdef __tb_small__
+#   define TB_SCHEDULER_IO_WHEEL_MAXN       (256)
+#else
+#   define TB_SCHEDULER_IO_WHEEL_MAXN       (1024)
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
@@ -69,18 +86,25 @@ typedef struct __tb_lo_scheduler_io_t
     tb_poller_ref_t     poller;
 
 #ifndef TB_CONFIG_MICRO_ENABLE
-    // the timer
-    tb_timer_ref_t      timer;
-
-    // the low-precision timer (faster)
-    tb_ltimer_ref_t     ltimer;
+    /* the timer wheel for all timeouts, one slot per millisecond
+     *
+     * the timeout entries are embedded in the coroutines,
+     * so we need not allocate any timer task and inserting or removing them is O(1)
+     */
+    tb_list_entry_t     wheel[TB_SCHEDULER_IO_WHEEL_MAXN];
+
+    // the time (ms) of the first unexpired slot
+    tb_hong_t           wheel_time;
+
+    // the timeout entries count in the wheel
+    tb_size_t           wheel_count;
 #endif
 
-    // the poller data
-    tb_pollerdata_t     pollerdata;
+    // the poller data (fd => tb_lo_pollerdata_io_t)
+    tb_polleritems_t    pollerdata;
 
-    // the poller data pool
-    tb_fixed_pool_ref_t pollerdata_pool;
+    // the triggered poller events
+    tb_poller_event_t   events[TB_SCHEDULER_IO_EVENTS_MAXN];
 
 }tb_lo_scheduler_io_t, *tb_lo_scheduler_io_ref_t;
 
@@ -31,6 +31,7 @@
  */
 #include "lock.h"
 #include "semaphore.h"
+#include "../utils/lock_profiler.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
@@ -47,16 +48,42 @@ tb_void_t tb_co_lock_exit(tb_co_lock_ref_t self)
 }
 tb_void_t tb_co_lock_enter(tb_co_lock_ref_t self)
 {
+#ifdef TB_LOCK_PROFILER_SAMPLE_ENABLE
+    // sample it for the lock profiler, it's only a predictable branch if it's not sampling
+    if (tb_lock_profiler_sampling())
+    {
+        tb_hong_t wait = 0;
+        if (tb_co_semaphore_wait((tb_co_semaphore_ref_t)self, 0) <= 0)
+        {
+            wait = tb_lock_profiler_contended((tb_pointer_t)self);
+            tb_co_semaphore_wait((tb_co_semaphore_ref_t)self, -1);
+        }
+        tb_lock_profiler_acquired((tb_pointer_t)self, wait);
+        return ;
+    }
+#endif
+
     // enter lock
     tb_co_semaphore_wait((tb_co_semaphore_ref_t)self, -1);
 }
 tb_bool_t tb_co_lock_enter_try(tb_co_lock_ref_t self)
 {
     // try to enter lock
-    return tb_co_semaphore_wait((tb_co_semaphore_ref_t)self, 0) > 0;
+    tb_bool_t ok = tb_co_semaphore_wait((tb_co_semaphore_ref_t)self, 0) > 0;
+
+#ifdef TB_LOCK_PROFILER_SAMPLE_ENABLE
+    // sample it for the lock profiler
+    if (ok && tb_lock_profiler_sampling()) tb_lock_profiler_acquired((tb_pointer_t)self, 0);
+#endif
+    return ok;
 }
 tb_void_t tb_co_lock_leave(tb_co_lock_ref_t self)
 {
+#ifdef TB_LOCK_PROFILER_SAMPLE_ENABLE
+    // sample the hold time for the lock profiler
+    if (tb_lock_profiler_sampling()) tb_lock_profiler_released((tb_pointer_t)self);
+#endif
+
     // leave lock
     tb_co_semaphore_post((tb_co_semaphore_ref_t)self, 1);
 }
@@ -32,6 +32,7 @@
 #include "scheduler.h"
 #include "impl/impl.h"
 #include "../algorithm/algorithm.h"
+#include "../utils/metrics.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * globals
@@ -141,6 +142,9 @@ tb_void_t tb_co_scheduler_exit(tb_co_scheduler_ref_t self)
     tb_co_scheduler_free(&scheduler->coroutines_dead);
 
     // free all ready coroutines
+#ifdef TB_METRICS_ENABLE
+    tb_metrics_add(tb_metrics_builtin(TB_METRICS_BUILTIN_COROUTINE_READY), -(tb_long_t)tb_list_entry_size(&scheduler->coroutines_ready));
+#endif
     tb_co_scheduler_free(&scheduler->coroutines_ready);
 
     // free all suspend coroutines
@@ -228,6 +232,25 @@ tb_void_t tb_co_scheduler_loop(tb_co_scheduler_ref_t self, tb_bool_t exclusive)
     }
 #endif
 }
+tb_void_t tb_co_scheduler_busy_poll(tb_co_scheduler_ref_t self, tb_size_t usecs)
+{
+    // check
+    tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)self;
+    tb_assert_and_check_return(scheduler);
+
+    // save the maximum spinning budget
+    scheduler->busy_poll = usecs;
+}
+tb_void_t tb_co_scheduler_stats(tb_co_scheduler_ref_t self, tb_co_scheduler_stats_ref_t stats)
+{
+    // check
+    tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)self;
+    tb_assert_and_check_return(scheduler && stats);
+
+    // get stats from the io scheduler
+    if (scheduler->scheduler_io) *stats = scheduler->scheduler_io->stats;
+    else tb_memset(stats, 0, sizeof(tb_co_scheduler_stats_t));
+}
 tb_co_scheduler_ref_t tb_co_scheduler_self()
 {
     // get self scheduler on the current thread
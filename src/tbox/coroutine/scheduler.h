@@ -39,6 +39,26 @@ __tb_extern_c_enter__
 /// the coroutine scheduler ref type
 typedef __tb_typeref__(co_scheduler);
 
+/// the coroutine scheduler stats type
+typedef struct __tb_co_scheduler_stats_t
+{
+    /// the spinning count, the io events have been got by polling without blocking
+    tb_hize_t               spin;
+
+    /// the parking count, the scheduler has been blocked to wait the io events
+    tb_hize_t               park;
+
+    /// the polling count without blocking
+    tb_hize_t               polls;
+
+    /// the current spinning budget (us)
+    tb_size_t               budget;
+
+    /// the average idle time before the io events arrive (us)
+    tb_size_t               interval;
+
+}tb_co_scheduler_stats_t, *tb_co_scheduler_stats_ref_t;
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
@@ -69,6 +89,28 @@ tb_void_t               tb_co_scheduler_kill(tb_co_scheduler_ref_t scheduler);
  */
 tb_void_t               tb_co_scheduler_loop(tb_co_scheduler_ref_t schedule, tb_bool_t exclusive);
 
+/*! enable the adaptive busy polling mode
+ *
+ * the scheduler will poll the io events without blocking for a while before parking it,
+ * it will reduce the wakeup latency of the io events but it will consume more cpu.
+ *
+ * the spinning budget is tuned by the recent idle time before the io events arrive,
+ * it will not spin if the io events do not come frequently.
+ *
+ * @note the sockets can also enable TB_SOCKET_CTRL_SET_BUSY_POLL to poll the device queue
+ *
+ * @param scheduler     the scheduler
+ * @param usecs         the maximum spinning budget (us), 0: disable it
+ */
+tb_void_t               tb_co_scheduler_busy_poll(tb_co_scheduler_ref_t scheduler, tb_size_t usecs);
+
+/*! get the scheduler stats
+ *
+ * @param scheduler     the scheduler
+ * @param stats         the stats
+ */
+tb_void_t               tb_co_scheduler_stats(tb_co_scheduler_ref_t scheduler, tb_co_scheduler_stats_ref_t stats);
+
 /*! get the scheduler of the current coroutine
  *
  * @return              the scheduler
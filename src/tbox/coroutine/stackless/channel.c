@@ -0,0 +1,328 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        channel.c
+ * @ingroup     coroutine
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "lo_channel"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "channel.h"
+#include "../impl/impl.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the queue grow
+#ifdef __tb_small__
+#   define TB_LO_CHANNEL_QUEUE_GROW     (4)
+#else
+#   define TB_LO_CHANNEL_QUEUE_GROW     (16)
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the growable circular queue type for the channel data and the waiting coroutines
+typedef struct __tb_lo_channel_queue_t
+{
+    // the items
+    tb_cpointer_t*          data;
+
+    // the head index
+    tb_size_t               head;
+
+    // the items count
+    tb_size_t               size;
+
+    // the maximum count of the allocated items
+    tb_size_t               maxn;
+
+}tb_lo_channel_queue_t;
+
+// the stackless coroutine channel type
+typedef struct __tb_lo_channel_t
+{
+    // the buffer size, 0: unbounded
+    tb_size_t               bufsize;
+
+    // the data queue
+    tb_lo_channel_queue_t   queue;
+
+    // the waiting coroutines for sending
+    tb_lo_channel_queue_t   waiting_send;
+
+    // the waiting coroutines for receiving
+    tb_lo_channel_queue_t   waiting_recv;
+
+    // the free function
+    tb_lo_channel_free_func_t free;
+
+    // the user private data
+    tb_cpointer_t           priv;
+
+}tb_lo_channel_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_bool_t tb_lo_channel_queue_grow(tb_lo_channel_queue_t* queue, tb_size_t maxn)
+{
+    // check
+    tb_assert(queue && maxn > queue->maxn);
+
+    // grow data
+    tb_cpointer_t* data = (tb_cpointer_t*)tb_ralloc(queue->data, maxn * sizeof(tb_cpointer_t));
+    tb_assert_and_check_return_val(data, tb_false);
+
+    // move the wrapped items at the head to the end of the new data
+    tb_size_t tail = queue->maxn - queue->head;
+    if (queue->size && queue->head + queue->size > queue->maxn)
+    {
+        tb_memmov(data + maxn - tail, data + queue->head, tail * sizeof(tb_cpointer_t));
+        queue->head = maxn - tail;
+    }
+
+    // update data
+    queue->data = data;
+    queue->maxn = maxn;
+    return tb_true;
+}
+static __tb_inline__ tb_bool_t tb_lo_channel_queue_push(tb_lo_channel_queue_t* queue, tb_cpointer_t item)
+{
+    // full? grow it
+    if (queue->size == queue->maxn && !tb_lo_channel_queue_grow(queue, queue->maxn? (queue->maxn << 1) : TB_LO_CHANNEL_QUEUE_GROW))
+        return tb_false;
+
+    // push it to the tail
+    queue->data[(queue->head + queue->size) % queue->maxn] = item;
+    queue->size++;
+    return tb_true;
+}
+static __tb_inline__ tb_cpointer_t tb_lo_channel_queue_pop(tb_lo_channel_queue_t* queue)
+{
+    // check
+    tb_assert(queue->size);
+
+    // pop it from the head
+    tb_cpointer_t item = queue->data[queue->head];
+    queue->head = (queue->head + 1) % queue->maxn;
+    queue->size--;
+    return item;
+}
+static tb_void_t tb_lo_channel_queue_remove(tb_lo_channel_queue_t* queue, tb_cpointer_t item)
+{
+    // find it, the waiting queue is usually very short
+    tb_size_t i = 0;
+    for (i = 0; i < queue->size && queue->data[(queue->head + i) % queue->maxn] != item; i++) ;
+    tb_check_return(i < queue->size);
+
+    // move the next items forward
+    for (; i + 1 < queue->size; i++)
+        queue->data[(queue->head + i) % queue->maxn] = queue->data[(queue->head + i + 1) % queue->maxn];
+    queue->size--;
+}
+static tb_void_t tb_lo_channel_queue_exit(tb_lo_channel_queue_t* queue)
+{
+    if (queue->data) tb_free(queue->data);
+    tb_memset(queue, 0, sizeof(tb_lo_channel_queue_t));
+}
+static tb_void_t tb_lo_channel_notify(tb_lo_channel_queue_t* waiting)
+{
+    /* resume the first suspended coroutine
+     *
+     * the coroutine of select() may have been resumed by other channel and it will leave this channel later,
+     * so we skip it and notify the next coroutine
+     */
+    while (waiting->size)
+    {
+        tb_lo_coroutine_t* coroutine = (tb_lo_coroutine_t*)tb_lo_channel_queue_pop(waiting);
+        if (tb_lo_core_state(coroutine) == TB_STATE_SUSPEND)
+        {
+            tb_lo_scheduler_resume((tb_lo_scheduler_t*)coroutine->scheduler, coroutine);
+            break;
+        }
+    }
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_void_t tb_lo_channel_wait_(tb_lo_channel_ref_t self, tb_lo_coroutine_ref_t coroutine, tb_bool_t send)
+{
+    // check
+    tb_lo_channel_t* channel = (tb_lo_channel_t*)self;
+    tb_assert(channel && coroutine);
+
+    // wait it, the suspended coroutine will be never resumed if no memory
+    if (!tb_lo_channel_queue_push(send? &channel->waiting_send : &channel->waiting_recv, coroutine))
+    {
+        // trace
+        tb_trace_e("wait coroutine(%p) failed!", coroutine);
+    }
+}
+tb_void_t tb_lo_channel_select_wait_(tb_lo_channel_ref_t const* channels, tb_size_t count, tb_lo_coroutine_ref_t coroutine)
+{
+    // check
+    tb_assert(channels);
+
+    // wait all channels
+    tb_size_t i = 0;
+    for (i = 0; i < count; i++)
+    {
+        if (channels[i]) tb_lo_channel_wait_(channels[i], coroutine, tb_false);
+    }
+}
+tb_void_t tb_lo_channel_select_leave_(tb_lo_channel_ref_t const* channels, tb_size_t count, tb_lo_coroutine_ref_t coroutine)
+{
+    // check
+    tb_assert(channels);
+
+    // leave all channels, the notifying channel has removed it
+    tb_size_t i = 0;
+    for (i = 0; i < count; i++)
+    {
+        tb_lo_channel_t* channel = (tb_lo_channel_t*)channels[i];
+        if (channel) tb_lo_channel_queue_remove(&channel->waiting_recv, coroutine);
+    }
+}
+tb_lo_channel_ref_t tb_lo_channel_init(tb_size_t size, tb_lo_channel_free_func_t free, tb_cpointer_t priv)
+{
+    // done
+    tb_bool_t           ok = tb_false;
+    tb_lo_channel_t*    channel = tb_null;
+    do
+    {
+        // make channel
+        channel = tb_malloc0_type(tb_lo_channel_t);
+        tb_assert_and_check_break(channel);
+
+        // init channel
+        channel->bufsize    = size;
+        channel->free       = free;
+        channel->priv       = priv;
+
+        // init the data queue for the bounded channel
+        if (size && !tb_lo_channel_queue_grow(&channel->queue, size)) break;
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        // exit it
+        if (channel) tb_lo_channel_exit((tb_lo_channel_ref_t)channel);
+        channel = tb_null;
+    }
+
+    // ok?
+    return (tb_lo_channel_ref_t)channel;
+}
+tb_void_t tb_lo_channel_exit(tb_lo_channel_ref_t self)
+{
+    // check
+    tb_lo_channel_t* channel = (tb_lo_channel_t*)self;
+    tb_assert_and_check_return(channel);
+
+    // check waiting coroutines
+    tb_assert(!channel->waiting_send.size && !channel->waiting_recv.size);
+
+    // free the remaining data
+    while (channel->queue.size)
+    {
+        tb_pointer_t data = (tb_pointer_t)tb_lo_channel_queue_pop(&channel->queue);
+        if (channel->free) channel->free(data, channel->priv);
+    }
+
+    // exit queues
+    tb_lo_channel_queue_exit(&channel->queue);
+    tb_lo_channel_queue_exit(&channel->waiting_send);
+    tb_lo_channel_queue_exit(&channel->waiting_recv);
+
+    // exit it
+    tb_free(channel);
+}
+tb_size_t tb_lo_channel_size(tb_lo_channel_ref_t self)
+{
+    // check
+    tb_lo_channel_t* channel = (tb_lo_channel_t*)self;
+    tb_assert_and_check_return_val(channel, 0);
+
+    return channel->queue.size;
+}
+tb_bool_t tb_lo_channel_send_try(tb_lo_channel_ref_t self, tb_cpointer_t data)
+{
+    // check
+    tb_lo_channel_t* channel = (tb_lo_channel_t*)self;
+    tb_assert_and_check_return_val(channel, tb_false);
+
+    // full?
+    tb_check_return_val(!channel->bufsize || channel->queue.size < channel->bufsize, tb_false);
+
+    // push data
+    if (!tb_lo_channel_queue_push(&channel->queue, data)) return tb_false;
+
+    // notify the waiting receiver
+    tb_lo_channel_notify(&channel->waiting_recv);
+    return tb_true;
+}
+tb_bool_t tb_lo_channel_recv_try(tb_lo_channel_ref_t self, tb_pointer_t* pdata)
+{
+    // check
+    tb_lo_channel_t* channel = (tb_lo_channel_t*)self;
+    tb_assert_and_check_return_val(channel && pdata, tb_false);
+
+    // no data?
+    tb_check_return_val(channel->queue.size, tb_false);
+
+    // pop data
+    *pdata = (tb_pointer_t)tb_lo_channel_queue_pop(&channel->queue);
+
+    // notify the waiting sender
+    tb_lo_channel_notify(&channel->waiting_send);
+    return tb_true;
+}
+tb_bool_t tb_lo_channel_select_try(tb_lo_channel_ref_t const* channels, tb_size_t count, tb_size_t* pindex, tb_pointer_t* pdata)
+{
+    // check
+    tb_assert_and_check_return_val(channels && pdata, tb_false);
+
+    // recv data from the first channel with data
+    tb_size_t i = 0;
+    for (i = 0; i < count; i++)
+    {
+        if (channels[i] && tb_lo_channel_recv_try(channels[i], pdata))
+        {
+            if (pindex) *pindex = i;
+            return tb_true;
+        }
+    }
+    return tb_false;
+}
@@ -0,0 +1,223 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        channel.h
+ * @ingroup     coroutine
+ *
+ */
+#ifndef TB_COROUTINE_STACKLESS_CHANNEL_H
+#define TB_COROUTINE_STACKLESS_CHANNEL_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "coroutine.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+/*! send data into channel
+ *
+ * the current coroutine will be suspended if this channel is full
+ *
+ * @note the data expression will be evaluated again after resuming, so it cannot be a local variable
+ *
+ * @param channel       the channel
+ * @param data          the channel data
+ */
+#define tb_lo_channel_send(channel, data) \
+do \
+{ \
+    while (!tb_lo_channel_send_try(channel, data)) \
+    { \
+        tb_lo_channel_wait_(channel, tb_lo_coroutine_self(), tb_true); \
+        tb_lo_coroutine_suspend(); \
+    } \
+    \
+} while (0)
+
+/*! recv data from channel
+ *
+ * the current coroutine will be suspended if no data
+ *
+ * @code
+    typedef struct __tb_xxxx_priv_t
+    {
+        tb_lo_channel_ref_t channel;
+        tb_pointer_t        data;
+
+    }tb_xxxx_priv_t;
+
+    tb_lo_coroutine_enter(coroutine)
+    {
+        while (1)
+        {
+            tb_lo_channel_recv(priv->channel, &priv->data);
+            tb_trace_i("recv: %p", priv->data);
+        }
+    }
+ * @endcode
+ *
+ * @param channel       the channel
+ * @param pdata         the channel data pointer
+ */
+#define tb_lo_channel_recv(channel, pdata) \
+do \
+{ \
+    while (!tb_lo_channel_recv_try(channel, pdata)) \
+    { \
+        tb_lo_channel_wait_(channel, tb_lo_coroutine_self(), tb_false); \
+        tb_lo_coroutine_suspend(); \
+    } \
+    \
+} while (0)
+
+/*! recv data from one of the given channels
+ *
+ * the current coroutine will be suspended until one of them has data,
+ * the channels are checked in order, so the previous channel has the higher priority.
+ *
+ * @param channels      the channels array
+ * @param count         the channels count
+ * @param pindex        the index pointer of the received channel
+ * @param pdata         the channel data pointer
+ */
+#define tb_lo_channel_select(channels, count, pindex, pdata) \
+do \
+{ \
+    while (!tb_lo_channel_select_try(channels, count, pindex, pdata)) \
+    { \
+        tb_lo_channel_select_wait_(channels, count, tb_lo_coroutine_self()); \
+        tb_lo_coroutine_suspend(); \
+        tb_lo_channel_select_leave_(channels, count, tb_lo_coroutine_self()); \
+    } \
+    \
+} while (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the stackless coroutine channel ref type
+typedef __tb_typeref__(lo_channel);
+
+/*! the free function type
+ *
+ * @param data          the channel data
+ * @param priv          the user private data
+ */
+typedef tb_void_t       (*tb_lo_channel_free_func_t)(tb_pointer_t data, tb_cpointer_t priv);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private interfaces
+ */
+
+/* wait the channel for sending or receiving
+ *
+ * @param channel       the channel
+ * @param coroutine     the current coroutine
+ * @param send          wait it for sending?
+ */
+tb_void_t               tb_lo_channel_wait_(tb_lo_channel_ref_t channel, tb_lo_coroutine_ref_t coroutine, tb_bool_t send);
+
+/* wait all given channels for receiving
+ *
+ * @param channels      the channels array
+ * @param count         the channels count
+ * @param coroutine     the current coroutine
+ */
+tb_void_t               tb_lo_channel_select_wait_(tb_lo_channel_ref_t const* channels, tb_size_t count, tb_lo_coroutine_ref_t coroutine);
+
+/* leave all given channels after the current coroutine has been resumed
+ *
+ * @param channels      the channels array
+ * @param count         the channels count
+ * @param coroutine     the current coroutine
+ */
+tb_void_t               tb_lo_channel_select_leave_(tb_lo_channel_ref_t const* channels, tb_size_t count, tb_lo_coroutine_ref_t coroutine);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init channel
+ *
+ * @param size          the buffer size, 0: unbounded
+ * @param free          the free function
+ * @param priv          the user private data
+ *
+ * @return              the channel
+ */
+tb_lo_channel_ref_t     tb_lo_channel_init(tb_size_t size, tb_lo_channel_free_func_t free, tb_cpointer_t priv);
+
+/*! exit channel
+ *
+ * @note all waiting coroutines must be finished before exiting it
+ *
+ * @param channel       the channel
+ */
+tb_void_t               tb_lo_channel_exit(tb_lo_channel_ref_t channel);
+
+/*! get the data count in channel
+ *
+ * @param channel       the channel
+ *
+ * @return              the data count
+ */
+tb_size_t               tb_lo_channel_size(tb_lo_channel_ref_t channel);
+
+/*! try sending data into channel without suspending
+ *
+ * @param channel       the channel
+ * @param data          the channel data
+ *
+ * @return              tb_true or tb_false if this channel is full
+ */
+tb_bool_t               tb_lo_channel_send_try(tb_lo_channel_ref_t channel, tb_cpointer_t data);
+
+/*! try recving data from channel without suspending
+ *
+ * @param channel       the channel
+ * @param pdata         the channel data pointer
+ *
+ * @return              tb_true or tb_false if no data
+ */
+tb_bool_t               tb_lo_channel_recv_try(tb_lo_channel_ref_t channel, tb_pointer_t* pdata);
+
+/*! try recving data from one of the given channels without suspending
+ *
+ * @param channels      the channels array
+ * @param count         the channels count
+ * @param pindex        the index pointer of the received channel
+ * @param pdata         the channel data pointer
+ *
+ * @return              tb_true or tb_false if all channels have no data
+ */
+tb_bool_t               tb_lo_channel_select_try(tb_lo_channel_ref_t const* channels, tb_size_t count, tb_size_t* pindex, tb_pointer_t* pdata);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -33,6 +33,21 @@
 #include "scheduler.h"
 #include "../impl/impl.h"
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the head type of the pooled user private data for pass_pool()
+typedef union __tb_lo_coroutine_pass_head_t
+{
+    // the pool, tb_null if it's allocated from the native memory
+    tb_fixed_pool_ref_t         pool;
+
+    // align the user private data
+    tb_hize_t                   align;
+
+}tb_lo_coroutine_pass_head_t;
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * private implementation
  */
@@ -47,7 +62,7 @@ tb_lo_coroutine_t* tb_lo_coroutine_init(tb_lo_scheduler_ref_t scheduler, tb_lo_c
     do
     {
         // make coroutine
-        coroutine = tb_malloc0_type(tb_lo_coroutine_t);
+        coroutine = (tb_lo_coroutine_t*)tb_fixed_pool_malloc0(((tb_lo_scheduler_t*)scheduler)->pool);
         tb_assert_and_check_break(coroutine);
 
         // init core
@@ -109,7 +124,7 @@ tb_void_t tb_lo_coroutine_exit(tb_lo_coroutine_t* coroutine)
     tb_trace_d("exit: %p", coroutine);
 
     // exit it
-    tb_free(coroutine);
+    tb_fixed_pool_free(((tb_lo_scheduler_t*)coroutine->scheduler)->pool, coroutine);
 }
 tb_lo_scheduler_ref_t tb_lo_coroutine_scheduler_(tb_lo_coroutine_ref_t self)
 {
@@ -205,6 +220,51 @@ tb_pointer_t tb_lo_coroutine_pass1_make_(tb_size_t type_size, tb_cpointer_t valu
     return data;
 }
 
+tb_pointer_t tb_lo_coroutine_pass_pool_make_(tb_lo_scheduler_ref_t self, tb_size_t type_size)
+{
+    // check
+    tb_assert(type_size);
+
+    // get the current scheduler
+    tb_lo_scheduler_t* scheduler = (tb_lo_scheduler_t*)self;
+    if (!scheduler) scheduler = (tb_lo_scheduler_t*)tb_lo_scheduler_self_();
+    tb_assert_and_check_return_val(scheduler, tb_null);
+
+    // make data from the pool with the same item size, we use the native memory if there are too many different sizes
+    tb_size_t                       size = sizeof(tb_lo_coroutine_pass_head_t) + type_size;
+    tb_fixed_pool_ref_t             pool = tb_lo_scheduler_pool(scheduler, size);
+    tb_lo_coroutine_pass_head_t*    head = (tb_lo_coroutine_pass_head_t*)(pool? tb_fixed_pool_malloc0(pool) : tb_malloc0(size));
+    tb_check_return_val(head, tb_null);
+
+    // save the pool
+    head->pool = pool;
+
+    // ok
+    return (tb_pointer_t)(head + 1);
+}
+tb_pointer_t tb_lo_coroutine_pass_pool1_make_(tb_lo_scheduler_ref_t scheduler, tb_size_t type_size, tb_cpointer_t value, tb_size_t offset, tb_size_t size)
+{
+    // check
+    tb_assert(type_size && value && offset + size <= type_size);
+
+    // make data
+    tb_byte_t* data = (tb_byte_t*)tb_lo_coroutine_pass_pool_make_(scheduler, type_size);
+    if (data) tb_memcpy(data + offset, value, size);
+
+    // ok?
+    return data;
+}
+tb_void_t tb_lo_coroutine_pass_pool_free_(tb_cpointer_t priv)
+{
+    // check
+    tb_check_return(priv);
+
+    // free data
+    tb_lo_coroutine_pass_head_t* head = (tb_lo_coroutine_pass_head_t*)priv - 1;
+    if (head->pool) tb_fixed_pool_free(head->pool, head);
+    else tb_free(head);
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * public implementation
  */
@@ -289,6 +289,40 @@ do \
  */
 #define tb_lo_coroutine_pass1(type, member, value)  tb_lo_coroutine_pass1_make_(sizeof(type), &(value), tb_offsetof(type, member), tb_memsizeof(type, member)), tb_lo_coroutine_pass_free_
 
+/*! pass the user private data which is allocated from the fixed pool of the scheduler
+ *
+ * the scheduler keeps one pool for each size of the private data type,
+ * so it's faster and uses less memory than tb_lo_coroutine_pass() for a large number of coroutines.
+ *
+ * @code
+
+    // start coroutine
+    tb_lo_coroutine_start(scheduler, coroutine_func, tb_lo_coroutine_pass_pool(scheduler, tb_xxxx_priv_t));
+
+ * @endcode
+ *
+ * =>
+ *
+ * @code
+
+    // start coroutine
+    tb_lo_coroutine_start(scheduler, coroutine_func, tb_lo_coroutine_pass_pool_make_(scheduler, sizeof(tb_xxxx_priv_t)), tb_lo_coroutine_pass_pool_free_);
+
+ * @endcode
+ */
+#define tb_lo_coroutine_pass_pool(scheduler, type)  tb_lo_coroutine_pass_pool_make_(scheduler, sizeof(type)), tb_lo_coroutine_pass_pool_free_
+
+/*! pass the user private data which is allocated from the fixed pool of the scheduler and init one member
+ *
+ * @code
+
+    // start coroutine
+    tb_lo_coroutine_start(scheduler, coroutine_func, tb_lo_coroutine_pass_pool1(scheduler, tb_xxxx_priv_t, member, value));
+
+ * @endcode
+ */
+#define tb_lo_coroutine_pass_pool1(scheduler, type, member, value)  tb_lo_coroutine_pass_pool1_make_(scheduler, sizeof(type), &(value), tb_offsetof(type, member), tb_memsizeof(type, member)), tb_lo_coroutine_pass_pool_free_
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
@@ -358,6 +392,33 @@ tb_long_t               tb_lo_coroutine_proc_status_(tb_lo_coroutine_ref_t corou
  */
 tb_void_t               tb_lo_coroutine_pass_free_(tb_cpointer_t priv);
 
+/* make the user private data for pass_pool()
+ *
+ * @param scheduler     the scheduler, uses the current scheduler if be null
+ * @param type_size     the data type size
+ *
+ * @return              the user private data
+ */
+tb_pointer_t            tb_lo_coroutine_pass_pool_make_(tb_lo_scheduler_ref_t scheduler, tb_size_t type_size);
+
+/* make the user private data for pass_pool1()
+ *
+ * @param scheduler     the scheduler, uses the current scheduler if be null
+ * @param type_size     the data type size
+ * @param value         the value pointer
+ * @param offset        the member offset
+ * @param size          the value size
+ *
+ * @return              the user private data
+ */
+tb_pointer_t            tb_lo_coroutine_pass_pool1_make_(tb_lo_scheduler_ref_t scheduler, tb_size_t type_size, tb_cpointer_t value, tb_size_t offset, tb_size_t size);
+
+/* free the user private data for pass_pool()
+ *
+ * @param priv          the user private data
+ */
+tb_void_t               tb_lo_coroutine_pass_pool_free_(tb_cpointer_t priv);
+
 /* make the user private data for pass1()
  *
  * @param type_size     the data type size
@@ -31,6 +31,7 @@
  */
 #include "scheduler.h"
 #include "../impl/impl.h"
+#include "../../utils/metrics.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * macros
@@ -45,6 +46,15 @@
 #   define TB_SCHEDULER_DEAD_CACHE_MAXN     (256)
 #endif
 
+// the coroutine pool grow
+#if defined(TB_CONFIG_MICRO_ENABLE)
+#   define TB_SCHEDULER_POOL_GROW           (8)
+#elif defined(__tb_small__)
+#   define TB_SCHEDULER_POOL_GROW           (64)
+#else
+#   define TB_SCHEDULER_POOL_GROW           (256)
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * globals
  */
@@ -102,6 +112,11 @@ static tb_void_t tb_lo_scheduler_make_ready(tb_lo_scheduler_t* scheduler, tb_lo_
         // .. last -> coroutine(inserted)
         tb_list_entry_insert_tail(&scheduler->coroutines_ready, &coroutine->entry);
     }
+
+    // update the ready coroutines count
+#ifdef TB_METRICS_ENABLE
+    tb_metrics_add(tb_metrics_builtin(TB_METRICS_BUILTIN_COROUTINE_READY), 1);
+#endif
 }
 static tb_void_t tb_lo_scheduler_make_dead(tb_lo_scheduler_t* scheduler, tb_lo_coroutine_t* coroutine)
 {
@@ -117,6 +132,9 @@ static tb_void_t tb_lo_scheduler_make_dead(tb_lo_scheduler_t* scheduler, tb_lo_c
 
     // remove this coroutine from the ready coroutines
     tb_list_entry_remove(&scheduler->coroutines_ready, &coroutine->entry);
+#ifdef TB_METRICS_ENABLE
+    tb_metrics_add(tb_metrics_builtin(TB_METRICS_BUILTIN_COROUTINE_READY), -1);
+#endif
 
     // append this coroutine to dead coroutines
     tb_list_entry_insert_tail(&scheduler->coroutines_dead, &coroutine->entry);
@@ -132,6 +150,9 @@ static tb_void_t tb_lo_scheduler_make_suspend(tb_lo_scheduler_t* scheduler, tb_l
 
     // remove this coroutine from the ready coroutines
     tb_list_entry_remove(&scheduler->coroutines_ready, &coroutine->entry);
+#ifdef TB_METRICS_ENABLE
+    tb_metrics_add(tb_metrics_builtin(TB_METRICS_BUILTIN_COROUTINE_READY), -1);
+#endif
 
     // append this coroutine to suspend coroutines
     tb_list_entry_insert_tail(&scheduler->coroutines_suspend, &coroutine->entry);
@@ -164,6 +185,11 @@ static tb_void_t tb_lo_scheduler_switch(tb_lo_scheduler_t* scheduler, tb_lo_coro
     // mark the given coroutine as running
     scheduler->running = coroutine;
 
+    // update the switches count
+#ifdef TB_METRICS_ENABLE
+    tb_metrics_add(tb_metrics_builtin(TB_METRICS_BUILTIN_COROUTINE_SWITCHES), 1);
+#endif
+
     // call the coroutine function
     coroutine->func((tb_lo_coroutine_ref_t)coroutine, coroutine->priv);
 }
@@ -248,6 +274,26 @@ tb_void_t tb_lo_scheduler_resume(tb_lo_scheduler_t* scheduler, tb_lo_coroutine_t
     // make it as ready
     tb_lo_scheduler_make_ready(scheduler, coroutine);
 }
+tb_fixed_pool_ref_t tb_lo_scheduler_pool(tb_lo_scheduler_t* scheduler, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(scheduler && size, tb_null);
+
+    // find the pool with the same item size
+    tb_size_t i = 0;
+    for (i = 0; i < TB_SCHEDULER_POOLS_MAXN && scheduler->pools[i]; i++)
+    {
+        if (tb_fixed_pool_item_size(scheduler->pools[i]) == size)
+            return scheduler->pools[i];
+    }
+
+    // too many different item sizes?
+    tb_check_return_val(i < TB_SCHEDULER_POOLS_MAXN, tb_null);
+
+    // init a new pool
+    scheduler->pools[i] = tb_fixed_pool_init(tb_null, TB_SCHEDULER_POOL_GROW, size, tb_null, tb_null, tb_null);
+    return scheduler->pools[i];
+}
 tb_lo_scheduler_ref_t tb_lo_scheduler_self_()
 {
     // get self scheduler on the current thread
@@ -281,6 +327,10 @@ tb_lo_scheduler_ref_t tb_lo_scheduler_init()
         // init suspend coroutines
         tb_list_entry_init(&scheduler->coroutines_suspend, tb_lo_coroutine_t, entry, tb_null);
 
+        // init coroutine pool
+        scheduler->pool = tb_fixed_pool_init(tb_null, TB_SCHEDULER_POOL_GROW, sizeof(tb_lo_coroutine_t), tb_null, tb_null, tb_null);
+        tb_assert_and_check_break(scheduler->pool);
+
         // ok
         ok = tb_true;
 
@@ -318,6 +368,9 @@ tb_void_t tb_lo_scheduler_exit(tb_lo_scheduler_ref_t self)
     tb_lo_scheduler_free(&scheduler->coroutines_dead);
 
     // free all ready coroutines
+#ifdef TB_METRICS_ENABLE
+    tb_metrics_add(tb_metrics_builtin(TB_METRICS_BUILTIN_COROUTINE_READY), -(tb_long_t)tb_list_entry_size(&scheduler->coroutines_ready));
+#endif
     tb_lo_scheduler_free(&scheduler->coroutines_ready);
 
     // free all suspend coroutines
@@ -332,6 +385,15 @@ tb_void_t tb_lo_scheduler_exit(tb_lo_scheduler_ref_t self)
     // exit suspend coroutines
     tb_list_entry_exit(&scheduler->coroutines_suspend);
 
+    // exit the user private data pools
+    tb_size_t i = 0;
+    for (i = 0; i < TB_SCHEDULER_POOLS_MAXN && scheduler->pools[i]; i++)
+        tb_fixed_pool_exit(scheduler->pools[i]);
+
+    // exit coroutine pool
+    if (scheduler->pool) tb_fixed_pool_exit(scheduler->pool);
+    scheduler->pool = tb_null;
+
     // exit the scheduler
     tb_free(scheduler);
 }
@@ -29,6 +29,7 @@
 #include "scheduler.h"
 #include "semaphore.h"
 #include "lock.h"
+#include "channel.h"
 
 
 #endif
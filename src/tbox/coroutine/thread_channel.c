@@ -0,0 +1,570 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        thread_channel.c
+ * @ingroup     coroutine
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "thread_channel"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "thread_channel.h"
+#include "coroutine.h"
+#include "../platform/pipe.h"
+#include "../platform/time.h"
+#include "../platform/spinlock.h"
+#include "../platform/impl/pollerdata.h"
+#ifdef TB_CONFIG_POSIX_HAVE_EVENTFD
+#   include <sys/eventfd.h>
+#   include <unistd.h>
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the initial queue size for the unbounded channel
+#ifdef __tb_small__
+#   define TB_CO_THREAD_CHANNEL_QUEUE_GROW      (64)
+#else
+#   define TB_CO_THREAD_CHANNEL_QUEUE_GROW      (256)
+#endif
+
+// the backoff interval (ms) if other coroutine has been parked on the notifier
+#define TB_CO_THREAD_CHANNEL_BACKOFF            (1)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/* the notifier type
+ *
+ * the waiting side is parked on the notification file, it's eventfd on linux, otherwise it's a pipe pair.
+ *
+ * the waker only writes the notification file if someone is waiting and it has been not signaled,
+ * so we only need one write for each batch of data.
+ */
+typedef struct __tb_co_thread_channel_notifier_t
+{
+    // the notification files, read: pair[0], write: pair[1], they are the same file for eventfd
+    tb_pipe_file_ref_t              pair[2];
+
+    // the waiting count
+    tb_size_t                       waiting;
+
+    // has been signaled?
+    tb_bool_t                       signaled;
+
+    /* has a coroutine been parked on it?
+     *
+     * the io scheduler only allows one coroutine to wait the same poller object,
+     * so other coroutines will backoff and try it again.
+     */
+    tb_bool_t                       co_parked;
+
+}tb_co_thread_channel_notifier_t;
+
+// the thread channel type
+typedef struct __tb_co_thread_channel_t
+{
+    // the lock
+    tb_spinlock_t                   lock;
+
+    // the queue data
+    tb_cpointer_t*                  data;
+
+    // the queue head
+    tb_size_t                       head;
+
+    // the queue size
+    tb_size_t                       size;
+
+    // the queue capacity
+    tb_size_t                       capacity;
+
+    // the maximum size, 0: unbounded
+    tb_size_t                       maxn;
+
+    // is closed?
+    tb_bool_t                       closed;
+
+    // the free function
+    tb_co_channel_free_func_t       free;
+
+    // the user private data
+    tb_cpointer_t                   priv;
+
+    // the notifier for the waiting receivers
+    tb_co_thread_channel_notifier_t notifier_recv;
+
+    // the notifier for the waiting senders (only for bounded channel)
+    tb_co_thread_channel_notifier_t notifier_send;
+
+}tb_co_thread_channel_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_bool_t tb_co_thread_channel_notifier_init(tb_co_thread_channel_notifier_t* notifier)
+{
+    // check
+    tb_assert(notifier);
+
+#ifdef TB_CONFIG_POSIX_HAVE_EVENTFD
+    // init eventfd
+    tb_int_t fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fd >= 0)
+    {
+        notifier->pair[0] = (tb_pipe_file_ref_t)tb_fd2ptr(fd);
+        notifier->pair[1] = notifier->pair[0];
+        return tb_true;
+    }
+#endif
+
+    // init pipe pair
+    return tb_pipe_file_init_pair(notifier->pair, 0);
+}
+static tb_void_t tb_co_thread_channel_notifier_exit(tb_co_thread_channel_notifier_t* notifier)
+{
+    // check
+    tb_assert(notifier);
+
+    // exit notification files
+    if (notifier->pair[1] && notifier->pair[1] != notifier->pair[0]) tb_pipe_file_exit(notifier->pair[1]);
+    if (notifier->pair[0]) tb_pipe_file_exit(notifier->pair[0]);
+    notifier->pair[0] = tb_null;
+    notifier->pair[1] = tb_null;
+}
+static tb_void_t tb_co_thread_channel_notifier_write(tb_co_thread_channel_notifier_t* notifier)
+{
+    // check
+    tb_assert(notifier && notifier->pair[1]);
+
+    // write one event, it's ok if the pipe is full because the waiting side has not drained it
+    if (notifier->pair[1] == notifier->pair[0])
+    {
+        tb_uint64_t value = 1;
+        tb_pipe_file_write(notifier->pair[1], (tb_byte_t const*)&value, sizeof(value));
+    }
+    else
+    {
+        tb_byte_t value = 1;
+        tb_pipe_file_write(notifier->pair[1], &value, 1);
+    }
+}
+static tb_void_t tb_co_thread_channel_notifier_drain(tb_co_thread_channel_notifier_t* notifier)
+{
+    // check
+    tb_assert(notifier && notifier->pair[0]);
+
+    // drain all events
+    if (notifier->pair[1] == notifier->pair[0])
+    {
+        tb_uint64_t value = 0;
+        tb_pipe_file_read(notifier->pair[0], (tb_byte_t*)&value, sizeof(value));
+    }
+    else
+    {
+        tb_byte_t data[64];
+        while (tb_pipe_file_read(notifier->pair[0], data, sizeof(data)) == sizeof(data)) ;
+    }
+}
+
+/* mark the notifier as signaled and return whether we need write the notification file
+ *
+ * @note it need be called with lock
+ */
+static __tb_inline__ tb_bool_t tb_co_thread_channel_notifier_signal(tb_co_thread_channel_notifier_t* notifier)
+{
+    if (notifier->waiting && !notifier->signaled)
+    {
+        notifier->signaled = tb_true;
+        return tb_true;
+    }
+    return tb_false;
+}
+
+/* wait the notifier
+ *
+ * @note it need be called with lock and it will return with lock
+ *
+ * @return          > 0: woken up or retry, 0: timeout, -1: failed
+ */
+static tb_long_t tb_co_thread_channel_notifier_wait(tb_co_thread_channel_t* channel, tb_co_thread_channel_notifier_t* notifier, tb_long_t timeout)
+{
+    // check
+    tb_assert(channel && notifier);
+
+    // has a coroutine been parked on this notifier? backoff and retry it
+    tb_bool_t is_coroutine = tb_coroutine_self()? tb_true : tb_false;
+    if (is_coroutine && notifier->co_parked)
+    {
+        tb_spinlock_leave(&channel->lock);
+        tb_coroutine_sleep(TB_CO_THREAD_CHANNEL_BACKOFF);
+        tb_spinlock_enter(&channel->lock);
+        return 1;
+    }
+
+    // park it
+    notifier->waiting++;
+    if (is_coroutine) notifier->co_parked = tb_true;
+    tb_spinlock_leave(&channel->lock);
+
+    // trace
+    tb_trace_d("wait[%p]: %ld ms ..", notifier, timeout);
+
+    /* wait the notification file
+     *
+     * we wait it in the io scheduler poller if be in coroutine, otherwise we use poll/select
+     */
+    tb_long_t wait = tb_pipe_file_wait(notifier->pair[0], TB_PIPE_EVENT_READ, timeout);
+
+    // drain the notification events
+    if (wait > 0) tb_co_thread_channel_notifier_drain(notifier);
+
+    // trace
+    tb_trace_d("wait[%p]: %ld", notifier, wait);
+
+    // unpark it
+    tb_spinlock_enter(&channel->lock);
+    notifier->waiting--;
+    notifier->signaled = tb_false;
+    if (is_coroutine) notifier->co_parked = tb_false;
+    return wait;
+}
+static tb_long_t tb_co_thread_channel_timeout_left(tb_long_t timeout, tb_hong_t startime)
+{
+    // infinity?
+    tb_check_return_val(timeout >= 0, -1);
+
+    // get the left timeout
+    tb_long_t left = (tb_long_t)(startime + timeout - tb_mclock());
+    return left > 0? left : 0;
+}
+static tb_bool_t tb_co_thread_channel_queue_grow(tb_co_thread_channel_t* channel, tb_size_t need)
+{
+    // check
+    tb_assert(channel);
+
+    // enough?
+    tb_check_return_val(channel->size + need > channel->capacity, tb_true);
+
+    // compute the new capacity
+    tb_size_t capacity = channel->capacity? channel->capacity : TB_CO_THREAD_CHANNEL_QUEUE_GROW;
+    while (capacity < channel->size + need) capacity <<= 1;
+
+    // make the new queue data
+    tb_cpointer_t* data = tb_nalloc_type(capacity, tb_cpointer_t);
+    tb_assert_and_check_return_val(data, tb_false);
+
+    // copy the pending data
+    if (channel->size)
+    {
+        tb_size_t tail = channel->capacity - channel->head;
+        if (channel->size <= tail) tb_memcpy(data, channel->data + channel->head, channel->size * sizeof(tb_cpointer_t));
+        else
+        {
+            tb_memcpy(data, channel->data + channel->head, tail * sizeof(tb_cpointer_t));
+            tb_memcpy(data + tail, channel->data, (channel->size - tail) * sizeof(tb_cpointer_t));
+        }
+    }
+
+    // update the queue data
+    if (channel->data) tb_free(channel->data);
+    channel->data       = data;
+    channel->head       = 0;
+    channel->capacity   = capacity;
+    return tb_true;
+}
+static tb_size_t tb_co_thread_channel_queue_put(tb_co_thread_channel_t* channel, tb_cpointer_t const* list, tb_size_t size)
+{
+    // check
+    tb_assert(channel && list);
+
+    // get the free space
+    if (channel->maxn)
+    {
+        tb_assert(channel->size <= channel->maxn);
+        size = tb_min(size, channel->maxn - channel->size);
+    }
+    else if (!tb_co_thread_channel_queue_grow(channel, size)) return 0;
+
+    // put data
+    tb_size_t i = 0;
+    tb_size_t tail = (channel->head + channel->size) % channel->capacity;
+    for (i = 0; i < size; i++)
+    {
+        channel->data[tail] = list[i];
+        if (++tail == channel->capacity) tail = 0;
+    }
+    channel->size += size;
+    return size;
+}
+static tb_size_t tb_co_thread_channel_queue_pop(tb_co_thread_channel_t* channel, tb_pointer_t* list, tb_size_t maxn)
+{
+    // check
+    tb_assert(channel && list);
+
+    // pop data
+    tb_size_t i = 0;
+    tb_size_t size = tb_min(maxn, channel->size);
+    for (i = 0; i < size; i++)
+    {
+        list[i] = (tb_pointer_t)channel->data[channel->head];
+        if (++channel->head == channel->capacity) channel->head = 0;
+    }
+    channel->size -= size;
+    return size;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_co_thread_channel_ref_t tb_co_thread_channel_init(tb_size_t maxn, tb_co_channel_free_func_t free, tb_cpointer_t priv)
+{
+    // done
+    tb_bool_t               ok = tb_false;
+    tb_co_thread_channel_t* channel = tb_null;
+    do
+    {
+        // make channel
+        channel = tb_malloc0_type(tb_co_thread_channel_t);
+        tb_assert_and_check_break(channel);
+
+        // init lock
+        if (!tb_spinlock_init(&channel->lock)) break;
+
+        // init free function and data
+        channel->free = free;
+        channel->priv = priv;
+        channel->maxn = maxn;
+
+        // bounded? make the fixed queue data
+        if (maxn)
+        {
+            channel->capacity = maxn;
+            channel->data = tb_nalloc_type(maxn, tb_cpointer_t);
+            tb_assert_and_check_break(channel->data);
+        }
+
+        // init notifiers
+        if (!tb_co_thread_channel_notifier_init(&channel->notifier_recv)) break;
+        if (maxn && !tb_co_thread_channel_notifier_init(&channel->notifier_send)) break;
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        // exit it
+        if (channel) tb_co_thread_channel_exit((tb_co_thread_channel_ref_t)channel);
+        channel = tb_null;
+    }
+
+    // ok?
+    return (tb_co_thread_channel_ref_t)channel;
+}
+tb_void_t tb_co_thread_channel_exit(tb_co_thread_channel_ref_t self)
+{
+    // check
+    tb_co_thread_channel_t* channel = (tb_co_thread_channel_t*)self;
+    tb_assert_and_check_return(channel);
+
+    // check waiting senders and receivers
+    tb_assert(!channel->notifier_recv.waiting && !channel->notifier_send.waiting);
+
+    // exit queue
+    if (channel->data)
+    {
+        // free data
+        if (channel->free)
+        {
+            tb_size_t head = channel->head;
+            tb_size_t size = channel->size;
+            while (size--)
+            {
+                channel->free((tb_pointer_t)channel->data[head], channel->priv);
+                if (++head == channel->capacity) head = 0;
+            }
+        }
+
+        // free it
+        tb_free(channel->data);
+    }
+    channel->data = tb_null;
+    channel->size = 0;
+
+    // exit notifiers
+    tb_co_thread_channel_notifier_exit(&channel->notifier_recv);
+    tb_co_thread_channel_notifier_exit(&channel->notifier_send);
+
+    // exit lock
+    tb_spinlock_exit(&channel->lock);
+
+    // exit the channel
+    tb_free(channel);
+}
+tb_void_t tb_co_thread_channel_close(tb_co_thread_channel_ref_t self)
+{
+    // check
+    tb_co_thread_channel_t* channel = (tb_co_thread_channel_t*)self;
+    tb_assert_and_check_return(channel);
+
+    // mark as closed
+    tb_spinlock_enter(&channel->lock);
+    channel->closed = tb_true;
+    tb_bool_t notify_recv = channel->notifier_recv.waiting? tb_true : tb_false;
+    tb_bool_t notify_send = channel->notifier_send.waiting? tb_true : tb_false;
+    if (notify_recv) channel->notifier_recv.signaled = tb_true;
+    if (notify_send) channel->notifier_send.signaled = tb_true;
+    tb_spinlock_leave(&channel->lock);
+
+    // wake up all waiting senders and receivers
+    if (notify_recv) tb_co_thread_channel_notifier_write(&channel->notifier_recv);
+    if (notify_send) tb_co_thread_channel_notifier_write(&channel->notifier_send);
+}
+tb_bool_t tb_co_thread_channel_is_closed(tb_co_thread_channel_ref_t self)
+{
+    // check
+    tb_co_thread_channel_t* channel = (tb_co_thread_channel_t*)self;
+    tb_assert_and_check_return_val(channel, tb_true);
+
+    // is closed?
+    tb_spinlock_enter(&channel->lock);
+    tb_bool_t closed = channel->closed;
+    tb_spinlock_leave(&channel->lock);
+    return closed;
+}
+tb_size_t tb_co_thread_channel_size(tb_co_thread_channel_ref_t self)
+{
+    // check
+    tb_co_thread_channel_t* channel = (tb_co_thread_channel_t*)self;
+    tb_assert_and_check_return_val(channel, 0);
+
+    // get size
+    tb_spinlock_enter(&channel->lock);
+    tb_size_t size = channel->size;
+    tb_spinlock_leave(&channel->lock);
+    return size;
+}
+tb_bool_t tb_co_thread_channel_send(tb_co_thread_channel_ref_t self, tb_cpointer_t data, tb_long_t timeout)
+{
+    return tb_co_thread_channel_send_batch(self, &data, 1, timeout) == 1;
+}
+tb_size_t tb_co_thread_channel_send_batch(tb_co_thread_channel_ref_t self, tb_cpointer_t const* list, tb_size_t size, tb_long_t timeout)
+{
+    // check
+    tb_co_thread_channel_t* channel = (tb_co_thread_channel_t*)self;
+    tb_assert_and_check_return_val(channel && list, 0);
+
+    // done
+    tb_size_t sent = 0;
+    tb_hong_t startime = timeout > 0? tb_mclock() : 0;
+    tb_spinlock_enter(&channel->lock);
+    while (sent < size && !channel->closed)
+    {
+        // put data
+        tb_size_t real = tb_co_thread_channel_queue_put(channel, list + sent, size - sent);
+        sent += real;
+
+        // notify the waiting receivers once for this batch
+        if (real && tb_co_thread_channel_notifier_signal(&channel->notifier_recv))
+        {
+            tb_spinlock_leave(&channel->lock);
+            tb_co_thread_channel_notifier_write(&channel->notifier_recv);
+            tb_spinlock_enter(&channel->lock);
+        }
+
+        // all data have been sent?
+        tb_check_break(sent < size);
+
+        // failed to grow the unbounded queue?
+        tb_assert_and_check_break(channel->maxn);
+
+        // full? wait the receivers
+        tb_check_break(timeout);
+        tb_long_t left = tb_co_thread_channel_timeout_left(timeout, startime);
+        tb_check_break(left);
+        if (channel->size == channel->maxn && tb_co_thread_channel_notifier_wait(channel, &channel->notifier_send, left) <= 0)
+            break;
+    }
+
+    // the sent data may be left in the queue, notify other waiting senders if we have free space
+    tb_bool_t notify_send = (channel->maxn && channel->size < channel->maxn)? tb_co_thread_channel_notifier_signal(&channel->notifier_send) : tb_false;
+    tb_spinlock_leave(&channel->lock);
+    if (notify_send) tb_co_thread_channel_notifier_write(&channel->notifier_send);
+    return sent;
+}
+tb_bool_t tb_co_thread_channel_recv(tb_co_thread_channel_ref_t self, tb_pointer_t* pdata, tb_long_t timeout)
+{
+    // check
+    tb_assert_and_check_return_val(pdata, tb_false);
+
+    // recv it
+    return tb_co_thread_channel_recv_batch(self, pdata, 1, timeout) == 1;
+}
+tb_size_t tb_co_thread_channel_recv_batch(tb_co_thread_channel_ref_t self, tb_pointer_t* list, tb_size_t maxn, tb_long_t timeout)
+{
+    // check
+    tb_co_thread_channel_t* channel = (tb_co_thread_channel_t*)self;
+    tb_assert_and_check_return_val(channel && list && maxn, 0);
+
+    // done
+    tb_size_t recv = 0;
+    tb_hong_t startime = timeout > 0? tb_mclock() : 0;
+    tb_spinlock_enter(&channel->lock);
+    while (1)
+    {
+        // pop all pending data
+        recv = tb_co_thread_channel_queue_pop(channel, list, maxn);
+        tb_check_break(!recv);
+
+        // closed?
+        tb_check_break(!channel->closed);
+
+        // no data? wait the senders
+        tb_check_break(timeout);
+        tb_long_t left = tb_co_thread_channel_timeout_left(timeout, startime);
+        tb_check_break(left);
+        if (tb_co_thread_channel_notifier_wait(channel, &channel->notifier_recv, left) <= 0)
+        {
+            // we may be woken up with data before timeout
+            recv = tb_co_thread_channel_queue_pop(channel, list, maxn);
+            break;
+        }
+    }
+
+    // notify the waiting senders if we have free space
+    tb_bool_t notify_send = (recv && channel->maxn)? tb_co_thread_channel_notifier_signal(&channel->notifier_send) : tb_false;
+
+    // notify the next waiting receiver if there are still some pending data
+    tb_bool_t notify_recv = (channel->size || channel->closed)? tb_co_thread_channel_notifier_signal(&channel->notifier_recv) : tb_false;
+    tb_spinlock_leave(&channel->lock);
+    if (notify_send) tb_co_thread_channel_notifier_write(&channel->notifier_send);
+    if (notify_recv) tb_co_thread_channel_notifier_write(&channel->notifier_recv);
+    return recv;
+}
@@ -0,0 +1,156 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        thread_channel.h
+ * @ingroup     coroutine
+ *
+ */
+#ifndef TB_COROUTINE_THREAD_CHANNEL_H
+#define TB_COROUTINE_THREAD_CHANNEL_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "channel.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/*! the thread channel ref type
+ *
+ * the thread channel can be used between the os threads and the coroutines,
+ * e.g. the workers of tb_thread_pool send results to a coroutine on the scheduler loop, or the reverse.
+ *
+ * the waiting side will be woken up by a notification file (eventfd or pipe),
+ * so the coroutine only waits it in the poller of the io scheduler and does not block the other coroutines.
+ *
+ * we only write one notification for each batch, all data sent before the waiting side is woken up will be received together.
+ */
+typedef __tb_typeref__(co_thread_channel);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init thread channel
+ *
+ * @param maxn          the maximum buffer size, 0: unbounded, otherwise the sender will wait if this channel is full
+ * @param free          the free function for the pending data when exiting channel
+ * @param priv          the user private data
+ *
+ * @return              the channel
+ */
+tb_co_thread_channel_ref_t  tb_co_thread_channel_init(tb_size_t maxn, tb_co_channel_free_func_t free, tb_cpointer_t priv);
+
+/*! exit thread channel
+ *
+ * @note we need ensure that all waiting senders and receivers have been finished
+ *
+ * @param channel       the channel
+ */
+tb_void_t                   tb_co_thread_channel_exit(tb_co_thread_channel_ref_t channel);
+
+/*! close thread channel
+ *
+ * all waiting senders and receivers will be woken up,
+ * the receivers can still recv the pending data, but we cannot send any data after closing it.
+ *
+ * @param channel       the channel
+ */
+tb_void_t                   tb_co_thread_channel_close(tb_co_thread_channel_ref_t channel);
+
+/*! is closed?
+ *
+ * @param channel       the channel
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t                   tb_co_thread_channel_is_closed(tb_co_thread_channel_ref_t channel);
+
+/*! get the pending data count
+ *
+ * @param channel       the channel
+ *
+ * @return              the data count
+ */
+tb_size_t                   tb_co_thread_channel_size(tb_co_thread_channel_ref_t channel);
+
+/*! send data into channel
+ *
+ * it can be called in any thread or coroutine,
+ * the current coroutine or thread will be suspended if this channel is bounded and full.
+ *
+ * @param channel       the channel
+ * @param data          the channel data
+ * @param timeout       the timeout, infinity: -1
+ *
+ * @return              tb_true or tb_false (timeout or closed)
+ */
+tb_bool_t                   tb_co_thread_channel_send(tb_co_thread_channel_ref_t channel, tb_cpointer_t data, tb_long_t timeout);
+
+/*! send a batch of data into channel
+ *
+ * we only wake up the receiver once for this batch
+ *
+ * @param channel       the channel
+ * @param list          the data list
+ * @param size          the data count
+ * @param timeout       the timeout, infinity: -1
+ *
+ * @return              the sent data count, it may be less than size if timeout or closed
+ */
+tb_size_t                   tb_co_thread_channel_send_batch(tb_co_thread_channel_ref_t channel, tb_cpointer_t const* list, tb_size_t size, tb_long_t timeout);
+
+/*! recv data from channel
+ *
+ * it can be called in any thread or coroutine,
+ * the current coroutine or thread will be suspended if no data.
+ *
+ * @param channel       the channel
+ * @param pdata         the channel data pointer
+ * @param timeout       the timeout, infinity: -1
+ *
+ * @return              tb_true or tb_false (timeout or closed)
+ */
+tb_bool_t                   tb_co_thread_channel_recv(tb_co_thread_channel_ref_t channel, tb_pointer_t* pdata, tb_long_t timeout);
+
+/*! recv a batch of data from channel
+ *
+ * it will return all pending data (at most maxn) once we have been woken up
+ *
+ * @param channel       the channel
+ * @param list          the data list
+ * @param maxn          the maximum data count
+ * @param timeout       the timeout, infinity: -1
+ *
+ * @return              the received data count, 0: timeout or closed
+ */
+tb_size_t                   tb_co_thread_channel_recv_batch(tb_co_thread_channel_ref_t channel, tb_pointer_t* list, tb_size_t maxn, tb_long_t timeout);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -26,6 +26,7 @@
  */
 #include "prefix.h"
 #include "sql.h"
+#include "pool.h"
 
 
 
@@ -1359,6 +1359,31 @@ static tb_void_t tb_database_mysql_statement_exit(tb_database_sql_impl_t* databa
     // exit it
     if (statement) mysql_stmt_close((MYSQL_STMT*)statement);
 }
+static tb_bool_t tb_database_mysql_statement_reset(tb_database_sql_impl_t* database, tb_database_sql_statement_ref_t statement)
+{
+    // check
+    tb_database_mysql_t* mysql = tb_database_mysql_cast(database);
+    tb_assert_and_check_return_val(mysql && mysql->database && statement, tb_false);
+
+    // exit the statement result
+    if (mysql->result.statement == (MYSQL_STMT*)statement)
+        tb_database_mysql_result_exit(database, (tb_iterator_ref_t)&mysql->result);
+
+    // free the pending result and reset it
+    mysql_stmt_free_result((MYSQL_STMT*)statement);
+    if (mysql_stmt_reset((MYSQL_STMT*)statement))
+    {
+        // save state
+        mysql->base.state = tb_database_mysql_state_from_errno(mysql_stmt_errno((MYSQL_STMT*)statement));
+
+        // trace
+        tb_trace_e("statement: reset failed, error[%d]: %s", mysql_stmt_errno((MYSQL_STMT*)statement), mysql_stmt_error((MYSQL_STMT*)statement));
+        return tb_false;
+    }
+
+    // ok
+    return tb_true;
+}
 static tb_bool_t tb_database_mysql_statement_done(tb_database_sql_impl_t* database, tb_database_sql_statement_ref_t statement)
 {
     // check
@@ -1643,6 +1668,7 @@ tb_database_sql_ref_t tb_database_mysql_init(tb_url_ref_t url)
         mysql->base.statement_exit  = tb_database_mysql_statement_exit;
         mysql->base.statement_done  = tb_database_mysql_statement_done;
         mysql->base.statement_bind  = tb_database_mysql_statement_bind;
+        mysql->base.statement_reset = tb_database_mysql_statement_reset;
 
         // init row operation
         static tb_iterator_op_t row_op =
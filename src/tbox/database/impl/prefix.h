@@ -26,13 +26,109 @@
  */
 #include "../prefix.h"
 #include "../sql.h"
+#include "../../container/hash_map.h"
+#include "../../container/list_entry.h"
 #include "sqlite3.h"
 #include "mysql.h"
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the default row maxn of the batch
+#define TB_DATABASE_SQL_BATCH_MAXN          (1024)
+
+// the data chunk size of the batch
+#define TB_DATABASE_SQL_BATCH_CHUNK         (65536)
+
+// the default statement maxn of the statement cache
+#ifdef __tb_small__
+#   define TB_DATABASE_SQL_STATEMENT_CACHE_MAXN     (16)
+#else
+#   define TB_DATABASE_SQL_STATEMENT_CACHE_MAXN     (64)
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
 
+// the database sql batch chunk type
+typedef struct __tb_database_sql_batch_chunk_t
+{
+    // the next chunk
+    struct __tb_database_sql_batch_chunk_t* next;
+
+    // the chunk size
+    tb_size_t                       size;
+
+    // the used size
+    tb_size_t                       used;
+
+}tb_database_sql_batch_chunk_t;
+
+// the database sql batch type
+typedef struct __tb_database_sql_batch_t
+{
+    // the row count
+    tb_size_t                       size;
+
+    // the row maxn
+    tb_size_t                       maxn;
+
+    // the column count
+    tb_size_t                       count;
+
+    // the column maxn
+    tb_size_t                       count_maxn;
+
+    // the columns
+    tb_database_sql_column_t*       columns;
+
+    // the data chunks for copying text and blob
+    tb_database_sql_batch_chunk_t*  chunks;
+
+    // the current chunk
+    tb_database_sql_batch_chunk_t*  chunk;
+
+    // the result for fetching it by iterator
+    tb_iterator_ref_t               result;
+
+    // the result iterator
+    tb_size_t                       result_itor;
+
+}tb_database_sql_batch_t;
+
+// the database sql statement cache entry type
+typedef struct __tb_database_sql_statement_entry_t
+{
+    // the list entry of the lru list
+    tb_list_entry_t                 entry;
+
+    // the statement
+    tb_database_sql_statement_ref_t statement;
+
+    // the sql
+    tb_char_t*                      sql;
+
+}tb_database_sql_statement_entry_t;
+
+// the database sql statement cache type
+typedef struct __tb_database_sql_statement_cache_t
+{
+    // the idle statements: sql => entry
+    tb_hash_map_ref_t               idle;
+
+    // the used statements: statement => entry
+    tb_hash_map_ref_t               used;
+
+    // the lru list of the idle statements, the head is the most recently used
+    tb_list_entry_head_t            lru;
+
+    // the stat
+    tb_database_sql_statement_cache_stat_t stat;
+
+}tb_database_sql_statement_cache_t;
+
 // the database sql impl type
 typedef struct __tb_database_sql_impl_t
 {
@@ -48,6 +144,12 @@ typedef struct __tb_database_sql_impl_t
     // is opened?
     tb_bool_t                       bopened;
 
+    // in transaction?
+    tb_bool_t                       btransaction;
+
+    // the statement cache
+    tb_database_sql_statement_cache_t cache;
+
     // open
     tb_bool_t                       (*open)(struct __tb_database_sql_impl_t* database);
 
@@ -75,6 +177,9 @@ typedef struct __tb_database_sql_impl_t
     // exit result
     tb_void_t                       (*result_exit)(struct __tb_database_sql_impl_t* database, tb_iterator_ref_t result);
 
+    // fetch result to the batch, it will fetch it by the result iterator if be null
+    tb_long_t                       (*result_fetch)(struct __tb_database_sql_impl_t* database, tb_database_sql_batch_t* batch);
+
     // statement init
     tb_database_sql_statement_ref_t (*statement_init)(struct __tb_database_sql_impl_t* database, tb_char_t const* sql);
 
@@ -87,7 +192,40 @@ typedef struct __tb_database_sql_impl_t
     // statement bind
     tb_bool_t                       (*statement_bind)(struct __tb_database_sql_impl_t* database, tb_database_sql_statement_ref_t statement, tb_database_sql_value_t const* list, tb_size_t size);
 
+    // statement reset for reusing it, the statement will not be cached if be null
+    tb_bool_t                       (*statement_reset)(struct __tb_database_sql_impl_t* database, tb_database_sql_statement_ref_t statement);
+
 }tb_database_sql_impl_t;
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/* reset the batch and prepare the columns for fetching
+ *
+ * @param batch                     the batch
+ * @param count                     the column count
+ *
+ * @return                          tb_true or tb_false
+ */
+tb_bool_t                           tb_database_sql_batch_prepare(tb_database_sql_batch_t* batch, tb_size_t count);
+
+/* copy the text or blob data to the batch, it is valid until the next fetching
+ *
+ * @param batch                     the batch
+ * @param data                      the data
+ * @param size                      the size
+ *
+ * @return                          the copied data
+ */
+tb_byte_t const*                    tb_database_sql_batch_copy(tb_database_sql_batch_t* batch, tb_byte_t const* data, tb_size_t size);
+
+/* set the column name of the batch, it will be copied to the batch buffer and be valid until the next fetching
+ *
+ * @param batch                     the batch
+ * @param index                     the column index
+ * @param name                      the column name
+ */
+tb_void_t                           tb_database_sql_batch_name_set(tb_database_sql_batch_t* batch, tb_size_t index, tb_char_t const* name);
 
 #endif
@@ -60,12 +60,21 @@ typedef struct __tb_database_sqlite3_result_t
     // the result
     tb_char_t**                         result;
 
+    // the text data of the result table, the table is made by sqlite3_get_table if be null
+    tb_char_t*                          data;
+
     // the statement
     sqlite3_stmt*                       statement;
 
+    // is the statement owned by the result? it is made by done(sql) and will be finalized after clearing result
+    tb_bool_t                           owned;
+
     // the row count
     tb_size_t                           count;
 
+    // the fetched row count for the batch
+    tb_size_t                           offset;
+
     // the row
     tb_database_sqlite3_result_row_t    row;
 
@@ -349,6 +358,142 @@ static __tb_inline__ tb_database_sqlite3_t* tb_database_sqlite3_cast(tb_database
     // cast
     return (tb_database_sqlite3_t*)database;
 }
+static tb_void_t tb_database_sqlite3_result_clear(tb_database_sqlite3_result_t* result)
+{
+    // check
+    tb_assert_and_check_return(result);
+
+    // exit the result table
+    if (result->result)
+    {
+        if (result->data)
+        {
+            tb_free(result->result);
+            tb_free(result->data);
+        }
+        else sqlite3_free_table(result->result);
+    }
+    result->result = tb_null;
+    result->data = tb_null;
+
+    // finalize the statement of done(sql)
+    if (result->statement && result->owned) sqlite3_finalize(result->statement);
+    result->statement = tb_null;
+    result->owned = tb_false;
+
+    // clear the row and col count
+    result->count = 0;
+    result->offset = 0;
+    result->row.count = 0;
+}
+static tb_bool_t tb_database_sqlite3_result_table(tb_database_sqlite3_t* sqlite)
+{
+    // check
+    tb_database_sqlite3_result_t* result = &sqlite->result;
+    tb_assert_and_check_return_val(result->statement && result->owned && result->row.count, tb_false);
+
+    // done
+    tb_bool_t       ok = tb_false;
+    tb_size_t       count = result->row.count;
+    tb_size_t       rows = 0;
+    tb_size_t       size = 0;
+    tb_size_t       maxn = 0;
+    tb_size_t       offsets_size = 0;
+    tb_size_t       offsets_maxn = 0;
+    tb_size_t*      offsets = tb_null;
+    tb_char_t*      data = tb_null;
+    tb_char_t**     table = tb_null;
+    sqlite3_stmt*   statement = result->statement;
+    tb_int_t        step = SQLITE_ROW;
+    do
+    {
+        // save the names and the text values of all rows, the statement is at the first row now
+        tb_size_t col = 0;
+        tb_bool_t failed = tb_false;
+        for (; step == SQLITE_ROW && !failed; step = sqlite3_step(statement), rows++)
+        {
+            // grow offsets, the names are saved before the first row
+            if (offsets_size + (rows? count : count << 1) > offsets_maxn)
+            {
+                offsets_maxn = (offsets_size + (count << 1)) << 1;
+                offsets = (tb_size_t*)tb_ralloc(offsets, offsets_maxn * sizeof(tb_size_t));
+                tb_assert_and_check_break_state(offsets, failed, tb_true);
+            }
+
+            // save texts
+            tb_size_t i = rows? 1 : 0;
+            for (; i < 2 && !failed; i++)
+            {
+                for (col = 0; col < count; col++)
+                {
+                    // the text, the null value is -1
+                    tb_char_t const* text = i? (tb_char_t const*)sqlite3_column_text(statement, (tb_int_t)col) : sqlite3_column_name(statement, (tb_int_t)col);
+                    if (!text)
+                    {
+                        offsets[offsets_size++] = (tb_size_t)-1;
+                        continue;
+                    }
+
+                    // grow data
+                    tb_size_t n = tb_strlen(text);
+                    if (size + n + 1 > maxn)
+                    {
+                        maxn = (size + n + 1 + 4096) << 1;
+                        data = (tb_char_t*)tb_ralloc(data, maxn);
+                        tb_assert_and_check_break_state(data, failed, tb_true);
+                    }
+
+                    // copy text
+                    tb_memcpy(data + size, text, n + 1);
+                    offsets[offsets_size++] = size;
+                    size += n + 1;
+                }
+            }
+        }
+        tb_check_break(!failed);
+
+        // failed?
+        if (step != SQLITE_DONE)
+        {
+            // save state
+            sqlite->base.state = tb_database_sqlite3_state_from_errno(sqlite3_errcode(sqlite->database));
+
+            // trace
+            tb_trace_e("load: failed, error[%d]: %s", sqlite3_errcode(sqlite->database), sqlite3_errmsg(sqlite->database));
+            break;
+        }
+
+        // make the table like sqlite3_get_table, the names are at the first row
+        table = (tb_char_t**)tb_nalloc(offsets_size, sizeof(tb_char_t*));
+        tb_assert_and_check_break(table);
+        for (col = 0; col < offsets_size; col++)
+            table[col] = offsets[col] != (tb_size_t)-1? data + offsets[col] : tb_null;
+
+        // finalize the statement
+        tb_database_sqlite3_result_clear(result);
+
+        // save the result table
+        result->result      = table;
+        result->data        = data;
+        result->count       = rows;
+        result->row.count   = count;
+        result->itor.mode   = TB_ITERATOR_MODE_RACCESS | TB_ITERATOR_MODE_READONLY;
+        table = tb_null;
+        data = tb_null;
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // exit data
+    if (offsets) tb_free(offsets);
+    if (table) tb_free(table);
+    if (data) tb_free(data);
+
+    // ok?
+    return ok;
+}
 static tb_bool_t tb_database_sqlite3_open(tb_database_sql_impl_t* database)
 {
     // check
@@ -400,8 +545,7 @@ static tb_void_t tb_database_sqlite3_clos(tb_database_sql_impl_t* database)
     tb_assert_and_check_return(sqlite);
 
     // exit result first if exists
-    if (sqlite->result.result) sqlite3_free_table(sqlite->result.result);
-    sqlite->result.result = tb_null;
+    tb_database_sqlite3_result_clear(&sqlite->result);
 
     // close database
     if (sqlite->database) sqlite3_close(sqlite->database);
@@ -482,77 +626,128 @@ static tb_bool_t tb_database_sqlite3_rollback(tb_database_sql_impl_t* database)
     // ok
     return tb_true;
 }
-static tb_bool_t tb_database_sqlite3_done(tb_database_sql_impl_t* database, tb_char_t const* sql)
+static tb_bool_t tb_database_sqlite3_done_table(tb_database_sqlite3_t* sqlite, tb_char_t const* sql)
 {
-    // check
-    tb_database_sqlite3_t* sqlite = tb_database_sqlite3_cast(database);
-    tb_assert_and_check_return_val(sqlite && sqlite->database && sql, tb_false);
+    // done sql
+    tb_int_t    row_count = 0;
+    tb_int_t    col_count = 0;
+    tb_char_t*  error = tb_null;
+    if (SQLITE_OK != sqlite3_get_table(sqlite->database, sql, &sqlite->result.result, &row_count, &col_count, &error))
+    {
+        // save state
+        sqlite->base.state = tb_database_sqlite3_state_from_errno(sqlite3_errcode(sqlite->database));
 
-    // done
-    tb_bool_t ok = tb_false;
-    do
+        // trace
+        tb_trace_e("done: sql: %s failed, error[%d]: %s", sql, sqlite3_errcode(sqlite->database), error);
+
+        // exit error
+        if (error) sqlite3_free(error);
+        return tb_false;
+    }
+
+    // no result?
+    if (!row_count)
     {
-        // exit result first if exists
+        // exit result
         if (sqlite->result.result) sqlite3_free_table(sqlite->result.result);
         sqlite->result.result = tb_null;
+        return tb_true;
+    }
 
-        // clear the lasr statement first
-        sqlite->result.statement = tb_null;
+    // save the result iterator mode
+    sqlite->result.itor.mode = TB_ITERATOR_MODE_RACCESS | TB_ITERATOR_MODE_READONLY;
 
-        // clear the result row count first
-        sqlite->result.count = 0;
+    // save result row count
+    sqlite->result.count = row_count;
 
-        // clear the result col count first
-        sqlite->result.row.count = 0;
+    // save result col count
+    sqlite->result.row.count = col_count;
+    return tb_true;
+}
+static tb_bool_t tb_database_sqlite3_done(tb_database_sql_impl_t* database, tb_char_t const* sql)
+{
+    // check
+    tb_database_sqlite3_t* sqlite = tb_database_sqlite3_cast(database);
+    tb_assert_and_check_return_val(sqlite && sqlite->database && sql, tb_false);
 
-        // done sql
-        tb_int_t    row_count = 0;
-        tb_int_t    col_count = 0;
-        tb_char_t*  error = tb_null;
-        if (SQLITE_OK != sqlite3_get_table(sqlite->database, sql, &sqlite->result.result, &row_count, &col_count, &error))
+    // exit the last result first if exists
+    tb_database_sqlite3_result_clear(&sqlite->result);
+
+    /* done the statements of sql one by one
+     *
+     * the last statement with result is kept at the first row, so we can fetch the typed values of the rows by stepping it,
+     * and the result table of the text values will be loaded only for the result iterator
+     */
+    tb_bool_t           ok = tb_true;
+    tb_char_t const*    tail = sql;
+    while (ok && *tail)
+    {
+        // init statement
+        sqlite3_stmt*       statement = tb_null;
+        tb_char_t const*    next = tb_null;
+        if (SQLITE_OK != sqlite3_prepare_v2(sqlite->database, tail, -1, &statement, &next))
         {
             // save state
             sqlite->base.state = tb_database_sqlite3_state_from_errno(sqlite3_errcode(sqlite->database));
 
             // trace
-            tb_trace_e("done: sql: %s failed, error[%d]: %s", sql, sqlite3_errcode(sqlite->database), error);
+            tb_trace_e("done: sql: %s failed, error[%d]: %s", sql, sqlite3_errcode(sqlite->database), sqlite3_errmsg(sqlite->database));
+            ok = tb_false;
+            break;
+        }
+
+        // no more statements? e.g. spaces or comments
+        tb_check_break(statement);
 
-            // exit error
-            if (error) sqlite3_free(error);
+        // the statement has result and it is not the last one? done the remaining sql by the result table
+        tb_char_t const* p = next;
+        while (tb_isspace(*p)) p++;
+        tb_size_t col_count = sqlite3_column_count(statement);
+        if (col_count && *p)
+        {
+            sqlite3_finalize(statement);
+            ok = tb_database_sqlite3_done_table(sqlite, tail);
             break;
         }
 
-        // no result?
-        if (!row_count)
+        // step statement
+        tb_int_t result = sqlite3_step(statement);
+        if (result == SQLITE_ROW && col_count)
         {
-            // exit result
-            if (sqlite->result.result) sqlite3_free_table(sqlite->result.result);
-            sqlite->result.result = tb_null;
+            // save the result iterator mode
+            sqlite->result.itor.mode = TB_ITERATOR_MODE_FORWARD | TB_ITERATOR_MODE_READONLY;
 
-            // trace
-            tb_trace_d("done: sql: %s: ok", sql);
+            // save statement for fetching rows
+            sqlite->result.statement = statement;
+            sqlite->result.owned = tb_true;
+
+            // save result row count
+            sqlite->result.count = (tb_size_t)-1;
 
-            // ok
-            ok = tb_true;
+            // save result col count
+            sqlite->result.row.count = col_count;
             break;
         }
 
-        // save the result iterator mode
-        sqlite->result.itor.mode = TB_ITERATOR_MODE_RACCESS | TB_ITERATOR_MODE_READONLY;
-
-        // save result row count
-        sqlite->result.count = row_count;
-
-        // save result col count
-        sqlite->result.row.count = col_count;
+        // skip the other rows, e.g. pragma
+        while (result == SQLITE_ROW) result = sqlite3_step(statement);
+        if (result != SQLITE_DONE)
+        {
+            // save state
+            sqlite->base.state = tb_database_sqlite3_state_from_errno(sqlite3_errcode(sqlite->database));
 
-        // trace
-        tb_trace_d("done: sql: %s: ok", sql);
+            // trace
+            tb_trace_e("done: sql: %s failed, error[%d]: %s", sql, sqlite3_errcode(sqlite->database), sqlite3_errmsg(sqlite->database));
+            ok = tb_false;
+        }
 
-        // ok
-        ok = tb_true;
+        // exit statement
+        sqlite3_finalize(statement);
+        tail = next;
+    }
 
-    } while (0);
+    // trace
+    if (ok) tb_trace_d("done: sql: %s: ok", sql);
 
     // ok?
     return ok;
@@ -564,15 +759,7 @@ static tb_void_t tb_database_sqlite3_result_exit(tb_database_sql_impl_t* databas
     tb_assert_and_check_return(sqlite3_result);
 
     // exit result
-    if (sqlite3_result->result) sqlite3_free_table(sqlite3_result->result);
-    sqlite3_result->result = tb_null;
-
-    // clear the statement
-    sqlite3_result->statement = tb_null;
-
-    // clear result
-    sqlite3_result->count = 0;
-    sqlite3_result->row.count = 0;
+    tb_database_sqlite3_result_clear(sqlite3_result);
 }
 static tb_iterator_ref_t tb_database_sqlite3_result_load(tb_database_sql_impl_t* database, tb_bool_t try_all)
 {
@@ -580,14 +767,161 @@ static tb_iterator_ref_t tb_database_sqlite3_result_load(tb_database_sql_impl_t*
     tb_database_sqlite3_t* sqlite = tb_database_sqlite3_cast(database);
     tb_assert_and_check_return_val(sqlite && sqlite->database, tb_null);
 
+    // load the result table of done(sql), the values of the result iterator are always the texts for it
+    if (sqlite->result.statement && sqlite->result.owned && !tb_database_sqlite3_result_table(sqlite)) return tb_null;
+
     // ok?
     return (sqlite->result.result || sqlite->result.statement)? (tb_iterator_ref_t)&sqlite->result : tb_null;
 }
+static tb_long_t tb_database_sqlite3_result_fetch(tb_database_sql_impl_t* database, tb_database_sql_batch_t* batch)
+{
+    // check
+    tb_database_sqlite3_t* sqlite = tb_database_sqlite3_cast(database);
+    tb_assert_and_check_return_val(sqlite && sqlite->database && batch, -1);
+
+    // the result
+    tb_database_sqlite3_result_t* result = &sqlite->result;
+
+    // no more rows?
+    tb_check_return_val((result->result && result->offset < result->count) || result->statement, 0);
+
+    // prepare columns
+    tb_size_t count = result->row.count;
+    if (!tb_database_sql_batch_prepare(batch, count)) return -1;
+
+    // the table result of the multiple statements? the text values are referenced directly and be valid until the next query
+    tb_size_t col;
+    if (result->result)
+    {
+        // set column names
+        for (col = 0; col < count; col++)
+            tb_database_sql_batch_name_set(batch, col, result->result[col]);
+
+        // fetch rows
+        tb_size_t row;
+        tb_size_t size = tb_min(result->count - result->offset, batch->maxn);
+        for (row = 0; row < size; row++)
+        {
+            tb_char_t const** values = (tb_char_t const**)result->result + (1 + result->offset + row) * count;
+            for (col = 0; col < count; col++)
+            {
+                tb_database_sql_column_t* column = &batch->columns[col];
+                if (values[col])
+                {
+                    column->types[row] = TB_DATABASE_SQL_VALUE_TYPE_TEXT;
+                    column->datas[row] = (tb_byte_t const*)values[col];
+                    column->sizes[row] = (tb_uint32_t)tb_strlen(values[col]);
+                }
+                else column->types[row] = TB_DATABASE_SQL_VALUE_TYPE_NULL;
+            }
+        }
+        result->offset += size;
+        batch->size = size;
+    }
+    // the statement result? the values will be changed after stepping, so we copy them to the batch
+    else
+    {
+        // set column names
+        sqlite3_stmt* statement = result->statement;
+        for (col = 0; col < count; col++)
+            tb_database_sql_batch_name_set(batch, col, sqlite3_column_name(statement, (tb_int_t)col));
+
+        // fetch rows, the statement is at the current row now
+        tb_int_t ok = SQLITE_ROW;
+        while (batch->size < batch->maxn && ok == SQLITE_ROW)
+        {
+            tb_size_t row = batch->size;
+            for (col = 0; col < count; col++)
+            {
+                tb_database_sql_column_t* column = &batch->columns[col];
+                switch (sqlite3_column_type(statement, (tb_int_t)col))
+                {
+                case SQLITE_INTEGER:
+                    column->types[row] = TB_DATABASE_SQL_VALUE_TYPE_INT64;
+                    column->ints[row] = sqlite3_column_int64(statement, (tb_int_t)col);
+                    break;
+#ifdef TB_CONFIG_TYPE_HAVE_FLOAT
+                case SQLITE_FLOAT:
+                    column->types[row] = TB_DATABASE_SQL_VALUE_TYPE_DOUBLE;
+                    column->reals[row] = sqlite3_column_double(statement, (tb_int_t)col);
+                    break;
+#endif
+                case SQLITE_TEXT:
+                case SQLITE_BLOB:
+                    {
+                        // copy data
+                        tb_bool_t           text = sqlite3_column_type(statement, (tb_int_t)col) == SQLITE_TEXT;
+                        tb_byte_t const*    data = text? (tb_byte_t const*)sqlite3_column_text(statement, (tb_int_t)col) : (tb_byte_t const*)sqlite3_column_blob(statement, (tb_int_t)col);
+                        tb_size_t           size = sqlite3_column_bytes(statement, (tb_int_t)col);
+                        column->types[row] = text? TB_DATABASE_SQL_VALUE_TYPE_TEXT : TB_DATABASE_SQL_VALUE_TYPE_BLOB32;
+                        column->datas[row] = tb_database_sql_batch_copy(batch, data, size);
+                        column->sizes[row] = (tb_uint32_t)size;
+                        tb_assert_and_check_return_val(column->datas[row], -1);
+                    }
+                    break;
+                default:
+                    column->types[row] = TB_DATABASE_SQL_VALUE_TYPE_NULL;
+                    break;
+                }
+            }
+            batch->size++;
+
+            // step to the next row
+            ok = sqlite3_step(statement);
+        }
+
+        // end?
+        if (ok != SQLITE_ROW)
+        {
+            // clear the statement result
+            tb_bool_t owned = result->owned;
+            result->statement = tb_null;
+            result->owned = tb_false;
+            result->count = 0;
+            result->row.count = 0;
+
+            // finalize the statement of done(sql) or reset the statement
+            if ((owned? sqlite3_finalize(statement) : sqlite3_reset(statement)) != SQLITE_OK || ok != SQLITE_DONE)
+            {
+                // save state
+                sqlite->base.state = tb_database_sqlite3_state_from_errno(sqlite3_errcode(sqlite->database));
+
+                // trace
+                tb_trace_e("fetch: failed, error[%d]: %s", sqlite3_errcode(sqlite->database), sqlite3_errmsg(sqlite->database));
+                return -1;
+            }
+        }
+    }
+
+    // ok
+    return batch->size;
+}
 static tb_void_t tb_database_sqlite3_statement_exit(tb_database_sql_impl_t* database, tb_database_sql_statement_ref_t statement)
 {
+    // clear the statement result
+    tb_database_sqlite3_t* sqlite = tb_database_sqlite3_cast(database);
+    if (sqlite && statement && sqlite->result.statement == (sqlite3_stmt*)statement)
+        tb_database_sqlite3_result_exit(database, (tb_iterator_ref_t)&sqlite->result);
+
     // exit statement
     if (statement) sqlite3_finalize((sqlite3_stmt*)statement);
 }
+static tb_bool_t tb_database_sqlite3_statement_reset(tb_database_sql_impl_t* database, tb_database_sql_statement_ref_t statement)
+{
+    // check
+    tb_database_sqlite3_t* sqlite = tb_database_sqlite3_cast(database);
+    tb_assert_and_check_return_val(sqlite && sqlite->database && statement, tb_false);
+
+    // clear the statement result
+    if (sqlite->result.statement == (sqlite3_stmt*)statement)
+        tb_database_sqlite3_result_exit(database, (tb_iterator_ref_t)&sqlite->result);
+
+    // reset it, the error of the last step will be returned again and we need not it
+    sqlite3_reset((sqlite3_stmt*)statement);
+
+    // clear the bound arguments
+    return sqlite3_clear_bindings((sqlite3_stmt*)statement) == SQLITE_OK;
+}
 static tb_database_sql_statement_ref_t tb_database_sqlite3_statement_init(tb_database_sql_impl_t* database, tb_char_t const* sql)
 {
     // check
@@ -618,18 +952,8 @@ static tb_bool_t tb_database_sqlite3_statement_done(tb_database_sql_impl_t* data
     tb_bool_t ok = tb_false;
     do
     {
-        // exit result first if exists
-        if (sqlite->result.result) sqlite3_free_table(sqlite->result.result);
-        sqlite->result.result = tb_null;
-
-        // clear the last statement first
-        sqlite->result.statement = tb_null;
-
-        // clear the result row count first
-        sqlite->result.count = 0;
-
-        // clear the result col count first
-        sqlite->result.row.count = 0;
+        // exit the last result first if exists
+        tb_database_sqlite3_result_clear(&sqlite->result);
 
         // step statement
         tb_int_t result = sqlite3_step((sqlite3_stmt*)statement);
@@ -705,7 +1029,6 @@ static tb_bool_t tb_database_sqlite3_statement_bind(tb_database_sql_impl_t* data
         switch (value->type)
         {
         case TB_DATABASE_SQL_VALUE_TYPE_TEXT:
-            tb_trace_i("sqlite3: test %lu %s", i, value->u.text.data);
             ok = sqlite3_bind_text((sqlite3_stmt*)statement, (tb_int_t)(i + 1), value->u.text.data, (tb_int_t)tb_database_sql_value_size(value), tb_null);
             break;
         case TB_DATABASE_SQL_VALUE_TYPE_INT64:
@@ -872,10 +1195,12 @@ tb_database_sql_ref_t tb_database_sqlite3_init(tb_url_ref_t url)
         sqlite->base.rollback       = tb_database_sqlite3_rollback;
         sqlite->base.result_load    = tb_database_sqlite3_result_load;
         sqlite->base.result_exit    = tb_database_sqlite3_result_exit;
+        sqlite->base.result_fetch   = tb_database_sqlite3_result_fetch;
         sqlite->base.statement_init = tb_database_sqlite3_statement_init;
         sqlite->base.statement_exit = tb_database_sqlite3_statement_exit;
         sqlite->base.statement_done = tb_database_sqlite3_statement_done;
         sqlite->base.statement_bind = tb_database_sqlite3_statement_bind;
+        sqlite->base.statement_reset = tb_database_sqlite3_statement_reset;
 
         // init row operation
         static tb_iterator_op_t row_op =
@@ -0,0 +1,495 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        pool.c
+ * @ingroup     database
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "database_pool"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "pool.h"
+#include "impl/prefix.h"
+#include "../algorithm/algorithm.h"
+#include "../platform/time.h"
+#include "../platform/spinlock.h"
+#include "../platform/semaphore.h"
+#if defined(TB_CONFIG_MODULE_HAVE_COROUTINE) \
+        && !defined(TB_CONFIG_MICRO_ENABLE)
+#   include "../coroutine/coroutine.h"
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the default connection maxn
+#ifdef __tb_small__
+#   define TB_DATABASE_SQL_POOL_MAXN                (4)
+#else
+#   define TB_DATABASE_SQL_POOL_MAXN                (16)
+#endif
+
+// the default idle timeout (ms)
+#define TB_DATABASE_SQL_POOL_IDLE_TIMEOUT           (60000)
+
+// the idle time (ms) for checking the connection before reusing it
+#define TB_DATABASE_SQL_POOL_CHECK_INTERVAL         (5000)
+
+// the max sleep time (ms) for waiting the free connection in coroutine
+#define TB_DATABASE_SQL_POOL_SLEEP_MAXN             (16)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the database sql pool connection type
+typedef struct __tb_database_sql_pool_conn_t
+{
+    // the list entry of the idle list
+    tb_list_entry_t                 entry;
+
+    // the database
+    tb_database_sql_ref_t           database;
+
+    // the last used time
+    tb_hong_t                       time;
+
+    // need check it before reusing it?
+    tb_bool_t                       bcheck;
+
+    // the last statement cache stat
+    tb_hize_t                       statement_hits;
+    tb_hize_t                       statement_misses;
+
+}tb_database_sql_pool_conn_t;
+
+// the database sql pool type
+typedef struct __tb_database_sql_pool_t
+{
+    // the url
+    tb_char_t*                      url;
+
+    // the connection maxn
+    tb_size_t                       maxn;
+
+    // the idle timeout
+    tb_long_t                       idle_timeout;
+
+    // the lock
+    tb_spinlock_t                   lock;
+
+    // the free connection count
+    tb_semaphore_ref_t              semaphore;
+
+    // all connections: database => conn
+    tb_hash_map_ref_t               conns;
+
+    // the idle connections, the head is the most recently used
+    tb_list_entry_head_t            idle;
+
+    // the stat
+    tb_database_sql_pool_stat_t     stat;
+
+}tb_database_sql_pool_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_void_t tb_database_sql_pool_conn_exit(tb_database_sql_pool_conn_t* conn)
+{
+    // exit database
+    if (conn->database)
+    {
+        tb_database_sql_clos(conn->database);
+        tb_database_sql_exit(conn->database);
+    }
+    tb_free(conn);
+}
+static tb_database_sql_pool_conn_t* tb_database_sql_pool_conn_open(tb_database_sql_pool_t* pool)
+{
+    // make connection
+    tb_database_sql_pool_conn_t* conn = tb_malloc0_type(tb_database_sql_pool_conn_t);
+    tb_assert_and_check_return_val(conn, tb_null);
+
+    // init and open database
+    conn->database = tb_database_sql_init(pool->url);
+    if (!conn->database || !tb_database_sql_open(conn->database))
+    {
+        // trace
+        tb_trace_e("open %s failed: %s", pool->url, conn->database? tb_state_cstr(tb_database_sql_state(conn->database)) : "unknown");
+
+        // exit it
+        tb_database_sql_pool_conn_exit(conn);
+        return tb_null;
+    }
+
+    // save it
+    tb_bool_t ok = tb_false;
+    tb_spinlock_enter(&pool->lock);
+    if (tb_hash_map_insert(pool->conns, conn->database, conn))
+    {
+        pool->stat.size++;
+        pool->stat.opened++;
+        ok = tb_true;
+    }
+    tb_spinlock_leave(&pool->lock);
+
+    // failed?
+    if (!ok)
+    {
+        tb_database_sql_pool_conn_exit(conn);
+        conn = tb_null;
+    }
+    return conn;
+}
+static tb_void_t tb_database_sql_pool_conn_remove(tb_database_sql_pool_t* pool, tb_database_sql_pool_conn_t* conn)
+{
+    // remove it, the lock must be entered
+    tb_hash_map_remove(pool->conns, conn->database);
+    pool->stat.size--;
+    pool->stat.closed++;
+}
+static tb_bool_t tb_database_sql_pool_conn_check(tb_database_sql_pool_conn_t* conn)
+{
+    // ping it
+    tb_bool_t ok = tb_database_sql_done(conn->database, "select 1");
+
+    // trace
+    tb_trace_d("check: %p: %s", conn->database, ok? "ok" : "no");
+
+    // ok?
+    return ok;
+}
+static tb_size_t tb_database_sql_pool_reap_idle(tb_database_sql_pool_t* pool, tb_list_entry_head_ref_t reaped, tb_hong_t now)
+{
+    // never reap it?
+    tb_check_return_val(pool->idle_timeout >= 0, 0);
+
+    // move the expired connections to the reaped list, the lock must be entered
+    tb_size_t count = 0;
+    while (tb_list_entry_size(&pool->idle))
+    {
+        // the least recently used connection
+        tb_database_sql_pool_conn_t* conn = (tb_database_sql_pool_conn_t*)tb_list_entry(&pool->idle, tb_list_entry_last(&pool->idle));
+        tb_check_break(now - conn->time >= pool->idle_timeout);
+
+        // remove it
+        tb_list_entry_remove_last(&pool->idle);
+        tb_database_sql_pool_conn_remove(pool, conn);
+        tb_list_entry_insert_tail(reaped, &conn->entry);
+        count++;
+    }
+    return count;
+}
+static tb_void_t tb_database_sql_pool_reap_exit(tb_list_entry_head_ref_t reaped)
+{
+    // close the reaped connections
+    while (tb_list_entry_size(reaped))
+    {
+        tb_database_sql_pool_conn_t* conn = (tb_database_sql_pool_conn_t*)tb_list_entry(reaped, tb_list_entry_head(reaped));
+        tb_list_entry_remove_head(reaped);
+
+        // trace
+        tb_trace_d("reap: %p", conn->database);
+
+        // exit it
+        tb_database_sql_pool_conn_exit(conn);
+    }
+}
+static tb_long_t tb_database_sql_pool_wait(tb_database_sql_pool_t* pool, tb_long_t timeout)
+{
+#if defined(TB_CONFIG_MODULE_HAVE_COROUTINE) \
+        && !defined(TB_CONFIG_MICRO_ENABLE)
+    // wait it in coroutine? we cannot block the scheduler thread
+    if (tb_coroutine_self())
+    {
+        tb_long_t ok = 0;
+        tb_size_t delay = 1;
+        tb_hong_t time = tb_mclock();
+        while (!(ok = tb_semaphore_wait(pool->semaphore, 0)))
+        {
+            // timeout?
+            if (timeout >= 0 && tb_mclock() - time >= timeout) break;
+
+            // sleep it and let other coroutines run
+            tb_msleep(delay);
+            if (delay < TB_DATABASE_SQL_POOL_SLEEP_MAXN) delay <<= 1;
+        }
+        return ok;
+    }
+#endif
+
+    // wait it
+    return tb_semaphore_wait(pool->semaphore, timeout);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_database_sql_pool_ref_t tb_database_sql_pool_init(tb_char_t const* url, tb_size_t maxn, tb_long_t idle_timeout)
+{
+    // check
+    tb_assert_and_check_return_val(url, tb_null);
+
+    // done
+    tb_bool_t               ok = tb_false;
+    tb_database_sql_pool_t* pool = tb_null;
+    do
+    {
+        // make pool
+        pool = tb_malloc0_type(tb_database_sql_pool_t);
+        tb_assert_and_check_break(pool);
+
+        // init pool
+        pool->maxn          = maxn? maxn : TB_DATABASE_SQL_POOL_MAXN;
+        pool->idle_timeout  = idle_timeout? idle_timeout : TB_DATABASE_SQL_POOL_IDLE_TIMEOUT;
+        pool->url           = tb_strdup(url);
+        tb_assert_and_check_break(pool->url);
+
+        // init lock
+        if (!tb_spinlock_init(&pool->lock)) break;
+
+        // init semaphore
+        pool->semaphore = tb_semaphore_init(pool->maxn);
+        tb_assert_and_check_break(pool->semaphore);
+
+        // init connections
+        pool->conns = tb_hash_map_init(TB_HASH_MAP_BUCKET_SIZE_MICRO, tb_element_ptr(tb_null, tb_null), tb_element_ptr(tb_null, tb_null));
+        tb_assert_and_check_break(pool->conns);
+
+        // init idle list
+        tb_list_entry_init(&pool->idle, tb_database_sql_pool_conn_t, entry, tb_null);
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        if (pool) tb_database_sql_pool_exit((tb_database_sql_pool_ref_t)pool);
+        pool = tb_null;
+    }
+
+    // ok?
+    return (tb_database_sql_pool_ref_t)pool;
+}
+tb_void_t tb_database_sql_pool_exit(tb_database_sql_pool_ref_t self)
+{
+    // check
+    tb_database_sql_pool_t* pool = (tb_database_sql_pool_t*)self;
+    tb_assert_and_check_return(pool);
+
+    // exit all connections
+    if (pool->conns)
+    {
+        // check
+        tb_assertf(tb_list_entry_size(&pool->idle) == tb_hash_map_size(pool->conns), "%lu connections are not checked in!", tb_hash_map_size(pool->conns) - tb_list_entry_size(&pool->idle));
+
+        // exit them
+        tb_for_all_if (tb_hash_map_item_ref_t, item, pool->conns, item)
+            tb_database_sql_pool_conn_exit((tb_database_sql_pool_conn_t*)item->data);
+        tb_hash_map_exit(pool->conns);
+        pool->conns = tb_null;
+    }
+
+    // exit semaphore
+    if (pool->semaphore) tb_semaphore_exit(pool->semaphore);
+    pool->semaphore = tb_null;
+
+    // exit lock
+    tb_spinlock_exit(&pool->lock);
+
+    // exit url
+    if (pool->url) tb_free(pool->url);
+    pool->url = tb_null;
+
+    // exit it
+    tb_free(pool);
+}
+tb_database_sql_ref_t tb_database_sql_pool_checkout(tb_database_sql_pool_ref_t self, tb_long_t timeout)
+{
+    // check
+    tb_database_sql_pool_t* pool = (tb_database_sql_pool_t*)self;
+    tb_assert_and_check_return_val(pool && pool->semaphore, tb_null);
+
+    // attempt to get a free connection without waiting
+    tb_bool_t waited = tb_false;
+    tb_hong_t wait_time = 0;
+    tb_long_t ok = tb_semaphore_wait(pool->semaphore, 0);
+    if (!ok && timeout)
+    {
+        // wait the free connection
+        waited = tb_true;
+        wait_time = tb_mclock();
+        ok = tb_database_sql_pool_wait(pool, timeout);
+        wait_time = tb_mclock() - wait_time;
+    }
+
+    // update stat
+    tb_spinlock_enter(&pool->lock);
+    if (waited)
+    {
+        pool->stat.waits++;
+        pool->stat.wait_time += wait_time;
+        if (wait_time > pool->stat.wait_maxn) pool->stat.wait_maxn = wait_time;
+    }
+    if (ok <= 0) pool->stat.timeouts++;
+    tb_spinlock_leave(&pool->lock);
+
+    // timeout or failed?
+    if (ok <= 0)
+    {
+        // trace
+        tb_trace_d("checkout: timeout after %lld ms", wait_time);
+        return tb_null;
+    }
+
+    // get an idle connection
+    tb_database_sql_pool_conn_t* conn = tb_null;
+    while (1)
+    {
+        // pop the most recently used connection
+        tb_spinlock_enter(&pool->lock);
+        if (tb_list_entry_size(&pool->idle))
+        {
+            conn = (tb_database_sql_pool_conn_t*)tb_list_entry(&pool->idle, tb_list_entry_head(&pool->idle));
+            tb_list_entry_remove_head(&pool->idle);
+        }
+        tb_spinlock_leave(&pool->lock);
+        tb_check_break(conn);
+
+        // check it if it was failed or has been idle for a while
+        if (!conn->bcheck && tb_mclock() - conn->time < TB_DATABASE_SQL_POOL_CHECK_INTERVAL) break;
+        if (tb_database_sql_pool_conn_check(conn))
+        {
+            conn->bcheck = tb_false;
+            break;
+        }
+
+        // remove the broken connection
+        tb_spinlock_enter(&pool->lock);
+        tb_database_sql_pool_conn_remove(pool, conn);
+        tb_spinlock_leave(&pool->lock);
+        tb_database_sql_pool_conn_exit(conn);
+        conn = tb_null;
+    }
+
+    // open a new connection if no idle connections
+    if (!conn) conn = tb_database_sql_pool_conn_open(pool);
+
+    // failed? release the free connection
+    if (!conn)
+    {
+        tb_semaphore_post(pool->semaphore, 1);
+        return tb_null;
+    }
+
+    // update stat
+    tb_spinlock_enter(&pool->lock);
+    pool->stat.checkouts++;
+    tb_spinlock_leave(&pool->lock);
+
+    // trace
+    tb_trace_d("checkout: %p", conn->database);
+
+    // ok
+    return conn->database;
+}
+tb_void_t tb_database_sql_pool_checkin(tb_database_sql_pool_ref_t self, tb_database_sql_ref_t database)
+{
+    // check
+    tb_database_sql_pool_t*  pool = (tb_database_sql_pool_t*)self;
+    tb_database_sql_impl_t*  impl = (tb_database_sql_impl_t*)database;
+    tb_assert_and_check_return(pool && impl);
+
+    // get the connection
+    tb_spinlock_enter(&pool->lock);
+    tb_database_sql_pool_conn_t* conn = (tb_database_sql_pool_conn_t*)tb_hash_map_get(pool->conns, database);
+    tb_spinlock_leave(&pool->lock);
+    tb_assertf_and_check_return(conn, "unknown connection: %p", database);
+
+    // rollback the uncommitted transaction
+    if (impl->btransaction && !tb_database_sql_rollback(database)) conn->bcheck = tb_true;
+
+    // failed? check it before reusing it
+    if (tb_database_sql_state(database) != TB_STATE_OK) conn->bcheck = tb_true;
+
+    // get the statement cache stat
+    tb_database_sql_statement_cache_stat_t cache;
+    tb_database_sql_statement_cache_stat(database, &cache);
+
+    // checkin it and reap the expired idle connections
+    tb_list_entry_head_t reaped;
+    tb_list_entry_init(&reaped, tb_database_sql_pool_conn_t, entry, tb_null);
+    tb_hong_t now = tb_mclock();
+    tb_spinlock_enter(&pool->lock);
+    pool->stat.statement_hits += cache.hits - conn->statement_hits;
+    pool->stat.statement_misses += cache.misses - conn->statement_misses;
+    conn->statement_hits = cache.hits;
+    conn->statement_misses = cache.misses;
+    conn->time = now;
+    tb_list_entry_insert_head(&pool->idle, &conn->entry);
+    tb_database_sql_pool_reap_idle(pool, &reaped, now);
+    tb_spinlock_leave(&pool->lock);
+
+    // release the free connection
+    tb_semaphore_post(pool->semaphore, 1);
+
+    // close the reaped connections
+    tb_database_sql_pool_reap_exit(&reaped);
+
+    // trace
+    tb_trace_d("checkin: %p", database);
+}
+tb_size_t tb_database_sql_pool_reap(tb_database_sql_pool_ref_t self)
+{
+    // check
+    tb_database_sql_pool_t* pool = (tb_database_sql_pool_t*)self;
+    tb_assert_and_check_return_val(pool, 0);
+
+    // reap the expired idle connections
+    tb_list_entry_head_t reaped;
+    tb_list_entry_init(&reaped, tb_database_sql_pool_conn_t, entry, tb_null);
+    tb_spinlock_enter(&pool->lock);
+    tb_size_t count = tb_database_sql_pool_reap_idle(pool, &reaped, tb_mclock());
+    tb_spinlock_leave(&pool->lock);
+
+    // close them
+    tb_database_sql_pool_reap_exit(&reaped);
+    return count;
+}
+tb_void_t tb_database_sql_pool_stat(tb_database_sql_pool_ref_t self, tb_database_sql_pool_stat_t* stat)
+{
+    // check
+    tb_database_sql_pool_t* pool = (tb_database_sql_pool_t*)self;
+    tb_assert_and_check_return(pool && stat);
+
+    // get stat
+    tb_spinlock_enter(&pool->lock);
+    *stat = pool->stat;
+    stat->idle = tb_list_entry_size(&pool->idle);
+    tb_spinlock_leave(&pool->lock);
+}
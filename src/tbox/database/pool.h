@@ -0,0 +1,159 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        pool.h
+ * @ingroup     database
+ */
+#ifndef TB_DATABASE_POOL_H
+#define TB_DATABASE_POOL_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "sql.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the database sql pool ref type
+typedef __tb_typeref__(database_sql_pool);
+
+/// the database sql pool stat type
+typedef struct __tb_database_sql_pool_stat_t
+{
+    /// the opened connection count
+    tb_size_t                       size;
+
+    /// the idle connection count
+    tb_size_t                       idle;
+
+    /// the checkout count
+    tb_hize_t                       checkouts;
+
+    /// the checkout count which has been waited for the free connection
+    tb_hize_t                       waits;
+
+    /// the timeout count of the checkout
+    tb_hize_t                       timeouts;
+
+    /// the total wait time (ms)
+    tb_hong_t                       wait_time;
+
+    /// the max wait time (ms)
+    tb_hong_t                       wait_maxn;
+
+    /// the opened count of the connection
+    tb_hize_t                       opened;
+
+    /// the closed count of the connection by the health check, reaping and failure
+    tb_hize_t                       closed;
+
+    /// the hit count of the statement cache of all connections
+    tb_hize_t                       statement_hits;
+
+    /// the missed count of the statement cache of all connections
+    tb_hize_t                       statement_misses;
+
+}tb_database_sql_pool_stat_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init the database connection pool
+ *
+ * the pool is thread-safe and the checkout will sleep in the coroutine instead of blocking the thread
+ *
+ * @code
+    tb_database_sql_pool_ref_t pool = tb_database_sql_pool_init("/tmp/test.sqlite3", 8, 0);
+    if (pool)
+    {
+        tb_database_sql_ref_t database = tb_database_sql_pool_checkout(pool, 1000);
+        if (database)
+        {
+            tb_database_sql_done(database, "select * from table1");
+            // ...
+            tb_database_sql_pool_checkin(pool, database);
+        }
+        tb_database_sql_pool_exit(pool);
+    }
+ * @endcode
+ *
+ * @param url                       the database url
+ * @param maxn                      the connection maxn, using the default maxn if be zero
+ * @param idle_timeout              the idle timeout (ms) for closing the unused connection,
+ *                                  using the default timeout if be zero and never close it if be -1
+ *
+ * @return                          the pool
+ */
+tb_database_sql_pool_ref_t          tb_database_sql_pool_init(tb_char_t const* url, tb_size_t maxn, tb_long_t idle_timeout);
+
+/*! exit the pool, all connections must be checked in
+ *
+ * @param pool                      the pool
+ */
+tb_void_t                           tb_database_sql_pool_exit(tb_database_sql_pool_ref_t pool);
+
+/*! checkout an opened connection from the pool
+ *
+ * the idle connection will be checked before returning it if it was failed or has been idle for a while,
+ * and it will wait for the free connection if the pool is full.
+ *
+ * @param pool                      the pool
+ * @param timeout                   the timeout (ms), infinity: -1
+ *
+ * @return                          the database, tb_null if timeout or failed
+ */
+tb_database_sql_ref_t               tb_database_sql_pool_checkout(tb_database_sql_pool_ref_t pool, tb_long_t timeout);
+
+/*! checkin the connection to the pool
+ *
+ * the uncommitted transaction will be rolled back
+ *
+ * @param pool                      the pool
+ * @param database                  the database
+ */
+tb_void_t                           tb_database_sql_pool_checkin(tb_database_sql_pool_ref_t pool, tb_database_sql_ref_t database);
+
+/*! close the idle connections which have been unused for the idle timeout
+ *
+ * @param pool                      the pool
+ *
+ * @return                          the closed connection count
+ */
+tb_size_t                           tb_database_sql_pool_reap(tb_database_sql_pool_ref_t pool);
+
+/*! get the pool stat
+ *
+ * @param pool                      the pool
+ * @param stat                      the stat
+ */
+tb_void_t                           tb_database_sql_pool_stat(tb_database_sql_pool_ref_t pool, tb_database_sql_pool_stat_t* stat);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -30,6 +30,182 @@
  */
 #include "sql.h"
 #include "impl/prefix.h"
+#include "../algorithm/algorithm.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_void_t tb_database_sql_statement_entry_exit(tb_database_sql_statement_entry_t* entry)
+{
+    // exit it
+    if (entry->sql) tb_free(entry->sql);
+    tb_free(entry);
+}
+static tb_void_t tb_database_sql_statement_cache_evict(tb_database_sql_impl_t* impl, tb_size_t maxn)
+{
+    // evict the least recently used statements
+    tb_database_sql_statement_cache_t* cache = &impl->cache;
+    while (tb_list_entry_size(&cache->lru) > maxn)
+    {
+        // remove the last entry
+        tb_database_sql_statement_entry_t* entry = (tb_database_sql_statement_entry_t*)tb_list_entry(&cache->lru, tb_list_entry_last(&cache->lru));
+        tb_list_entry_remove_last(&cache->lru);
+        tb_hash_map_remove(cache->idle, entry->sql);
+
+        // trace
+        tb_trace_d("statement: evict %s", entry->sql);
+
+        // exit statement
+        impl->statement_exit(impl, entry->statement);
+        tb_database_sql_statement_entry_exit(entry);
+        cache->stat.evictions++;
+    }
+}
+static tb_void_t tb_database_sql_statement_cache_clear(tb_database_sql_impl_t* impl)
+{
+    // exit all idle statements
+    tb_database_sql_statement_cache_t* cache = &impl->cache;
+    if (cache->idle) tb_database_sql_statement_cache_evict(impl, 0);
+
+    // forget all used statements, they will be exited directly
+    if (cache->used)
+    {
+        tb_for_all_if (tb_hash_map_item_ref_t, item, cache->used, item)
+            tb_database_sql_statement_entry_exit((tb_database_sql_statement_entry_t*)item->data);
+        tb_hash_map_clear(cache->used);
+    }
+}
+static tb_void_t tb_database_sql_statement_cache_exit(tb_database_sql_impl_t* impl)
+{
+    // clear cache first
+    tb_database_sql_statement_cache_clear(impl);
+
+    // exit maps
+    tb_database_sql_statement_cache_t* cache = &impl->cache;
+    if (cache->idle) tb_hash_map_exit(cache->idle);
+    cache->idle = tb_null;
+    if (cache->used) tb_hash_map_exit(cache->used);
+    cache->used = tb_null;
+}
+static tb_bool_t tb_database_sql_statement_cache_init(tb_database_sql_impl_t* impl)
+{
+    // inited?
+    tb_database_sql_statement_cache_t* cache = &impl->cache;
+    tb_check_return_val(!cache->idle, tb_true);
+
+    // init maps
+    cache->idle = tb_hash_map_init(TB_HASH_MAP_BUCKET_SIZE_MICRO, tb_element_str(tb_true), tb_element_ptr(tb_null, tb_null));
+    cache->used = tb_hash_map_init(TB_HASH_MAP_BUCKET_SIZE_MICRO, tb_element_ptr(tb_null, tb_null), tb_element_ptr(tb_null, tb_null));
+    if (!cache->idle || !cache->used)
+    {
+        tb_database_sql_statement_cache_exit(impl);
+        return tb_false;
+    }
+
+    // init lru list
+    tb_list_entry_init(&cache->lru, tb_database_sql_statement_entry_t, entry, tb_null);
+    return tb_true;
+}
+static tb_void_t tb_database_sql_batch_set_value(tb_database_sql_batch_t* batch, tb_size_t col, tb_database_sql_value_t const* value)
+{
+    // the column and row
+    tb_size_t                   row = batch->size;
+    tb_database_sql_column_t*   column = &batch->columns[col];
+
+    // set value
+    switch (value->type)
+    {
+    case TB_DATABASE_SQL_VALUE_TYPE_INT8:
+    case TB_DATABASE_SQL_VALUE_TYPE_INT16:
+    case TB_DATABASE_SQL_VALUE_TYPE_INT32:
+    case TB_DATABASE_SQL_VALUE_TYPE_INT64:
+    case TB_DATABASE_SQL_VALUE_TYPE_UINT8:
+    case TB_DATABASE_SQL_VALUE_TYPE_UINT16:
+    case TB_DATABASE_SQL_VALUE_TYPE_UINT32:
+    case TB_DATABASE_SQL_VALUE_TYPE_UINT64:
+        column->types[row] = TB_DATABASE_SQL_VALUE_TYPE_INT64;
+        column->ints[row] = tb_database_sql_value_int64(value);
+        break;
+#ifdef TB_CONFIG_TYPE_HAVE_FLOAT
+    case TB_DATABASE_SQL_VALUE_TYPE_FLOAT:
+    case TB_DATABASE_SQL_VALUE_TYPE_DOUBLE:
+        column->types[row] = TB_DATABASE_SQL_VALUE_TYPE_DOUBLE;
+        column->reals[row] = tb_database_sql_value_double(value);
+        break;
+#endif
+    case TB_DATABASE_SQL_VALUE_TYPE_TEXT:
+    case TB_DATABASE_SQL_VALUE_TYPE_BLOB8:
+    case TB_DATABASE_SQL_VALUE_TYPE_BLOB16:
+    case TB_DATABASE_SQL_VALUE_TYPE_BLOB32:
+        {
+            // the data, the stream blob will be null
+            tb_byte_t const*    data = value->type == TB_DATABASE_SQL_VALUE_TYPE_TEXT? (tb_byte_t const*)value->u.text.data : value->u.blob.data;
+            tb_size_t           size = tb_database_sql_value_size(value);
+            if (data)
+            {
+                column->types[row] = value->type == TB_DATABASE_SQL_VALUE_TYPE_TEXT? TB_DATABASE_SQL_VALUE_TYPE_TEXT : TB_DATABASE_SQL_VALUE_TYPE_BLOB32;
+                column->datas[row] = tb_database_sql_batch_copy(batch, data, size);
+                column->sizes[row] = (tb_uint32_t)size;
+                if (column->datas[row]) break;
+            }
+        }
+    default:
+        column->types[row] = TB_DATABASE_SQL_VALUE_TYPE_NULL;
+        break;
+    }
+}
+static tb_long_t tb_database_sql_batch_fetch(tb_database_sql_impl_t* impl, tb_database_sql_batch_t* batch)
+{
+    // load result if be not loaded
+    if (!batch->result)
+    {
+        batch->result = impl->result_load(impl, tb_false);
+        tb_check_return_val(batch->result, 0);
+
+        batch->result_itor = tb_iterator_head(batch->result);
+    }
+
+    // fetch rows
+    tb_iterator_ref_t   result = batch->result;
+    tb_size_t           tail = tb_iterator_tail(result);
+    while (batch->size < batch->maxn && batch->result_itor != tail)
+    {
+        // the row
+        tb_iterator_ref_t row = (tb_iterator_ref_t)tb_iterator_item(result, batch->result_itor);
+        tb_assert_and_check_return_val(row, -1);
+
+        // prepare columns for the first row
+        tb_size_t col;
+        tb_size_t count = tb_iterator_size(row);
+        if (!batch->size)
+        {
+            if (!tb_database_sql_batch_prepare(batch, count)) return -1;
+        }
+        tb_assert_and_check_return_val(count == batch->count, -1);
+
+        // set values
+        for (col = 0; col < count; col++)
+        {
+            tb_database_sql_value_t const* value = (tb_database_sql_value_t const*)tb_iterator_item(row, col);
+            tb_assert_and_check_return_val(value, -1);
+
+            if (!batch->size) tb_database_sql_batch_name_set(batch, col, tb_database_sql_value_name(value));
+            tb_database_sql_batch_set_value(batch, col, value);
+        }
+        batch->size++;
+
+        // next row
+        batch->result_itor = tb_iterator_next(result, batch->result_itor);
+    }
+
+    // end? exit result
+    if (batch->result_itor == tail)
+    {
+        impl->result_exit(impl, result);
+        batch->result = tb_null;
+    }
+    return batch->size;
+}
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
@@ -110,6 +286,9 @@ tb_database_sql_ref_t tb_database_sql_init(tb_char_t const* url)
         database = s_init[m](&database_url);
         tb_assert_and_check_break(database);
 
+        // init the statement cache maxn
+        ((tb_database_sql_impl_t*)database)->cache.stat.maxn = TB_DATABASE_SQL_STATEMENT_CACHE_MAXN;
+
         // trace
         tb_trace_d("init: %s: ok", url);
 
@@ -144,6 +323,9 @@ tb_void_t tb_database_sql_exit(tb_database_sql_ref_t database)
     // trace
     tb_trace_d("exit: ..");
 
+    // exit the statement cache before closing it
+    tb_database_sql_statement_cache_exit(impl);
+
     // exit it
     if (impl->exit) impl->exit(impl);
 
@@ -189,11 +371,15 @@ tb_void_t tb_database_sql_clos(tb_database_sql_ref_t database)
     // opened?
     tb_check_return(impl->bopened);
 
+    // clear the statement cache before closing it
+    tb_database_sql_statement_cache_clear(impl);
+
     // clos it
     if (impl->clos) impl->clos(impl);
 
     // closed
     impl->bopened = tb_false;
+    impl->btransaction = tb_false;
 
     // clear state
     impl->state = TB_STATE_OK;
@@ -223,7 +409,11 @@ tb_bool_t tb_database_sql_begin(tb_database_sql_ref_t database)
     tb_bool_t ok = impl->begin(impl);
 
     // save state
-    if (ok) impl->state = TB_STATE_OK;
+    if (ok)
+    {
+        impl->state = TB_STATE_OK;
+        impl->btransaction = tb_true;
+    }
 
     // ok?
     return ok;
@@ -244,7 +434,11 @@ tb_bool_t tb_database_sql_commit(tb_database_sql_ref_t database)
     tb_bool_t ok = impl->commit(impl);
 
     // save state
-    if (ok) impl->state = TB_STATE_OK;
+    if (ok)
+    {
+        impl->state = TB_STATE_OK;
+        impl->btransaction = tb_false;
+    }
 
     // ok?
     return ok;
@@ -265,7 +459,11 @@ tb_bool_t tb_database_sql_rollback(tb_database_sql_ref_t database)
     tb_bool_t ok = impl->rollback(impl);
 
     // save state
-    if (ok) impl->state = TB_STATE_OK;
+    if (ok)
+    {
+        impl->state = TB_STATE_OK;
+        impl->btransaction = tb_false;
+    }
 
     // ok?
     return ok;
@@ -342,12 +540,52 @@ tb_database_sql_statement_ref_t tb_database_sql_statement_init(tb_database_sql_r
     // opened?
     tb_assert_and_check_return_val(impl->bopened, tb_null);
 
+    // attempt to reuse the cached statement
+    tb_database_sql_statement_cache_t* cache = &impl->cache;
+    tb_bool_t cached = impl->statement_reset && cache->stat.maxn && tb_database_sql_statement_cache_init(impl);
+    if (cached)
+    {
+        tb_database_sql_statement_entry_t* entry = (tb_database_sql_statement_entry_t*)tb_hash_map_get(cache->idle, sql);
+        if (entry)
+        {
+            // move it to the used statements
+            tb_list_entry_remove(&cache->lru, &entry->entry);
+            tb_hash_map_remove(cache->idle, sql);
+            if (!tb_hash_map_insert(cache->used, entry->statement, entry))
+            {
+                tb_database_sql_statement_ref_t statement = entry->statement;
+                tb_database_sql_statement_entry_exit(entry);
+                impl->state = TB_STATE_OK;
+                return statement;
+            }
+            cache->stat.hits++;
+
+            // ok
+            impl->state = TB_STATE_OK;
+            return entry->statement;
+        }
+        cache->stat.misses++;
+    }
+
     // init statement
     tb_database_sql_statement_ref_t statement = impl->statement_init(impl, sql);
 
     // save state
     if (statement) impl->state = TB_STATE_OK;
 
+    // mark it as the cached statement
+    if (statement && cached)
+    {
+        tb_database_sql_statement_entry_t* entry = tb_malloc0_type(tb_database_sql_statement_entry_t);
+        if (entry)
+        {
+            entry->statement = statement;
+            entry->sql = tb_strdup(sql);
+            if (!entry->sql || !tb_hash_map_insert(cache->used, statement, entry))
+                tb_database_sql_statement_entry_exit(entry);
+        }
+    }
+
     // ok?
     return statement;
 }
@@ -360,11 +598,30 @@ tb_void_t tb_database_sql_statement_exit(tb_database_sql_ref_t database, tb_data
     // opened?
     tb_assert_and_check_return(impl->bopened);
 
-    // exit statement
-    impl->statement_exit(impl, statement);
-
     // clear state
     impl->state = TB_STATE_OK;
+
+    // is the cached statement?
+    tb_database_sql_statement_cache_t* cache = &impl->cache;
+    tb_database_sql_statement_entry_t* entry = cache->used? (tb_database_sql_statement_entry_t*)tb_hash_map_get(cache->used, statement) : tb_null;
+    if (entry)
+    {
+        // remove it from the used statements
+        tb_hash_map_remove(cache->used, statement);
+
+        // reset and keep it if no the same idle statement
+        if (cache->stat.maxn && !tb_hash_map_get(cache->idle, entry->sql) && impl->statement_reset(impl, statement)
+            && tb_hash_map_insert(cache->idle, entry->sql, entry))
+        {
+            tb_list_entry_insert_head(&cache->lru, &entry->entry);
+            tb_database_sql_statement_cache_evict(impl, cache->stat.maxn);
+            return ;
+        }
+        tb_database_sql_statement_entry_exit(entry);
+    }
+
+    // exit statement
+    impl->statement_exit(impl, statement);
 }
 tb_bool_t tb_database_sql_statement_done(tb_database_sql_ref_t database, tb_database_sql_statement_ref_t statement)
 {
@@ -408,3 +665,254 @@ tb_bool_t tb_database_sql_statement_bind(tb_database_sql_ref_t database, tb_data
     // ok?
     return ok;
 }
+tb_bool_t tb_database_sql_statement_bulk(tb_database_sql_ref_t database, tb_database_sql_statement_ref_t statement, tb_database_sql_value_t const* list, tb_size_t size, tb_size_t count)
+{
+    // check
+    tb_database_sql_impl_t* impl = (tb_database_sql_impl_t*)database;
+    tb_assert_and_check_return_val(impl && impl->statement_bind && impl->statement_done && statement && list && size, tb_false);
+
+    // init state
+    impl->state = TB_STATE_DATABASE_UNKNOWN_ERROR;
+
+    // opened?
+    tb_assert_and_check_return_val(impl->bopened, tb_false);
+
+    // begin transaction if not in transaction
+    tb_bool_t begin = !impl->btransaction;
+    if (begin && !tb_database_sql_begin(database)) return tb_false;
+
+    // bind and done statement for all rows
+    tb_size_t i;
+    for (i = 0; i < count; i++)
+    {
+        if (!impl->statement_bind(impl, statement, list + i * size, size)) break;
+        if (!impl->statement_done(impl, statement)) break;
+    }
+
+    // commit or rollback it
+    tb_bool_t ok = (i == count);
+    if (begin)
+    {
+        if (ok) ok = tb_database_sql_commit(database);
+        else
+        {
+            // rollback it and keep the error state
+            tb_size_t state = impl->state;
+            tb_database_sql_rollback(database);
+            impl->state = state;
+        }
+    }
+
+    // save state
+    if (ok) impl->state = TB_STATE_OK;
+
+    // trace
+    tb_trace_d("bulk: %lu rows: %s", count, ok? "ok" : "no");
+
+    // ok?
+    return ok;
+}
+tb_database_sql_batch_ref_t tb_database_sql_batch_init(tb_size_t maxn)
+{
+    // make batch
+    tb_database_sql_batch_t* batch = tb_malloc0_type(tb_database_sql_batch_t);
+    tb_assert_and_check_return_val(batch, tb_null);
+
+    // init it
+    batch->maxn = maxn? maxn : TB_DATABASE_SQL_BATCH_MAXN;
+
+    // ok
+    return (tb_database_sql_batch_ref_t)batch;
+}
+tb_void_t tb_database_sql_batch_exit(tb_database_sql_batch_ref_t self)
+{
+    // check
+    tb_database_sql_batch_t* batch = (tb_database_sql_batch_t*)self;
+    tb_assert_and_check_return(batch);
+
+    // exit columns, all column arrays are allocated with the column list
+    if (batch->columns) tb_free(batch->columns);
+
+    // exit chunks
+    while (batch->chunks)
+    {
+        tb_database_sql_batch_chunk_t* next = batch->chunks->next;
+        tb_free(batch->chunks);
+        batch->chunks = next;
+    }
+
+    // exit it
+    tb_free(batch);
+}
+tb_size_t tb_database_sql_batch_size(tb_database_sql_batch_ref_t self)
+{
+    // check
+    tb_database_sql_batch_t* batch = (tb_database_sql_batch_t*)self;
+    tb_assert_and_check_return_val(batch, 0);
+
+    // the row count
+    return batch->size;
+}
+tb_size_t tb_database_sql_batch_count(tb_database_sql_batch_ref_t self)
+{
+    // check
+    tb_database_sql_batch_t* batch = (tb_database_sql_batch_t*)self;
+    tb_assert_and_check_return_val(batch, 0);
+
+    // the column count
+    return batch->count;
+}
+tb_database_sql_column_t const* tb_database_sql_batch_column(tb_database_sql_batch_ref_t self, tb_size_t index)
+{
+    // check
+    tb_database_sql_batch_t* batch = (tb_database_sql_batch_t*)self;
+    tb_assert_and_check_return_val(batch && index < batch->count, tb_null);
+
+    // the column
+    return &batch->columns[index];
+}
+tb_bool_t tb_database_sql_batch_prepare(tb_database_sql_batch_t* batch, tb_size_t count)
+{
+    // check
+    tb_assert_and_check_return_val(batch && batch->maxn && count, tb_false);
+
+    // reset rows and chunks
+    batch->size = 0;
+    batch->chunk = batch->chunks;
+    if (batch->chunk) batch->chunk->used = 0;
+
+    // make columns
+    if (count > batch->count_maxn)
+    {
+        // the size of all values in one column, each array is aligned by sizeof(tb_int64_t)
+        tb_size_t maxn = batch->maxn;
+#ifdef TB_CONFIG_TYPE_HAVE_FLOAT
+        tb_size_t size = tb_align8(maxn * sizeof(tb_int64_t)) + tb_align8(maxn * sizeof(tb_double_t)) + tb_align8(maxn * sizeof(tb_byte_t const*)) + tb_align8(maxn * sizeof(tb_uint32_t)) + tb_align8(maxn * sizeof(tb_uint8_t));
+#else
+        tb_size_t size = tb_align8(maxn * sizeof(tb_int64_t)) + tb_align8(maxn * sizeof(tb_byte_t const*)) + tb_align8(maxn * sizeof(tb_uint32_t)) + tb_align8(maxn * sizeof(tb_uint8_t));
+#endif
+
+        // make the column list and all column arrays, the arrays start at the aligned offset after the column list
+        tb_size_t                   head = tb_align8(count * sizeof(tb_database_sql_column_t));
+        tb_database_sql_column_t*   columns = (tb_database_sql_column_t*)tb_ralloc(batch->columns, head + count * size);
+        tb_assert_and_check_return_val(columns, tb_false);
+
+        // init the column arrays
+        tb_size_t i;
+        tb_byte_t* data = (tb_byte_t*)columns + head;
+        for (i = 0; i < count; i++)
+        {
+            columns[i].ints     = (tb_int64_t*)data;            data += tb_align8(maxn * sizeof(tb_int64_t));
+#ifdef TB_CONFIG_TYPE_HAVE_FLOAT
+            columns[i].reals    = (tb_double_t*)data;           data += tb_align8(maxn * sizeof(tb_double_t));
+#endif
+            columns[i].datas    = (tb_byte_t const**)data;      data += tb_align8(maxn * sizeof(tb_byte_t const*));
+            columns[i].sizes    = (tb_uint32_t*)data;           data += tb_align8(maxn * sizeof(tb_uint32_t));
+            columns[i].types    = (tb_uint8_t*)data;            data += tb_align8(maxn * sizeof(tb_uint8_t));
+        }
+        batch->columns      = columns;
+        batch->count_maxn   = count;
+    }
+
+    // save the column count
+    batch->count = count;
+    return tb_true;
+}
+tb_byte_t const* tb_database_sql_batch_copy(tb_database_sql_batch_t* batch, tb_byte_t const* data, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(batch && (data || !size), tb_null);
+
+    // find a chunk with enough space, the larger data uses a new larger chunk
+    tb_database_sql_batch_chunk_t* chunk = batch->chunk;
+    while (chunk && chunk->used + size + 1 > chunk->size)
+    {
+        chunk = chunk->next;
+        if (chunk) chunk->used = 0;
+    }
+
+    // make a new chunk
+    if (!chunk)
+    {
+        tb_size_t chunk_size = tb_max(size + 1, TB_DATABASE_SQL_BATCH_CHUNK);
+        chunk = (tb_database_sql_batch_chunk_t*)tb_malloc_bytes(sizeof(tb_database_sql_batch_chunk_t) + chunk_size);
+        tb_assert_and_check_return_val(chunk, tb_null);
+
+        // insert it after the current chunk
+        chunk->size = chunk_size;
+        chunk->used = 0;
+        if (batch->chunk)
+        {
+            chunk->next = batch->chunk->next;
+            batch->chunk->next = chunk;
+        }
+        else
+        {
+            chunk->next = batch->chunks;
+            batch->chunks = chunk;
+        }
+    }
+    batch->chunk = chunk;
+
+    // copy data and append '\0' for text
+    tb_byte_t* copy = (tb_byte_t*)(chunk + 1) + chunk->used;
+    if (size) tb_memcpy(copy, data, size);
+    copy[size] = '\0';
+    chunk->used += size + 1;
+    return copy;
+}
+tb_void_t tb_database_sql_batch_name_set(tb_database_sql_batch_t* batch, tb_size_t index, tb_char_t const* name)
+{
+    // check
+    tb_assert_and_check_return(batch && index < batch->count);
+
+    // copy the name, it may be freed after exiting the result
+    batch->columns[index].name = name? (tb_char_t const*)tb_database_sql_batch_copy(batch, (tb_byte_t const*)name, tb_strlen(name)) : tb_null;
+}
+tb_long_t tb_database_sql_result_fetch(tb_database_sql_ref_t database, tb_database_sql_batch_ref_t self)
+{
+    // check
+    tb_database_sql_impl_t*  impl = (tb_database_sql_impl_t*)database;
+    tb_database_sql_batch_t* batch = (tb_database_sql_batch_t*)self;
+    tb_assert_and_check_return_val(impl && impl->result_load && impl->result_exit && batch, -1);
+
+    // init state
+    impl->state = TB_STATE_DATABASE_UNKNOWN_ERROR;
+
+    // opened?
+    tb_assert_and_check_return_val(impl->bopened, -1);
+
+    // clear the last rows
+    batch->size = 0;
+
+    // fetch rows
+    tb_long_t size = impl->result_fetch? impl->result_fetch(impl, batch) : tb_database_sql_batch_fetch(impl, batch);
+
+    // save state
+    if (size >= 0) impl->state = TB_STATE_OK;
+
+    // ok?
+    return size;
+}
+tb_void_t tb_database_sql_statement_cache_set(tb_database_sql_ref_t database, tb_size_t maxn)
+{
+    // check
+    tb_database_sql_impl_t* impl = (tb_database_sql_impl_t*)database;
+    tb_assert_and_check_return(impl);
+
+    // save maxn
+    impl->cache.stat.maxn = maxn;
+
+    // evict the overflow statements
+    if (impl->cache.idle) tb_database_sql_statement_cache_evict(impl, maxn);
+}
+tb_void_t tb_database_sql_statement_cache_stat(tb_database_sql_ref_t database, tb_database_sql_statement_cache_stat_t* stat)
+{
+    // check
+    tb_database_sql_impl_t* impl = (tb_database_sql_impl_t*)database;
+    tb_assert_and_check_return(impl && stat);
+
+    // get stat
+    *stat = impl->cache.stat;
+    stat->size = impl->cache.idle? tb_list_entry_size(&impl->cache.lru) : 0;
+}
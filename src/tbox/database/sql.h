@@ -51,6 +51,58 @@ typedef __tb_typeref__(database_sql);
 /// the database sql statement ref type
 typedef __tb_typeref__(database_sql_statement);
 
+/// the database sql batch ref type
+typedef __tb_typeref__(database_sql_batch);
+
+/*! the database sql column type of the batch
+ *
+ * all values of one column are stored in the contiguous arrays and indexed by the row,
+ * the value type of each row may be TB_DATABASE_SQL_VALUE_TYPE_NULL, INT64, DOUBLE, TEXT or BLOB32.
+ */
+typedef struct __tb_database_sql_column_t
+{
+    /// the column name, it is copied to the batch and valid until the next fetching
+    tb_char_t const*                name;
+
+    /// the value types
+    tb_uint8_t*                     types;
+
+    /// the integer values
+    tb_int64_t*                     ints;
+
+#ifdef TB_CONFIG_TYPE_HAVE_FLOAT
+    /// the real values
+    tb_double_t*                    reals;
+#endif
+
+    /// the text and blob data, it is valid until the next fetching
+    tb_byte_t const**               datas;
+
+    /// the text and blob sizes
+    tb_uint32_t*                    sizes;
+
+}tb_database_sql_column_t;
+
+/// the database sql statement cache stat type
+typedef struct __tb_database_sql_statement_cache_stat_t
+{
+    /// the cached statement count
+    tb_size_t                       size;
+
+    /// the cached statement maxn
+    tb_size_t                       maxn;
+
+    /// the hit count
+    tb_hize_t                       hits;
+
+    /// the missed count
+    tb_hize_t                       misses;
+
+    /// the evicted count
+    tb_hize_t                       evictions;
+
+}tb_database_sql_statement_cache_stat_t;
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
@@ -269,7 +321,81 @@ tb_iterator_ref_t                   tb_database_sql_result_load(tb_database_sql_
  */
 tb_void_t                           tb_database_sql_result_exit(tb_database_sql_ref_t database, tb_iterator_ref_t result);
 
+/*! init the columnar batch of the database result
+ *
+ * @param maxn                      the row maxn of each batch, using the default maxn if 0
+ *
+ * @return                          the batch
+ */
+tb_database_sql_batch_ref_t         tb_database_sql_batch_init(tb_size_t maxn);
+
+/*! exit the batch
+ *
+ * @param batch                     the batch
+ */
+tb_void_t                           tb_database_sql_batch_exit(tb_database_sql_batch_ref_t batch);
+
+/*! the row count of the current batch
+ *
+ * @param batch                     the batch
+ *
+ * @return                          the row count
+ */
+tb_size_t                           tb_database_sql_batch_size(tb_database_sql_batch_ref_t batch);
+
+/*! the column count of the current batch
+ *
+ * @param batch                     the batch
+ *
+ * @return                          the column count
+ */
+tb_size_t                           tb_database_sql_batch_count(tb_database_sql_batch_ref_t batch);
+
+/*! the column of the current batch
+ *
+ * @param batch                     the batch
+ * @param index                     the column index
+ *
+ * @return                          the column
+ */
+tb_database_sql_column_t const*     tb_database_sql_batch_column(tb_database_sql_batch_ref_t batch, tb_size_t index);
+
+/*! fetch the next rows of the database result to the columnar batch
+ *
+ * the text and blob values point to the driver memory directly if they are alive until the next fetching,
+ * otherwise they will be copied to the batch buffer.
+ *
+ * @code
+    // done sql
+    // ..
+
+    // fetch result
+    tb_long_t                   size = 0;
+    tb_database_sql_batch_ref_t batch = tb_database_sql_batch_init(0);
+    while ((size = tb_database_sql_result_fetch(database, batch)) > 0)
+    {
+        // the id column
+        tb_long_t                       row;
+        tb_database_sql_column_t const* id = tb_database_sql_batch_column(batch, 0);
+        for (row = 0; row < size; row++)
+        {
+            if (id->types[row] == TB_DATABASE_SQL_VALUE_TYPE_INT64)
+                tb_trace_i("id: %lld", id->ints[row]);
+        }
+    }
+    tb_database_sql_batch_exit(batch);
+ * @endcode
+ *
+ * @param database                  the database handle
+ * @param batch                     the batch
+ *
+ * @return                          the row count, end: 0, failed: -1
+ */
+tb_long_t                           tb_database_sql_result_fetch(tb_database_sql_ref_t database, tb_database_sql_batch_ref_t batch);
+
 /*! init the database statement
+ *
+ * the prepared statement will be reused from the statement cache of this database if exists
  *
  * @param database                  the database handle
  * @param sql                       the sql command
@@ -279,6 +405,9 @@ tb_void_t                           tb_database_sql_result_exit(tb_database_sql_
 tb_database_sql_statement_ref_t     tb_database_sql_statement_init(tb_database_sql_ref_t database, tb_char_t const* sql);
 
 /*! exit the database statement
+ *
+ * the statement will be reset and kept in the statement cache if the cache is enabled,
+ * and the least recently used statement will be evicted if the cache is full.
  *
  * @param database                  the database handle
  * @param statement                 the statement handle
@@ -327,6 +456,55 @@ tb_bool_t                           tb_database_sql_statement_done(tb_database_s
  */
 tb_bool_t                           tb_database_sql_statement_bind(tb_database_sql_ref_t database, tb_database_sql_statement_ref_t statement, tb_database_sql_value_t const* list, tb_size_t size);
 
+/*! bind and done the database statement for all rows in one transaction
+ *
+ * it will begin a transaction if not in transaction, and commit it if all rows are ok, otherwise rollback it.
+ *
+ * @code
+    tb_database_sql_statement_ref_t statement = tb_database_sql_statement_init(database, "insert into table values(?, ?)");
+    if (statement)
+    {
+        // the values of all rows
+        tb_size_t               i;
+        tb_database_sql_value_t list[2 * 1000];
+        for (i = 0; i < 1000; i++)
+        {
+            tb_database_sql_value_set_int32(&list[i * 2], (tb_int32_t)i);
+            tb_database_sql_value_set_text(&list[i * 2 + 1], "name", 0);
+        }
+
+        // insert all rows
+        tb_database_sql_statement_bulk(database, statement, list, 2, 1000);
+
+        // exit statement
+        tb_database_sql_statement_exit(database, statement);
+    }
+ * @endcode
+ *
+ * @param database                  the database handle
+ * @param statement                 the statement handle
+ * @param list                      the argument value list of all rows
+ * @param size                      the argument value count of each row
+ * @param count                     the row count
+ *
+ * @return                          tb_true or tb_false
+ */
+tb_bool_t                           tb_database_sql_statement_bulk(tb_database_sql_ref_t database, tb_database_sql_statement_ref_t statement, tb_database_sql_value_t const* list, tb_size_t size, tb_size_t count);
+
+/*! set the maxn of the prepared statement cache, the cache is keyed by the sql text
+ *
+ * @param database                  the database handle
+ * @param maxn                      the statement maxn, disable the cache and clear it if be zero
+ */
+tb_void_t                           tb_database_sql_statement_cache_set(tb_database_sql_ref_t database, tb_size_t maxn);
+
+/*! get the stat of the prepared statement cache
+ *
+ * @param database                  the database handle
+ * @param stat                      the stat
+ */
+tb_void_t                           tb_database_sql_statement_cache_stat(tb_database_sql_ref_t database, tb_database_sql_statement_cache_stat_t* stat);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
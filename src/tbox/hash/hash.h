@@ -40,6 +40,8 @@
 #include "fnv32.h"
 #include "fnv64.h"
 #include "murmur.h"
+#include "wyhash.h"
+#include "xxhash.h"
 #include "adler32.h"
 #include "blizzard.h"
 
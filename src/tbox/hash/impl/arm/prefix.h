@@ -0,0 +1,48 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        prefix.h
+ * @ingroup     hash
+ *
+ */
+#ifndef TB_HASH_IMPL_ARM_PREFIX_H
+#define TB_HASH_IMPL_ARM_PREFIX_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+/* the crypto extensions need be enabled by the compiler flags, e.g. -march=armv8-a+crypto,
+ * it has been enabled by default for the apple arm64 targets, and we check them at runtime too
+ */
+#if defined(TB_ARCH_ARM64) && (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_SHA2))
+#   define TB_HASH_IMPL_ARM
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#ifdef TB_HASH_IMPL_ARM
+#   include <arm_neon.h>
+#endif
+
+#endif
@@ -0,0 +1,181 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        sha.c
+ * @ingroup     hash
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+#ifdef TB_HASH_IMPL_ARM
+
+// the armv8 crypto extensions are supported
+#define TB_HASH_IMPL_SHA_ARM
+
+// load the big-endian message words
+#define TB_SHA_ARM_LOAD(p)          vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(p)))
+
+// sha1: rounds 4 * g ~ 4 * g + 3, e0 is the input e, e1 is the output e
+#define TB_SHA1_ARM_ROUNDS(op, e0, e1, w, k) \
+    tmp = vaddq_u32(w, k); \
+    e1 = vsha1h_u32(vgetq_lane_u32(abcd, 0)); \
+    abcd = op(abcd, e0, tmp)
+
+// sha1: the message schedule, w0 = su1(su0(w0, w1, w2), w3)
+#define TB_SHA1_ARM_SCHEDULE(w0, w1, w2, w3) \
+    w0 = vsha1su1q_u32(vsha1su0q_u32(w0, w1, w2), w3)
+
+// sha256: rounds 4 * g ~ 4 * g + 3
+#define TB_SHA256_ARM_ROUNDS(w, g) \
+    tmp = vaddq_u32(w, vld1q_u32(&g_sha_k256[(g) << 2])); \
+    abcd_prev = abcd; \
+    abcd = vsha256hq_u32(abcd, efgh, tmp); \
+    efgh = vsha256h2q_u32(efgh, abcd_prev, tmp)
+
+// sha256: the message schedule, w0 = su1(su0(w0, w1), w2, w3)
+#define TB_SHA256_ARM_SCHEDULE(w0, w1, w2, w3) \
+    w0 = vsha256su1q_u32(vsha256su0q_u32(w0, w1), w2, w3)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_sha_transform_sha1_arm(tb_uint32_t* state, tb_byte_t const* data, tb_size_t blocks)
+{
+    // init
+    uint32x4_t const k0 = vdupq_n_u32(0x5a827999);
+    uint32x4_t const k1 = vdupq_n_u32(0x6ed9eba1);
+    uint32x4_t const k2 = vdupq_n_u32(0x8f1bbcdc);
+    uint32x4_t const k3 = vdupq_n_u32(0xca62c1d6);
+    uint32x4_t abcd = vld1q_u32(state);
+    uint32_t   e0 = state[4];
+    uint32_t   e1;
+    uint32x4_t abcd_save;
+    uint32_t   e0_save;
+    uint32x4_t tmp;
+    uint32x4_t w0, w1, w2, w3;
+
+    // done
+    for (; blocks; blocks--, data += 64)
+    {
+        // save the current state
+        abcd_save = abcd;
+        e0_save = e0;
+
+        // load the message
+        w0 = TB_SHA_ARM_LOAD(data);
+        w1 = TB_SHA_ARM_LOAD(data + 16);
+        w2 = TB_SHA_ARM_LOAD(data + 32);
+        w3 = TB_SHA_ARM_LOAD(data + 48);
+
+        // rounds 0 ~ 19
+        TB_SHA1_ARM_ROUNDS(vsha1cq_u32, e0, e1, w0, k0); TB_SHA1_ARM_SCHEDULE(w0, w1, w2, w3);
+        TB_SHA1_ARM_ROUNDS(vsha1cq_u32, e1, e0, w1, k0); TB_SHA1_ARM_SCHEDULE(w1, w2, w3, w0);
+        TB_SHA1_ARM_ROUNDS(vsha1cq_u32, e0, e1, w2, k0); TB_SHA1_ARM_SCHEDULE(w2, w3, w0, w1);
+        TB_SHA1_ARM_ROUNDS(vsha1cq_u32, e1, e0, w3, k0); TB_SHA1_ARM_SCHEDULE(w3, w0, w1, w2);
+        TB_SHA1_ARM_ROUNDS(vsha1cq_u32, e0, e1, w0, k0); TB_SHA1_ARM_SCHEDULE(w0, w1, w2, w3);
+
+        // rounds 20 ~ 39
+        TB_SHA1_ARM_ROUNDS(vsha1pq_u32, e1, e0, w1, k1); TB_SHA1_ARM_SCHEDULE(w1, w2, w3, w0);
+        TB_SHA1_ARM_ROUNDS(vsha1pq_u32, e0, e1, w2, k1); TB_SHA1_ARM_SCHEDULE(w2, w3, w0, w1);
+        TB_SHA1_ARM_ROUNDS(vsha1pq_u32, e1, e0, w3, k1); TB_SHA1_ARM_SCHEDULE(w3, w0, w1, w2);
+        TB_SHA1_ARM_ROUNDS(vsha1pq_u32, e0, e1, w0, k1); TB_SHA1_ARM_SCHEDULE(w0, w1, w2, w3);
+        TB_SHA1_ARM_ROUNDS(vsha1pq_u32, e1, e0, w1, k1); TB_SHA1_ARM_SCHEDULE(w1, w2, w3, w0);
+
+        // rounds 40 ~ 59
+        TB_SHA1_ARM_ROUNDS(vsha1mq_u32, e0, e1, w2, k2); TB_SHA1_ARM_SCHEDULE(w2, w3, w0, w1);
+        TB_SHA1_ARM_ROUNDS(vsha1mq_u32, e1, e0, w3, k2); TB_SHA1_ARM_SCHEDULE(w3, w0, w1, w2);
+        TB_SHA1_ARM_ROUNDS(vsha1mq_u32, e0, e1, w0, k2); TB_SHA1_ARM_SCHEDULE(w0, w1, w2, w3);
+        TB_SHA1_ARM_ROUNDS(vsha1mq_u32, e1, e0, w1, k2); TB_SHA1_ARM_SCHEDULE(w1, w2, w3, w0);
+        TB_SHA1_ARM_ROUNDS(vsha1mq_u32, e0, e1, w2, k2); TB_SHA1_ARM_SCHEDULE(w2, w3, w0, w1);
+
+        // rounds 60 ~ 79
+        TB_SHA1_ARM_ROUNDS(vsha1pq_u32, e1, e0, w3, k3); TB_SHA1_ARM_SCHEDULE(w3, w0, w1, w2);
+        TB_SHA1_ARM_ROUNDS(vsha1pq_u32, e0, e1, w0, k3);
+        TB_SHA1_ARM_ROUNDS(vsha1pq_u32, e1, e0, w1, k3);
+        TB_SHA1_ARM_ROUNDS(vsha1pq_u32, e0, e1, w2, k3);
+        TB_SHA1_ARM_ROUNDS(vsha1pq_u32, e1, e0, w3, k3);
+
+        // update the state
+        e0 += e0_save;
+        abcd = vaddq_u32(abcd, abcd_save);
+    }
+
+    // save the state
+    vst1q_u32(state, abcd);
+    state[4] = e0;
+}
+static tb_void_t tb_sha_transform_sha2_arm(tb_uint32_t* state, tb_byte_t const* data, tb_size_t blocks)
+{
+    // init
+    uint32x4_t abcd = vld1q_u32(&state[0]);
+    uint32x4_t efgh = vld1q_u32(&state[4]);
+    uint32x4_t abcd_save;
+    uint32x4_t efgh_save;
+    uint32x4_t abcd_prev;
+    uint32x4_t tmp;
+    uint32x4_t w0, w1, w2, w3;
+
+    // done
+    for (; blocks; blocks--, data += 64)
+    {
+        // save the current state
+        abcd_save = abcd;
+        efgh_save = efgh;
+
+        // load the message
+        w0 = TB_SHA_ARM_LOAD(data);
+        w1 = TB_SHA_ARM_LOAD(data + 16);
+        w2 = TB_SHA_ARM_LOAD(data + 32);
+        w3 = TB_SHA_ARM_LOAD(data + 48);
+
+        // rounds 0 ~ 47
+        TB_SHA256_ARM_ROUNDS(w0,  0); TB_SHA256_ARM_SCHEDULE(w0, w1, w2, w3);
+        TB_SHA256_ARM_ROUNDS(w1,  1); TB_SHA256_ARM_SCHEDULE(w1, w2, w3, w0);
+        TB_SHA256_ARM_ROUNDS(w2,  2); TB_SHA256_ARM_SCHEDULE(w2, w3, w0, w1);
+        TB_SHA256_ARM_ROUNDS(w3,  3); TB_SHA256_ARM_SCHEDULE(w3, w0, w1, w2);
+        TB_SHA256_ARM_ROUNDS(w0,  4); TB_SHA256_ARM_SCHEDULE(w0, w1, w2, w3);
+        TB_SHA256_ARM_ROUNDS(w1,  5); TB_SHA256_ARM_SCHEDULE(w1, w2, w3, w0);
+        TB_SHA256_ARM_ROUNDS(w2,  6); TB_SHA256_ARM_SCHEDULE(w2, w3, w0, w1);
+        TB_SHA256_ARM_ROUNDS(w3,  7); TB_SHA256_ARM_SCHEDULE(w3, w0, w1, w2);
+        TB_SHA256_ARM_ROUNDS(w0,  8); TB_SHA256_ARM_SCHEDULE(w0, w1, w2, w3);
+        TB_SHA256_ARM_ROUNDS(w1,  9); TB_SHA256_ARM_SCHEDULE(w1, w2, w3, w0);
+        TB_SHA256_ARM_ROUNDS(w2, 10); TB_SHA256_ARM_SCHEDULE(w2, w3, w0, w1);
+        TB_SHA256_ARM_ROUNDS(w3, 11); TB_SHA256_ARM_SCHEDULE(w3, w0, w1, w2);
+
+        // rounds 48 ~ 63
+        TB_SHA256_ARM_ROUNDS(w0, 12);
+        TB_SHA256_ARM_ROUNDS(w1, 13);
+        TB_SHA256_ARM_ROUNDS(w2, 14);
+        TB_SHA256_ARM_ROUNDS(w3, 15);
+
+        // update the state
+        abcd = vaddq_u32(abcd, abcd_save);
+        efgh = vaddq_u32(efgh, efgh_save);
+    }
+
+    // save the state
+    vst1q_u32(&state[0], abcd);
+    vst1q_u32(&state[4], efgh);
+}
+#endif
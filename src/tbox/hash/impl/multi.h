@@ -0,0 +1,186 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        multi.h
+ * @ingroup     hash
+ *
+ */
+#ifndef TB_HASH_IMPL_MULTI_H
+#define TB_HASH_IMPL_MULTI_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "../../utils/bits.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the lanes count
+#define TB_HASH_MULTI_LANES         (8)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the multi-buffer transform type, state[i] = the state word i of all lanes
+typedef tb_void_t                   (*tb_hash_multi_transform_t)(tb_uint32_t (*state)[TB_HASH_MULTI_LANES], tb_byte_t const* blocks[TB_HASH_MULTI_LANES]);
+
+// the multi-buffer hash type
+typedef struct __tb_hash_multi_t
+{
+    // the transform
+    tb_hash_multi_transform_t       transform;
+
+    // the initial state
+    tb_uint32_t const*              state;
+
+    // the state words count
+    tb_size_t                       words;
+
+    // is big-endian? the message length and digest of sha are big-endian, md5 is little-endian
+    tb_bool_t                       bigendian;
+
+}tb_hash_multi_t;
+
+// the multi-buffer lane type
+typedef struct __tb_hash_multi_lane_t
+{
+    // the message index, -1: idle
+    tb_long_t                       index;
+
+    // the message data
+    tb_byte_t const*                data;
+
+    // the left full blocks of the message data
+    tb_size_t                       left;
+
+    // the left padding blocks
+    tb_size_t                       padn;
+
+    // the next padding block
+    tb_byte_t const*                padp;
+
+    // the padding blocks, the tail data + 0x80 + zeros + the message bits
+    tb_byte_t                       pad[128];
+
+}tb_hash_multi_lane_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static __tb_inline__ tb_void_t tb_hash_multi_lane_load(tb_hash_multi_t const* hash, tb_hash_multi_lane_t* lane, tb_size_t i, tb_uint32_t (*state)[TB_HASH_MULTI_LANES], tb_byte_t const** datas, tb_size_t const* sizes, tb_size_t index)
+{
+    // init the lane state
+    tb_size_t j;
+    for (j = 0; j < hash->words; j++) state[j][i] = hash->state[j];
+
+    // init the message data
+    tb_size_t size  = sizes[index];
+    tb_size_t tail  = size & 63;
+    lane->index     = (tb_long_t)index;
+    lane->data      = datas[index];
+    lane->left      = size >> 6;
+    lane->padn      = tail < 56? 1 : 2;
+    lane->padp      = lane->pad;
+
+    // make the padding blocks
+    tb_byte_t* pad = lane->pad;
+    if (tail) tb_memcpy(pad, lane->data + size - tail, tail);
+    pad[tail] = 0x80;
+    tb_memset(pad + tail + 1, 0, (lane->padn << 6) - tail - 9);
+    if (hash->bigendian) tb_bits_set_u64_be(pad + (lane->padn << 6) - 8, (tb_uint64_t)size << 3);
+    else tb_bits_set_u64_le(pad + (lane->padn << 6) - 8, (tb_uint64_t)size << 3);
+}
+static __tb_inline__ tb_void_t tb_hash_multi_lane_save(tb_hash_multi_t const* hash, tb_hash_multi_lane_t* lane, tb_size_t i, tb_uint32_t (*state)[TB_HASH_MULTI_LANES], tb_byte_t* digests)
+{
+    // save the digest of this lane
+    tb_size_t   j;
+    tb_byte_t*  digest = digests + (tb_size_t)lane->index * (hash->words << 2);
+    for (j = 0; j < hash->words; j++)
+    {
+        if (hash->bigendian) tb_bits_set_u32_be(digest + (j << 2), state[j][i]);
+        else tb_bits_set_u32_le(digest + (j << 2), state[j][i]);
+    }
+    lane->index = -1;
+}
+
+/* make the digests of multiple messages in the parallel lanes
+ *
+ * each lane takes the next message after its message has been finished,
+ * so the lanes are always busy until the last messages are being processed.
+ */
+static tb_void_t tb_hash_multi_make(tb_hash_multi_t const* hash, tb_byte_t const** datas, tb_size_t const* sizes, tb_size_t count, tb_byte_t* digests)
+{
+    // init lanes
+    tb_uint32_t             state[8][TB_HASH_MULTI_LANES] = {{0}};
+    tb_byte_t const*        blocks[TB_HASH_MULTI_LANES];
+    tb_hash_multi_lane_t    lanes[TB_HASH_MULTI_LANES];
+    tb_byte_t               zero[64] = {0};
+    tb_size_t               next = 0;
+    tb_size_t               busy = 0;
+    tb_size_t               i;
+    for (i = 0; i < TB_HASH_MULTI_LANES; i++)
+    {
+        lanes[i].index = -1;
+        if (next < count)
+        {
+            tb_hash_multi_lane_load(hash, &lanes[i], i, state, datas, sizes, next++);
+            busy++;
+        }
+    }
+
+    // done
+    while (busy)
+    {
+        // get the next block of all lanes, the idle lanes transform the zero block and their results are discarded
+        for (i = 0; i < TB_HASH_MULTI_LANES; i++)
+        {
+            tb_hash_multi_lane_t* lane = &lanes[i];
+            if (lane->index < 0) blocks[i] = zero;
+            else if (lane->left) blocks[i] = lane->data;
+            else blocks[i] = lane->padp;
+        }
+
+        // transform them
+        hash->transform(state, blocks);
+
+        // move to the next blocks
+        for (i = 0; i < TB_HASH_MULTI_LANES; i++)
+        {
+            tb_hash_multi_lane_t* lane = &lanes[i];
+            if (lane->index < 0) continue;
+            if (lane->left)
+            {
+                lane->data += 64;
+                lane->left--;
+            }
+            else if (--lane->padn) lane->padp += 64;
+            else
+            {
+                // this message has been finished, load the next message
+                tb_hash_multi_lane_save(hash, lane, i, state, digests);
+                if (next < count) tb_hash_multi_lane_load(hash, lane, i, state, datas, sizes, next++);
+                else busy--;
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,149 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        md5.c
+ * @ingroup     hash
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+#ifdef TB_HASH_IMPL_x86
+
+// the 8-lanes avx2 md5 is supported
+#define TB_HASH_IMPL_MD5_x8
+
+// the basic md5 functions for the 8 lanes
+#define TB_MD5_X8_F(x, y, z)        _mm256_xor_si256(_mm256_and_si256(_mm256_xor_si256(y, z), x), z)
+#define TB_MD5_X8_G(x, y, z)        _mm256_xor_si256(_mm256_and_si256(_mm256_xor_si256(x, y), z), y)
+#define TB_MD5_X8_H(x, y, z)        _mm256_xor_si256(_mm256_xor_si256(x, y), z)
+#define TB_MD5_X8_I(x, y, z)        _mm256_xor_si256(y, _mm256_or_si256(x, _mm256_xor_si256(z, ones)))
+
+// the md5 step for the 8 lanes
+#define TB_MD5_X8_STEP(f, a, b, c, d, x, s, ac) \
+    a = _mm256_add_epi32(a, _mm256_add_epi32(f(b, c, d), _mm256_add_epi32(x, _mm256_set1_epi32((tb_int_t)(ac))))); \
+    a = _mm256_or_si256(_mm256_slli_epi32(a, s), _mm256_srli_epi32(a, 32 - (s))); \
+    a = _mm256_add_epi32(a, b)
+#define TB_MD5_X8_FF(a, b, c, d, x, s, ac)  TB_MD5_X8_STEP(TB_MD5_X8_F, a, b, c, d, x, s, ac)
+#define TB_MD5_X8_GG(a, b, c, d, x, s, ac)  TB_MD5_X8_STEP(TB_MD5_X8_G, a, b, c, d, x, s, ac)
+#define TB_MD5_X8_HH(a, b, c, d, x, s, ac)  TB_MD5_X8_STEP(TB_MD5_X8_H, a, b, c, d, x, s, ac)
+#define TB_MD5_X8_II(a, b, c, d, x, s, ac)  TB_MD5_X8_STEP(TB_MD5_X8_I, a, b, c, d, x, s, ac)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+
+// the md5 transform of the 8 lanes, state[i] = the state word i of the lanes 0 ~ 7
+static TB_HASH_IMPL_x86_TARGET("avx2") tb_void_t tb_md5_transform_x8(tb_uint32_t (*state)[8], tb_byte_t const* blocks[8])
+{
+    // init
+    __m256i const ones = _mm256_set1_epi32(-1);
+    __m256i w[16];
+    __m256i a = _mm256_loadu_si256((__m256i const*)state[0]);
+    __m256i b = _mm256_loadu_si256((__m256i const*)state[1]);
+    __m256i c = _mm256_loadu_si256((__m256i const*)state[2]);
+    __m256i d = _mm256_loadu_si256((__m256i const*)state[3]);
+    __m256i a0 = a, b0 = b, c0 = c, d0 = d;
+
+    // load the little-endian message words of all lanes
+    tb_hash_impl_x86_load_x8(w, blocks);
+
+    // round 1
+    TB_MD5_X8_FF(a, b, c, d, w[ 0],  7, 0xd76aa478);
+    TB_MD5_X8_FF(d, a, b, c, w[ 1], 12, 0xe8c7b756);
+    TB_MD5_X8_FF(c, d, a, b, w[ 2], 17, 0x242070db);
+    TB_MD5_X8_FF(b, c, d, a, w[ 3], 22, 0xc1bdceee);
+    TB_MD5_X8_FF(a, b, c, d, w[ 4],  7, 0xf57c0faf);
+    TB_MD5_X8_FF(d, a, b, c, w[ 5], 12, 0x4787c62a);
+    TB_MD5_X8_FF(c, d, a, b, w[ 6], 17, 0xa8304613);
+    TB_MD5_X8_FF(b, c, d, a, w[ 7], 22, 0xfd469501);
+    TB_MD5_X8_FF(a, b, c, d, w[ 8],  7, 0x698098d8);
+    TB_MD5_X8_FF(d, a, b, c, w[ 9], 12, 0x8b44f7af);
+    TB_MD5_X8_FF(c, d, a, b, w[10], 17, 0xffff5bb1);
+    TB_MD5_X8_FF(b, c, d, a, w[11], 22, 0x895cd7be);
+    TB_MD5_X8_FF(a, b, c, d, w[12],  7, 0x6b901122);
+    TB_MD5_X8_FF(d, a, b, c, w[13], 12, 0xfd987193);
+    TB_MD5_X8_FF(c, d, a, b, w[14], 17, 0xa679438e);
+    TB_MD5_X8_FF(b, c, d, a, w[15], 22, 0x49b40821);
+
+    // round 2
+    TB_MD5_X8_GG(a, b, c, d, w[ 1],  5, 0xf61e2562);
+    TB_MD5_X8_GG(d, a, b, c, w[ 6],  9, 0xc040b340);
+    TB_MD5_X8_GG(c, d, a, b, w[11], 14, 0x265e5a51);
+    TB_MD5_X8_GG(b, c, d, a, w[ 0], 20, 0xe9b6c7aa);
+    TB_MD5_X8_GG(a, b, c, d, w[ 5],  5, 0xd62f105d);
+    TB_MD5_X8_GG(d, a, b, c, w[10],  9, 0x02441453);
+    TB_MD5_X8_GG(c, d, a, b, w[15], 14, 0xd8a1e681);
+    TB_MD5_X8_GG(b, c, d, a, w[ 4], 20, 0xe7d3fbc8);
+    TB_MD5_X8_GG(a, b, c, d, w[ 9],  5, 0x21e1cde6);
+    TB_MD5_X8_GG(d, a, b, c, w[14],  9, 0xc33707d6);
+    TB_MD5_X8_GG(c, d, a, b, w[ 3], 14, 0xf4d50d87);
+    TB_MD5_X8_GG(b, c, d, a, w[ 8], 20, 0x455a14ed);
+    TB_MD5_X8_GG(a, b, c, d, w[13],  5, 0xa9e3e905);
+    TB_MD5_X8_GG(d, a, b, c, w[ 2],  9, 0xfcefa3f8);
+    TB_MD5_X8_GG(c, d, a, b, w[ 7], 14, 0x676f02d9);
+    TB_MD5_X8_GG(b, c, d, a, w[12], 20, 0x8d2a4c8a);
+
+    // round 3
+    TB_MD5_X8_HH(a, b, c, d, w[ 5],  4, 0xfffa3942);
+    TB_MD5_X8_HH(d, a, b, c, w[ 8], 11, 0x8771f681);
+    TB_MD5_X8_HH(c, d, a, b, w[11], 16, 0x6d9d6122);
+    TB_MD5_X8_HH(b, c, d, a, w[14], 23, 0xfde5380c);
+    TB_MD5_X8_HH(a, b, c, d, w[ 1],  4, 0xa4beea44);
+    TB_MD5_X8_HH(d, a, b, c, w[ 4], 11, 0x4bdecfa9);
+    TB_MD5_X8_HH(c, d, a, b, w[ 7], 16, 0xf6bb4b60);
+    TB_MD5_X8_HH(b, c, d, a, w[10], 23, 0xbebfbc70);
+    TB_MD5_X8_HH(a, b, c, d, w[13],  4, 0x289b7ec6);
+    TB_MD5_X8_HH(d, a, b, c, w[ 0], 11, 0xeaa127fa);
+    TB_MD5_X8_HH(c, d, a, b, w[ 3], 16, 0xd4ef3085);
+    TB_MD5_X8_HH(b, c, d, a, w[ 6], 23, 0x04881d05);
+    TB_MD5_X8_HH(a, b, c, d, w[ 9],  4, 0xd9d4d039);
+    TB_MD5_X8_HH(d, a, b, c, w[12], 11, 0xe6db99e5);
+    TB_MD5_X8_HH(c, d, a, b, w[15], 16, 0x1fa27cf8);
+    TB_MD5_X8_HH(b, c, d, a, w[ 2], 23, 0xc4ac5665);
+
+    // round 4
+    TB_MD5_X8_II(a, b, c, d, w[ 0],  6, 0xf4292244);
+    TB_MD5_X8_II(d, a, b, c, w[ 7], 10, 0x432aff97);
+    TB_MD5_X8_II(c, d, a, b, w[14], 15, 0xab9423a7);
+    TB_MD5_X8_II(b, c, d, a, w[ 5], 21, 0xfc93a039);
+    TB_MD5_X8_II(a, b, c, d, w[12],  6, 0x655b59c3);
+    TB_MD5_X8_II(d, a, b, c, w[ 3], 10, 0x8f0ccc92);
+    TB_MD5_X8_II(c, d, a, b, w[10], 15, 0xffeff47d);
+    TB_MD5_X8_II(b, c, d, a, w[ 1], 21, 0x85845dd1);
+    TB_MD5_X8_II(a, b, c, d, w[ 8],  6, 0x6fa87e4f);
+    TB_MD5_X8_II(d, a, b, c, w[15], 10, 0xfe2ce6e0);
+    TB_MD5_X8_II(c, d, a, b, w[ 6], 15, 0xa3014314);
+    TB_MD5_X8_II(b, c, d, a, w[13], 21, 0x4e0811a1);
+    TB_MD5_X8_II(a, b, c, d, w[ 4],  6, 0xf7537e82);
+    TB_MD5_X8_II(d, a, b, c, w[11], 10, 0xbd3af235);
+    TB_MD5_X8_II(c, d, a, b, w[ 2], 15, 0x2ad7d2bb);
+    TB_MD5_X8_II(b, c, d, a, w[ 9], 21, 0xeb86d391);
+
+    // update the state
+    _mm256_storeu_si256((__m256i*)state[0], _mm256_add_epi32(a, a0));
+    _mm256_storeu_si256((__m256i*)state[1], _mm256_add_epi32(b, b0));
+    _mm256_storeu_si256((__m256i*)state[2], _mm256_add_epi32(c, c0));
+    _mm256_storeu_si256((__m256i*)state[3], _mm256_add_epi32(d, d0));
+}
+#endif
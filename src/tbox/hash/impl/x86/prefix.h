@@ -0,0 +1,99 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        prefix.h
+ * @ingroup     hash
+ *
+ */
+#ifndef TB_HASH_IMPL_x86_PREFIX_H
+#define TB_HASH_IMPL_x86_PREFIX_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+/* the accelerated implementations are compiled with the target attributes,
+ * so we need not enable -msha or -mavx2 for the whole library and they are dispatched at runtime
+ */
+#if defined(TB_COMPILER_IS_MSVC) && TB_COMPILER_VERSION_BE(19, 0)
+#   define TB_HASH_IMPL_x86
+#   define TB_HASH_IMPL_x86_TARGET(features)
+#elif defined(TB_COMPILER_IS_CLANG) || (defined(TB_COMPILER_IS_GCC) && TB_COMPILER_VERSION_BE(4, 9))
+#   define TB_HASH_IMPL_x86
+#   define TB_HASH_IMPL_x86_TARGET(features)    __attribute__((target(features)))
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#ifdef TB_HASH_IMPL_x86
+#   include <immintrin.h>
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * inlines
+ */
+#ifdef TB_HASH_IMPL_x86
+
+// load the 16 message words of the 8 lanes and transpose them, w[i] = the word i of the lanes 0 ~ 7
+static __tb_inline__ TB_HASH_IMPL_x86_TARGET("avx2") tb_void_t tb_hash_impl_x86_load_x8(__m256i w[16], tb_byte_t const* blocks[8])
+{
+    tb_size_t i;
+    for (i = 0; i < 16; i += 8)
+    {
+        __m256i r0 = _mm256_loadu_si256((__m256i const*)(blocks[0] + (i << 2)));
+        __m256i r1 = _mm256_loadu_si256((__m256i const*)(blocks[1] + (i << 2)));
+        __m256i r2 = _mm256_loadu_si256((__m256i const*)(blocks[2] + (i << 2)));
+        __m256i r3 = _mm256_loadu_si256((__m256i const*)(blocks[3] + (i << 2)));
+        __m256i r4 = _mm256_loadu_si256((__m256i const*)(blocks[4] + (i << 2)));
+        __m256i r5 = _mm256_loadu_si256((__m256i const*)(blocks[5] + (i << 2)));
+        __m256i r6 = _mm256_loadu_si256((__m256i const*)(blocks[6] + (i << 2)));
+        __m256i r7 = _mm256_loadu_si256((__m256i const*)(blocks[7] + (i << 2)));
+        __m256i t0 = _mm256_unpacklo_epi32(r0, r1);
+        __m256i t1 = _mm256_unpackhi_epi32(r0, r1);
+        __m256i t2 = _mm256_unpacklo_epi32(r2, r3);
+        __m256i t3 = _mm256_unpackhi_epi32(r2, r3);
+        __m256i t4 = _mm256_unpacklo_epi32(r4, r5);
+        __m256i t5 = _mm256_unpackhi_epi32(r4, r5);
+        __m256i t6 = _mm256_unpacklo_epi32(r6, r7);
+        __m256i t7 = _mm256_unpackhi_epi32(r6, r7);
+        r0 = _mm256_unpacklo_epi64(t0, t2);
+        r1 = _mm256_unpackhi_epi64(t0, t2);
+        r2 = _mm256_unpacklo_epi64(t1, t3);
+        r3 = _mm256_unpackhi_epi64(t1, t3);
+        r4 = _mm256_unpacklo_epi64(t4, t6);
+        r5 = _mm256_unpackhi_epi64(t4, t6);
+        r6 = _mm256_unpacklo_epi64(t5, t7);
+        r7 = _mm256_unpackhi_epi64(t5, t7);
+        w[i + 0] = _mm256_permute2x128_si256(r0, r4, 0x20);
+        w[i + 1] = _mm256_permute2x128_si256(r1, r5, 0x20);
+        w[i + 2] = _mm256_permute2x128_si256(r2, r6, 0x20);
+        w[i + 3] = _mm256_permute2x128_si256(r3, r7, 0x20);
+        w[i + 4] = _mm256_permute2x128_si256(r0, r4, 0x31);
+        w[i + 5] = _mm256_permute2x128_si256(r1, r5, 0x31);
+        w[i + 6] = _mm256_permute2x128_si256(r2, r6, 0x31);
+        w[i + 7] = _mm256_permute2x128_si256(r3, r7, 0x31);
+    }
+}
+#endif
+
+#endif
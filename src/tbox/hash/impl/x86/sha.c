@@ -0,0 +1,319 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        sha.c
+ * @ingroup     hash
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+#ifdef TB_HASH_IMPL_x86
+
+// the sha extensions are supported
+#define TB_HASH_IMPL_SHA_x86
+
+// the 8-lanes avx2 sha1 is supported
+#define TB_HASH_IMPL_SHA1_x8
+
+// sha1: rounds 4 * g ~ 4 * g + 3, e0 is the input e, e1 saves abcd for the next group
+#define TB_SHA1_NI_ROUNDS(e0, e1, w, f) \
+    e0 = _mm_sha1nexte_epu32(e0, w); \
+    e1 = abcd; \
+    abcd = _mm_sha1rnds4_epu32(abcd, e0, f)
+
+// sha256: rounds 4 * g ~ 4 * g + 3
+#define TB_SHA256_NI_ROUNDS(w, g) \
+    msg = _mm_add_epi32(w, _mm_loadu_si128((__m128i const*)&g_sha_k256[(g) << 2])); \
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg); \
+    state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0e))
+
+// sha256: the message schedule, w3 += alignr(w2, w1) and w3 = msg2(w3, w2)
+#define TB_SHA256_NI_SCHEDULE2(w1, w2, w3) \
+    w3 = _mm_sha256msg2_epu32(_mm_add_epi32(w3, _mm_alignr_epi8(w2, w1, 4)), w2)
+
+// the avx2 operations for the 8 lanes
+#define TB_SHA1_X8_ROL(x, n)        _mm256_or_si256(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - (n)))
+#define TB_SHA1_X8_ADD(x, y)        _mm256_add_epi32(x, y)
+#define TB_SHA1_X8_XOR(x, y)        _mm256_xor_si256(x, y)
+#define TB_SHA1_X8_AND(x, y)        _mm256_and_si256(x, y)
+#define TB_SHA1_X8_OR(x, y)         _mm256_or_si256(x, y)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static TB_HASH_IMPL_x86_TARGET("sha,sse4.1,ssse3") tb_void_t tb_sha_transform_sha1_x86(tb_uint32_t* state, tb_byte_t const* data, tb_size_t blocks)
+{
+    // init
+    __m128i const mask = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+    __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128((__m128i const*)state), 0x1b);
+    __m128i e0 = _mm_set_epi32((tb_int_t)state[4], 0, 0, 0);
+    __m128i e1;
+    __m128i abcd_save;
+    __m128i e0_save;
+    __m128i w0, w1, w2, w3;
+
+    // done
+    for (; blocks; blocks--, data += 64)
+    {
+        // save the current state
+        abcd_save = abcd;
+        e0_save = e0;
+
+        // load the message
+        w0 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)(data +  0)), mask);
+        w1 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)(data + 16)), mask);
+        w2 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)(data + 32)), mask);
+        w3 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)(data + 48)), mask);
+
+        // rounds 0 ~ 19
+        e0 = _mm_add_epi32(e0, w0);
+        e1 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+        TB_SHA1_NI_ROUNDS(e1, e0, w1, 0);
+        w0 = _mm_sha1msg1_epu32(w0, w1);
+        TB_SHA1_NI_ROUNDS(e0, e1, w2, 0);
+        w1 = _mm_sha1msg1_epu32(w1, w2);
+        w0 = _mm_xor_si128(w0, w2);
+        w0 = _mm_sha1msg2_epu32(w0, w3);
+        TB_SHA1_NI_ROUNDS(e1, e0, w3, 0);
+        w2 = _mm_sha1msg1_epu32(w2, w3);
+        w1 = _mm_xor_si128(w1, w3);
+        w1 = _mm_sha1msg2_epu32(w1, w0);
+        TB_SHA1_NI_ROUNDS(e0, e1, w0, 0);
+        w3 = _mm_sha1msg1_epu32(w3, w0);
+        w2 = _mm_xor_si128(w2, w0);
+
+        // rounds 20 ~ 39
+        w2 = _mm_sha1msg2_epu32(w2, w1);
+        TB_SHA1_NI_ROUNDS(e1, e0, w1, 1);
+        w0 = _mm_sha1msg1_epu32(w0, w1);
+        w3 = _mm_xor_si128(w3, w1);
+        w3 = _mm_sha1msg2_epu32(w3, w2);
+        TB_SHA1_NI_ROUNDS(e0, e1, w2, 1);
+        w1 = _mm_sha1msg1_epu32(w1, w2);
+        w0 = _mm_xor_si128(w0, w2);
+        w0 = _mm_sha1msg2_epu32(w0, w3);
+        TB_SHA1_NI_ROUNDS(e1, e0, w3, 1);
+        w2 = _mm_sha1msg1_epu32(w2, w3);
+        w1 = _mm_xor_si128(w1, w3);
+        w1 = _mm_sha1msg2_epu32(w1, w0);
+        TB_SHA1_NI_ROUNDS(e0, e1, w0, 1);
+        w3 = _mm_sha1msg1_epu32(w3, w0);
+        w2 = _mm_xor_si128(w2, w0);
+        w2 = _mm_sha1msg2_epu32(w2, w1);
+        TB_SHA1_NI_ROUNDS(e1, e0, w1, 1);
+        w0 = _mm_sha1msg1_epu32(w0, w1);
+        w3 = _mm_xor_si128(w3, w1);
+
+        // rounds 40 ~ 59
+        w3 = _mm_sha1msg2_epu32(w3, w2);
+        TB_SHA1_NI_ROUNDS(e0, e1, w2, 2);
+        w1 = _mm_sha1msg1_epu32(w1, w2);
+        w0 = _mm_xor_si128(w0, w2);
+        w0 = _mm_sha1msg2_epu32(w0, w3);
+        TB_SHA1_NI_ROUNDS(e1, e0, w3, 2);
+        w2 = _mm_sha1msg1_epu32(w2, w3);
+        w1 = _mm_xor_si128(w1, w3);
+        w1 = _mm_sha1msg2_epu32(w1, w0);
+        TB_SHA1_NI_ROUNDS(e0, e1, w0, 2);
+        w3 = _mm_sha1msg1_epu32(w3, w0);
+        w2 = _mm_xor_si128(w2, w0);
+        w2 = _mm_sha1msg2_epu32(w2, w1);
+        TB_SHA1_NI_ROUNDS(e1, e0, w1, 2);
+        w0 = _mm_sha1msg1_epu32(w0, w1);
+        w3 = _mm_xor_si128(w3, w1);
+        w3 = _mm_sha1msg2_epu32(w3, w2);
+        TB_SHA1_NI_ROUNDS(e0, e1, w2, 2);
+        w1 = _mm_sha1msg1_epu32(w1, w2);
+        w0 = _mm_xor_si128(w0, w2);
+
+        // rounds 60 ~ 79
+        w0 = _mm_sha1msg2_epu32(w0, w3);
+        TB_SHA1_NI_ROUNDS(e1, e0, w3, 3);
+        w2 = _mm_sha1msg1_epu32(w2, w3);
+        w1 = _mm_xor_si128(w1, w3);
+        w1 = _mm_sha1msg2_epu32(w1, w0);
+        TB_SHA1_NI_ROUNDS(e0, e1, w0, 3);
+        w3 = _mm_sha1msg1_epu32(w3, w0);
+        w2 = _mm_xor_si128(w2, w0);
+        w2 = _mm_sha1msg2_epu32(w2, w1);
+        TB_SHA1_NI_ROUNDS(e1, e0, w1, 3);
+        w3 = _mm_xor_si128(w3, w1);
+        w3 = _mm_sha1msg2_epu32(w3, w2);
+        TB_SHA1_NI_ROUNDS(e0, e1, w2, 3);
+        TB_SHA1_NI_ROUNDS(e1, e0, w3, 3);
+
+        // update the state
+        e0 = _mm_sha1nexte_epu32(e0, e0_save);
+        abcd = _mm_add_epi32(abcd, abcd_save);
+    }
+
+    // save the state
+    _mm_storeu_si128((__m128i*)state, _mm_shuffle_epi32(abcd, 0x1b));
+    state[4] = (tb_uint32_t)_mm_extract_epi32(e0, 3);
+}
+static TB_HASH_IMPL_x86_TARGET("sha,sse4.1,ssse3") tb_void_t tb_sha_transform_sha2_x86(tb_uint32_t* state, tb_byte_t const* data, tb_size_t blocks)
+{
+    // init
+    __m128i const mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m128i msg;
+    __m128i state0;
+    __m128i state1;
+    __m128i abef_save;
+    __m128i cdgh_save;
+    __m128i w0, w1, w2, w3;
+
+    // load the state, abcd efgh => abef cdgh
+    msg     = _mm_shuffle_epi32(_mm_loadu_si128((__m128i const*)&state[0]), 0xb1);
+    state1  = _mm_shuffle_epi32(_mm_loadu_si128((__m128i const*)&state[4]), 0x1b);
+    state0  = _mm_alignr_epi8(msg, state1, 8);
+    state1  = _mm_blend_epi16(state1, msg, 0xf0);
+
+    // done
+    for (; blocks; blocks--, data += 64)
+    {
+        // save the current state
+        abef_save = state0;
+        cdgh_save = state1;
+
+        // load the message
+        w0 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)(data +  0)), mask);
+        w1 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)(data + 16)), mask);
+        w2 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)(data + 32)), mask);
+        w3 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)(data + 48)), mask);
+
+        // rounds 0 ~ 15
+        TB_SHA256_NI_ROUNDS(w0, 0);
+        TB_SHA256_NI_ROUNDS(w1, 1);
+        w0 = _mm_sha256msg1_epu32(w0, w1);
+        TB_SHA256_NI_ROUNDS(w2, 2);
+        w1 = _mm_sha256msg1_epu32(w1, w2);
+        TB_SHA256_NI_ROUNDS(w3, 3);
+        TB_SHA256_NI_SCHEDULE2(w2, w3, w0);
+        w2 = _mm_sha256msg1_epu32(w2, w3);
+
+        // rounds 16 ~ 51
+        TB_SHA256_NI_ROUNDS(w0, 4);
+        TB_SHA256_NI_SCHEDULE2(w3, w0, w1);
+        w3 = _mm_sha256msg1_epu32(w3, w0);
+        TB_SHA256_NI_ROUNDS(w1, 5);
+        TB_SHA256_NI_SCHEDULE2(w0, w1, w2);
+        w0 = _mm_sha256msg1_epu32(w0, w1);
+        TB_SHA256_NI_ROUNDS(w2, 6);
+        TB_SHA256_NI_SCHEDULE2(w1, w2, w3);
+        w1 = _mm_sha256msg1_epu32(w1, w2);
+        TB_SHA256_NI_ROUNDS(w3, 7);
+        TB_SHA256_NI_SCHEDULE2(w2, w3, w0);
+        w2 = _mm_sha256msg1_epu32(w2, w3);
+        TB_SHA256_NI_ROUNDS(w0, 8);
+        TB_SHA256_NI_SCHEDULE2(w3, w0, w1);
+        w3 = _mm_sha256msg1_epu32(w3, w0);
+        TB_SHA256_NI_ROUNDS(w1, 9);
+        TB_SHA256_NI_SCHEDULE2(w0, w1, w2);
+        w0 = _mm_sha256msg1_epu32(w0, w1);
+        TB_SHA256_NI_ROUNDS(w2, 10);
+        TB_SHA256_NI_SCHEDULE2(w1, w2, w3);
+        w1 = _mm_sha256msg1_epu32(w1, w2);
+        TB_SHA256_NI_ROUNDS(w3, 11);
+        TB_SHA256_NI_SCHEDULE2(w2, w3, w0);
+        w2 = _mm_sha256msg1_epu32(w2, w3);
+        TB_SHA256_NI_ROUNDS(w0, 12);
+        TB_SHA256_NI_SCHEDULE2(w3, w0, w1);
+        w3 = _mm_sha256msg1_epu32(w3, w0);
+
+        // rounds 52 ~ 63
+        TB_SHA256_NI_ROUNDS(w1, 13);
+        TB_SHA256_NI_SCHEDULE2(w0, w1, w2);
+        TB_SHA256_NI_ROUNDS(w2, 14);
+        TB_SHA256_NI_SCHEDULE2(w1, w2, w3);
+        TB_SHA256_NI_ROUNDS(w3, 15);
+
+        // update the state
+        state0 = _mm_add_epi32(state0, abef_save);
+        state1 = _mm_add_epi32(state1, cdgh_save);
+    }
+
+    // save the state, abef cdgh => abcd efgh
+    msg     = _mm_shuffle_epi32(state0, 0x1b);
+    state1  = _mm_shuffle_epi32(state1, 0xb1);
+    state0  = _mm_blend_epi16(msg, state1, 0xf0);
+    state1  = _mm_alignr_epi8(state1, msg, 8);
+    _mm_storeu_si128((__m128i*)&state[0], state0);
+    _mm_storeu_si128((__m128i*)&state[4], state1);
+}
+static TB_HASH_IMPL_x86_TARGET("avx2") tb_void_t tb_sha_transform_sha1_x8(tb_uint32_t (*state)[8], tb_byte_t const* blocks[8])
+{
+    // init
+    __m256i const mask = _mm256_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL, 0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m256i w[16];
+    __m256i a = _mm256_loadu_si256((__m256i const*)state[0]);
+    __m256i b = _mm256_loadu_si256((__m256i const*)state[1]);
+    __m256i c = _mm256_loadu_si256((__m256i const*)state[2]);
+    __m256i d = _mm256_loadu_si256((__m256i const*)state[3]);
+    __m256i e = _mm256_loadu_si256((__m256i const*)state[4]);
+    __m256i a0 = a, b0 = b, c0 = c, d0 = d, e0 = e;
+
+    // load the message words of all lanes, w[i] = the big-endian word i of the lanes 0 ~ 7
+    tb_size_t i;
+    tb_hash_impl_x86_load_x8(w, blocks);
+    for (i = 0; i < 16; i++) w[i] = _mm256_shuffle_epi8(w[i], mask);
+
+    // done
+    for (i = 0; i < 80; i++)
+    {
+        // the message schedule in the circular buffer
+        __m256i t;
+        if (i >= 16)
+        {
+            t = TB_SHA1_X8_XOR(TB_SHA1_X8_XOR(w[(i - 3) & 15], w[(i - 8) & 15]), TB_SHA1_X8_XOR(w[(i - 14) & 15], w[i & 15]));
+            w[i & 15] = TB_SHA1_X8_ROL(t, 1);
+        }
+
+        // the round function and constant
+        if (i < 20)
+            t = TB_SHA1_X8_ADD(TB_SHA1_X8_XOR(TB_SHA1_X8_AND(b, TB_SHA1_X8_XOR(c, d)), d), _mm256_set1_epi32(0x5a827999));
+        else if (i < 40)
+            t = TB_SHA1_X8_ADD(TB_SHA1_X8_XOR(TB_SHA1_X8_XOR(b, c), d), _mm256_set1_epi32(0x6ed9eba1));
+        else if (i < 60)
+            t = TB_SHA1_X8_ADD(TB_SHA1_X8_OR(TB_SHA1_X8_AND(TB_SHA1_X8_OR(b, c), d), TB_SHA1_X8_AND(b, c)), _mm256_set1_epi32(0x8f1bbcdc));
+        else
+            t = TB_SHA1_X8_ADD(TB_SHA1_X8_XOR(TB_SHA1_X8_XOR(b, c), d), _mm256_set1_epi32(0xca62c1d6));
+
+        // update a, b, c, d, e
+        t = TB_SHA1_X8_ADD(TB_SHA1_X8_ADD(t, w[i & 15]), TB_SHA1_X8_ADD(e, TB_SHA1_X8_ROL(a, 5)));
+        e = d;
+        d = c;
+        c = TB_SHA1_X8_ROL(b, 30);
+        b = a;
+        a = t;
+    }
+
+    // update the state
+    _mm256_storeu_si256((__m256i*)state[0], TB_SHA1_X8_ADD(a, a0));
+    _mm256_storeu_si256((__m256i*)state[1], TB_SHA1_X8_ADD(b, b0));
+    _mm256_storeu_si256((__m256i*)state[2], TB_SHA1_X8_ADD(c, c0));
+    _mm256_storeu_si256((__m256i*)state[3], TB_SHA1_X8_ADD(d, d0));
+    _mm256_storeu_si256((__m256i*)state[4], TB_SHA1_X8_ADD(e, e0));
+}
+#endif
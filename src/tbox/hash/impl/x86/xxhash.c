@@ -0,0 +1,62 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        xxhash.c
+ * @ingroup     hash
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+#ifdef TB_HASH_IMPL_x86
+
+// the avx2 xxhash3 accumulate is supported
+#define TB_HASH_IMPL_XXHASH3_x86
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+
+// accumulate the 64-bytes stripes with the two 256-bits accumulators
+static TB_HASH_IMPL_x86_TARGET("avx2") tb_void_t tb_xxhash3_accumulate_avx2(tb_uint64_t* acc, tb_byte_t const* data, tb_byte_t const* secret, tb_size_t stripes)
+{
+    // load the accumulators
+    __m256i a0 = _mm256_loadu_si256((__m256i const*)acc);
+    __m256i a1 = _mm256_loadu_si256((__m256i const*)acc + 1);
+
+    // acc[i ^ 1] += data[i], acc[i] += lo32(data[i] ^ key[i]) * hi32(data[i] ^ key[i])
+    for (; stripes; stripes--, data += 64, secret += 8)
+    {
+        __m256i d0 = _mm256_loadu_si256((__m256i const*)data);
+        __m256i d1 = _mm256_loadu_si256((__m256i const*)data + 1);
+        __m256i k0 = _mm256_xor_si256(d0, _mm256_loadu_si256((__m256i const*)secret));
+        __m256i k1 = _mm256_xor_si256(d1, _mm256_loadu_si256((__m256i const*)secret + 1));
+        a0 = _mm256_add_epi64(a0, _mm256_add_epi64(_mm256_mul_epu32(k0, _mm256_srli_epi64(k0, 32)), _mm256_shuffle_epi32(d0, _MM_SHUFFLE(1, 0, 3, 2))));
+        a1 = _mm256_add_epi64(a1, _mm256_add_epi64(_mm256_mul_epu32(k1, _mm256_srli_epi64(k1, 32)), _mm256_shuffle_epi32(d1, _MM_SHUFFLE(1, 0, 3, 2))));
+    }
+
+    // save the accumulators
+    _mm256_storeu_si256((__m256i*)acc, a0);
+    _mm256_storeu_si256((__m256i*)acc + 1, a1);
+}
+#endif
@@ -24,6 +24,10 @@
  * includes
  */
 #include "md5.h"
+#include "impl/multi.h"
+#if defined(TB_ARCH_x86) || defined(TB_ARCH_x64)
+#   include "impl/x86/md5.c"
+#endif
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * macros
@@ -67,6 +71,9 @@
  * globals
  */
 
+// the initial state
+static tb_uint32_t const g_md5_state[4] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476};
+
 /* Padding */
 static tb_byte_t g_md5_padding[64] =
 {
@@ -209,10 +216,14 @@ tb_void_t tb_md5_spak(tb_md5_t* md5, tb_byte_t const* data, tb_size_t size)
     md5->i[0] += ((tb_uint32_t)size << 3);
     md5->i[1] += ((tb_uint32_t)size >> 29);
 
-    while (size--)
+    while (size)
     {
-        // add new character to buffer, increment mdi
-        md5->ip[mdi++] = *data++;
+        // add new characters to buffer, increment mdi
+        tb_size_t n = tb_min(size, (tb_size_t)(0x40 - mdi));
+        tb_memcpy(md5->ip + mdi, data, n);
+        data += n;
+        size -= n;
+        mdi += (tb_int_t)n;
 
         // transform if necessary
         if (mdi == 0x40)
@@ -295,4 +306,33 @@ tb_size_t tb_md5_make(tb_byte_t const* ib, tb_size_t in, tb_byte_t* ob, tb_size_
     // ok
     return 16;
 }
+tb_size_t tb_md5_make_multi(tb_byte_t const** datas, tb_size_t const* sizes, tb_size_t count, tb_byte_t* digests)
+{
+    // check
+    tb_assert_and_check_return_val(datas && sizes && digests, 0);
+
+#ifdef TB_HASH_IMPL_MD5_x8
+    // make them in the parallel lanes if there are enough messages
+    if (count >= 4 && (tb_cpu_features() & TB_CPU_FEATURE_AVX2))
+    {
+        tb_hash_multi_t hash;
+        hash.transform  = tb_md5_transform_x8;
+        hash.state      = g_md5_state;
+        hash.words      = 4;
+        hash.bigendian  = tb_false;
+        tb_hash_multi_make(&hash, datas, sizes, count, digests);
+        return 16;
+    }
+#endif
 
+    // make them one by one
+    tb_size_t i;
+    for (i = 0; i < count; i++)
+    {
+        tb_md5_t md5;
+        tb_md5_init(&md5, 0);
+        tb_md5_spak(&md5, datas[i], sizes[i]);
+        tb_md5_exit(&md5, digests + (i << 4), 16);
+    }
+    return 16;
+}
@@ -84,6 +84,20 @@ tb_void_t               tb_md5_spak(tb_md5_t* md5, tb_byte_t const* data, tb_siz
  */
 tb_size_t               tb_md5_make(tb_byte_t const* ib, tb_size_t in, tb_byte_t* ob, tb_size_t on);
 
+/*! make md5 of the multiple messages
+ *
+ * the digests are computed in the 8 parallel lanes with avx2 if it is supported,
+ * it is faster than computing them one by one for many small messages, e.g. the object keys and chunks.
+ *
+ * @param datas         the message datas
+ * @param sizes         the message sizes
+ * @param count         the messages count
+ * @param digests       the output digests, count * 16 bytes
+ *
+ * @return              the digest size of each message
+ */
+tb_size_t               tb_md5_make_multi(tb_byte_t const** datas, tb_size_t const* sizes, tb_size_t count, tb_byte_t* digests);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
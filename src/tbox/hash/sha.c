@@ -24,12 +24,22 @@
  * includes
  */
 #include "sha.h"
+#include "impl/multi.h"
 #include "../utils/bits.h"
+#include "../platform/file.h"
+#include "../platform/atomic.h"
+#include "../platform/thread_pool.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * macros
  */
 
+// the default chunk size of the tree sha
+#define TB_SHA_TREE_CHUNK_SIZE          (1024 * 1024)
+
+// the read buffer size of the tree sha for the file
+#define TB_SHA_TREE_READ_SIZE           (256 * 1024)
+
 // rol
 #define TB_SHA_ROL(v, b)               (((v) << (b)) | ((v) >> (32 - (b))))
 
@@ -92,10 +102,61 @@ static tb_uint32_t const g_sha_k256[64] =
     0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
 };
 
+// the initial state of sha1
+static tb_uint32_t const g_sha_state_sha1[5] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0};
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * arch implementation
+ */
+#if defined(TB_ARCH_x86) || defined(TB_ARCH_x64)
+#   include "impl/x86/sha.c"
+#elif defined(TB_ARCH_ARM64)
+#   include "impl/arm/sha.c"
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the tree sha type
+typedef struct __tb_sha_tree_t
+{
+    // the mode
+    tb_size_t               mode;
+
+    // the input data, it is null if we read the chunks from the file
+    tb_byte_t const*        data;
+
+    // the input file
+    tb_file_ref_t           file;
+
+    // the input size
+    tb_hize_t               size;
+
+    // the chunk size
+    tb_size_t               chunk;
+
+    // the chunks count
+    tb_size_t               count;
+
+    // the next chunk index
+    tb_atomic_t             next;
+
+    // is failed?
+    tb_atomic_t             failed;
+
+    // the digest size of each chunk
+    tb_size_t               digest_size;
+
+    // the digests of all chunks
+    tb_byte_t*              digests;
+
+}tb_sha_tree_t;
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * private implementation
  */
-static tb_void_t tb_sha_transform_sha1(tb_uint32_t state[5], tb_byte_t const buffer[64])
+static tb_void_t tb_sha_transform_sha1_block(tb_uint32_t state[5], tb_byte_t const buffer[64])
 {
     // init
     tb_uint32_t block[80];
@@ -186,7 +247,7 @@ static tb_void_t tb_sha_transform_sha1(tb_uint32_t state[5], tb_byte_t const buf
     state[4] += e;
 }
 
-static tb_void_t tb_sha_transform_sha2(tb_uint32_t* state, tb_byte_t const buffer[64])
+static tb_void_t tb_sha_transform_sha2_block(tb_uint32_t* state, tb_byte_t const buffer[64])
 {
     // init
     tb_uint32_t T1;
@@ -260,6 +321,125 @@ static tb_void_t tb_sha_transform_sha2(tb_uint32_t* state, tb_byte_t const buffe
     state[6] += g;
     state[7] += h;
 }
+static tb_void_t tb_sha_transform_sha1(tb_uint32_t* state, tb_byte_t const* data, tb_size_t blocks)
+{
+    for (; blocks; blocks--, data += 64) tb_sha_transform_sha1_block(state, data);
+}
+static tb_void_t tb_sha_transform_sha2(tb_uint32_t* state, tb_byte_t const* data, tb_size_t blocks)
+{
+    for (; blocks; blocks--, data += 64) tb_sha_transform_sha2_block(state, data);
+}
+static tb_pointer_t tb_sha_transform_select(tb_size_t mode)
+{
+    // select the accelerated transform for the current cpu
+    tb_bool_t sha1 = mode == TB_SHA_MODE_SHA1_160;
+#if defined(TB_HASH_IMPL_SHA_x86)
+    tb_size_t need = TB_CPU_FEATURE_SHA | TB_CPU_FEATURE_SSE41 | TB_CPU_FEATURE_SSSE3;
+    if ((tb_cpu_features() & need) == need) return sha1? (tb_pointer_t)tb_sha_transform_sha1_x86 : (tb_pointer_t)tb_sha_transform_sha2_x86;
+#elif defined(TB_HASH_IMPL_SHA_ARM)
+    if (tb_cpu_features() & (sha1? TB_CPU_FEATURE_SHA1 : TB_CPU_FEATURE_SHA2)) return sha1? (tb_pointer_t)tb_sha_transform_sha1_arm : (tb_pointer_t)tb_sha_transform_sha2_arm;
+#endif
+    return sha1? (tb_pointer_t)tb_sha_transform_sha1 : (tb_pointer_t)tb_sha_transform_sha2;
+}
+static tb_bool_t tb_sha_tree_chunk(tb_sha_tree_t* tree, tb_size_t index, tb_byte_t** pbuffer)
+{
+    // the chunk offset and size
+    tb_hize_t offset = (tb_hize_t)index * tree->chunk;
+    tb_size_t size = (tb_size_t)tb_min((tb_hize_t)tree->chunk, tree->size - offset);
+
+    // hash this chunk
+    tb_sha_t sha;
+    tb_sha_init(&sha, tree->mode);
+    if (tree->data) tb_sha_spak(&sha, tree->data + offset, size);
+    else
+    {
+        // init the read buffer of this worker
+        if (!*pbuffer) *pbuffer = tb_malloc_bytes(TB_SHA_TREE_READ_SIZE);
+        tb_check_return_val(*pbuffer, tb_false);
+
+        // read and hash this chunk
+        while (size)
+        {
+            tb_long_t real = tb_file_pread(tree->file, *pbuffer, tb_min(size, TB_SHA_TREE_READ_SIZE), offset);
+            tb_check_return_val(real > 0, tb_false);
+
+            tb_sha_spak(&sha, *pbuffer, (tb_size_t)real);
+            offset += real;
+            size -= real;
+        }
+    }
+    tb_sha_exit(&sha, tree->digests + index * tree->digest_size, tree->digest_size);
+    return tb_true;
+}
+static tb_void_t tb_sha_tree_done(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // check
+    tb_sha_tree_t* tree = (tb_sha_tree_t*)priv;
+    tb_assert_and_check_return(tree);
+
+    // hash the next chunks until all chunks have been taken
+    tb_byte_t* buffer = tb_null;
+    while (!tb_atomic_get(&tree->failed))
+    {
+        tb_size_t index = (tb_size_t)tb_atomic_fetch_and_add(&tree->next, 1);
+        tb_check_break(index < tree->count);
+
+        if (!tb_sha_tree_chunk(tree, index, &buffer))
+            tb_atomic_set(&tree->failed, 1);
+    }
+
+    // exit the read buffer
+    if (buffer) tb_free(buffer);
+}
+static tb_size_t tb_sha_tree_make(tb_sha_tree_t* tree, tb_byte_t* ob, tb_size_t on)
+{
+    // init tree
+    tb_size_t digest_size = tree->mode >> 3;
+    tb_assert_and_check_return_val(on >= digest_size, 0);
+    if (!tree->chunk) tree->chunk = TB_SHA_TREE_CHUNK_SIZE;
+    tree->count         = tree->size? (tb_size_t)((tree->size + tree->chunk - 1) / tree->chunk) : 1;
+    tree->digest_size   = digest_size;
+    tree->digests       = (tb_byte_t*)tb_nalloc(tree->count, digest_size);
+    tb_atomic_init(&tree->next, 0);
+    tb_atomic_init(&tree->failed, 0);
+    tb_assert_and_check_return_val(tree->digests, 0);
+
+    // post the workers, the current thread is a worker too
+    tb_size_t                   i;
+    tb_thread_pool_ref_t        pool = tb_thread_pool();
+    tb_thread_pool_task_ref_t   tasks[16];
+    tb_size_t                   tasks_count = tb_min(tb_min(tree->count, tb_cpu_count()), tb_arrayn(tasks) + 1) - 1;
+    for (i = 0; i < tasks_count && pool; i++)
+    {
+        tasks[i] = tb_thread_pool_task_init(pool, "sha_tree", tb_sha_tree_done, tb_null, tree, tb_false);
+        tb_check_break(tasks[i]);
+    }
+    tasks_count = i;
+    tb_sha_tree_done(tb_null, tree);
+
+    // wait the workers
+    for (i = 0; i < tasks_count; i++)
+    {
+        tb_thread_pool_task_wait(pool, tasks[i], -1);
+        tb_thread_pool_task_exit(pool, tasks[i]);
+    }
+
+    // make the root digest of all chunk digests
+    tb_size_t size = 0;
+    if (!tb_atomic_get(&tree->failed))
+    {
+        tb_sha_t sha;
+        tb_sha_init(&sha, tree->mode);
+        tb_sha_spak(&sha, tree->digests, tree->count * digest_size);
+        tb_sha_exit(&sha, ob, on);
+        size = digest_size;
+    }
+
+    // exit digests
+    tb_free(tree->digests);
+    tree->digests = tb_null;
+    return size;
+}
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
@@ -282,7 +462,6 @@ tb_void_t tb_sha_init(tb_sha_t* sha, tb_size_t mode)
         sha->state[2] = 0x98badcfe;
         sha->state[3] = 0x10325476;
         sha->state[4] = 0xc3d2e1f0;
-        sha->transform = tb_sha_transform_sha1;
         break;
     case TB_SHA_MODE_SHA2_224:
         sha->state[0] = 0xc1059ed8;
@@ -293,7 +472,6 @@ tb_void_t tb_sha_init(tb_sha_t* sha, tb_size_t mode)
         sha->state[5] = 0x68581511;
         sha->state[6] = 0x64f98fa7;
         sha->state[7] = 0xbefa4fa4;
-        sha->transform = tb_sha_transform_sha2;
         break;
     case TB_SHA_MODE_SHA2_256:
         sha->state[0] = 0x6a09e667;
@@ -304,13 +482,13 @@ tb_void_t tb_sha_init(tb_sha_t* sha, tb_size_t mode)
         sha->state[5] = 0x9b05688c;
         sha->state[6] = 0x1f83d9ab;
         sha->state[7] = 0x5be0cd19;
-        sha->transform = tb_sha_transform_sha2;
         break;
     default:
         tb_assert(0);
         break;
     }
     sha->count = 0;
+    sha->transform = tb_sha_transform_select(mode);
 }
 tb_void_t tb_sha_exit(tb_sha_t* sha, tb_byte_t* data, tb_size_t size)
 {
@@ -320,9 +498,10 @@ tb_void_t tb_sha_exit(tb_sha_t* sha, tb_byte_t* data, tb_size_t size)
     // the count
     tb_hize_t count = tb_bits_be_to_ne_u64(sha->count << 3);
 
-    // spak
-    tb_sha_spak(sha, (tb_byte_t const*)"\200", 1);
-    while ((sha->count & 63) != 56) tb_sha_spak(sha, (tb_byte_t const*)"", 1);
+    // spak the padding data, 0x80 + zeros, and pad out to 56 mod 64
+    tb_byte_t   pad[64] = {0x80};
+    tb_size_t   left = (tb_size_t)sha->count & 63;
+    tb_sha_spak(sha, pad, left < 56? 56 - left : 120 - left);
     tb_sha_spak(sha, (tb_byte_t*)&count, 8);
 
     // done
@@ -348,7 +527,7 @@ tb_void_t tb_sha_spak(tb_sha_t* sha, tb_byte_t const* data, tb_size_t size)
         sha->buffer[j++] = data[i];
         if (64 == j)
         {
-            sha->transform(sha->state, sha->buffer);
+            sha->transform(sha->state, sha->buffer, 1);
             j = 0;
         }
     }
@@ -356,9 +535,12 @@ tb_void_t tb_sha_spak(tb_sha_t* sha, tb_byte_t const* data, tb_size_t size)
     if ((j + size) > 63)
     {
         tb_memcpy(&sha->buffer[j], data, (i = 64 - j));
-        sha->transform(sha->state, sha->buffer);
-        for (; i + 63 < size; i += 64)
-            sha->transform(sha->state, &data[i]);
+        sha->transform(sha->state, sha->buffer, 1);
+        if (size - i > 63)
+        {
+            sha->transform(sha->state, &data[i], (size - i) >> 6);
+            i += (size - i) & ~(tb_size_t)63;
+        }
         j = 0;
     }
     else i = 0;
@@ -383,4 +565,71 @@ tb_size_t tb_sha_make(tb_size_t mode, tb_byte_t const* ib, tb_size_t in, tb_byte
     // ok?
     return (sha.digest_len << 2);
 }
+tb_size_t tb_sha_make_multi(tb_size_t mode, tb_byte_t const** datas, tb_size_t const* sizes, tb_size_t count, tb_byte_t* digests)
+{
+    // check
+    tb_size_t digest_size = mode >> 3;
+    tb_assert_and_check_return_val(datas && sizes && digests, 0);
+
+#ifdef TB_HASH_IMPL_SHA1_x8
+    /* make sha1 in the parallel lanes if there are enough messages,
+     * but the sha extensions are faster than the avx2 lanes
+     */
+    tb_size_t features = tb_cpu_features();
+    if (mode == TB_SHA_MODE_SHA1_160 && count >= 4 && (features & TB_CPU_FEATURE_AVX2) && !(features & TB_CPU_FEATURE_SHA))
+    {
+        tb_hash_multi_t hash;
+        hash.transform  = tb_sha_transform_sha1_x8;
+        hash.state      = g_sha_state_sha1;
+        hash.words      = 5;
+        hash.bigendian  = tb_true;
+        tb_hash_multi_make(&hash, datas, sizes, count, digests);
+        return digest_size;
+    }
+#endif
 
+    // make them one by one
+    tb_size_t i;
+    for (i = 0; i < count; i++)
+    {
+        tb_sha_t sha;
+        tb_sha_init(&sha, mode);
+        tb_sha_spak(&sha, datas[i], sizes[i]);
+        tb_sha_exit(&sha, digests + i * digest_size, digest_size);
+    }
+    return digest_size;
+}
+tb_size_t tb_sha_make_tree(tb_size_t mode, tb_byte_t const* ib, tb_size_t in, tb_byte_t* ob, tb_size_t on, tb_size_t chunk)
+{
+    // check
+    tb_assert_and_check_return_val(ib && ob, 0);
+
+    // make it
+    tb_sha_tree_t tree = {0};
+    tree.mode   = mode;
+    tree.data   = ib;
+    tree.size   = in;
+    tree.chunk  = chunk;
+    return tb_sha_tree_make(&tree, ob, on);
+}
+tb_size_t tb_sha_make_tree_from_file(tb_size_t mode, tb_char_t const* path, tb_byte_t* ob, tb_size_t on, tb_size_t chunk)
+{
+    // check
+    tb_assert_and_check_return_val(path && ob, 0);
+
+    // init file
+    tb_file_ref_t file = tb_file_init(path, TB_FILE_MODE_RO);
+    tb_check_return_val(file, 0);
+
+    // make it
+    tb_sha_tree_t tree = {0};
+    tree.mode   = mode;
+    tree.file   = file;
+    tree.size   = tb_file_size(file);
+    tree.chunk  = chunk;
+    tb_size_t size = tb_sha_tree_make(&tree, ob, on);
+
+    // exit file
+    tb_file_exit(file);
+    return size;
+}
@@ -43,7 +43,7 @@ typedef struct __tb_sha_t
     tb_hize_t       count;       //!< number of bytes in buffer
     tb_uint8_t      buffer[64];  //!< 512-bit buffer of input values used in hash updating
     tb_uint32_t     state[8];    //!< current hash value
-    tb_void_t       (*transform)(tb_uint32_t *state, tb_uint8_t const buffer[64]);
+    tb_void_t       (*transform)(tb_uint32_t* state, tb_uint8_t const* data, tb_size_t blocks); //!< transform the 64-bytes blocks
 
 }tb_sha_t;
 
@@ -95,6 +95,61 @@ tb_void_t               tb_sha_spak(tb_sha_t* sha, tb_byte_t const* data, tb_siz
  */
 tb_size_t               tb_sha_make(tb_size_t mode, tb_byte_t const* ib, tb_size_t ip, tb_byte_t* ob, tb_size_t on);
 
+/*! make sha of the multiple messages
+ *
+ * the sha1 digests are computed in the 8 parallel lanes with avx2 if the sha extensions are not supported,
+ * it is faster than computing them one by one for many small messages, e.g. the object keys and chunks.
+ *
+ * @code
+    tb_byte_t const*    datas[] = {data1, data2, data3};
+    tb_size_t           sizes[] = {size1, size2, size3};
+    tb_byte_t           digests[3 * 20];
+    tb_sha_make_multi(TB_SHA_MODE_SHA1_160, datas, sizes, 3, digests);
+ * @endcode
+ *
+ * @param mode          the mode
+ * @param datas         the message datas
+ * @param sizes         the message sizes
+ * @param count         the messages count
+ * @param digests       the output digests, the digest size of each message is (mode >> 3)
+ *
+ * @return              the digest size of each message
+ */
+tb_size_t               tb_sha_make_multi(tb_size_t mode, tb_byte_t const** datas, tb_size_t const* sizes, tb_size_t count, tb_byte_t* digests);
+
+/*! make the tree sha of the large data in parallel
+ *
+ * the data is split into the chunks which are hashed in the thread pool,
+ * and the root digest is the sha of all chunk digests: sha(sha(chunk0) || sha(chunk1) || ...)
+ *
+ * @note the tree digest is not the same as the digest of tb_sha_make()
+ *
+ * @param mode          the mode
+ * @param ib            the input data
+ * @param in            the input size
+ * @param ob            the output data
+ * @param on            the output size
+ * @param chunk         the chunk size, using the default size (1MB) if be zero
+ *
+ * @return              the real size
+ */
+tb_size_t               tb_sha_make_tree(tb_size_t mode, tb_byte_t const* ib, tb_size_t in, tb_byte_t* ob, tb_size_t on, tb_size_t chunk);
+
+/*! make the tree sha of the given file in parallel
+ *
+ * the chunks are read and hashed by the workers of the thread pool,
+ * the digest is the same as tb_sha_make_tree() of the whole file data.
+ *
+ * @param mode          the mode
+ * @param path          the file path
+ * @param ob            the output data
+ * @param on            the output size
+ * @param chunk         the chunk size, using the default size (1MB) if be zero
+ *
+ * @return              the real size, 0 if failed
+ */
+tb_size_t               tb_sha_make_tree_from_file(tb_size_t mode, tb_char_t const* path, tb_byte_t* ob, tb_size_t on, tb_size_t chunk);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
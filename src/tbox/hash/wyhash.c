@@ -0,0 +1,145 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        wyhash.c
+ * @ingroup     hash
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "wyhash.h"
+#include "../utils/bits.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the default secret
+static tb_uint64_t const g_wyhash_secret[4] =
+{
+    0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL, 0x8ebc6af09c88c6e3ULL, 0x589965cc75374cc3ULL
+};
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static __tb_inline__ tb_void_t tb_wyhash_mum(tb_uint64_t* a, tb_uint64_t* b)
+{
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 r = (unsigned __int128)*a * *b;
+    *a = (tb_uint64_t)r;
+    *b = (tb_uint64_t)(r >> 64);
+#else
+    // the 32-bit multiplications
+    tb_uint64_t ha = *a >> 32;
+    tb_uint64_t hb = *b >> 32;
+    tb_uint64_t la = (tb_uint32_t)*a;
+    tb_uint64_t lb = (tb_uint32_t)*b;
+    tb_uint64_t rh = ha * hb;
+    tb_uint64_t rm0 = ha * lb;
+    tb_uint64_t rm1 = hb * la;
+    tb_uint64_t rl = la * lb;
+    tb_uint64_t t = rl + (rm0 << 32);
+    tb_uint64_t c = t < rl;
+    tb_uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+static __tb_inline__ tb_uint64_t tb_wyhash_mix(tb_uint64_t a, tb_uint64_t b)
+{
+    tb_wyhash_mum(&a, &b);
+    return a ^ b;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_uint64_t tb_wyhash_make(tb_byte_t const* data, tb_size_t size, tb_uint64_t seed)
+{
+    // check
+    tb_assert_and_check_return_val(data || !size, 0);
+
+    // init
+    tb_byte_t const*    p = data;
+    tb_uint64_t const*  s = g_wyhash_secret;
+    tb_uint64_t         a = 0;
+    tb_uint64_t         b = 0;
+    seed ^= tb_wyhash_mix(seed ^ s[0], s[1]);
+
+    // the short input, we read the overlapped words
+    if (size <= 16)
+    {
+        if (size >= 4)
+        {
+            tb_size_t n = (size >> 3) << 2;
+            a = ((tb_uint64_t)tb_bits_get_u32_le(p) << 32) | tb_bits_get_u32_le(p + n);
+            b = ((tb_uint64_t)tb_bits_get_u32_le(p + size - 4) << 32) | tb_bits_get_u32_le(p + size - 4 - n);
+        }
+        else if (size)
+            a = ((tb_uint64_t)p[0] << 16) | ((tb_uint64_t)p[size >> 1] << 8) | p[size - 1];
+    }
+    else
+    {
+        // mix the 48-bytes blocks with the three independent lanes
+        tb_size_t i = size;
+        if (i >= 48)
+        {
+            tb_uint64_t see1 = seed;
+            tb_uint64_t see2 = seed;
+            do
+            {
+                seed = tb_wyhash_mix(tb_bits_get_u64_le(p) ^ s[1], tb_bits_get_u64_le(p + 8) ^ seed);
+                see1 = tb_wyhash_mix(tb_bits_get_u64_le(p + 16) ^ s[2], tb_bits_get_u64_le(p + 24) ^ see1);
+                see2 = tb_wyhash_mix(tb_bits_get_u64_le(p + 32) ^ s[3], tb_bits_get_u64_le(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+
+            } while (i >= 48);
+            seed ^= see1 ^ see2;
+        }
+
+        // mix the left 16-bytes blocks
+        while (i > 16)
+        {
+            seed = tb_wyhash_mix(tb_bits_get_u64_le(p) ^ s[1], tb_bits_get_u64_le(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+
+        // the last 16 bytes, it may be overlapped with the previous block
+        a = tb_bits_get_u64_le(p + i - 16);
+        b = tb_bits_get_u64_le(p + i - 8);
+    }
+
+    // done
+    a ^= s[1];
+    b ^= seed;
+    tb_wyhash_mum(&a, &b);
+    return tb_wyhash_mix(a ^ s[0] ^ (tb_uint64_t)size, b ^ s[1]);
+}
+tb_uint64_t tb_wyhash_make_from_cstr(tb_char_t const* cstr, tb_uint64_t seed)
+{
+    // check
+    tb_assert_and_check_return_val(cstr, 0);
+
+    // make it
+    return tb_wyhash_make((tb_byte_t const*)cstr, tb_strlen(cstr), seed);
+}
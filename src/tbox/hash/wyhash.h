@@ -0,0 +1,66 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        wyhash.h
+ * @ingroup     hash
+ *
+ */
+#ifndef TB_HASH_WYHASH_H
+#define TB_HASH_WYHASH_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! make wyhash
+ *
+ * it is the same as the wyhash final4 with the default secret (the test vectors of wyhash),
+ * it is very fast for the short keys, so it is suitable for the hash table.
+ *
+ * @param data      the data
+ * @param size      the size
+ * @param seed      the seed
+ *
+ * @return          the wyhash 64-bits value
+ */
+tb_uint64_t         tb_wyhash_make(tb_byte_t const* data, tb_size_t size, tb_uint64_t seed);
+
+/*! make wyhash from c-string
+ *
+ * @param cstr      the c-string
+ * @param seed      the seed
+ *
+ * @return          the wyhash 64-bits value
+ */
+tb_uint64_t         tb_wyhash_make_from_cstr(tb_char_t const* cstr, tb_uint64_t seed);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
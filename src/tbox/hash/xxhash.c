@@ -0,0 +1,626 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        xxhash.c
+ * @ingroup     hash
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "xxhash.h"
+#include "../utils/bits.h"
+#include "../platform/cpu.h"
+#ifdef TB_ARCH_SSE2
+#   include <emmintrin.h>
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the primes
+#define TB_XXHASH_PRIME32_1             (0x9e3779b1U)
+#define TB_XXHASH_PRIME32_2             (0x85ebca77U)
+#define TB_XXHASH_PRIME32_3             (0xc2b2ae3dU)
+#define TB_XXHASH_PRIME64_1             (0x9e3779b185ebca87ULL)
+#define TB_XXHASH_PRIME64_2             (0xc2b2ae3d27d4eb4fULL)
+#define TB_XXHASH_PRIME64_3             (0x165667b19e3779f9ULL)
+#define TB_XXHASH_PRIME64_4             (0x85ebca77c2b2ae63ULL)
+#define TB_XXHASH_PRIME64_5             (0x27d4eb2f165667c5ULL)
+#define TB_XXHASH_PRIME_MX1             (0x165667919e3779f9ULL)
+#define TB_XXHASH_PRIME_MX2             (0x9fb21c651e98df25ULL)
+
+// the stripe size
+#define TB_XXHASH3_STRIPE_SIZE          (64)
+
+// the secret size
+#define TB_XXHASH3_SECRET_SIZE          (192)
+
+// the stripes count of one block, the secret is consumed 8 bytes per stripe
+#define TB_XXHASH3_BLOCK_STRIPES        ((TB_XXHASH3_SECRET_SIZE - TB_XXHASH3_STRIPE_SIZE) >> 3)
+
+// the buffer size of the streaming state
+#define TB_XXHASH3_BUFFER_SIZE          (256)
+
+// the maximum size of the short input, it need not the accumulators
+#define TB_XXHASH3_MIDSIZE_MAX          (240)
+
+// the secret offsets
+#define TB_XXHASH3_SECRET_MERGE         (11)
+#define TB_XXHASH3_SECRET_LAST          (TB_XXHASH3_SECRET_SIZE - TB_XXHASH3_STRIPE_SIZE - 7)
+#define TB_XXHASH3_SECRET_SCRAMBLE      (TB_XXHASH3_SECRET_SIZE - TB_XXHASH3_STRIPE_SIZE)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the accumulate function type
+typedef tb_void_t (*tb_xxhash3_accumulate_t)(tb_uint64_t* acc, tb_byte_t const* data, tb_byte_t const* secret, tb_size_t stripes);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the default secret
+static tb_byte_t const g_xxhash3_secret[TB_XXHASH3_SECRET_SIZE] =
+{
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+    0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+    0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+    0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+    0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+    0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+    0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+    0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+    0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e
+};
+
+// the initial accumulators
+static tb_uint64_t const g_xxhash3_acc[8] =
+{
+    TB_XXHASH_PRIME32_3, TB_XXHASH_PRIME64_1, TB_XXHASH_PRIME64_2, TB_XXHASH_PRIME64_3
+,   TB_XXHASH_PRIME64_4, TB_XXHASH_PRIME32_2, TB_XXHASH_PRIME64_5, TB_XXHASH_PRIME32_1
+};
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * arch implementation
+ */
+#if defined(TB_ARCH_x86) || defined(TB_ARCH_x64)
+#   include "impl/x86/xxhash.c"
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static __tb_inline__ tb_uint64_t tb_xxhash3_umul128(tb_uint64_t a, tb_uint64_t b, tb_uint64_t* phigh)
+{
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 r = (unsigned __int128)a * b;
+    *phigh = (tb_uint64_t)(r >> 64);
+    return (tb_uint64_t)r;
+#else
+    // the 32-bit multiplications
+    tb_uint32_t al = (tb_uint32_t)a;
+    tb_uint32_t ah = (tb_uint32_t)(a >> 32);
+    tb_uint32_t bl = (tb_uint32_t)b;
+    tb_uint32_t bh = (tb_uint32_t)(b >> 32);
+    tb_uint64_t b00 = (tb_uint64_t)al * bl;
+    tb_uint64_t b01 = (tb_uint64_t)al * bh;
+    tb_uint64_t b10 = (tb_uint64_t)ah * bl;
+    tb_uint64_t b11 = (tb_uint64_t)ah * bh;
+
+    // add the middle parts with carry
+    tb_uint64_t mid1 = b10 + (b00 >> 32);
+    tb_uint64_t mid2 = b01 + (tb_uint32_t)mid1;
+    *phigh = b11 + (mid1 >> 32) + (mid2 >> 32);
+    return (mid2 << 32) | (tb_uint32_t)b00;
+#endif
+}
+static __tb_inline__ tb_uint64_t tb_xxhash3_fold64(tb_uint64_t a, tb_uint64_t b)
+{
+    tb_uint64_t high;
+    tb_uint64_t low = tb_xxhash3_umul128(a, b, &high);
+    return low ^ high;
+}
+static __tb_inline__ tb_uint64_t tb_xxhash3_rotl64(tb_uint64_t x, tb_size_t n)
+{
+    return (x << n) | (x >> (64 - n));
+}
+static __tb_inline__ tb_uint64_t tb_xxhash64_avalanche(tb_uint64_t h)
+{
+    h ^= h >> 33;
+    h *= TB_XXHASH_PRIME64_2;
+    h ^= h >> 29;
+    h *= TB_XXHASH_PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+static __tb_inline__ tb_uint64_t tb_xxhash3_avalanche(tb_uint64_t h)
+{
+    h ^= h >> 37;
+    h *= TB_XXHASH_PRIME_MX1;
+    h ^= h >> 32;
+    return h;
+}
+static __tb_inline__ tb_uint64_t tb_xxhash3_rrmxmx(tb_uint64_t h, tb_uint64_t size)
+{
+    h ^= tb_xxhash3_rotl64(h, 49) ^ tb_xxhash3_rotl64(h, 24);
+    h *= TB_XXHASH_PRIME_MX2;
+    h ^= (h >> 35) + size;
+    h *= TB_XXHASH_PRIME_MX2;
+    h ^= h >> 28;
+    return h;
+}
+static __tb_inline__ tb_uint64_t tb_xxhash3_mix16(tb_byte_t const* data, tb_byte_t const* secret, tb_uint64_t seed)
+{
+    tb_uint64_t lo = tb_bits_get_u64_le(data);
+    tb_uint64_t hi = tb_bits_get_u64_le(data + 8);
+    return tb_xxhash3_fold64(lo ^ (tb_bits_get_u64_le(secret) + seed), hi ^ (tb_bits_get_u64_le(secret + 8) - seed));
+}
+static __tb_inline__ tb_void_t tb_xxhash3_mix32(tb_uint64_t acc[2], tb_byte_t const* data1, tb_byte_t const* data2, tb_byte_t const* secret, tb_uint64_t seed)
+{
+    acc[0] += tb_xxhash3_mix16(data1, secret, seed);
+    acc[0] ^= tb_bits_get_u64_le(data2) + tb_bits_get_u64_le(data2 + 8);
+    acc[1] += tb_xxhash3_mix16(data2, secret + 16, seed);
+    acc[1] ^= tb_bits_get_u64_le(data1) + tb_bits_get_u64_le(data1 + 8);
+}
+static tb_void_t tb_xxhash3_secret_init(tb_byte_t* secret, tb_uint64_t seed)
+{
+    // derive the secret from the seed for the long input
+    tb_size_t i = 0;
+    for (i = 0; i < TB_XXHASH3_SECRET_SIZE; i += 16)
+    {
+        tb_bits_set_u64_le(secret + i, tb_bits_get_u64_le(g_xxhash3_secret + i) + seed);
+        tb_bits_set_u64_le(secret + i + 8, tb_bits_get_u64_le(g_xxhash3_secret + i + 8) - seed);
+    }
+}
+static tb_void_t tb_xxhash3_accumulate(tb_uint64_t* acc, tb_byte_t const* data, tb_byte_t const* secret, tb_size_t stripes)
+{
+#ifdef TB_ARCH_SSE2
+    // load the accumulators
+    __m128i a0 = _mm_loadu_si128((__m128i const*)acc);
+    __m128i a1 = _mm_loadu_si128((__m128i const*)acc + 1);
+    __m128i a2 = _mm_loadu_si128((__m128i const*)acc + 2);
+    __m128i a3 = _mm_loadu_si128((__m128i const*)acc + 3);
+
+    // acc[i ^ 1] += data[i], acc[i] += lo32(data[i] ^ key[i]) * hi32(data[i] ^ key[i])
+#   define TB_XXHASH3_ACCUMULATE_SSE2(a, i) \
+    do \
+    { \
+        __m128i d = _mm_loadu_si128((__m128i const*)data + (i)); \
+        __m128i k = _mm_xor_si128(d, _mm_loadu_si128((__m128i const*)secret + (i))); \
+        __m128i p = _mm_mul_epu32(k, _mm_shuffle_epi32(k, _MM_SHUFFLE(0, 3, 0, 1))); \
+        a = _mm_add_epi64(a, _mm_add_epi64(p, _mm_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2)))); \
+    } while (0)
+    for (; stripes; stripes--, data += TB_XXHASH3_STRIPE_SIZE, secret += 8)
+    {
+        TB_XXHASH3_ACCUMULATE_SSE2(a0, 0);
+        TB_XXHASH3_ACCUMULATE_SSE2(a1, 1);
+        TB_XXHASH3_ACCUMULATE_SSE2(a2, 2);
+        TB_XXHASH3_ACCUMULATE_SSE2(a3, 3);
+    }
+#   undef TB_XXHASH3_ACCUMULATE_SSE2
+
+    // save the accumulators
+    _mm_storeu_si128((__m128i*)acc, a0);
+    _mm_storeu_si128((__m128i*)acc + 1, a1);
+    _mm_storeu_si128((__m128i*)acc + 2, a2);
+    _mm_storeu_si128((__m128i*)acc + 3, a3);
+#else
+    tb_size_t i = 0;
+    for (; stripes; stripes--, data += TB_XXHASH3_STRIPE_SIZE, secret += 8)
+    {
+        for (i = 0; i < 8; i++)
+        {
+            tb_uint64_t d = tb_bits_get_u64_le(data + (i << 3));
+            tb_uint64_t k = d ^ tb_bits_get_u64_le(secret + (i << 3));
+            acc[i ^ 1] += d;
+            acc[i] += (tb_uint64_t)(tb_uint32_t)k * (tb_uint32_t)(k >> 32);
+        }
+    }
+#endif
+}
+static tb_void_t tb_xxhash3_scramble(tb_uint64_t* acc, tb_byte_t const* secret)
+{
+    tb_size_t i = 0;
+    for (i = 0; i < 8; i++)
+    {
+        tb_uint64_t a = acc[i];
+        a ^= a >> 47;
+        a ^= tb_bits_get_u64_le(secret + (i << 3));
+        acc[i] = a * TB_XXHASH_PRIME32_1;
+    }
+}
+static tb_xxhash3_accumulate_t tb_xxhash3_accumulate_select()
+{
+    // select the accelerated accumulate function for the current cpu
+#ifdef TB_HASH_IMPL_XXHASH3_x86
+    if (tb_cpu_features() & TB_CPU_FEATURE_AVX2) return tb_xxhash3_accumulate_avx2;
+#endif
+    return tb_xxhash3_accumulate;
+}
+static tb_uint64_t tb_xxhash3_merge(tb_uint64_t const* acc, tb_byte_t const* secret, tb_uint64_t value)
+{
+    tb_size_t i = 0;
+    for (i = 0; i < 4; i++)
+        value += tb_xxhash3_fold64(acc[i << 1] ^ tb_bits_get_u64_le(secret + (i << 4)), acc[(i << 1) + 1] ^ tb_bits_get_u64_le(secret + (i << 4) + 8));
+    return tb_xxhash3_avalanche(value);
+}
+static tb_size_t tb_xxhash3_consume(tb_uint64_t* acc, tb_size_t stripes_acc, tb_byte_t const* data, tb_size_t stripes, tb_byte_t const* secret, tb_xxhash3_accumulate_t accumulate)
+{
+    // the current block will be full? scramble it and continue to accumulate the next block
+    if (TB_XXHASH3_BLOCK_STRIPES - stripes_acc <= stripes)
+    {
+        tb_size_t left = TB_XXHASH3_BLOCK_STRIPES - stripes_acc;
+        accumulate(acc, data, secret + (stripes_acc << 3), left);
+        tb_xxhash3_scramble(acc, secret + TB_XXHASH3_SECRET_SCRAMBLE);
+        accumulate(acc, data + left * TB_XXHASH3_STRIPE_SIZE, secret, stripes - left);
+        return stripes - left;
+    }
+    accumulate(acc, data, secret + (stripes_acc << 3), stripes);
+    return stripes_acc + stripes;
+}
+static tb_void_t tb_xxhash3_long(tb_uint64_t* acc, tb_byte_t const* data, tb_size_t size, tb_byte_t const* secret)
+{
+    // init the accumulators
+    tb_memcpy(acc, g_xxhash3_acc, sizeof(g_xxhash3_acc));
+
+    // accumulate all full blocks
+    tb_xxhash3_accumulate_t accumulate = tb_xxhash3_accumulate_select();
+    tb_size_t               block = TB_XXHASH3_BLOCK_STRIPES * TB_XXHASH3_STRIPE_SIZE;
+    tb_size_t               blocks = (size - 1) / block;
+    tb_size_t               i = 0;
+    for (i = 0; i < blocks; i++)
+    {
+        accumulate(acc, data + i * block, secret, TB_XXHASH3_BLOCK_STRIPES);
+        tb_xxhash3_scramble(acc, secret + TB_XXHASH3_SECRET_SCRAMBLE);
+    }
+
+    // accumulate the left stripes and the last stripe
+    accumulate(acc, data + blocks * block, secret, ((size - 1) - blocks * block) / TB_XXHASH3_STRIPE_SIZE);
+    accumulate(acc, data + size - TB_XXHASH3_STRIPE_SIZE, secret + TB_XXHASH3_SECRET_LAST, 1);
+}
+static tb_uint64_t tb_xxhash3_make_0to16(tb_byte_t const* data, tb_size_t size, tb_uint64_t seed, tb_byte_t const* secret)
+{
+    if (size > 8)
+    {
+        tb_uint64_t lo = tb_bits_get_u64_le(data) ^ ((tb_bits_get_u64_le(secret + 24) ^ tb_bits_get_u64_le(secret + 32)) + seed);
+        tb_uint64_t hi = tb_bits_get_u64_le(data + size - 8) ^ ((tb_bits_get_u64_le(secret + 40) ^ tb_bits_get_u64_le(secret + 48)) - seed);
+        return tb_xxhash3_avalanche((tb_uint64_t)size + tb_bits_swap_u64(lo) + hi + tb_xxhash3_fold64(lo, hi));
+    }
+    else if (size >= 4)
+    {
+        seed ^= (tb_uint64_t)tb_bits_swap_u32((tb_uint32_t)seed) << 32;
+        tb_uint64_t flip = (tb_bits_get_u64_le(secret + 8) ^ tb_bits_get_u64_le(secret + 16)) - seed;
+        tb_uint64_t value = (tb_uint64_t)tb_bits_get_u32_le(data + size - 4) + ((tb_uint64_t)tb_bits_get_u32_le(data) << 32);
+        return tb_xxhash3_rrmxmx(value ^ flip, size);
+    }
+    else if (size)
+    {
+        tb_uint32_t combo = ((tb_uint32_t)data[0] << 16) | ((tb_uint32_t)data[size >> 1] << 24) | (tb_uint32_t)data[size - 1] | ((tb_uint32_t)size << 8);
+        tb_uint64_t flip = (tb_uint64_t)(tb_bits_get_u32_le(secret) ^ tb_bits_get_u32_le(secret + 4)) + seed;
+        return tb_xxhash64_avalanche((tb_uint64_t)combo ^ flip);
+    }
+    return tb_xxhash64_avalanche(seed ^ tb_bits_get_u64_le(secret + 56) ^ tb_bits_get_u64_le(secret + 64));
+}
+static tb_uint64_t tb_xxhash3_make_17to128(tb_byte_t const* data, tb_size_t size, tb_uint64_t seed, tb_byte_t const* secret)
+{
+    tb_uint64_t acc = (tb_uint64_t)size * TB_XXHASH_PRIME64_1;
+    if (size > 32)
+    {
+        if (size > 64)
+        {
+            if (size > 96)
+            {
+                acc += tb_xxhash3_mix16(data + 48, secret + 96, seed);
+                acc += tb_xxhash3_mix16(data + size - 64, secret + 112, seed);
+            }
+            acc += tb_xxhash3_mix16(data + 32, secret + 64, seed);
+            acc += tb_xxhash3_mix16(data + size - 48, secret + 80, seed);
+        }
+        acc += tb_xxhash3_mix16(data + 16, secret + 32, seed);
+        acc += tb_xxhash3_mix16(data + size - 32, secret + 48, seed);
+    }
+    acc += tb_xxhash3_mix16(data, secret, seed);
+    acc += tb_xxhash3_mix16(data + size - 16, secret + 16, seed);
+    return tb_xxhash3_avalanche(acc);
+}
+static tb_uint64_t tb_xxhash3_make_129to240(tb_byte_t const* data, tb_size_t size, tb_uint64_t seed, tb_byte_t const* secret)
+{
+    tb_uint64_t acc = (tb_uint64_t)size * TB_XXHASH_PRIME64_1;
+    tb_size_t   rounds = size >> 4;
+    tb_size_t   i = 0;
+    for (i = 0; i < 8; i++) acc += tb_xxhash3_mix16(data + (i << 4), secret + (i << 4), seed);
+    acc = tb_xxhash3_avalanche(acc);
+    for (i = 8; i < rounds; i++) acc += tb_xxhash3_mix16(data + (i << 4), secret + ((i - 8) << 4) + 3, seed);
+    acc += tb_xxhash3_mix16(data + size - 16, secret + 136 - 17, seed);
+    return tb_xxhash3_avalanche(acc);
+}
+static tb_uint64_t tb_xxhash3_make_short(tb_byte_t const* data, tb_size_t size, tb_uint64_t seed)
+{
+    if (size <= 16) return tb_xxhash3_make_0to16(data, size, seed, g_xxhash3_secret);
+    else if (size <= 128) return tb_xxhash3_make_17to128(data, size, seed, g_xxhash3_secret);
+    return tb_xxhash3_make_129to240(data, size, seed, g_xxhash3_secret);
+}
+static tb_void_t tb_xxhash3_make128_0to16(tb_byte_t const* data, tb_size_t size, tb_uint64_t seed, tb_byte_t const* secret, tb_uint64_t hash[2])
+{
+    if (size > 8)
+    {
+        tb_uint64_t flip_lo = (tb_bits_get_u64_le(secret + 32) ^ tb_bits_get_u64_le(secret + 40)) - seed;
+        tb_uint64_t flip_hi = (tb_bits_get_u64_le(secret + 48) ^ tb_bits_get_u64_le(secret + 56)) + seed;
+        tb_uint64_t input_lo = tb_bits_get_u64_le(data);
+        tb_uint64_t input_hi = tb_bits_get_u64_le(data + size - 8);
+        tb_uint64_t mul_hi;
+        tb_uint64_t mul_lo = tb_xxhash3_umul128(input_lo ^ input_hi ^ flip_lo, TB_XXHASH_PRIME64_1, &mul_hi);
+        mul_lo += (tb_uint64_t)(size - 1) << 54;
+        input_hi ^= flip_hi;
+        mul_hi += input_hi + (tb_uint64_t)(tb_uint32_t)input_hi * (TB_XXHASH_PRIME32_2 - 1);
+        mul_lo ^= tb_bits_swap_u64(mul_hi);
+        tb_uint64_t hi;
+        tb_uint64_t lo = tb_xxhash3_umul128(mul_lo, TB_XXHASH_PRIME64_2, &hi);
+        hi += mul_hi * TB_XXHASH_PRIME64_2;
+        hash[0] = tb_xxhash3_avalanche(lo);
+        hash[1] = tb_xxhash3_avalanche(hi);
+    }
+    else if (size >= 4)
+    {
+        seed ^= (tb_uint64_t)tb_bits_swap_u32((tb_uint32_t)seed) << 32;
+        tb_uint64_t value = (tb_uint64_t)tb_bits_get_u32_le(data) + ((tb_uint64_t)tb_bits_get_u32_le(data + size - 4) << 32);
+        tb_uint64_t flip = (tb_bits_get_u64_le(secret + 16) ^ tb_bits_get_u64_le(secret + 24)) + seed;
+        tb_uint64_t hi;
+        tb_uint64_t lo = tb_xxhash3_umul128(value ^ flip, TB_XXHASH_PRIME64_1 + ((tb_uint64_t)size << 2), &hi);
+        hi += lo << 1;
+        lo ^= hi >> 3;
+        lo ^= lo >> 35;
+        lo *= TB_XXHASH_PRIME_MX2;
+        lo ^= lo >> 28;
+        hash[0] = lo;
+        hash[1] = tb_xxhash3_avalanche(hi);
+    }
+    else if (size)
+    {
+        tb_uint32_t lo = ((tb_uint32_t)data[0] << 16) | ((tb_uint32_t)data[size >> 1] << 24) | (tb_uint32_t)data[size - 1] | ((tb_uint32_t)size << 8);
+        tb_uint32_t hi = tb_bits_swap_u32(lo);
+        hi = (hi << 13) | (hi >> 19);
+        hash[0] = tb_xxhash64_avalanche((tb_uint64_t)lo ^ ((tb_uint64_t)(tb_bits_get_u32_le(secret) ^ tb_bits_get_u32_le(secret + 4)) + seed));
+        hash[1] = tb_xxhash64_avalanche((tb_uint64_t)hi ^ ((tb_uint64_t)(tb_bits_get_u32_le(secret + 8) ^ tb_bits_get_u32_le(secret + 12)) - seed));
+    }
+    else
+    {
+        hash[0] = tb_xxhash64_avalanche(seed ^ tb_bits_get_u64_le(secret + 64) ^ tb_bits_get_u64_le(secret + 72));
+        hash[1] = tb_xxhash64_avalanche(seed ^ tb_bits_get_u64_le(secret + 80) ^ tb_bits_get_u64_le(secret + 88));
+    }
+}
+static tb_void_t tb_xxhash3_make128_17to240(tb_byte_t const* data, tb_size_t size, tb_uint64_t seed, tb_byte_t const* secret, tb_uint64_t hash[2])
+{
+    tb_uint64_t acc[2];
+    acc[0] = (tb_uint64_t)size * TB_XXHASH_PRIME64_1;
+    acc[1] = 0;
+    if (size <= 128)
+    {
+        if (size > 32)
+        {
+            if (size > 64)
+            {
+                if (size > 96) tb_xxhash3_mix32(acc, data + 48, data + size - 64, secret + 96, seed);
+                tb_xxhash3_mix32(acc, data + 32, data + size - 48, secret + 64, seed);
+            }
+            tb_xxhash3_mix32(acc, data + 16, data + size - 32, secret + 32, seed);
+        }
+        tb_xxhash3_mix32(acc, data, data + size - 16, secret, seed);
+    }
+    else
+    {
+        tb_size_t rounds = size >> 5;
+        tb_size_t i = 0;
+        for (i = 0; i < 4; i++) tb_xxhash3_mix32(acc, data + (i << 5), data + (i << 5) + 16, secret + (i << 5), seed);
+        acc[0] = tb_xxhash3_avalanche(acc[0]);
+        acc[1] = tb_xxhash3_avalanche(acc[1]);
+        for (i = 4; i < rounds; i++) tb_xxhash3_mix32(acc, data + (i << 5), data + (i << 5) + 16, secret + ((i - 4) << 5) + 3, seed);
+        tb_xxhash3_mix32(acc, data + size - 16, data + size - 32, secret + 136 - 17 - 16, 0 - seed);
+    }
+    hash[0] = tb_xxhash3_avalanche(acc[0] + acc[1]);
+    hash[1] = 0 - tb_xxhash3_avalanche(acc[0] * TB_XXHASH_PRIME64_1 + acc[1] * TB_XXHASH_PRIME64_4 + ((tb_uint64_t)size - seed) * TB_XXHASH_PRIME64_2);
+}
+static tb_void_t tb_xxhash3_make128_short(tb_byte_t const* data, tb_size_t size, tb_uint64_t seed, tb_uint64_t hash[2])
+{
+    if (size <= 16) tb_xxhash3_make128_0to16(data, size, seed, g_xxhash3_secret, hash);
+    else tb_xxhash3_make128_17to240(data, size, seed, g_xxhash3_secret, hash);
+}
+static tb_void_t tb_xxhash3_merge128(tb_uint64_t const* acc, tb_byte_t const* secret, tb_hize_t size, tb_uint64_t hash[2])
+{
+    hash[0] = tb_xxhash3_merge(acc, secret + TB_XXHASH3_SECRET_MERGE, (tb_uint64_t)size * TB_XXHASH_PRIME64_1);
+    hash[1] = tb_xxhash3_merge(acc, secret + TB_XXHASH3_SECRET_SIZE - 64 - TB_XXHASH3_SECRET_MERGE, ~((tb_uint64_t)size * TB_XXHASH_PRIME64_2));
+}
+static tb_void_t tb_xxhash3_digest(tb_xxhash3_t* xxhash, tb_uint64_t* acc)
+{
+    // accumulate the buffered stripes on the copied accumulators, so the state can be continued
+    tb_memcpy(acc, xxhash->acc, sizeof(xxhash->acc));
+    if (xxhash->buffer_size >= TB_XXHASH3_STRIPE_SIZE)
+    {
+        tb_size_t stripes = (xxhash->buffer_size - 1) / TB_XXHASH3_STRIPE_SIZE;
+        tb_xxhash3_consume(acc, xxhash->stripes, xxhash->buffer, stripes, xxhash->secret, xxhash->accumulate);
+        xxhash->accumulate(acc, xxhash->buffer + xxhash->buffer_size - TB_XXHASH3_STRIPE_SIZE, xxhash->secret + TB_XXHASH3_SECRET_LAST, 1);
+    }
+    else
+    {
+        // the last stripe is made of the tail of the previous buffer and the buffered data
+        tb_byte_t last[TB_XXHASH3_STRIPE_SIZE];
+        tb_size_t catchup = TB_XXHASH3_STRIPE_SIZE - xxhash->buffer_size;
+        tb_memcpy(last, xxhash->buffer + TB_XXHASH3_BUFFER_SIZE - catchup, catchup);
+        tb_memcpy(last + catchup, xxhash->buffer, xxhash->buffer_size);
+        xxhash->accumulate(acc, last, xxhash->secret + TB_XXHASH3_SECRET_LAST, 1);
+    }
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_void_t tb_xxhash3_init(tb_xxhash3_t* xxhash, tb_uint64_t seed)
+{
+    // check
+    tb_assert_and_check_return(xxhash);
+
+    // init it
+    tb_memcpy(xxhash->acc, g_xxhash3_acc, sizeof(g_xxhash3_acc));
+    if (seed) tb_xxhash3_secret_init(xxhash->secret, seed);
+    else tb_memcpy(xxhash->secret, g_xxhash3_secret, sizeof(g_xxhash3_secret));
+    xxhash->buffer_size = 0;
+    xxhash->stripes     = 0;
+    xxhash->total       = 0;
+    xxhash->seed        = seed;
+    xxhash->accumulate  = tb_xxhash3_accumulate_select();
+}
+tb_void_t tb_xxhash3_spak(tb_xxhash3_t* xxhash, tb_byte_t const* data, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return(xxhash && (data || !size));
+
+    // only buffer it if the buffer is not full
+    xxhash->total += size;
+    if (size <= TB_XXHASH3_BUFFER_SIZE - xxhash->buffer_size)
+    {
+        tb_memcpy(xxhash->buffer + xxhash->buffer_size, data, size);
+        xxhash->buffer_size += size;
+        return ;
+    }
+
+    // fill and consume the buffer
+    tb_size_t stripes = TB_XXHASH3_BUFFER_SIZE / TB_XXHASH3_STRIPE_SIZE;
+    if (xxhash->buffer_size)
+    {
+        tb_size_t fill = TB_XXHASH3_BUFFER_SIZE - xxhash->buffer_size;
+        tb_memcpy(xxhash->buffer + xxhash->buffer_size, data, fill);
+        data += fill;
+        size -= fill;
+        xxhash->stripes = tb_xxhash3_consume(xxhash->acc, xxhash->stripes, xxhash->buffer, stripes, xxhash->secret, xxhash->accumulate);
+        xxhash->buffer_size = 0;
+    }
+
+    // consume the input data directly, we always keep the last bytes for the digest
+    if (size > TB_XXHASH3_BUFFER_SIZE)
+    {
+        do
+        {
+            xxhash->stripes = tb_xxhash3_consume(xxhash->acc, xxhash->stripes, data, stripes, xxhash->secret, xxhash->accumulate);
+            data += TB_XXHASH3_BUFFER_SIZE;
+            size -= TB_XXHASH3_BUFFER_SIZE;
+
+        } while (size > TB_XXHASH3_BUFFER_SIZE);
+
+        // save the last consumed stripe, it may be used for the last stripe of the digest
+        tb_memcpy(xxhash->buffer + TB_XXHASH3_BUFFER_SIZE - TB_XXHASH3_STRIPE_SIZE, data - TB_XXHASH3_STRIPE_SIZE, TB_XXHASH3_STRIPE_SIZE);
+    }
+
+    // buffer the left data
+    tb_memcpy(xxhash->buffer, data, size);
+    xxhash->buffer_size = size;
+}
+tb_uint64_t tb_xxhash3_exit(tb_xxhash3_t* xxhash)
+{
+    // check
+    tb_assert_and_check_return_val(xxhash, 0);
+
+    // the short input? it is hashed with the default secret and the seed
+    if (xxhash->total <= TB_XXHASH3_MIDSIZE_MAX)
+        return tb_xxhash3_make_short(xxhash->buffer, (tb_size_t)xxhash->total, xxhash->seed);
+
+    // digest the long input
+    tb_uint64_t acc[8];
+    tb_xxhash3_digest(xxhash, acc);
+    return tb_xxhash3_merge(acc, xxhash->secret + TB_XXHASH3_SECRET_MERGE, (tb_uint64_t)xxhash->total * TB_XXHASH_PRIME64_1);
+}
+tb_void_t tb_xxhash3_exit128(tb_xxhash3_t* xxhash, tb_uint64_t hash[2])
+{
+    // check
+    tb_assert_and_check_return(xxhash && hash);
+
+    // the short input?
+    if (xxhash->total <= TB_XXHASH3_MIDSIZE_MAX)
+    {
+        tb_xxhash3_make128_short(xxhash->buffer, (tb_size_t)xxhash->total, xxhash->seed, hash);
+        return ;
+    }
+
+    // digest the long input
+    tb_uint64_t acc[8];
+    tb_xxhash3_digest(xxhash, acc);
+    tb_xxhash3_merge128(acc, xxhash->secret, xxhash->total, hash);
+}
+tb_uint64_t tb_xxhash3_make(tb_byte_t const* data, tb_size_t size, tb_uint64_t seed)
+{
+    // check
+    tb_assert_and_check_return_val(data || !size, 0);
+
+    // the short input
+    if (size <= TB_XXHASH3_MIDSIZE_MAX) return tb_xxhash3_make_short(data, size, seed);
+
+    // init the secret
+    tb_byte_t           secret_seeded[TB_XXHASH3_SECRET_SIZE];
+    tb_byte_t const*    secret = g_xxhash3_secret;
+    if (seed)
+    {
+        tb_xxhash3_secret_init(secret_seeded, seed);
+        secret = secret_seeded;
+    }
+
+    // hash the long input
+    tb_uint64_t acc[8];
+    tb_xxhash3_long(acc, data, size, secret);
+    return tb_xxhash3_merge(acc, secret + TB_XXHASH3_SECRET_MERGE, (tb_uint64_t)size * TB_XXHASH_PRIME64_1);
+}
+tb_uint64_t tb_xxhash3_make_from_cstr(tb_char_t const* cstr, tb_uint64_t seed)
+{
+    // check
+    tb_assert_and_check_return_val(cstr, 0);
+
+    // make it
+    return tb_xxhash3_make((tb_byte_t const*)cstr, tb_strlen(cstr), seed);
+}
+tb_void_t tb_xxhash3_make128(tb_byte_t const* data, tb_size_t size, tb_uint64_t seed, tb_uint64_t hash[2])
+{
+    // check
+    tb_assert_and_check_return(hash);
+    hash[0] = hash[1] = 0;
+    tb_assert_and_check_return(data || !size);
+
+    // the short input
+    if (size <= TB_XXHASH3_MIDSIZE_MAX)
+    {
+        tb_xxhash3_make128_short(data, size, seed, hash);
+        return ;
+    }
+
+    // init the secret
+    tb_byte_t           secret_seeded[TB_XXHASH3_SECRET_SIZE];
+    tb_byte_t const*    secret = g_xxhash3_secret;
+    if (seed)
+    {
+        tb_xxhash3_secret_init(secret_seeded, seed);
+        secret = secret_seeded;
+    }
+
+    // hash the long input
+    tb_uint64_t acc[8];
+    tb_xxhash3_long(acc, data, size, secret);
+    tb_xxhash3_merge128(acc, secret, size, hash);
+}
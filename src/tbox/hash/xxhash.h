@@ -0,0 +1,127 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        xxhash.h
+ * @ingroup     hash
+ *
+ */
+#ifndef TB_HASH_XXHASH_H
+#define TB_HASH_XXHASH_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the xxhash3 streaming state
+typedef struct __tb_xxhash3_t
+{
+    tb_uint64_t     acc[8];         //!< the accumulators
+    tb_byte_t       secret[192];    //!< the secret derived from the seed
+    tb_byte_t       buffer[256];    //!< the buffered input, it keeps the last stripe for the digest
+    tb_size_t       buffer_size;    //!< the buffered size
+    tb_size_t       stripes;        //!< the accumulated stripes count in the current block
+    tb_hize_t       total;          //!< the total input size
+    tb_uint64_t     seed;           //!< the seed
+    tb_void_t       (*accumulate)(tb_uint64_t* acc, tb_byte_t const* data, tb_byte_t const* secret, tb_size_t stripes); //!< accumulate the 64-bytes stripes
+
+}tb_xxhash3_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init xxhash3
+ *
+ * @param xxhash        the xxhash3 state
+ * @param seed          the seed
+ */
+tb_void_t               tb_xxhash3_init(tb_xxhash3_t* xxhash, tb_uint64_t seed);
+
+/*! spak xxhash3
+ *
+ * @param xxhash        the xxhash3 state
+ * @param data          the data
+ * @param size          the size
+ */
+tb_void_t               tb_xxhash3_spak(tb_xxhash3_t* xxhash, tb_byte_t const* data, tb_size_t size);
+
+/*! exit xxhash3 and get the 64-bits hash
+ *
+ * the state is not changed, so we can continue to spak more data after it
+ *
+ * @param xxhash        the xxhash3 state
+ *
+ * @return              the xxh3 64-bits value
+ */
+tb_uint64_t             tb_xxhash3_exit(tb_xxhash3_t* xxhash);
+
+/*! exit xxhash3 and get the 128-bits hash
+ *
+ * @param xxhash        the xxhash3 state
+ * @param hash          the 128-bits value, hash[0]: the low 64-bits, hash[1]: the high 64-bits
+ */
+tb_void_t               tb_xxhash3_exit128(tb_xxhash3_t* xxhash, tb_uint64_t hash[2]);
+
+/*! make xxhash3
+ *
+ * it is the same as the canonical XXH3_64bits_withSeed()
+ *
+ * @param data          the data
+ * @param size          the size
+ * @param seed          the seed
+ *
+ * @return              the xxh3 64-bits value
+ */
+tb_uint64_t             tb_xxhash3_make(tb_byte_t const* data, tb_size_t size, tb_uint64_t seed);
+
+/*! make xxhash3 from c-string
+ *
+ * @param cstr          the c-string
+ * @param seed          the seed
+ *
+ * @return              the xxh3 64-bits value
+ */
+tb_uint64_t             tb_xxhash3_make_from_cstr(tb_char_t const* cstr, tb_uint64_t seed);
+
+/*! make the 128-bits xxhash3
+ *
+ * it is the same as the canonical XXH3_128bits_withSeed(),
+ * the two halves can be used as the independent hashes, e.g. the double hashing of the bloom filter.
+ *
+ * @param data          the data
+ * @param size          the size
+ * @param seed          the seed
+ * @param hash          the 128-bits value, hash[0]: the low 64-bits, hash[1]: the high 64-bits
+ */
+tb_void_t               tb_xxhash3_make128(tb_byte_t const* data, tb_size_t size, tb_uint64_t seed, tb_uint64_t hash[2]);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
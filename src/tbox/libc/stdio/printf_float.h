@@ -0,0 +1,90 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        printf_float.h
+ * @ingroup     libc
+ *
+ */
+#ifndef TB_LIBC_STDIO_PRINTF_FLOAT_H
+#define TB_LIBC_STDIO_PRINTF_FLOAT_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the maximum count of the exact decimal digits of the double, 2^53 * 5^1074 < 10^767
+#define TB_PRINTF_DOUBLE_EXACT_MAXN         (768)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+#ifdef TB_CONFIG_TYPE_HAVE_FLOAT
+
+/* get the shortest decimal representation of the double, it can be parsed back to the same double
+ *
+ * it uses the ryu algorithm, so only the 64-bit integer arithmetic is used.
+ *
+ * e.g. 0.3 => 3 * 10^-1, 1e23 => 1 * 10^23, 5e-324 => 5 * 10^-324
+ *
+ * @param num       the finite double, the sign will be ignored
+ * @param pexp      the decimal exponent, num = mantissa * 10^exp
+ *
+ * @return          the decimal mantissa, at most 17 digits
+ */
+tb_uint64_t         tb_printf_double_decimal(tb_double_t num, tb_int_t* pexp);
+
+/* get the shortest decimal representation of the float, it can be parsed back to the same float
+ *
+ * @param num       the finite float, the sign will be ignored
+ * @param pexp      the decimal exponent, num = mantissa * 10^exp
+ *
+ * @return          the decimal mantissa, at most 9 digits
+ */
+tb_uint32_t         tb_printf_float_decimal(tb_float_t num, tb_int_t* pexp);
+
+/* get the exact decimal digits of the double, num = 0.digits * 10^point
+ *
+ * the binary double is always a finite decimal, so we can get all digits of it by the big integer,
+ * it is used to round the digits correctly for the given precision, e.g. 1.005 => 1.00499999999999989...
+ *
+ * @param num       the finite double, the sign will be ignored
+ * @param digits    the digits buffer, the trailing zeros will be removed and it is not null-terminated
+ * @param maxn      the digits buffer size, need TB_PRINTF_DOUBLE_EXACT_MAXN
+ * @param ppoint    the position of the decimal point
+ *
+ * @return          the digits count
+ */
+tb_size_t           tb_printf_double_exact(tb_double_t num, tb_char_t* digits, tb_size_t maxn, tb_int_t* ppoint);
+
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -167,14 +167,16 @@ tb_long_t           tb_wputs(tb_wchar_t const* string);
  *              This type differs slightly from fixed-point notation in
  *              that insignificant zeroes to the right of the decimal point are not included.
  *              Also, the decimal point is not included on whole numbers.
+ *              If no precision, it prints the shortest digits which can be parsed to the same number, e.g. 0.1, 1e+21
  *   - c:       print a char (character).
  *   - s:       print a character string
  *   - p:       print a void * (pointer to void) in an implementation-defined format.
  *   - n:       print nothing, but write number of characters successfully written so far into an integer pointer parameter.
  *   - %:       %
  *
- * @note support        d, i, u, o, u, x/X, b/B, f/F, c, s
- * @note not support    e/E, g/G, p, n
+ * @note support        d, i, u, o, u, x/X, b/B, e/E, f/F, g/G, c, s
+ * @note not support    p, n
+ * @note the float number is rounded from its shortest digits, and the digits after them are zeros, e.g. %.20lf of 0.1 => 0.10000000000000000000
  *
  * @code
  * tb_printf("|hello world|\n");
@@ -191,6 +193,7 @@ tb_long_t           tb_wputs(tb_wchar_t const* string);
  * tb_printf("|%016.9f|\n", 3.14159);
  * tb_printf("|%lf|\n", 1.0 / 6.0);
  * tb_printf("|%lf|\n", 0.0003141596);
+ * tb_printf("|%le|%lg|%.3lg|\n", 0.0003141596, 0.1 + 0.2, 1234.5);
  * tb_printf("|%F|\n", tb_float_to_fixed(3.1415));
  * tb_printf("|%{object_name}|\n", object);
  * @endcode
@@ -30,6 +30,7 @@
 #include "../../utils/utils.h"
 #include "../string/string.h"
 #include "printf_object.h"
+#include "printf_float.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
@@ -60,6 +61,7 @@ typedef enum __tb_printf_extra_t
 ,   TB_PRINTF_EXTRA_UPPER           = 2     // upper case for %X %B
 ,   TB_PRINTF_EXTRA_PERCENT         = 4     // percent char: %
 ,   TB_PRINTF_EXTRA_EXP             = 8     // exponent form: [-]d.ddd e[+/-]ddd
+,   TB_PRINTF_EXTRA_GENERAL         = 16    // general form: %f or %e, it is the shortest form if no precision
 
 }tb_printf_extra_t;
 
@@ -117,6 +119,23 @@ typedef struct __tb_printf_entry_t
 
 }tb_printf_entry_t;
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the two digits table: "00" - "99"
+static tb_char_t const g_printf_digits_100[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
@@ -255,12 +274,21 @@ static tb_char_t* tb_printf_int64(tb_char_t* pb, tb_char_t* pe, tb_printf_entry_
         }
         else
         {
-            do
+            // convert two digits at a time, it reduces the divisions by half
+            while (num >= 100)
             {
-                digits[digit_i++] = digits_table[num % e.base] | lomask;
-                num /= e.base;
+                tb_size_t r = (tb_size_t)(num % 100) << 1;
+                num /= 100;
+                digits[digit_i++] = g_printf_digits_100[r + 1];
+                digits[digit_i++] = g_printf_digits_100[r];
             }
-            while (num);
+            if (num >= 10)
+            {
+                tb_size_t r = (tb_size_t)num << 1;
+                digits[digit_i++] = g_printf_digits_100[r + 1];
+                digits[digit_i++] = g_printf_digits_100[r];
+            }
+            else digits[digit_i++] = (tb_char_t)('0' + num);
         }
 #endif
     }
@@ -396,12 +424,21 @@ static tb_char_t* tb_printf_int32(tb_char_t* pb, tb_char_t* pe, tb_printf_entry_
         }
         else
         {
-            do
+            // convert two digits at a time, it reduces the divisions by half
+            while (num >= 100)
             {
-                digits[digit_i++] = digits_table[num % e.base] | lomask;
-                num /= e.base;
+                tb_size_t r = (tb_size_t)(num % 100) << 1;
+                num /= 100;
+                digits[digit_i++] = g_printf_digits_100[r + 1];
+                digits[digit_i++] = g_printf_digits_100[r];
             }
-            while (num);
+            if (num >= 10)
+            {
+                tb_size_t r = (tb_size_t)num << 1;
+                digits[digit_i++] = g_printf_digits_100[r + 1];
+                digits[digit_i++] = g_printf_digits_100[r];
+            }
+            else digits[digit_i++] = (tb_char_t)('0' + num);
         }
 #endif
     }
@@ -483,264 +520,271 @@ static tb_char_t* tb_printf_int32(tb_char_t* pb, tb_char_t* pe, tb_printf_entry_
     return pb;
 }
 #ifdef TB_CONFIG_TYPE_HAVE_FLOAT
-static tb_char_t* tb_printf_float(tb_char_t* pb, tb_char_t* pe, tb_printf_entry_t e, tb_float_t num)
+static tb_char_t* tb_printf_fill(tb_char_t* pb, tb_char_t* pe, tb_char_t c, tb_int_t n)
 {
-    // digits
-    tb_char_t   ints[32] = {0};
-    tb_char_t   decs[32] = {0};
-    tb_int_t    ints_i = 0, decs_i = 0;
-
-    // for inf nan
-    if (tb_isinff(num))
+    if (n > pe - pb) n = (tb_int_t)(pe - pb);
+    if (n > 0)
     {
-        if (pb < pe && num < 0) *pb++ = '-';
-        if (pb < pe) *pb++ = (e.extra & TB_PRINTF_EXTRA_UPPER)? 'I' : 'i';
-        if (pb < pe) *pb++ = (e.extra & TB_PRINTF_EXTRA_UPPER)? 'N' : 'n';
-        if (pb < pe) *pb++ = (e.extra & TB_PRINTF_EXTRA_UPPER)? 'F' : 'f';
-        return pb;
+        tb_memset(pb, c, n);
+        pb += n;
     }
-    else if (tb_isnanf(num))
+    return pb;
+}
+static tb_char_t* tb_printf_copy(tb_char_t* pb, tb_char_t* pe, tb_char_t const* s, tb_int_t n)
+{
+    if (n > pe - pb) n = (tb_int_t)(pe - pb);
+    if (n > 0)
+    {
+        tb_memcpy(pb, s, n);
+        pb += n;
+    }
+    return pb;
+}
+static tb_char_t* tb_printf_infnan(tb_char_t* pb, tb_char_t* pe, tb_printf_entry_t e, tb_bool_t sign, tb_bool_t isnan)
+{
+    // inf or nan
+    if (isnan)
     {
         if (pb < pe) *pb++ = (e.extra & TB_PRINTF_EXTRA_UPPER)? 'N' : 'n';
         if (pb < pe) *pb++ = (e.extra & TB_PRINTF_EXTRA_UPPER)? 'A' : 'a';
         if (pb < pe) *pb++ = (e.extra & TB_PRINTF_EXTRA_UPPER)? 'N' : 'n';
-        return pb;
     }
-
-    // sign: + -
-    tb_char_t sign = 0;
-    if (e.extra & TB_PRINTF_EXTRA_SIGNED)
+    else
     {
-        if (num < 0)
-        {
-            sign = '-';
-            --e.width;
-        }
-        else if (e.flags & TB_PRINTF_FLAG_PLUS)
-        {
-            sign = '+';
-            --e.width;
-        }
+        if (pb < pe && sign) *pb++ = '-';
+        if (pb < pe) *pb++ = (e.extra & TB_PRINTF_EXTRA_UPPER)? 'I' : 'i';
+        if (pb < pe) *pb++ = (e.extra & TB_PRINTF_EXTRA_UPPER)? 'N' : 'n';
+        if (pb < pe) *pb++ = (e.extra & TB_PRINTF_EXTRA_UPPER)? 'F' : 'f';
     }
+    return pb;
+}
+/* round the exact decimal digits to the given digits count, it rounds half to even like libc
+ *
+ * the digits have no trailing zeros, so it is a tie only if the removed part is just the last digit 5,
+ * e.g. 0.125 => 0.12, 0.375 => 0.38, 2.5 => 2, 1.005 (1.00499999999999989...) => 1.00
+ */
+static tb_int_t tb_printf_decimal_round(tb_char_t* digits, tb_int_t n, tb_int_t keep, tb_int_t* ppoint)
+{
+    // no rounding?
+    if (keep >= n) return n;
 
-    // adjust sign
-    if (num < 0) num = -num;
-
-    // default precision: 6
-    if (e.precision <= 0) e.precision = 6;
-
-    // round? i.dddddddd5 => i.ddddddde
-    tb_uint32_t p = 1;
-    tb_size_t   n = e.precision;
-    while (n--) p *= 10;
-    if (((tb_uint32_t)(num * p * 10) % 10) > 4)
-        num += 1.0f / (tb_float_t)p;
+    // only zero is left? e.g. 0.0004 => 0.00
+    if (keep < 0) return 0;
 
-    // get integer & decimal
-    tb_int32_t integer = (tb_int32_t)num;
-    tb_float_t decimal = num - integer;
+    // truncate it, the previous digit of the first digit is zero and it is even, e.g. 0.5 => 0
+    tb_char_t c = digits[keep];
+    tb_bool_t up = c > '5' || (c == '5' && (n > keep + 1 || (keep && ((digits[keep - 1] - '0') & 1))));
+    n = keep;
 
-    // convert integer => digits string in reverse order
-    if (integer == 0) ints[ints_i++] = '0';
-    else
+    // round up and remove the trailing nines, e.g. 0.1996 => 0.2
+    if (up)
     {
-        if (integer < 0) integer = -integer;
-        do
-        {
-            ints[ints_i++] = (integer % 10) + '0';
-            integer /= 10;
-        }
-        while (integer);
-    }
-
-    // convert decimal => digits string in positive order
-    if (decimal == 0) decs[decs_i++] = '0';
-    else
-    {
-        tb_long_t d = (tb_long_t)(decimal * 10);
-        do
+        while (n > 0 && digits[n - 1] == '9') n--;
+        if (n) digits[n - 1]++;
+        else
         {
-            decs[decs_i++] = (tb_char_t)(d + (tb_long_t)'0');
-            decimal = decimal * 10 - d;
-            d = (tb_long_t)(decimal * 10);
+            // 9.99 => 10.0
+            digits[0] = '1';
+            n = 1;
+            (*ppoint)++;
         }
-        while (decs_i < e.precision);
-    }
-
-    // adjust precision
-    if (decs_i > e.precision)
-        decs_i = e.precision;
-
-    // fill spaces at left side, e.g. "   0.31415926"
-    e.width -= (tb_int_t)(ints_i + 1 + e.precision);
-    if (!(e.flags & (TB_PRINTF_FLAG_LEFT + TB_PRINTF_FLAG_ZERO)))
-    {
-        while (--e.width >= 0)
-            if (pb < pe) *pb++ = ' ';
     }
-
-    // append sign: + / -
-    if (sign && (pb < pe)) *pb++ = sign;
-
-    // fill 0 or spaces, e.g. "00003.1415926"
-    if (!(e.flags & TB_PRINTF_FLAG_LEFT))
-    {
-        tb_char_t c = (e.flags & TB_PRINTF_FLAG_ZERO)? '0' : ' ';
-        while (--e.width >= 0)
-            if (pb < pe) *pb++ = c;
-    }
-
-    // append integer
-    while (--ints_i >= 0)
-        if (pb < pe) *pb++ = ints[ints_i];
-
-    // append .
-    if (pb < pe) *pb++ = '.';
-
-    // append decimal
-    tb_int_t decs_n = decs_i;
-    while (--decs_i >= 0)
-        if (pb < pe) *pb++ = decs[decs_n - decs_i - 1];
-
-    // fill 0 if precision is larger, e.g. "0.3140000"
-    while (decs_n <= --e.precision)
-        if (pb < pe) *pb++ = '0';
-
-    // trailing space padding for left-justified flags, e.g. "0.31415926   "
-    while (--e.width >= 0)
-        if (pb < pe) *pb++ = ' ';
-
-    return pb;
+    return n;
 }
-static tb_char_t* tb_printf_double(tb_char_t* pb, tb_char_t* pe, tb_printf_entry_t e, tb_double_t num)
+/* printf the decimal number: 0.digits * 10^point
+ *
+ * %f: [-]ddd.ddd
+ * %e: [-]d.ddde[+/-]dd
+ * %g: the shortest form of %f or %e, it will be the shortest representation which can be parsed to the same number if no precision
+ *
+ * the exact digits will be used for the others, because rounding the shortest digits will round twice, e.g. %.2lf: 1.005 => 1.01
+ */
+static tb_char_t* tb_printf_decimal(tb_char_t* pb, tb_char_t* pe, tb_printf_entry_t e, tb_bool_t negative, tb_double_t num, tb_int_t maxn)
 {
-    // digits
-    tb_char_t   ints[64] = {0};
-    tb_char_t   decs[64] = {0};
-    tb_int_t    ints_i = 0, decs_i = 0;
-
-    // for inf nan
-    if (tb_isinf(num))
+    // use the shortest digits for %g without precision and '#'
+    tb_char_t   digits[TB_PRINTF_DOUBLE_EXACT_MAXN];
+    tb_int_t    n = 0;
+    tb_int_t    point = 0;
+    tb_bool_t   shortest = ((e.extra & TB_PRINTF_EXTRA_GENERAL) && e.precision < 0 && !(e.flags & TB_PRINTF_FLAG_PFIX))? tb_true : tb_false;
+    if (shortest)
     {
-        if (pb < pe && num < 0) *pb++ = '-';
-        if (pb < pe) *pb++ = (e.extra & TB_PRINTF_EXTRA_UPPER)? 'I' : 'i';
-        if (pb < pe) *pb++ = (e.extra & TB_PRINTF_EXTRA_UPPER)? 'N' : 'n';
-        if (pb < pe) *pb++ = (e.extra & TB_PRINTF_EXTRA_UPPER)? 'F' : 'f';
-        return pb;
-    }
-    else if (tb_isnan(num))
-    {
-        if (pb < pe) *pb++ = (e.extra & TB_PRINTF_EXTRA_UPPER)? 'N' : 'n';
-        if (pb < pe) *pb++ = (e.extra & TB_PRINTF_EXTRA_UPPER)? 'A' : 'a';
-        if (pb < pe) *pb++ = (e.extra & TB_PRINTF_EXTRA_UPPER)? 'N' : 'n';
-        return pb;
-    }
-
+        // get the shortest decimal digits
+        tb_int_t    exp = 0;
+        tb_uint64_t mantissa = maxn == 9? tb_printf_float_decimal((tb_float_t)num, &exp) : tb_printf_double_decimal(num, &exp);
 
-    // sign: + -
-    tb_char_t sign = 0;
-    if (e.extra & TB_PRINTF_EXTRA_SIGNED)
-    {
-        if (num < 0)
+        // convert mantissa => digits string, @note the mantissa has 17 digits at most
+        tb_char_t* p = digits + 32;
+        while (mantissa >= 100)
         {
-            sign = '-';
-            --e.width;
+            tb_size_t r = (tb_size_t)(mantissa % 100) << 1;
+            mantissa /= 100;
+            *--p = g_printf_digits_100[r + 1];
+            *--p = g_printf_digits_100[r];
         }
-        else if (e.flags & TB_PRINTF_FLAG_PLUS)
+        if (mantissa >= 10)
         {
-            sign = '+';
-            --e.width;
+            tb_size_t r = (tb_size_t)mantissa << 1;
+            *--p = g_printf_digits_100[r + 1];
+            *--p = g_printf_digits_100[r];
         }
-    }
+        else *--p = (tb_char_t)('0' + mantissa);
+        n = (tb_int_t)(digits + 32 - p);
+        tb_memmov(digits, p, n);
 
-    // adjust sign
-    if (num < 0) num = -num;
+        // the position of the decimal point
+        point = n + exp;
 
-    // default precision: 6
-    if (e.precision <= 0) e.precision = 6;
+        // remove the trailing zeros, e.g. 100 => 1e2
+        while (n > 1 && digits[n - 1] == '0') n--;
+    }
+    // get the exact decimal digits, the float can be converted to double exactly
+    else n = (tb_int_t)tb_printf_double_exact(num, digits, sizeof(digits), &point);
 
-    // round? i.dddddddd5 => i.ddddddde
-    tb_uint64_t p = 1;
-    tb_size_t   n = e.precision;
-    while (n--) p *= 10;
-    if (((tb_uint64_t)(num * p * 10) % 10) > 4)
-        num += 1. / (tb_double_t)p;
+    // the exponent form?
+    tb_bool_t expform = (e.extra & TB_PRINTF_EXTRA_EXP)? tb_true : tb_false;
+    if (e.extra & TB_PRINTF_EXTRA_GENERAL)
+    {
+        // the precision is the significant digits count for %g, it will be the shortest digits if no precision and '#'
+        tb_int_t precision = e.precision;
+        if (shortest) precision = maxn;
+        else
+        {
+            // default precision: 6, e.g. %#g
+            if (precision < 0) precision = 6;
+            else if (!precision) precision = 1;
+            n = tb_printf_decimal_round(digits, n, precision, &point);
+        }
 
-    // get integer & decimal
-    tb_int64_t integer = (tb_int64_t)num;
-    tb_double_t decimal = num - integer;
+        // use the exponent form if the exponent is less than -4 or not less than the precision
+        tb_int_t x = point - 1;
+        expform = (x < -4 || x >= precision)? tb_true : tb_false;
 
-    // convert integer => digits string in reverse order
-    if (integer == 0) ints[ints_i++] = '0';
-    else
-    {
-        if (integer < 0) integer = -integer;
-        do
+        // remove the trailing zeros if no '#', e.g. 0.100 => 0.1
+        if (e.flags & TB_PRINTF_FLAG_PFIX)
+            e.precision = expform? precision - 1 : precision - 1 - x;
+        else
         {
-            ints[ints_i++] = (integer % 10) + '0';
-            integer /= 10;
+            while (n > 1 && digits[n - 1] == '0') n--;
+            e.precision = expform? n - 1 : tb_max(n - point, 0);
         }
-        while (integer);
     }
-
-    // convert decimal => digits string in positive order
-    if (decimal == 0) decs[decs_i++] = '0';
     else
     {
-        tb_long_t d = (tb_long_t)(decimal * 10);
-        do
+        // default precision: 6
+        if (e.precision < 0) e.precision = 6;
+        n = tb_printf_decimal_round(digits, n, expform? e.precision + 1 : point + e.precision, &point);
+    }
+
+    // has the decimal point?
+    tb_int_t dot = (e.precision > 0 || (e.flags & TB_PRINTF_FLAG_PFIX))? 1 : 0;
+
+    // make the exponent string, e.g. e+08
+    tb_char_t   expstr[8];
+    tb_int_t    expn = 0;
+    tb_int_t    size = 0;
+    if (expform)
+    {
+        tb_int_t x = n? point - 1 : 0;
+        expstr[expn++] = (e.extra & TB_PRINTF_EXTRA_UPPER)? 'E' : 'e';
+        expstr[expn++] = x < 0? '-' : '+';
+        if (x < 0) x = -x;
+        if (x >= 100)
         {
-            decs[decs_i++] = (tb_char_t)(d + (tb_long_t)'0');
-            decimal = decimal * 10 - d;
-            d = (tb_long_t)(decimal * 10);
+            expstr[expn++] = (tb_char_t)('0' + x / 100);
+            x %= 100;
         }
-        while (decs_i < e.precision);
+        expstr[expn++] = g_printf_digits_100[x << 1];
+        expstr[expn++] = g_printf_digits_100[(x << 1) + 1];
+        size = 1 + dot + e.precision + expn;
     }
+    else size = tb_max(point, 1) + dot + e.precision;
 
-    // adjust precision
-    if (decs_i > e.precision)
-        decs_i = e.precision;
+    // sign: + -
+    tb_char_t sign = 0;
+    if (negative) sign = '-';
+    else if (e.flags & TB_PRINTF_FLAG_PLUS) sign = '+';
+    if (sign) size++;
 
     // fill spaces at left side, e.g. "   0.31415926"
-    e.width -= (tb_int_t)(ints_i + 1 + e.precision);
+    e.width -= size;
     if (!(e.flags & (TB_PRINTF_FLAG_LEFT + TB_PRINTF_FLAG_ZERO)))
-    {
-        while (--e.width >= 0)
-            if (pb < pe) *pb++ = ' ';
-    }
+        pb = tb_printf_fill(pb, pe, ' ', e.width);
 
     // append sign: + / -
     if (sign && (pb < pe)) *pb++ = sign;
 
-    // fill 0 or spaces, e.g. "00003.1415926"
-    if (!(e.flags & TB_PRINTF_FLAG_LEFT))
+    // fill 0, e.g. "00003.1415926"
+    if ((e.flags & (TB_PRINTF_FLAG_LEFT + TB_PRINTF_FLAG_ZERO)) == TB_PRINTF_FLAG_ZERO)
+        pb = tb_printf_fill(pb, pe, '0', e.width);
+
+    if (expform)
     {
-        tb_char_t c = (e.flags & TB_PRINTF_FLAG_ZERO)? '0' : ' ';
-        while (--e.width >= 0)
-            if (pb < pe) *pb++ = c;
+        // append the first digit, e.g. 3.1415926e+00
+        if (pb < pe) *pb++ = n? digits[0] : '0';
+
+        // append the decimal digits and fill 0 if the precision is larger, e.g. 3.1400e+00
+        if (dot && pb < pe) *pb++ = '.';
+        tb_int_t decs = tb_min(tb_max(n - 1, 0), e.precision);
+        pb = tb_printf_copy(pb, pe, digits + 1, decs);
+        pb = tb_printf_fill(pb, pe, '0', e.precision - decs);
+
+        // append the exponent
+        pb = tb_printf_copy(pb, pe, expstr, expn);
+    }
+    else
+    {
+        // append integer, e.g. 31400.00
+        if (point > 0)
+        {
+            tb_int_t ints = tb_min(point, n);
+            pb = tb_printf_copy(pb, pe, digits, ints);
+            pb = tb_printf_fill(pb, pe, '0', point - ints);
+        }
+        else if (pb < pe) *pb++ = '0';
+
+        // append decimal, e.g. 0.000314
+        if (dot && pb < pe) *pb++ = '.';
+        tb_int_t zeros = point < 0? tb_min(-point, e.precision) : 0;
+        tb_int_t start = tb_max(point, 0);
+        tb_int_t decs = tb_min(tb_max(n - start, 0), e.precision - zeros);
+        pb = tb_printf_fill(pb, pe, '0', zeros);
+        pb = tb_printf_copy(pb, pe, digits + start, decs);
+
+        // fill 0 if precision is larger, e.g. "0.3140000"
+        pb = tb_printf_fill(pb, pe, '0', e.precision - zeros - decs);
     }
 
-    // append integer
-    while (--ints_i >= 0)
-        if (pb < pe) *pb++ = ints[ints_i];
+    // trailing space padding for left-justified flags, e.g. "0.31415926   "
+    if (e.flags & TB_PRINTF_FLAG_LEFT)
+        pb = tb_printf_fill(pb, pe, ' ', e.width);
 
-    // append .
-    if (pb < pe) *pb++ = '.';
+    return pb;
+}
+static tb_char_t* tb_printf_float(tb_char_t* pb, tb_char_t* pe, tb_printf_entry_t e, tb_float_t num)
+{
+    // get the sign bit, -0.0 is negative too
+    tb_ieee_float_t ieee; ieee.f = num;
+    tb_bool_t negative = (ieee.i >> 31)? tb_true : tb_false;
 
-    // append decimal
-    tb_int_t decs_n = decs_i;
-    while (--decs_i >= 0)
-        if (pb < pe) *pb++ = decs[decs_n - decs_i - 1];
+    // for inf nan
+    if (tb_isinff(num) || tb_isnanf(num))
+        return tb_printf_infnan(pb, pe, e, negative, tb_isnanf(num));
 
-    // fill 0 if precision is larger, e.g. "0.3140000"
-    while (decs_n <= --e.precision)
-        if (pb < pe) *pb++ = '0';
+    // printf it
+    return tb_printf_decimal(pb, pe, e, negative, num, 9);
+}
+static tb_char_t* tb_printf_double(tb_char_t* pb, tb_char_t* pe, tb_printf_entry_t e, tb_double_t num)
+{
+    // get the sign bit, -0.0 is negative too
+    tb_ieee_double_t ieee; ieee.d = num;
+    tb_bool_t negative = (ieee.i.h >> 31)? tb_true : tb_false;
 
-    // trailing space padding for left-justified flags, e.g. "0.31415926   "
-    while (--e.width >= 0)
-        if (pb < pe) *pb++ = ' ';
+    // for inf nan
+    if (tb_isinf(num) || tb_isnan(num))
+        return tb_printf_infnan(pb, pe, e, negative, tb_isnan(num));
 
-    return pb;
+    // printf it
+    return tb_printf_decimal(pb, pe, e, negative, num, 17);
 }
 #endif
 // get a printf format entry
@@ -938,6 +982,13 @@ get_qualifier:
         e->extra |= TB_PRINTF_EXTRA_SIGNED;
         e->extra |= TB_PRINTF_EXTRA_EXP;
         break;
+    case 'G':
+        e->extra |= TB_PRINTF_EXTRA_UPPER;
+    case 'g':
+        e->type = TB_PRINTF_TYPE_FLOAT;
+        e->extra |= TB_PRINTF_EXTRA_SIGNED;
+        e->extra |= TB_PRINTF_EXTRA_GENERAL;
+        break;
 #endif
     case '{':
         {
@@ -25,6 +25,8 @@
  */
 #include "stdlib.h"
 #include "../../libm/libm.h"
+#include "../../utils/bits.h"
+#include "../string/string.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
@@ -119,36 +121,57 @@ tb_uint64_t tb_s10tou64(tb_char_t const* s)
     // skip space
     while (tb_isspace(*s)) s++;
 
+    // compute number
+    tb_uint64_t val = 0;
+    tb_s10tou64_n(s, tb_strlen(s), &val);
+    return val;
+}
+tb_size_t tb_s10tou64_n(tb_char_t const* s, tb_size_t n, tb_uint64_t* pvalue)
+{
+    // check
+    tb_assert_and_check_return_val(s && pvalue, 0);
+
     // has sign?
-    tb_int_t sign = 0;
-    if (*s == '-')
+    tb_char_t const*    p = s;
+    tb_char_t const*    e = s + n;
+    tb_int_t            sign = 0;
+    if (p < e && (*p == '-' || *p == '+'))
     {
-        sign = 1;
-        s++;
+        sign = *p == '-';
+        p++;
     }
-    // skip '+'
-    else if (*s == '+') s++;
 
-    // skip '0'
-    while ((*s) == '0') s++;
-
-    // compute number
-    tb_uint64_t val = 0;
-    while (*s)
+    // compute number, 8 digits at a time
+    tb_char_t const*    digits = p;
+    tb_uint64_t         val = 0;
+    while (e - p >= 8)
     {
-        tb_char_t ch = *s;
-        if (tb_isdigit10(ch))
-            val = val * 10 + (ch - '0');
-        else break;
-
-        s++;
+        // all bytes are in ['0', '9']?
+        tb_uint64_t chunk = tb_bits_get_u64_le(p);
+        if (((chunk + 0x4646464646464646ULL) | (chunk - 0x3030303030303030ULL)) & 0x8080808080808080ULL) break;
+
+        // convert them with three multiplications, the first digit is the lowest byte
+        chunk -= 0x3030303030303030ULL;
+        chunk = (chunk * 10) + (chunk >> 8);
+        chunk = (((chunk & 0x000000ff000000ffULL) * 0x000f424000000064ULL) + (((chunk >> 16) & 0x000000ff000000ffULL) * 0x0000271000000001ULL)) >> 32;
+        val = val * 100000000 + (tb_uint32_t)chunk;
+        p += 8;
     }
+    while (p < e && tb_isdigit10(*p))
+    {
+        val = val * 10 + (*p - '0');
+        p++;
+    }
+
+    // no digits?
+    if (p == digits) return 0;
 
     // is negative number?
     if (sign) val = ~val + 1;
 
-    // the value
-    return val;
+    // ok
+    *pvalue = val;
+    return p - s;
 }
 tb_uint64_t tb_s16tou64(tb_char_t const* s)
 {
@@ -438,86 +461,10 @@ tb_double_t tb_s10tod(tb_char_t const* s)
     // skip space
     while (tb_isspace(*s)) s++;
 
-    // has sign?
-    tb_int_t sign = 0;
-    if (*s == '-')
-    {
-        sign = 1;
-        s++;
-    }
-    // skip '+'
-    else if (*s == '+') s++;
-
-    // nan?
-    if (s[0] == 'n' && s[1] == 'a' && s[2] == 'n')
-        return TB_NAN;
-
-    // inf or -inf?
-    if (s[0] == 'i' && s[1] == 'n' && s[2] == 'f')
-        return sign? -TB_INF : TB_INF;
-
-    // skip '0'
-    while ((*s) == '0') s++;
-
-    // compute double: lhs.rhs
-    tb_int_t    dec = 0;
-    tb_uint64_t lhs = 0;
-    tb_double_t rhs = 0.;
-    tb_int_t    zeros = 0;
-    tb_int8_t   decimals[256];
-    tb_int8_t*  d = decimals;
-    tb_int8_t*  e = decimals + 256;
-    while (*s)
-    {
-        tb_char_t ch = *s;
-
-        // is the part of decimal?
-        if (ch == '.')
-        {
-            if (!dec)
-            {
-                dec = 1;
-                s++;
-                continue ;
-            }
-            else break;
-        }
-
-        // parse integer & decimal
-        if (tb_isdigit10(ch))
-        {
-            // save decimals
-            if (dec)
-            {
-                if (d < e)
-                {
-                    if (ch != '0')
-                    {
-                        // fill '0'
-                        while (zeros--) *d++ = 0;
-                        zeros = 0;
-
-                        // save decimal
-                        *d++ = ch - '0';
-                    }
-                    else zeros++;
-                }
-            }
-            else lhs = lhs * 10 + (ch - '0');
-        }
-        else break;
-
-        s++;
-    }
-
-    // check
-    tb_assert_and_check_return_val(d <= decimals + 256, 0);
-
-    // compute decimal
-    while (d-- > decimals) rhs = (rhs + *d) / 10;
-
-    // merge
-    return (sign? ((tb_double_t)lhs + rhs) * -1. : ((tb_double_t)lhs + rhs));
+    // compute double
+    tb_double_t val = 0;
+    tb_s10tod_n(s, tb_strlen(s), &val);
+    return val;
 }
 tb_double_t tb_s16tod(tb_char_t const* s)
 {
@@ -670,9 +617,10 @@ tb_double_t tb_stod(tb_char_t const* s)
             return tb_s16tod(s);
         else if (*p == 'b' || *p == 'B')
             return tb_s2tod(s);
-        else return tb_s8tod(s);
+        else if (tb_isdigit8(*p))
+            return tb_s8tod(s);
     }
-    else return tb_s10tod(s);
+    return tb_s10tod(s);
 }
 tb_double_t tb_sbtod(tb_char_t const* s, tb_int_t base)
 {
@@ -140,6 +140,23 @@ tb_uint64_t         tb_s8tou64(tb_char_t const* s);
  */
 tb_uint64_t         tb_s10tou64(tb_char_t const* s);
 
+/*! convert the decimal string slice to uint64, it parses 8 digits at a time
+ *
+ * <pre>
+ * .e.g
+ *
+ * "123, "  => 123, the parsed size: 3
+ * "-9"     => -9, the parsed size: 2
+ * </pre>
+ *
+ * @param s         the string, it need not be null-terminated
+ * @param n         the string size
+ * @param pvalue    the uint64 number
+ *
+ * @return          the parsed size, 0 if no digits
+ */
+tb_size_t           tb_s10tou64_n(tb_char_t const* s, tb_size_t n, tb_uint64_t* pvalue);
+
 /*! convert the hex string to uint64
  *
  * <pre>
@@ -222,6 +239,26 @@ tb_double_t         tb_s8tod(tb_char_t const* s);
  */
 tb_double_t         tb_s10tod(tb_char_t const* s);
 
+/*! convert the decimal string slice to double, it is correctly rounded
+ *
+ * it uses the Eisel-Lemire algorithm and falls back to the big decimal for the rare ambiguous cases
+ *
+ * <pre>
+ * .e.g
+ *
+ * "3.14, "     => 3.14, the parsed size: 4
+ * "-1.5e-10"   => -1.5e-10, the parsed size: 8
+ * "inf"        => inf, the parsed size: 3
+ * </pre>
+ *
+ * @param s         the string, it need not be null-terminated
+ * @param n         the string size
+ * @param pvalue    the double number
+ *
+ * @return          the parsed size, 0 if it is not a number
+ */
+tb_size_t           tb_s10tod_n(tb_char_t const* s, tb_size_t n, tb_double_t* pvalue);
+
 /*! convert the hex string to double
  *
  * <pre>
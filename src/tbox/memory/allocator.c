@@ -81,6 +81,11 @@ tb_pointer_t tb_allocator_malloc_(tb_allocator_ref_t allocator, tb_size_t size _
     // leave
     if (lockit) tb_spinlock_leave(&allocator->lock);
 
+    // record the allocated size
+#ifdef TB_METRICS_ENABLE
+    if (data) tb_metrics_record(tb_metrics_builtin(TB_METRICS_BUILTIN_ALLOCATOR_MALLOC_SIZE), size);
+#endif
+
     // ok?
     return data;
 }
@@ -229,6 +234,11 @@ tb_pointer_t tb_allocator_large_malloc_(tb_allocator_ref_t allocator, tb_size_t
     // leave
     if (lockit) tb_spinlock_leave(&allocator->lock);
 
+    // record the allocated size
+#ifdef TB_METRICS_ENABLE
+    if (data) tb_metrics_record(tb_metrics_builtin(TB_METRICS_BUILTIN_ALLOCATOR_MALLOC_SIZE), size);
+#endif
+
     // ok?
     return data;
 }
@@ -336,7 +336,7 @@ tb_allocator_ref_t tb_default_allocator_init(tb_allocator_ref_t large_allocator)
         tb_assert_and_check_break(allocator->small_allocator);
 
         // register lock profiler
-#ifdef TB_LOCK_PROFILER_ENABLE
+#ifdef TB_LOCK_PROFILER_REGISTER_ENABLE
         tb_lock_profiler_register(tb_lock_profiler(), (tb_pointer_t)&allocator->base.lock, TB_TRACE_MODULE_NAME);
 #endif
 
@@ -964,7 +964,7 @@ tb_allocator_ref_t tb_static_large_allocator_init(tb_byte_t* data, tb_size_t siz
     allocator->data_tail = (tb_static_large_data_head_t*)((tb_byte_t*)&allocator->data_head[1] + allocator->data_head->space);
 
     // register lock profiler
-#ifdef TB_LOCK_PROFILER_ENABLE
+#ifdef TB_LOCK_PROFILER_REGISTER_ENABLE
     tb_lock_profiler_register(tb_lock_profiler(), (tb_pointer_t)&allocator->base.lock, TB_TRACE_MODULE_NAME);
 #endif
 
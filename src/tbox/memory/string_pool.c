@@ -34,25 +34,418 @@
 #include "../libc/libc.h"
 #include "../utils/utils.h"
 #include "../platform/platform.h"
-#include "../container/container.h"
-#include "../algorithm/algorithm.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the shard count, must be power of 2
+#ifdef __tb_small__
+#   define TB_STRING_POOL_SHARD_COUNT           (4)
+#else
+#   define TB_STRING_POOL_SHARD_COUNT           (16)
+#endif
+
+// the initial slot count of each shard, must be power of 2
+#define TB_STRING_POOL_SLOT_INIT                (64)
+
+// the arena chunk size
+#define TB_STRING_POOL_ARENA_SIZE               (8192)
+
+// the deleted slot
+#define TB_STRING_POOL_SLOT_DELETED             ((tb_long_t)1)
+
+// the string entry from the interned c-string
+#define tb_string_pool_entry(cstr)              (((tb_string_pool_entry_t*)(cstr)) - 1)
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
 
+/* the interned string entry type
+ *
+ * <pre>
+ * | refn | retired | epoch | hash | size | c-string ... '\0' |
+ *                                        |
+ *                                    interned pointer
+ * </pre>
+ */
+typedef struct __tb_string_pool_entry_t
+{
+    // the reference count
+    tb_atomic_t                             refn;
+
+    // the next retired entry
+    struct __tb_string_pool_entry_t*        retired;
+
+    // the retired epoch
+    tb_size_t                               epoch;
+
+    // the string hash
+    tb_size_t                               hash;
+
+    // the string size
+    tb_size_t                               size;
+
+}tb_string_pool_entry_t;
+
+// the slot table type, it uses open addressing with linear probing
+typedef struct __tb_string_pool_table_t
+{
+    // the slot mask
+    tb_size_t                               mask;
+
+    // the next retired table
+    struct __tb_string_pool_table_t*        retired;
+
+    // the retired epoch
+    tb_size_t                               epoch;
+
+    // the slots, the entry pointers
+    tb_atomic_t                             slots[1];
+
+}tb_string_pool_table_t;
+
+// the string pool shard type
+typedef struct __tb_string_pool_shard_t
+{
+    // the lock for writers, readers do not need it
+    tb_spinlock_t                           lock;
+
+    // the slot table
+    tb_atomic_t                             table;
+
+    // the current epoch
+    tb_atomic_t                             epoch;
+
+    // the reader count of the even and odd epochs
+    tb_atomic_t                             readers[2];
+
+    // the used slot count
+    tb_size_t                               size;
+
+    // the deleted slot count
+    tb_size_t                               dels;
+
+    // the retired entries, the newer entry is at the head
+    tb_string_pool_entry_t*                 retired_entries;
+
+    // the retired tables, the newer table is at the head
+    tb_string_pool_table_t*                 retired_tables;
+
+    // the arena chunks, the first pointer of each chunk is the next chunk
+    tb_byte_t*                              arena;
+
+    // the free data of the current arena chunk
+    tb_byte_t*                              arena_data;
+
+    // the free size of the current arena chunk
+    tb_size_t                               arena_left;
+
+    // the padding, avoid false sharing between shards
+    tb_byte_t                               padding[TB_L1_CACHE_BYTES];
+
+}tb_string_pool_shard_t;
+
 // the string pool type
 typedef struct __tb_string_pool_t
 {
-    // the cache
-    tb_hash_map_ref_t           cache;
+    // the flags
+    tb_size_t                               flags;
+
+    // the shards
+    tb_string_pool_shard_t                  shards[TB_STRING_POOL_SHARD_COUNT];
 
 }tb_string_pool_t;
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_size_t tb_string_pool_hash(tb_char_t const* data, tb_size_t* psize, tb_bool_t bcase)
+{
+    // fnv-1a
+    tb_uint32_t         hash = 2166136261ul;
+    tb_byte_t const*    p = (tb_byte_t const*)data;
+    if (bcase)
+    {
+        while (*p)
+        {
+            hash ^= *p++;
+            hash *= 16777619ul;
+        }
+    }
+    else
+    {
+        while (*p)
+        {
+            hash ^= (tb_byte_t)tb_tolower(*p);
+            hash *= 16777619ul;
+            p++;
+        }
+    }
+
+    // save size
+    *psize = (tb_char_t const*)p - data;
+
+    // mix all bits, because we use the high bits for shard and the low bits for slot
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6b;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35;
+    hash ^= hash >> 16;
+    return (tb_size_t)hash;
+}
+static __tb_inline__ tb_string_pool_shard_t* tb_string_pool_shard(tb_string_pool_t* pool, tb_size_t hash)
+{
+    return &pool->shards[(hash >> 24) & (TB_STRING_POOL_SHARD_COUNT - 1)];
+}
+static tb_size_t tb_string_pool_shard_enter(tb_string_pool_shard_t* shard)
+{
+    // enter the current epoch, retry it if the epoch has been changed before we are counted
+    while (1)
+    {
+        tb_size_t epoch = (tb_size_t)tb_atomic_get(&shard->epoch);
+        tb_atomic_fetch_and_add(&shard->readers[epoch & 1], 1);
+        if ((tb_size_t)tb_atomic_get(&shard->epoch) == epoch) return epoch;
+        tb_atomic_fetch_and_sub(&shard->readers[epoch & 1], 1);
+    }
+    return 0;
+}
+static __tb_inline__ tb_void_t tb_string_pool_shard_leave(tb_string_pool_shard_t* shard, tb_size_t epoch)
+{
+    tb_atomic_fetch_and_sub(&shard->readers[epoch & 1], 1);
+}
+static tb_void_t tb_string_pool_shard_reclaim(tb_string_pool_shard_t* shard)
+{
+    // no retired data?
+    tb_check_return(shard->retired_entries || shard->retired_tables);
+
+    /* enter the next epoch if there are no readers in the previous epoch
+     *
+     * the readers of the epoch (e + 1) and (e - 1) use the same counter
+     */
+    tb_size_t epoch = (tb_size_t)tb_atomic_get(&shard->epoch);
+    if (!tb_atomic_get(&shard->readers[(epoch + 1) & 1]))
+    {
+        epoch++;
+        tb_atomic_set(&shard->epoch, epoch);
+    }
+
+    /* free the entries retired at the epoch (e - 2) or before
+     *
+     * all readers which may see them have left, because we can enter the epoch e
+     * only if all readers of (e - 2) have left.
+     */
+    tb_string_pool_entry_t* entry = shard->retired_entries;
+    tb_string_pool_entry_t* prev = tb_null;
+    while (entry && entry->epoch + 2 > epoch)
+    {
+        prev = entry;
+        entry = entry->retired;
+    }
+    if (prev) prev->retired = tb_null;
+    else shard->retired_entries = tb_null;
+    while (entry)
+    {
+        tb_string_pool_entry_t* next = entry->retired;
+        tb_free(entry);
+        entry = next;
+    }
+
+    // free the retired tables
+    tb_string_pool_table_t* table = shard->retired_tables;
+    tb_string_pool_table_t* tprev = tb_null;
+    while (table && table->epoch + 2 > epoch)
+    {
+        tprev = table;
+        table = table->retired;
+    }
+    if (tprev) tprev->retired = tb_null;
+    else shard->retired_tables = tb_null;
+    while (table)
+    {
+        tb_string_pool_table_t* next = table->retired;
+        tb_free(table);
+        table = next;
+    }
+}
+static tb_string_pool_table_t* tb_string_pool_table_init(tb_size_t maxn)
+{
+    // make table
+    tb_string_pool_table_t* table = (tb_string_pool_table_t*)tb_malloc0(sizeof(tb_string_pool_table_t) + (maxn - 1) * sizeof(tb_atomic_t));
+    tb_assert_and_check_return_val(table, tb_null);
+
+    // init table
+    table->mask = maxn - 1;
+    return table;
+}
+static tb_string_pool_entry_t* tb_string_pool_table_find(tb_string_pool_table_t* table, tb_char_t const* data, tb_size_t size, tb_size_t hash, tb_bool_t bcase)
+{
+    // find it, the table has always free slots
+    tb_size_t mask = table->mask;
+    tb_size_t i = hash & mask;
+    while (1)
+    {
+        // the end?
+        tb_long_t slot = tb_atomic_get_explicit(&table->slots[i], TB_ATOMIC_ACQUIRE);
+        tb_check_break(slot);
+
+        // is this entry?
+        if (slot != TB_STRING_POOL_SLOT_DELETED)
+        {
+            tb_string_pool_entry_t* entry = (tb_string_pool_entry_t*)slot;
+            if (    entry->hash == hash
+                &&  entry->size == size
+                &&  (bcase? !tb_memcmp(entry + 1, data, size) : !tb_strnicmp((tb_char_t const*)(entry + 1), data, size)))
+                return entry;
+        }
+
+        // next
+        i = (i + 1) & mask;
+    }
+    return tb_null;
+}
+static tb_bool_t tb_string_pool_shard_grow(tb_string_pool_shard_t* shard, tb_bool_t reclaim)
+{
+    // the load factor of used and deleted slots is less than 50%?
+    tb_string_pool_table_t* table = (tb_string_pool_table_t*)tb_atomic_get(&shard->table);
+    tb_check_return_val((shard->size + shard->dels + 1) << 1 > table->mask + 1, tb_true);
+
+    // compute the new slot count, the deleted slots will be dropped
+    tb_size_t maxn = table->mask + 1;
+    while ((shard->size + 1) << 2 > maxn) maxn <<= 1;
+
+    // make the new table
+    tb_string_pool_table_t* table_new = tb_string_pool_table_init(maxn);
+    tb_assert_and_check_return_val(table_new, tb_false);
+
+    // copy the used slots, it is not visible to readers now
+    tb_size_t i = 0;
+    tb_size_t n = table->mask + 1;
+    for (i = 0; i < n; i++)
+    {
+        tb_long_t slot = tb_atomic_get_explicit(&table->slots[i], TB_ATOMIC_RELAXED);
+        if (slot && slot != TB_STRING_POOL_SLOT_DELETED)
+        {
+            tb_size_t j = ((tb_string_pool_entry_t*)slot)->hash & table_new->mask;
+            while (tb_atomic_get_explicit(&table_new->slots[j], TB_ATOMIC_RELAXED)) j = (j + 1) & table_new->mask;
+            tb_atomic_set_explicit(&table_new->slots[j], slot, TB_ATOMIC_RELAXED);
+        }
+    }
+
+    // publish the new table
+    tb_atomic_set_explicit(&shard->table, (tb_long_t)table_new, TB_ATOMIC_RELEASE);
+    shard->dels = 0;
+
+    /* retire the old table, some readers may be still using it
+     *
+     * we free it after all readers have left if reclaim is enabled, otherwise free it when clearing pool
+     */
+    table->epoch = reclaim? (tb_size_t)tb_atomic_get(&shard->epoch) : 0;
+    table->retired = shard->retired_tables;
+    shard->retired_tables = table;
+    return tb_true;
+}
+static tb_string_pool_entry_t* tb_string_pool_shard_alloc(tb_string_pool_shard_t* shard, tb_size_t size, tb_bool_t reclaim)
+{
+    // we need free it one by one if reclaim is enabled
+    tb_size_t need = sizeof(tb_string_pool_entry_t) + size + 1;
+    if (reclaim) return (tb_string_pool_entry_t*)tb_malloc(need);
+
+    // allocate it from the current arena chunk
+    need = tb_align(need, sizeof(tb_pointer_t));
+    if (need <= shard->arena_left)
+    {
+        tb_byte_t* data = shard->arena_data;
+        shard->arena_data += need;
+        shard->arena_left -= need;
+        return (tb_string_pool_entry_t*)data;
+    }
+
+    // the large string? allocate an individual chunk for it and keep the current chunk
+    tb_bool_t  large = need > (TB_STRING_POOL_ARENA_SIZE >> 2);
+    tb_byte_t* chunk = (tb_byte_t*)tb_malloc(sizeof(tb_pointer_t) + (large? need : TB_STRING_POOL_ARENA_SIZE));
+    tb_assert_and_check_return_val(chunk, tb_null);
+
+    // attach chunk
+    *((tb_byte_t**)chunk) = shard->arena;
+    shard->arena = chunk;
+    chunk += sizeof(tb_pointer_t);
+
+    // update the current chunk
+    if (!large)
+    {
+        shard->arena_data = chunk + need;
+        shard->arena_left = TB_STRING_POOL_ARENA_SIZE - need;
+    }
+    return (tb_string_pool_entry_t*)chunk;
+}
+static tb_bool_t tb_string_pool_shard_init(tb_string_pool_shard_t* shard)
+{
+    // init lock
+    if (!tb_spinlock_init(&shard->lock)) return tb_false;
+
+    // init table
+    tb_string_pool_table_t* table = tb_string_pool_table_init(TB_STRING_POOL_SLOT_INIT);
+    tb_assert_and_check_return_val(table, tb_false);
+    tb_atomic_init(&shard->table, (tb_long_t)table);
+    return tb_true;
+}
+static tb_void_t tb_string_pool_shard_clear(tb_string_pool_shard_t* shard, tb_bool_t reclaim)
+{
+    // free all entries
+    tb_string_pool_table_t* table = (tb_string_pool_table_t*)tb_atomic_get(&shard->table);
+    if (table)
+    {
+        tb_size_t i = 0;
+        tb_size_t n = table->mask + 1;
+        for (i = 0; i < n; i++)
+        {
+            tb_long_t slot = tb_atomic_get(&table->slots[i]);
+            if (reclaim && slot && slot != TB_STRING_POOL_SLOT_DELETED) tb_free((tb_pointer_t)slot);
+            tb_atomic_set(&table->slots[i], 0);
+        }
+    }
+
+    // free all retired entries
+    while (shard->retired_entries)
+    {
+        tb_string_pool_entry_t* next = shard->retired_entries->retired;
+        tb_free(shard->retired_entries);
+        shard->retired_entries = next;
+    }
+
+    // free all retired tables
+    while (shard->retired_tables)
+    {
+        tb_string_pool_table_t* next = shard->retired_tables->retired;
+        tb_free(shard->retired_tables);
+        shard->retired_tables = next;
+    }
+
+    // free all arena chunks
+    while (shard->arena)
+    {
+        tb_byte_t* next = *((tb_byte_t**)shard->arena);
+        tb_free(shard->arena);
+        shard->arena = next;
+    }
+    shard->arena_data = tb_null;
+    shard->arena_left = 0;
+
+    // reset size
+    shard->size = 0;
+    shard->dels = 0;
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
 tb_string_pool_ref_t tb_string_pool_init(tb_bool_t bcase)
+{
+    return tb_string_pool_init_with(TB_STRING_POOL_FLAG_RECLAIM | (bcase? 0 : TB_STRING_POOL_FLAG_NOCASE));
+}
+tb_string_pool_ref_t tb_string_pool_init_with(tb_size_t flags)
 {
     // done
     tb_bool_t           ok = tb_false;
@@ -63,9 +456,16 @@ tb_string_pool_ref_t tb_string_pool_init(tb_bool_t bcase)
         pool = tb_malloc0_type(tb_string_pool_t);
         tb_assert_and_check_break(pool);
 
-        // init hash
-        pool->cache = tb_hash_map_init(0, tb_element_str(bcase), tb_element_size());
-        tb_assert_and_check_break(pool->cache);
+        // init flags
+        pool->flags = flags;
+
+        // init shards
+        tb_size_t i = 0;
+        for (i = 0; i < TB_STRING_POOL_SHARD_COUNT; i++)
+        {
+            if (!tb_string_pool_shard_init(&pool->shards[i])) break;
+        }
+        tb_assert_and_check_break(i == TB_STRING_POOL_SHARD_COUNT);
 
         // ok
         ok = tb_true;
@@ -89,9 +489,23 @@ tb_void_t tb_string_pool_exit(tb_string_pool_ref_t self)
     tb_string_pool_t* pool = (tb_string_pool_t*)self;
     tb_assert_and_check_return(pool);
 
-    // exit cache
-    if (pool->cache) tb_hash_map_exit(pool->cache);
-    pool->cache = tb_null;
+    // exit shards
+    tb_size_t i = 0;
+    tb_bool_t reclaim = (pool->flags & TB_STRING_POOL_FLAG_RECLAIM)? tb_true : tb_false;
+    for (i = 0; i < TB_STRING_POOL_SHARD_COUNT; i++)
+    {
+        // clear it
+        tb_string_pool_shard_t* shard = &pool->shards[i];
+        tb_string_pool_shard_clear(shard, reclaim);
+
+        // exit table
+        tb_pointer_t table = (tb_pointer_t)tb_atomic_get(&shard->table);
+        if (table) tb_free(table);
+        tb_atomic_set(&shard->table, 0);
+
+        // exit lock
+        tb_spinlock_exit(&shard->lock);
+    }
 
     // exit it
     tb_free(pool);
@@ -102,8 +516,16 @@ tb_void_t tb_string_pool_clear(tb_string_pool_ref_t self)
     tb_string_pool_t* pool = (tb_string_pool_t*)self;
     tb_assert_and_check_return(pool);
 
-    // clear cache
-    if (pool->cache) tb_hash_map_clear(pool->cache);
+    // clear shards
+    tb_size_t i = 0;
+    tb_bool_t reclaim = (pool->flags & TB_STRING_POOL_FLAG_RECLAIM)? tb_true : tb_false;
+    for (i = 0; i < TB_STRING_POOL_SHARD_COUNT; i++)
+    {
+        tb_string_pool_shard_t* shard = &pool->shards[i];
+        tb_spinlock_enter(&shard->lock);
+        tb_string_pool_shard_clear(shard, reclaim);
+        tb_spinlock_leave(&shard->lock);
+    }
 }
 tb_char_t const* tb_string_pool_insert(tb_string_pool_ref_t self, tb_char_t const* data)
 {
@@ -111,47 +533,94 @@ tb_char_t const* tb_string_pool_insert(tb_string_pool_ref_t self, tb_char_t cons
     tb_string_pool_t* pool = (tb_string_pool_t*)self;
     tb_assert_and_check_return_val(pool && data, tb_null);
 
-    // done
-    tb_char_t const* cstr = tb_null;
-    if (pool->cache)
-    {
-        // exists?
-        tb_size_t               itor;
-        tb_hash_map_item_ref_t  item = tb_null;
-        if (    ((itor = tb_hash_map_find(pool->cache, data)) != tb_iterator_tail(pool->cache))
-            &&  (item = (tb_hash_map_item_ref_t)tb_iterator_item(pool->cache, itor)))
+    // compute hash and size
+    tb_size_t size = 0;
+    tb_bool_t bcase = !(pool->flags & TB_STRING_POOL_FLAG_NOCASE);
+    tb_bool_t reclaim = (pool->flags & TB_STRING_POOL_FLAG_RECLAIM)? tb_true : tb_false;
+    tb_size_t hash = tb_string_pool_hash(data, &size, bcase);
+    tb_string_pool_shard_t* shard = tb_string_pool_shard(pool, hash);
+
+    // find it without lock first
+    tb_string_pool_entry_t* entry = tb_null;
+    if (reclaim)
+    {
+        tb_size_t epoch = tb_string_pool_shard_enter(shard);
+        entry = tb_string_pool_table_find((tb_string_pool_table_t*)tb_atomic_get_explicit(&shard->table, TB_ATOMIC_ACQUIRE), data, size, hash, bcase);
+        if (entry)
         {
-            // refn
-            tb_size_t refn = (tb_size_t)item->data;
+            // refn++ if it has not been removed
+            tb_long_t refn = tb_atomic_get(&entry->refn);
+            while (refn > 0 && !tb_atomic_compare_and_swap(&entry->refn, &refn, refn + 1)) ;
+            if (refn <= 0) entry = tb_null;
+        }
+        tb_string_pool_shard_leave(shard, epoch);
+    }
+    else
+    {
+        // the entries are never freed before clearing pool
+        entry = tb_string_pool_table_find((tb_string_pool_table_t*)tb_atomic_get_explicit(&shard->table, TB_ATOMIC_ACQUIRE), data, size, hash, bcase);
+        if (entry) tb_atomic_fetch_and_add(&entry->refn, 1);
+    }
+    if (entry) return (tb_char_t const*)(entry + 1);
 
-            // refn++
-            if (refn) tb_iterator_copy(pool->cache, itor, (tb_pointer_t)(refn + 1));
-            // no refn? remove it
-            else
-            {
-                // assert
-                tb_assert(0);
+    // enter lock
+    tb_spinlock_enter(&shard->lock);
 
-                // del it
-                tb_iterator_remove(pool->cache, itor);
-                item = tb_null;
-            }
-        }
+    // find it again, it may be inserted by other threads
+    entry = tb_string_pool_table_find((tb_string_pool_table_t*)tb_atomic_get(&shard->table), data, size, hash, bcase);
+    if (entry) tb_atomic_fetch_and_add(&entry->refn, 1);
+    else if (tb_string_pool_shard_grow(shard, reclaim) && (entry = tb_string_pool_shard_alloc(shard, size, reclaim)))
+    {
+        // init entry
+        tb_atomic_init(&entry->refn, 1);
+        entry->retired = tb_null;
+        entry->epoch   = 0;
+        entry->hash    = hash;
+        entry->size    = size;
+        tb_memcpy(entry + 1, data, size + 1);
 
-        // no item? insert it
-        if (!item)
-        {
-            // insert it
-            if ((itor = tb_hash_map_insert(pool->cache, data, (tb_pointer_t)1)) != tb_iterator_tail(pool->cache))
-                item = (tb_hash_map_item_ref_t)tb_iterator_item(pool->cache, itor);
-        }
+        // find a free slot
+        tb_string_pool_table_t* table = (tb_string_pool_table_t*)tb_atomic_get(&shard->table);
+        tb_size_t               i = hash & table->mask;
+        tb_long_t               slot;
+        while ((slot = tb_atomic_get_explicit(&table->slots[i], TB_ATOMIC_RELAXED)) && slot != TB_STRING_POOL_SLOT_DELETED)
+            i = (i + 1) & table->mask;
+        if (slot == TB_STRING_POOL_SLOT_DELETED) shard->dels--;
+        shard->size++;
 
-        // save the cstr
-        if (item) cstr = (tb_char_t const*)item->name;
+        // publish it
+        tb_atomic_set_explicit(&table->slots[i], (tb_long_t)entry, TB_ATOMIC_RELEASE);
     }
 
+    // reclaim the retired data
+    if (reclaim) tb_string_pool_shard_reclaim(shard);
+
+    // leave lock
+    tb_spinlock_leave(&shard->lock);
+
     // ok?
-    return cstr;
+    return entry? (tb_char_t const*)(entry + 1) : tb_null;
+}
+tb_char_t const* tb_string_pool_find(tb_string_pool_ref_t self, tb_char_t const* data)
+{
+    // check
+    tb_string_pool_t* pool = (tb_string_pool_t*)self;
+    tb_assert_and_check_return_val(pool && data, tb_null);
+
+    // compute hash and size
+    tb_size_t size = 0;
+    tb_bool_t bcase = !(pool->flags & TB_STRING_POOL_FLAG_NOCASE);
+    tb_bool_t reclaim = (pool->flags & TB_STRING_POOL_FLAG_RECLAIM)? tb_true : tb_false;
+    tb_size_t hash = tb_string_pool_hash(data, &size, bcase);
+    tb_string_pool_shard_t* shard = tb_string_pool_shard(pool, hash);
+
+    // find it without lock
+    tb_size_t epoch = reclaim? tb_string_pool_shard_enter(shard) : 0;
+    tb_string_pool_entry_t* entry = tb_string_pool_table_find((tb_string_pool_table_t*)tb_atomic_get_explicit(&shard->table, TB_ATOMIC_ACQUIRE), data, size, hash, bcase);
+    if (reclaim) tb_string_pool_shard_leave(shard, epoch);
+
+    // ok?
+    return entry? (tb_char_t const*)(entry + 1) : tb_null;
 }
 tb_void_t tb_string_pool_remove(tb_string_pool_ref_t self, tb_char_t const* data)
 {
@@ -159,37 +628,99 @@ tb_void_t tb_string_pool_remove(tb_string_pool_ref_t self, tb_char_t const* data
     tb_string_pool_t* pool = (tb_string_pool_t*)self;
     tb_assert_and_check_return(pool && data);
 
-    // done
-    tb_hash_map_item_ref_t item = tb_null;
-    if (pool->cache)
+    // compute hash and size
+    tb_size_t size = 0;
+    tb_bool_t bcase = !(pool->flags & TB_STRING_POOL_FLAG_NOCASE);
+    tb_size_t hash = tb_string_pool_hash(data, &size, bcase);
+    tb_string_pool_shard_t* shard = tb_string_pool_shard(pool, hash);
+
+    // no reclaim? we only decrease the reference count and keep it in the pool
+    if (!(pool->flags & TB_STRING_POOL_FLAG_RECLAIM))
     {
-        // exists?
-        tb_size_t itor;
-        if (    ((itor = tb_hash_map_find(pool->cache, data)) != tb_iterator_tail(pool->cache))
-            &&  (item = (tb_hash_map_item_ref_t)tb_iterator_item(pool->cache, itor)))
+        tb_string_pool_entry_t* entry = tb_string_pool_table_find((tb_string_pool_table_t*)tb_atomic_get_explicit(&shard->table, TB_ATOMIC_ACQUIRE), data, size, hash, bcase);
+        if (entry)
         {
-            // refn
-            tb_size_t refn = (tb_size_t)item->data;
-
-            // refn--
-            if (refn > 1) tb_iterator_copy(pool->cache, itor, (tb_pointer_t)(refn - 1));
-            // del it
-            else tb_iterator_remove(pool->cache, itor);
+            tb_long_t refn = tb_atomic_get(&entry->refn);
+            while (refn > 0 && !tb_atomic_compare_and_swap(&entry->refn, &refn, refn - 1)) ;
         }
+        return ;
     }
+
+    // enter lock
+    tb_spinlock_enter(&shard->lock);
+
+    // find it
+    tb_string_pool_table_t* table = (tb_string_pool_table_t*)tb_atomic_get(&shard->table);
+    tb_string_pool_entry_t* entry = tb_string_pool_table_find(table, data, size, hash, bcase);
+    if (entry && tb_atomic_fetch_and_sub(&entry->refn, 1) == 1)
+    {
+        // remove it from the table
+        tb_size_t i = hash & table->mask;
+        while (tb_atomic_get_explicit(&table->slots[i], TB_ATOMIC_RELAXED) != (tb_long_t)entry) i = (i + 1) & table->mask;
+        tb_atomic_set(&table->slots[i], TB_STRING_POOL_SLOT_DELETED);
+        shard->size--;
+        shard->dels++;
+
+        // retire it, some readers may be still using it
+        entry->epoch = (tb_size_t)tb_atomic_get(&shard->epoch);
+        entry->retired = shard->retired_entries;
+        shard->retired_entries = entry;
+    }
+
+    // reclaim the retired data
+    tb_string_pool_shard_reclaim(shard);
+
+    // leave lock
+    tb_spinlock_leave(&shard->lock);
+}
+tb_size_t tb_string_pool_cstr_size(tb_char_t const* cstr)
+{
+    // check
+    tb_assert_and_check_return_val(cstr, 0);
+
+    // the string size
+    return tb_string_pool_entry(cstr)->size;
+}
+tb_size_t tb_string_pool_cstr_hash(tb_char_t const* cstr)
+{
+    // check
+    tb_assert_and_check_return_val(cstr, 0);
+
+    // the string hash
+    return tb_string_pool_entry(cstr)->hash;
 }
 #ifdef __tb_debug__
 tb_void_t tb_string_pool_dump(tb_string_pool_ref_t self)
 {
     // check
     tb_string_pool_t* pool = (tb_string_pool_t*)self;
-    tb_assert_and_check_return(pool && pool->cache);
+    tb_assert_and_check_return(pool);
 
-    // dump cache
-    tb_for_all_if (tb_hash_map_item_ref_t, item, pool->cache, item)
+    // dump shards
+    tb_size_t i = 0;
+    for (i = 0; i < TB_STRING_POOL_SHARD_COUNT; i++)
     {
+        tb_string_pool_shard_t* shard = &pool->shards[i];
+        tb_spinlock_enter(&shard->lock);
+
         // trace
-        tb_trace_i("item: refn: %lu, cstr: %s", (tb_size_t)item->data, item->name);
+        tb_string_pool_table_t* table = (tb_string_pool_table_t*)tb_atomic_get(&shard->table);
+        tb_trace_i("shard[%lu]: size: %lu, dels: %lu, maxn: %lu", i, shard->size, shard->dels, table->mask + 1);
+
+        // dump items
+        tb_size_t j = 0;
+        tb_size_t n = table->mask + 1;
+        for (j = 0; j < n; j++)
+        {
+            tb_long_t slot = tb_atomic_get(&table->slots[j]);
+            if (slot && slot != TB_STRING_POOL_SLOT_DELETED)
+            {
+                tb_string_pool_entry_t* entry = (tb_string_pool_entry_t*)slot;
+                tb_trace_i("    item: refn: %ld, cstr: %s", tb_atomic_get(&entry->refn), (tb_char_t const*)(entry + 1));
+            }
+        }
+
+        tb_spinlock_leave(&shard->lock);
     }
 }
 #endif
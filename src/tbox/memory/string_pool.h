@@ -39,6 +39,15 @@ __tb_extern_c_enter__
 /// the string pool ref type
 typedef __tb_typeref__(string_pool);
 
+/// the string pool flag enum
+typedef enum __tb_string_pool_flag_e
+{
+    TB_STRING_POOL_FLAG_NONE        = 0     //!< case sensitive, and the strings are kept in the arena until clearing pool
+,   TB_STRING_POOL_FLAG_NOCASE      = 1     //!< case insensitive
+,   TB_STRING_POOL_FLAG_RECLAIM     = 2     //!< free the string if the reference count be zero, it will be reclaimed after all readers have left
+
+}tb_string_pool_flag_e;
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
@@ -47,12 +56,40 @@ typedef __tb_typeref__(string_pool);
  *
  * readonly, strip repeat strings and decrease memory fragmens
  *
+ * it is same as tb_string_pool_init_with(TB_STRING_POOL_FLAG_RECLAIM)
+ *
  * @param bcase             is case?
  *
  * @return                  the string pool
  */
 tb_string_pool_ref_t        tb_string_pool_init(tb_bool_t bcase);
 
+/*! init string pool with the given flags
+ *
+ * the pool is thread-safe and sharded, each shard has an open addressing table of the interned strings.
+ * finding and inserting the interned strings do not need any locks, we only lock the shard to insert new strings.
+ *
+ * the length and hash of the interned string are stored before it,
+ * so we can compare the interned strings by pointers and get their hash directly, e.g. tb_element_istr()
+ *
+ * @code
+ * tb_string_pool_ref_t pool = tb_string_pool_init_with(TB_STRING_POOL_FLAG_NOCASE);
+ * if (pool)
+ * {
+ *     tb_char_t const* name1 = tb_string_pool_insert(pool, "Content-Type");
+ *     tb_char_t const* name2 = tb_string_pool_insert(pool, "content-type");
+ *     tb_assert(name1 == name2);
+ *
+ *     tb_string_pool_exit(pool);
+ * }
+ * @endcode
+ *
+ * @param flags             the flags, e.g. TB_STRING_POOL_FLAG_NOCASE | TB_STRING_POOL_FLAG_RECLAIM
+ *
+ * @return                  the string pool
+ */
+tb_string_pool_ref_t        tb_string_pool_init_with(tb_size_t flags);
+
 /*! exit the string pool
  *
  * @param pool              the string pool
@@ -60,6 +97,8 @@ tb_string_pool_ref_t        tb_string_pool_init(tb_bool_t bcase);
 tb_void_t                   tb_string_pool_exit(tb_string_pool_ref_t pool);
 
 /*! clear the string pool
+ *
+ * @note it is not thread-safe, all interned strings will be freed
  *
  * @param pool              the string pool
  */
@@ -74,13 +113,40 @@ tb_void_t                   tb_string_pool_clear(tb_string_pool_ref_t pool);
  */
 tb_char_t const*            tb_string_pool_insert(tb_string_pool_ref_t pool, tb_char_t const* data);
 
-/*! remove string from the pool if the reference count be zero
+/*! find the interned string and do not change the reference count
+ *
+ * @note the returned string is only valid while somebody holds its reference if TB_STRING_POOL_FLAG_RECLAIM is enabled
+ *
+ * @param pool              the string pool
+ * @param data              the string data
+ *
+ * @return                  the interned string or tb_null
+ */
+tb_char_t const*            tb_string_pool_find(tb_string_pool_ref_t pool, tb_char_t const* data);
+
+/*! decrease the reference count, and remove string from the pool if it be zero and TB_STRING_POOL_FLAG_RECLAIM is enabled
  *
  * @param pool              the string pool
  * @param data              the string data
  */
 tb_void_t                   tb_string_pool_remove(tb_string_pool_ref_t pool, tb_char_t const* data);
 
+/*! get the size of the interned string
+ *
+ * @param cstr              the interned string returned by tb_string_pool_insert()
+ *
+ * @return                  the string size
+ */
+tb_size_t                   tb_string_pool_cstr_size(tb_char_t const* cstr);
+
+/*! get the hash of the interned string
+ *
+ * @param cstr              the interned string returned by tb_string_pool_insert()
+ *
+ * @return                  the string hash
+ */
+tb_size_t                   tb_string_pool_cstr_hash(tb_char_t const* cstr);
+
 #ifdef __tb_debug__
 /*! dump the string pool
  *
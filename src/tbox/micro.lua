@@ -42,9 +42,11 @@ target("tbox")
     add_files("libc/string/strlcpy.c")
     add_files("libc/string/strncpy.c")
     add_files("libc/stdio/vsnprintf.c")
+    add_files("libc/stdio/printf_float.c")
     add_files("libc/stdio/snprintf.c")
     add_files("libc/stdio/printf.c")
     add_files("libc/stdlib/stdlib.c")
+    add_files("libc/stdlib/strtod.c")
     add_files("libc/impl/libc.c")
     add_files("libm/impl/libm.c")
     add_files("math/impl/math.c")
@@ -36,60 +36,174 @@
 #include "../math/math.h"
 #include "../utils/utils.h"
 #include "../string/string.h"
+#include "../stream/stream.h"
 #include "../platform/platform.h"
 #include "../algorithm/algorithm.h"
 #include "../container/container.h"
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the shard count, the cookies of the same site (the last two domain labels) are always in the same shard
+#ifdef __tb_small__
+#   define TB_COOKIES_SHARD_MAXN            (4)
+#else
+#   define TB_COOKIES_SHARD_MAXN            (16)
+#endif
+
+// the entry grow count of each shard
+#ifdef __tb_small__
+#   define TB_COOKIES_ENTRY_GROW            (64)
+#else
+#   define TB_COOKIES_ENTRY_GROW            (256)
+#endif
+
+// the snapshot magic: "TBCK" and version
+#define TB_COOKIES_SNAPSHOT_MAGIC           (0x5442434b)
+#define TB_COOKIES_SNAPSHOT_VERSION         (1)
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
 
-// the cookies entry type
-typedef struct __tb_cookies_entry_t
+// the cookies item type, it is parsed from the value of "Set-Cookie"
+typedef struct __tb_cookies_item_t
 {
     // the domain
-    tb_char_t const*        domain;
+    tb_char_t const*                domain;
 
     // the path
-    tb_char_t const*        path;
+    tb_char_t const*                path;
 
     // the name
-    tb_char_t const*        name;
+    tb_char_t const*                name;
 
     // the value
-    tb_char_t const*        value;
+    tb_char_t const*                value;
 
     // the expires
-    tb_time_t               expires;
+    tb_time_t                       expires;
 
     // the max-age, default: 1 and storage: 0
-    tb_uint32_t             maxage  : 30;
+    tb_uint32_t                     maxage  : 30;
 
     // storage cookies to file? remove it immediately if maxage == 0 and storage: 0
-    tb_uint32_t             storage : 1;
+    tb_uint32_t                     storage : 1;
 
     // is secure?
-    tb_uint32_t             secure  : 1;
+    tb_uint32_t                     secure  : 1;
+
+}tb_cookies_item_t, *tb_cookies_item_ref_t;
+
+/* the path node type of the path trie, we split path to segments by '/'
+ *
+ * e.g. "/" is the root node, "/style" => "style" and "/style/foo/" => "style" -> "foo" -> ""
+ *
+ * so the parent path is always the ancestor node of the matched child path
+ */
+typedef struct __tb_cookies_path_t
+{
+    // the parent node
+    struct __tb_cookies_path_t*     parent;
+
+    // the first child node
+    struct __tb_cookies_path_t*     child;
+
+    // the next sibling node
+    struct __tb_cookies_path_t*     next;
+
+    // the entries at this path
+    struct __tb_cookies_entry_t*    entries;
+
+    // the segment size, the segment data is following this node
+    tb_size_t                       size;
+
+}tb_cookies_path_t, *tb_cookies_path_ref_t;
+
+// the domain node type
+typedef struct __tb_cookies_domain_t
+{
+    // the domain
+    tb_char_t const*                domain;
+
+    // the root path node
+    tb_cookies_path_t               root;
+
+}tb_cookies_domain_t, *tb_cookies_domain_ref_t;
+
+// the cookies entry type
+typedef struct __tb_cookies_entry_t
+{
+    // the next entry at the same path
+    struct __tb_cookies_entry_t*    next;
+
+    // the domain node
+    tb_cookies_domain_ref_t         domain;
+
+    // the path node
+    tb_cookies_path_ref_t           path;
+
+    // the name
+    tb_char_t const*                name;
+
+    // the value
+    tb_char_t const*                value;
+
+    // the expires, no expires: 0
+    tb_time_t                       expires;
+
+    // the index of the expires heap, not in heap: -1
+    tb_size_t                       index;
+
+    // the max-age
+    tb_uint32_t                     maxage  : 30;
+
+    // storage cookies to file?
+    tb_uint32_t                     storage : 1;
+
+    // is secure?
+    tb_uint32_t                     secure  : 1;
 
 }tb_cookies_entry_t, *tb_cookies_entry_ref_t;
 
-// the cookies type
-typedef struct __tb_cookies_t
+// the cookies shard type
+typedef struct __tb_cookies_shard_t
 {
     // the lock
-    tb_spinlock_t           lock;
+    tb_spinlock_t                   lock;
+
+    // the domains, domain => tb_cookies_domain_ref_t
+    tb_hash_map_ref_t               domains;
 
-    // the string element
-    tb_element_t            string_element;
+    // the entry pool
+    tb_fixed_pool_ref_t             entry_pool;
 
-    // the string pool
-    tb_string_pool_ref_t    string_pool;
+    // the min-heap of the entries with expires, we evict the expired entries lazily from the top
+    tb_cookies_entry_ref_t*         heap;
 
-    // the cookie pool, key: "domain+path+name"
-    tb_hash_set_ref_t       cookie_pool;
+    // the heap size
+    tb_size_t                       heap_size;
+
+    // the heap maxn
+    tb_size_t                       heap_maxn;
+
+}tb_cookies_shard_t, *tb_cookies_shard_ref_t;
+
+// the cookies type
+typedef struct __tb_cookies_t
+{
+    // the string pool, it is thread-safe
+    tb_string_pool_ref_t            string_pool;
+
+    // the shards
+    tb_cookies_shard_t              shards[TB_COOKIES_SHARD_MAXN];
 
 }tb_cookies_t;
 
+// the cookies walk func type
+typedef tb_bool_t                   (*tb_cookies_walk_func_t)(tb_cookies_entry_ref_t entry, tb_char_t const* path, tb_cpointer_t priv);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * private implementation
  */
@@ -152,126 +266,35 @@ static tb_bool_t tb_cookies_get_domain_and_path_from_url(tb_char_t const* url, t
     // ok?
     return *pdomain? tb_true : tb_false;
 }
-static tb_bool_t tb_cookies_is_child_domain(tb_char_t const* parent, tb_char_t const* child)
+static tb_void_t tb_cookies_item_exit(tb_cookies_t* cookies, tb_cookies_item_ref_t item)
 {
     // check
-    tb_assert_and_check_return_val(parent && child, tb_false);
-
-    // init
-    tb_char_t const*    pb = parent;
-    tb_char_t const*    cb = child;
-    tb_size_t           pn = tb_strlen(pb);
-    tb_size_t           cn = tb_strlen(cb);
-    tb_assert_and_check_return_val(pn && cn, tb_false);
-
-    // is child?
-    tb_size_t           n = 0;
-    tb_char_t const*    pe = pb + pn - 1;
-    tb_char_t const*    ce = cb + cn - 1;
-    for (; pe >= pb && ce >= cb && *pe == *ce; pe--, ce--)
-    {
-        if (*ce == '.') n++;
-    }
-
-    // ok?
-    return (pe < pb && n >= 1 && (ce < cb || *ce == '.'))? tb_true : tb_false;
-}
-static tb_bool_t tb_cookies_is_child_path(tb_char_t const* parent, tb_char_t const* child)
-{
-    // check
-    tb_assert_and_check_return_val(parent && child, tb_false);
-
-    // parent is root?
-    if (parent[0] == '/' && !parent[1]) return tb_true;
-
-    // is child?
-    tb_char_t const*    p = parent;
-    tb_char_t const*    c = child;
-    tb_size_t           n = tb_strlen(parent);
-    while (n-- && *p && *c && *p++ == *c++) ;
-
-    // ok?
-    return (!*p && (!*c || *c == '/'))? tb_true : tb_false;
-}
-static tb_void_t tb_cookies_entry_exit(tb_cookies_t* cookies, tb_cookies_entry_ref_t entry)
-{
-    // check
-    tb_assert_and_check_return(cookies && entry);
+    tb_assert_and_check_return(cookies && item);
 
     // exit domain
-    if (entry->domain) tb_string_pool_remove(cookies->string_pool, entry->domain);
-    entry->domain = tb_null;
+    if (item->domain) tb_string_pool_remove(cookies->string_pool, item->domain);
+    item->domain = tb_null;
 
     // exit path
-    if (entry->path) tb_string_pool_remove(cookies->string_pool, entry->path);
-    entry->path = tb_null;
+    if (item->path) tb_string_pool_remove(cookies->string_pool, item->path);
+    item->path = tb_null;
 
     // exit name
-    if (entry->name) tb_string_pool_remove(cookies->string_pool, entry->name);
-    entry->name = tb_null;
+    if (item->name) tb_string_pool_remove(cookies->string_pool, item->name);
+    item->name = tb_null;
 
     // exit value
-    if (entry->value) tb_string_pool_remove(cookies->string_pool, entry->value);
-    entry->value = tb_null;
-}
-static tb_void_t tb_cookies_entry_free(tb_element_ref_t element, tb_pointer_t buff)
-{
-    // check
-    tb_cookies_entry_ref_t entry = (tb_cookies_entry_ref_t)buff;
-    tb_assert_and_check_return(element && entry);
-
-    // the cookies
-    tb_cookies_t* cookies = (tb_cookies_t*)element->priv;
-    tb_assert_and_check_return(cookies && cookies->string_pool);
-
-    // exit it
-    tb_cookies_entry_exit(cookies, entry);
-}
-static tb_size_t tb_cookies_entry_hash(tb_element_ref_t element, tb_cpointer_t data, tb_size_t mask, tb_size_t index)
-{
-    // check
-    tb_cookies_entry_ref_t entry = (tb_cookies_entry_ref_t)data;
-    tb_assert_and_check_return_val(element && entry && entry->domain, 0);
-
-    // the cookies
-    tb_cookies_t* cookies = (tb_cookies_t*)element->priv;
-    tb_assert_and_check_return_val(cookies && cookies->string_element.hash, 0);
-
-    // compute the three hash values
-    tb_size_t v0 = cookies->string_element.hash(&cookies->string_element, entry->domain, mask, index);
-    tb_size_t v1 = entry->path? cookies->string_element.hash(&cookies->string_element, entry->path, mask, index) : 0;
-    tb_size_t v2 = entry->name? cookies->string_element.hash(&cookies->string_element, entry->name, mask, index) : 0;
-
-    // the hash value
-    return (v0 ^ v1 ^ v2) & mask;
-}
-static tb_long_t tb_cookies_entry_comp(tb_element_ref_t element, tb_cpointer_t ldata, tb_cpointer_t rdata)
-{
-    // check
-    tb_cookies_entry_ref_t lentry = (tb_cookies_entry_ref_t)ldata;
-    tb_cookies_entry_ref_t rentry = (tb_cookies_entry_ref_t)rdata;
-    tb_assert_and_check_return_val(lentry && lentry->domain, 0);
-    tb_assert_and_check_return_val(rentry && rentry->domain, 0);
-
-    // compare domain
-    tb_long_t ok = tb_strcmp(lentry->domain, rentry->domain);
-    tb_check_return_val(!ok, ok);
-
-    // compare domain
-    ok = tb_strcmp(lentry->path? lentry->path : "", rentry->path? rentry->path : "");
-    tb_check_return_val(!ok, ok);
-
-    // compare name
-    return tb_strcmp(lentry->name? lentry->name : "", rentry->name? rentry->name : "");
+    if (item->value) tb_string_pool_remove(cookies->string_pool, item->value);
+    item->value = tb_null;
 }
-static tb_bool_t tb_cookies_entry_init(tb_cookies_t* cookies, tb_cookies_entry_ref_t entry, tb_char_t const* domain, tb_char_t const* path, tb_bool_t secure, tb_char_t const* value)
+static tb_bool_t tb_cookies_item_init(tb_cookies_t* cookies, tb_cookies_item_ref_t item, tb_char_t const* domain, tb_char_t const* path, tb_bool_t secure, tb_char_t const* value)
 {
     // check
-    tb_assert_and_check_return_val(cookies && cookies->string_pool && entry && value, tb_false);
+    tb_assert_and_check_return_val(cookies && cookies->string_pool && item && value, tb_false);
 
     // init maxage: -1
-    entry->maxage = 1;
-    entry->storage = 0;
+    item->maxage = 1;
+    item->storage = 0;
 
     // done
     tb_char_t const* p = value;
@@ -296,7 +319,7 @@ static tb_bool_t tb_cookies_entry_init(tb_cookies_t* cookies, tb_cookies_entry_r
                 tb_assert_and_check_return_val(v, tb_false);
 
                 // make expires time
-                entry->expires = tb_http_date_from_cstr(v, p - v);
+                item->expires = tb_http_date_from_cstr(v, p - v);
             }
             else if (!tb_strnicmp(b, "max-age", 7))
             {
@@ -307,10 +330,10 @@ static tb_bool_t tb_cookies_entry_init(tb_cookies_t* cookies, tb_cookies_entry_r
                 tb_long_t maxage = tb_stoi32(v);
 
                 // storage to file?
-                entry->storage = maxage > 0? 1 : 0;
+                item->storage = maxage > 0? 1 : 0;
 
                 // save maxage
-                entry->maxage = tb_abs(maxage);
+                item->maxage = tb_abs(maxage);
             }
             else if (!tb_strnicmp(b, "domain", 6))
             {
@@ -322,7 +345,7 @@ static tb_bool_t tb_cookies_entry_init(tb_cookies_t* cookies, tb_cookies_entry_r
                 if (v < p)
                 {
                     tb_strncpy(data, v, p - v); data[p - v] = '\0';
-                    entry->domain = tb_string_pool_insert(cookies->string_pool, data[0] == '.'? data + 1 : data);
+                    item->domain = tb_string_pool_insert(cookies->string_pool, data[0] == '.'? data + 1 : data);
                 }
             }
             else if (!tb_strnicmp(b, "path", 4))
@@ -335,7 +358,7 @@ static tb_bool_t tb_cookies_entry_init(tb_cookies_t* cookies, tb_cookies_entry_r
                 if (v < p)
                 {
                     tb_strncpy(data, v, p - v); data[p - v] = '\0';
-                    entry->path = tb_string_pool_insert(cookies->string_pool, data);
+                    item->path = tb_string_pool_insert(cookies->string_pool, data);
                 }
             }
             else if (!tb_strnicmp(b, "version", 7))
@@ -343,7 +366,7 @@ static tb_bool_t tb_cookies_entry_init(tb_cookies_t* cookies, tb_cookies_entry_r
                 // must have value
                 tb_assert_and_check_return_val(v, tb_false);
             }
-            else if (!tb_strnicmp(b, "secure", 6)) entry->secure = 1;
+            else if (!tb_strnicmp(b, "secure", 6)) item->secure = 1;
             // ignore it
             else if (!tb_strnicmp(b, "HttpOnly", 8)) ;
             // key=value
@@ -355,20 +378,20 @@ static tb_bool_t tb_cookies_entry_init(tb_cookies_t* cookies, tb_cookies_entry_r
                 // save name
                 tb_assert_and_check_return_val(v - b - 1 < sizeof(data), tb_false);
                 tb_strncpy(data, b, v - b - 1); data[v - b - 1] = '\0';
-                entry->name = tb_string_pool_insert(cookies->string_pool, data);
-                tb_assert_and_check_return_val(entry->name, tb_false);
+                item->name = tb_string_pool_insert(cookies->string_pool, data);
+                tb_assert_and_check_return_val(item->name, tb_false);
 
                 // save value
                 tb_assert_and_check_return_val(p - v < sizeof(data), tb_false);
                 if (v < p)
                 {
                     tb_strncpy(data, v, p - v); data[p - v] = '\0';
-                    entry->value = tb_string_pool_insert(cookies->string_pool, data);
-                    tb_assert_and_check_return_val(entry->value, tb_false);
+                    item->value = tb_string_pool_insert(cookies->string_pool, data);
+                    tb_assert_and_check_return_val(item->value, tb_false);
                 }
 
                 // trace
-                tb_trace_d("set %s=%s", entry->name, entry->value? entry->value : "");
+                tb_trace_d("set %s=%s", item->name, item->value? item->value : "");
             }
 
             // next key-value pair
@@ -392,7 +415,7 @@ static tb_bool_t tb_cookies_entry_init(tb_cookies_t* cookies, tb_cookies_entry_r
     }
 
     // domain not exists? using the given domain
-    if (!entry->domain && domain)
+    if (!item->domain && domain)
     {
         // the domain size
         tb_size_t n = tb_strlen(domain);
@@ -408,9 +431,9 @@ static tb_bool_t tb_cookies_entry_init(tb_cookies_t* cookies, tb_cookies_entry_r
         if (n && *domain == '.') domain++;
 
         // save domain
-        entry->domain = tb_string_pool_insert(cookies->string_pool, domain);
+        item->domain = tb_string_pool_insert(cookies->string_pool, domain);
     }
-    if (!entry->domain)
+    if (!item->domain)
     {
         // trace
         tb_trace_e("no domain for value: %s", value);
@@ -418,60 +441,470 @@ static tb_bool_t tb_cookies_entry_init(tb_cookies_t* cookies, tb_cookies_entry_r
     }
 
     // path not exists? using the given path
-    if (!entry->path) entry->path = tb_string_pool_insert(cookies->string_pool, path? path : "/");
-    tb_assert_and_check_return_val(entry->path, tb_false);
+    if (!item->path) item->path = tb_string_pool_insert(cookies->string_pool, path? path : "/");
+    tb_assert_and_check_return_val(item->path, tb_false);
 
     // no secure? using the given secure value
-    if (!entry->secure && secure) entry->secure = 1;
+    if (!item->secure && secure) item->secure = 1;
 
     // ok
     return tb_true;
 }
-static tb_bool_t tb_cookies_entry_walk(tb_iterator_ref_t iterator, tb_cpointer_t item, tb_cpointer_t value)
+static tb_cookies_shard_ref_t tb_cookies_shard(tb_cookies_t* cookies, tb_char_t const* domain)
 {
     // check
-    tb_value_t* tuple = (tb_value_t*)value;
-    tb_assert(item && tuple);
+    tb_assert(cookies && domain);
+
+    /* find the last two labels of domain, e.g. "www.space.baidu.com" => "baidu.com"
+     *
+     * the matched parent domains of the given domain always contain them,
+     * so we need only lookup one shard for getting cookies
+     */
+    tb_size_t           dots = 0;
+    tb_char_t const*    e = domain + tb_strlen(domain);
+    tb_char_t const*    p = e;
+    while (p > domain && (p[-1] != '.' || ++dots < 2)) p--;
+
+    // compute hash
+    tb_uint32_t hash = 2166136261ul;
+    while (p < e)
+    {
+        hash ^= (tb_byte_t)*p++;
+        hash *= 16777619ul;
+    }
+    return &cookies->shards[(hash ^ (hash >> 16)) % TB_COOKIES_SHARD_MAXN];
+}
+static __tb_inline__ tb_void_t tb_cookies_heap_set(tb_cookies_shard_ref_t shard, tb_size_t index, tb_cookies_entry_ref_t entry)
+{
+    shard->heap[index] = entry;
+    entry->index = index;
+}
+static tb_void_t tb_cookies_heap_up(tb_cookies_shard_ref_t shard, tb_size_t index)
+{
+    // move it up until the parent entry is earlier
+    tb_cookies_entry_ref_t entry = shard->heap[index];
+    while (index)
+    {
+        tb_size_t parent = (index - 1) >> 1;
+        tb_check_break(shard->heap[parent]->expires > entry->expires);
+        tb_cookies_heap_set(shard, index, shard->heap[parent]);
+        index = parent;
+    }
+    tb_cookies_heap_set(shard, index, entry);
+}
+static tb_void_t tb_cookies_heap_down(tb_cookies_shard_ref_t shard, tb_size_t index)
+{
+    // move it down until the child entries are later
+    tb_size_t               child;
+    tb_size_t               size = shard->heap_size;
+    tb_cookies_entry_ref_t  entry = shard->heap[index];
+    while ((child = (index << 1) + 1) < size)
+    {
+        if (child + 1 < size && shard->heap[child + 1]->expires < shard->heap[child]->expires) child++;
+        tb_check_break(shard->heap[child]->expires < entry->expires);
+        tb_cookies_heap_set(shard, index, shard->heap[child]);
+        index = child;
+    }
+    tb_cookies_heap_set(shard, index, entry);
+}
+static tb_bool_t tb_cookies_heap_push(tb_cookies_shard_ref_t shard, tb_cookies_entry_ref_t entry)
+{
+    // check
+    tb_assert_and_check_return_val(entry->expires && entry->index == (tb_size_t)-1, tb_false);
 
-    // the entry
-    tb_cookies_entry_ref_t entry = (tb_cookies_entry_ref_t)item;
-    tb_assert(entry && entry->domain);
+    // grow heap
+    if (shard->heap_size >= shard->heap_maxn)
+    {
+        tb_size_t               maxn = shard->heap_maxn? (shard->heap_maxn << 1) : TB_COOKIES_ENTRY_GROW;
+        tb_cookies_entry_ref_t* heap = tb_ralloc_type(shard->heap, maxn, tb_cookies_entry_ref_t);
+        tb_assert_and_check_return_val(heap, tb_false);
 
-    // the domain
-    tb_char_t const* domain = tuple[0].cstr;
+        shard->heap = heap;
+        shard->heap_maxn = maxn;
+    }
 
-    // the path
-    tb_char_t const* path = tuple[1].cstr;
+    // push it
+    tb_cookies_heap_set(shard, shard->heap_size++, entry);
+    tb_cookies_heap_up(shard, entry->index);
+    return tb_true;
+}
+static tb_void_t tb_cookies_heap_remove(tb_cookies_shard_ref_t shard, tb_cookies_entry_ref_t entry)
+{
+    // not in heap?
+    tb_size_t index = entry->index;
+    tb_check_return(index != (tb_size_t)-1);
+    tb_assert_and_check_return(index < shard->heap_size && shard->heap[index] == entry);
+
+    // remove it and fill this hole with the last entry
+    entry->index = (tb_size_t)-1;
+    tb_cookies_entry_ref_t last = shard->heap[--shard->heap_size];
+    if (last != entry)
+    {
+        tb_cookies_heap_set(shard, index, last);
+        if (index && shard->heap[(index - 1) >> 1]->expires > last->expires)
+            tb_cookies_heap_up(shard, index);
+        else tb_cookies_heap_down(shard, index);
+    }
+}
+static tb_cookies_path_ref_t tb_cookies_path_find(tb_cookies_path_ref_t root, tb_char_t const* path, tb_bool_t create)
+{
+    // check
+    tb_assert(root && path);
+
+    // the root path?
+    tb_char_t const* p = path;
+    if (*p == '/') p++;
+    tb_check_return_val(*p, root);
+
+    // find or create the path nodes of all segments
+    tb_cookies_path_ref_t node = root;
+    while (node)
+    {
+        // the segment
+        tb_char_t const* e = p;
+        while (*e && *e != '/') e++;
+        tb_size_t n = e - p;
+
+        // find the child node of this segment
+        tb_cookies_path_ref_t child = node->child;
+        while (child && (child->size != n || tb_memcmp(child + 1, p, n))) child = child->next;
+
+        // create a new child node if not found
+        if (!child && create)
+        {
+            child = (tb_cookies_path_ref_t)tb_malloc0_bytes(sizeof(tb_cookies_path_t) + n + 1);
+            tb_assert_and_check_break(child);
+
+            child->size     = n;
+            child->parent   = node;
+            child->next     = node->child;
+            node->child     = child;
+            tb_memcpy(child + 1, p, n);
+        }
+
+        // next segment
+        node = child;
+        tb_check_break(*e);
+        p = e + 1;
+    }
+    return node;
+}
+static tb_void_t tb_cookies_path_prune(tb_cookies_t* cookies, tb_cookies_shard_ref_t shard, tb_cookies_domain_ref_t domain, tb_cookies_path_ref_t node)
+{
+    // remove the empty path nodes
+    while (node->parent && !node->entries && !node->child)
+    {
+        // unlink it from parent
+        tb_cookies_path_ref_t  parent = node->parent;
+        tb_cookies_path_ref_t* pnode = &parent->child;
+        while (*pnode != node) pnode = &(*pnode)->next;
+        *pnode = node->next;
+
+        // free it
+        tb_free(node);
+        node = parent;
+    }
+
+    // remove the empty domain
+    if (!node->parent && !node->entries && !node->child)
+    {
+        tb_hash_map_remove(shard->domains, domain->domain);
+        tb_string_pool_remove(cookies->string_pool, domain->domain);
+        tb_free(domain);
+    }
+}
+static tb_void_t tb_cookies_entry_exit(tb_cookies_t* cookies, tb_cookies_entry_ref_t entry)
+{
+    // exit name
+    if (entry->name) tb_string_pool_remove(cookies->string_pool, entry->name);
+    entry->name = tb_null;
 
-    // the secure
-    tb_size_t secure = tuple[2].ul;
+    // exit value
+    if (entry->value) tb_string_pool_remove(cookies->string_pool, entry->value);
+    entry->value = tb_null;
+}
+static tb_void_t tb_cookies_entry_remove(tb_cookies_t* cookies, tb_cookies_shard_ref_t shard, tb_cookies_entry_ref_t entry)
+{
+    // unlink it from the path node
+    tb_cookies_path_ref_t   path = entry->path;
+    tb_cookies_entry_ref_t* pentry = &path->entries;
+    while (*pentry != entry) pentry = &(*pentry)->next;
+    *pentry = entry->next;
 
-    // the value of key
-    tb_string_ref_t kvalue = (tb_string_ref_t)tuple[3].ptr;
-    tb_assert(kvalue);
+    // remove it from the expires heap
+    tb_cookies_heap_remove(shard, entry);
 
-    // expired?
-    if (entry->expires && tb_cache_time() >= entry->expires)
+    // exit it
+    tb_cookies_domain_ref_t domain = entry->domain;
+    tb_cookies_entry_exit(cookies, entry);
+    tb_fixed_pool_free(shard->entry_pool, entry);
+
+    // remove the empty path nodes
+    tb_cookies_path_prune(cookies, shard, domain, path);
+}
+static tb_void_t tb_cookies_shard_expire(tb_cookies_t* cookies, tb_cookies_shard_ref_t shard, tb_time_t now)
+{
+    // evict the expired entries from the heap top, we need not scan all entries
+    while (shard->heap_size && shard->heap[0]->expires <= now)
     {
         // trace
-        tb_trace_d("expired: %s%s%s: %s = %s", entry->secure? "https://" : "http://", entry->domain, entry->path? entry->path : "", entry->name? entry->name : "", entry->value? entry->value : "");
+        tb_trace_d("expired: %s: %s = %s", shard->heap[0]->domain->domain, shard->heap[0]->name, shard->heap[0]->value? shard->heap[0]->value : "");
 
         // remove it
+        tb_cookies_entry_remove(cookies, shard, shard->heap[0]);
+    }
+}
+static tb_bool_t tb_cookies_shard_set(tb_cookies_t* cookies, tb_cookies_shard_ref_t shard, tb_cookies_item_ref_t item, tb_time_t now)
+{
+    // check
+    tb_assert_and_check_return_val(item->domain && item->path, tb_false);
+
+    // no name? ignore it
+    tb_check_return_val(item->name, tb_true);
+
+    // remove it? maxage is zero or it has been expired
+    tb_bool_t remove = (!item->maxage && !item->storage) || (item->expires && item->expires <= now);
+
+    // get domain
+    tb_cookies_domain_ref_t domain = (tb_cookies_domain_ref_t)tb_hash_map_get(shard->domains, item->domain);
+    if (!domain)
+    {
+        // no domain for removing
+        tb_check_return_val(!remove, tb_true);
+
+        // make domain
+        domain = tb_malloc0_type(tb_cookies_domain_t);
+        tb_assert_and_check_return_val(domain, tb_false);
+
+        // insert domain
+        domain->domain = tb_string_pool_insert(cookies->string_pool, item->domain);
+        if (!domain->domain || tb_hash_map_insert(shard->domains, item->domain, domain) == tb_iterator_tail(shard->domains))
+        {
+            if (domain->domain) tb_string_pool_remove(cookies->string_pool, domain->domain);
+            tb_free(domain);
+            return tb_false;
+        }
+    }
+
+    // get path
+    tb_cookies_path_ref_t path = tb_cookies_path_find(&domain->root, item->path, !remove);
+    tb_check_return_val(path || remove, tb_false);
+    tb_check_return_val(path, tb_true);
+
+    // find entry, the interned names are same if they are equal
+    tb_cookies_entry_ref_t entry = path->entries;
+    while (entry && entry->name != item->name) entry = entry->next;
+
+    // remove it?
+    if (remove)
+    {
+        if (entry) tb_cookies_entry_remove(cookies, shard, entry);
         return tb_true;
     }
 
-    // this cookies is at domain/path?
-    if (    tb_cookies_is_child_domain(entry->domain, domain)
-        &&  entry->path && entry->name
-        &&  tb_cookies_is_child_path(entry->path, path)
-        &&  entry->secure == secure)
+    // make a new entry
+    if (!entry)
     {
-        // append "key=value; "
-        tb_string_cstrfcat(kvalue, "%s=%s; ", entry->name, entry->value? entry->value : "");
+        entry = (tb_cookies_entry_ref_t)tb_fixed_pool_malloc0(shard->entry_pool);
+        if (!entry)
+        {
+            tb_cookies_path_prune(cookies, shard, domain, path);
+            return tb_false;
+        }
+
+        // init entry
+        entry->index    = (tb_size_t)-1;
+        entry->domain   = domain;
+        entry->path     = path;
+        entry->next     = path->entries;
+        path->entries   = entry;
+
+        // move name to this entry
+        entry->name     = item->name;
+        item->name      = tb_null;
     }
 
-    // continue
-    return tb_false;
+    // update value
+    if (entry->value) tb_string_pool_remove(cookies->string_pool, entry->value);
+    entry->value    = item->value;
+    item->value     = tb_null;
+    entry->maxage   = item->maxage;
+    entry->storage  = item->storage;
+    entry->secure   = item->secure;
+
+    // update expires
+    if (entry->expires != item->expires)
+    {
+        tb_cookies_heap_remove(shard, entry);
+        entry->expires = item->expires;
+        if (entry->expires && !tb_cookies_heap_push(shard, entry))
+        {
+            tb_cookies_entry_remove(cookies, shard, entry);
+            return tb_false;
+        }
+    }
+    return tb_true;
+}
+static tb_void_t tb_cookies_shard_get(tb_cookies_path_ref_t node, tb_char_t const* p, tb_size_t secure, tb_string_ref_t value)
+{
+    // get the cookies of the child path first, the cookies with more specific path mapping should be sent before others
+    if (p)
+    {
+        // the next segment
+        tb_char_t const* e = p;
+        while (*e && *e != '/') e++;
+        tb_size_t n = e - p;
+
+        // find the child node
+        tb_cookies_path_ref_t child = node->child;
+        while (child && (child->size != n || tb_memcmp(child + 1, p, n))) child = child->next;
+        if (child) tb_cookies_shard_get(child, *e? e + 1 : tb_null, secure, value);
+    }
+
+    // append "key=value; "
+    tb_cookies_entry_ref_t entry;
+    for (entry = node->entries; entry; entry = entry->next)
+    {
+        if (entry->secure == secure)
+            tb_string_cstrfcat(value, "%s=%s; ", entry->name, entry->value? entry->value : "");
+    }
+}
+static tb_void_t tb_cookies_shard_clear(tb_cookies_t* cookies, tb_cookies_shard_ref_t shard, tb_cookies_path_ref_t node)
+{
+    // exit the child nodes
+    tb_cookies_path_ref_t child = node->child;
+    while (child)
+    {
+        tb_cookies_path_ref_t next = child->next;
+        tb_cookies_shard_clear(cookies, shard, child);
+        tb_free(child);
+        child = next;
+    }
+    node->child = tb_null;
+
+    // exit the entries
+    tb_cookies_entry_ref_t entry = node->entries;
+    while (entry)
+    {
+        tb_cookies_entry_ref_t next = entry->next;
+        tb_cookies_entry_exit(cookies, entry);
+        tb_fixed_pool_free(shard->entry_pool, entry);
+        entry = next;
+    }
+    node->entries = tb_null;
+}
+static tb_bool_t tb_cookies_shard_walk(tb_cookies_path_ref_t node, tb_char_t* path, tb_size_t size, tb_size_t maxn, tb_cookies_walk_func_t func, tb_cpointer_t priv)
+{
+    // walk the entries at this path
+    tb_cookies_entry_ref_t entry;
+    for (entry = node->entries; entry; entry = entry->next)
+    {
+        if (!func(entry, path, priv)) return tb_false;
+    }
+
+    // walk the child nodes
+    tb_cookies_path_ref_t child;
+    for (child = node->child; child; child = child->next)
+    {
+        // make the child path, e.g. "/" + "style" => "/style", "/style" + "foo" => "/style/foo"
+        tb_size_t n = size;
+        if (node->parent) path[n++] = '/';
+        tb_check_continue(n + child->size < maxn);
+        tb_memcpy(path + n, child + 1, child->size);
+        path[n + child->size] = '\0';
+
+        // walk it
+        if (!tb_cookies_shard_walk(child, path, n + child->size, maxn, func, priv)) return tb_false;
+        path[size] = '\0';
+    }
+    return tb_true;
+}
+static tb_bool_t tb_cookies_walk_shard(tb_cookies_shard_ref_t shard, tb_cookies_walk_func_t func, tb_cpointer_t priv)
+{
+    // enter
+    tb_spinlock_enter(&shard->lock);
+
+    // walk all domains
+    tb_bool_t ok = tb_true;
+    tb_char_t path[TB_PATH_MAXN];
+    tb_for_all_if (tb_hash_map_item_ref_t, item, shard->domains, item && ok)
+    {
+        tb_cookies_domain_ref_t domain = (tb_cookies_domain_ref_t)item->data;
+        path[0] = '/';
+        path[1] = '\0';
+        ok = tb_cookies_shard_walk(&domain->root, path, 1, sizeof(path), func, priv);
+    }
+
+    // leave
+    tb_spinlock_leave(&shard->lock);
+    return ok;
+}
+static tb_bool_t tb_cookies_save_entry(tb_cookies_entry_ref_t entry, tb_char_t const* path, tb_cpointer_t priv)
+{
+    // check
+    tb_value_t* tuple = (tb_value_t*)priv;
+    tb_assert(tuple);
+
+    // the buffer, we only encode entries to it under the shard lock and write it to stream after leaving the lock
+    tb_buffer_ref_t buffer = (tb_buffer_ref_t)tuple[1].ptr;
+
+    // expired? skip it
+    tb_check_return_val(!entry->expires || entry->expires > tuple[0].t, tb_true);
+
+    // the string sizes
+    tb_size_t           i;
+    tb_char_t const*    cstrs[4];
+    tb_size_t           sizes[4];
+    tb_size_t           size = 14;
+    cstrs[0] = entry->domain->domain;
+    cstrs[1] = path;
+    cstrs[2] = entry->name;
+    cstrs[3] = entry->value? entry->value : "";
+    for (i = 0; i < 4; i++)
+    {
+        sizes[i] = tb_strlen(cstrs[i]);
+        tb_check_return_val(sizes[i] <= TB_MAXU16, tb_false);
+        size += 2 + sizes[i];
+    }
+
+    // grow the buffer by doubling, it may hold all entries of one shard
+    tb_size_t base = tb_buffer_size(buffer);
+    if (base + size > tb_buffer_maxn(buffer) && !tb_buffer_resize(buffer, (base + size) << 1)) return tb_false;
+
+    // append record: tag, flags, expires, maxage and strings
+    tb_byte_t* data = tb_buffer_resize(buffer, base + size);
+    tb_assert_and_check_return_val(data, tb_false);
+
+    data += base;
+    data[0] = 1;
+    data[1] = (tb_byte_t)(entry->secure | (entry->storage << 1));
+    tb_bits_set_s64_be(data + 2, (tb_sint64_t)entry->expires);
+    tb_bits_set_u32_be(data + 10, entry->maxage);
+    data += 14;
+    for (i = 0; i < 4; i++)
+    {
+        tb_bits_set_u16_be(data, (tb_uint16_t)sizes[i]);
+        tb_memcpy(data + 2, cstrs[i], sizes[i]);
+        data += 2 + sizes[i];
+    }
+    return tb_true;
+}
+static tb_char_t const* tb_cookies_load_cstr(tb_cookies_t* cookies, tb_byte_t const** pp, tb_byte_t const* e, tb_char_t* data)
+{
+    // load size
+    tb_byte_t const* p = *pp;
+    tb_check_return_val(p + 2 <= e, tb_null);
+    tb_size_t size = tb_bits_get_u16_be(p);
+    p += 2;
+
+    // load data
+    tb_check_return_val(p + size <= e, tb_null);
+    tb_memcpy(data, p, size);
+    data[size] = '\0';
+    *pp = p + size;
+
+    // intern it
+    return tb_string_pool_insert(cookies->string_pool, data);
 }
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -510,27 +943,32 @@ tb_cookies_ref_t tb_cookies_init()
         cookies = tb_malloc0_type(tb_cookies_t);
         tb_assert_and_check_break(cookies);
 
-        // init lock
-        if (!tb_spinlock_init(&cookies->lock)) break;
-
         // init string pool
         cookies->string_pool = tb_string_pool_init(tb_true);
         tb_assert_and_check_break(cookies->string_pool);
 
-        // init cookie pool
-        tb_element_t element = tb_element_mem(sizeof(tb_cookies_entry_t), tb_cookies_entry_free, cookies);
-        element.hash = tb_cookies_entry_hash;
-        element.comp = tb_cookies_entry_comp;
-        cookies->cookie_pool = tb_hash_set_init(TB_HASH_SET_BUCKET_SIZE_MICRO, element);
-        tb_assert_and_check_break(cookies->cookie_pool);
+        // init shards
+        tb_size_t i;
+        for (i = 0; i < TB_COOKIES_SHARD_MAXN; i++)
+        {
+            // init lock
+            tb_cookies_shard_ref_t shard = &cookies->shards[i];
+            if (!tb_spinlock_init(&shard->lock)) break;
+
+            // init domains
+            shard->domains = tb_hash_map_init(TB_HASH_MAP_BUCKET_SIZE_MICRO, tb_element_str(tb_true), tb_element_ptr(tb_null, tb_null));
+            tb_assert_and_check_break(shard->domains);
 
-        // init string element
-        cookies->string_element = tb_element_str(tb_true);
+            // init entry pool
+            shard->entry_pool = tb_fixed_pool_init(tb_null, TB_COOKIES_ENTRY_GROW, sizeof(tb_cookies_entry_t), tb_null, tb_null, tb_null);
+            tb_assert_and_check_break(shard->entry_pool);
 
-        // register lock profiler
-#ifdef TB_LOCK_PROFILER_ENABLE
-        tb_lock_profiler_register(tb_lock_profiler(), (tb_pointer_t)&cookies->lock, TB_TRACE_MODULE_NAME);
+            // register lock profiler
+#ifdef TB_LOCK_PROFILER_REGISTER_ENABLE
+            tb_lock_profiler_register(tb_lock_profiler(), (tb_pointer_t)&shard->lock, TB_TRACE_MODULE_NAME);
 #endif
+        }
+        tb_check_break(i == TB_COOKIES_SHARD_MAXN);
 
         // ok
         ok = tb_true;
@@ -554,23 +992,34 @@ tb_void_t tb_cookies_exit(tb_cookies_ref_t self)
     tb_cookies_t* cookies = (tb_cookies_t*)self;
     tb_assert_and_check_return(cookies);
 
-    // enter
-    tb_spinlock_enter(&cookies->lock);
+    // clear cookies
+    tb_cookies_clear(self);
+
+    // exit shards
+    tb_size_t i;
+    for (i = 0; i < TB_COOKIES_SHARD_MAXN; i++)
+    {
+        // exit domains
+        tb_cookies_shard_ref_t shard = &cookies->shards[i];
+        if (shard->domains) tb_hash_map_exit(shard->domains);
+        shard->domains = tb_null;
+
+        // exit entry pool
+        if (shard->entry_pool) tb_fixed_pool_exit(shard->entry_pool);
+        shard->entry_pool = tb_null;
 
-    // exit cookie pool
-    if (cookies->cookie_pool) tb_hash_set_exit(cookies->cookie_pool);
-    cookies->cookie_pool = tb_null;
+        // exit heap
+        if (shard->heap) tb_free(shard->heap);
+        shard->heap = tb_null;
+
+        // exit lock
+        tb_spinlock_exit(&shard->lock);
+    }
 
     // exit string pool
     if (cookies->string_pool) tb_string_pool_exit(cookies->string_pool);
     cookies->string_pool = tb_null;
 
-    // leave
-    tb_spinlock_leave(&cookies->lock);
-
-    // exit lock
-    tb_spinlock_exit(&cookies->lock);
-
     // exit it
     tb_free(cookies);
 }
@@ -580,71 +1029,57 @@ tb_void_t tb_cookies_clear(tb_cookies_ref_t self)
     tb_cookies_t* cookies = (tb_cookies_t*)self;
     tb_assert_and_check_return(cookies);
 
-    // enter
-    tb_spinlock_enter(&cookies->lock);
+    // clear shards
+    tb_size_t i;
+    for (i = 0; i < TB_COOKIES_SHARD_MAXN; i++)
+    {
+        // enter
+        tb_cookies_shard_ref_t shard = &cookies->shards[i];
+        tb_spinlock_enter(&shard->lock);
 
-    // clear cookie pool
-    if (cookies->cookie_pool) tb_hash_set_clear(cookies->cookie_pool);
+        // clear domains
+        if (shard->domains)
+        {
+            tb_for_all_if (tb_hash_map_item_ref_t, item, shard->domains, item)
+            {
+                tb_cookies_domain_ref_t domain = (tb_cookies_domain_ref_t)item->data;
+                tb_cookies_shard_clear(cookies, shard, &domain->root);
+                tb_string_pool_remove(cookies->string_pool, domain->domain);
+                tb_free(domain);
+            }
+            tb_hash_map_clear(shard->domains);
+        }
 
-    // clear string pool
-    if (cookies->string_pool) tb_string_pool_clear(cookies->string_pool);
+        // clear heap
+        shard->heap_size = 0;
 
-    // leave
-    tb_spinlock_leave(&cookies->lock);
+        // leave
+        tb_spinlock_leave(&shard->lock);
+    }
 }
 tb_bool_t tb_cookies_set(tb_cookies_ref_t self, tb_char_t const* domain, tb_char_t const* path, tb_bool_t secure, tb_char_t const* value)
 {
     // check
     tb_cookies_t* cookies = (tb_cookies_t*)self;
-    tb_assert_and_check_return_val(cookies, tb_false);
+    tb_assert_and_check_return_val(cookies && cookies->string_pool, tb_false);
 
-    // enter
-    tb_spinlock_enter(&cookies->lock);
-
-    // done
+    // init item, the string pool is thread-safe, so we need not lock it
     tb_bool_t           ok = tb_false;
-    tb_cookies_entry_t  entry = {0};
-    do
+    tb_cookies_item_t   item = {0};
+    if (tb_cookies_item_init(cookies, &item, domain, path, secure, value))
     {
-        // check
-        tb_assert_and_check_break(cookies->string_pool && cookies->cookie_pool);
-
-        // init entry
-        if (!tb_cookies_entry_init(cookies, &entry, domain, path, secure, value)) break;
-
-        // maxage is zero? remove it
-        if (!entry.maxage && !entry.storage)
-        {
-            // remove it
-            tb_hash_set_remove(cookies->cookie_pool, &entry);
-
-            // exit it
-            tb_cookies_entry_exit(cookies, &entry);
-        }
-        // set entry
-        else tb_hash_set_insert(cookies->cookie_pool, &entry);
-
-        // storage to file?
-        if (entry.storage)
-        {
-            // TODO
-            tb_trace1_w("not supports storaging cookies to file now!");
-        }
-
-        // ok
-        ok = tb_true;
-
-    } while (0);
+        // spak the cached time
+        tb_cache_time_spak();
 
-    // failed?
-    if (!ok)
-    {
-        // exit it
-        tb_cookies_entry_exit(cookies, &entry);
+        // set it to the shard of this domain
+        tb_cookies_shard_ref_t shard = tb_cookies_shard(cookies, item.domain);
+        tb_spinlock_enter(&shard->lock);
+        ok = tb_cookies_shard_set(cookies, shard, &item, tb_cache_time());
+        tb_spinlock_leave(&shard->lock);
     }
 
-    // leave
-    tb_spinlock_leave(&cookies->lock);
+    // exit item
+    tb_cookies_item_exit(cookies, &item);
 
     // ok?
     return ok;
@@ -680,43 +1115,44 @@ tb_char_t const* tb_cookies_get(tb_cookies_ref_t self, tb_char_t const* domain,
     // clear value first
     tb_string_clear(value);
 
-    // enter
-    tb_spinlock_enter(&cookies->lock);
+    // no path? using the root path
+    if (!path || !path[0]) path = "/";
 
-    // done
-    tb_bool_t ok = tb_false;
-    do
-    {
-        // check
-        tb_assert_and_check_break(cookies->string_pool && cookies->cookie_pool);
+    // skip '.'
+    if (*domain == '.') domain++;
 
-        // no path? using the root path
-        if (!path || !path[0]) path = "/";
+    // skip '/' of the root path
+    tb_char_t const* p = path;
+    if (*p == '/') p++;
 
-        // skip '.'
-        if (*domain == '.') domain++;
-
-        // spak the cached time
-        tb_cache_time_spak();
+    // spak the cached time
+    tb_cache_time_spak();
 
-        // get the matched values
-        tb_value_t tuple[4];
-        tuple[0].cstr   = domain;
-        tuple[1].cstr   = path;
-        tuple[2].ul     = secure? 1 : 0;
-        tuple[3].ptr    = value;
-        tb_remove_if(cookies->cookie_pool, tb_cookies_entry_walk, tuple);
+    // enter the shard of this domain
+    tb_cookies_shard_ref_t shard = tb_cookies_shard(cookies, domain);
+    tb_spinlock_enter(&shard->lock);
 
-        // ok
-        ok = tb_true;
+    // evict the expired entries
+    tb_cookies_shard_expire(cookies, shard, tb_cache_time());
 
-    } while (0);
+    /* get the cookies of all matched domains, e.g. "space.baidu.com" and "baidu.com" for "space.baidu.com"
+     *
+     * the matched domain need contain one dot at least
+     */
+    tb_char_t const* d = domain;
+    while (d && tb_strchr(d, '.'))
+    {
+        // get the cookies of all matched paths in this domain
+        tb_cookies_domain_ref_t node = (tb_cookies_domain_ref_t)tb_hash_map_get(shard->domains, d);
+        if (node) tb_cookies_shard_get(&node->root, *p? p : tb_null, secure? 1 : 0, value);
 
-    // failed?
-    if (!ok) tb_string_clear(value);
+        // the parent domain
+        d = tb_strchr(d, '.');
+        if (d) d++;
+    }
 
     // leave
-    tb_spinlock_leave(&cookies->lock);
+    tb_spinlock_leave(&shard->lock);
 
     // ok?
     return tb_string_size(value)? tb_string_cstr(value) : tb_null;
@@ -739,34 +1175,200 @@ tb_char_t const* tb_cookies_get_from_url(tb_cookies_ref_t self, tb_char_t const*
     // get it from domain and path
     return tb_cookies_get(self, domain, path, secure, value);
 }
-#ifdef __tb_debug__
-tb_void_t tb_cookies_dump(tb_cookies_ref_t self)
+tb_bool_t tb_cookies_save(tb_cookies_ref_t self, tb_char_t const* url)
 {
     // check
     tb_cookies_t* cookies = (tb_cookies_t*)self;
-    tb_assert_and_check_return(cookies && cookies->cookie_pool);
+    tb_assert_and_check_return_val(cookies && url, tb_false);
 
-    // enter
-    tb_spinlock_enter(&cookies->lock);
+    // done
+    tb_bool_t       ok = tb_false;
+    tb_stream_ref_t stream = tb_null;
+    tb_buffer_t     buffer;
+    tb_buffer_init(&buffer);
+    do
+    {
+        // init stream
+        stream = tb_stream_init_from_url(url);
+        tb_assert_and_check_break(stream);
 
-    // dump
-    tb_trace_i("");
-    tb_trace_i("cookie: size: %lu", tb_hash_set_size(cookies->cookie_pool));
-    tb_for_all_if (tb_cookies_entry_ref_t, entry, cookies->cookie_pool, entry)
+        // ctrl file
+        if (tb_stream_type(stream) == TB_STREAM_TYPE_FILE)
+        {
+            if (!tb_stream_ctrl(stream, TB_STREAM_CTRL_FILE_SET_MODE, TB_FILE_MODE_RW | TB_FILE_MODE_CREAT | TB_FILE_MODE_TRUNC)) break;
+        }
+
+        // open stream
+        if (!tb_stream_open(stream)) break;
+
+        // save head
+        if (!tb_stream_bwrit_u32_be(stream, TB_COOKIES_SNAPSHOT_MAGIC)) break;
+        if (!tb_stream_bwrit_u32_be(stream, TB_COOKIES_SNAPSHOT_VERSION)) break;
+
+        // spak the cached time
+        tb_cache_time_spak();
+
+        /* save all entries
+         *
+         * we snapshot the entries of each shard to the buffer under its lock,
+         * and write the buffer to stream after leaving the lock, so the slow io will not block the other threads
+         */
+        tb_size_t  i;
+        tb_value_t tuple[2];
+        tuple[0].t      = tb_cache_time();
+        tuple[1].ptr    = &buffer;
+        for (i = 0; i < TB_COOKIES_SHARD_MAXN; i++)
+        {
+            // snapshot this shard
+            if (!tb_cookies_walk_shard(&cookies->shards[i], tb_cookies_save_entry, tuple)) break;
+
+            // write it by blocks
+            if (tb_buffer_size(&buffer) >= TB_STREAM_BLOCK_MAXN)
+            {
+                if (!tb_stream_bwrit(stream, tb_buffer_data(&buffer), tb_buffer_size(&buffer))) break;
+                tb_buffer_clear(&buffer);
+            }
+        }
+        tb_check_break(i == TB_COOKIES_SHARD_MAXN);
+
+        // save end
+        if (!tb_buffer_memncat(&buffer, (tb_byte_t const*)"", 1)) break;
+        if (!tb_stream_bwrit(stream, tb_buffer_data(&buffer), tb_buffer_size(&buffer))) break;
+        if (!tb_stream_sync(stream, tb_true)) break;
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // exit stream
+    if (stream) tb_stream_exit(stream);
+
+    // exit buffer
+    tb_buffer_exit(&buffer);
+
+    // ok?
+    return ok;
+}
+tb_bool_t tb_cookies_load(tb_cookies_ref_t self, tb_char_t const* url)
+{
+    // check
+    tb_cookies_t* cookies = (tb_cookies_t*)self;
+    tb_assert_and_check_return_val(cookies && cookies->string_pool && url, tb_false);
+
+    // done
+    tb_bool_t           ok = tb_false;
+    tb_stream_ref_t     stream = tb_null;
+    tb_char_t*          cstr = tb_null;
+    tb_byte_t*          data = tb_null;
+    tb_size_t           size = 0;
+    tb_cookies_item_t   item = {0};
+    do
     {
-        // the entry
-        tb_assert_and_check_continue(entry->domain);
+        // init cstr
+        cstr = tb_malloc_cstr(TB_MAXU16 + 1);
+        tb_assert_and_check_break(cstr);
+
+        // read all data
+        stream = tb_stream_init_from_url(url);
+        tb_assert_and_check_break(stream);
+        if (!tb_stream_open(stream)) break;
+        data = tb_stream_bread_all(stream, tb_false, &size);
+        tb_check_break(data && size >= 8);
+
+        // check head
+        tb_byte_t const* p = data;
+        tb_byte_t const* e = data + size;
+        if (tb_bits_get_u32_be(p) != TB_COOKIES_SNAPSHOT_MAGIC) break;
+        if (tb_bits_get_u32_be(p + 4) != TB_COOKIES_SNAPSHOT_VERSION) break;
+        p += 8;
 
-        // the date
-        tb_tm_t date = {0};
-        tb_gmtime(entry->expires, &date);
+        // spak the cached time
+        tb_cache_time_spak();
+        tb_time_t now = tb_cache_time();
 
-        // trace
-        tb_trace_i("%s%s%s: %s = %s, expires: %04ld-%02ld-%02ld %02ld:%02ld:%02ld GMT, week: %d", entry->secure? "https://" : "http://", entry->domain, entry->path? entry->path : "", entry->name? entry->name : "", entry->value? entry->value : "", date.year, date.month, date.mday, date.hour, date.minute, date.second, date.week);
+        // load all entries
+        while (p < e)
+        {
+            // end?
+            if (!*p)
+            {
+                ok = tb_true;
+                break;
+            }
+
+            // load item
+            tb_check_break(p + 14 <= e);
+            tb_byte_t flags = p[1];
+            item.expires    = (tb_time_t)tb_bits_get_s64_be(p + 2);
+            item.maxage     = tb_bits_get_u32_be(p + 10);
+            item.secure     = flags & 1;
+            item.storage    = (flags >> 1) & 1;
+            p += 14;
+            if (!(item.domain = tb_cookies_load_cstr(cookies, &p, e, cstr))) break;
+            if (!(item.path = tb_cookies_load_cstr(cookies, &p, e, cstr))) break;
+            if (!(item.name = tb_cookies_load_cstr(cookies, &p, e, cstr))) break;
+            if (!(item.value = tb_cookies_load_cstr(cookies, &p, e, cstr))) break;
+
+            // set it to the shard of this domain
+            tb_cookies_shard_ref_t shard = tb_cookies_shard(cookies, item.domain);
+            tb_spinlock_enter(&shard->lock);
+            tb_bool_t set = tb_cookies_shard_set(cookies, shard, &item, now);
+            tb_spinlock_leave(&shard->lock);
+            tb_check_break(set);
+
+            // exit item
+            tb_cookies_item_exit(cookies, &item);
+        }
+
+    } while (0);
+
+    // exit item
+    tb_cookies_item_exit(cookies, &item);
+
+    // exit stream
+    if (stream) tb_stream_exit(stream);
+
+    // exit data
+    if (data) tb_free(data);
+
+    // exit cstr
+    if (cstr) tb_free(cstr);
+
+    // ok?
+    return ok;
+}
+#ifdef __tb_debug__
+static tb_bool_t tb_cookies_dump_entry(tb_cookies_entry_ref_t entry, tb_char_t const* path, tb_cpointer_t priv)
+{
+    // the date
+    tb_tm_t date = {0};
+    tb_gmtime(entry->expires, &date);
+
+    // trace
+    tb_trace_i("%s%s%s: %s = %s, expires: %04ld-%02ld-%02ld %02ld:%02ld:%02ld GMT, week: %d", entry->secure? "https://" : "http://", entry->domain->domain, path, entry->name, entry->value? entry->value : "", date.year, date.month, date.mday, date.hour, date.minute, date.second, date.week);
+    return tb_true;
+}
+tb_void_t tb_cookies_dump(tb_cookies_ref_t self)
+{
+    // check
+    tb_cookies_t* cookies = (tb_cookies_t*)self;
+    tb_assert_and_check_return(cookies);
+
+    // the cookies size
+    tb_size_t i;
+    tb_size_t size = 0;
+    for (i = 0; i < TB_COOKIES_SHARD_MAXN; i++)
+    {
+        tb_spinlock_enter(&cookies->shards[i].lock);
+        size += tb_fixed_pool_size(cookies->shards[i].entry_pool);
+        tb_spinlock_leave(&cookies->shards[i].lock);
     }
 
-    // leave
-    tb_spinlock_leave(&cookies->lock);
+    // dump
+    tb_trace_i("");
+    tb_trace_i("cookie: size: %lu", size);
+    for (i = 0; i < TB_COOKIES_SHARD_MAXN; i++)
+        tb_cookies_walk_shard(&cookies->shards[i], tb_cookies_dump_entry, tb_null);
 }
 #endif
-
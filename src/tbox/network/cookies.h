@@ -278,6 +278,24 @@ tb_char_t const*    tb_cookies_get_from_url(tb_cookies_ref_t cookies, tb_char_t
  */
 tb_void_t           tb_cookies_clear(tb_cookies_ref_t cookies);
 
+/*! save the binary snapshot of all unexpired cookies to the given url
+ *
+ * @param cookies   the cookies
+ * @param url       the output url, e.g. file:///tmp/cookies.dat
+ *
+ * @return          tb_true or tb_false
+ */
+tb_bool_t           tb_cookies_save(tb_cookies_ref_t cookies, tb_char_t const* url);
+
+/*! load the binary snapshot saved by tb_cookies_save() and merge it to cookies
+ *
+ * @param cookies   the cookies
+ * @param url       the input url
+ *
+ * @return          tb_true or tb_false
+ */
+tb_bool_t           tb_cookies_load(tb_cookies_ref_t cookies, tb_char_t const* url);
+
 #ifdef __tb_debug__
 /*! dump cookies
  *
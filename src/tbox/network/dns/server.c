@@ -70,6 +70,17 @@ typedef struct __tb_dns_server_list_t
 
 }tb_dns_server_list_t;
 
+// the best dns servers type, it's the immutable snapshot for the lock-free readers
+typedef struct __tb_dns_server_best_t
+{
+    // the server count
+    tb_size_t               size;
+
+    // the server addresses
+    tb_ipaddr_t             addr[2];
+
+}tb_dns_server_best_t;
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * globals
  */
@@ -80,9 +91,34 @@ static tb_spinlock_t        g_lock = TB_SPINLOCK_INIT;
 // the server list
 static tb_dns_server_list_t g_list = {0};
 
+// the best servers of the sorted server list
+static tb_rcu_pointer_t     g_best = TB_RCU_POINTER_INIT;
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * server
  */
+static tb_void_t tb_dns_server_best_free(tb_pointer_t data)
+{
+    if (data) tb_free(data);
+}
+static tb_void_t tb_dns_server_best_update()
+{
+    // make the best servers from the current server list
+    tb_dns_server_best_t* best = tb_null;
+    tb_size_t n = g_list.list? tb_min(tb_vector_size(g_list.list), 2) : 0;
+    if (n && (best = tb_malloc0_type(tb_dns_server_best_t)))
+    {
+        tb_size_t i = 0;
+        for (; i < n; i++)
+        {
+            tb_dns_server_t const* server = (tb_dns_server_t const*)tb_iterator_item(g_list.list, i);
+            if (server) best->addr[best->size++] = server->addr;
+        }
+    }
+
+    // publish it, the old servers will be freed after all readers have left
+    tb_rcu_pointer_set(&g_best, best);
+}
 static tb_long_t tb_dns_server_comp(tb_element_ref_t element, tb_cpointer_t litem, tb_cpointer_t ritem)
 {
     // check
@@ -339,6 +375,7 @@ tb_bool_t tb_dns_server_init()
         {
             g_list.list = tb_vector_init(8, tb_element_mem(sizeof(tb_dns_server_t), tb_null, tb_null));
             g_list.sort = tb_false;
+            tb_rcu_pointer_init(&g_best, tb_null, tb_dns_server_best_free);
         }
         tb_assert_and_check_break(g_list.list);
 
@@ -361,8 +398,8 @@ tb_void_t tb_dns_server_exit()
     // enter
     tb_spinlock_enter(&g_lock);
 
-    // exit list
-    if (g_list.list) tb_vector_exit(g_list.list);
+    // detach list
+    tb_vector_ref_t list = g_list.list;
     g_list.list = tb_null;
 
     // exit sort
@@ -370,6 +407,18 @@ tb_void_t tb_dns_server_exit()
 
     // leave
     tb_spinlock_leave(&g_lock);
+
+    // exit list
+    if (list) tb_vector_exit(list);
+
+    /* retire the best servers and wait for all readers to leave,
+     * we cannot synchronize it under the lock, because it may wait for a long time
+     */
+    tb_rcu_pointer_set(&g_best, tb_null);
+    tb_rcu_synchronize();
+
+    // exit the best servers
+    tb_rcu_pointer_exit(&g_best);
 }
 tb_void_t tb_dns_server_dump()
 {
@@ -431,6 +480,7 @@ tb_void_t tb_dns_server_sort()
     /* sort ok, only done once sort
      * using the unsorted server list at the other thread if the sort have been not finished
      */
+    if (!g_list.sort && g_list.list) tb_dns_server_best_update();
     g_list.sort = tb_true;
 
     // leave
@@ -448,8 +498,15 @@ tb_void_t tb_dns_server_sort()
     // enter
     tb_spinlock_enter(&g_lock);
 
-    // save the sorted server list
-    if (tb_vector_size(list)) tb_vector_copy(g_list.list, list);
+    // save the sorted server list if it has been not changed or exited by the other thread
+    if (tb_vector_size(list))
+    {
+        if (g_list.list && g_list.sort)
+        {
+            tb_vector_copy(g_list.list, list);
+            tb_dns_server_best_update();
+        }
+    }
     else
     {
         // no faster server? using the previous server list
@@ -467,6 +524,20 @@ tb_size_t tb_dns_server_get(tb_ipaddr_t addr[2])
     // check
     tb_assert_and_check_return_val(addr, 0);
 
+    // get the best servers without lock if the server list has been sorted
+    tb_size_t ok = 0;
+    if (tb_rcu_read_enter())
+    {
+        tb_dns_server_best_t const* best = (tb_dns_server_best_t const*)tb_rcu_pointer_get(&g_best);
+        if (best)
+        {
+            for (; ok < best->size; ok++)
+                addr[ok] = best->addr[ok];
+        }
+        tb_rcu_read_leave();
+    }
+    tb_check_return_val(!ok, ok);
+
     // sort first
     tb_dns_server_sort();
 
@@ -474,7 +545,6 @@ tb_size_t tb_dns_server_get(tb_ipaddr_t addr[2])
     tb_spinlock_enter(&g_lock);
 
     // done
-    tb_size_t ok = 0;
     do
     {
         // check
@@ -535,6 +605,12 @@ tb_void_t tb_dns_server_add(tb_char_t const* addr)
         // need sort it again
         g_list.sort = tb_false;
 
+        /* clear the best servers with the sort flag under the lock, the readers will sort the servers again
+         *
+         * @note it only retires the old servers and does not wait for the readers
+         */
+        tb_rcu_pointer_set(&g_best, tb_null);
+
     } while (0);
 
     // leave
@@ -34,6 +34,7 @@
 #include "impl/http/option.h"
 #include "impl/http/status.h"
 #include "impl/http/method.h"
+#include "impl/http/header.h"
 #include "../zip/zip.h"
 #include "../libc/libc.h"
 #include "../math/math.h"
@@ -69,14 +70,17 @@ typedef struct __tb_http_t
     // the zstream for gzip/deflate
     tb_stream_ref_t     zstream;
 
-    // the head
-    tb_hash_map_ref_t   head;
+    // the request head
+    tb_http_header_t    head;
+
+    // the response head
+    tb_http_header_t    rhead;
 
     // is opened?
     tb_bool_t           bopened;
 
     // the request data
-    tb_string_t         request;
+    tb_buffer_t         request;
 
     // the cookies
     tb_string_t         cookies;
@@ -171,12 +175,8 @@ static tb_bool_t tb_http_request(tb_http_t* http)
     tb_hong_t           post_size = 0;
     do
     {
-        // clear line data
-        tb_string_clear(&http->request);
-
-        // init the head value
-        tb_static_string_t value;
-        if (!tb_static_string_init(&value, http->data, sizeof(http->data))) break;
+        // clear head, the pre-sized arena will be reused
+        tb_http_header_clear(&http->head);
 
         // init method
         tb_char_t const* method = tb_http_method_cstr(http->option.method);
@@ -192,36 +192,37 @@ static tb_bool_t tb_http_request(tb_http_t* http)
         // init host
         tb_char_t const* host = tb_url_host(&http->option.url);
         tb_assert_and_check_break(host);
-        tb_hash_map_insert(http->head, "Host", host);
+        if (!tb_http_header_set_id(&http->head, TB_HTTP_HEADER_HOST, host, tb_strlen(host))) break;
 
         // init accept
-        tb_hash_map_insert(http->head, "Accept", "*/*");
+        if (!tb_http_header_set_id(&http->head, TB_HTTP_HEADER_ACCEPT, "*/*", 3)) break;
 
         // init connection
-        tb_hash_map_insert(http->head, "Connection", http->status.balived? "keep-alive" : "close");
+        if (http->status.balived)
+        {
+            if (!tb_http_header_set_id(&http->head, TB_HTTP_HEADER_CONNECTION, "keep-alive", 10)) break;
+        }
+        else if (!tb_http_header_set_id(&http->head, TB_HTTP_HEADER_CONNECTION, "close", 5)) break;
 
         // init cookies
-        tb_bool_t cookie = tb_false;
         if (http->option.cookies)
         {
             // set cookie
             if (tb_cookies_get(http->option.cookies, host, path, tb_url_ssl(&http->option.url), &http->cookies))
             {
-                tb_hash_map_insert(http->head, "Cookie", tb_string_cstr(&http->cookies));
-                cookie = tb_true;
+                if (!tb_http_header_set_id(&http->head, TB_HTTP_HEADER_COOKIE, tb_string_cstr(&http->cookies), tb_string_size(&http->cookies))) break;
             }
         }
 
-        // no cookie? remove it
-        if (!cookie) tb_hash_map_remove(http->head, "Cookie");
-
         // init range
+        tb_char_t value[64];
+        tb_long_t value_size = 0;
         if (http->option.range.bof && http->option.range.eof >= http->option.range.bof)
-            tb_static_string_cstrfcpy(&value, "bytes=%llu-%llu", http->option.range.bof, http->option.range.eof);
+            value_size = tb_snprintf(value, sizeof(value), "bytes=%llu-%llu", http->option.range.bof, http->option.range.eof);
         else if (http->option.range.bof && !http->option.range.eof)
-            tb_static_string_cstrfcpy(&value, "bytes=%llu-", http->option.range.bof);
+            value_size = tb_snprintf(value, sizeof(value), "bytes=%llu-", http->option.range.bof);
         else if (!http->option.range.bof && http->option.range.eof)
-            tb_static_string_cstrfcpy(&value, "bytes=0-%llu", http->option.range.eof);
+            value_size = tb_snprintf(value, sizeof(value), "bytes=0-%llu", http->option.range.eof);
         else if (http->option.range.bof > http->option.range.eof)
         {
             http->status.state = TB_STATE_HTTP_RANGE_INVALID;
@@ -229,10 +230,7 @@ static tb_bool_t tb_http_request(tb_http_t* http)
         }
 
         // update range
-        if (tb_static_string_size(&value))
-            tb_hash_map_insert(http->head, "Range", tb_static_string_cstr(&value));
-        // remove range
-        else tb_hash_map_remove(http->head, "Range");
+        if (value_size > 0 && !tb_http_header_set_id(&http->head, TB_HTTP_HEADER_RANGE, value, value_size)) break;
 
         // init post
         if (http->option.method == TB_HTTP_METHOD_POST)
@@ -256,8 +254,8 @@ static tb_bool_t tb_http_request(tb_http_t* http)
                 tb_assert_and_check_break(post_size >= 0);
 
                 // append post size
-                tb_static_string_cstrfcpy(&value, "%lld", post_size);
-                tb_hash_map_insert(http->head, "Content-Length", tb_static_string_cstr(&value));
+                value_size = tb_snprintf(value, sizeof(value), "%lld", post_size);
+                if (!tb_http_header_set_id(&http->head, TB_HTTP_HEADER_CONTENT_LENGTH, value, value_size)) break;
 
                 // ok
                 post_ok = tb_true;
@@ -271,8 +269,6 @@ static tb_bool_t tb_http_request(tb_http_t* http)
                 break;
             }
         }
-        // remove post
-        else tb_hash_map_remove(http->head, "Content-Length");
 
         // replace the custom head
         tb_char_t const* head_data = (tb_char_t const*)tb_buffer_data(&http->option.head_data);
@@ -280,70 +276,72 @@ static tb_bool_t tb_http_request(tb_http_t* http)
         while (head_data < head_tail)
         {
             // the name and data
-            tb_char_t const* name = head_data;
-            tb_char_t const* data = head_data + tb_strlen(name) + 1;
+            tb_char_t const*    name = head_data;
+            tb_size_t           name_size = tb_strlen(name);
+            tb_char_t const*    data = head_data + name_size + 1;
             tb_check_break(data < head_tail);
 
             // replace it
-            tb_hash_map_insert(http->head, name, data);
+            tb_size_t data_size = tb_strlen(data);
+            if (name_size && !tb_http_header_set(&http->head, name, name_size, data, data_size)) break;
 
             // next
-            head_data = data + tb_strlen(data) + 1;
+            head_data = data + data_size + 1;
         }
 
-        // exit the head value
-        tb_static_string_exit(&value);
-
-        // check head
-        tb_assert_and_check_break(tb_hash_map_size(http->head));
-
-        // append method
-        tb_string_cstrcat(&http->request, method);
-
-        // append ' '
-        tb_string_chrcat(&http->request, ' ');
-
         // encode path
-        tb_url_encode2(path, tb_strlen(path), http->data, sizeof(http->data) - 1);
+        tb_size_t path_size = tb_url_encode2(path, tb_strlen(path), http->data, sizeof(http->data) - 1);
         path = http->data;
 
-        // append path
-        tb_string_cstrcat(&http->request, path);
-
-        // append args if exists
+        // encode args if exists
+        tb_size_t args_size = 0;
         if (args)
         {
-            // append '?'
-            tb_string_chrcat(&http->request, '?');
+            args_size = tb_url_encode2(args, tb_strlen(args), http->data + path_size + 1, sizeof(http->data) - path_size - 2);
+            args = http->data + path_size + 1;
+        }
 
-            // encode args
-            tb_url_encode2(args, tb_strlen(args), http->data, sizeof(http->data) - 1);
-            args = http->data;
+        /* compute the request size
+         *
+         * "$method $path?$args HTTP/1.x\r\n"
+         * "$name: $value\r\n" ...
+         * "\r\n"
+         */
+        tb_size_t method_size   = tb_strlen(method);
+        tb_size_t head_size     = tb_http_header_size(&http->head);
+        tb_size_t request_size  = method_size + 1 + path_size + (args? args_size + 1 : 0) + 11 + head_size + 2;
+
+        // make the request data, the buffer will be reused for the next request
+        tb_char_t* request_data = (tb_char_t*)tb_buffer_resize(&http->request, request_size + 1);
+        tb_assert_and_check_break(request_data);
+
+        // append method and path
+        tb_char_t* p = request_data;
+        tb_memcpy(p, method, method_size); p += method_size;
+        *p++ = ' ';
+        tb_memcpy(p, path, path_size); p += path_size;
 
-            // append args
-            tb_string_cstrcat(&http->request, args);
+        // append args if exists
+        if (args)
+        {
+            *p++ = '?';
+            tb_memcpy(p, args, args_size); p += args_size;
         }
 
-        // append ' '
-        tb_string_chrcat(&http->request, ' ');
-
         // append version, HTTP/1.1
-        tb_string_cstrfcat(&http->request, "HTTP/1.%1u\r\n", http->status.balived? http->status.version : http->option.version);
+        tb_memcpy(p, " HTTP/1.", 8); p += 8;
+        *p++ = (tb_char_t)('0' + ((http->status.balived? http->status.version : http->option.version) & 1));
+        *p++ = '\r';
+        *p++ = '\n';
 
         // append key: value
-        tb_for_all (tb_hash_map_item_ref_t, item, http->head)
-        {
-            if (item && item->name && item->data)
-                tb_string_cstrfcat(&http->request, "%s: %s\r\n", (tb_char_t const*)item->name, (tb_char_t const*)item->data);
-        }
+        p += tb_http_header_copy(&http->head, p);
 
         // append end
-        tb_string_cstrcat(&http->request, "\r\n");
-
-        // the request data and size
-        tb_char_t const*    request_data = tb_string_cstr(&http->request);
-        tb_size_t           request_size = tb_string_size(&http->request);
-        tb_assert_and_check_break(request_data && request_size);
+        *p++ = '\r';
+        *p++ = '\n';
+        *p = '\0';
+        tb_assert_and_check_break(p == request_data + request_size);
 
         // trace
         tb_trace_d("request[%lu]:\n%s", request_size, request_data);
@@ -380,6 +378,73 @@ static tb_bool_t tb_http_request(tb_http_t* http)
     // ok?
     return ok;
 }
+static tb_char_t* tb_http_response_line(tb_http_t* http, tb_size_t* size)
+{
+    // check
+    tb_assert_and_check_return_val(http && http->stream && size, tb_null);
+
+    // read line to the arena of the response head
+    tb_bool_t   ok = tb_false;
+    tb_bool_t   eof = tb_false;
+    tb_size_t   read = 0;
+    tb_byte_t*  data = tb_null;
+    while (1)
+    {
+        // peek data
+        tb_long_t real = tb_stream_peek(http->stream, &data, TB_STREAM_BLOCK_MAXN);
+        if (real > 0)
+        {
+            // scan the line end
+            tb_size_t n = tb_http_header_scan((tb_char_t const*)data, real);
+            tb_bool_t end = n < real;
+            if (end) n++;
+
+            // append it to the current line
+            if (!tb_http_header_line_cat(&http->rhead, (tb_char_t const*)data, n)) break;
+            if (!tb_stream_skip(http->stream, n)) break;
+            read += n;
+
+            // end?
+            if (end)
+            {
+                ok = tb_true;
+                break;
+            }
+
+            // the line is too long? it is a bad response
+            if (read >= sizeof(http->data))
+            {
+                // trace
+                tb_trace_e("response: the line is too long, size: %lu", read);
+
+                // save state
+                http->status.state = TB_STATE_HTTP_RESPONSE_UNK;
+                break;
+            }
+        }
+        else if (!real)
+        {
+            // wait it
+            real = tb_stream_wait(http->stream, TB_STREAM_WAIT_READ, tb_stream_timeout(http->stream));
+            if (real <= 0)
+            {
+                eof = tb_true;
+                break;
+            }
+        }
+        else
+        {
+            eof = tb_true;
+            break;
+        }
+    }
+
+    // the last line without '\n'?
+    if (eof && read) ok = tb_true;
+
+    // done line
+    return ok? tb_http_header_line_done(&http->rhead, size) : tb_null;
+}
 /*
  * HTTP/1.1 206 Partial Content
  * Date: Fri, 23 Apr 2010 05:25:45 GMT
@@ -392,7 +457,7 @@ static tb_bool_t tb_http_request(tb_http_t* http)
  * Connection: close
  * Content-Type: application/x-shockwave-flash
  */
-static tb_bool_t tb_http_response_done(tb_http_t* http, tb_char_t const* line, tb_size_t indx)
+static tb_bool_t tb_http_response_done(tb_http_t* http, tb_char_t* line, tb_size_t size, tb_size_t indx)
 {
     // check
     tb_assert_and_check_return_val(http && http->sstream && line, tb_false);
@@ -443,105 +508,120 @@ static tb_bool_t tb_http_response_done(tb_http_t* http, tb_char_t const* line, t
     // key: value?
     else
     {
-        // seek to value
-        while (*p && *p != ':') p++;
-        tb_assert_and_check_return_val(*p, tb_false);
-        p++; while (*p && tb_isspace(*p)) p++;
+        // load the key and value to the response head
+        tb_size_t id = tb_http_header_line_load(&http->rhead, line, size, &p);
+        tb_assert_and_check_return_val(id != TB_HTTP_HEADER_MAXN, tb_false);
 
         // no value
         tb_check_return_val(*p, tb_true);
 
-        // parse content size
-        if (!tb_strnicmp(line, "Content-Length", 14))
+        // parse the well-known header
+        switch (id)
         {
-            http->status.content_size = tb_stou64(p);
-            if (http->status.document_size < 0)
-                http->status.document_size = http->status.content_size;
-        }
-        // parse content range: "bytes $from-$to/$document_size"
-        else if (!tb_strnicmp(line, "Content-Range", 13))
-        {
-            tb_hize_t from = 0;
-            tb_hize_t to = 0;
-            tb_hize_t document_size = 0;
-            if (!tb_strncmp(p, "bytes ", 6))
+        // parse content size
+        case TB_HTTP_HEADER_CONTENT_LENGTH:
             {
-                p += 6;
-                from = tb_stou64(p);
-                while (*p && *p != '-') p++;
-                if (*p && *p++ == '-') to = tb_stou64(p);
-                while (*p && *p != '/') p++;
-                if (*p && *p++ == '/') document_size = tb_stou64(p);
+                http->status.content_size = tb_stou64(p);
+                if (http->status.document_size < 0)
+                    http->status.document_size = http->status.content_size;
             }
-            // no stream, be able to seek
-            http->status.bseeked = 1;
-            http->status.document_size = document_size;
-            if (http->status.content_size < 0)
+            break;
+        // parse content range: "bytes $from-$to/$document_size"
+        case TB_HTTP_HEADER_CONTENT_RANGE:
             {
-                if (from && to > from) http->status.content_size = to - from;
-                else if (!from && to) http->status.content_size = to;
-                else if (from && !to && document_size > from) http->status.content_size = document_size - from;
-                else http->status.content_size = document_size;
+                tb_hize_t from = 0;
+                tb_hize_t to = 0;
+                tb_hize_t document_size = 0;
+                if (!tb_strncmp(p, "bytes ", 6))
+                {
+                    p += 6;
+                    from = tb_stou64(p);
+                    while (*p && *p != '-') p++;
+                    if (*p && *p++ == '-') to = tb_stou64(p);
+                    while (*p && *p != '/') p++;
+                    if (*p && *p++ == '/') document_size = tb_stou64(p);
+                }
+                // no stream, be able to seek
+                http->status.bseeked = 1;
+                http->status.document_size = document_size;
+                if (http->status.content_size < 0)
+                {
+                    if (from && to > from) http->status.content_size = to - from;
+                    else if (!from && to) http->status.content_size = to;
+                    else if (from && !to && document_size > from) http->status.content_size = document_size - from;
+                    else http->status.content_size = document_size;
+                }
             }
-        }
+            break;
         // parse accept-ranges: "bytes "
-        else if (!tb_strnicmp(line, "Accept-Ranges", 13))
-        {
-            // no stream, be able to seek
-            http->status.bseeked = 1;
-        }
+        case TB_HTTP_HEADER_ACCEPT_RANGES:
+            {
+                // no stream, be able to seek
+                http->status.bseeked = 1;
+            }
+            break;
         // parse content type
-        else if (!tb_strnicmp(line, "Content-Type", 12))
-        {
-            tb_string_cstrcpy(&http->status.content_type, p);
-            tb_assert_and_check_return_val(tb_string_size(&http->status.content_type), tb_false);
-        }
+        case TB_HTTP_HEADER_CONTENT_TYPE:
+            {
+                tb_string_cstrcpy(&http->status.content_type, p);
+                tb_assert_and_check_return_val(tb_string_size(&http->status.content_type), tb_false);
+            }
+            break;
         // parse transfer encoding
-        else if (!tb_strnicmp(line, "Transfer-Encoding", 17))
-        {
-            if (!tb_stricmp(p, "chunked")) http->status.bchunked = 1;
-        }
+        case TB_HTTP_HEADER_TRANSFER_ENCODING:
+            {
+                if (!tb_stricmp(p, "chunked")) http->status.bchunked = 1;
+            }
+            break;
         // parse content encoding
-        else if (!tb_strnicmp(line, "Content-Encoding", 16))
-        {
-            if (!tb_stricmp(p, "gzip")) http->status.bgzip = 1;
-            else if (!tb_stricmp(p, "deflate")) http->status.bdeflate = 1;
-        }
+        case TB_HTTP_HEADER_CONTENT_ENCODING:
+            {
+                if (!tb_stricmp(p, "gzip")) http->status.bgzip = 1;
+                else if (!tb_stricmp(p, "deflate")) http->status.bdeflate = 1;
+            }
+            break;
         // parse location
-        else if (!tb_strnicmp(line, "Location", 8))
-        {
-            // redirect? check code: 301 - 307
-            tb_assert_and_check_return_val(http->status.code > 300 && http->status.code < 308, tb_false);
+        case TB_HTTP_HEADER_LOCATION:
+            {
+                // redirect? check code: 301 - 307
+                tb_assert_and_check_return_val(http->status.code > 300 && http->status.code < 308, tb_false);
 
-            // save location
-            tb_string_cstrcpy(&http->status.location, p);
-        }
+                // save location
+                tb_string_cstrcpy(&http->status.location, p);
+            }
+            break;
         // parse connection
-        else if (!tb_strnicmp(line, "Connection", 10))
-        {
-            // keep alive?
-            http->status.balived = !tb_stricmp(p, "close")? 0 : 1;
+        case TB_HTTP_HEADER_CONNECTION:
+            {
+                // keep alive?
+                http->status.balived = !tb_stricmp(p, "close")? 0 : 1;
 
-            // ctrl stream for sock
-            if (!tb_stream_ctrl(http->sstream, TB_STREAM_CTRL_SOCK_KEEP_ALIVE, http->status.balived? tb_true : tb_false)) return tb_false;
-        }
+                // ctrl stream for sock
+                if (!tb_stream_ctrl(http->sstream, TB_STREAM_CTRL_SOCK_KEEP_ALIVE, http->status.balived? tb_true : tb_false)) return tb_false;
+            }
+            break;
         // parse cookies
-        else if (http->option.cookies && !tb_strnicmp(line, "Set-Cookie", 10))
-        {
-            // the host
-            tb_char_t const* host = tb_null;
-            tb_http_ctrl((tb_http_ref_t)http, TB_HTTP_OPTION_GET_HOST, &host);
+        case TB_HTTP_HEADER_SET_COOKIE:
+            if (http->option.cookies)
+            {
+                // the host
+                tb_char_t const* host = tb_null;
+                tb_http_ctrl((tb_http_ref_t)http, TB_HTTP_OPTION_GET_HOST, &host);
 
-            // the path
-            tb_char_t const* path = tb_null;
-            tb_http_ctrl((tb_http_ref_t)http, TB_HTTP_OPTION_GET_PATH, &path);
+                // the path
+                tb_char_t const* path = tb_null;
+                tb_http_ctrl((tb_http_ref_t)http, TB_HTTP_OPTION_GET_PATH, &path);
 
-            // is ssl?
-            tb_bool_t bssl = tb_false;
-            tb_http_ctrl((tb_http_ref_t)http, TB_HTTP_OPTION_GET_SSL, &bssl);
+                // is ssl?
+                tb_bool_t bssl = tb_false;
+                tb_http_ctrl((tb_http_ref_t)http, TB_HTTP_OPTION_GET_SSL, &bssl);
 
-            // set cookies
-            tb_cookies_set(http->option.cookies, host, path, bssl, p);
+                // set cookies
+                tb_cookies_set(http->option.cookies, host, path, bssl, p);
+            }
+            break;
+        default:
+            break;
         }
     }
 
@@ -557,19 +637,23 @@ static tb_bool_t tb_http_response(tb_http_t* http)
     tb_bool_t ok = tb_false;
     do
     {
+        // clear the response head, the pre-sized arena will be reused
+        tb_http_header_clear(&http->rhead);
+
         // read line
-        tb_long_t real = 0;
-        tb_size_t indx = 0;
-        while ((real = tb_stream_bread_line(http->stream, http->data, sizeof(http->data) - 1)) >= 0)
+        tb_char_t*  line = tb_null;
+        tb_size_t   size = 0;
+        tb_size_t   indx = 0;
+        while ((line = tb_http_response_line(http, &size)))
         {
             // trace
-            tb_trace_d("response: %s", http->data);
+            tb_trace_d("response: %s", line);
 
             // do callback
-            if (http->option.head_func && !http->option.head_func(http->data, http->option.head_priv)) break;
+            if (http->option.head_func && !http->option.head_func(line, http->option.head_priv)) break;
 
             // end?
-            if (!real)
+            if (!size)
             {
                 // switch to cstream if chunked
                 if (http->status.bchunked)
@@ -647,7 +731,7 @@ static tb_bool_t tb_http_response(tb_http_t* http)
             }
 
             // done it
-            if (!tb_http_response_done(http, http->data, indx++)) break;
+            if (!tb_http_response_done(http, line, size, indx++)) break;
         }
 
     } while (0);
@@ -748,12 +832,14 @@ tb_http_ref_t tb_http_init()
         http->stream = http->sstream = tb_stream_init_sock();
         tb_assert_and_check_break(http->stream);
 
-        // init head
-        http->head = tb_hash_map_init(8, tb_element_str(tb_false), tb_element_str(tb_false));
-        tb_assert_and_check_break(http->head);
+        // init request head
+        if (!tb_http_header_init(&http->head)) break;
+
+        // init response head
+        if (!tb_http_header_init(&http->rhead)) break;
 
         // init request data
-        if (!tb_string_init(&http->request)) break;
+        if (!tb_buffer_init(&http->request)) break;
 
         // init cookies data
         if (!tb_string_init(&http->cookies)) break;
@@ -822,11 +908,13 @@ tb_void_t tb_http_exit(tb_http_ref_t self)
     tb_string_exit(&http->cookies);
 
     // exit request data
-    tb_string_exit(&http->request);
+    tb_buffer_exit(&http->request);
+
+    // exit response head
+    tb_http_header_exit(&http->rhead);
 
-    // exit head
-    if (http->head) tb_hash_map_exit(http->head);
-    http->head = tb_null;
+    // exit request head
+    tb_http_header_exit(&http->head);
 
     // free it
     tb_free(http);
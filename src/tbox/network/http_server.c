@@ -0,0 +1,1501 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        http_server.c
+ * @ingroup     network
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "http_server"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "http_server.h"
+#include "impl/http/header.h"
+#include "impl/http/method.h"
+#include "../libc/libc.h"
+#include "../utils/utils.h"
+#include "../stream/stream.h"
+#include "../platform/platform.h"
+#include "../container/container.h"
+#include "../coroutine/coroutine.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * the implementation for coroutine
+ */
+#ifdef TB_CONFIG_MODULE_HAVE_COROUTINE
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the coroutine stack size of the connection
+#ifdef __tb_small__
+#   define TB_HTTP_SERVER_STACKSIZE         (8192 << 2)
+#else
+#   define TB_HTTP_SERVER_STACKSIZE         (8192 << 3)
+#endif
+
+// the idle timeout of the keep-alive connection, 30s
+#define TB_HTTP_SERVER_TIMEOUT              (30000)
+
+// the request head maxn
+#define TB_HTTP_SERVER_HEAD_MAXN            (65536)
+
+// the grow size of the receive buffer
+#define TB_HTTP_SERVER_DATA_GROW            (8192)
+
+// the maxn of the merged response data before sending it
+#define TB_HTTP_SERVER_CORK_MAXN            (65536)
+
+// the maxn of the cached files of each worker
+#ifdef __tb_small__
+#   define TB_HTTP_SERVER_FILE_MAXN         (64)
+#else
+#   define TB_HTTP_SERVER_FILE_MAXN         (256)
+#endif
+
+// the interval (ms) for checking the cached file info
+#define TB_HTTP_SERVER_FILE_CHECK           (1000)
+
+// add the worker stat
+#define tb_http_server_stat_add(worker, name, n) \
+    tb_atomic64_fetch_and_add_explicit(&(worker)->stat_##name, (tb_int64_t)(n), TB_ATOMIC_RELAXED)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the response state enum
+typedef enum __tb_http_server_response_e
+{
+    TB_HTTP_SERVER_RESPONSE_NONE    = 0     //!< no response
+,   TB_HTTP_SERVER_RESPONSE_SENT    = 1     //!< the response has been sent
+,   TB_HTTP_SERVER_RESPONSE_CHUNKED = 2     //!< the chunked response is being written
+
+}tb_http_server_response_e;
+
+// the http server route type
+typedef struct __tb_http_server_route_t
+{
+    // the path prefix
+    tb_char_t*                      prefix;
+
+    // the prefix size
+    tb_size_t                       prefix_size;
+
+    // the handler
+    tb_http_server_func_t           func;
+
+    // the user private data
+    tb_cpointer_t                   priv;
+
+    // the root directory for the static files
+    tb_char_t*                      rootdir;
+
+}tb_http_server_route_t;
+
+// the cached file type
+typedef struct __tb_http_server_file_t
+{
+    // the lru entry
+    tb_list_entry_t                 entry;
+
+    // the path
+    tb_char_t*                      path;
+
+    // the file
+    tb_file_ref_t                   file;
+
+    // the file size
+    tb_hize_t                       size;
+
+    // the last modified time
+    tb_time_t                       mtime;
+
+    // the last checked time
+    tb_hong_t                       checked;
+
+    // the reference count of the sending sessions
+    tb_size_t                       refn;
+
+    // it has been removed from the cache?
+    tb_bool_t                       bdead;
+
+}tb_http_server_file_t;
+
+// the http server worker type
+typedef struct __tb_http_server_worker_t
+{
+    // the server
+    struct __tb_http_server_t*      server;
+
+    // the thread
+    tb_thread_ref_t                 thread;
+
+    // the scheduler
+    tb_co_scheduler_ref_t           scheduler;
+
+    // the listener
+    tb_socket_ref_t                 sock;
+
+    // the listener is shared from the first worker?
+    tb_bool_t                       bshared;
+
+    // the alive sessions, only be accessed in the worker thread
+    tb_list_entry_head_t            sessions;
+
+    // the cached files, path => file
+    tb_hash_map_ref_t               files;
+
+    // the lru list of the cached files
+    tb_list_entry_head_t            files_lru;
+
+    // the stat
+    tb_atomic64_t                   stat_connections;
+    tb_atomic64_t                   stat_requests;
+    tb_atomic64_t                   stat_pipelined;
+    tb_atomic64_t                   stat_files;
+    tb_atomic64_t                   stat_file_hits;
+    tb_atomic64_t                   stat_file_misses;
+    tb_atomic64_t                   stat_send_size;
+
+}tb_http_server_worker_t;
+
+// the http server type
+typedef struct __tb_http_server_t
+{
+    // the bound address
+    tb_ipaddr_t                     addr;
+
+    // the workers
+    tb_http_server_worker_t*        workers;
+
+    // the worker count
+    tb_size_t                       workers_count;
+
+    // the routes, sorted by the prefix size
+    tb_http_server_route_t*         routes;
+
+    // the route count
+    tb_size_t                       routes_size;
+
+    // is started?
+    tb_bool_t                       bstarted;
+
+    // is stopped?
+    tb_atomic32_t                   stopped;
+
+}tb_http_server_t;
+
+// the http server session type
+typedef struct __tb_http_server_session_t
+{
+    // the list entry of the worker sessions
+    tb_list_entry_t                 entry;
+
+    // the worker
+    tb_http_server_worker_t*        worker;
+
+    // the socket
+    tb_socket_ref_t                 sock;
+
+    // the request method, -1 if it is not supported
+    tb_size_t                       method;
+
+    // the path offset in the head arena
+    tb_size_t                       path;
+
+    // the args offset in the head arena, 0 if no args
+    tb_size_t                       args;
+
+    // the request content size
+    tb_hize_t                       content_size;
+
+    // the read content size
+    tb_hize_t                       content_read;
+
+    // keep alive?
+    tb_bool_t                       keep_alive;
+
+    // expect 100-continue?
+    tb_bool_t                       bexpect;
+
+    // is bad request?
+    tb_size_t                       bad_code;
+
+    // the response state
+    tb_size_t                       response;
+
+    // the request head
+    tb_http_header_t                head;
+
+    // the response head
+    tb_http_header_t                rhead;
+
+    // the chunked filter for encoding
+    tb_filter_ref_t                 chunked;
+
+    // the receive data
+    tb_byte_t*                      idata;
+
+    // the receive data size
+    tb_size_t                       isize;
+
+    // the receive data maxn
+    tb_size_t                       imaxn;
+
+    // the position of the unparsed data
+    tb_size_t                       ipos;
+
+    // the merged response data
+    tb_buffer_t                     odata;
+
+}tb_http_server_session_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_char_t const* tb_http_server_code_cstr(tb_size_t code)
+{
+    // done
+    switch (code)
+    {
+    case TB_HTTP_CODE_CONTINUE:                 return "Continue";
+    case TB_HTTP_CODE_OK:                       return "OK";
+    case TB_HTTP_CODE_CREATED:                  return "Created";
+    case TB_HTTP_CODE_ACCEPTED:                 return "Accepted";
+    case TB_HTTP_CODE_NO_CONTENT:               return "No Content";
+    case TB_HTTP_CODE_PARTIAL_CONTENT:          return "Partial Content";
+    case TB_HTTP_CODE_MOVED_PERMANENTLY:        return "Moved Permanently";
+    case TB_HTTP_CODE_MOVED_TEMPORARILY:        return "Found";
+    case TB_HTTP_CODE_SEE_OTHER:                return "See Other";
+    case TB_HTTP_CODE_NOT_MODIFIED:             return "Not Modified";
+    case TB_HTTP_CODE_TEMPORARY_REDIRECT:       return "Temporary Redirect";
+    case TB_HTTP_CODE_BAD_REQUEST:              return "Bad Request";
+    case TB_HTTP_CODE_UNAUTHORIZED:             return "Unauthorized";
+    case TB_HTTP_CODE_FORBIDDEN:                return "Forbidden";
+    case TB_HTTP_CODE_NOT_FOUND:                return "Not Found";
+    case TB_HTTP_CODE_METHOD_NOT_ALLOWED:       return "Method Not Allowed";
+    case TB_HTTP_CODE_REQUEST_TIMEOUT:          return "Request Timeout";
+    case TB_HTTP_CODE_LENGTH_REQUIRED:          return "Length Required";
+    case TB_HTTP_CODE_REQUEST_ENTITY_TOO_LONG:  return "Payload Too Large";
+    case TB_HTTP_CODE_REQUEST_URI_TOO_LONG:     return "URI Too Long";
+    case TB_HTTP_CODE_INTERNAL_SERVER_ERROR:    return "Internal Server Error";
+    case TB_HTTP_CODE_NOT_IMPLEMENTED:          return "Not Implemented";
+    case TB_HTTP_CODE_SERVICE_UNAVAILABLE:      return "Service Unavailable";
+    default:                                    return "Unknown";
+    }
+}
+static tb_char_t const* tb_http_server_mime_type(tb_char_t const* path)
+{
+    // the mime types
+    static tb_char_t const* s_types[][2] =
+    {
+        { "html",   "text/html"                 }
+    ,   { "htm",    "text/html"                 }
+    ,   { "css",    "text/css"                  }
+    ,   { "js",     "application/javascript"    }
+    ,   { "json",   "application/json"          }
+    ,   { "xml",    "application/xml"           }
+    ,   { "txt",    "text/plain"                }
+    ,   { "png",    "image/png"                 }
+    ,   { "jpg",    "image/jpeg"                }
+    ,   { "jpeg",   "image/jpeg"                }
+    ,   { "gif",    "image/gif"                 }
+    ,   { "svg",    "image/svg+xml"             }
+    ,   { "ico",    "image/x-icon"              }
+    ,   { "wasm",   "application/wasm"          }
+    ,   { "pdf",    "application/pdf"           }
+    };
+
+    // find the file extension
+    tb_char_t const* p = tb_strrchr(path, '.');
+    if (p && !tb_strchr(p, '/'))
+    {
+        tb_size_t i;
+        for (i = 0; i < tb_arrayn(s_types); i++)
+        {
+            if (!tb_stricmp(p + 1, s_types[i][0])) return s_types[i][1];
+        }
+    }
+    return "application/octet-stream";
+}
+static tb_void_t tb_http_server_file_free(tb_http_server_file_t* file)
+{
+    // check
+    tb_assert_and_check_return(file);
+
+    // exit it
+    if (file->file) tb_file_exit(file->file);
+    if (file->path) tb_free(file->path);
+    tb_free(file);
+}
+static tb_void_t tb_http_server_file_remove(tb_http_server_worker_t* worker, tb_http_server_file_t* file)
+{
+    // check
+    tb_assert_and_check_return(worker && file && !file->bdead);
+
+    // remove it from the cache
+    tb_hash_map_remove(worker->files, file->path);
+    tb_list_entry_remove(&worker->files_lru, &file->entry);
+    file->bdead = tb_true;
+
+    // free it if no session is sending it, otherwise it will be freed after sending
+    if (!file->refn) tb_http_server_file_free(file);
+}
+static tb_void_t tb_http_server_file_release(tb_http_server_worker_t* worker, tb_http_server_file_t* file)
+{
+    // check
+    tb_assert_and_check_return(worker && file && file->refn);
+
+    // free it if it has been removed
+    if (!--file->refn && file->bdead) tb_http_server_file_free(file);
+}
+static tb_http_server_file_t* tb_http_server_file_get(tb_http_server_worker_t* worker, tb_char_t const* path)
+{
+    // check
+    tb_assert_and_check_return_val(worker && worker->files && path, tb_null);
+
+    // get the cached file
+    tb_hong_t               now = tb_mclock();
+    tb_file_info_t          info;
+    tb_http_server_file_t*  file = (tb_http_server_file_t*)tb_hash_map_get(worker->files, path);
+    if (file && now - file->checked >= TB_HTTP_SERVER_FILE_CHECK)
+    {
+        // the file has been changed? remove it
+        if (!tb_file_info(path, &info) || info.type != TB_FILE_TYPE_FILE || info.size != file->size || info.mtime != file->mtime)
+        {
+            tb_http_server_file_remove(worker, file);
+            file = tb_null;
+        }
+        else file->checked = now;
+    }
+
+    // hit?
+    if (file)
+    {
+        tb_list_entry_moveto_head(&worker->files_lru, &file->entry);
+        tb_http_server_stat_add(worker, file_hits, 1);
+        file->refn++;
+        return file;
+    }
+
+    // miss
+    tb_http_server_stat_add(worker, file_misses, 1);
+
+    // done
+    tb_bool_t ok = tb_false;
+    do
+    {
+        // get the file info
+        if (!tb_file_info(path, &info) || info.type != TB_FILE_TYPE_FILE) break;
+
+        // make file
+        file = tb_malloc0_type(tb_http_server_file_t);
+        tb_assert_and_check_break(file);
+
+        // init file
+        file->path      = tb_strdup(path);
+        file->file      = tb_file_init(path, TB_FILE_MODE_RO);
+        file->size      = info.size;
+        file->mtime     = info.mtime;
+        file->checked   = now;
+        file->refn      = 1;
+        tb_check_break(file->path && file->file);
+
+        // cache it
+        if (!tb_hash_map_insert(worker->files, path, file)) break;
+        tb_list_entry_insert_head(&worker->files_lru, &file->entry);
+
+        // remove the least recently used files
+        while (tb_list_entry_size(&worker->files_lru) > TB_HTTP_SERVER_FILE_MAXN)
+            tb_http_server_file_remove(worker, (tb_http_server_file_t*)tb_list_entry(&worker->files_lru, tb_list_entry_last(&worker->files_lru)));
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok && file)
+    {
+        tb_http_server_file_free(file);
+        file = tb_null;
+    }
+    return file;
+}
+static tb_bool_t tb_http_server_session_send_data(tb_http_server_session_t* session, tb_byte_t const* data, tb_size_t size)
+{
+    // send data
+    tb_size_t send = 0;
+    while (send < size)
+    {
+        // send it
+        tb_long_t real = tb_socket_send(session->sock, data + send, size - send);
+
+        // has data?
+        if (real > 0) send += real;
+        // no data? wait it
+        else if (!real)
+        {
+            // wait it
+            if (tb_socket_wait(session->sock, TB_SOCKET_EVENT_SEND, TB_HTTP_SERVER_TIMEOUT) <= 0) break;
+        }
+        // failed or end?
+        else break;
+    }
+
+    // update stat
+    tb_http_server_stat_add(session->worker, send_size, send);
+
+    // ok?
+    return send == size;
+}
+static tb_bool_t tb_http_server_session_send_sendfile(tb_http_server_session_t* session, tb_file_ref_t file, tb_hize_t size)
+{
+    // send file
+    tb_hize_t send = 0;
+    while (send < size)
+    {
+        // send it
+        tb_hong_t real = tb_socket_sendf(session->sock, file, send, size - send);
+
+        // has data?
+        if (real > 0) send += real;
+        // no data? wait it
+        else if (!real)
+        {
+            // wait it
+            if (tb_socket_wait(session->sock, TB_SOCKET_EVENT_SEND, TB_HTTP_SERVER_TIMEOUT) <= 0) break;
+        }
+        // failed or end?
+        else break;
+    }
+
+    // update stat
+    tb_http_server_stat_add(session->worker, send_size, send);
+
+    // ok?
+    return send == size;
+}
+static tb_bool_t tb_http_server_session_flush(tb_http_server_session_t* session)
+{
+    // no data?
+    tb_size_t size = tb_buffer_size(&session->odata);
+    tb_check_return_val(size, tb_true);
+
+    // send the merged response data
+    tb_bool_t ok = tb_http_server_session_send_data(session, tb_buffer_data(&session->odata), size);
+    tb_buffer_clear(&session->odata);
+    return ok;
+}
+static tb_bool_t tb_http_server_session_head_make(tb_http_server_session_t* session, tb_size_t code, tb_hong_t content_size)
+{
+    // make the response data, we reserve 256 bytes for the status line and the server head
+    tb_size_t   osize = tb_buffer_size(&session->odata);
+    tb_size_t   hsize = tb_http_header_size(&session->rhead);
+    tb_char_t*  data = (tb_char_t*)tb_buffer_resize(&session->odata, osize + hsize + 256);
+    tb_assert_and_check_return_val(data, tb_false);
+
+    /* make the status line and the server head
+     *
+     * HTTP/1.1 200 OK
+     * Server: tbox
+     * Content-Length: 13
+     * Connection: keep-alive
+     */
+    tb_char_t*  p = data + osize;
+    tb_long_t   n = 0;
+    if (content_size >= 0)
+    {
+        n = tb_snprintf(p, 256, "HTTP/1.1 %lu %s\r\nServer: tbox\r\nContent-Length: %lld\r\nConnection: %s\r\n"
+                        , code, tb_http_server_code_cstr(code), content_size, session->keep_alive? "keep-alive" : "close");
+    }
+    else
+    {
+        n = tb_snprintf(p, 256, "HTTP/1.1 %lu %s\r\nServer: tbox\r\nTransfer-Encoding: chunked\r\nConnection: %s\r\n"
+                        , code, tb_http_server_code_cstr(code), session->keep_alive? "keep-alive" : "close");
+    }
+    tb_assert_and_check_return_val(n > 0 && n < 254, tb_false);
+    p += n;
+
+    // copy the user heads
+    p += tb_http_header_copy(&session->rhead, p);
+
+    // append end
+    *p++ = '\r';
+    *p++ = '\n';
+
+    // update the data size
+    tb_buffer_resize(&session->odata, p - data);
+    return tb_true;
+}
+static tb_bool_t tb_http_server_session_request_line(tb_http_server_session_t* session, tb_char_t* line, tb_size_t size)
+{
+    // parse method, e.g. "GET /path?args HTTP/1.1"
+    tb_char_t* p = line;
+    tb_char_t* e = line + size;
+    while (p < e && *p != ' ') p++;
+    tb_check_return_val(p < e && p > line, tb_false);
+
+    // find method
+    tb_size_t i;
+    tb_size_t n = p - line;
+    session->method = (tb_size_t)-1;
+    for (i = TB_HTTP_METHOD_GET; i <= TB_HTTP_METHOD_CONNECT; i++)
+    {
+        tb_char_t const* method = tb_http_method_cstr(i);
+        if (method && !tb_strncmp(method, line, n) && !method[n])
+        {
+            session->method = i;
+            break;
+        }
+    }
+
+    // parse path
+    while (p < e && *p == ' ') p++;
+    tb_char_t* path = p;
+    while (p < e && *p != ' ') p++;
+    tb_check_return_val(p < e && p > path && *path == '/', tb_false);
+    *p++ = '\0';
+
+    // parse version
+    while (p < e && *p == ' ') p++;
+    tb_check_return_val(p + 8 <= e && !tb_strncmp(p, "HTTP/1.", 7), tb_false);
+    session->keep_alive = p[7] != '0';
+
+    // parse args
+    tb_char_t* args = tb_strchr(path, '?');
+    if (args)
+    {
+        *args++ = '\0';
+        session->args = args - session->head.data;
+    }
+
+    // decode path in place
+    tb_size_t path_size = tb_strlen(path);
+    tb_url_decode2(path, path_size, path, path_size + 1);
+    session->path = path - session->head.data;
+    return tb_true;
+}
+static tb_long_t tb_http_server_session_recv(tb_http_server_session_t* session)
+{
+    // move the unparsed data to the head
+    if (session->ipos)
+    {
+        if (session->ipos < session->isize) tb_memmov(session->idata, session->idata + session->ipos, session->isize - session->ipos);
+        session->isize -= session->ipos;
+        session->ipos = 0;
+    }
+
+    // grow the receive data
+    if (session->isize == session->imaxn)
+    {
+        tb_check_return_val(session->imaxn < TB_HTTP_SERVER_HEAD_MAXN, -1);
+        tb_byte_t* idata = (tb_byte_t*)tb_ralloc(session->idata, session->imaxn + TB_HTTP_SERVER_DATA_GROW);
+        tb_assert_and_check_return_val(idata, -1);
+        session->idata = idata;
+        session->imaxn += TB_HTTP_SERVER_DATA_GROW;
+    }
+
+    // recv data
+    while (!tb_atomic32_get_explicit(&session->worker->server->stopped, TB_ATOMIC_RELAXED))
+    {
+        // recv it
+        tb_long_t real = tb_socket_recv(session->sock, session->idata + session->isize, session->imaxn - session->isize);
+
+        // has data?
+        if (real > 0)
+        {
+            session->isize += real;
+            return real;
+        }
+        // failed or closed?
+        else if (real < 0) return -1;
+
+        // flush the merged response data before waiting, the pipelined requests have been handled
+        if (!tb_http_server_session_flush(session)) return -1;
+
+        // no data? wait it, we close it directly if timeout
+        if (tb_socket_wait(session->sock, TB_SOCKET_EVENT_RECV, TB_HTTP_SERVER_TIMEOUT) <= 0) return -1;
+    }
+    return -1;
+}
+static tb_long_t tb_http_server_session_head_recv(tb_http_server_session_t* session)
+{
+    // clear the request
+    tb_http_header_clear(&session->head);
+    tb_http_header_clear(&session->rhead);
+    session->method         = (tb_size_t)-1;
+    session->path           = 0;
+    session->args           = 0;
+    session->content_size   = 0;
+    session->content_read   = 0;
+    session->keep_alive     = tb_false;
+    session->bexpect        = tb_false;
+    session->bad_code       = 0;
+    session->response       = TB_HTTP_SERVER_RESPONSE_NONE;
+
+    // parse the request head line by line, the received data will be parsed only once
+    tb_size_t indx = 0;
+    tb_size_t scan = 0;
+    tb_bool_t pipelined = session->ipos < session->isize;
+    while (1)
+    {
+        // scan the line end
+        tb_byte_t*  data = session->idata + session->ipos;
+        tb_size_t   left = session->isize - session->ipos;
+        tb_size_t   n = scan + tb_http_header_scan((tb_char_t const*)data + scan, left - scan);
+        if (n < left)
+        {
+            // append the line to the head arena
+            if (!tb_http_header_line_cat(&session->head, (tb_char_t const*)data, n + 1)) return -1;
+            session->ipos += n + 1;
+            scan = 0;
+
+            // get the line
+            tb_size_t   size = 0;
+            tb_char_t*  line = tb_http_header_line_done(&session->head, &size);
+            tb_assert_and_check_return_val(line, -1);
+
+            // trace
+            tb_trace_d("head: %s", line);
+
+            // the request line? skip the leading empty lines
+            if (!indx)
+            {
+                tb_check_continue(size);
+                if (!tb_http_server_session_request_line(session, line, size)) return -1;
+            }
+            // end?
+            else if (!size)
+            {
+                if (pipelined) tb_http_server_stat_add(session->worker, pipelined, 1);
+                return 1;
+            }
+            // key: value
+            else
+            {
+                // load it
+                tb_char_t const*    value = tb_null;
+                tb_size_t           id = tb_http_header_line_load(&session->head, line, size, &value);
+                if (id == TB_HTTP_HEADER_MAXN) return -1;
+
+                // parse the well-known heads
+                switch (id)
+                {
+                case TB_HTTP_HEADER_CONTENT_LENGTH:
+                    session->content_size = tb_stou64(value);
+                    break;
+                case TB_HTTP_HEADER_CONNECTION:
+                    if (!tb_stricmp(value, "close")) session->keep_alive = tb_false;
+                    else if (!tb_stricmp(value, "keep-alive")) session->keep_alive = tb_true;
+                    break;
+                case TB_HTTP_HEADER_TRANSFER_ENCODING:
+                    // the chunked request content is not supported now
+                    session->bad_code = TB_HTTP_CODE_LENGTH_REQUIRED;
+                    break;
+                case TB_HTTP_HEADER_EXPECT:
+                    session->bexpect = !tb_stricmp(value, "100-continue");
+                    break;
+                default:
+                    break;
+                }
+            }
+
+            // next line
+            indx++;
+
+            // the head is too large?
+            tb_check_return_val(session->head.data_size < TB_HTTP_SERVER_HEAD_MAXN, -1);
+        }
+        else
+        {
+            // the head is too large?
+            tb_check_return_val(left < TB_HTTP_SERVER_HEAD_MAXN, -1);
+
+            // recv more data
+            scan = left;
+            pipelined = tb_false;
+            if (tb_http_server_session_recv(session) <= 0)
+            {
+                // closed before the next request?
+                return (!indx && !left)? 0 : -1;
+            }
+        }
+    }
+    return -1;
+}
+static tb_http_server_route_t const* tb_http_server_session_route(tb_http_server_session_t* session)
+{
+    // the server
+    tb_http_server_t* server = session->worker->server;
+
+    /* find the longest matched prefix, the routes have been sorted by the prefix size
+     *
+     * the prefix must match the whole path segments, e.g. "/api" matches "/api", "/api/x" and "/api?x", but not "/apix"
+     */
+    tb_size_t           i;
+    tb_char_t const*    path = tb_http_server_session_path((tb_http_server_session_ref_t)session);
+    for (i = 0; i < server->routes_size; i++)
+    {
+        tb_http_server_route_t const* route = &server->routes[i];
+        tb_size_t                     size = route->prefix_size;
+        if (!tb_strncmp(path, route->prefix, size))
+        {
+            tb_char_t ch = path[size];
+            if (!ch || ch == '/' || ch == '?' || (size && route->prefix[size - 1] == '/')) return route;
+        }
+    }
+    return tb_null;
+}
+static tb_bool_t tb_http_server_session_root(tb_http_server_session_ref_t self, tb_cpointer_t priv)
+{
+    // check
+    tb_http_server_session_t*       session = (tb_http_server_session_t*)self;
+    tb_http_server_route_t const*   route = (tb_http_server_route_t const*)priv;
+    tb_assert_and_check_return_val(session && route && route->rootdir, tb_false);
+
+    // only get and head
+    if (session->method != TB_HTTP_METHOD_GET && session->method != TB_HTTP_METHOD_HEAD)
+        return tb_http_server_session_send(self, TB_HTTP_CODE_METHOD_NOT_ALLOWED, tb_null, 0);
+
+    // the relative path, we do not allow to access the parent directory
+    tb_char_t const* path = tb_http_server_session_path(self) + route->prefix_size;
+    if (tb_strstr(path, "..")) return tb_http_server_session_send(self, TB_HTTP_CODE_FORBIDDEN, tb_null, 0);
+
+    // make the full path
+    tb_char_t   fullpath[TB_PATH_MAXN];
+    tb_size_t   size = tb_strlen(path);
+    tb_long_t   n = tb_snprintf(fullpath, sizeof(fullpath), "%s%s%s%s", route->rootdir, *path == '/'? "" : "/", path, (!size || path[size - 1] == '/')? "index.html" : "");
+    if (n <= 0 || n >= sizeof(fullpath)) return tb_http_server_session_send(self, TB_HTTP_CODE_REQUEST_URI_TOO_LONG, tb_null, 0);
+
+    // send file
+    return tb_http_server_session_send_file(self, fullpath);
+}
+static tb_bool_t tb_http_server_session_dispatch(tb_http_server_session_t* session)
+{
+    // update stat
+    tb_http_server_stat_add(session->worker, requests, 1);
+
+    // bad request?
+    tb_bool_t ok = tb_true;
+    if (session->bad_code || session->method == (tb_size_t)-1)
+    {
+        session->keep_alive = tb_false;
+        ok = tb_http_server_session_send((tb_http_server_session_ref_t)session, session->bad_code? session->bad_code : TB_HTTP_CODE_NOT_IMPLEMENTED, tb_null, 0);
+    }
+    else
+    {
+        // route it
+        tb_http_server_route_t const* route = tb_http_server_session_route(session);
+        if (route) ok = route->func((tb_http_server_session_ref_t)session, route->rootdir? route : route->priv);
+
+        // no response? not found
+        if (!route || (ok && session->response == TB_HTTP_SERVER_RESPONSE_NONE))
+            ok = tb_http_server_session_send((tb_http_server_session_ref_t)session, TB_HTTP_CODE_NOT_FOUND, tb_null, 0);
+    }
+
+    // finish the chunked response
+    if (ok && session->response == TB_HTTP_SERVER_RESPONSE_CHUNKED)
+        ok = tb_http_server_session_done((tb_http_server_session_ref_t)session);
+
+    // skip the left request content for the next request
+    if (ok && session->content_read < session->content_size)
+    {
+        // we do not send 100-continue for skipping content, so close it
+        if (session->bexpect) ok = tb_false;
+        else
+        {
+            tb_byte_t data[TB_HTTP_SERVER_DATA_GROW];
+            tb_long_t real = 0;
+            while ((real = tb_http_server_session_read((tb_http_server_session_ref_t)session, data, sizeof(data))) > 0) ;
+            ok = !real;
+        }
+    }
+
+    // ok?
+    return ok && session->keep_alive;
+}
+static tb_void_t tb_http_server_session_exit(tb_http_server_session_t* session)
+{
+    // check
+    tb_assert_and_check_return(session);
+
+    // remove it from the worker
+    if (session->worker) tb_list_entry_remove(&session->worker->sessions, &session->entry);
+
+    // exit socket
+    if (session->sock) tb_socket_exit(session->sock);
+    session->sock = tb_null;
+
+    // exit chunked filter
+    if (session->chunked) tb_filter_exit(session->chunked);
+    session->chunked = tb_null;
+
+    // exit data
+    if (session->idata) tb_free(session->idata);
+    session->idata = tb_null;
+    tb_buffer_exit(&session->odata);
+
+    // exit heads
+    tb_http_header_exit(&session->rhead);
+    tb_http_header_exit(&session->head);
+
+    // exit it
+    tb_free(session);
+}
+static tb_http_server_session_t* tb_http_server_session_init(tb_http_server_worker_t* worker, tb_socket_ref_t sock)
+{
+    // done
+    tb_bool_t                   ok = tb_false;
+    tb_http_server_session_t*   session = tb_null;
+    do
+    {
+        // make session
+        session = tb_malloc0_type(tb_http_server_session_t);
+        tb_assert_and_check_break(session);
+
+        // init session
+        session->sock = sock;
+        if (!tb_http_header_init(&session->head)) break;
+        if (!tb_http_header_init(&session->rhead)) break;
+        if (!tb_buffer_init(&session->odata)) break;
+
+        // init receive data
+        session->idata = tb_malloc_bytes(TB_HTTP_SERVER_DATA_GROW);
+        tb_assert_and_check_break(session->idata);
+        session->imaxn = TB_HTTP_SERVER_DATA_GROW;
+
+        // disable the nagle algorithm, the pipelined responses will be merged by ourselves
+        tb_socket_ctrl(sock, TB_SOCKET_CTRL_SET_TCP_NODELAY, tb_true);
+
+        // add it to the worker
+        session->worker = worker;
+        tb_list_entry_insert_tail(&worker->sessions, &session->entry);
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok && session)
+    {
+        session->sock = tb_null;
+        tb_http_server_session_exit(session);
+        session = tb_null;
+    }
+    return session;
+}
+static tb_void_t tb_http_server_session_loop(tb_cpointer_t priv)
+{
+    // check
+    tb_http_server_session_t* session = (tb_http_server_session_t*)priv;
+    tb_assert_and_check_return(session);
+
+    // handle requests
+    tb_long_t ok = 0;
+    while (!tb_atomic32_get_explicit(&session->worker->server->stopped, TB_ATOMIC_RELAXED))
+    {
+        // recv and parse the request head
+        ok = tb_http_server_session_head_recv(session);
+
+        // bad request? close it after sending response
+        if (ok < 0)
+        {
+            session->keep_alive = tb_false;
+            session->response = TB_HTTP_SERVER_RESPONSE_NONE;
+            tb_http_server_session_send((tb_http_server_session_ref_t)session, TB_HTTP_CODE_BAD_REQUEST, tb_null, 0);
+            break;
+        }
+        // closed?
+        else if (!ok) break;
+
+        // dispatch it
+        if (!tb_http_server_session_dispatch(session)) break;
+    }
+
+    // flush the left response data
+    tb_http_server_session_flush(session);
+
+    // exit session
+    tb_http_server_session_exit(session);
+}
+static tb_void_t tb_http_server_listen(tb_cpointer_t priv)
+{
+    // check
+    tb_http_server_worker_t* worker = (tb_http_server_worker_t*)priv;
+    tb_assert_and_check_return(worker && worker->server && worker->sock);
+
+    // accept connections
+    tb_socket_ref_t client = tb_null;
+    while (!tb_atomic32_get(&worker->server->stopped))
+    {
+        // accept and start the connection
+        if ((client = tb_socket_accept(worker->sock, tb_null)))
+        {
+            // init session
+            tb_http_server_session_t* session = tb_http_server_session_init(worker, client);
+            if (session)
+            {
+                // start it
+                if (tb_coroutine_start(tb_null, tb_http_server_session_loop, session, TB_HTTP_SERVER_STACKSIZE))
+                    tb_http_server_stat_add(worker, connections, 1);
+                else tb_http_server_session_exit(session);
+            }
+            else tb_socket_exit(client);
+        }
+        else if (tb_socket_wait(worker->sock, TB_SOCKET_EVENT_ACPT, -1) <= 0) break;
+    }
+
+    // kill all connections of this worker, they will exit after waking up
+    tb_list_entry_ref_t entry = tb_list_entry_head(&worker->sessions);
+    while (entry != tb_list_entry_tail(&worker->sessions))
+    {
+        tb_http_server_session_t* session = (tb_http_server_session_t*)tb_list_entry(&worker->sessions, entry);
+        if (session->sock) tb_socket_kill(session->sock, TB_SOCKET_KILL_RW);
+        entry = tb_list_entry_next(entry);
+    }
+
+    // trace
+    tb_trace_d("worker[%p]: stopped", worker);
+}
+static tb_int_t tb_http_server_worker_loop(tb_cpointer_t priv)
+{
+    // check
+    tb_http_server_worker_t* worker = (tb_http_server_worker_t*)priv;
+    tb_assert_and_check_return_val(worker && worker->scheduler, -1);
+
+    // start listener
+    if (tb_coroutine_start(worker->scheduler, tb_http_server_listen, worker, 0))
+    {
+        // run scheduler, enable exclusive mode if be only one worker
+        tb_co_scheduler_loop(worker->scheduler, worker->server->workers_count == 1);
+    }
+    return 0;
+}
+static tb_void_t tb_http_server_worker_exit(tb_http_server_worker_t* worker)
+{
+    // check
+    tb_assert_and_check_return(worker);
+
+    // exit scheduler
+    if (worker->scheduler)
+    {
+        tb_co_scheduler_kill(worker->scheduler);
+        tb_co_scheduler_exit(worker->scheduler);
+        worker->scheduler = tb_null;
+    }
+
+    // exit the left sessions
+    while (tb_list_entry_size(&worker->sessions))
+        tb_http_server_session_exit((tb_http_server_session_t*)tb_list_entry(&worker->sessions, tb_list_entry_head(&worker->sessions)));
+
+    // exit cached files
+    while (tb_list_entry_size(&worker->files_lru))
+        tb_http_server_file_remove(worker, (tb_http_server_file_t*)tb_list_entry(&worker->files_lru, tb_list_entry_head(&worker->files_lru)));
+    if (worker->files) tb_hash_map_exit(worker->files);
+    worker->files = tb_null;
+
+    // exit listener
+    if (worker->sock && !worker->bshared) tb_socket_exit(worker->sock);
+    worker->sock = tb_null;
+}
+static tb_bool_t tb_http_server_worker_init(tb_http_server_worker_t* worker, tb_http_server_t* server, tb_socket_ref_t shared)
+{
+    // init worker
+    tb_memset(worker, 0, sizeof(tb_http_server_worker_t));
+    worker->server = server;
+    tb_list_entry_init(&worker->sessions, tb_http_server_session_t, entry, tb_null);
+    tb_list_entry_init(&worker->files_lru, tb_http_server_file_t, entry, tb_null);
+
+    // done
+    tb_bool_t ok = tb_false;
+    do
+    {
+        // init listener
+        if (shared)
+        {
+            worker->sock    = shared;
+            worker->bshared = tb_true;
+        }
+        else
+        {
+            // init socket
+            worker->sock = tb_socket_init(TB_SOCKET_TYPE_TCP, tb_ipaddr_family(&server->addr));
+            tb_assert_and_check_break(worker->sock);
+
+            // bind it, SO_REUSEPORT will be enabled if the port is not zero
+            if (!tb_socket_bind(worker->sock, &server->addr)) break;
+
+            // get the random port
+            if (!tb_ipaddr_port(&server->addr) && !tb_socket_local(worker->sock, &server->addr)) break;
+
+            // listen it
+            if (!tb_socket_listen(worker->sock, 1024)) break;
+        }
+
+        // init cached files
+        worker->files = tb_hash_map_init(TB_HASH_MAP_BUCKET_SIZE_MICRO, tb_element_str(tb_true), tb_element_ptr(tb_null, tb_null));
+        tb_assert_and_check_break(worker->files);
+
+        // init scheduler
+        worker->scheduler = tb_co_scheduler_init();
+        tb_assert_and_check_break(worker->scheduler);
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok) tb_http_server_worker_exit(worker);
+    return ok;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+tb_http_server_ref_t tb_http_server_init(tb_ipaddr_ref_t addr, tb_size_t workers)
+{
+    // check
+    tb_assert_and_check_return_val(addr, tb_null);
+
+    // make server
+    tb_http_server_t* server = tb_malloc0_type(tb_http_server_t);
+    tb_assert_and_check_return_val(server, tb_null);
+
+    // init server
+    tb_ipaddr_copy(&server->addr, addr);
+    server->workers_count = workers? workers : tb_cpu_count();
+    if (!server->workers_count) server->workers_count = 1;
+    tb_atomic32_init(&server->stopped, 0);
+    return (tb_http_server_ref_t)server;
+}
+tb_void_t tb_http_server_exit(tb_http_server_ref_t self)
+{
+    // check
+    tb_http_server_t* server = (tb_http_server_t*)self;
+    tb_assert_and_check_return(server);
+
+    // stop it
+    tb_http_server_stop(self);
+
+    // exit routes
+    tb_size_t i;
+    for (i = 0; i < server->routes_size; i++)
+    {
+        if (server->routes[i].prefix) tb_free(server->routes[i].prefix);
+        if (server->routes[i].rootdir) tb_free(server->routes[i].rootdir);
+    }
+    if (server->routes) tb_free(server->routes);
+    server->routes = tb_null;
+
+    // exit it
+    tb_free(server);
+}
+tb_bool_t tb_http_server_route(tb_http_server_ref_t self, tb_char_t const* prefix, tb_http_server_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_http_server_t* server = (tb_http_server_t*)self;
+    tb_assert_and_check_return_val(server && prefix && *prefix == '/' && func && !server->bstarted, tb_false);
+
+    // grow routes
+    tb_http_server_route_t* routes = (tb_http_server_route_t*)tb_ralloc(server->routes, (server->routes_size + 1) * sizeof(tb_http_server_route_t));
+    tb_assert_and_check_return_val(routes, tb_false);
+    server->routes = routes;
+
+    // make route
+    tb_http_server_route_t route;
+    route.prefix        = tb_strdup(prefix);
+    route.prefix_size   = tb_strlen(prefix);
+    route.func          = func;
+    route.priv          = priv;
+    route.rootdir       = tb_null;
+    tb_assert_and_check_return_val(route.prefix, tb_false);
+
+    // insert it and keep the longer prefix first
+    tb_size_t i = server->routes_size;
+    while (i && routes[i - 1].prefix_size < route.prefix_size)
+    {
+        routes[i] = routes[i - 1];
+        i--;
+    }
+    routes[i] = route;
+    server->routes_size++;
+    return tb_true;
+}
+tb_bool_t tb_http_server_root(tb_http_server_ref_t self, tb_char_t const* prefix, tb_char_t const* rootdir)
+{
+    // check
+    tb_http_server_t* server = (tb_http_server_t*)self;
+    tb_assert_and_check_return_val(server && rootdir, tb_false);
+
+    // add route
+    if (!tb_http_server_route(self, prefix, tb_http_server_session_root, tb_null)) return tb_false;
+
+    // save the root directory
+    tb_size_t i;
+    for (i = 0; i < server->routes_size; i++)
+    {
+        tb_http_server_route_t* route = &server->routes[i];
+        if (route->func == tb_http_server_session_root && !route->rootdir && !tb_strcmp(route->prefix, prefix))
+        {
+            route->rootdir = tb_strdup(rootdir);
+            return route->rootdir? tb_true : tb_false;
+        }
+    }
+    return tb_false;
+}
+tb_bool_t tb_http_server_start(tb_http_server_ref_t self)
+{
+    // check
+    tb_http_server_t* server = (tb_http_server_t*)self;
+    tb_assert_and_check_return_val(server && server->workers_count && !server->bstarted, tb_false);
+
+    // done
+    tb_bool_t ok = tb_false;
+    do
+    {
+        // make workers
+        server->workers = tb_nalloc0_type(server->workers_count, tb_http_server_worker_t);
+        tb_assert_and_check_break(server->workers);
+        server->bstarted = tb_true;
+        tb_atomic32_set(&server->stopped, 0);
+
+        // init workers, each worker has it's own listener if the port is specified
+        tb_size_t i;
+        tb_bool_t random_port = !tb_ipaddr_port(&server->addr);
+        for (i = 0; i < server->workers_count; i++)
+        {
+            tb_socket_ref_t shared = (random_port && i)? server->workers[0].sock : tb_null;
+            if (!tb_http_server_worker_init(&server->workers[i], server, shared)) break;
+        }
+        tb_check_break(i == server->workers_count);
+
+        // start workers
+        for (i = 0; i < server->workers_count; i++)
+        {
+            server->workers[i].thread = tb_thread_init(tb_null, tb_http_server_worker_loop, &server->workers[i], 0);
+            tb_assert_and_check_break(server->workers[i].thread);
+        }
+        tb_check_break(i == server->workers_count);
+
+        // trace
+        tb_trace_d("started: %{ipaddr}, workers: %lu", &server->addr, server->workers_count);
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed? stop it
+    if (!ok) tb_http_server_stop(self);
+    return ok;
+}
+tb_void_t tb_http_server_stop(tb_http_server_ref_t self)
+{
+    // check
+    tb_http_server_t* server = (tb_http_server_t*)self;
+    tb_assert_and_check_return(server);
+
+    // started?
+    tb_check_return(server->bstarted);
+
+    // stop it
+    tb_atomic32_set(&server->stopped, 1);
+
+    // kill all listeners to wake up workers, they will kill all connections
+    tb_size_t i;
+    for (i = 0; i < server->workers_count; i++)
+    {
+        tb_http_server_worker_t* worker = &server->workers[i];
+        if (worker->sock && !worker->bshared) tb_socket_kill(worker->sock, TB_SOCKET_KILL_RW);
+    }
+
+    // wait all workers
+    for (i = 0; i < server->workers_count; i++)
+    {
+        tb_http_server_worker_t* worker = &server->workers[i];
+        if (worker->thread)
+        {
+            tb_thread_wait(worker->thread, -1, tb_null);
+            tb_thread_exit(worker->thread);
+            worker->thread = tb_null;
+        }
+    }
+
+    // exit all workers, exit the shared listener at last
+    for (i = server->workers_count; i > 0; i--) tb_http_server_worker_exit(&server->workers[i - 1]);
+    tb_free(server->workers);
+    server->workers = tb_null;
+
+    // stopped
+    server->bstarted = tb_false;
+}
+tb_bool_t tb_http_server_addr(tb_http_server_ref_t self, tb_ipaddr_ref_t addr)
+{
+    // check
+    tb_http_server_t* server = (tb_http_server_t*)self;
+    tb_assert_and_check_return_val(server && addr, tb_false);
+
+    // get it
+    tb_ipaddr_copy(addr, &server->addr);
+    return tb_true;
+}
+tb_void_t tb_http_server_stat(tb_http_server_ref_t self, tb_http_server_stat_t* stat)
+{
+    // check
+    tb_http_server_t* server = (tb_http_server_t*)self;
+    tb_assert_and_check_return(server && stat);
+
+    // sum the stat of all workers
+    tb_size_t i;
+    tb_memset(stat, 0, sizeof(tb_http_server_stat_t));
+    for (i = 0; server->workers && i < server->workers_count; i++)
+    {
+        tb_http_server_worker_t* worker = &server->workers[i];
+        stat->connections   += tb_atomic64_get_explicit(&worker->stat_connections, TB_ATOMIC_RELAXED);
+        stat->requests      += tb_atomic64_get_explicit(&worker->stat_requests, TB_ATOMIC_RELAXED);
+        stat->pipelined     += tb_atomic64_get_explicit(&worker->stat_pipelined, TB_ATOMIC_RELAXED);
+        stat->files         += tb_atomic64_get_explicit(&worker->stat_files, TB_ATOMIC_RELAXED);
+        stat->file_hits     += tb_atomic64_get_explicit(&worker->stat_file_hits, TB_ATOMIC_RELAXED);
+        stat->file_misses   += tb_atomic64_get_explicit(&worker->stat_file_misses, TB_ATOMIC_RELAXED);
+        stat->send_size     += tb_atomic64_get_explicit(&worker->stat_send_size, TB_ATOMIC_RELAXED);
+    }
+}
+tb_size_t tb_http_server_session_method(tb_http_server_session_ref_t self)
+{
+    // check
+    tb_http_server_session_t* session = (tb_http_server_session_t*)self;
+    tb_assert_and_check_return_val(session, TB_HTTP_METHOD_GET);
+
+    // the method
+    return session->method;
+}
+tb_char_t const* tb_http_server_session_path(tb_http_server_session_ref_t self)
+{
+    // check
+    tb_http_server_session_t* session = (tb_http_server_session_t*)self;
+    tb_assert_and_check_return_val(session, tb_null);
+
+    // the path
+    return session->head.data + session->path;
+}
+tb_char_t const* tb_http_server_session_args(tb_http_server_session_ref_t self)
+{
+    // check
+    tb_http_server_session_t* session = (tb_http_server_session_t*)self;
+    tb_assert_and_check_return_val(session, tb_null);
+
+    // the args
+    return session->args? session->head.data + session->args : tb_null;
+}
+tb_char_t const* tb_http_server_session_head(tb_http_server_session_ref_t self, tb_char_t const* name)
+{
+    // check
+    tb_http_server_session_t* session = (tb_http_server_session_t*)self;
+    tb_assert_and_check_return_val(session && name, tb_null);
+
+    // get it
+    return tb_http_header_get(&session->head, name, tb_strlen(name), tb_null);
+}
+tb_hize_t tb_http_server_session_content_size(tb_http_server_session_ref_t self)
+{
+    // check
+    tb_http_server_session_t* session = (tb_http_server_session_t*)self;
+    tb_assert_and_check_return_val(session, 0);
+
+    // the content size
+    return session->content_size;
+}
+tb_long_t tb_http_server_session_read(tb_http_server_session_ref_t self, tb_byte_t* data, tb_size_t size)
+{
+    // check
+    tb_http_server_session_t* session = (tb_http_server_session_t*)self;
+    tb_assert_and_check_return_val(session && data && size, -1);
+
+    // end?
+    tb_check_return_val(session->content_read < session->content_size, 0);
+    size = (tb_size_t)tb_min((tb_hize_t)size, session->content_size - session->content_read);
+
+    // send 100-continue first
+    if (session->bexpect)
+    {
+        static tb_char_t const s_continue[] = "HTTP/1.1 100 Continue\r\n\r\n";
+        session->bexpect = tb_false;
+        if (!tb_http_server_session_flush(session)) return -1;
+        if (!tb_http_server_session_send_data(session, (tb_byte_t const*)s_continue, sizeof(s_continue) - 1)) return -1;
+    }
+
+    // no buffered data? recv it
+    if (session->ipos == session->isize && tb_http_server_session_recv(session) <= 0) return -1;
+
+    // read the buffered data
+    size = tb_min(size, session->isize - session->ipos);
+    tb_memcpy(data, session->idata + session->ipos, size);
+    session->ipos += size;
+    session->content_read += size;
+    return size;
+}
+tb_bool_t tb_http_server_session_head_set(tb_http_server_session_ref_t self, tb_char_t const* name, tb_char_t const* value)
+{
+    // check
+    tb_http_server_session_t* session = (tb_http_server_session_t*)self;
+    tb_assert_and_check_return_val(session && name && value, tb_false);
+
+    // set it
+    return tb_http_header_set(&session->rhead, name, tb_strlen(name), value, tb_strlen(value));
+}
+tb_bool_t tb_http_server_session_send(tb_http_server_session_ref_t self, tb_size_t code, tb_byte_t const* data, tb_size_t size)
+{
+    // check
+    tb_http_server_session_t* session = (tb_http_server_session_t*)self;
+    tb_assert_and_check_return_val(session && session->response == TB_HTTP_SERVER_RESPONSE_NONE, tb_false);
+
+    // make the response head
+    session->response = TB_HTTP_SERVER_RESPONSE_SENT;
+    if (!tb_http_server_session_head_make(session, code, size)) return tb_false;
+
+    // append the content, it will be sent with the pipelined responses
+    if (data && size && session->method != TB_HTTP_METHOD_HEAD && !tb_buffer_memncat(&session->odata, data, size)) return tb_false;
+
+    // too large? send it now
+    return tb_buffer_size(&session->odata) < TB_HTTP_SERVER_CORK_MAXN? tb_true : tb_http_server_session_flush(session);
+}
+tb_bool_t tb_http_server_session_send_file(tb_http_server_session_ref_t self, tb_char_t const* path)
+{
+    // check
+    tb_http_server_session_t* session = (tb_http_server_session_t*)self;
+    tb_assert_and_check_return_val(session && path, tb_false);
+
+    // get the cached file
+    tb_http_server_file_t* file = tb_http_server_file_get(session->worker, path);
+    if (!file) return tb_http_server_session_send(self, TB_HTTP_CODE_NOT_FOUND, tb_null, 0);
+
+    // done
+    tb_bool_t ok = tb_false;
+    do
+    {
+        // check
+        tb_assert_and_check_break(session->response == TB_HTTP_SERVER_RESPONSE_NONE);
+
+        // set content type
+        if (!tb_http_header_get_id(&session->rhead, TB_HTTP_HEADER_CONTENT_TYPE, tb_null))
+        {
+            tb_char_t const* type = tb_http_server_mime_type(path);
+            if (!tb_http_header_set_id(&session->rhead, TB_HTTP_HEADER_CONTENT_TYPE, type, tb_strlen(type))) break;
+        }
+
+        // make the response head
+        session->response = TB_HTTP_SERVER_RESPONSE_SENT;
+        if (!tb_http_server_session_head_make(session, TB_HTTP_CODE_OK, file->size)) break;
+
+        // send the response head with the previous pipelined responses
+        if (!tb_http_server_session_flush(session)) break;
+
+        // send file
+        if (session->method != TB_HTTP_METHOD_HEAD && !tb_http_server_session_send_sendfile(session, file->file, file->size)) break;
+
+        // update stat
+        tb_http_server_stat_add(session->worker, files, 1);
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // release file
+    tb_http_server_file_release(session->worker, file);
+    return ok;
+}
+tb_bool_t tb_http_server_session_write(tb_http_server_session_ref_t self, tb_byte_t const* data, tb_size_t size)
+{
+    // check
+    tb_http_server_session_t* session = (tb_http_server_session_t*)self;
+    tb_assert_and_check_return_val(session && data && session->response != TB_HTTP_SERVER_RESPONSE_SENT, tb_false);
+
+    // the first chunk? make the response head
+    if (session->response == TB_HTTP_SERVER_RESPONSE_NONE)
+    {
+        // init the chunked filter
+        if (!session->chunked) session->chunked = tb_filter_init_from_chunked(tb_false);
+        tb_assert_and_check_return_val(session->chunked, tb_false);
+        if (!tb_filter_open(session->chunked)) return tb_false;
+
+        // make head
+        session->response = TB_HTTP_SERVER_RESPONSE_CHUNKED;
+        if (!tb_http_server_session_head_make(session, TB_HTTP_CODE_OK, -1)) return tb_false;
+    }
+
+    // no content for the head method
+    tb_check_return_val(size && session->method != TB_HTTP_METHOD_HEAD, tb_true);
+
+    // encode data
+    tb_byte_t const*    odata = tb_null;
+    tb_long_t           osize = tb_filter_spak(session->chunked, data, size, &odata, 0, 1);
+    while (osize > 0)
+    {
+        // append it
+        if (!tb_buffer_memncat(&session->odata, odata, osize)) return tb_false;
+
+        // encode the left data
+        osize = tb_filter_spak(session->chunked, tb_null, 0, &odata, 0, 1);
+    }
+    tb_check_return_val(osize >= 0, tb_false);
+
+    // send it now for streaming
+    return tb_http_server_session_flush(session);
+}
+tb_bool_t tb_http_server_session_done(tb_http_server_session_ref_t self)
+{
+    // check
+    tb_http_server_session_t* session = (tb_http_server_session_t*)self;
+    tb_assert_and_check_return_val(session, tb_false);
+
+    // not chunked?
+    tb_check_return_val(session->response == TB_HTTP_SERVER_RESPONSE_CHUNKED, tb_true);
+    session->response = TB_HTTP_SERVER_RESPONSE_SENT;
+
+    // encode the end chunk
+    tb_bool_t ok = tb_true;
+    if (session->method != TB_HTTP_METHOD_HEAD)
+    {
+        tb_byte_t const*    odata = tb_null;
+        tb_long_t           osize = 0;
+        while ((osize = tb_filter_spak(session->chunked, tb_null, 0, &odata, 0, -1)) > 0)
+        {
+            if (!tb_buffer_memncat(&session->odata, odata, osize))
+            {
+                ok = tb_false;
+                break;
+            }
+        }
+    }
+
+    // close filter for the next response
+    tb_filter_clos(session->chunked);
+    return ok;
+}
+#endif
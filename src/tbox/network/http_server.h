@@ -0,0 +1,295 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        http_server.h
+ * @ingroup     network
+ *
+ */
+#ifndef TB_NETWORK_HTTP_SERVER_H
+#define TB_NETWORK_HTTP_SERVER_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "http.h"
+#include "ipaddr.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the http server ref type
+typedef __tb_typeref__(http_server);
+
+/// the http server session ref type, it is the current request and response of the connection
+typedef __tb_typeref__(http_server_session);
+
+/*! the http server handler type
+ *
+ * the handler is called in the coroutine of the connection, so it can block the coroutine by socket, sleep, lock, channel ...
+ *
+ * @param session               the session
+ * @param priv                  the user private data
+ *
+ * @return                      tb_true: keep the connection alive, tb_false: close the connection
+ */
+typedef tb_bool_t               (*tb_http_server_func_t)(tb_http_server_session_ref_t session, tb_cpointer_t priv);
+
+/// the http server stat type
+typedef struct __tb_http_server_stat_t
+{
+    /// the accepted connection count
+    tb_hize_t                   connections;
+
+    /// the request count
+    tb_hize_t                   requests;
+
+    /// the pipelined request count which has been received before the previous response was sent
+    tb_hize_t                   pipelined;
+
+    /// the sent file count
+    tb_hize_t                   files;
+
+    /// the hit count of the file cache
+    tb_hize_t                   file_hits;
+
+    /// the missed count of the file cache
+    tb_hize_t                   file_misses;
+
+    /// the sent bytes
+    tb_hize_t                   send_size;
+
+}tb_http_server_stat_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init the http server
+ *
+ * each worker runs a coroutine scheduler in its own thread and has its own listener with SO_REUSEPORT,
+ * the listener will be shared by all workers if the port is zero.
+ *
+ * @code
+    static tb_bool_t tb_demo_hello(tb_http_server_session_ref_t session, tb_cpointer_t priv)
+    {
+        tb_http_server_session_head_set(session, "Content-Type", "text/plain");
+        return tb_http_server_session_send(session, TB_HTTP_CODE_OK, (tb_byte_t const*)"hello", 5);
+    }
+
+    tb_ipaddr_t addr;
+    tb_ipaddr_set(&addr, "127.0.0.1", 8080, TB_IPADDR_FAMILY_IPV4);
+    tb_http_server_ref_t server = tb_http_server_init(&addr, 0);
+    if (server)
+    {
+        tb_http_server_route(server, "/hello", tb_demo_hello, tb_null);
+        tb_http_server_root(server, "/", "/var/www");
+        if (tb_http_server_start(server))
+        {
+            // ...
+            tb_http_server_stop(server);
+        }
+        tb_http_server_exit(server);
+    }
+ * @endcode
+ *
+ * @param addr                  the bound address
+ * @param workers               the worker count, using the cpu count if be zero
+ *
+ * @return                      the server
+ */
+tb_http_server_ref_t            tb_http_server_init(tb_ipaddr_ref_t addr, tb_size_t workers);
+
+/*! exit the http server, it will be stopped first
+ *
+ * @param server                the server
+ */
+tb_void_t                       tb_http_server_exit(tb_http_server_ref_t server);
+
+/*! add the route handler, the longest matched path prefix will be used
+ *
+ * the prefix matches the whole path segments, e.g. "/api" matches "/api" and "/api/users" but not "/apix",
+ * and the prefix ending with '/' matches all paths under it.
+ *
+ * @note it must be called before starting the server
+ *
+ * @param server                the server
+ * @param prefix                the path prefix, e.g. "/api/"
+ * @param func                  the handler
+ * @param priv                  the user private data
+ *
+ * @return                      tb_true or tb_false
+ */
+tb_bool_t                       tb_http_server_route(tb_http_server_ref_t server, tb_char_t const* prefix, tb_http_server_func_t func, tb_cpointer_t priv);
+
+/*! add the route for serving the static files
+ *
+ * @note it must be called before starting the server
+ *
+ * @param server                the server
+ * @param prefix                the path prefix, e.g. "/static/"
+ * @param rootdir               the root directory, the path after the prefix will be mapped to it
+ *
+ * @return                      tb_true or tb_false
+ */
+tb_bool_t                       tb_http_server_root(tb_http_server_ref_t server, tb_char_t const* prefix, tb_char_t const* rootdir);
+
+/*! start all workers
+ *
+ * @param server                the server
+ *
+ * @return                      tb_true or tb_false
+ */
+tb_bool_t                       tb_http_server_start(tb_http_server_ref_t server);
+
+/*! stop all workers and close all connections, it will wait for all workers
+ *
+ * @param server                the server
+ */
+tb_void_t                       tb_http_server_stop(tb_http_server_ref_t server);
+
+/*! get the bound address, e.g. get the random port if the port is zero
+ *
+ * @param server                the server
+ * @param addr                  the address
+ *
+ * @return                      tb_true or tb_false
+ */
+tb_bool_t                       tb_http_server_addr(tb_http_server_ref_t server, tb_ipaddr_ref_t addr);
+
+/*! get the server stat of all workers
+ *
+ * @param server                the server
+ * @param stat                  the stat
+ */
+tb_void_t                       tb_http_server_stat(tb_http_server_ref_t server, tb_http_server_stat_t* stat);
+
+/*! get the request method
+ *
+ * @param session               the session
+ *
+ * @return                      the method, e.g. TB_HTTP_METHOD_GET
+ */
+tb_size_t                       tb_http_server_session_method(tb_http_server_session_ref_t session);
+
+/*! get the request path which has been decoded
+ *
+ * @param session               the session
+ *
+ * @return                      the path
+ */
+tb_char_t const*                tb_http_server_session_path(tb_http_server_session_ref_t session);
+
+/*! get the request arguments
+ *
+ * @param session               the session
+ *
+ * @return                      the arguments after '?', tb_null if no arguments
+ */
+tb_char_t const*                tb_http_server_session_args(tb_http_server_session_ref_t session);
+
+/*! get the request head value
+ *
+ * @param session               the session
+ * @param name                  the case-insensitive head name
+ *
+ * @return                      the value, tb_null if not found
+ */
+tb_char_t const*                tb_http_server_session_head(tb_http_server_session_ref_t session, tb_char_t const* name);
+
+/*! get the request content size
+ *
+ * @param session               the session
+ *
+ * @return                      the content size
+ */
+tb_hize_t                       tb_http_server_session_content_size(tb_http_server_session_ref_t session);
+
+/*! read the request content, it will block the coroutine
+ *
+ * @param session               the session
+ * @param data                  the data
+ * @param size                  the size
+ *
+ * @return                      the real size, 0: end, -1: failed
+ */
+tb_long_t                       tb_http_server_session_read(tb_http_server_session_ref_t session, tb_byte_t* data, tb_size_t size);
+
+/*! set the response head, e.g. "Content-Type"
+ *
+ * @note "Content-Length", "Transfer-Encoding" and "Connection" will be set by the server
+ *
+ * @param session               the session
+ * @param name                  the name
+ * @param value                 the value
+ *
+ * @return                      tb_true or tb_false
+ */
+tb_bool_t                       tb_http_server_session_head_set(tb_http_server_session_ref_t session, tb_char_t const* name, tb_char_t const* value);
+
+/*! send the whole response
+ *
+ * the response will be merged with the next pipelined response and be sent at once
+ *
+ * @param session               the session
+ * @param code                  the response code
+ * @param data                  the content data, maybe null
+ * @param size                  the content size
+ *
+ * @return                      tb_true or tb_false
+ */
+tb_bool_t                       tb_http_server_session_send(tb_http_server_session_ref_t session, tb_size_t code, tb_byte_t const* data, tb_size_t size);
+
+/*! send the file response by sendfile, the opened file and it's info will be cached in the worker
+ *
+ * @param session               the session
+ * @param path                  the file path
+ *
+ * @return                      tb_true or tb_false, the 404 response will be sent if the file is not found
+ */
+tb_bool_t                       tb_http_server_session_send_file(tb_http_server_session_ref_t session, tb_char_t const* path);
+
+/*! write the chunked response data, the response head will be sent at the first time
+ *
+ * @param session               the session
+ * @param data                  the data
+ * @param size                  the size
+ *
+ * @return                      tb_true or tb_false
+ */
+tb_bool_t                       tb_http_server_session_write(tb_http_server_session_ref_t session, tb_byte_t const* data, tb_size_t size);
+
+/*! finish the chunked response, it will be called automatically after returning from the handler
+ *
+ * @param session               the session
+ *
+ * @return                      tb_true or tb_false
+ */
+tb_bool_t                       tb_http_server_session_done(tb_http_server_session_ref_t session);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -0,0 +1,535 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        header.c
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "http_header"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "header.h"
+#include "../../../utils/bits.h"
+#ifdef TB_ARCH_SSE2
+#   include <emmintrin.h>
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+/* the perfect hash of the well-known header name
+ *
+ * it only uses the name size and the first and last characters (lowercase),
+ * and the factors have been chosen for no collision in the 128 slots.
+ */
+#define tb_http_header_hash(name, size) \
+    (((size) + ((((tb_byte_t const*)(name))[0] | 0x20) * 11) + ((((tb_byte_t const*)(name))[(size) - 1] | 0x20) * 9)) & 0x7f)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the well-known header name type
+typedef struct __tb_http_header_name_t
+{
+    // the name
+    tb_char_t const*            name;
+
+    // the name size
+    tb_size_t                   size;
+
+}tb_http_header_name_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the well-known header names, sorted by the header id
+static tb_http_header_name_t const g_http_header_names[] =
+{
+    { tb_null,                  0   }
+,   { "Accept",                 6   }
+,   { "Accept-Charset",         14  }
+,   { "Accept-Encoding",        15  }
+,   { "Accept-Language",        15  }
+,   { "Accept-Ranges",          13  }
+,   { "Age",                    3   }
+,   { "Authorization",          13  }
+,   { "Cache-Control",          13  }
+,   { "Connection",             10  }
+,   { "Content-Disposition",    19  }
+,   { "Content-Encoding",       16  }
+,   { "Content-Language",       16  }
+,   { "Content-Length",         14  }
+,   { "Content-Location",       16  }
+,   { "Content-Range",          13  }
+,   { "Content-Type",           12  }
+,   { "Cookie",                 6   }
+,   { "Date",                   4   }
+,   { "ETag",                   4   }
+,   { "Expect",                 6   }
+,   { "Expires",                7   }
+,   { "Host",                   4   }
+,   { "If-Modified-Since",      17  }
+,   { "If-None-Match",          13  }
+,   { "If-Range",               8   }
+,   { "Keep-Alive",             10  }
+,   { "Last-Modified",          13  }
+,   { "Location",               8   }
+,   { "Pragma",                 6   }
+,   { "Proxy-Authorization",    19  }
+,   { "Range",                  5   }
+,   { "Referer",                7   }
+,   { "Server",                 6   }
+,   { "Set-Cookie",             10  }
+,   { "Transfer-Encoding",      17  }
+,   { "Upgrade",                7   }
+,   { "User-Agent",             10  }
+,   { "Vary",                   4   }
+,   { "Via",                    3   }
+,   { "WWW-Authenticate",       16  }
+,   { "X-Forwarded-For",        15  }
+};
+
+// the header id of the perfect hash slots
+static tb_uint8_t const g_http_header_slots[128] =
+{
+    0,  0,  0,  0,  0,  0,  0,  0, 34,  0, 28,  0,  0,  0,  0,  0
+,   22, 0,  0,  0,  0,  0,  7,  0, 25,  0,  8, 36,  0,  0,  0,  0
+,   0, 23,  0,  0,  0, 37,  0,  0,  0,  9,  0,  0, 35,  0,  0, 14
+,   26, 0, 10,  0,  0, 27,  0,  0, 24, 41, 40,  6,  0,  0,  0, 29
+,   0, 30,  0,  5,  0,  1,  0,  4,  0,  0,  0,  0,  0,  2,  0,  0
+,   0,  0,  0,  0, 17,  0,  0, 38,  0,  3, 16, 15,  0, 18, 12,  0
+,   0,  0,  0,  0,  0,  0,  0,  0,  0, 21,  0,  0,  0,  0,  0, 32
+,   11, 20, 0,  0,  0,  0,  0, 13, 31, 33, 19,  0,  0,  0, 39,  0
+};
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_bool_t tb_http_header_data_grow(tb_http_header_t* header, tb_size_t size)
+{
+    // enough?
+    tb_size_t need = header->data_size + size;
+    tb_check_return_val(need > header->data_maxn, tb_true);
+
+    // check, the offset of entry is 32bits
+    tb_assert_and_check_return_val(need < TB_MAXU32, tb_false);
+
+    // grow the arena
+    tb_size_t maxn = tb_align(need + TB_HTTP_HEADER_DATA_GROW, TB_HTTP_HEADER_DATA_GROW);
+    tb_char_t* data = (tb_char_t*)tb_ralloc(header->data, maxn);
+    tb_assert_and_check_return_val(data, tb_false);
+
+    // trace
+    tb_trace_d("grow arena: %lu => %lu", header->data_maxn, maxn);
+
+    // save it
+    header->data        = data;
+    header->data_maxn   = maxn;
+    return tb_true;
+}
+static tb_size_t tb_http_header_data_cat(tb_http_header_t* header, tb_char_t const* data, tb_size_t size)
+{
+    // grow the arena, and reserve the end character
+    if (!tb_http_header_data_grow(header, size + 1)) return -1;
+
+    // copy it
+    tb_size_t offset = header->data_size;
+    if (size) tb_memcpy(header->data + offset, data, size);
+    header->data[offset + size] = '\0';
+    header->data_size += size + 1;
+    return offset;
+}
+static tb_http_header_entry_t* tb_http_header_entry_add(tb_http_header_t* header)
+{
+    // grow entries
+    if (header->size >= header->maxn)
+    {
+        // check, the index is 16bits
+        tb_assert_and_check_return_val(header->maxn + TB_HTTP_HEADER_ENTRY_GROW < TB_MAXU16, tb_null);
+
+        // grow it
+        tb_size_t               maxn = header->maxn + TB_HTTP_HEADER_ENTRY_GROW;
+        tb_http_header_entry_t* entries = (tb_http_header_entry_t*)tb_ralloc(header->entries, maxn * sizeof(tb_http_header_entry_t));
+        tb_assert_and_check_return_val(entries, tb_null);
+
+        // save it
+        header->entries = entries;
+        header->maxn    = maxn;
+    }
+
+    // add entry
+    tb_http_header_entry_t* entry = &header->entries[header->size++];
+    tb_memset(entry, 0, sizeof(tb_http_header_entry_t));
+    return entry;
+}
+static tb_http_header_entry_t* tb_http_header_entry_find(tb_http_header_t* header, tb_char_t const* name, tb_size_t name_size)
+{
+    // the well-known header? find it from the index
+    tb_size_t id = tb_http_header_id(name, name_size);
+    if (id) return header->index[id]? &header->entries[header->index[id] - 1] : tb_null;
+
+    // find the unknown header
+    tb_size_t i = 0;
+    for (i = 0; i < header->size; i++)
+    {
+        tb_http_header_entry_t* entry = &header->entries[i];
+        if (!entry->id && entry->name_size == name_size && !tb_strnicmp(header->data + entry->name, name, name_size))
+            return entry;
+    }
+    return tb_null;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_bool_t tb_http_header_init(tb_http_header_t* header)
+{
+    // check
+    tb_assert_and_check_return_val(header, tb_false);
+
+    // init it
+    tb_memset(header, 0, sizeof(tb_http_header_t));
+
+    // pre-size entries
+    header->entries = tb_nalloc_type(TB_HTTP_HEADER_ENTRY_GROW, tb_http_header_entry_t);
+    tb_assert_and_check_return_val(header->entries, tb_false);
+    header->maxn = TB_HTTP_HEADER_ENTRY_GROW;
+
+    // pre-size arena
+    header->data = tb_malloc_cstr(TB_HTTP_HEADER_DATA_GROW);
+    tb_assert_and_check_return_val(header->data, tb_false);
+    header->data_maxn = TB_HTTP_HEADER_DATA_GROW;
+
+    // ok
+    return tb_true;
+}
+tb_void_t tb_http_header_exit(tb_http_header_t* header)
+{
+    // check
+    tb_assert_and_check_return(header);
+
+    // exit entries
+    if (header->entries) tb_free(header->entries);
+    header->entries = tb_null;
+
+    // exit arena
+    if (header->data) tb_free(header->data);
+    header->data = tb_null;
+
+    // clear it
+    header->size        = 0;
+    header->maxn        = 0;
+    header->data_size   = 0;
+    header->data_maxn   = 0;
+    header->line        = 0;
+}
+tb_void_t tb_http_header_clear(tb_http_header_t* header)
+{
+    // check
+    tb_assert_and_check_return(header);
+
+    // clear the entries and arena, but keep the memory for the next request
+    header->size        = 0;
+    header->data_size   = 0;
+    header->line        = 0;
+    tb_memset(header->index, 0, sizeof(header->index));
+}
+tb_size_t tb_http_header_id(tb_char_t const* name, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(name, TB_HTTP_HEADER_NONE);
+    tb_check_return_val(size >= 3 && size <= 19, TB_HTTP_HEADER_NONE);
+
+    // get the id of the hash slot
+    tb_size_t id = g_http_header_slots[tb_http_header_hash(name, size)];
+
+    // confirm it
+    return (id && g_http_header_names[id].size == size && !tb_strnicmp(g_http_header_names[id].name, name, size))? id : TB_HTTP_HEADER_NONE;
+}
+tb_char_t const* tb_http_header_name(tb_size_t id)
+{
+    // check
+    tb_assert_and_check_return_val(id && id < TB_HTTP_HEADER_MAXN, tb_null);
+
+    // the name
+    return g_http_header_names[id].name;
+}
+tb_bool_t tb_http_header_set(tb_http_header_t* header, tb_char_t const* name, tb_size_t name_size, tb_char_t const* value, tb_size_t value_size)
+{
+    // check
+    tb_assert_and_check_return_val(header && name && name_size && name_size < TB_MAXU16 && value, tb_false);
+
+    // the well-known header?
+    tb_size_t id = tb_http_header_id(name, name_size);
+    if (id) return tb_http_header_set_id(header, id, value, value_size);
+
+    // copy value
+    tb_size_t offset = tb_http_header_data_cat(header, value, value_size);
+    tb_check_return_val(offset != -1, tb_false);
+
+    // replace it if exists
+    tb_http_header_entry_t* entry = tb_http_header_entry_find(header, name, name_size);
+    if (!entry)
+    {
+        // copy name, maybe the arena will be grown
+        tb_size_t name_offset = tb_http_header_data_cat(header, name, name_size);
+        tb_check_return_val(name_offset != -1, tb_false);
+
+        // add entry
+        entry = tb_http_header_entry_add(header);
+        tb_check_return_val(entry, tb_false);
+        entry->name         = (tb_uint32_t)name_offset;
+        entry->name_size    = (tb_uint16_t)name_size;
+    }
+
+    // save value
+    entry->value        = (tb_uint32_t)offset;
+    entry->value_size   = (tb_uint32_t)value_size;
+    return tb_true;
+}
+tb_bool_t tb_http_header_set_id(tb_http_header_t* header, tb_size_t id, tb_char_t const* value, tb_size_t value_size)
+{
+    // check
+    tb_assert_and_check_return_val(header && id && id < TB_HTTP_HEADER_MAXN && value, tb_false);
+
+    // copy value
+    tb_size_t offset = tb_http_header_data_cat(header, value, value_size);
+    tb_check_return_val(offset != -1, tb_false);
+
+    // add entry if not exists
+    tb_http_header_entry_t* entry = header->index[id]? &header->entries[header->index[id] - 1] : tb_null;
+    if (!entry)
+    {
+        entry = tb_http_header_entry_add(header);
+        tb_check_return_val(entry, tb_false);
+        entry->id           = (tb_uint16_t)id;
+        entry->name_size    = (tb_uint16_t)g_http_header_names[id].size;
+        header->index[id]   = (tb_uint16_t)header->size;
+    }
+
+    // save value
+    entry->value        = (tb_uint32_t)offset;
+    entry->value_size   = (tb_uint32_t)value_size;
+    return tb_true;
+}
+tb_char_t const* tb_http_header_get(tb_http_header_t* header, tb_char_t const* name, tb_size_t name_size, tb_size_t* value_size)
+{
+    // check
+    tb_assert_and_check_return_val(header && name, tb_null);
+
+    // find it
+    tb_http_header_entry_t* entry = tb_http_header_entry_find(header, name, name_size);
+    tb_check_return_val(entry, tb_null);
+
+    // the value
+    if (value_size) *value_size = entry->value_size;
+    return header->data + entry->value;
+}
+tb_char_t const* tb_http_header_get_id(tb_http_header_t* header, tb_size_t id, tb_size_t* value_size)
+{
+    // check
+    tb_assert_and_check_return_val(header && id && id < TB_HTTP_HEADER_MAXN, tb_null);
+
+    // find it
+    tb_size_t index = header->index[id];
+    tb_check_return_val(index, tb_null);
+
+    // the value
+    tb_http_header_entry_t* entry = &header->entries[index - 1];
+    if (value_size) *value_size = entry->value_size;
+    return header->data + entry->value;
+}
+tb_void_t tb_http_header_remove_id(tb_http_header_t* header, tb_size_t id)
+{
+    // check
+    tb_assert_and_check_return(header && id && id < TB_HTTP_HEADER_MAXN);
+
+    // exists?
+    tb_size_t index = header->index[id];
+    tb_check_return(index);
+
+    // remove it and keep the order of the left entries, the value will be freed after clearing the arena
+    if (index < header->size) tb_memmov(&header->entries[index - 1], &header->entries[index], (header->size - index) * sizeof(tb_http_header_entry_t));
+    header->size--;
+    header->index[id] = 0;
+
+    // update the index of the moved entries
+    tb_size_t i = 0;
+    for (i = 0; i < TB_HTTP_HEADER_MAXN; i++)
+    {
+        if (header->index[i] > index) header->index[i]--;
+    }
+}
+tb_size_t tb_http_header_size(tb_http_header_t* header)
+{
+    // check
+    tb_assert_and_check_return_val(header, 0);
+
+    // "name: value\r\n"
+    tb_size_t i = 0;
+    tb_size_t size = 0;
+    for (i = 0; i < header->size; i++)
+        size += header->entries[i].name_size + header->entries[i].value_size + 4;
+    return size;
+}
+tb_size_t tb_http_header_copy(tb_http_header_t* header, tb_char_t* data)
+{
+    // check
+    tb_assert_and_check_return_val(header && data, 0);
+
+    // copy "name: value\r\n"
+    tb_size_t   i = 0;
+    tb_char_t*  p = data;
+    for (i = 0; i < header->size; i++)
+    {
+        // the entry
+        tb_http_header_entry_t const* entry = &header->entries[i];
+
+        // copy name
+        tb_memcpy(p, entry->id? g_http_header_names[entry->id].name : header->data + entry->name, entry->name_size);
+        p += entry->name_size;
+        *p++ = ':';
+        *p++ = ' ';
+
+        // copy value
+        tb_memcpy(p, header->data + entry->value, entry->value_size);
+        p += entry->value_size;
+        *p++ = '\r';
+        *p++ = '\n';
+    }
+    return p - data;
+}
+tb_size_t tb_http_header_scan(tb_char_t const* data, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(data, size);
+
+    // done
+    tb_byte_t const* p = (tb_byte_t const*)data;
+    tb_byte_t const* e = p + size;
+#ifdef TB_ARCH_SSE2
+    // scan 16 bytes at once
+    __m128i const lf = _mm_set1_epi8('\n');
+    while (p + 16 <= e)
+    {
+        tb_uint32_t mask = (tb_uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((__m128i const*)p), lf));
+        if (mask) return (p - (tb_byte_t const*)data) + tb_bits_fb1_u32_le(mask);
+        p += 16;
+    }
+#else
+    // align it
+    while (p < e && (((tb_size_t)p) & (sizeof(tb_size_t) - 1)))
+    {
+        if (*p == '\n') return p - (tb_byte_t const*)data;
+        p++;
+    }
+
+    // scan one word at once, the word has a zero byte if ((x - 0x01..) & ~x & 0x80..)
+    tb_size_t const ones = (tb_size_t)-1 / 0xff;
+    tb_size_t const lf = ones * '\n';
+    while (p + sizeof(tb_size_t) <= e)
+    {
+        tb_size_t x = *((tb_size_t const*)p) ^ lf;
+        if ((x - ones) & ~x & (ones << 7)) break;
+        p += sizeof(tb_size_t);
+    }
+#endif
+
+    // scan the left bytes
+    while (p < e && *p != '\n') p++;
+    return p - (tb_byte_t const*)data;
+}
+tb_bool_t tb_http_header_line_cat(tb_http_header_t* header, tb_char_t const* data, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(header && data, tb_false);
+
+    // grow the arena
+    if (!tb_http_header_data_grow(header, size)) return tb_false;
+
+    // append it
+    tb_memcpy(header->data + header->data_size, data, size);
+    header->data_size += size;
+    return tb_true;
+}
+tb_char_t* tb_http_header_line_done(tb_http_header_t* header, tb_size_t* size)
+{
+    // check
+    tb_assert_and_check_return_val(header && header->line <= header->data_size, tb_null);
+
+    // reserve the end character
+    if (!tb_http_header_data_grow(header, 1)) return tb_null;
+
+    // remove the trailing "\r\n"
+    tb_char_t*  line = header->data + header->line;
+    tb_size_t   n = header->data_size - header->line;
+    if (n && line[n - 1] == '\n') n--;
+    if (n && line[n - 1] == '\r') n--;
+    line[n] = '\0';
+
+    // start the next line
+    header->data_size = header->line + n + 1;
+    header->line = header->data_size;
+
+    // ok
+    if (size) *size = n;
+    return line;
+}
+tb_size_t tb_http_header_line_load(tb_http_header_t* header, tb_char_t* line, tb_size_t size, tb_char_t const** value)
+{
+    // check
+    tb_assert_and_check_return_val(header && line && line >= header->data && line + size < header->data + header->data_size, TB_HTTP_HEADER_MAXN);
+
+    // seek to ':'
+    tb_char_t* p = line;
+    tb_char_t* e = line + size;
+    while (p < e && *p != ':') p++;
+    tb_check_return_val(p < e && p > line && p - line < TB_MAXU16, TB_HTTP_HEADER_MAXN);
+
+    // the name
+    tb_size_t id = tb_http_header_id(line, p - line);
+    tb_size_t name_size = p - line;
+
+    // the value, skip the leading and trailing spaces
+    p++; while (p < e && tb_isspace(*p)) p++;
+    while (e > p && tb_isspace(e[-1])) e--;
+    *e = '\0';
+
+    // add entry
+    tb_http_header_entry_t* entry = tb_http_header_entry_add(header);
+    tb_check_return_val(entry, TB_HTTP_HEADER_MAXN);
+    entry->id           = (tb_uint16_t)id;
+    entry->name         = (tb_uint32_t)(line - header->data);
+    entry->name_size    = (tb_uint16_t)name_size;
+    entry->value        = (tb_uint32_t)(p - header->data);
+    entry->value_size   = (tb_uint32_t)(e - p);
+
+    // index the first well-known header
+    if (id && !header->index[id]) header->index[id] = (tb_uint16_t)header->size;
+
+    // ok
+    if (value) *value = p;
+    return id;
+}
@@ -0,0 +1,311 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        header.h
+ *
+ */
+#ifndef TB_NETWORK_IMPL_HTTP_HEADER_H
+#define TB_NETWORK_IMPL_HTTP_HEADER_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the pre-sized entry count of the header
+#ifdef __tb_small__
+#   define TB_HTTP_HEADER_ENTRY_GROW        (16)
+#else
+#   define TB_HTTP_HEADER_ENTRY_GROW        (32)
+#endif
+
+// the pre-sized arena size of the header
+#ifdef __tb_small__
+#   define TB_HTTP_HEADER_DATA_GROW         (1024)
+#else
+#   define TB_HTTP_HEADER_DATA_GROW         (4096)
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the well-known http header id enum, sorted by name
+typedef enum __tb_http_header_id_e
+{
+    TB_HTTP_HEADER_NONE                 = 0     //!< the unknown header
+,   TB_HTTP_HEADER_ACCEPT               = 1
+,   TB_HTTP_HEADER_ACCEPT_CHARSET       = 2
+,   TB_HTTP_HEADER_ACCEPT_ENCODING      = 3
+,   TB_HTTP_HEADER_ACCEPT_LANGUAGE      = 4
+,   TB_HTTP_HEADER_ACCEPT_RANGES        = 5
+,   TB_HTTP_HEADER_AGE                  = 6
+,   TB_HTTP_HEADER_AUTHORIZATION        = 7
+,   TB_HTTP_HEADER_CACHE_CONTROL        = 8
+,   TB_HTTP_HEADER_CONNECTION           = 9
+,   TB_HTTP_HEADER_CONTENT_DISPOSITION  = 10
+,   TB_HTTP_HEADER_CONTENT_ENCODING     = 11
+,   TB_HTTP_HEADER_CONTENT_LANGUAGE     = 12
+,   TB_HTTP_HEADER_CONTENT_LENGTH       = 13
+,   TB_HTTP_HEADER_CONTENT_LOCATION     = 14
+,   TB_HTTP_HEADER_CONTENT_RANGE        = 15
+,   TB_HTTP_HEADER_CONTENT_TYPE         = 16
+,   TB_HTTP_HEADER_COOKIE               = 17
+,   TB_HTTP_HEADER_DATE                 = 18
+,   TB_HTTP_HEADER_ETAG                 = 19
+,   TB_HTTP_HEADER_EXPECT               = 20
+,   TB_HTTP_HEADER_EXPIRES              = 21
+,   TB_HTTP_HEADER_HOST                 = 22
+,   TB_HTTP_HEADER_IF_MODIFIED_SINCE    = 23
+,   TB_HTTP_HEADER_IF_NONE_MATCH        = 24
+,   TB_HTTP_HEADER_IF_RANGE             = 25
+,   TB_HTTP_HEADER_KEEP_ALIVE           = 26
+,   TB_HTTP_HEADER_LAST_MODIFIED        = 27
+,   TB_HTTP_HEADER_LOCATION             = 28
+,   TB_HTTP_HEADER_PRAGMA               = 29
+,   TB_HTTP_HEADER_PROXY_AUTHORIZATION  = 30
+,   TB_HTTP_HEADER_RANGE                = 31
+,   TB_HTTP_HEADER_REFERER              = 32
+,   TB_HTTP_HEADER_SERVER               = 33
+,   TB_HTTP_HEADER_SET_COOKIE           = 34
+,   TB_HTTP_HEADER_TRANSFER_ENCODING    = 35
+,   TB_HTTP_HEADER_UPGRADE              = 36
+,   TB_HTTP_HEADER_USER_AGENT           = 37
+,   TB_HTTP_HEADER_VARY                 = 38
+,   TB_HTTP_HEADER_VIA                  = 39
+,   TB_HTTP_HEADER_WWW_AUTHENTICATE     = 40
+,   TB_HTTP_HEADER_X_FORWARDED_FOR      = 41
+,   TB_HTTP_HEADER_MAXN                 = 42
+
+}tb_http_header_id_e;
+
+// the http header entry type, the name and value are the slices of the header arena
+typedef struct __tb_http_header_entry_t
+{
+    // the header id
+    tb_uint16_t                 id;
+
+    // the name size
+    tb_uint16_t                 name_size;
+
+    // the name offset, only for the unknown header
+    tb_uint32_t                 name;
+
+    // the value offset
+    tb_uint32_t                 value;
+
+    // the value size
+    tb_uint32_t                 value_size;
+
+}tb_http_header_entry_t;
+
+/* the http header type
+ *
+ * all names and values are stored in one arena and will be cleared at once for the next request,
+ * the entries and arena are pre-sized and only grow for the large header.
+ */
+typedef struct __tb_http_header_t
+{
+    // the entries
+    tb_http_header_entry_t*     entries;
+
+    // the entry count
+    tb_size_t                   size;
+
+    // the entry maxn
+    tb_size_t                   maxn;
+
+    // the arena data
+    tb_char_t*                  data;
+
+    // the arena size
+    tb_size_t                   data_size;
+
+    // the arena maxn
+    tb_size_t                   data_maxn;
+
+    // the offset of the current line which is being loaded
+    tb_size_t                   line;
+
+    // the entry index + 1 of the well-known headers
+    tb_uint16_t                 index[TB_HTTP_HEADER_MAXN];
+
+}tb_http_header_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/* init header
+ *
+ * @param header        the header
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_http_header_init(tb_http_header_t* header);
+
+/* exit header
+ *
+ * @param header        the header
+ */
+tb_void_t               tb_http_header_exit(tb_http_header_t* header);
+
+/* clear header and keep the pre-sized arena
+ *
+ * @param header        the header
+ */
+tb_void_t               tb_http_header_clear(tb_http_header_t* header);
+
+/* get the header id from the case-insensitive name
+ *
+ * @param name          the name
+ * @param size          the name size
+ *
+ * @return              the header id, TB_HTTP_HEADER_NONE if it is unknown
+ */
+tb_size_t               tb_http_header_id(tb_char_t const* name, tb_size_t size);
+
+/* get the canonical name of the header id
+ *
+ * @param id            the header id
+ *
+ * @return              the name
+ */
+tb_char_t const*        tb_http_header_name(tb_size_t id);
+
+/* set the header value, the old value will be replaced
+ *
+ * @param header        the header
+ * @param name          the name
+ * @param name_size     the name size
+ * @param value         the value
+ * @param value_size    the value size
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_http_header_set(tb_http_header_t* header, tb_char_t const* name, tb_size_t name_size, tb_char_t const* value, tb_size_t value_size);
+
+/* set the well-known header value, the old value will be replaced
+ *
+ * @param header        the header
+ * @param id            the header id
+ * @param value         the value
+ * @param value_size    the value size
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_http_header_set_id(tb_http_header_t* header, tb_size_t id, tb_char_t const* value, tb_size_t value_size);
+
+/* get the header value
+ *
+ * @param header        the header
+ * @param name          the name
+ * @param name_size     the name size
+ * @param value_size    the value size, optional
+ *
+ * @return              the value, tb_null if not found
+ */
+tb_char_t const*        tb_http_header_get(tb_http_header_t* header, tb_char_t const* name, tb_size_t name_size, tb_size_t* value_size);
+
+/* get the well-known header value
+ *
+ * @param header        the header
+ * @param id            the header id
+ * @param value_size    the value size, optional
+ *
+ * @return              the value, tb_null if not found
+ */
+tb_char_t const*        tb_http_header_get_id(tb_http_header_t* header, tb_size_t id, tb_size_t* value_size);
+
+/* remove the well-known header
+ *
+ * @param header        the header
+ * @param id            the header id
+ */
+tb_void_t               tb_http_header_remove_id(tb_http_header_t* header, tb_size_t id);
+
+/* get the serialized size of all headers, "name: value\r\n" ...
+ *
+ * @param header        the header
+ *
+ * @return              the size
+ */
+tb_size_t               tb_http_header_size(tb_http_header_t* header);
+
+/* serialize all headers to the given data without any allocation
+ *
+ * @param header        the header
+ * @param data          the data, it's size must be larger than tb_http_header_size()
+ *
+ * @return              the written size
+ */
+tb_size_t               tb_http_header_copy(tb_http_header_t* header, tb_char_t* data);
+
+/* scan the line end
+ *
+ * @param data          the data
+ * @param size          the data size
+ *
+ * @return              the position of '\n', return size if not found
+ */
+tb_size_t               tb_http_header_scan(tb_char_t const* data, tb_size_t size);
+
+/* append data to the current line in the arena
+ *
+ * @param header        the header
+ * @param data          the data
+ * @param size          the data size
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_http_header_line_cat(tb_http_header_t* header, tb_char_t const* data, tb_size_t size);
+
+/* finish the current line, the trailing "\r\n" will be removed
+ *
+ * @param header        the header
+ * @param size          the line size
+ *
+ * @return              the line terminated by '\0', it will be invalid after appending the next line
+ */
+tb_char_t*              tb_http_header_line_done(tb_http_header_t* header, tb_size_t* size);
+
+/* load the header entry from the line "name: value" which is in the arena
+ *
+ * @param header        the header
+ * @param line          the line from tb_http_header_line_done()
+ * @param size          the line size
+ * @param value         the value terminated by '\0'
+ *
+ * @return              the header id, TB_HTTP_HEADER_MAXN if the line is invalid
+ */
+tb_size_t               tb_http_header_line_load(tb_http_header_t* header, tb_char_t* line, tb_size_t size, tb_char_t const** value);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -36,5 +36,8 @@
 #include "http.h"
 #include "cookies.h"
 #include "dns/dns.h"
+#ifdef TB_CONFIG_MODULE_HAVE_COROUTINE
+#   include "http_server.h"
+#endif
 
 #endif
@@ -134,7 +134,7 @@ static tb_object_ref_t tb_oc_json_reader_func_array(tb_oc_json_reader_t* reader,
 
             // read item
             tb_object_ref_t item = func(reader, ch);
-            tb_assert_and_check_break_state(item, ok, tb_false);
+            tb_check_break_state(item, ok, tb_false);
 
             // append item
             tb_oc_array_append(array, item);
@@ -269,6 +269,9 @@ static tb_object_ref_t tb_oc_json_reader_func_number(tb_oc_json_reader_t* reader
                 break;
             }
 
+            // has exponent? it is float too, e.g. 1e+10
+            if (ch == 'e' || ch == 'E') bf = tb_true;
+
             // append character
             if (tb_isdigit10(ch) || ch == '.' || ch == 'e' || ch == 'E' || ch == '-' || ch == '+')
                 tb_static_string_chrcat(&data, ch);
@@ -287,16 +290,26 @@ static tb_object_ref_t tb_oc_json_reader_func_number(tb_oc_json_reader_t* reader
         // trace
         tb_trace_d("number: %s", tb_static_string_cstr(&data));
 
+        // the number string, we parse it directly without the null-terminated string
+        tb_char_t const*    cstr = tb_static_string_cstr(&data);
+        tb_size_t           size = tb_static_string_size(&data);
+
         // init number
 #ifdef TB_CONFIG_TYPE_HAVE_FLOAT
-        if (bf) number = tb_oc_number_init_from_float(tb_stof(tb_static_string_cstr(&data)));
+        if (bf)
+        {
+            tb_double_t value = 0;
+            tb_check_break(tb_s10tod_n(cstr, size, &value) == size);
+            number = tb_oc_number_init_from_double(value);
+        }
 #else
         if (bf) tb_trace_noimpl();
 #endif
         else if (bs)
         {
-            tb_sint64_t value = tb_stoi64(tb_static_string_cstr(&data));
-            tb_size_t   bytes = tb_object_need_bytes(-value);
+            tb_uint64_t value = 0;
+            tb_check_break(tb_s10tou64_n(cstr, size, &value) == size);
+            tb_size_t   bytes = tb_object_need_bytes(-(tb_sint64_t)value);
             switch (bytes)
             {
             case 1: number = tb_oc_number_init_from_sint8((tb_sint8_t)value); break;
@@ -309,7 +322,8 @@ static tb_object_ref_t tb_oc_json_reader_func_number(tb_oc_json_reader_t* reader
         }
         else
         {
-            tb_uint64_t value = tb_stou64(tb_static_string_cstr(&data));
+            tb_uint64_t value = 0;
+            tb_check_break(tb_s10tou64_n(cstr, size, &value) == size);
             tb_size_t   bytes = tb_object_need_bytes(value);
             switch (bytes)
             {
@@ -442,7 +456,7 @@ static tb_object_ref_t tb_oc_json_reader_func_dictionary(tb_oc_json_reader_t* re
 
                 // read val
                 tb_object_ref_t val = func(reader, ch);
-                tb_assert_and_check_break_state(val, ok, tb_false);
+                tb_check_break_state(val, ok, tb_false);
 
                 // set key => val
                 tb_oc_dictionary_insert(dictionary, tb_static_string_cstr(&kname), val);
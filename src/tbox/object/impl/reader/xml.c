@@ -378,24 +378,44 @@ static tb_object_ref_t tb_oc_xml_reader_func_number(tb_oc_xml_reader_t* reader,
                 tb_assert_and_check_break_state(text, leave, tb_true);
                 tb_trace_d("number: %s", text);
 
-                // has sign? is float?
+                // skip spaces
+                while (tb_isspace(*text)) text++;
+
+                // is hex or binary? e.g. 0x1e, -0x1e, 0b101
+                tb_char_t const* h = (*text == '-' || *text == '+')? text + 1 : text;
+                tb_size_t x = (h[0] == '0' && (h[1] == 'x' || h[1] == 'X' || h[1] == 'b' || h[1] == 'B'))? 1 : 0;
+
+                // has sign? is float? and get the text size
                 tb_size_t s = 0;
                 tb_size_t f = 0;
                 tb_char_t const* p = text;
                 for (; *p; p++)
                 {
                     if (!s && *p == '-') s = 1;
-                    if (!f && *p == '.') f = 1;
-                    if (s && f) break;
+                    if (!x && !f && (*p == '.' || *p == 'e' || *p == 'E')) f = 1;
                 }
 
+                // is octal integer? e.g. 017
+                if (!f && h[0] == '0' && tb_isdigit10(h[1])) x = 1;
+
                 // number
+                if (x) number = s? tb_oc_number_init_from_sint64(tb_stoi64(text)) : tb_oc_number_init_from_uint64(tb_stou64(text));
 #ifdef TB_CONFIG_TYPE_HAVE_FLOAT
-                if (f) number = tb_oc_number_init_from_double(tb_atof(text));
+                else if (f)
+                {
+                    tb_double_t value = 0;
+                    tb_s10tod_n(text, p - text, &value);
+                    number = tb_oc_number_init_from_double(value);
+                }
 #else
-                if (f) tb_trace_noimpl();
+                else if (f) tb_trace_noimpl();
 #endif
-                else number = s? tb_oc_number_init_from_sint64(tb_stoi64(text)) : tb_oc_number_init_from_uint64(tb_stou64(text));
+                else
+                {
+                    tb_uint64_t value = 0;
+                    tb_s10tou64_n(text, p - text, &value);
+                    number = s? tb_oc_number_init_from_sint64((tb_sint64_t)value) : tb_oc_number_init_from_uint64(value);
+                }
                 tb_assert_and_check_break_state(number, leave, tb_true);
             }
             break;
@@ -24,10 +24,123 @@
  */
 #include "prefix.h"
 #include "cpu.h"
+#include "atomic.h"
+#if defined(TB_ARCH_x86) || defined(TB_ARCH_x64)
+#   if defined(TB_COMPILER_IS_MSVC)
+#       include <intrin.h>
+#   elif defined(TB_COMPILER_IS_GCC) || defined(TB_COMPILER_IS_CLANG)
+#       include <cpuid.h>
+#       define TB_CPU_HAVE_CPUID
+#   endif
+#elif defined(TB_ARCH_ARM64) && (defined(TB_CONFIG_OS_LINUX) || defined(TB_CONFIG_OS_ANDROID))
+#   include <sys/auxv.h>
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the features have been detected
+#define TB_CPU_FEATURE_DETECTED     ((tb_size_t)1 << (sizeof(tb_size_t) * 8 - 1))
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the detected features
+static tb_atomic_t  g_cpu_features = 0;
+
+// the disabled features
+static tb_atomic_t  g_cpu_features_disabled = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+#if defined(TB_ARCH_x86) || defined(TB_ARCH_x64)
+static tb_bool_t tb_cpu_cpuid(tb_uint32_t leaf, tb_uint32_t subleaf, tb_uint32_t regs[4])
+{
+#if defined(TB_COMPILER_IS_MSVC)
+    tb_int_t info[4];
+    __cpuidex(info, (tb_int_t)leaf, (tb_int_t)subleaf);
+    regs[0] = info[0]; regs[1] = info[1]; regs[2] = info[2]; regs[3] = info[3];
+    return tb_true;
+#elif defined(TB_CPU_HAVE_CPUID)
+    return __get_cpuid_count(leaf, subleaf, &regs[0], &regs[1], &regs[2], &regs[3])? tb_true : tb_false;
+#else
+    return tb_false;
+#endif
+}
+static tb_uint64_t tb_cpu_xgetbv()
+{
+#if defined(TB_COMPILER_IS_MSVC)
+    return _xgetbv(0);
+#elif defined(TB_CPU_HAVE_CPUID)
+    tb_uint32_t eax, edx;
+    __tb_asm__ __tb_volatile__ (".byte 0x0f, 0x01, 0xd0" : "=a" (eax), "=d" (edx) : "c" (0));
+    return ((tb_uint64_t)edx << 32) | eax;
+#else
+    return 0;
+#endif
+}
+#endif
+static tb_size_t tb_cpu_features_detect()
+{
+    tb_size_t features = TB_CPU_FEATURE_NONE;
+#if defined(TB_ARCH_x86) || defined(TB_ARCH_x64)
+    tb_uint32_t regs[4];
+    if (tb_cpu_cpuid(0, 0, regs))
+    {
+        tb_uint32_t maxleaf = regs[0];
+        if (maxleaf >= 1 && tb_cpu_cpuid(1, 0, regs))
+        {
+            if (regs[3] & (1 << 26)) features |= TB_CPU_FEATURE_SSE2;
+            if (regs[2] & (1 << 9)) features |= TB_CPU_FEATURE_SSSE3;
+            if (regs[2] & (1 << 19)) features |= TB_CPU_FEATURE_SSE41;
+
+            // the os has enabled the xmm and ymm states? (osxsave and xcr0)
+            tb_bool_t ymm = (regs[2] & (1 << 27)) && (tb_cpu_xgetbv() & 0x6) == 0x6;
+            if (maxleaf >= 7 && tb_cpu_cpuid(7, 0, regs))
+            {
+                if (ymm && (regs[1] & (1 << 5))) features |= TB_CPU_FEATURE_AVX2;
+                if (regs[1] & (1 << 29)) features |= TB_CPU_FEATURE_SHA;
+            }
+        }
+    }
+#elif defined(TB_ARCH_ARM64)
+    features |= TB_CPU_FEATURE_NEON;
+#   if defined(TB_CONFIG_OS_LINUX) || defined(TB_CONFIG_OS_ANDROID)
+    // HWCAP_SHA1 and HWCAP_SHA2
+    tb_size_t hwcap = (tb_size_t)getauxval(AT_HWCAP);
+    if (hwcap & (1 << 5)) features |= TB_CPU_FEATURE_SHA1;
+    if (hwcap & (1 << 6)) features |= TB_CPU_FEATURE_SHA2;
+#   elif defined(TB_CONFIG_OS_MACOSX) || defined(TB_CONFIG_OS_IOS)
+    // all apple arm64 chips have the crypto extensions
+    features |= TB_CPU_FEATURE_SHA1 | TB_CPU_FEATURE_SHA2;
+#   endif
+#elif defined(TB_ARCH_ARM_NEON)
+    features |= TB_CPU_FEATURE_NEON;
+#endif
+    return features;
+}
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
+tb_size_t tb_cpu_features()
+{
+    // detect features only once, it is not a problem if multiple threads detect them at the same time
+    tb_size_t features = (tb_size_t)tb_atomic_get(&g_cpu_features);
+    if (!(features & TB_CPU_FEATURE_DETECTED))
+    {
+        features = tb_cpu_features_detect() | TB_CPU_FEATURE_DETECTED;
+        tb_atomic_set(&g_cpu_features, (tb_long_t)features);
+    }
+    return (features & ~TB_CPU_FEATURE_DETECTED) & ~(tb_size_t)tb_atomic_get(&g_cpu_features_disabled);
+}
+tb_void_t tb_cpu_features_disable(tb_size_t features)
+{
+    tb_atomic_set(&g_cpu_features_disabled, (tb_long_t)features);
+}
 #if defined(TB_CONFIG_OS_WINDOWS)
 #   include "windows/cpu.c"
 #elif defined(TB_CONFIG_POSIX_HAVE_SYSCONF)
@@ -73,6 +73,25 @@
  */
 __tb_extern_c_enter__
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the cpu feature enum
+typedef enum __tb_cpu_feature_e
+{
+    TB_CPU_FEATURE_NONE     = 0
+,   TB_CPU_FEATURE_SSE2     = 1         //!< x86: sse2
+,   TB_CPU_FEATURE_SSSE3    = 2         //!< x86: ssse3
+,   TB_CPU_FEATURE_SSE41    = 4         //!< x86: sse4.1
+,   TB_CPU_FEATURE_AVX2     = 8         //!< x86: avx2, and the os supports the ymm registers
+,   TB_CPU_FEATURE_SHA      = 16        //!< x86: the sha extensions (sha-ni)
+,   TB_CPU_FEATURE_NEON     = 32        //!< arm: neon (asimd)
+,   TB_CPU_FEATURE_SHA1     = 64        //!< arm: the armv8 sha1 crypto extensions
+,   TB_CPU_FEATURE_SHA2     = 128       //!< arm: the armv8 sha2 crypto extensions
+
+}tb_cpu_feature_e;
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
@@ -83,6 +102,21 @@ __tb_extern_c_enter__
  */
 tb_size_t               tb_cpu_count(tb_noarg_t);
 
+/*! the cpu features detected at runtime
+ *
+ * @return              the cpu features, e.g. TB_CPU_FEATURE_SSE2 | TB_CPU_FEATURE_AVX2
+ */
+tb_size_t               tb_cpu_features(tb_noarg_t);
+
+/*! disable the given cpu features
+ *
+ * the accelerated implementations will not use them after disabling,
+ * it is used to test and benchmark the fallback implementations.
+ *
+ * @param features      the disabled cpu features, TB_CPU_FEATURE_NONE will enable all features
+ */
+tb_void_t               tb_cpu_features_disable(tb_size_t features);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
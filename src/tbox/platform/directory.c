@@ -72,3 +72,106 @@ tb_bool_t tb_directory_copy(tb_char_t const* path, tb_char_t const* dest)
     return tb_false;
 }
 #endif
+
+#if !(defined(TB_CONFIG_OS_WINDOWS) && !defined(TB_COMPILER_LIKE_UNIX)) \
+    && defined(TB_CONFIG_POSIX_HAVE_OPENDIR) \
+    && defined(TB_CONFIG_POSIX_HAVE_OPENAT) \
+    && defined(TB_CONFIG_POSIX_HAVE_FSTATAT) \
+    && defined(TB_CONFIG_POSIX_HAVE_FDOPENDIR)
+#   include "posix/directory_walk.c"
+#else
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the entries count of each batch
+#ifdef __tb_small__
+#   define TB_DIRECTORY_WALK_BATCH_MAXN     (16)
+#else
+#   define TB_DIRECTORY_WALK_BATCH_MAXN     (64)
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the batch walker type, it is serial and always gets the whole file info
+typedef struct __tb_directory_walk_batch_t
+{
+    // the callback func
+    tb_directory_walk_batch_func_t  func;
+
+    // the callback priv
+    tb_cpointer_t                   priv;
+
+    // is stopped?
+    tb_bool_t                       stop;
+
+    // the entries count
+    tb_size_t                       count;
+
+    // the entries
+    tb_directory_entry_t            entries[TB_DIRECTORY_WALK_BATCH_MAXN];
+
+}tb_directory_walk_batch_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_void_t tb_directory_walk_batch_emit(tb_directory_walk_batch_t* batch)
+{
+    // do callback
+    if (batch->count && !batch->stop && !batch->func(batch->entries, batch->count, batch->priv))
+        batch->stop = tb_true;
+
+    // free the copied paths
+    while (batch->count) tb_free((tb_pointer_t)batch->entries[--batch->count].path);
+}
+static tb_bool_t tb_directory_walk_batch_item(tb_char_t const* path, tb_file_info_t const* info, tb_cpointer_t priv)
+{
+    // check
+    tb_directory_walk_batch_t* batch = (tb_directory_walk_batch_t*)priv;
+    tb_assert_and_check_return_val(batch && path && info, tb_false);
+
+    // copy path
+    tb_char_t* data = tb_strdup(path);
+    tb_assert_and_check_return_val(data, tb_false);
+
+    // save entry
+    tb_char_t const*        name = tb_strrchr(data, '/');
+    tb_directory_entry_t*   entry = &batch->entries[batch->count++];
+#if defined(TB_CONFIG_OS_WINDOWS) && !defined(TB_COMPILER_LIKE_UNIX)
+    if (!name) name = tb_strrchr(data, '\\');
+#endif
+    entry->path = data;
+    entry->name = name? name + 1 : data;
+    entry->info = *info;
+
+    // pass the full batch
+    if (batch->count == TB_DIRECTORY_WALK_BATCH_MAXN) tb_directory_walk_batch_emit(batch);
+    return !batch->stop;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_void_t tb_directory_walk_batch(tb_char_t const* path, tb_long_t recursion, tb_size_t flags, tb_directory_walk_batch_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_assert_and_check_return(path && func);
+
+    // init batch
+    tb_directory_walk_batch_t batch;
+    batch.func  = func;
+    batch.priv  = priv;
+    batch.stop  = tb_false;
+    batch.count = 0;
+
+    // walk it in the current thread
+    tb_directory_walk(path, recursion, (flags & TB_DIRECTORY_WALK_FLAG_PREFIX)? tb_true : tb_false, tb_directory_walk_batch_item, &batch);
+
+    // pass the remaining entries
+    tb_directory_walk_batch_emit(&batch);
+}
+#endif
@@ -47,6 +47,40 @@ __tb_extern_c_enter__
  */
 typedef tb_bool_t       (*tb_directory_walk_func_t)(tb_char_t const* path, tb_file_info_t const* info, tb_cpointer_t priv);
 
+/// the directory walk flag enum
+typedef enum __tb_directory_walk_flag_e
+{
+    TB_DIRECTORY_WALK_FLAG_NONE     = 0     //!< postfix recursion, the directory is after all files in it
+,   TB_DIRECTORY_WALK_FLAG_PREFIX   = 1     //!< prefix recursion, the directory is before all files in it
+,   TB_DIRECTORY_WALK_FLAG_TYPEONLY = 2     //!< only get the file type if the file system has it, the other file info may be zero
+,   TB_DIRECTORY_WALK_FLAG_PARALLEL = 4     //!< walk the subdirectories in the thread pool, the callback may be called in the worker threads at the same time
+
+}tb_directory_walk_flag_e;
+
+/// the directory entry type
+typedef struct __tb_directory_entry_t
+{
+    /// the file path
+    tb_char_t const*        path;
+
+    /// the file name in the file path
+    tb_char_t const*        name;
+
+    /// the file info
+    tb_file_info_t          info;
+
+}tb_directory_entry_t;
+
+/*! the directory walk batch func type
+ *
+ * @param entries       the directory entries, they are only valid in this callback
+ * @param count         the entries count
+ * @param priv          the user private data
+ *
+ * @return              continue: tb_true, break: tb_false
+ */
+typedef tb_bool_t       (*tb_directory_walk_batch_func_t)(tb_directory_entry_t const* entries, tb_size_t count, tb_cpointer_t priv);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
@@ -113,6 +147,33 @@ tb_size_t               tb_directory_temporary(tb_char_t* path, tb_size_t maxn);
  */
 tb_void_t               tb_directory_walk(tb_char_t const* path, tb_long_t recursion, tb_bool_t prefix, tb_directory_walk_func_t func, tb_cpointer_t priv);
 
+/*! the directory walk with the batch callback
+ *
+ * it opens the subdirectories relative to the parent directory and does not stat the file if the file type is known
+ * and TB_DIRECTORY_WALK_FLAG_TYPEONLY is set, so it is much faster than tb_directory_walk() for the large directory tree.
+ *
+ * the entries of one directory are passed in order, but the different directories may be walked in any order,
+ * and the callback must be thread-safe if TB_DIRECTORY_WALK_FLAG_PARALLEL is set.
+ *
+ * @code
+    static tb_bool_t tb_directory_walk_batch_func(tb_directory_entry_t const* entries, tb_size_t count, tb_cpointer_t priv)
+    {
+        tb_size_t i;
+        for (i = 0; i < count; i++)
+            tb_trace_i("%s: %s", entries[i].info.type == TB_FILE_TYPE_DIRECTORY? "dir" : "file", entries[i].path);
+        return tb_true;
+    }
+    tb_directory_walk_batch("/tmp", -1, TB_DIRECTORY_WALK_FLAG_TYPEONLY | TB_DIRECTORY_WALK_FLAG_PARALLEL, tb_directory_walk_batch_func, tb_null);
+ * @endcode
+ *
+ * @param path          the directory path
+ * @param recursion     the recursion level, 0, 1, 2, .. or -1 (infinite)
+ * @param flags         the walk flags, e.g. TB_DIRECTORY_WALK_FLAG_PREFIX | TB_DIRECTORY_WALK_FLAG_TYPEONLY
+ * @param func          the callback func
+ * @param priv          the callback priv
+ */
+tb_void_t               tb_directory_walk_batch(tb_char_t const* path, tb_long_t recursion, tb_size_t flags, tb_directory_walk_batch_func_t func, tb_cpointer_t priv);
+
 /*! copy directory
  *
  * @param path          the directory path
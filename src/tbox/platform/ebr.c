@@ -0,0 +1,404 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        ebr.c
+ * @ingroup     platform
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "ebr"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "ebr.h"
+#include "sched.h"
+#include "atomic.h"
+#include "thread_local.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the retired count of the current thread to try reclaiming them
+#define TB_EBR_RETIRED_GROW         (64)
+
+// the maximum count of the cached free nodes for each thread
+#define TB_EBR_NODE_CACHE_MAXN      (256)
+
+// the active flag of the record state, the state is (epoch << 1) | active
+#define TB_EBR_STATE_ACTIVE         (1)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the retired node type
+typedef struct __tb_ebr_node_t
+{
+    // the next node
+    struct __tb_ebr_node_t*     next;
+
+    // the retired data
+    tb_pointer_t                data;
+
+    // the free function
+    tb_ebr_free_t               func;
+
+    // the retired epoch
+    tb_size_t                   epoch;
+
+}tb_ebr_node_t;
+
+/* the thread record type
+ *
+ * the records are never freed before exiting tbox, the record of the exited thread will be reused
+ * by the other new thread, and the retired nodes which have been not reclaimed are also inherited.
+ */
+typedef struct __tb_ebr_record_t
+{
+    // the next record in the global record list, it will not be changed after inserting it
+    struct __tb_ebr_record_t*   next;
+
+    // is owned by a thread?
+    tb_atomic_t                 owned;
+
+    // the state, (epoch << 1) | active
+    tb_atomic_t                 state;
+
+    // the nested count of the critical section
+    tb_size_t                   nested;
+
+    // the retired nodes, the older node is at the head
+    tb_ebr_node_t*              retired_head;
+    tb_ebr_node_t*              retired_tail;
+
+    // the retired count
+    tb_size_t                   retired_count;
+
+    // the count to try reclaiming the retired nodes next time
+    tb_size_t                   retired_limit;
+
+    // the cached free nodes
+    tb_ebr_node_t*              nodes;
+
+    // the cached free node count
+    tb_size_t                   nodes_count;
+
+    // the padding, avoid false sharing between threads
+    tb_byte_t                   padding[TB_L1_CACHE_BYTES];
+
+}tb_ebr_record_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the global epoch
+static tb_atomic_t                              g_ebr_epoch = 0;
+
+// the global record list
+static tb_atomic_t                              g_ebr_records = 0;
+
+// the thread local record, it will be released after the thread exited
+static tb_thread_local_t                        g_ebr_local = TB_THREAD_LOCAL_INIT;
+
+// the cached thread local record for the fast path
+#ifdef __tb_thread_local__
+static __tb_thread_local__ tb_ebr_record_t*     g_ebr_record = tb_null;
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * declaration
+ */
+__tb_extern_c_enter__
+tb_void_t tb_ebr_exit_env(tb_noarg_t);
+__tb_extern_c_leave__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_bool_t tb_ebr_advance(tb_size_t epoch)
+{
+    /* we can enter the next epoch only if all active readers have seen the current epoch,
+     * so the readers of the epoch (e - 1) have all left after entering the epoch (e + 1).
+     */
+    tb_ebr_record_t* record = (tb_ebr_record_t*)tb_atomic_get(&g_ebr_records);
+    for (; record; record = record->next)
+    {
+        tb_size_t state = (tb_size_t)tb_atomic_get(&record->state);
+        if ((state & TB_EBR_STATE_ACTIVE) && (state >> 1) != epoch)
+            return tb_false;
+    }
+
+    // enter the next epoch, it's ok if the other thread has advanced it
+    tb_long_t expected = (tb_long_t)epoch;
+    tb_atomic_compare_and_swap(&g_ebr_epoch, &expected, (tb_long_t)(epoch + 1));
+    return tb_true;
+}
+static tb_void_t tb_ebr_record_reclaim(tb_ebr_record_t* record)
+{
+    // try to enter the next epoch
+    tb_size_t epoch = (tb_size_t)tb_atomic_get(&g_ebr_epoch);
+    if (tb_ebr_advance(epoch)) epoch = (tb_size_t)tb_atomic_get(&g_ebr_epoch);
+
+    /* free the nodes retired at the epoch (e - 2) or before
+     *
+     * the node was removed before retiring it, so only the readers of the epoch (e - 1) and e may see it.
+     */
+    tb_ebr_node_t* node = record->retired_head;
+    while (node && epoch - node->epoch >= 2)
+    {
+        // free data
+        tb_ebr_node_t* next = node->next;
+        node->func(node->data);
+
+        // cache this node or free it
+        if (record->nodes_count < TB_EBR_NODE_CACHE_MAXN)
+        {
+            node->next = record->nodes;
+            record->nodes = node;
+            record->nodes_count++;
+        }
+        else tb_free(node);
+
+        // next
+        record->retired_count--;
+        node = next;
+    }
+    record->retired_head = node;
+    if (!node) record->retired_tail = tb_null;
+
+    // try reclaiming it again after retiring more nodes, avoid scanning all records for each retiring if some readers are blocked
+    record->retired_limit = record->retired_count + TB_EBR_RETIRED_GROW;
+}
+static tb_void_t tb_ebr_record_free(tb_cpointer_t priv)
+{
+    // the record
+    tb_ebr_record_t* record = (tb_ebr_record_t*)priv;
+    tb_assert_and_check_return(record);
+
+    // the thread has exited in the critical section? leave it
+    tb_assert(!record->nested);
+    record->nested = 0;
+    tb_atomic_set_explicit(&record->state, 0, TB_ATOMIC_RELEASE);
+
+    // reclaim the retired nodes as much as possible, the remaining nodes will be inherited by the next owner
+    if (record->retired_head) tb_ebr_record_reclaim(record);
+
+    // release this record
+#ifdef __tb_thread_local__
+    g_ebr_record = tb_null;
+#endif
+    tb_atomic_set_explicit(&record->owned, 0, TB_ATOMIC_RELEASE);
+}
+static tb_ebr_record_t* tb_ebr_record_init()
+{
+    // init the thread local
+    if (!tb_thread_local_init(&g_ebr_local, tb_ebr_record_free)) return tb_null;
+
+    // reuse the released record first
+    tb_ebr_record_t* record = (tb_ebr_record_t*)tb_atomic_get(&g_ebr_records);
+    for (; record; record = record->next)
+    {
+        tb_long_t owned = 0;
+        if (!tb_atomic_get_explicit(&record->owned, TB_ATOMIC_RELAXED) && tb_atomic_compare_and_swap(&record->owned, &owned, 1))
+            break;
+    }
+
+    // make a new record and insert it to the head of the record list
+    if (!record)
+    {
+        record = tb_malloc0_type(tb_ebr_record_t);
+        tb_assert_and_check_return_val(record, tb_null);
+
+        record->owned = 1;
+        record->retired_limit = TB_EBR_RETIRED_GROW;
+        tb_long_t head = tb_atomic_get(&g_ebr_records);
+        do
+        {
+            record->next = (tb_ebr_record_t*)head;
+
+        } while (!tb_atomic_compare_and_swap(&g_ebr_records, &head, (tb_long_t)record));
+    }
+
+    // save it to the current thread
+    if (!tb_thread_local_set(&g_ebr_local, record))
+    {
+        tb_atomic_set(&record->owned, 0);
+        return tb_null;
+    }
+#ifdef __tb_thread_local__
+    g_ebr_record = record;
+#endif
+    return record;
+}
+static __tb_inline__ tb_ebr_record_t* tb_ebr_record_self(tb_bool_t init)
+{
+#ifdef __tb_thread_local__
+    tb_ebr_record_t* record = g_ebr_record;
+#else
+    tb_ebr_record_t* record = (tb_ebr_record_t*)tb_thread_local_get(&g_ebr_local);
+#endif
+    return record || !init? record : tb_ebr_record_init();
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_void_t tb_ebr_exit_env()
+{
+    /* free all records and retired data
+     *
+     * @note all other threads have exited now
+     */
+    tb_ebr_record_t* record = (tb_ebr_record_t*)tb_atomic_fetch_and_set(&g_ebr_records, 0);
+    while (record)
+    {
+        tb_ebr_record_t* next = record->next;
+        tb_ebr_node_t* node = record->retired_head;
+        while (node)
+        {
+            tb_ebr_node_t* node_next = node->next;
+            node->func(node->data);
+            tb_free(node);
+            node = node_next;
+        }
+        node = record->nodes;
+        while (node)
+        {
+            tb_ebr_node_t* node_next = node->next;
+            tb_free(node);
+            node = node_next;
+        }
+        tb_free(record);
+        record = next;
+    }
+#ifdef __tb_thread_local__
+    g_ebr_record = tb_null;
+#endif
+}
+tb_bool_t tb_ebr_enter()
+{
+    // get the record of the current thread
+    tb_ebr_record_t* record = tb_ebr_record_self(tb_true);
+    tb_check_return_val(record, tb_false);
+
+    // nested? only enter it once
+    if (!record->nested++)
+    {
+        /* publish the current epoch, we use exchange instead of store,
+         * because we need a full barrier to prevent the following loads from being reordered before it
+         */
+        tb_size_t epoch = (tb_size_t)tb_atomic_get_explicit(&g_ebr_epoch, TB_ATOMIC_RELAXED);
+        tb_atomic_fetch_and_set(&record->state, (tb_long_t)((epoch << 1) | TB_EBR_STATE_ACTIVE));
+    }
+    return tb_true;
+}
+tb_void_t tb_ebr_leave()
+{
+    // get the record of the current thread
+    tb_ebr_record_t* record = tb_ebr_record_self(tb_false);
+    tb_assert_and_check_return(record && record->nested);
+
+    // leave it
+    if (!--record->nested)
+        tb_atomic_set_explicit(&record->state, 0, TB_ATOMIC_RELEASE);
+}
+tb_void_t tb_ebr_retire(tb_pointer_t data, tb_ebr_free_t func)
+{
+    // check
+    tb_assert_and_check_return(data && func);
+
+    // get the record of the current thread, we free it directly after all readers have left if no record
+    tb_ebr_record_t* record = tb_ebr_record_self(tb_true);
+    if (!record)
+    {
+        tb_ebr_synchronize();
+        func(data);
+        return ;
+    }
+
+    // make node
+    tb_ebr_node_t* node = record->nodes;
+    if (node)
+    {
+        record->nodes = node->next;
+        record->nodes_count--;
+    }
+    else node = tb_malloc_type(tb_ebr_node_t);
+    if (!node)
+    {
+        tb_ebr_synchronize();
+        func(data);
+        return ;
+    }
+
+    // append it to the retired list, the data has been removed before getting the epoch
+    node->next  = tb_null;
+    node->data  = data;
+    node->func  = func;
+    node->epoch = (tb_size_t)tb_atomic_get(&g_ebr_epoch);
+    if (record->retired_tail) record->retired_tail->next = node;
+    else record->retired_head = node;
+    record->retired_tail = node;
+    record->retired_count++;
+
+    // reclaim them in batch, but we cannot free data in the critical section
+    if (record->retired_count >= record->retired_limit && !record->nested)
+        tb_ebr_record_reclaim(record);
+}
+tb_void_t tb_ebr_synchronize()
+{
+    // check, we will never finish it in the critical section
+    tb_ebr_record_t* record = tb_ebr_record_self(tb_false);
+    tb_assert_and_check_return(!record || !record->nested);
+
+    // wait for entering the epoch (e + 2)
+    tb_size_t epoch = (tb_size_t)tb_atomic_get(&g_ebr_epoch);
+    tb_size_t current = epoch;
+    while (current - epoch < 2)
+    {
+        if (!tb_ebr_advance(current)) tb_sched_yield();
+        current = (tb_size_t)tb_atomic_get(&g_ebr_epoch);
+    }
+}
+tb_void_t tb_ebr_reclaim(tb_bool_t wait)
+{
+    // get the record of the current thread
+    tb_ebr_record_t* record = tb_ebr_record_self(tb_false);
+    tb_check_return(record && record->retired_head);
+    tb_assert_and_check_return(!record->nested);
+
+    // wait for all readers of the retired nodes?
+    if (wait)
+    {
+        tb_size_t epoch = record->retired_tail->epoch;
+        while ((tb_size_t)tb_atomic_get(&g_ebr_epoch) - epoch < 2)
+        {
+            tb_size_t current = (tb_size_t)tb_atomic_get(&g_ebr_epoch);
+            if (!tb_ebr_advance(current)) tb_sched_yield();
+        }
+    }
+
+    // reclaim them
+    tb_ebr_record_reclaim(record);
+}
@@ -0,0 +1,104 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        ebr.h
+ * @ingroup     platform
+ *
+ */
+#ifndef TB_PLATFORM_EBR_H
+#define TB_PLATFORM_EBR_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/*! the retired data free function type
+ *
+ * @param data      the retired data
+ */
+typedef tb_void_t   (*tb_ebr_free_t)(tb_pointer_t data);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! enter the epoch critical section on the current thread
+ *
+ * the shared data which is read in the critical section will not be freed until we leave it,
+ * it supports to be nested and it never blocks the other readers and writers.
+ *
+ * @code
+
+    // read it
+    if (tb_ebr_enter())
+    {
+        tb_node_t* node = (tb_node_t*)tb_atomic_get_explicit(&g_head, TB_ATOMIC_ACQUIRE);
+        if (node) value = node->value;
+        tb_ebr_leave();
+    }
+
+    // remove it
+    tb_node_t* node = (tb_node_t*)tb_atomic_fetch_and_set(&g_head, 0);
+    if (node) tb_ebr_retire(node, tb_node_free);
+
+ * @endcode
+ *
+ * @return          tb_true or tb_false
+ */
+tb_bool_t           tb_ebr_enter(tb_noarg_t);
+
+/// leave the epoch critical section on the current thread
+tb_void_t           tb_ebr_leave(tb_noarg_t);
+
+/*! retire the data which has been removed from the shared structure
+ *
+ * the data will be freed after all readers which may see it have left their critical sections.
+ * it is deferred to the retire list of the current thread and the list is reclaimed in batch.
+ *
+ * @param data      the data
+ * @param func      the free function
+ */
+tb_void_t           tb_ebr_retire(tb_pointer_t data, tb_ebr_free_t func);
+
+/*! wait for all readers in the current critical sections to leave
+ *
+ * @note we cannot call it in the critical section
+ */
+tb_void_t           tb_ebr_synchronize(tb_noarg_t);
+
+/*! reclaim the retired data of the current thread as much as possible
+ *
+ * @param wait      wait for all readers and free all retired data?
+ */
+tb_void_t           tb_ebr_reclaim(tb_bool_t wait);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
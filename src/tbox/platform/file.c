@@ -113,6 +113,26 @@ tb_hize_t tb_file_size(tb_file_ref_t file)
     tb_trace_noimpl();
     return 0;
 }
+tb_byte_t* tb_file_mmap(tb_file_ref_t file, tb_hize_t offset, tb_size_t size, tb_size_t flags)
+{
+    tb_trace_noimpl();
+    return tb_null;
+}
+tb_bool_t tb_file_munmap(tb_byte_t* data, tb_size_t size)
+{
+    tb_trace_noimpl();
+    return tb_false;
+}
+tb_bool_t tb_file_madvise(tb_byte_t* data, tb_size_t size, tb_size_t advice)
+{
+    tb_trace_noimpl();
+    return tb_false;
+}
+tb_bool_t tb_file_msync(tb_byte_t* data, tb_size_t size)
+{
+    tb_trace_noimpl();
+    return tb_false;
+}
 tb_bool_t tb_file_info(tb_char_t const* path, tb_file_info_t* info)
 {
     tb_trace_noimpl();
@@ -101,6 +101,28 @@ typedef struct __tb_file_info_t
 
 }tb_file_info_t;
 
+/// the file mmap flag type
+typedef enum __tb_file_mmap_flag_t
+{
+    TB_FILE_MMAP_READ       = 1     //!< readable
+,   TB_FILE_MMAP_WRITE      = 2     //!< writable, the file must be opened with TB_FILE_MODE_RW
+,   TB_FILE_MMAP_PRIVATE    = 4     //!< copy on write, the written data will not be stored to the file
+,   TB_FILE_MMAP_POPULATE   = 8     //!< prefault all pages when mapping it, only for linux
+,   TB_FILE_MMAP_HUGEPAGE   = 16    //!< attempt to use the transparent huge pages, it will be ignored if not supported
+
+}tb_file_mmap_flag_t;
+
+/// the file madvise type
+typedef enum __tb_file_madvise_t
+{
+    TB_FILE_MADVISE_NORMAL      = 0 //!< no special treatment
+,   TB_FILE_MADVISE_SEQUENTIAL  = 1 //!< expect sequential page references, read ahead aggressively
+,   TB_FILE_MADVISE_RANDOM      = 2 //!< expect random page references, no read ahead
+,   TB_FILE_MADVISE_WILLNEED    = 3 //!< expect access in the near future, start reading it now
+,   TB_FILE_MADVISE_DONTNEED    = 4 //!< do not expect access in the near future
+
+}tb_file_madvise_t;
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
@@ -249,6 +271,67 @@ tb_hize_t               tb_file_size(tb_file_ref_t file);
  */
 tb_hong_t               tb_file_offset(tb_file_ref_t file);
 
+/*! map the file data to memory
+ *
+ * the offset need not be aligned by the page size, we will align it internally
+ *
+ * @code
+ * tb_file_ref_t file = tb_file_init("/tmp/file", TB_FILE_MODE_RO);
+ * if (file)
+ * {
+ *     tb_size_t  size = (tb_size_t)tb_file_size(file);
+ *     tb_byte_t* data = tb_file_mmap(file, 0, size, TB_FILE_MMAP_READ);
+ *     if (data)
+ *     {
+ *         tb_file_madvise(data, size, TB_FILE_MADVISE_SEQUENTIAL);
+ *
+ *         // ...
+ *
+ *         tb_file_munmap(data, size);
+ *     }
+ *     tb_file_exit(file);
+ * }
+ * @endcode
+ *
+ * @note the mapped data is still valid after exiting the file
+ *
+ * @param file          the file
+ * @param offset        the file offset
+ * @param size          the mapped size, must be not zero
+ * @param flags         the mmap flags, e.g. TB_FILE_MMAP_READ | TB_FILE_MMAP_WRITE
+ *
+ * @return              the mapped data address or tb_null
+ */
+tb_byte_t*              tb_file_mmap(tb_file_ref_t file, tb_hize_t offset, tb_size_t size, tb_size_t flags);
+
+/*! unmap the file data
+ *
+ * @param data          the mapped data address returned by tb_file_mmap()
+ * @param size          the mapped size
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_file_munmap(tb_byte_t* data, tb_size_t size);
+
+/*! give advice about the access pattern of the mapped data
+ *
+ * @param data          the mapped data address, it can be in the middle of the mapped data
+ * @param size          the advised size
+ * @param advice        the advice, e.g. TB_FILE_MADVISE_SEQUENTIAL
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_file_madvise(tb_byte_t* data, tb_size_t size, tb_size_t advice);
+
+/*! flush the modified mapped data to the file
+ *
+ * @param data          the mapped data address
+ * @param size          the flushed size
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_file_msync(tb_byte_t* data, tb_size_t size);
+
 /*! the file info for file or directory
  *
  * @param path          the file path
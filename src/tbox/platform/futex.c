@@ -0,0 +1,61 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        futex.c
+ * @ingroup     platform
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "futex.h"
+#include "time.h"
+#include "sched.h"
+#include "atomic.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+#if defined(TB_CONFIG_OS_LINUX) || defined(TB_CONFIG_OS_ANDROID)
+#   include "linux/futex.c"
+#else
+tb_long_t tb_futex_wait(tb_atomic32_t* futex, tb_int32_t expected, tb_long_t timeout)
+{
+    // check
+    tb_assert_and_check_return_val(futex, -1);
+
+    // poll the value, yield it first and sleep it if it's still not changed
+    tb_size_t   tries = 0;
+    tb_hong_t   time = timeout > 0? tb_mclock() : 0;
+    while (tb_atomic32_get(futex) == expected)
+    {
+        // timeout?
+        if (!timeout || (timeout > 0 && tb_mclock() - time >= timeout)) return 0;
+
+        // wait it
+        if (tries++ < 16) tb_sched_yield();
+        else tb_msleep(1);
+    }
+    return 1;
+}
+tb_size_t tb_futex_wake(tb_atomic32_t* futex, tb_size_t count)
+{
+    // the waiters will see the changed value after polling
+    return 0;
+}
+#endif
@@ -0,0 +1,66 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        futex.h
+ * @ingroup     platform
+ *
+ */
+#ifndef TB_PLATFORM_FUTEX_H
+#define TB_PLATFORM_FUTEX_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! wait on the futex address if its value is still equal to the expected value
+ *
+ * it may return spuriously, so we need to check the value again after returning.
+ * it will poll the value with backoff if the native futex is not supported.
+ *
+ * @param futex     the futex address
+ * @param expected  the expected value
+ * @param timeout   the timeout (ms), infinity: -1
+ *
+ * @return          ok: 1, timeout: 0, failed: -1
+ */
+tb_long_t           tb_futex_wait(tb_atomic32_t* futex, tb_int32_t expected, tb_long_t timeout);
+
+/*! wake the waiters on the futex address
+ *
+ * @param futex     the futex address
+ * @param count     the maximum count of the woken waiters, wake all: -1
+ *
+ * @return          the woken count
+ */
+tb_size_t           tb_futex_wake(tb_atomic32_t* futex, tb_size_t count);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -0,0 +1,83 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        futex_mutex.c
+ * @ingroup     platform
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "futex_mutex.h"
+#include "futex.h"
+#include "cpu.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the maximum spin count before parking the thread
+#define TB_FUTEX_MUTEX_SPIN_MAXN    (128)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_void_t tb_futex_mutex_enter_slow(tb_futex_mutex_ref_t mutex)
+{
+    // occupied
+#ifdef TB_LOCK_PROFILER_ENABLE
+    tb_lock_profiler_occupied(tb_lock_profiler(), (tb_pointer_t)mutex);
+#endif
+
+    /* spin it adaptively if there are multiple cpus
+     *
+     * we spin about twice the average spin count which the previous owners need,
+     * so we will park it quickly if the critical section is long or it's oversubscribed.
+     */
+#ifdef tb_cpu_pause
+    if (tb_cpu_count() > 1)
+    {
+        tb_int32_t spins = tb_atomic32_get_explicit(&mutex->spins, TB_ATOMIC_RELAXED);
+        tb_int32_t maxn = tb_min(spins * 2 + 10, TB_FUTEX_MUTEX_SPIN_MAXN);
+        tb_int32_t i = 0;
+        for (i = 0; i < maxn; i++)
+        {
+            tb_int32_t state = 0;
+            if (!tb_atomic32_get_explicit(&mutex->state, TB_ATOMIC_RELAXED) &&
+                tb_atomic32_compare_and_swap_explicit(&mutex->state, &state, 1, TB_ATOMIC_ACQUIRE, TB_ATOMIC_RELAXED))
+                break;
+            tb_cpu_pause();
+        }
+
+        // update the average spin count
+        tb_atomic32_set_explicit(&mutex->spins, spins + (i - spins) / 8, TB_ATOMIC_RELAXED);
+        tb_check_return(i == maxn);
+    }
+#endif
+
+    /* park it until we get the lock
+     *
+     * we always mark it as contended after waking up, because there may be other waiters.
+     */
+    while (tb_atomic32_fetch_and_set_explicit(&mutex->state, 2, TB_ATOMIC_ACQUIRE))
+        tb_futex_wait(&mutex->state, 2, -1);
+}
+tb_void_t tb_futex_mutex_wake(tb_futex_mutex_ref_t mutex)
+{
+    tb_futex_wake(&mutex->state, 1);
+}
@@ -0,0 +1,164 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        futex_mutex.h
+ * @ingroup     platform
+ *
+ */
+#ifndef TB_PLATFORM_FUTEX_MUTEX_H
+#define TB_PLATFORM_FUTEX_MUTEX_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "atomic.h"
+#include "../utils/lock_profiler.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+/// the futex mutex initial value
+#define TB_FUTEX_MUTEX_INIT         {0, 0}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/*! the futex mutex type
+ *
+ * it's a lightweight mutex which need not be created, it spins adaptively before parking the thread,
+ * so it's fast like the spinlock for the short critical sections and does not burn cpu for the long ones.
+ */
+typedef struct __tb_futex_mutex_t
+{
+    // the state, unlocked: 0, locked: 1, locked and has waiters: 2
+    tb_atomic32_t           state;
+
+    // the average spin count for acquiring it
+    tb_atomic32_t           spins;
+
+}tb_futex_mutex_t, *tb_futex_mutex_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/* enter the futex mutex in the slow path
+ *
+ * @param mutex     the mutex
+ */
+tb_void_t           tb_futex_mutex_enter_slow(tb_futex_mutex_ref_t mutex);
+
+/* wake one waiter of the futex mutex
+ *
+ * @param mutex     the mutex
+ */
+tb_void_t           tb_futex_mutex_wake(tb_futex_mutex_ref_t mutex);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * inline implementation
+ */
+
+/*! init the futex mutex
+ *
+ * @param mutex     the mutex
+ *
+ * @return          tb_true or tb_false
+ */
+static __tb_inline_force__ tb_bool_t tb_futex_mutex_init(tb_futex_mutex_ref_t mutex)
+{
+    // check
+    tb_assert(mutex);
+    tb_atomic32_set_explicit(&mutex->state, 0, TB_ATOMIC_RELAXED);
+    tb_atomic32_set_explicit(&mutex->spins, 0, TB_ATOMIC_RELAXED);
+    return tb_true;
+}
+
+/*! exit the futex mutex
+ *
+ * @param mutex     the mutex
+ */
+static __tb_inline_force__ tb_void_t tb_futex_mutex_exit(tb_futex_mutex_ref_t mutex)
+{
+    // check
+    tb_assert(mutex && !tb_atomic32_get_explicit(&mutex->state, TB_ATOMIC_RELAXED));
+}
+
+/*! try to enter the futex mutex
+ *
+ * @param mutex     the mutex
+ *
+ * @return          tb_true or tb_false
+ */
+static __tb_inline_force__ tb_bool_t tb_futex_mutex_enter_try(tb_futex_mutex_ref_t mutex)
+{
+    // check
+    tb_assert(mutex);
+
+    // try locking it
+    tb_int32_t state = 0;
+    tb_bool_t ok = tb_atomic32_compare_and_swap_explicit(&mutex->state, &state, 1, TB_ATOMIC_ACQUIRE, TB_ATOMIC_RELAXED);
+
+    // occupied?
+#ifdef TB_LOCK_PROFILER_ENABLE
+    if (!ok) tb_lock_profiler_occupied(tb_lock_profiler(), (tb_pointer_t)mutex);
+#endif
+    return ok;
+}
+
+/*! enter the futex mutex
+ *
+ * @param mutex     the mutex
+ */
+static __tb_inline_force__ tb_void_t tb_futex_mutex_enter(tb_futex_mutex_ref_t mutex)
+{
+    // check
+    tb_assert(mutex);
+
+    // lock it directly if it's not contended
+    tb_int32_t state = 0;
+    if (!tb_atomic32_compare_and_swap_explicit(&mutex->state, &state, 1, TB_ATOMIC_ACQUIRE, TB_ATOMIC_RELAXED))
+        tb_futex_mutex_enter_slow(mutex);
+}
+
+/*! leave the futex mutex
+ *
+ * @param mutex     the mutex
+ */
+static __tb_inline_force__ tb_void_t tb_futex_mutex_leave(tb_futex_mutex_ref_t mutex)
+{
+    // check
+    tb_assert(mutex);
+
+    // unlock it and wake one waiter if there are some waiters
+    if (tb_atomic32_fetch_and_set_explicit(&mutex->state, 0, TB_ATOMIC_RELEASE) == 2)
+        tb_futex_mutex_wake(mutex);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
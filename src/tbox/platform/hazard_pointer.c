@@ -0,0 +1,381 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        hazard_pointer.c
+ * @ingroup     platform
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "hazard_pointer"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "hazard_pointer.h"
+#include "sched.h"
+#include "thread_local.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the minimum retired count of the current thread to scan all hazard pointers
+#define TB_HAZARD_POINTER_RETIRED_MINN      (64)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the retired node type
+typedef struct __tb_hazard_pointer_node_t
+{
+    // the next node
+    struct __tb_hazard_pointer_node_t*      next;
+
+    // the retired data
+    tb_pointer_t                            data;
+
+    // the free function
+    tb_hazard_pointer_free_t                func;
+
+}tb_hazard_pointer_node_t;
+
+/* the thread record type
+ *
+ * the records are never freed before exiting tbox, the record of the exited thread will be reused
+ * by the other new thread, and the retired nodes which have been not freed are also inherited.
+ */
+typedef struct __tb_hazard_pointer_record_t
+{
+    // the next record in the global record list, it will not be changed after inserting it
+    struct __tb_hazard_pointer_record_t*    next;
+
+    // is owned by a thread?
+    tb_atomic_t                             owned;
+
+    // the hazard pointers
+    tb_atomic_t                             slots[TB_HAZARD_POINTER_SLOT_MAXN];
+
+    // the retired nodes
+    tb_hazard_pointer_node_t*               retired;
+
+    // the retired count
+    tb_size_t                               retired_count;
+
+    // the sorted hazard pointers for scanning
+    tb_size_t*                              hazards;
+
+    // the maximum count of the hazard pointers
+    tb_size_t                               hazards_maxn;
+
+    // the padding, avoid false sharing between threads
+    tb_byte_t                               padding[TB_L1_CACHE_BYTES];
+
+}tb_hazard_pointer_record_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the global record list
+static tb_atomic_t                                          g_hazard_pointer_records = 0;
+
+// the global record count
+static tb_atomic_t                                          g_hazard_pointer_records_count = 0;
+
+// the thread local record, it will be released after the thread exited
+static tb_thread_local_t                                    g_hazard_pointer_local = TB_THREAD_LOCAL_INIT;
+
+// the cached thread local record for the fast path
+#ifdef __tb_thread_local__
+static __tb_thread_local__ tb_hazard_pointer_record_t*      g_hazard_pointer_record = tb_null;
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * declaration
+ */
+__tb_extern_c_enter__
+tb_void_t tb_hazard_pointer_exit_env(tb_noarg_t);
+__tb_extern_c_leave__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_bool_t tb_hazard_pointer_find(tb_size_t const* hazards, tb_size_t count, tb_size_t data)
+{
+    // binary find it
+    tb_size_t l = 0;
+    tb_size_t r = count;
+    while (l < r)
+    {
+        tb_size_t m = (l + r) >> 1;
+        if (hazards[m] < data) l = m + 1;
+        else if (hazards[m] > data) r = m;
+        else return tb_true;
+    }
+    return tb_false;
+}
+static tb_void_t tb_hazard_pointer_record_scan(tb_hazard_pointer_record_t* record)
+{
+    // collect all hazard pointers, the newer records are at the head
+    tb_size_t                   count = 0;
+    tb_hazard_pointer_record_t* item = (tb_hazard_pointer_record_t*)tb_atomic_get(&g_hazard_pointer_records);
+    for (; item; item = item->next)
+    {
+        // grow the hazard pointers
+        if (count + TB_HAZARD_POINTER_SLOT_MAXN > record->hazards_maxn)
+        {
+            tb_size_t   maxn = tb_max(record->hazards_maxn << 1, 64);
+            tb_size_t*  hazards = (tb_size_t*)tb_ralloc(record->hazards, maxn * sizeof(tb_size_t));
+            tb_assert_and_check_return(hazards);
+            record->hazards      = hazards;
+            record->hazards_maxn = maxn;
+        }
+
+        // save the non-null hazard pointers
+        tb_size_t i = 0;
+        for (i = 0; i < TB_HAZARD_POINTER_SLOT_MAXN; i++)
+        {
+            tb_size_t hazard = (tb_size_t)tb_atomic_get(&item->slots[i]);
+            if (hazard) record->hazards[count++] = hazard;
+        }
+    }
+
+    // sort them, the count is small and most slots are null
+    tb_size_t* hazards = record->hazards;
+    tb_size_t  i = 0;
+    for (i = 1; i < count; i++)
+    {
+        tb_size_t hazard = hazards[i];
+        tb_size_t j = i;
+        for (; j > 0 && hazards[j - 1] > hazard; j--)
+            hazards[j] = hazards[j - 1];
+        hazards[j] = hazard;
+    }
+
+    // free all retired data which is not protected
+    tb_hazard_pointer_node_t*   node = record->retired;
+    tb_hazard_pointer_node_t*   kept = tb_null;
+    while (node)
+    {
+        tb_hazard_pointer_node_t* next = node->next;
+        if (count && tb_hazard_pointer_find(hazards, count, (tb_size_t)node->data))
+        {
+            node->next = kept;
+            kept = node;
+        }
+        else
+        {
+            node->func(node->data);
+            tb_free(node);
+            record->retired_count--;
+        }
+        node = next;
+    }
+    record->retired = kept;
+}
+static tb_void_t tb_hazard_pointer_record_free(tb_cpointer_t priv)
+{
+    // the record
+    tb_hazard_pointer_record_t* record = (tb_hazard_pointer_record_t*)priv;
+    tb_assert_and_check_return(record);
+
+    // clear all slots
+    tb_size_t i = 0;
+    for (i = 0; i < TB_HAZARD_POINTER_SLOT_MAXN; i++)
+        tb_atomic_set_explicit(&record->slots[i], 0, TB_ATOMIC_RELEASE);
+
+    // free the retired data as much as possible, the remaining nodes will be inherited by the next owner
+    if (record->retired) tb_hazard_pointer_record_scan(record);
+
+    // release this record
+#ifdef __tb_thread_local__
+    g_hazard_pointer_record = tb_null;
+#endif
+    tb_atomic_set_explicit(&record->owned, 0, TB_ATOMIC_RELEASE);
+}
+static tb_hazard_pointer_record_t* tb_hazard_pointer_record_init()
+{
+    // init the thread local
+    if (!tb_thread_local_init(&g_hazard_pointer_local, tb_hazard_pointer_record_free)) return tb_null;
+
+    // reuse the released record first
+    tb_hazard_pointer_record_t* record = (tb_hazard_pointer_record_t*)tb_atomic_get(&g_hazard_pointer_records);
+    for (; record; record = record->next)
+    {
+        tb_long_t owned = 0;
+        if (!tb_atomic_get_explicit(&record->owned, TB_ATOMIC_RELAXED) && tb_atomic_compare_and_swap(&record->owned, &owned, 1))
+            break;
+    }
+
+    // make a new record and insert it to the head of the record list
+    if (!record)
+    {
+        record = tb_malloc0_type(tb_hazard_pointer_record_t);
+        tb_assert_and_check_return_val(record, tb_null);
+
+        record->owned = 1;
+        tb_long_t head = tb_atomic_get(&g_hazard_pointer_records);
+        do
+        {
+            record->next = (tb_hazard_pointer_record_t*)head;
+
+        } while (!tb_atomic_compare_and_swap(&g_hazard_pointer_records, &head, (tb_long_t)record));
+        tb_atomic_fetch_and_add(&g_hazard_pointer_records_count, 1);
+    }
+
+    // save it to the current thread
+    if (!tb_thread_local_set(&g_hazard_pointer_local, record))
+    {
+        tb_atomic_set(&record->owned, 0);
+        return tb_null;
+    }
+#ifdef __tb_thread_local__
+    g_hazard_pointer_record = record;
+#endif
+    return record;
+}
+static __tb_inline__ tb_hazard_pointer_record_t* tb_hazard_pointer_record_self(tb_bool_t init)
+{
+#ifdef __tb_thread_local__
+    tb_hazard_pointer_record_t* record = g_hazard_pointer_record;
+#else
+    tb_hazard_pointer_record_t* record = (tb_hazard_pointer_record_t*)tb_thread_local_get(&g_hazard_pointer_local);
+#endif
+    return record || !init? record : tb_hazard_pointer_record_init();
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_void_t tb_hazard_pointer_exit_env()
+{
+    /* free all records and retired data
+     *
+     * @note all other threads have exited now
+     */
+    tb_hazard_pointer_record_t* record = (tb_hazard_pointer_record_t*)tb_atomic_fetch_and_set(&g_hazard_pointer_records, 0);
+    while (record)
+    {
+        tb_hazard_pointer_record_t* next = record->next;
+        tb_hazard_pointer_node_t*   node = record->retired;
+        while (node)
+        {
+            tb_hazard_pointer_node_t* node_next = node->next;
+            node->func(node->data);
+            tb_free(node);
+            node = node_next;
+        }
+        if (record->hazards) tb_free(record->hazards);
+        tb_free(record);
+        record = next;
+    }
+    tb_atomic_set(&g_hazard_pointer_records_count, 0);
+#ifdef __tb_thread_local__
+    g_hazard_pointer_record = tb_null;
+#endif
+}
+tb_pointer_t tb_hazard_pointer_protect(tb_size_t slot, tb_atomic_t* pointer)
+{
+    // check
+    tb_assert_and_check_return_val(slot < TB_HAZARD_POINTER_SLOT_MAXN && pointer, tb_null);
+
+    // get the record of the current thread
+    tb_hazard_pointer_record_t* record = tb_hazard_pointer_record_self(tb_true);
+    tb_check_return_val(record, tb_null);
+
+    /* publish the hazard pointer and check whether it's still reachable
+     *
+     * we use exchange instead of store, because we need a full barrier to prevent the following load from being reordered before it.
+     * if it's still reachable after publishing, it has not been retired and all scanning threads will see it.
+     */
+    tb_long_t data = tb_atomic_get_explicit(pointer, TB_ATOMIC_ACQUIRE);
+    while (1)
+    {
+        tb_atomic_fetch_and_set(&record->slots[slot], data);
+        tb_long_t current = tb_atomic_get_explicit(pointer, TB_ATOMIC_ACQUIRE);
+        if (current == data) break;
+        data = current;
+    }
+    return (tb_pointer_t)data;
+}
+tb_void_t tb_hazard_pointer_clear(tb_size_t slot)
+{
+    // check
+    tb_assert_and_check_return(slot < TB_HAZARD_POINTER_SLOT_MAXN);
+
+    // clear it
+    tb_hazard_pointer_record_t* record = tb_hazard_pointer_record_self(tb_false);
+    if (record) tb_atomic_set_explicit(&record->slots[slot], 0, TB_ATOMIC_RELEASE);
+}
+tb_void_t tb_hazard_pointer_retire(tb_pointer_t data, tb_hazard_pointer_free_t func)
+{
+    // check
+    tb_assert_and_check_return(data && func);
+
+    // get the record of the current thread and make node
+    tb_hazard_pointer_record_t* record = tb_hazard_pointer_record_self(tb_true);
+    tb_hazard_pointer_node_t*   node = record? tb_malloc_type(tb_hazard_pointer_node_t) : tb_null;
+    if (!node)
+    {
+        /* no memory? we can only wait until no threads protect it
+         *
+         * @note we cannot wait for the protected data of the current thread
+         */
+        tb_size_t hazard = 0;
+        do
+        {
+            hazard = 0;
+            tb_hazard_pointer_record_t* item = (tb_hazard_pointer_record_t*)tb_atomic_get(&g_hazard_pointer_records);
+            for (; item && !hazard; item = item->next)
+            {
+                tb_size_t i = 0;
+                for (i = 0; i < TB_HAZARD_POINTER_SLOT_MAXN && !hazard; i++)
+                    hazard = (tb_pointer_t)tb_atomic_get(&item->slots[i]) == data? 1 : 0;
+            }
+            if (hazard) tb_sched_yield();
+
+        } while (hazard);
+        func(data);
+        return ;
+    }
+
+    // append it to the retired list
+    node->data = data;
+    node->func = func;
+    node->next = record->retired;
+    record->retired = node;
+    record->retired_count++;
+
+    /* scan all hazard pointers in batch
+     *
+     * we keep the retired count larger than the count of all hazard pointers,
+     * so we can always free the half of retired data and the amortized cost is constant.
+     */
+    tb_size_t limit = (tb_size_t)tb_atomic_get_explicit(&g_hazard_pointer_records_count, TB_ATOMIC_RELAXED) * TB_HAZARD_POINTER_SLOT_MAXN * 2;
+    if (record->retired_count >= tb_max(limit, TB_HAZARD_POINTER_RETIRED_MINN))
+        tb_hazard_pointer_record_scan(record);
+}
+tb_void_t tb_hazard_pointer_scan()
+{
+    tb_hazard_pointer_record_t* record = tb_hazard_pointer_record_self(tb_false);
+    if (record && record->retired) tb_hazard_pointer_record_scan(record);
+}
@@ -0,0 +1,109 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        hazard_pointer.h
+ * @ingroup     platform
+ *
+ */
+#ifndef TB_PLATFORM_HAZARD_POINTER_H
+#define TB_PLATFORM_HAZARD_POINTER_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "atomic.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+/// the hazard pointer slot count of each thread
+#define TB_HAZARD_POINTER_SLOT_MAXN     (4)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/*! the retired data free function type
+ *
+ * @param data      the retired data
+ */
+typedef tb_void_t   (*tb_hazard_pointer_free_t)(tb_pointer_t data);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! protect the pointer which is loaded from the given atomic address
+ *
+ * the protected data will not be freed until we clear or reuse this slot,
+ * it's more precise than the epoch based reclamation and a blocked reader only holds a few data,
+ * but we need to protect each pointer in the traversing.
+ *
+ * @code
+
+    // read it
+    tb_node_t* node = (tb_node_t*)tb_hazard_pointer_protect(0, &g_head);
+    if (node) value = node->value;
+    tb_hazard_pointer_clear(0);
+
+    // remove it
+    tb_node_t* node = (tb_node_t*)tb_atomic_fetch_and_set(&g_head, 0);
+    if (node) tb_hazard_pointer_retire(node, tb_node_free);
+
+ * @endcode
+ *
+ * @param slot      the slot index of the current thread, [0, TB_HAZARD_POINTER_SLOT_MAXN)
+ * @param pointer   the atomic address of the shared pointer
+ *
+ * @return          the protected pointer, it will be tb_null if the shared pointer is null or failed
+ */
+tb_pointer_t        tb_hazard_pointer_protect(tb_size_t slot, tb_atomic_t* pointer);
+
+/*! clear the given slot of the current thread
+ *
+ * @param slot      the slot index
+ */
+tb_void_t           tb_hazard_pointer_clear(tb_size_t slot);
+
+/*! retire the data which has been removed from the shared structure
+ *
+ * the data will be freed after no threads protect it.
+ *
+ * @param data      the data
+ * @param func      the free function
+ */
+tb_void_t           tb_hazard_pointer_retire(tb_pointer_t data, tb_hazard_pointer_free_t func);
+
+/*! scan all hazard pointers and free the retired data of the current thread which is not protected
+ *
+ * @note we need not call it manually, it will be called automatically after retiring some data
+ */
+tb_void_t           tb_hazard_pointer_scan(tb_noarg_t);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
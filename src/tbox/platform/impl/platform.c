@@ -41,6 +41,11 @@
 __tb_extern_c_enter__
 tb_bool_t tb_process_group_init();
 tb_void_t tb_process_group_exit();
+tb_void_t tb_ebr_exit_env();
+tb_void_t tb_hazard_pointer_exit_env();
+tb_void_t tb_lock_profiler_exit_env();
+tb_void_t tb_metrics_init_env();
+tb_void_t tb_metrics_exit_env();
 __tb_extern_c_leave__
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -69,6 +74,11 @@ tb_bool_t tb_platform_init_env(tb_handle_t priv)
     if (!tb_thread_local_init_env()) return tb_false;
 #endif
 
+    // init the metrics environment
+#ifndef TB_CONFIG_MICRO_ENABLE
+    tb_metrics_init_env();
+#endif
+
     // init exception environment
 #ifdef TB_CONFIG_EXCEPTION_ENABLE
     if (!tb_exception_init_env()) return tb_false;
@@ -104,11 +114,30 @@ tb_void_t tb_platform_exit_env()
     tb_thread_local_exit_env();
 #endif
 
+    // exit the memory reclamation environment, all threads have exited and released their records now
+#ifndef TB_CONFIG_MICRO_ENABLE
+    tb_hazard_pointer_exit_env();
+    tb_ebr_exit_env();
+#endif
+
+    // exit the sampled lock profiler environment
+#ifndef TB_CONFIG_MICRO_ENABLE
+    tb_lock_profiler_exit_env();
+#endif
+
+    // exit the metrics environment
+#ifndef TB_CONFIG_MICRO_ENABLE
+    tb_metrics_exit_env();
+#endif
+
     // exit dns environment
 #ifndef TB_CONFIG_MICRO_ENABLE
     tb_dns_exit_env();
 #endif
 
+    // exit socket relay environment
+    tb_socket_relay_exit_env();
+
     // exit socket environment
     tb_socket_exit_env();
 
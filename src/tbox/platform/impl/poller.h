@@ -62,6 +62,21 @@ typedef struct __tb_poller_t
     tb_poller_process_ref_t process_poller;
 #endif
 
+    // the maximum count of the events fetched by each waiting, 0: default
+    tb_size_t               maxevents;
+
+    // the pending events list for tb_poller_wait_events()
+    tb_poller_event_ref_t   events;
+
+    // the pending events head
+    tb_size_t               events_head;
+
+    // the pending events size
+    tb_size_t               events_size;
+
+    // the pending events maxn
+    tb_size_t               events_maxn;
+
     /* exit poller
      *
      * @param poller        the poller
@@ -90,6 +105,17 @@ typedef struct __tb_poller_t
      */
     tb_long_t               (*wait)(struct __tb_poller_t* poller, tb_poller_event_func_t func, tb_long_t timeout);
 
+    /* wait events for all objects and save them to the given list, optional
+     *
+     * @param poller        the poller
+     * @param list          the events list
+     * @param maxn          the maximum count of the events list
+     * @param timeout       the timeout, infinity: -1
+     *
+     * @return              > 0: the events number, 0: timeout, -1: failed
+     */
+    tb_long_t               (*wait_events)(struct __tb_poller_t* poller, tb_poller_event_ref_t list, tb_size_t maxn, tb_long_t timeout);
+
     /* insert socket to poller
      *
      * @param poller        the poller
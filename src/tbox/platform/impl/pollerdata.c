@@ -49,9 +49,9 @@ __tb_extern_c_leave__
 #endif
 
 /* //////////////////////////////////////////////////////////////////////////////////////
- * private implementation
+ * implementation
  */
-static tb_long_t tb_pollerdata_object2fd(tb_poller_object_ref_t object)
+tb_long_t tb_pollerdata_object2fd(tb_poller_object_ref_t object)
 {
     // check
     tb_assert(object && object->ref.ptr);
@@ -69,11 +69,6 @@ static tb_long_t tb_pollerdata_object2fd(tb_poller_object_ref_t object)
 
     return fd;
 }
-
-/* //////////////////////////////////////////////////////////////////////////////////////
- * implementation
- */
-
 tb_void_t tb_pollerdata_init(tb_pollerdata_ref_t pollerdata)
 {
     // check
@@ -158,3 +153,60 @@ tb_void_t tb_pollerdata_reset(tb_pollerdata_ref_t pollerdata, tb_poller_object_r
     // remove the poller private data
     if (fd < pollerdata->maxn) pollerdata->data[fd] = tb_null;
 }
+tb_void_t tb_polleritems_init(tb_polleritems_ref_t polleritems, tb_size_t itemsize)
+{
+    // check
+    tb_assert(polleritems && itemsize);
+
+    // init it
+    polleritems->data       = tb_null;
+    polleritems->maxn       = 0;
+    polleritems->itemsize   = itemsize;
+}
+tb_void_t tb_polleritems_exit(tb_polleritems_ref_t polleritems)
+{
+    // check
+    tb_assert(polleritems);
+
+    // exit poller items
+    if (polleritems->data) tb_free(polleritems->data);
+    polleritems->data = tb_null;
+    polleritems->maxn = 0;
+}
+tb_pointer_t tb_polleritems_get(tb_polleritems_ref_t polleritems, tb_poller_object_ref_t object)
+{
+    // check
+    tb_assert(polleritems);
+
+    // get the poller item
+    tb_long_t fd = tb_pollerdata_object2fd(object);
+    return (polleritems->data && fd < polleritems->maxn)? polleritems->data + fd * polleritems->itemsize : tb_null;
+}
+tb_pointer_t tb_polleritems_need(tb_polleritems_ref_t polleritems, tb_poller_object_ref_t object)
+{
+    // check
+    tb_assert(polleritems && object);
+
+    // get fd
+    tb_long_t fd = tb_pollerdata_object2fd(object);
+
+    // grow items
+    tb_size_t need = fd + 1;
+    if (need > polleritems->maxn)
+    {
+        // grow data
+        need += TB_POLLERDATA_GROW;
+        tb_byte_t* data = (tb_byte_t*)tb_ralloc(polleritems->data, need * polleritems->itemsize);
+        tb_assert_and_check_return_val(data, tb_null);
+
+        // init growed space
+        tb_memset(data + polleritems->maxn * polleritems->itemsize, 0, (need - polleritems->maxn) * polleritems->itemsize);
+
+        // grow data size
+        polleritems->data = data;
+        polleritems->maxn = need;
+    }
+
+    // get the poller item
+    return polleritems->data + fd * polleritems->itemsize;
+}
@@ -57,6 +57,24 @@ typedef struct __tb_pollerdata_t
 
 }tb_pollerdata_t, *tb_pollerdata_ref_t;
 
+/* the poller items type
+ *
+ * the fixed-size items are stored inline and indexed by fd,
+ * so we need not allocate and look up the item pointer for each object.
+ */
+typedef struct __tb_polleritems_t
+{
+    // the items data (fd => item)
+    tb_byte_t*              data;
+
+    // the items maximum count
+    tb_size_t               maxn;
+
+    // the item size
+    tb_size_t               itemsize;
+
+}tb_polleritems_t, *tb_polleritems_ref_t;
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
@@ -103,6 +121,47 @@ tb_cpointer_t           tb_pollerdata_get(tb_pollerdata_ref_t pollerdata, tb_pol
  */
 tb_void_t               tb_pollerdata_reset(tb_pollerdata_ref_t pollerdata, tb_poller_object_ref_t object);
 
+/* get the fd of the poller object
+ *
+ * @param object        the poller object
+ *
+ * @return              the fd
+ */
+tb_long_t               tb_pollerdata_object2fd(tb_poller_object_ref_t object);
+
+/* init poller items
+ *
+ * @param polleritems   the polleritems
+ * @param itemsize      the item size
+ */
+tb_void_t               tb_polleritems_init(tb_polleritems_ref_t polleritems, tb_size_t itemsize);
+
+/* exit poller items
+ *
+ * @param polleritems   the polleritems
+ */
+tb_void_t               tb_polleritems_exit(tb_polleritems_ref_t polleritems);
+
+/* get the poller item
+ *
+ * @param polleritems   the polleritems
+ * @param object        the poller object
+ *
+ * @return              the poller item, it will be tb_null if this object has not been inserted
+ */
+tb_pointer_t            tb_polleritems_get(tb_polleritems_ref_t polleritems, tb_poller_object_ref_t object);
+
+/* get the poller item and grow the items if this object has not been inserted
+ *
+ * @note the returned item will be moved after growing, so we cannot keep it
+ *
+ * @param polleritems   the polleritems
+ * @param object        the poller object
+ *
+ * @return              the poller item
+ */
+tb_pointer_t            tb_polleritems_need(tb_polleritems_ref_t polleritems, tb_poller_object_ref_t object);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
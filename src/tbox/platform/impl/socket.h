@@ -41,6 +41,9 @@ tb_bool_t   tb_socket_init_env(tb_noarg_t);
 // exit socket environment
 tb_void_t   tb_socket_exit_env(tb_noarg_t);
 
+// exit socket relay environment
+tb_void_t   tb_socket_relay_exit_env(tb_noarg_t);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
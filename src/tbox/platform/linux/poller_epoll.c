@@ -30,6 +30,33 @@
 #   include <sys/resource.h>
 #endif
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the initial events count
+#ifdef __tb_small__
+#   define TB_POLLER_EPOLL_EVENTS_MIN       (16)
+#else
+#   define TB_POLLER_EPOLL_EVENTS_MIN       (64)
+#endif
+
+// the default maximum events count
+#ifdef __tb_small__
+#   define TB_POLLER_EPOLL_EVENTS_MAX       (1024)
+#else
+#   define TB_POLLER_EPOLL_EVENTS_MAX       (8192)
+#endif
+
+/* the epoll data: fd (32bits) | object type (8bits) | has private data (1bit)
+ *
+ * we need not look up the private data of the object which was inserted with TB_POLLER_EVENT_NOEXTRA
+ */
+#define tb_poller_epoll_data_make(fd, type, extra)  ((tb_uint64_t)(tb_uint32_t)(fd) | ((tb_uint64_t)(type) << 32) | ((extra)? ((tb_uint64_t)1 << 40) : 0))
+#define tb_poller_epoll_data_fd(data)               ((tb_int_t)(tb_uint32_t)(data))
+#define tb_poller_epoll_data_type(data)             ((tb_uint8_t)((data) >> 32))
+#define tb_poller_epoll_data_extra(data)            ((data) & ((tb_uint64_t)1 << 40))
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
@@ -56,7 +83,7 @@ typedef struct __tb_poller_epoll_t
     tb_size_t               events_count;
 
     // the socket data
-    tb_pollerdata_t           pollerdata;
+    tb_pollerdata_t         pollerdata;
 
 }tb_poller_epoll_t, *tb_poller_epoll_ref_t;
 
@@ -129,12 +156,8 @@ static tb_void_t tb_poller_epoll_spak(tb_poller_t* self)
     // post it
     if (poller->pair[0]) tb_socket_send(poller->pair[0], (tb_byte_t const*)"p", 1);
 }
-static tb_bool_t tb_poller_epoll_insert(tb_poller_t* self, tb_poller_object_ref_t object, tb_size_t events, tb_cpointer_t priv)
+static tb_bool_t tb_poller_epoll_ctrl(tb_poller_epoll_ref_t poller, tb_int_t op, tb_poller_object_ref_t object, tb_size_t events, tb_cpointer_t priv)
 {
-    // check
-    tb_poller_epoll_ref_t poller = (tb_poller_epoll_ref_t)self;
-    tb_assert_and_check_return_val(poller && poller->epfd > 0 && object, tb_false);
-
     // init event
     struct epoll_event e = {0};
     if (events & TB_POLLER_EVENT_RECV) e.events |= EPOLLIN;
@@ -153,27 +176,39 @@ static tb_bool_t tb_poller_epoll_insert(tb_poller_t* self, tb_poller_object_ref_
     tb_assertf(!(events & TB_POLLER_EVENT_ONESHOT), "cannot insert events with oneshot, not supported!");
 #endif
 
-    // save fd
-    e.data.fd = (tb_int_t)tb_ptr2fd(object->ref.ptr);
-
-    // bind the object type to the private data
-    priv = tb_poller_priv_set_object_type(object, priv);
-
     // bind user private data to object
-    if (!(events & TB_POLLER_EVENT_NOEXTRA) || object->type == TB_POLLER_OBJECT_PIPE)
+    tb_int_t    fd = (tb_int_t)tb_ptr2fd(object->ref.ptr);
+    tb_bool_t   extra = tb_false;
+    if (!(events & TB_POLLER_EVENT_NOEXTRA))
+    {
         tb_pollerdata_set(&poller->pollerdata, object, priv);
+        extra = tb_true;
+    }
+    // keep the previous private data if we only modify events
+    else if (op == EPOLL_CTL_MOD && tb_pollerdata_get(&poller->pollerdata, object))
+        extra = tb_true;
+
+    // save fd, object type and the private data flag
+    e.data.u64 = tb_poller_epoll_data_make(fd, object->type, extra);
 
-    // add socket and events
-    if (epoll_ctl(poller->epfd, EPOLL_CTL_ADD, e.data.fd, &e) < 0)
+    // insert or modify events
+    if (epoll_ctl(poller->epfd, op, fd, &e) < 0)
     {
         // trace
-        tb_trace_e("insert object(%p) events: %lu failed, errno: %d", object->ref.ptr, events, errno);
+        tb_trace_e("%s object(%p) events: %lu failed, errno: %d", op == EPOLL_CTL_ADD? "insert" : "modify", object->ref.ptr, events, errno);
         return tb_false;
     }
-
-    // ok
     return tb_true;
 }
+static tb_bool_t tb_poller_epoll_insert(tb_poller_t* self, tb_poller_object_ref_t object, tb_size_t events, tb_cpointer_t priv)
+{
+    // check
+    tb_poller_epoll_ref_t poller = (tb_poller_epoll_ref_t)self;
+    tb_assert_and_check_return_val(poller && poller->epfd > 0 && object, tb_false);
+
+    // insert it
+    return tb_poller_epoll_ctrl(poller, EPOLL_CTL_ADD, object, events, priv);
+}
 static tb_bool_t tb_poller_epoll_remove(tb_poller_t* self, tb_poller_object_ref_t object)
 {
     // check
@@ -200,60 +235,25 @@ static tb_bool_t tb_poller_epoll_modify(tb_poller_t* self, tb_poller_object_ref_
     tb_poller_epoll_ref_t poller = (tb_poller_epoll_ref_t)self;
     tb_assert_and_check_return_val(poller && poller->epfd > 0 && object, tb_false);
 
-    // init event
-    struct epoll_event e = {0};
-    if (events & TB_POLLER_EVENT_RECV) e.events |= EPOLLIN;
-    if (events & TB_POLLER_EVENT_SEND) e.events |= EPOLLOUT;
-    if (events & TB_POLLER_EVENT_CLEAR)
-    {
-        e.events |= EPOLLET;
-#ifdef EPOLLRDHUP
-        e.events |= EPOLLRDHUP;
-#endif
-    }
-#ifdef EPOLLONESHOT
-    if (events & TB_POLLER_EVENT_ONESHOT) e.events |= EPOLLONESHOT;
-#else
-    // oneshot is not supported now
-    tb_assertf(!(events & TB_POLLER_EVENT_ONESHOT), "cannot insert events with oneshot, not supported!");
-#endif
-
-    // save fd
-    e.data.fd = (tb_int_t)tb_ptr2fd(object->ref.ptr);
-
-    // bind the object type to the private data
-    priv = tb_poller_priv_set_object_type(object, priv);
-
-    // bind user private data to object
-    if (!(events & TB_POLLER_EVENT_NOEXTRA) || object->type == TB_POLLER_OBJECT_PIPE)
-        tb_pollerdata_set(&poller->pollerdata, object, priv);
-
-    // modify events
-    if (epoll_ctl(poller->epfd, EPOLL_CTL_MOD, e.data.fd, &e) < 0)
-    {
-        // trace
-        tb_trace_e("modify object(%p) events: %lu failed, errno: %d", object->ref.ptr, events, errno);
-        return tb_false;
-    }
-    return tb_true;
+    // modify it
+    return tb_poller_epoll_ctrl(poller, EPOLL_CTL_MOD, object, events, priv);
 }
-static tb_long_t tb_poller_epoll_wait(tb_poller_t* self, tb_poller_event_func_t func, tb_long_t timeout)
+static tb_long_t tb_poller_epoll_wait_impl(tb_poller_epoll_ref_t poller, tb_size_t maxn, tb_long_t timeout)
 {
-    // check
-    tb_poller_epoll_ref_t poller = (tb_poller_epoll_ref_t)self;
-    tb_assert_and_check_return_val(poller && poller->epfd > 0 && poller->maxn && func, -1);
+    // the maximum events count
+    tb_size_t events_maxn = poller->base.maxevents? poller->base.maxevents : TB_POLLER_EPOLL_EVENTS_MAX;
+    events_maxn = tb_min(events_maxn, poller->maxn);
 
     // init events
-    tb_size_t grow = tb_align8((poller->maxn >> 3) + 1);
     if (!poller->events)
     {
-        poller->events_count = grow;
+        poller->events_count = tb_min(TB_POLLER_EPOLL_EVENTS_MIN, events_maxn);
         poller->events = tb_nalloc_type(poller->events_count, struct epoll_event);
         tb_assert_and_check_return_val(poller->events, -1);
     }
 
     // wait events
-    tb_long_t events_count = epoll_wait(poller->epfd, poller->events, poller->events_count, timeout);
+    tb_long_t events_count = epoll_wait(poller->epfd, poller->events, tb_min(poller->events_count, maxn), timeout);
 
     // timeout or interrupted?
     if (!events_count || (events_count == -1 && errno == EINTR))
@@ -262,72 +262,84 @@ static tb_long_t tb_poller_epoll_wait(tb_poller_t* self, tb_poller_event_func_t
     // check error?
     tb_assert_and_check_return_val(events_count >= 0 && events_count <= poller->events_count, -1);
 
-    // grow it if events is full
-    if (events_count == poller->events_count)
+    // grow it if events is full, we double it for reducing the waiting count in the busy servers
+    if (events_count == poller->events_count && poller->events_count < events_maxn)
     {
         // grow size
-        poller->events_count += grow;
-        if (poller->events_count > poller->maxn) poller->events_count = poller->maxn;
+        poller->events_count = tb_min(poller->events_count << 1, events_maxn);
 
         // grow data
         poller->events = (struct epoll_event*)tb_ralloc(poller->events, poller->events_count * sizeof(struct epoll_event));
         tb_assert_and_check_return_val(poller->events, -1);
     }
-    tb_assert(events_count <= poller->events_count);
+    return events_count;
+}
+static tb_long_t tb_poller_epoll_event(tb_poller_epoll_ref_t poller, struct epoll_event* e, tb_poller_event_ref_t event)
+{
+    // the events for epoll
+    tb_size_t epoll_events = e->events;
+
+    // the object
+    tb_uint64_t data = e->data.u64;
+    event->object.type      = tb_poller_epoll_data_type(data);
+    event->object.ref.ptr   = tb_fd2ptr(tb_poller_epoll_data_fd(data));
+    tb_assert(event->object.ref.ptr);
+
+    // spank socket events?
+    tb_socket_ref_t pair = poller->pair[1];
+    if (event->object.ref.sock == pair)
+    {
+        tb_check_return_val(epoll_events & EPOLLIN, 0);
+
+        // read spak
+        tb_char_t spak = '\0';
+        if (1 != tb_socket_recv(pair, (tb_byte_t*)&spak, 1)) return -1;
+
+        // killed? otherwise continue it
+        return spak == 'k'? -1 : 0;
+    }
+
+    // init events
+    tb_size_t events = TB_POLLER_EVENT_NONE;
+    if (epoll_events & EPOLLIN) events |= TB_POLLER_EVENT_RECV;
+    if (epoll_events & EPOLLOUT) events |= TB_POLLER_EVENT_SEND;
+    if (epoll_events & (EPOLLHUP | EPOLLERR) && !(events & (TB_POLLER_EVENT_RECV | TB_POLLER_EVENT_SEND)))
+        events |= TB_POLLER_EVENT_RECV | TB_POLLER_EVENT_SEND;
 
-    // limit
-    events_count = tb_min(events_count, poller->maxn);
+#ifdef EPOLLRDHUP
+    // connection closed for the edge trigger?
+    if (epoll_events & EPOLLRDHUP) events |= TB_POLLER_EVENT_EOF;
+#endif
+
+    // save events and the user private data
+    event->events = events;
+    event->priv = tb_poller_epoll_data_extra(data)? tb_pollerdata_get(&poller->pollerdata, &event->object) : tb_null;
+    return 1;
+}
+static tb_long_t tb_poller_epoll_wait(tb_poller_t* self, tb_poller_event_func_t func, tb_long_t timeout)
+{
+    // check
+    tb_poller_epoll_ref_t poller = (tb_poller_epoll_ref_t)self;
+    tb_assert_and_check_return_val(poller && poller->epfd > 0 && poller->maxn && func, -1);
+
+    // wait events
+    tb_long_t events_count = tb_poller_epoll_wait_impl(poller, poller->maxn, timeout);
+    tb_check_return_val(events_count > 0, events_count);
 
     // handle events
-    tb_size_t           i = 0;
+    tb_long_t           i = 0;
+    tb_long_t           ok = 0;
     tb_size_t           wait = 0;
-    struct epoll_event* e = tb_null;
-    tb_socket_ref_t     pair = poller->pair[1];
-    tb_poller_object_t  object;
+    tb_poller_event_t   event;
     for (i = 0; i < events_count; i++)
     {
-        // the epoll event
-        e = poller->events + i;
-
-        // the events for epoll
-        tb_size_t epoll_events = e->events;
-
-        // the socket
-        tb_long_t fd = e->data.fd;
-        object.ref.ptr = tb_fd2ptr(fd);
-        tb_assert(object.ref.ptr);
-
-        // spank socket events?
-        if (object.ref.sock == pair && (epoll_events & EPOLLIN))
-        {
-            // read spak
-            tb_char_t spak = '\0';
-            if (1 != tb_socket_recv(pair, (tb_byte_t*)&spak, 1)) return -1;
-
-            // killed?
-            if (spak == 'k') return -1;
-
-            // continue it
-            continue ;
-        }
-        tb_check_continue(object.ref.sock != pair);
-
-        // init events
-        tb_size_t events = TB_POLLER_EVENT_NONE;
-        if (epoll_events & EPOLLIN) events |= TB_POLLER_EVENT_RECV;
-        if (epoll_events & EPOLLOUT) events |= TB_POLLER_EVENT_SEND;
-        if (epoll_events & (EPOLLHUP | EPOLLERR) && !(events & (TB_POLLER_EVENT_RECV | TB_POLLER_EVENT_SEND)))
-            events |= TB_POLLER_EVENT_RECV | TB_POLLER_EVENT_SEND;
-
-#ifdef EPOLLRDHUP
-        // connection closed for the edge trigger?
-        if (epoll_events & EPOLLRDHUP) events |= TB_POLLER_EVENT_EOF;
-#endif
+        // get event
+        ok = tb_poller_epoll_event(poller, poller->events + i, &event);
+        tb_check_return_val(ok >= 0, -1);
+        tb_check_continue(ok);
 
         // call event function
-        tb_cpointer_t priv = tb_pollerdata_get(&poller->pollerdata, &object);
-        object.type = tb_poller_priv_get_object_type(priv);
-        func((tb_poller_ref_t)self, &object, events, tb_poller_priv_get_original(priv));
+        func((tb_poller_ref_t)self, &event.object, event.events, event.priv);
 
         // update the events count
         wait++;
@@ -336,6 +348,30 @@ static tb_long_t tb_poller_epoll_wait(tb_poller_t* self, tb_poller_event_func_t
     // ok
     return wait;
 }
+static tb_long_t tb_poller_epoll_wait_events(tb_poller_t* self, tb_poller_event_ref_t list, tb_size_t maxn, tb_long_t timeout)
+{
+    // check
+    tb_poller_epoll_ref_t poller = (tb_poller_epoll_ref_t)self;
+    tb_assert_and_check_return_val(poller && poller->epfd > 0 && poller->maxn && list && maxn, -1);
+
+    // wait events
+    tb_long_t events_count = tb_poller_epoll_wait_impl(poller, maxn, timeout);
+    tb_check_return_val(events_count > 0, events_count);
+
+    // save events to the list directly
+    tb_long_t i = 0;
+    tb_long_t ok = 0;
+    tb_size_t wait = 0;
+    for (i = 0; i < events_count; i++)
+    {
+        ok = tb_poller_epoll_event(poller, poller->events + i, list + wait);
+        tb_check_return_val(ok >= 0, -1);
+        if (ok) wait++;
+    }
+
+    // ok
+    return wait;
+}
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
@@ -357,6 +393,7 @@ tb_poller_t* tb_poller_epoll_init()
         poller->base.kill   = tb_poller_epoll_kill;
         poller->base.spak   = tb_poller_epoll_spak;
         poller->base.wait   = tb_poller_epoll_wait;
+        poller->base.wait_events = tb_poller_epoll_wait_events;
         poller->base.insert = tb_poller_epoll_insert;
         poller->base.remove = tb_poller_epoll_remove;
         poller->base.modify = tb_poller_epoll_modify;
@@ -352,7 +352,7 @@ tb_ltimer_ref_t tb_ltimer_init(tb_size_t grow, tb_size_t tick, tb_bool_t ctime)
         tb_assert_and_check_break(timer->expired);
 
         // register lock profiler
-#ifdef TB_LOCK_PROFILER_ENABLE
+#ifdef TB_LOCK_PROFILER_REGISTER_ENABLE
         tb_lock_profiler_register(tb_lock_profiler(), (tb_pointer_t)&timer->lock, TB_TRACE_MODULE_NAME);
 #endif
 
@@ -0,0 +1,219 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        mcslock.h
+ * @ingroup     platform
+ *
+ */
+#ifndef TB_PLATFORM_MCSLOCK_H
+#define TB_PLATFORM_MCSLOCK_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "cpu.h"
+#include "sched.h"
+#include "atomic.h"
+#include "../utils/lock_profiler.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+/// the mcs lock initial value
+#define TB_MCSLOCK_INIT             (0)
+
+/// the maximum spin count before yielding the cpu
+#define TB_MCSLOCK_SPIN_MAXN        (1024)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/*! the mcs lock type, it's the tail of the waiter queue
+ *
+ * it's a fair queued spinlock, each waiter spins on its own node instead of the shared lock,
+ * so it scales better than the spinlock under heavy contention.
+ *
+ * @note the lock is handed off in order, so it's slow if there are more waiters than cpus,
+ *       please use tb_futex_mutex_t for the oversubscribed threads.
+ *
+ * @code
+
+    static tb_mcslock_t g_lock = TB_MCSLOCK_INIT;
+
+    tb_mcslock_node_t node;
+    tb_mcslock_enter(&g_lock, &node);
+    ...
+    tb_mcslock_leave(&g_lock, &node);
+
+ * @endcode
+ */
+typedef tb_atomic_t                 tb_mcslock_t;
+
+/// the mcs lock ref type
+typedef tb_mcslock_t*               tb_mcslock_ref_t;
+
+/// the mcs lock node type, it's usually on the stack of the waiter
+typedef struct __tb_mcslock_node_t
+{
+    // the next waiter node
+    tb_atomic_t                     next;
+
+    // is waiting?
+    tb_atomic32_t                   waiting;
+
+}tb_mcslock_node_t, *tb_mcslock_node_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * inline implementation
+ */
+
+/*! init the mcs lock
+ *
+ * @param lock      the lock
+ *
+ * @return          tb_true or tb_false
+ */
+static __tb_inline_force__ tb_bool_t tb_mcslock_init(tb_mcslock_ref_t lock)
+{
+    // check
+    tb_assert(lock);
+    tb_atomic_set_explicit(lock, 0, TB_ATOMIC_RELAXED);
+    return tb_true;
+}
+
+/*! exit the mcs lock
+ *
+ * @param lock      the lock
+ */
+static __tb_inline_force__ tb_void_t tb_mcslock_exit(tb_mcslock_ref_t lock)
+{
+    // check
+    tb_assert(lock && !tb_atomic_get_explicit(lock, TB_ATOMIC_RELAXED));
+}
+
+/*! try to enter the mcs lock
+ *
+ * @param lock      the lock
+ * @param node      the node of the current waiter, it need be valid until leaving it
+ *
+ * @return          tb_true or tb_false
+ */
+static __tb_inline_force__ tb_bool_t tb_mcslock_enter_try(tb_mcslock_ref_t lock, tb_mcslock_node_ref_t node)
+{
+    // check
+    tb_assert(lock && node);
+
+    // init node
+    tb_atomic_set_explicit(&node->next, 0, TB_ATOMIC_RELAXED);
+    tb_atomic32_set_explicit(&node->waiting, 0, TB_ATOMIC_RELAXED);
+
+    // we can only get it if there are no waiters
+    tb_long_t tail = 0;
+    tb_bool_t ok = tb_atomic_compare_and_swap_explicit(lock, &tail, (tb_long_t)node, TB_ATOMIC_ACQUIRE, TB_ATOMIC_RELAXED);
+
+    // occupied?
+#ifdef TB_LOCK_PROFILER_ENABLE
+    if (!ok) tb_lock_profiler_occupied(tb_lock_profiler(), (tb_pointer_t)lock);
+#endif
+    return ok;
+}
+
+/*! enter the mcs lock
+ *
+ * @param lock      the lock
+ * @param node      the node of the current waiter, it need be valid until leaving it
+ */
+static __tb_inline_force__ tb_void_t tb_mcslock_enter(tb_mcslock_ref_t lock, tb_mcslock_node_ref_t node)
+{
+    // check
+    tb_assert(lock && node);
+
+    // init node
+    tb_atomic_set_explicit(&node->next, 0, TB_ATOMIC_RELAXED);
+    tb_atomic32_set_explicit(&node->waiting, 1, TB_ATOMIC_RELAXED);
+
+    // append it to the waiter queue
+    tb_mcslock_node_ref_t prev = (tb_mcslock_node_ref_t)tb_atomic_fetch_and_set_explicit(lock, (tb_long_t)node, TB_ATOMIC_ACQ_REL);
+    tb_check_return(prev);
+
+    // occupied
+#ifdef TB_LOCK_PROFILER_ENABLE
+    tb_lock_profiler_occupied(tb_lock_profiler(), (tb_pointer_t)lock);
+#endif
+
+    // link it after the previous waiter and wait for its handoff
+    tb_atomic_set_explicit(&prev->next, (tb_long_t)node, TB_ATOMIC_RELEASE);
+#if defined(tb_cpu_pause) && !defined(TB_CONFIG_MICRO_ENABLE)
+    tb_size_t spin = tb_cpu_count() > 1? 0 : TB_MCSLOCK_SPIN_MAXN;
+#endif
+    while (tb_atomic32_get_explicit(&node->waiting, TB_ATOMIC_ACQUIRE))
+    {
+        // we yield it if it's spinning too long or there is only one cpu, e.g. the previous waiter has been preempted
+#if defined(tb_cpu_pause) && !defined(TB_CONFIG_MICRO_ENABLE)
+        if (spin++ < TB_MCSLOCK_SPIN_MAXN) tb_cpu_pause();
+        else
+#endif
+        tb_sched_yield();
+    }
+}
+
+/*! leave the mcs lock
+ *
+ * @param lock      the lock
+ * @param node      the node which was passed to tb_mcslock_enter()
+ */
+static __tb_inline_force__ tb_void_t tb_mcslock_leave(tb_mcslock_ref_t lock, tb_mcslock_node_ref_t node)
+{
+    // check
+    tb_assert(lock && node);
+
+    // no next waiter? release it
+    tb_mcslock_node_ref_t next = (tb_mcslock_node_ref_t)tb_atomic_get_explicit(&node->next, TB_ATOMIC_ACQUIRE);
+    if (!next)
+    {
+        tb_long_t tail = (tb_long_t)node;
+        if (tb_atomic_compare_and_swap_explicit(lock, &tail, 0, TB_ATOMIC_RELEASE, TB_ATOMIC_RELAXED)) return ;
+
+        // the next waiter is linking itself, wait it
+        while (!(next = (tb_mcslock_node_ref_t)tb_atomic_get_explicit(&node->next, TB_ATOMIC_ACQUIRE)))
+        {
+#ifdef tb_cpu_pause
+            tb_cpu_pause();
+#else
+            tb_sched_yield();
+#endif
+        }
+    }
+
+    // hand it off to the next waiter
+    tb_atomic32_set_explicit(&next->waiting, 0, TB_ATOMIC_RELEASE);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
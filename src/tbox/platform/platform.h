@@ -27,18 +27,23 @@
  */
 #include "prefix.h"
 #include "cpu.h"
+#include "ebr.h"
+#include "rcu.h"
 #include "page.h"
 #include "path.h"
 #include "file.h"
 #include "time.h"
 #include "pipe.h"
 #include "mutex.h"
+#include "futex.h"
 #include "event.h"
 #include "timer.h"
 #include "print.h"
 #include "ltimer.h"
 #include "socket.h"
+#include "socket_relay.h"
 #include "thread.h"
+#include "rwlock.h"
 #include "atomic.h"
 #include "poller.h"
 #include "context.h"
@@ -50,6 +55,7 @@
 #include "syserror.h"
 #include "addrinfo.h"
 #include "spinlock.h"
+#include "mcslock.h"
 #include "hostname.h"
 #include "semaphore.h"
 #include "backtrace.h"
@@ -59,8 +65,10 @@
 #include "environment.h"
 #include "thread_pool.h"
 #include "thread_local.h"
+#include "futex_mutex.h"
 #include "native_memory.h"
 #include "virtual_memory.h"
+#include "hazard_pointer.h"
 #ifdef TB_CONFIG_API_HAVE_DEPRECATED
 #   include "deprecated/deprecated.h"
 #endif
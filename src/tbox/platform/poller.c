@@ -32,6 +32,7 @@
 #include "time.h"
 #include "impl/poller.h"
 #include "impl/pollerdata.h"
+#include "../utils/metrics.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * private implementation
@@ -69,6 +70,83 @@
 #   endif
 #endif
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the pending events grow
+#ifdef __tb_small__
+#   define TB_POLLER_EVENTS_GROW        (16)
+#else
+#   define TB_POLLER_EVENTS_GROW        (64)
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_void_t tb_poller_events_save(tb_poller_ref_t self, tb_poller_object_ref_t object, tb_long_t events, tb_cpointer_t priv)
+{
+    // check
+    tb_poller_t* poller = (tb_poller_t*)self;
+    tb_assert(poller && object);
+
+    // grow the pending events
+    if (poller->events_size >= poller->events_maxn)
+    {
+        tb_size_t maxn = poller->events_maxn + TB_POLLER_EVENTS_GROW;
+        tb_poller_event_ref_t list = (tb_poller_event_ref_t)tb_ralloc(poller->events, maxn * sizeof(tb_poller_event_t));
+        tb_assert_and_check_return(list);
+
+        poller->events      = list;
+        poller->events_maxn = maxn;
+    }
+
+    // save this event
+    tb_poller_event_ref_t event = poller->events + poller->events_size++;
+    event->object   = *object;
+    event->events   = events;
+    event->priv     = priv;
+}
+static tb_void_t tb_poller_events_purge(tb_poller_t* poller, tb_poller_object_ref_t object)
+{
+    // remove the pending events of this object, they may be stale after removing or modifying it
+    tb_size_t i = poller->events_head;
+    tb_size_t n = poller->events_head;
+    for (; i < poller->events_size; i++)
+    {
+        tb_poller_event_ref_t event = poller->events + i;
+        if (event->object.type == object->type && event->object.ref.ptr == object->ref.ptr) continue;
+        if (n != i) poller->events[n] = *event;
+        n++;
+    }
+    poller->events_size = n;
+
+    // no pending events? reset it
+    if (poller->events_head >= poller->events_size)
+    {
+        poller->events_head = 0;
+        poller->events_size = 0;
+    }
+}
+static tb_long_t tb_poller_events_load(tb_poller_t* poller, tb_poller_event_ref_t list, tb_size_t maxn)
+{
+    // load the pending events
+    tb_size_t count = tb_min(poller->events_size - poller->events_head, maxn);
+    if (count)
+    {
+        tb_memcpy(list, poller->events + poller->events_head, count * sizeof(tb_poller_event_t));
+        poller->events_head += count;
+    }
+
+    // all events have been loaded? reset it
+    if (poller->events_head >= poller->events_size)
+    {
+        poller->events_head = 0;
+        poller->events_size = 0;
+    }
+    return count;
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
@@ -123,6 +201,13 @@ tb_void_t tb_poller_exit(tb_poller_ref_t self)
     poller->process_poller = tb_null;
 #endif
 
+    // exit the pending events
+    if (poller->events) tb_free(poller->events);
+    poller->events      = tb_null;
+    poller->events_head = 0;
+    poller->events_size = 0;
+    poller->events_maxn = 0;
+
     // exit poller
     if (poller->exit)
         poller->exit(poller);
@@ -206,6 +291,9 @@ tb_bool_t tb_poller_remove(tb_poller_ref_t self, tb_poller_object_ref_t object)
     tb_poller_t* poller = (tb_poller_t*)self;
     tb_assert_and_check_return_val(poller && poller->remove && object, tb_false);
 
+    // purge the pending events of this object
+    if (poller->events_size) tb_poller_events_purge(poller, object);
+
 #ifdef TB_POLLER_ENABLE_PROCESS
     // is the process object?
     if (object->type == TB_POLLER_OBJECT_PROC)
@@ -228,6 +316,9 @@ tb_bool_t tb_poller_modify(tb_poller_ref_t self, tb_poller_object_ref_t object,
     tb_poller_t* poller = (tb_poller_t*)self;
     tb_assert_and_check_return_val(poller && poller->modify && object, tb_false);
 
+    // purge the pending events of this object
+    if (poller->events_size) tb_poller_events_purge(poller, object);
+
 #ifdef TB_POLLER_ENABLE_PROCESS
     // is the process object?
     if (object->type == TB_POLLER_OBJECT_PROC)
@@ -266,10 +357,65 @@ tb_long_t tb_poller_wait(tb_poller_ref_t self, tb_poller_event_func_t func, tb_l
         tb_long_t proc_wait = tb_poller_process_wait_poll(poller->process_poller, func);
         tb_check_return_val(proc_wait >= 0, -1);
         wait += proc_wait;
+
+        // record the events count
+#ifdef TB_METRICS_ENABLE
+        tb_metrics_record(tb_metrics_builtin(TB_METRICS_BUILTIN_POLLER_EVENTS_PER_WAIT), (tb_hize_t)wait);
+#endif
         return wait;
     }
 #endif
-    return poller->wait(poller, func, timeout);
+
+    // wait the poller objects
+    tb_long_t wait = poller->wait(poller, func, timeout);
+
+    // record the events count
+#ifdef TB_METRICS_ENABLE
+    if (wait >= 0) tb_metrics_record(tb_metrics_builtin(TB_METRICS_BUILTIN_POLLER_EVENTS_PER_WAIT), (tb_hize_t)wait);
+#endif
+    return wait;
+}
+tb_long_t tb_poller_wait_events(tb_poller_ref_t self, tb_poller_event_ref_t list, tb_size_t maxn, tb_long_t timeout)
+{
+    // check
+    tb_poller_t* poller = (tb_poller_t*)self;
+    tb_assert_and_check_return_val(poller && list && maxn, -1);
+
+    // return the pending events first
+    if (poller->events_size) return tb_poller_events_load(poller, list, maxn);
+
+    // wait events to the given list directly if be supported
+#ifdef TB_POLLER_ENABLE_PROCESS
+    if (poller->wait_events && !poller->process_poller)
+#else
+    if (poller->wait_events)
+#endif
+    {
+        // wait events
+        tb_long_t wait = poller->wait_events(poller, list, maxn, timeout);
+
+        // record the events count
+#ifdef TB_METRICS_ENABLE
+        if (wait >= 0) tb_metrics_record(tb_metrics_builtin(TB_METRICS_BUILTIN_POLLER_EVENTS_PER_WAIT), (tb_hize_t)wait);
+#endif
+        return wait;
+    }
+
+    // wait events and save them to the pending list
+    tb_long_t wait = tb_poller_wait(self, tb_poller_events_save, timeout);
+    tb_check_return_val(wait > 0, wait);
+
+    // load the pending events
+    return tb_poller_events_load(poller, list, maxn);
+}
+tb_void_t tb_poller_limit(tb_poller_ref_t self, tb_size_t maxn)
+{
+    // check
+    tb_poller_t* poller = (tb_poller_t*)self;
+    tb_assert_and_check_return(poller);
+
+    // save the maximum count of the events
+    poller->maxevents = maxn;
 }
 tb_void_t tb_poller_attach(tb_poller_ref_t self)
 {
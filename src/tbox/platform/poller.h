@@ -108,6 +108,20 @@ typedef struct __tb_poller_object_t
 
 }tb_poller_object_t, *tb_poller_object_ref_t;
 
+/// the poller event type for tb_poller_wait_events()
+typedef struct __tb_poller_event_t
+{
+    /// the poller object
+    tb_poller_object_t      object;
+
+    /// the poller events or process status
+    tb_long_t               events;
+
+    /// the user private data
+    tb_cpointer_t           priv;
+
+}tb_poller_event_t, *tb_poller_event_ref_t;
+
 /*! the poller event func type
  *
  * @param poller    the poller
@@ -213,6 +227,41 @@ tb_bool_t           tb_poller_modify(tb_poller_ref_t poller, tb_poller_object_re
  */
 tb_long_t           tb_poller_wait(tb_poller_ref_t poller, tb_poller_event_func_t func, tb_long_t timeout);
 
+/*! wait all sockets and save the triggered events to the given list
+ *
+ * it will not call the events function for each object, so it's faster than tb_poller_wait()
+ * for the servers with a lot of connections.
+ *
+ * @code
+    tb_poller_event_t list[64];
+    tb_long_t count = tb_poller_wait_events(poller, list, tb_arrayn(list), -1);
+    for (i = 0; i < count; i++)
+    {
+        // handle list[i].object, list[i].events and list[i].priv
+    }
+ * @endcode
+ *
+ * @note the remaining events will be returned by the next waiting directly if the list is full
+ *
+ * @param poller    the poller
+ * @param list      the events list
+ * @param maxn      the maximum count of the events list
+ * @param timeout   the timeout, infinity: -1
+ *
+ * @return          > 0: the events number, 0: timeout or interrupted, -1: failed
+ */
+tb_long_t           tb_poller_wait_events(tb_poller_ref_t poller, tb_poller_event_ref_t list, tb_size_t maxn, tb_long_t timeout);
+
+/*! limit the maximum count of the events fetched from the system by each waiting
+ *
+ * the events buffer of the poller (e.g. epoll) will grow adaptively until this limit,
+ * the default limit will be used if it is zero.
+ *
+ * @param poller    the poller
+ * @param maxn      the maximum count of the events
+ */
+tb_void_t           tb_poller_limit(tb_poller_ref_t poller, tb_size_t maxn);
+
 /*! attach the poller to the current thread (only for windows/iocp now)
  *
  * @param poller    the poller
@@ -27,6 +27,7 @@
 #include "../path.h"
 #include "../directory.h"
 #include "../environment.h"
+#include "../atomic.h"
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -38,56 +39,64 @@
 /* //////////////////////////////////////////////////////////////////////////////////////
  * private implementation
  */
-static tb_bool_t tb_directory_walk_remove(tb_char_t const* path, tb_file_info_t const* info, tb_cpointer_t priv)
+static tb_bool_t tb_directory_walk_remove(tb_directory_entry_t const* entries, tb_size_t count, tb_cpointer_t priv)
 {
     // check
-    tb_assert_and_check_return_val(path && info, tb_false);
+    tb_assert_and_check_return_val(entries, tb_false);
 
-    // remove file, directory and dead symbol link (info->type is none, file not exists)
-    remove(path);
+    // remove files, directories and dead symbol links (info.type is none, file not exists)
+    tb_size_t i = 0;
+    for (i = 0; i < count; i++)
+        remove(entries[i].path);
 
     // continue
     return tb_true;
 }
-static tb_bool_t tb_directory_walk_copy(tb_char_t const* path, tb_file_info_t const* info, tb_cpointer_t priv)
+static tb_bool_t tb_directory_walk_copy(tb_directory_entry_t const* entries, tb_size_t count, tb_cpointer_t priv)
 {
     // check
     tb_value_t* tuple = (tb_value_t*)priv;
-    tb_assert_and_check_return_val(path && info && priv, tb_false);
+    tb_assert_and_check_return_val(entries && priv, tb_false);
 
     // the dest directory
     tb_char_t const* dest = tuple[0].cstr;
     tb_assert_and_check_return_val(dest, tb_false);
 
-    // the file name
-    tb_size_t size = tuple[1].ul;
-    tb_char_t const* name = path + size;
-
-    // the dest file path
-    tb_char_t dpath[8192] = {0};
-    tb_snprintf(dpath, 8192, "%s/%s", dest, name[0] == '/'? name + 1 : name);
-
-    // remove the dest file first
-    tb_file_info_t dinfo = {0};
-    if (tb_file_info(dpath, &dinfo))
+    // copy all entries, they may be copied in the different threads at the same time
+    tb_size_t i = 0;
+    for (i = 0; i < count; i++)
     {
-        if (dinfo.type == TB_FILE_TYPE_FILE)
-            tb_file_remove(dpath);
-        if (dinfo.type == TB_FILE_TYPE_DIRECTORY)
-            tb_directory_remove(dpath);
-    }
+        // the file name
+        tb_size_t size = tuple[1].ul;
+        tb_char_t const* path = entries[i].path;
+        tb_char_t const* name = path + size;
+
+        // the dest file path
+        tb_char_t dpath[8192] = {0};
+        tb_snprintf(dpath, 8192, "%s/%s", dest, name[0] == '/'? name + 1 : name);
+
+        // remove the dest file first
+        tb_file_info_t dinfo = {0};
+        if (tb_file_info(dpath, &dinfo))
+        {
+            if (dinfo.type == TB_FILE_TYPE_FILE)
+                tb_file_remove(dpath);
+            if (dinfo.type == TB_FILE_TYPE_DIRECTORY)
+                tb_directory_remove(dpath);
+        }
 
-    // copy
-    switch (info->type)
-    {
-    case TB_FILE_TYPE_FILE:
-        if (!tb_file_copy(path, dpath)) tuple[2].b = tb_false;
-        break;
-    case TB_FILE_TYPE_DIRECTORY:
-        if (!tb_directory_create(dpath)) tuple[2].b = tb_false;
-        break;
-    default:
-        break;
+        // copy
+        switch (entries[i].info.type)
+        {
+        case TB_FILE_TYPE_FILE:
+            if (!tb_file_copy(path, dpath)) tb_atomic_set(&tuple[2].a, 0);
+            break;
+        case TB_FILE_TYPE_DIRECTORY:
+            if (!tb_directory_create(dpath)) tb_atomic_set(&tuple[2].a, 0);
+            break;
+        default:
+            break;
+        }
     }
 
     // continue
@@ -200,8 +209,8 @@ tb_bool_t tb_directory_remove(tb_char_t const* path)
     path = tb_path_absolute(path, full, TB_PATH_MAXN);
     tb_assert_and_check_return_val(path, tb_false);
 
-    // walk remove
-    tb_directory_walk_impl(path, -1, tb_false, tb_directory_walk_remove, tb_null);
+    // walk remove, the directory is removed after all files in it
+    tb_directory_walk_batch(path, -1, TB_DIRECTORY_WALK_FLAG_TYPEONLY | TB_DIRECTORY_WALK_FLAG_PARALLEL, tb_directory_walk_remove, tb_null);
 
     // remove it
     return !remove(path)? tb_true : tb_false;
@@ -286,15 +295,15 @@ tb_bool_t tb_directory_copy(tb_char_t const* path, tb_char_t const* dest)
     dest = tb_path_absolute(dest, full1, TB_PATH_MAXN);
     tb_assert_and_check_return_val(dest, tb_false);
 
-    // walk copy
+    // walk copy, the directory is created before all files in it
     tb_value_t tuple[3];
     tuple[0].cstr = dest;
     tuple[1].ul = tb_strlen(path);
-    tuple[2].b = tb_true;
-    tb_directory_walk_impl(path, -1, tb_true, tb_directory_walk_copy, tuple);
+    tb_atomic_init(&tuple[2].a, 1);
+    tb_directory_walk_batch(path, -1, TB_DIRECTORY_WALK_FLAG_PREFIX | TB_DIRECTORY_WALK_FLAG_TYPEONLY | TB_DIRECTORY_WALK_FLAG_PARALLEL, tb_directory_walk_copy, tuple);
 
     // ok?
-    tb_bool_t ok = tuple[2].b;
+    tb_bool_t ok = tb_atomic_get(&tuple[2].a)? tb_true : tb_false;
 
     // copy empty directory?
     if (ok && !tb_file_info(dest, tb_null))
@@ -0,0 +1,739 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        directory_walk.c
+ * @ingroup     platform
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "../cpu.h"
+#include "../path.h"
+#include "../atomic.h"
+#include "../spinlock.h"
+#include "../semaphore.h"
+#include "../directory.h"
+#include "../thread_pool.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#ifdef TB_CONFIG_OS_LINUX
+#   include <sys/syscall.h>
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the entries count of each batch
+#ifdef __tb_small__
+#   define TB_DIRECTORY_WALK_BATCH_MAXN     (64)
+#else
+#   define TB_DIRECTORY_WALK_BATCH_MAXN     (256)
+#endif
+
+// the buffer size of getdents64
+#ifdef __tb_small__
+#   define TB_DIRECTORY_WALK_DENTS_SIZE     (8192)
+#else
+#   define TB_DIRECTORY_WALK_DENTS_SIZE     (32768)
+#endif
+
+// the maximum depth of the opened parent directories, the deeper directories will be opened by the full path
+#define TB_DIRECTORY_WALK_DEPTH_MAXN        (16)
+
+// the maximum pending subtrees count of each helper
+#define TB_DIRECTORY_WALK_QUEUE_MAXN        (16)
+
+// use getdents64 directly?
+#if defined(TB_CONFIG_OS_LINUX) && defined(SYS_getdents64)
+#   define TB_DIRECTORY_WALK_HAVE_GETDENTS64
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+#ifdef TB_DIRECTORY_WALK_HAVE_GETDENTS64
+// the linux dirent64 type
+typedef struct __tb_directory_walk_dirent64_t
+{
+    tb_uint64_t                         d_ino;
+    tb_int64_t                          d_off;
+    tb_uint16_t                         d_reclen;
+    tb_uint8_t                          d_type;
+    tb_char_t                           d_name[1];
+
+}tb_directory_walk_dirent64_t;
+#endif
+
+// the walk entry type
+typedef struct __tb_directory_walk_entry_t
+{
+    // the path offset in the names
+    tb_size_t                           path;
+
+    // the path size
+    tb_size_t                           size;
+
+    // the name offset in the names
+    tb_size_t                           name;
+
+    // the file info
+    tb_file_info_t                      info;
+
+}tb_directory_walk_entry_t;
+
+// the walk entries list type
+typedef struct __tb_directory_walk_list_t
+{
+    // the entries
+    tb_directory_walk_entry_t*          entries;
+
+    // the entries count
+    tb_size_t                           size;
+
+    // the entries maxn
+    tb_size_t                           maxn;
+
+    // the path names
+    tb_char_t*                          names;
+
+    // the path names size
+    tb_size_t                           names_size;
+
+    // the path names maxn
+    tb_size_t                           names_maxn;
+
+}tb_directory_walk_list_t;
+
+/* the walk node type of the parallel walk
+ *
+ * it will be released after the directory and all its subtrees are finished,
+ * and then the subdirectories will be passed to the callback for the postfix walk.
+ */
+typedef struct __tb_directory_walk_node_t
+{
+    // the parent node
+    struct __tb_directory_walk_node_t*  parent;
+
+    // the reference count
+    tb_atomic32_t                       refn;
+
+    // the subdirectories for the postfix walk
+    tb_directory_walk_list_t            dirs;
+
+}tb_directory_walk_node_t;
+
+// the pending subtree type of the parallel walk
+typedef struct __tb_directory_walk_item_t
+{
+    // the directory path
+    tb_char_t*                          path;
+
+    // the path size
+    tb_size_t                           size;
+
+    // the recursion level
+    tb_long_t                           recursion;
+
+    // the parent node
+    tb_directory_walk_node_t*           node;
+
+}tb_directory_walk_item_t;
+
+// the directory walker type
+typedef struct __tb_directory_walker_t
+{
+    // the callback func
+    tb_directory_walk_batch_func_t      func;
+
+    // the callback priv
+    tb_cpointer_t                       priv;
+
+    // the walk flags
+    tb_size_t                           flags;
+
+    // the reference count, the caller and all posted helpers
+    tb_atomic32_t                       refn;
+
+    // is stopped?
+    tb_atomic32_t                       stop;
+
+    // is finished?
+    tb_atomic32_t                       finished;
+
+    // the thread pool, only for the parallel walk
+    tb_thread_pool_ref_t                pool;
+
+    // the semaphore to notify the caller
+    tb_semaphore_ref_t                  semaphore;
+
+    // the lock of the pending queue and helpers
+    tb_spinlock_t                       lock;
+
+    // the pending subtrees
+    tb_directory_walk_item_t*           queue;
+
+    // the pending subtrees count
+    tb_size_t                           queue_size;
+
+    // the pending subtrees maxn
+    tb_size_t                           queue_maxn;
+
+    // the posted helpers count
+    tb_size_t                           helpers;
+
+    // the posted helpers maxn
+    tb_size_t                           helpers_maxn;
+
+}tb_directory_walker_t;
+
+// the walk context type of each walking thread
+typedef struct __tb_directory_walk_context_t
+{
+    // the walker
+    tb_directory_walker_t*              walker;
+
+#ifdef TB_DIRECTORY_WALK_HAVE_GETDENTS64
+    // the getdents64 buffer
+    tb_byte_t*                          dents;
+#endif
+
+    // the pending files of the current directory
+    tb_directory_walk_list_t            files;
+
+}tb_directory_walk_context_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * declaration
+ */
+static tb_void_t tb_directory_walk_dir(tb_directory_walk_context_t* context, tb_int_t parentfd, tb_char_t const* name, tb_char_t const* path, tb_size_t size, tb_long_t recursion, tb_size_t depth, tb_directory_walk_node_t* parent);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_bool_t tb_directory_walk_list_push(tb_directory_walk_list_t* list, tb_char_t const* path, tb_size_t size, tb_char_t const* name, tb_file_info_t const* info)
+{
+    // grow entries
+    if (list->size == list->maxn)
+    {
+        tb_size_t maxn = list->maxn? (list->maxn << 1) : 16;
+        tb_directory_walk_entry_t* entries = (tb_directory_walk_entry_t*)tb_ralloc(list->entries, maxn * sizeof(tb_directory_walk_entry_t));
+        tb_assert_and_check_return_val(entries, tb_false);
+
+        list->entries   = entries;
+        list->maxn      = maxn;
+    }
+
+    // grow names, "path/name\0"
+    tb_size_t namesize  = tb_strlen(name);
+    tb_size_t separator = (size && path[size - 1] != '/')? 1 : 0;
+    tb_size_t need      = size + separator + namesize + 1;
+    if (list->names_size + need > list->names_maxn)
+    {
+        tb_size_t maxn = tb_max(list->names_maxn << 1, list->names_size + need + 1024);
+        tb_char_t* names = (tb_char_t*)tb_ralloc(list->names, maxn);
+        tb_assert_and_check_return_val(names, tb_false);
+
+        list->names         = names;
+        list->names_maxn    = maxn;
+    }
+
+    // append the path
+    tb_char_t* p = list->names + list->names_size;
+    tb_memcpy(p, path, size);
+    if (separator) p[size] = '/';
+    tb_memcpy(p + size + separator, name, namesize + 1);
+
+    // append the entry
+    tb_directory_walk_entry_t* entry = &list->entries[list->size++];
+    entry->path = list->names_size;
+    entry->size = need - 1;
+    entry->name = list->names_size + size + separator;
+    entry->info = *info;
+    list->names_size += need;
+    return tb_true;
+}
+static __tb_inline__ tb_void_t tb_directory_walk_list_clear(tb_directory_walk_list_t* list)
+{
+    list->size          = 0;
+    list->names_size    = 0;
+}
+static tb_void_t tb_directory_walk_list_exit(tb_directory_walk_list_t* list)
+{
+    if (list->entries) tb_free(list->entries);
+    if (list->names) tb_free(list->names);
+    tb_memset(list, 0, sizeof(tb_directory_walk_list_t));
+}
+static tb_void_t tb_directory_walk_list_emit(tb_directory_walker_t* walker, tb_directory_walk_list_t* list)
+{
+    // pass all entries by batches
+    tb_size_t               i = 0;
+    tb_directory_entry_t    entries[TB_DIRECTORY_WALK_BATCH_MAXN];
+    while (i < list->size && !tb_atomic32_get(&walker->stop))
+    {
+        // make batch
+        tb_size_t n = 0;
+        for (; n < TB_DIRECTORY_WALK_BATCH_MAXN && i < list->size; n++, i++)
+        {
+            tb_directory_walk_entry_t const* entry = &list->entries[i];
+            entries[n].path = list->names + entry->path;
+            entries[n].name = list->names + entry->name;
+            entries[n].info = entry->info;
+        }
+
+        // do callback
+        if (!walker->func(entries, n, walker->priv))
+            tb_atomic32_set(&walker->stop, 1);
+    }
+}
+static tb_void_t tb_directory_walk_info(tb_int_t fd, tb_char_t const* name, tb_size_t type, tb_size_t flags, tb_file_info_t* info)
+{
+#ifdef DT_UNKNOWN
+    // only need the file type? we need not stat it if the file system has given it
+    if ((flags & TB_DIRECTORY_WALK_FLAG_TYPEONLY) && type != DT_UNKNOWN && type != DT_LNK)
+    {
+        info->type = type == DT_DIR? TB_FILE_TYPE_DIRECTORY : TB_FILE_TYPE_FILE;
+        return ;
+    }
+#endif
+
+    // stat it relative to the directory, the dead symbol link will be none type
+#ifdef TB_CONFIG_POSIX_HAVE_FSTATAT64
+    struct stat64 st;
+    if (!fstatat64(fd, name, &st, 0))
+#else
+    struct stat st;
+    if (!fstatat(fd, name, &st, 0))
+#endif
+    {
+        info->type  = S_ISDIR(st.st_mode)? TB_FILE_TYPE_DIRECTORY : TB_FILE_TYPE_FILE;
+        info->size  = st.st_size >= 0? (tb_hize_t)st.st_size : 0;
+        info->atime = (tb_time_t)st.st_atime;
+        info->mtime = (tb_time_t)st.st_mtime;
+    }
+}
+static tb_void_t tb_directory_walk_item(tb_directory_walk_context_t* context, tb_int_t fd, tb_char_t const* path, tb_size_t size, tb_char_t const* name, tb_size_t type, tb_directory_walk_list_t* dirs)
+{
+    // skip "." and ".."
+    if (name[0] == '.' && (!name[1] || (name[1] == '.' && !name[2]))) return ;
+
+    // get the file info
+    tb_file_info_t info = {0};
+    tb_directory_walk_info(fd, name, type, context->walker->flags, &info);
+
+    // save the directory, we will walk it after reading this directory
+    if (info.type == TB_FILE_TYPE_DIRECTORY)
+        tb_directory_walk_list_push(dirs, path, size, name, &info);
+    // pass the file batch if it is full
+    else if (tb_directory_walk_list_push(&context->files, path, size, name, &info) && context->files.size >= TB_DIRECTORY_WALK_BATCH_MAXN)
+    {
+        tb_directory_walk_list_emit(context->walker, &context->files);
+        tb_directory_walk_list_clear(&context->files);
+    }
+}
+static tb_void_t tb_directory_walk_read(tb_directory_walk_context_t* context, tb_int_t fd, tb_char_t const* path, tb_size_t size, tb_directory_walk_list_t* dirs)
+{
+    // the walker
+    tb_directory_walker_t* walker = context->walker;
+
+#ifdef TB_DIRECTORY_WALK_HAVE_GETDENTS64
+    // read the directory entries by the large buffer
+    tb_long_t real = 0;
+    while (!tb_atomic32_get(&walker->stop) && (real = syscall(SYS_getdents64, fd, context->dents, TB_DIRECTORY_WALK_DENTS_SIZE)) > 0)
+    {
+        tb_long_t pos = 0;
+        while (pos < real)
+        {
+            tb_directory_walk_dirent64_t* item = (tb_directory_walk_dirent64_t*)(context->dents + pos);
+            tb_directory_walk_item(context, fd, path, size, item->d_name, item->d_type, dirs);
+            pos += item->d_reclen;
+        }
+    }
+#else
+    // read the directory entries by the duplicated fd, because closedir() will close it
+    tb_int_t    dupfd = dup(fd);
+    DIR*        directory = dupfd >= 0? fdopendir(dupfd) : tb_null;
+    if (directory)
+    {
+        struct dirent* item = tb_null;
+        while (!tb_atomic32_get(&walker->stop) && (item = readdir(directory)))
+        {
+#   ifdef DT_UNKNOWN
+            tb_directory_walk_item(context, fd, path, size, item->d_name, item->d_type, dirs);
+#   else
+            tb_directory_walk_item(context, fd, path, size, item->d_name, 0, dirs);
+#   endif
+        }
+        closedir(directory);
+    }
+    else if (dupfd >= 0) close(dupfd);
+#endif
+
+    // pass the remaining files
+    tb_directory_walk_list_emit(walker, &context->files);
+    tb_directory_walk_list_clear(&context->files);
+}
+static tb_directory_walk_node_t* tb_directory_walk_node_init(tb_directory_walk_node_t* parent)
+{
+    // make node
+    tb_directory_walk_node_t* node = tb_malloc0_type(tb_directory_walk_node_t);
+    tb_assert_and_check_return_val(node, tb_null);
+
+    // init node, the parent will be released after this node is released
+    node->parent = parent;
+    tb_atomic32_init(&node->refn, 1);
+    if (parent) tb_atomic32_fetch_and_add(&parent->refn, 1);
+    return node;
+}
+static tb_void_t tb_directory_walk_node_exit(tb_directory_walker_t* walker, tb_directory_walk_node_t* node)
+{
+    // release nodes to the root
+    while (node && tb_atomic32_fetch_and_sub(&node->refn, 1) == 1)
+    {
+        // all subtrees are finished, now pass the subdirectories for the postfix walk
+        tb_directory_walk_list_emit(walker, &node->dirs);
+
+        // exit node
+        tb_directory_walk_node_t* parent = node->parent;
+        tb_directory_walk_list_exit(&node->dirs);
+        tb_free(node);
+
+        // the root node is released? notify the caller
+        if (!parent)
+        {
+            tb_atomic32_set(&walker->finished, 1);
+            tb_semaphore_post(walker->semaphore, 1);
+        }
+        node = parent;
+    }
+}
+static tb_void_t tb_directory_walker_exit(tb_directory_walker_t* walker)
+{
+    // release it
+    tb_check_return(tb_atomic32_fetch_and_sub(&walker->refn, 1) == 1);
+
+    // exit semaphore
+    if (walker->semaphore) tb_semaphore_exit(walker->semaphore);
+    walker->semaphore = tb_null;
+
+    // exit lock
+    tb_spinlock_exit(&walker->lock);
+
+    // exit queue, it is empty now
+    if (walker->queue) tb_free(walker->queue);
+    walker->queue = tb_null;
+
+    // exit it
+    tb_free(walker);
+}
+static tb_bool_t tb_directory_walk_context_init(tb_directory_walk_context_t* context, tb_directory_walker_t* walker)
+{
+    // init context
+    tb_memset(context, 0, sizeof(tb_directory_walk_context_t));
+    context->walker = walker;
+
+#ifdef TB_DIRECTORY_WALK_HAVE_GETDENTS64
+    // init the getdents64 buffer
+    context->dents = tb_malloc_bytes(TB_DIRECTORY_WALK_DENTS_SIZE);
+    tb_assert_and_check_return_val(context->dents, tb_false);
+#endif
+    return tb_true;
+}
+static tb_void_t tb_directory_walk_context_exit(tb_directory_walk_context_t* context)
+{
+#ifdef TB_DIRECTORY_WALK_HAVE_GETDENTS64
+    if (context->dents) tb_free(context->dents);
+    context->dents = tb_null;
+#endif
+    tb_directory_walk_list_exit(&context->files);
+}
+static tb_void_t tb_directory_walk_helper_done(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv);
+static tb_void_t tb_directory_walk_helper_exit(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv);
+static tb_bool_t tb_directory_walk_push(tb_directory_walker_t* walker, tb_char_t const* path, tb_size_t size, tb_long_t recursion, tb_directory_walk_node_t* node)
+{
+    // the queue is full? we walk it in the current thread
+    tb_check_return_val(walker->queue_size < walker->queue_maxn, tb_false);
+
+    // copy path
+    tb_char_t* data = (tb_char_t*)tb_malloc_bytes(size + 1);
+    tb_assert_and_check_return_val(data, tb_false);
+    tb_memcpy(data, path, size + 1);
+
+    // hold the parent node before pushing it, it may be walked and released by other thread at once
+    tb_atomic32_fetch_and_add(&node->refn, 1);
+
+    // push it
+    tb_bool_t ok = tb_false;
+    tb_bool_t post = tb_false;
+    tb_spinlock_enter(&walker->lock);
+    if (walker->queue_size < walker->queue_maxn)
+    {
+        tb_directory_walk_item_t* item = &walker->queue[walker->queue_size++];
+        item->path      = data;
+        item->size      = size;
+        item->recursion = recursion;
+        item->node      = node;
+        ok = tb_true;
+
+        // need post more helpers?
+        if (walker->helpers < walker->helpers_maxn)
+        {
+            walker->helpers++;
+            post = tb_true;
+        }
+    }
+    tb_spinlock_leave(&walker->lock);
+
+    // failed? restore it
+    if (!ok)
+    {
+        tb_atomic32_fetch_and_sub(&node->refn, 1);
+        tb_free(data);
+        return tb_false;
+    }
+
+    // post a helper to the thread pool
+    if (post)
+    {
+        tb_atomic32_fetch_and_add(&walker->refn, 1);
+        if (!tb_thread_pool_task_post(walker->pool, "directory_walk", tb_directory_walk_helper_done, tb_directory_walk_helper_exit, walker, tb_false))
+            tb_directory_walk_helper_exit(tb_null, walker);
+    }
+
+    // notify the caller to help walking it
+    tb_semaphore_post(walker->semaphore, 1);
+    return tb_true;
+}
+static tb_bool_t tb_directory_walk_pop(tb_directory_walker_t* walker, tb_directory_walk_item_t* item)
+{
+    // pop the last subtree, it is the nearest directory
+    tb_bool_t ok = tb_false;
+    tb_spinlock_enter(&walker->lock);
+    if (walker->queue_size)
+    {
+        *item = walker->queue[--walker->queue_size];
+        ok = tb_true;
+    }
+    tb_spinlock_leave(&walker->lock);
+    return ok;
+}
+static tb_void_t tb_directory_walk_pop_all(tb_directory_walk_context_t* context)
+{
+    // walk all pending subtrees, we need release their nodes even if it has been stopped
+    tb_directory_walk_item_t item;
+    while (tb_directory_walk_pop(context->walker, &item))
+    {
+        tb_directory_walk_dir(context, -1, tb_null, item.path, item.size, item.recursion, 0, item.node);
+        tb_directory_walk_node_exit(context->walker, item.node);
+        tb_free(item.path);
+    }
+}
+static tb_void_t tb_directory_walk_helper_done(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // check
+    tb_directory_walker_t* walker = (tb_directory_walker_t*)priv;
+    tb_assert_and_check_return(walker);
+
+    // walk all pending subtrees
+    tb_directory_walk_context_t context;
+    if (tb_directory_walk_context_init(&context, walker))
+        tb_directory_walk_pop_all(&context);
+    tb_directory_walk_context_exit(&context);
+}
+static tb_void_t tb_directory_walk_helper_exit(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // check
+    tb_directory_walker_t* walker = (tb_directory_walker_t*)priv;
+    tb_assert_and_check_return(walker);
+
+    // this helper is finished, the caller will walk the remaining subtrees
+    tb_spinlock_enter(&walker->lock);
+    walker->helpers--;
+    tb_spinlock_leave(&walker->lock);
+
+    // release walker
+    tb_directory_walker_exit(walker);
+}
+static tb_void_t tb_directory_walk_dir(tb_directory_walk_context_t* context, tb_int_t parentfd, tb_char_t const* name, tb_char_t const* path, tb_size_t size, tb_long_t recursion, tb_size_t depth, tb_directory_walk_node_t* parent)
+{
+    // the walker
+    tb_directory_walker_t* walker = context->walker;
+    tb_check_return(!tb_atomic32_get(&walker->stop));
+
+    // open directory relative to the parent directory
+    tb_int_t fd = openat(parentfd >= 0? parentfd : AT_FDCWD, parentfd >= 0? name : path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    tb_check_return(fd >= 0);
+
+    // init node for the parallel walk
+    tb_directory_walk_node_t* node = tb_null;
+    if (walker->pool)
+    {
+        node = tb_directory_walk_node_init(parent);
+        if (!node)
+        {
+            close(fd);
+            return ;
+        }
+    }
+
+    // read all entries
+    tb_directory_walk_list_t dirs = {0};
+    tb_directory_walk_read(context, fd, path, size, &dirs);
+
+    // pass subdirectories before walking them for the prefix walk
+    tb_bool_t prefix = (walker->flags & TB_DIRECTORY_WALK_FLAG_PREFIX)? tb_true : tb_false;
+    if (prefix) tb_directory_walk_list_emit(walker, &dirs);
+
+    // walk subdirectories
+    if (recursion)
+    {
+        // too deep? close it to limit the opened fds, we open the subdirectories by the full path
+        if (depth >= TB_DIRECTORY_WALK_DEPTH_MAXN)
+        {
+            close(fd);
+            fd = -1;
+        }
+
+        // walk them in the thread pool or the current thread
+        tb_size_t i = 0;
+        for (i = 0; i < dirs.size && !tb_atomic32_get(&walker->stop); i++)
+        {
+            tb_directory_walk_entry_t const* entry = &dirs.entries[i];
+            tb_char_t const* subpath = dirs.names + entry->path;
+            if (node && tb_directory_walk_push(walker, subpath, entry->size, recursion > 0? recursion - 1 : recursion, node))
+                continue ;
+
+            tb_directory_walk_dir(context, fd, dirs.names + entry->name, subpath, entry->size, recursion > 0? recursion - 1 : recursion, depth + 1, node);
+        }
+    }
+
+    // exit directory
+    if (fd >= 0) close(fd);
+
+    // pass subdirectories after walking them for the postfix walk
+    if (node)
+    {
+        // the subtrees in the thread pool may be not finished, we pass them after releasing this node
+        if (!prefix)
+        {
+            node->dirs = dirs;
+            tb_memset(&dirs, 0, sizeof(tb_directory_walk_list_t));
+        }
+        tb_directory_walk_node_exit(walker, node);
+    }
+    else if (!prefix) tb_directory_walk_list_emit(walker, &dirs);
+    tb_directory_walk_list_exit(&dirs);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_void_t tb_directory_walk_batch(tb_char_t const* path, tb_long_t recursion, tb_size_t flags, tb_directory_walk_batch_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_assert_and_check_return(path && func);
+
+    // the absolute path (translate "~/")
+    tb_char_t full[TB_PATH_MAXN];
+    if (!tb_path_is_absolute(path))
+    {
+        path = tb_path_absolute(path, full, TB_PATH_MAXN);
+        tb_assert_and_check_return(path);
+    }
+
+    // remove the trailing separators, the opened path need not be trimmed
+    tb_size_t size = tb_strlen(path);
+    while (size > 1 && path[size - 1] == '/') size--;
+    tb_assert_and_check_return(size);
+
+    // done
+    tb_bool_t                   ok = tb_false;
+    tb_directory_walker_t*      walker = tb_null;
+    tb_directory_walk_context_t context = {0};
+    do
+    {
+        // make walker
+        walker = tb_malloc0_type(tb_directory_walker_t);
+        tb_assert_and_check_break(walker);
+
+        // init walker
+        walker->func    = func;
+        walker->priv    = priv;
+        walker->flags   = flags;
+        tb_atomic32_init(&walker->refn, 1);
+        tb_atomic32_init(&walker->stop, 0);
+        tb_atomic32_init(&walker->finished, 0);
+        if (!tb_spinlock_init(&walker->lock)) break;
+
+        // init the thread pool and pending queue for the parallel walk
+        if ((flags & TB_DIRECTORY_WALK_FLAG_PARALLEL) && recursion && (walker->pool = tb_thread_pool()))
+        {
+            walker->helpers_maxn    = tb_max(tb_cpu_count(), 1);
+            walker->queue_maxn      = walker->helpers_maxn * TB_DIRECTORY_WALK_QUEUE_MAXN;
+            walker->queue           = tb_nalloc0_type(walker->queue_maxn, tb_directory_walk_item_t);
+            walker->semaphore       = tb_semaphore_init(0);
+            tb_assert_and_check_break(walker->queue && walker->semaphore);
+        }
+
+        // init context
+        if (!tb_directory_walk_context_init(&context, walker)) break;
+
+        // walk it
+        if (walker->pool)
+        {
+            // the root node will be released after all subtrees are finished
+            tb_directory_walk_node_t* root = tb_directory_walk_node_init(tb_null);
+            tb_assert_and_check_break(root);
+
+            // walk the root directory and release the root node
+            tb_directory_walk_dir(&context, -1, tb_null, path, size, recursion, 0, root);
+            tb_directory_walk_node_exit(walker, root);
+
+            // help the thread pool to walk the pending subtrees until all subtrees are finished
+            while (!tb_atomic32_get(&walker->finished))
+            {
+                tb_directory_walk_pop_all(&context);
+                if (!tb_atomic32_get(&walker->finished))
+                    tb_semaphore_wait(walker->semaphore, -1);
+            }
+        }
+        else tb_directory_walk_dir(&context, -1, tb_null, path, size, recursion, 0, tb_null);
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        // trace
+        tb_trace_e("walk %s failed!", path);
+    }
+
+    // exit context
+    tb_directory_walk_context_exit(&context);
+
+    // exit walker, the helpers in the thread pool may be still holding it
+    if (walker) tb_directory_walker_exit(walker);
+}
@@ -26,6 +26,7 @@
 #include "../file.h"
 #include "../path.h"
 #include "../directory.h"
+#include "../page.h"
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -40,6 +41,9 @@
 #ifdef TB_CONFIG_POSIX_HAVE_SENDFILE
 #   include <sys/sendfile.h>
 #endif
+#ifdef TB_CONFIG_POSIX_HAVE_MMAP
+#   include <sys/mman.h>
+#endif
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
@@ -178,6 +182,112 @@ tb_hize_t tb_file_size(tb_file_ref_t file)
     // ok?
     return size;
 }
+tb_byte_t* tb_file_mmap(tb_file_ref_t file, tb_hize_t offset, tb_size_t size, tb_size_t flags)
+{
+    // check
+    tb_assert_and_check_return_val(file && size, tb_null);
+
+#ifdef TB_CONFIG_POSIX_HAVE_MMAP
+    // the page size
+    tb_size_t pagesize = tb_page_size();
+    tb_assert_and_check_return_val(pagesize, tb_null);
+
+    // the offset must be aligned by the page size
+    tb_size_t delta = (tb_size_t)(offset & (pagesize - 1));
+
+    // the protection
+    tb_int_t prot = PROT_READ;
+    if (flags & TB_FILE_MMAP_WRITE) prot |= PROT_WRITE;
+
+    // the mapping flags
+    tb_int_t mapflags = (flags & TB_FILE_MMAP_PRIVATE)? MAP_PRIVATE : MAP_SHARED;
+#   ifdef MAP_POPULATE
+    if (flags & TB_FILE_MMAP_POPULATE) mapflags |= MAP_POPULATE;
+#   endif
+
+    // map it
+    tb_pointer_t base = mmap(tb_null, size + delta, prot, mapflags, tb_file2fd(file), (off_t)(offset - delta));
+    if (base == MAP_FAILED)
+    {
+        // trace
+        tb_trace_d("mmap: %p, offset: %llu, size: %lu failed, errno: %d", file, offset, size, errno);
+        return tb_null;
+    }
+
+    // attempt to use the transparent huge pages
+#   if defined(TB_CONFIG_POSIX_HAVE_MADVISE) && defined(MADV_HUGEPAGE)
+    if (flags & TB_FILE_MMAP_HUGEPAGE) madvise(base, size + delta, MADV_HUGEPAGE);
+#   endif
+
+    // ok
+    return (tb_byte_t*)base + delta;
+#else
+    tb_trace_noimpl();
+    return tb_null;
+#endif
+}
+tb_bool_t tb_file_munmap(tb_byte_t* data, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(data && size, tb_false);
+
+#ifdef TB_CONFIG_POSIX_HAVE_MMAP
+    // get the page-aligned base address
+    tb_size_t  pagesize = tb_page_size();
+    tb_byte_t* base = (tb_byte_t*)((tb_size_t)data & ~(pagesize - 1));
+
+    // unmap it
+    return !munmap(base, size + (data - base))? tb_true : tb_false;
+#else
+    tb_trace_noimpl();
+    return tb_false;
+#endif
+}
+tb_bool_t tb_file_madvise(tb_byte_t* data, tb_size_t size, tb_size_t advice)
+{
+    // check
+    tb_assert_and_check_return_val(data && size, tb_false);
+
+#if defined(TB_CONFIG_POSIX_HAVE_MMAP) && defined(TB_CONFIG_POSIX_HAVE_MADVISE)
+    // the advice
+    tb_int_t advise = MADV_NORMAL;
+    switch (advice)
+    {
+    case TB_FILE_MADVISE_SEQUENTIAL:    advise = MADV_SEQUENTIAL;   break;
+    case TB_FILE_MADVISE_RANDOM:        advise = MADV_RANDOM;       break;
+    case TB_FILE_MADVISE_WILLNEED:      advise = MADV_WILLNEED;     break;
+    case TB_FILE_MADVISE_DONTNEED:      advise = MADV_DONTNEED;     break;
+    default:                                                        break;
+    }
+
+    // get the page-aligned base address
+    tb_size_t  pagesize = tb_page_size();
+    tb_byte_t* base = (tb_byte_t*)((tb_size_t)data & ~(pagesize - 1));
+
+    // advise it
+    return !madvise(base, size + (data - base), advise)? tb_true : tb_false;
+#else
+    // it is only a hint, so we ignore it
+    return tb_true;
+#endif
+}
+tb_bool_t tb_file_msync(tb_byte_t* data, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(data && size, tb_false);
+
+#ifdef TB_CONFIG_POSIX_HAVE_MMAP
+    // get the page-aligned base address
+    tb_size_t  pagesize = tb_page_size();
+    tb_byte_t* base = (tb_byte_t*)((tb_size_t)data & ~(pagesize - 1));
+
+    // sync it
+    return !msync(base, size + (data - base), MS_SYNC)? tb_true : tb_false;
+#else
+    tb_trace_noimpl();
+    return tb_false;
+#endif
+}
 tb_bool_t tb_file_info(tb_char_t const* path, tb_file_info_t* info)
 {
     // check
@@ -280,6 +390,28 @@ tb_hong_t tb_file_writf(tb_file_ref_t file, tb_file_ref_t ifile, tb_hize_t offse
     // check
     tb_assert_and_check_return_val(file && ifile && size, -1);
 
+#ifdef TB_CONFIG_POSIX_HAVE_COPY_FILE_RANGE
+    {
+        // copy it in the kernel, it may use reflink on some filesystems
+        loff_t      seek = offset;
+        tb_hong_t   real = -1;
+        do
+        {
+            real = copy_file_range(tb_file2fd(ifile), &seek, tb_file2fd(file), tb_null, (size_t)size, 0);
+
+        } while (real < 0 && errno == EINTR);
+
+        // ok?
+        if (real >= 0) return real;
+
+        // continue?
+        if (errno == EAGAIN) return 0;
+
+        // not supported? (e.g. cross-filesystem on old kernels) try other ways
+        if (errno != EXDEV && errno != ENOSYS && errno != EINVAL && errno != EOPNOTSUPP) return -1;
+    }
+#endif
+
 #ifdef TB_CONFIG_POSIX_HAVE_SENDFILE
 
     // writ it
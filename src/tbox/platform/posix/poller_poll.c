@@ -284,7 +284,7 @@ static tb_long_t tb_poller_poll_wait(tb_poller_t* self, tb_poller_event_func_t f
             tb_size_t events = TB_POLLER_EVENT_NONE;
             if (poll_events & POLLIN) events |= TB_POLLER_EVENT_RECV;
             if (poll_events & POLLOUT) events |= TB_POLLER_EVENT_SEND;
-            if ((poll_events & POLLHUP) && !(events & (TB_POLLER_EVENT_RECV | TB_POLLER_EVENT_SEND)))
+            if ((poll_events & (POLLHUP | POLLERR)) && !(events & (TB_POLLER_EVENT_RECV | TB_POLLER_EVENT_SEND)))
                 events |= TB_POLLER_EVENT_RECV | TB_POLLER_EVENT_SEND;
 
             // call event function
@@ -41,6 +41,10 @@
 #ifdef TB_CONFIG_POSIX_HAVE_SENDFILE
 #   include <sys/sendfile.h>
 #endif
+#if defined(TB_CONFIG_OS_LINUX) || defined(TB_CONFIG_OS_ANDROID)
+#   include <netinet/udp.h>
+#   include <linux/errqueue.h>
+#endif
 #ifdef TB_CONFIG_MODULE_HAVE_COROUTINE
 #   include "../../coroutine/coroutine.h"
 #   include "../../coroutine/impl/impl.h"
@@ -55,6 +59,32 @@
 #   define SO_NOSIGPIPE MSG_NOSIGNAL
 #endif
 
+// the udp segment options, they may be not defined in the old libc headers
+#if defined(TB_CONFIG_OS_LINUX) || defined(TB_CONFIG_OS_ANDROID)
+#   ifndef SOL_UDP
+#       define SOL_UDP          (17)
+#   endif
+#   ifndef UDP_SEGMENT
+#       define UDP_SEGMENT      (103)
+#   endif
+#   ifndef UDP_GRO
+#       define UDP_GRO          (104)
+#   endif
+#endif
+
+// enable the zero-copy sending?
+#if (defined(TB_CONFIG_OS_LINUX) || defined(TB_CONFIG_OS_ANDROID)) \
+        && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY) && defined(SO_EE_ORIGIN_ZEROCOPY)
+#   define TB_SOCKET_ZEROCOPY_ENABLE
+#endif
+
+// the maximum message count of sendmmsg/recvmmsg in one call
+#ifdef __tb_small__
+#   define TB_SOCKET_UMSG_MAXN  (16)
+#else
+#   define TB_SOCKET_UMSG_MAXN  (32)
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * private implementation
  */
@@ -335,6 +365,33 @@ tb_bool_t tb_socket_ctrl(tb_socket_ref_t sock, tb_size_t ctrl, ...)
                 ok = tb_true;
         }
         break;
+#endif
+#ifdef TB_SOCKET_ZEROCOPY_ENABLE
+    case TB_SOCKET_CTRL_SET_ZEROCOPY:
+        {
+            tb_int_t enable = (tb_int_t)tb_va_arg(args, tb_bool_t);
+            if (!setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, (tb_char_t*)&enable, sizeof(enable)))
+                ok = tb_true;
+        }
+        break;
+#endif
+#ifdef SO_BUSY_POLL
+    case TB_SOCKET_CTRL_SET_BUSY_POLL:
+        {
+            tb_int_t usecs = (tb_int_t)tb_va_arg(args, tb_size_t);
+            if (!setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, (tb_char_t*)&usecs, sizeof(usecs)))
+                ok = tb_true;
+        }
+        break;
+#endif
+#ifdef UDP_GRO
+    case TB_SOCKET_CTRL_SET_UDP_GRO:
+        {
+            tb_int_t enable = (tb_int_t)tb_va_arg(args, tb_bool_t);
+            if (!setsockopt(fd, SOL_UDP, UDP_GRO, (tb_char_t*)&enable, sizeof(enable)))
+                ok = tb_true;
+        }
+        break;
 #endif
     default:
         {
@@ -603,6 +660,90 @@ tb_long_t tb_socket_send(tb_socket_ref_t sock, tb_byte_t const* data, tb_size_t
     // error
     return -1;
 }
+tb_long_t tb_socket_send_zerocopy(tb_socket_ref_t sock, tb_byte_t const* data, tb_size_t size)
+{
+#ifdef TB_SOCKET_ZEROCOPY_ENABLE
+    // check
+    tb_assert_and_check_return_val(sock && data, -1);
+    tb_check_return_val(size, 0);
+
+    // send it, the pages of data will be pinned until the completion
+    tb_long_t real = send(tb_sock2fd(sock), data, (tb_int_t)size, MSG_ZEROCOPY);
+
+    // trace
+    tb_trace_d("send_zerocopy: %p %lu => %ld, errno: %d", sock, size, real, errno);
+
+    // ok?
+    if (real >= 0) return real;
+
+    // continue?
+    if (errno == EINTR || errno == EAGAIN) return 0;
+
+    /* the pinned pages exceed the limit? we need reap the completions first,
+     * waiting the send event will not help, the completions will only wake up the error queue
+     */
+    if (errno == ENOBUFS) return -2;
+
+    // error
+    return -1;
+#else
+    return tb_socket_send(sock, data, size);
+#endif
+}
+tb_long_t tb_socket_zerocopy_reap(tb_socket_ref_t sock, tb_uint32_t* last, tb_bool_t* copied)
+{
+    // check
+    tb_assert_and_check_return_val(sock && last, -1);
+
+#ifdef TB_SOCKET_ZEROCOPY_ENABLE
+    // reap all completions
+    tb_long_t count = 0;
+    while (1)
+    {
+        // init msg
+        union
+        {
+            struct cmsghdr  align;
+            tb_byte_t       data[CMSG_SPACE(sizeof(struct sock_extended_err) + sizeof(struct sockaddr_storage))];
+
+        }                   control;
+        struct msghdr       msg = {0};
+        msg.msg_control     = control.data;
+        msg.msg_controllen  = sizeof(control.data);
+
+        // read the error queue
+        if (recvmsg(tb_sock2fd(sock), &msg, MSG_ERRQUEUE) < 0)
+        {
+            // no more completions?
+            if (errno == EAGAIN || errno == EINTR) break;
+            return count? count : -1;
+        }
+
+        // parse the completed range [ee_info, ee_data]
+        struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+        for (; cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg))
+        {
+            // is ipv4 or ipv6 recverr?
+            tb_check_continue((cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR)
+                || (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR));
+
+            // is zero-copy completion?
+            struct sock_extended_err const* err = (struct sock_extended_err const*)CMSG_DATA(cmsg);
+            tb_check_continue(err->ee_errno == 0 && err->ee_origin == SO_EE_ORIGIN_ZEROCOPY);
+
+            // save it
+            count += (tb_long_t)(err->ee_data - err->ee_info + 1);
+            *last = err->ee_data;
+            if (copied) *copied = (err->ee_code & SO_EE_CODE_ZEROCOPY_COPIED)? tb_true : tb_false;
+        }
+    }
+
+    // ok
+    return count;
+#else
+    return 0;
+#endif
+}
 tb_hong_t tb_socket_sendf(tb_socket_ref_t sock, tb_file_ref_t file, tb_hize_t offset, tb_hize_t size)
 {
     // check
@@ -829,3 +970,162 @@ tb_long_t tb_socket_usendv(tb_socket_ref_t sock, tb_ipaddr_ref_t addr, tb_iovec_
     return -1;
 }
 #endif
+#if defined(TB_CONFIG_POSIX_HAVE_RECVMMSG) && defined(TB_CONFIG_POSIX_HAVE_SENDMMSG)
+tb_long_t tb_socket_urecvm(tb_socket_ref_t sock, tb_socket_umsg_t* list, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(sock && list && size, -1);
+
+    // init msgs
+    tb_size_t               i;
+    tb_size_t               n = tb_min(size, TB_SOCKET_UMSG_MAXN);
+    struct mmsghdr          msgs[TB_SOCKET_UMSG_MAXN];
+    struct iovec            iovs[TB_SOCKET_UMSG_MAXN];
+    struct sockaddr_storage addrs[TB_SOCKET_UMSG_MAXN];
+#ifdef UDP_GRO
+    // the control data for the gro segment size
+    union
+    {
+        struct cmsghdr      align;
+        tb_byte_t           data[CMSG_SPACE(sizeof(tb_int_t))];
+
+    }                       cmsgs[TB_SOCKET_UMSG_MAXN];
+#endif
+    for (i = 0; i < n; i++)
+    {
+        iovs[i].iov_base                = list[i].data;
+        iovs[i].iov_len                 = list[i].size;
+        msgs[i].msg_hdr.msg_name        = (tb_pointer_t)&addrs[i];
+        msgs[i].msg_hdr.msg_namelen     = sizeof(addrs[i]);
+        msgs[i].msg_hdr.msg_iov         = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen      = 1;
+#ifdef UDP_GRO
+        msgs[i].msg_hdr.msg_control     = cmsgs[i].data;
+        msgs[i].msg_hdr.msg_controllen  = sizeof(cmsgs[i].data);
+#else
+        msgs[i].msg_hdr.msg_control     = tb_null;
+        msgs[i].msg_hdr.msg_controllen  = 0;
+#endif
+        msgs[i].msg_hdr.msg_flags       = 0;
+        msgs[i].msg_len                 = 0;
+    }
+
+    // recv them in one syscall
+    tb_long_t r = recvmmsg(tb_sock2fd(sock), msgs, (tb_uint_t)n, 0, tb_null);
+
+    // trace
+    tb_trace_d("urecvm: %p %lu msgs => %ld msgs, errno: %d", sock, n, r, errno);
+
+    // ok?
+    if (r >= 0)
+    {
+        // save the received sizes, truncation, addresses and segments
+        for (i = 0; i < (tb_size_t)r; i++)
+        {
+            list[i].real        = msgs[i].msg_len;
+            list[i].truncated   = (msgs[i].msg_hdr.msg_flags & MSG_TRUNC)? tb_true : tb_false;
+            list[i].segment     = 0;
+            tb_sockaddr_save(&list[i].addr, &addrs[i]);
+#ifdef UDP_GRO
+            struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msgs[i].msg_hdr);
+            for (; cmsg; cmsg = CMSG_NXTHDR(&msgs[i].msg_hdr, cmsg))
+            {
+                if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO)
+                {
+                    tb_int_t segment = 0;
+                    tb_memcpy(&segment, CMSG_DATA(cmsg), sizeof(segment));
+                    if (segment > 0 && (tb_size_t)segment < list[i].real) list[i].segment = segment;
+                    break;
+                }
+            }
+#endif
+        }
+
+        // ok
+        return r;
+    }
+
+    // continue?
+    if (errno == EINTR || errno == EAGAIN) return 0;
+
+    // error
+    return -1;
+}
+tb_long_t tb_socket_usendm(tb_socket_ref_t sock, tb_socket_umsg_t* list, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(sock && list && size, -1);
+
+    // init msgs
+    tb_size_t               i;
+    tb_size_t               n = tb_min(size, TB_SOCKET_UMSG_MAXN);
+    struct mmsghdr          msgs[TB_SOCKET_UMSG_MAXN];
+    struct iovec            iovs[TB_SOCKET_UMSG_MAXN];
+    struct sockaddr_storage addrs[TB_SOCKET_UMSG_MAXN];
+#ifdef UDP_SEGMENT
+    // the control data for the gso segment size
+    union
+    {
+        struct cmsghdr      align;
+        tb_byte_t           data[CMSG_SPACE(sizeof(tb_uint16_t))];
+
+    }                       cmsgs[TB_SOCKET_UMSG_MAXN];
+#endif
+    for (i = 0; i < n; i++)
+    {
+        // load addr
+        tb_size_t addrn = tb_sockaddr_load(&addrs[i], &list[i].addr);
+        tb_assert_and_check_return_val(addrn, -1);
+
+        // init msg
+        iovs[i].iov_base                = list[i].data;
+        iovs[i].iov_len                 = list[i].size;
+        msgs[i].msg_hdr.msg_name        = (tb_pointer_t)&addrs[i];
+        msgs[i].msg_hdr.msg_namelen     = (socklen_t)addrn;
+        msgs[i].msg_hdr.msg_iov         = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen      = 1;
+        msgs[i].msg_hdr.msg_control     = tb_null;
+        msgs[i].msg_hdr.msg_controllen  = 0;
+        msgs[i].msg_hdr.msg_flags       = 0;
+        msgs[i].msg_len                 = 0;
+
+#ifdef UDP_SEGMENT
+        // split data to the datagrams by the kernel
+        if (list[i].segment && list[i].segment < list[i].size)
+        {
+            tb_uint16_t segment = (tb_uint16_t)list[i].segment;
+            msgs[i].msg_hdr.msg_control     = cmsgs[i].data;
+            msgs[i].msg_hdr.msg_controllen  = sizeof(cmsgs[i].data);
+
+            struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msgs[i].msg_hdr);
+            cmsg->cmsg_level    = SOL_UDP;
+            cmsg->cmsg_type     = UDP_SEGMENT;
+            cmsg->cmsg_len      = CMSG_LEN(sizeof(segment));
+            tb_memcpy(CMSG_DATA(cmsg), &segment, sizeof(segment));
+        }
+#else
+        tb_assert_and_check_return_val(!list[i].segment || list[i].segment >= list[i].size, -1);
+#endif
+    }
+
+    // send them in one syscall
+    tb_long_t r = sendmmsg(tb_sock2fd(sock), msgs, (tb_uint_t)n, 0);
+
+    // trace
+    tb_trace_d("usendm: %p %lu msgs => %ld msgs, errno: %d", sock, n, r, errno);
+
+    // ok?
+    if (r >= 0)
+    {
+        // save the sent sizes
+        for (i = 0; i < (tb_size_t)r; i++) list[i].real = msgs[i].msg_len;
+        return r;
+    }
+
+    // continue?
+    if (errno == EINTR || errno == EAGAIN) return 0;
+
+    // error
+    return -1;
+}
+#endif
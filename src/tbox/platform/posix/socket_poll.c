@@ -61,7 +61,7 @@ tb_long_t tb_socket_wait_impl(tb_socket_ref_t sock, tb_size_t events, tb_long_t
     tb_long_t e = TB_SOCKET_EVENT_NONE;
     if (pfd.revents & POLLIN) e |= TB_SOCKET_EVENT_RECV;
     if (pfd.revents & POLLOUT) e |= TB_SOCKET_EVENT_SEND;
-    if ((pfd.revents & POLLHUP) && !(e & (TB_SOCKET_EVENT_RECV | TB_SOCKET_EVENT_SEND)))
+    if ((pfd.revents & (POLLHUP | POLLERR)) && !(e & (TB_SOCKET_EVENT_RECV | TB_SOCKET_EVENT_SEND)))
         e |= TB_SOCKET_EVENT_RECV | TB_SOCKET_EVENT_SEND;
     return e;
 }
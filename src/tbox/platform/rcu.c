@@ -0,0 +1,70 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        rcu.c
+ * @ingroup     platform
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "rcu.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_void_t tb_rcu_pointer_init(tb_rcu_pointer_ref_t pointer, tb_pointer_t data, tb_ebr_free_t func)
+{
+    // check
+    tb_assert_and_check_return(pointer);
+
+    // init it
+    pointer->free = func;
+    tb_atomic_set(&pointer->data, (tb_long_t)data);
+}
+tb_void_t tb_rcu_pointer_exit(tb_rcu_pointer_ref_t pointer)
+{
+    // check
+    tb_assert_and_check_return(pointer);
+
+    // free the current data
+    tb_pointer_t data = (tb_pointer_t)tb_atomic_fetch_and_set(&pointer->data, 0);
+    if (data && pointer->free) pointer->free(data);
+}
+tb_void_t tb_rcu_pointer_set(tb_rcu_pointer_ref_t pointer, tb_pointer_t data)
+{
+    // check
+    tb_assert_and_check_return(pointer);
+
+    // publish the new data and retire the old data
+    tb_pointer_t old = (tb_pointer_t)tb_atomic_fetch_and_set(&pointer->data, (tb_long_t)data);
+    if (old && old != data && pointer->free) tb_ebr_retire(old, pointer->free);
+}
+tb_bool_t tb_rcu_pointer_cmpset(tb_rcu_pointer_ref_t pointer, tb_pointer_t old, tb_pointer_t data)
+{
+    // check
+    tb_assert_and_check_return_val(pointer, tb_false);
+
+    // publish the new data
+    tb_long_t expected = (tb_long_t)old;
+    tb_check_return_val(tb_atomic_compare_and_swap(&pointer->data, &expected, (tb_long_t)data), tb_false);
+
+    // retire the old data
+    if (old && old != data && pointer->free) tb_ebr_retire(old, pointer->free);
+    return tb_true;
+}
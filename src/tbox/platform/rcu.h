@@ -0,0 +1,160 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        rcu.h
+ * @ingroup     platform
+ *
+ */
+#ifndef TB_PLATFORM_RCU_H
+#define TB_PLATFORM_RCU_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "ebr.h"
+#include "atomic.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+/// the rcu pointer initial value
+#define TB_RCU_POINTER_INIT             {0, tb_null}
+
+/// enter the rcu read-side critical section, @see tb_ebr_enter()
+#define tb_rcu_read_enter()             tb_ebr_enter()
+
+/// leave the rcu read-side critical section
+#define tb_rcu_read_leave()             tb_ebr_leave()
+
+/// wait for all readers in the current read-side critical sections to leave
+#define tb_rcu_synchronize()            tb_ebr_synchronize()
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/*! the rcu pointer type
+ *
+ * it's used to publish the read-mostly data, e.g. the global table or configuration.
+ * the readers get the current data without any locks and the writers replace it with the new copy,
+ * the old data will be freed after all readers have left.
+ *
+ * @code
+
+    // the global table
+    static tb_rcu_pointer_t g_table = TB_RCU_POINTER_INIT;
+
+    // init it
+    tb_rcu_pointer_init(&g_table, tb_null, tb_table_free);
+
+    // read it
+    if (tb_rcu_read_enter())
+    {
+        tb_table_t const* table = (tb_table_t const*)tb_rcu_pointer_get(&g_table);
+        if (table) value = tb_table_find(table, key);
+        tb_rcu_read_leave();
+    }
+
+    // update it, the writers need be serialized by the lock or use tb_rcu_pointer_cmpset()
+    tb_spinlock_enter(&g_lock);
+    tb_table_t* table = tb_table_copy(tb_rcu_pointer_get(&g_table));
+    tb_table_insert(table, key, value);
+    tb_rcu_pointer_set(&g_table, table);
+    tb_spinlock_leave(&g_lock);
+
+    // exit it
+    tb_rcu_pointer_exit(&g_table);
+
+ * @endcode
+ */
+typedef struct __tb_rcu_pointer_t
+{
+    // the data
+    tb_atomic_t             data;
+
+    // the free function
+    tb_ebr_free_t           free;
+
+}tb_rcu_pointer_t, *tb_rcu_pointer_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init the rcu pointer
+ *
+ * @param pointer       the rcu pointer
+ * @param data          the initial data, it can be null
+ * @param func          the free function of the data
+ */
+tb_void_t               tb_rcu_pointer_init(tb_rcu_pointer_ref_t pointer, tb_pointer_t data, tb_ebr_free_t func);
+
+/*! exit the rcu pointer and free the current data directly
+ *
+ * @note all readers need have left
+ *
+ * @param pointer       the rcu pointer
+ */
+tb_void_t               tb_rcu_pointer_exit(tb_rcu_pointer_ref_t pointer);
+
+/*! replace the current data and free the old data after all readers have left
+ *
+ * @param pointer       the rcu pointer
+ * @param data          the new data, it can be null
+ */
+tb_void_t               tb_rcu_pointer_set(tb_rcu_pointer_ref_t pointer, tb_pointer_t data);
+
+/*! replace the current data if it's not changed
+ *
+ * @param pointer       the rcu pointer
+ * @param old           the old data
+ * @param data          the new data
+ *
+ * @return              tb_true if it has been replaced, the old data will be freed after all readers have left
+ */
+tb_bool_t               tb_rcu_pointer_cmpset(tb_rcu_pointer_ref_t pointer, tb_pointer_t old, tb_pointer_t data);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * inline implementation
+ */
+
+/*! get the current data
+ *
+ * @note it need be called in the read-side critical section or by the serialized writer
+ *
+ * @param pointer       the rcu pointer
+ *
+ * @return              the current data
+ */
+static __tb_inline__ tb_pointer_t tb_rcu_pointer_get(tb_rcu_pointer_ref_t pointer)
+{
+    return (tb_pointer_t)tb_atomic_get_explicit(&pointer->data, TB_ATOMIC_ACQUIRE);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -0,0 +1,348 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        rwlock.c
+ * @ingroup     platform
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "rwlock.h"
+#include "cpu.h"
+#include "futex.h"
+#include "thread.h"
+#include "atomic.h"
+#include "futex_mutex.h"
+#include "../utils/lock_profiler.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the maximum count of the reader slots
+#define TB_RWLOCK_SLOT_MAXN         (64)
+
+// the maximum spin count before parking the thread
+#define TB_RWLOCK_SPIN_MAXN         (128)
+
+// the writer state
+#define TB_RWLOCK_WRITER_NONE       (0)
+#define TB_RWLOCK_WRITER_ACTIVE     (1)
+#define TB_RWLOCK_WRITER_WAITED     (2)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the reader slot type, each slot has its own cache line
+typedef struct __tb_rwlock_slot_t
+{
+    // the reader count
+    tb_atomic32_t           readers;
+
+    // the padding
+    tb_byte_t               padding[TB_L1_CACHE_BYTES - sizeof(tb_atomic32_t)];
+
+}tb_rwlock_slot_t;
+
+// the reader-writer lock type
+typedef struct __tb_rwlock_t
+{
+    // the writer state, none: 0, active or pending: 1, and some readers are waiting for it: 2
+    tb_atomic32_t           writer;
+
+    // the sequence of the leaving readers for waking the writer
+    tb_atomic32_t           wseq;
+
+    // is the writer parked for waiting readers?
+    tb_atomic32_t           wpark;
+
+    // the count of the writers waiting for the writers lock
+    tb_atomic32_t           wpending;
+
+    // the writers lock
+    tb_futex_mutex_t        wlock;
+
+    // the slot mask
+    tb_size_t               mask;
+
+    // the padding, the writer state and the slots are not in the same cache line
+    tb_byte_t               padding[TB_L1_CACHE_BYTES];
+
+    // the reader slots
+    tb_rwlock_slot_t        slots[1];
+
+}tb_rwlock_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the next reader slot index
+static tb_atomic_t                              g_rwlock_slot_next = 0;
+
+// the reader slot index of the current thread, index + 1
+#ifdef __tb_thread_local__
+static __tb_thread_local__ tb_size_t            g_rwlock_slot = 0;
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static __tb_inline__ tb_rwlock_slot_t* tb_rwlock_slot(tb_rwlock_t* rwlock)
+{
+    /* get the reader slot of the current thread
+     *
+     * we assign the slots to the threads one by one, it's more stable than the current cpu,
+     * because the thread may be migrated to other cpu before leaving it.
+     */
+#ifdef __tb_thread_local__
+    if (!g_rwlock_slot) g_rwlock_slot = (tb_size_t)tb_atomic_fetch_and_add_explicit(&g_rwlock_slot_next, 1, TB_ATOMIC_RELAXED) + 1;
+    return &rwlock->slots[g_rwlock_slot & rwlock->mask];
+#else
+    tb_size_t self = tb_thread_self();
+    return &rwlock->slots[((self >> 4) ^ (self >> 12)) & rwlock->mask];
+#endif
+}
+static tb_bool_t tb_rwlock_readers(tb_rwlock_t* rwlock)
+{
+    tb_size_t i = 0;
+    for (i = 0; i <= rwlock->mask; i++)
+    {
+        if (tb_atomic32_get(&rwlock->slots[i].readers)) return tb_true;
+    }
+    return tb_false;
+}
+static tb_void_t tb_rwlock_reader_leave(tb_rwlock_t* rwlock, tb_rwlock_slot_t* slot)
+{
+    // leave it
+    tb_atomic32_fetch_and_sub(&slot->readers, 1);
+
+    // wake the writer if it's waiting for the readers
+    if (tb_atomic32_get(&rwlock->writer))
+    {
+        tb_atomic32_fetch_and_add(&rwlock->wseq, 1);
+        if (tb_atomic32_get(&rwlock->wpark)) tb_futex_wake(&rwlock->wseq, 1);
+    }
+}
+static tb_void_t tb_rwlock_reader_wait(tb_rwlock_t* rwlock)
+{
+    // spin it first
+    tb_size_t i = 0;
+#ifdef tb_cpu_pause
+    if (tb_cpu_count() > 1)
+    {
+        for (i = 0; i < TB_RWLOCK_SPIN_MAXN && tb_atomic32_get_explicit(&rwlock->writer, TB_ATOMIC_RELAXED); i++)
+            tb_cpu_pause();
+    }
+#endif
+
+    // park it until the writer leaves
+    while (1)
+    {
+        tb_int32_t writer = tb_atomic32_get(&rwlock->writer);
+        if (writer == TB_RWLOCK_WRITER_NONE) break;
+        if (writer == TB_RWLOCK_WRITER_ACTIVE && !tb_atomic32_compare_and_swap(&rwlock->writer, &writer, TB_RWLOCK_WRITER_WAITED))
+            continue;
+        tb_futex_wait(&rwlock->writer, TB_RWLOCK_WRITER_WAITED, -1);
+    }
+}
+static tb_void_t tb_rwlock_writer_block(tb_rwlock_t* rwlock)
+{
+    /* block the new readers
+     *
+     * the state may have been handed over by the previous writer, we cannot reset it to active,
+     * otherwise the waited readers will not be woken when leaving
+     */
+    tb_int32_t writer = TB_RWLOCK_WRITER_NONE;
+    tb_atomic32_compare_and_swap(&rwlock->writer, &writer, TB_RWLOCK_WRITER_ACTIVE);
+}
+static tb_void_t tb_rwlock_writer_wait(tb_rwlock_t* rwlock)
+{
+    // wait for all readers to leave
+    tb_size_t spin = 0;
+    while (1)
+    {
+        // get the sequence first, it will be changed if any reader leaves after checking
+        tb_int32_t wseq = tb_atomic32_get(&rwlock->wseq);
+        if (!tb_rwlock_readers(rwlock)) break;
+
+        // spin it first
+#ifdef tb_cpu_pause
+        if (spin < TB_RWLOCK_SPIN_MAXN && tb_cpu_count() > 1)
+        {
+            spin++;
+            tb_cpu_pause();
+            continue;
+        }
+#endif
+
+        // park it
+        tb_atomic32_set(&rwlock->wpark, 1);
+        tb_futex_wait(&rwlock->wseq, wseq, -1);
+    }
+    tb_atomic32_set_explicit(&rwlock->wpark, 0, TB_ATOMIC_RELAXED);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_rwlock_ref_t tb_rwlock_init()
+{
+    // the slot count, the power of 2
+    tb_size_t count = 1;
+    tb_size_t ncpu = tb_cpu_count();
+    while (count < ncpu && count < TB_RWLOCK_SLOT_MAXN) count <<= 1;
+
+    // make lock
+    tb_rwlock_t* rwlock = (tb_rwlock_t*)tb_malloc0(sizeof(tb_rwlock_t) + (count - 1) * sizeof(tb_rwlock_slot_t));
+    tb_assert_and_check_return_val(rwlock, tb_null);
+
+    // init lock
+    rwlock->mask = count - 1;
+    tb_futex_mutex_init(&rwlock->wlock);
+    return (tb_rwlock_ref_t)rwlock;
+}
+tb_void_t tb_rwlock_exit(tb_rwlock_ref_t lock)
+{
+    // check
+    tb_rwlock_t* rwlock = (tb_rwlock_t*)lock;
+    tb_assert_and_check_return(rwlock);
+
+    // exit it
+    tb_futex_mutex_exit(&rwlock->wlock);
+    tb_free(rwlock);
+}
+tb_bool_t tb_rwlock_enter_read(tb_rwlock_ref_t lock)
+{
+    // check
+    tb_rwlock_t* rwlock = (tb_rwlock_t*)lock;
+    tb_assert_and_check_return_val(rwlock, tb_false);
+
+    // enter it
+    tb_rwlock_slot_t* slot = tb_rwlock_slot(rwlock);
+    while (1)
+    {
+        // count this reader and check the writer, the writer will see our count or we will see the writer
+        tb_atomic32_fetch_and_add(&slot->readers, 1);
+        if (!tb_atomic32_get(&rwlock->writer)) break;
+
+        // a writer is active or pending, we back off and wait it
+        tb_rwlock_reader_leave(rwlock, slot);
+#ifdef TB_LOCK_PROFILER_ENABLE
+        tb_lock_profiler_occupied(tb_lock_profiler(), (tb_pointer_t)lock);
+#endif
+        tb_rwlock_reader_wait(rwlock);
+    }
+    return tb_true;
+}
+tb_bool_t tb_rwlock_enter_read_try(tb_rwlock_ref_t lock)
+{
+    // check
+    tb_rwlock_t* rwlock = (tb_rwlock_t*)lock;
+    tb_assert_and_check_return_val(rwlock, tb_false);
+
+    // try to enter it
+    tb_rwlock_slot_t* slot = tb_rwlock_slot(rwlock);
+    tb_atomic32_fetch_and_add(&slot->readers, 1);
+    if (!tb_atomic32_get(&rwlock->writer)) return tb_true;
+
+    // failed
+    tb_rwlock_reader_leave(rwlock, slot);
+#ifdef TB_LOCK_PROFILER_ENABLE
+    tb_lock_profiler_occupied(tb_lock_profiler(), (tb_pointer_t)lock);
+#endif
+    return tb_false;
+}
+tb_bool_t tb_rwlock_leave_read(tb_rwlock_ref_t lock)
+{
+    // check
+    tb_rwlock_t* rwlock = (tb_rwlock_t*)lock;
+    tb_assert_and_check_return_val(rwlock, tb_false);
+
+    // leave it
+    tb_rwlock_reader_leave(rwlock, tb_rwlock_slot(rwlock));
+    return tb_true;
+}
+tb_bool_t tb_rwlock_enter_write(tb_rwlock_ref_t lock)
+{
+    // check
+    tb_rwlock_t* rwlock = (tb_rwlock_t*)lock;
+    tb_assert_and_check_return_val(rwlock, tb_false);
+
+    // occupied?
+#ifdef TB_LOCK_PROFILER_ENABLE
+    if (tb_atomic32_get_explicit(&rwlock->writer, TB_ATOMIC_RELAXED) || tb_rwlock_readers(rwlock))
+        tb_lock_profiler_occupied(tb_lock_profiler(), (tb_pointer_t)lock);
+#endif
+
+    /* enter the writers lock
+     *
+     * we are pending before entering it, so the current writer will not unblock the new readers when leaving,
+     * and the writer state will be handed over to us directly.
+     */
+    tb_atomic32_fetch_and_add(&rwlock->wpending, 1);
+    tb_futex_mutex_enter(&rwlock->wlock);
+    tb_atomic32_fetch_and_sub(&rwlock->wpending, 1);
+
+    // block the new readers and wait for the current readers
+    tb_rwlock_writer_block(rwlock);
+    tb_rwlock_writer_wait(rwlock);
+    return tb_true;
+}
+tb_bool_t tb_rwlock_enter_write_try(tb_rwlock_ref_t lock)
+{
+    // check
+    tb_rwlock_t* rwlock = (tb_rwlock_t*)lock;
+    tb_assert_and_check_return_val(rwlock, tb_false);
+
+    // try to enter the writers lock
+    if (tb_futex_mutex_enter_try(&rwlock->wlock))
+    {
+        // no readers?
+        tb_rwlock_writer_block(rwlock);
+        if (!tb_rwlock_readers(rwlock)) return tb_true;
+
+        // failed
+        tb_rwlock_leave_write(lock);
+    }
+
+    // occupied
+#ifdef TB_LOCK_PROFILER_ENABLE
+    tb_lock_profiler_occupied(tb_lock_profiler(), (tb_pointer_t)lock);
+#endif
+    return tb_false;
+}
+tb_bool_t tb_rwlock_leave_write(tb_rwlock_ref_t lock)
+{
+    // check
+    tb_rwlock_t* rwlock = (tb_rwlock_t*)lock;
+    tb_assert_and_check_return_val(rwlock, tb_false);
+
+    /* wake all waited readers if no writers are pending
+     *
+     * otherwise, we keep the writer state for the next writer and the readers are still blocked
+     */
+    if (!tb_atomic32_get(&rwlock->wpending) && tb_atomic32_fetch_and_set(&rwlock->writer, TB_RWLOCK_WRITER_NONE) == TB_RWLOCK_WRITER_WAITED)
+        tb_futex_wake(&rwlock->writer, (tb_size_t)-1);
+
+    // leave the writers lock
+    tb_futex_mutex_leave(&rwlock->wlock);
+    return tb_true;
+}
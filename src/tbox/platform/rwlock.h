@@ -0,0 +1,122 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        rwlock.h
+ * @ingroup     platform
+ *
+ */
+#ifndef TB_PLATFORM_RWLOCK_H
+#define TB_PLATFORM_RWLOCK_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the reader-writer lock ref type
+typedef __tb_typeref__(rwlock);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init the reader-writer lock
+ *
+ * the readers are counted on the reader slots, each thread is assigned a slot in turn (or by its thread id),
+ * so they do not contend on the same cache line unless more threads than slots are reading,
+ * and the writers have the preference, the new readers will wait if a writer is waiting for the readers
+ * or other writers, and the waiting readers will not be woken until all pending writers have left.
+ *
+ * @note the recursive reading is not supported, it will deadlock if a writer is waiting between them.
+ *
+ * @return          the lock
+ */
+tb_rwlock_ref_t     tb_rwlock_init(tb_noarg_t);
+
+/*! exit the reader-writer lock
+ *
+ * @param lock      the lock
+ */
+tb_void_t           tb_rwlock_exit(tb_rwlock_ref_t lock);
+
+/*! enter the reader-writer lock for reading
+ *
+ * @note it cannot be entered again by the same thread before leaving it
+ *
+ * @param lock      the lock
+ *
+ * @return          tb_true or tb_false
+ */
+tb_bool_t           tb_rwlock_enter_read(tb_rwlock_ref_t lock);
+
+/*! try to enter the reader-writer lock for reading
+ *
+ * @param lock      the lock
+ *
+ * @return          tb_true or tb_false
+ */
+tb_bool_t           tb_rwlock_enter_read_try(tb_rwlock_ref_t lock);
+
+/*! leave the reader-writer lock for reading
+ *
+ * @note it need be called on the same thread as entering it
+ *
+ * @param lock      the lock
+ *
+ * @return          tb_true or tb_false
+ */
+tb_bool_t           tb_rwlock_leave_read(tb_rwlock_ref_t lock);
+
+/*! enter the reader-writer lock for writing
+ *
+ * @param lock      the lock
+ *
+ * @return          tb_true or tb_false
+ */
+tb_bool_t           tb_rwlock_enter_write(tb_rwlock_ref_t lock);
+
+/*! try to enter the reader-writer lock for writing
+ *
+ * @param lock      the lock
+ *
+ * @return          tb_true or tb_false
+ */
+tb_bool_t           tb_rwlock_enter_write_try(tb_rwlock_ref_t lock);
+
+/*! leave the reader-writer lock for writing
+ *
+ * @param lock      the lock
+ *
+ * @return          tb_true or tb_false
+ */
+tb_bool_t           tb_rwlock_leave_write(tb_rwlock_ref_t lock);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -34,6 +34,8 @@
 #   include "windows/semaphore.c"
 #elif defined(TB_CONFIG_OS_MACOSX) || defined(TB_CONFIG_OS_IOS)
 #   include "mach/semaphore.c"
+#elif (defined(TB_CONFIG_OS_LINUX) || defined(TB_CONFIG_OS_ANDROID)) && !defined(TB_CONFIG_MICRO_ENABLE)
+#   include "linux/semaphore.c"
 #elif defined(TB_CONFIG_POSIX_HAVE_SEM_INIT)
 #   include "posix/semaphore.c"
 #elif defined(TB_CONFIG_SYSTEMV_HAVE_SEMGET) \
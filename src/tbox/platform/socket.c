@@ -118,6 +118,16 @@ tb_long_t tb_socket_send(tb_socket_ref_t sock, tb_byte_t const* data, tb_size_t
     tb_trace_noimpl();
     return -1;
 }
+tb_long_t tb_socket_send_zerocopy(tb_socket_ref_t sock, tb_byte_t const* data, tb_size_t size)
+{
+    tb_trace_noimpl();
+    return -1;
+}
+tb_long_t tb_socket_zerocopy_reap(tb_socket_ref_t sock, tb_uint32_t* last, tb_bool_t* copied)
+{
+    tb_trace_noimpl();
+    return -1;
+}
 tb_long_t tb_socket_recvv(tb_handle_t socket, tb_iovec_t const* list, tb_size_t size)
 {
     tb_trace_noimpl();
@@ -155,6 +165,52 @@ tb_long_t tb_socket_usendv(tb_socket_ref_t sock, tb_ipaddr_ref_t addr, tb_iovec_
 }
 #endif
 
+#if !defined(TB_CONFIG_POSIX_HAVE_RECVMMSG) || !defined(TB_CONFIG_POSIX_HAVE_SENDMMSG)
+tb_long_t tb_socket_urecvm(tb_socket_ref_t sock, tb_socket_umsg_t* list, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(sock && list && size, -1);
+
+    // recv them one by one
+    tb_size_t i;
+    for (i = 0; i < size; i++)
+    {
+        // recv it
+        tb_long_t real = tb_socket_urecv(sock, &list[i].addr, list[i].data, list[i].size);
+        if (real < 0) return i? (tb_long_t)i : -1;
+        tb_check_break(real > 0);
+
+        // save it
+        list[i].real        = real;
+        list[i].truncated   = tb_false;
+        list[i].segment     = 0;
+    }
+    return i;
+}
+tb_long_t tb_socket_usendm(tb_socket_ref_t sock, tb_socket_umsg_t* list, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(sock && list && size, -1);
+
+    // send them one by one
+    tb_size_t i;
+    for (i = 0; i < size; i++)
+    {
+        // the segments are not supported
+        tb_assert_and_check_return_val(!list[i].segment || list[i].segment >= list[i].size, -1);
+
+        // send it
+        tb_long_t real = tb_socket_usend(sock, &list[i].addr, list[i].data, list[i].size);
+        if (real < 0) return i? (tb_long_t)i : -1;
+        tb_check_break(real > 0);
+
+        // save it
+        list[i].real = real;
+    }
+    return i;
+}
+#endif
+
 #if defined(TB_CONFIG_OS_WINDOWS)
 #   include "posix/socket_select.c"
 #elif defined(TB_CONFIG_POSIX_HAVE_POLL) && \
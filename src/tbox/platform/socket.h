@@ -91,6 +91,9 @@ typedef enum __tb_socket_ctrl_e
 ,   TB_SOCKET_CTRL_SET_TCP_KEEPINTVL    = 8
 ,   TB_SOCKET_CTRL_SET_KEEPALIVE        = 9
 ,   TB_SOCKET_CTRL_SET_NOSIGPIPE        = 10 //!< @note this operation always return true on windows
+,   TB_SOCKET_CTRL_SET_UDP_GRO          = 11 //!< enable to coalesce the received datagrams (UDP GRO), only for linux
+,   TB_SOCKET_CTRL_SET_ZEROCOPY         = 12 //!< enable tb_socket_send_zerocopy() (SO_ZEROCOPY), only for linux
+,   TB_SOCKET_CTRL_SET_BUSY_POLL        = 13 //!< set the busy polling time (us) of the device queue for the blocking recv (SO_BUSY_POLL), only for linux
 
 }tb_socket_ctrl_e;
 
@@ -106,6 +109,36 @@ typedef enum __tb_socket_event_e
 
 }tb_socket_event_e;
 
+/// the udp message type for sending and receiving the batched datagrams
+typedef struct __tb_socket_umsg_t
+{
+    /// the peer address, it is the destination for sending and the source for receiving
+    tb_ipaddr_t             addr;
+
+    /// the data
+    tb_byte_t*              data;
+
+    /// the data size for sending or the buffer size for receiving
+    tb_size_t               size;
+
+    /// the real sent or received size
+    tb_size_t               real;
+
+    /*! is the received datagram truncated? it is larger than the buffer size and the rest has been discarded
+     *
+     * @note it is always tb_false if the system cannot report it, e.g. receiving them one by one without recvmmsg()
+     */
+    tb_bool_t               truncated;
+
+    /*! the segment size, 0: no segments
+     *
+     * sending: the data will be split to the datagrams of this size by the kernel (UDP GSO)
+     * receiving: the received data has been coalesced from the datagrams of this size (UDP GRO)
+     */
+    tb_size_t               segment;
+
+}tb_socket_umsg_t;
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
@@ -220,6 +253,37 @@ tb_long_t           tb_socket_recv(tb_socket_ref_t sock, tb_byte_t* data, tb_siz
  */
 tb_long_t           tb_socket_send(tb_socket_ref_t sock, tb_byte_t const* data, tb_size_t size);
 
+/*! send the socket data for tcp without copying it to the kernel (MSG_ZEROCOPY)
+ *
+ * TB_SOCKET_CTRL_SET_ZEROCOPY must be enabled first, otherwise it will be same as tb_socket_send().
+ *
+ * the data must not be modified or freed until the completion is reaped by tb_socket_zerocopy_reap(),
+ * each successful sending has a sequence id which is increased from zero.
+ *
+ * @note it is only worth for the large data, e.g. >= 16KB
+ *
+ * @param sock      the socket
+ * @param data      the data
+ * @param size      the size
+ *
+ * @return          the real size, 0: no space and wait the send event,
+ *                  -2: the pinned pages exceed the limit (ENOBUFS), the completions need be reaped first, -1: failed
+ */
+tb_long_t           tb_socket_send_zerocopy(tb_socket_ref_t sock, tb_byte_t const* data, tb_size_t size);
+
+/*! reap the completions of the zero-copy sending from the error queue
+ *
+ * the completions will wake up the poller and tb_socket_wait() with the recv and send events,
+ * so we can reap them after waiting.
+ *
+ * @param sock      the socket
+ * @param last      the last completed sequence id
+ * @param copied    it will be true if the kernel has copied the data instead, optional
+ *
+ * @return          the completed count, 0: no completion, -1: failed
+ */
+tb_long_t           tb_socket_zerocopy_reap(tb_socket_ref_t sock, tb_uint32_t* last, tb_bool_t* copied);
+
 /*! recv the socket data for tcp with block mode
  *
  * @param sock      the socket
@@ -315,6 +379,32 @@ tb_long_t           tb_socket_urecvv(tb_socket_ref_t sock, tb_ipaddr_ref_t addr,
  */
 tb_long_t           tb_socket_usendv(tb_socket_ref_t sock, tb_ipaddr_ref_t addr, tb_iovec_t const* list, tb_size_t size);
 
+/*! urecvm the batched datagrams for udp
+ *
+ * it will receive them by recvmmsg() in one syscall if be supported, otherwise receive them one by one
+ *
+ * @param sock      the socket
+ * @param list      the message list, the addr, real, truncated and segment will be saved
+ * @param size      the message count
+ *
+ * @note the truncated datagram is still returned, its real size is the buffer size and truncated is tb_true
+ *
+ * @return          the received message count, 0: no data, -1: failed
+ */
+tb_long_t           tb_socket_urecvm(tb_socket_ref_t sock, tb_socket_umsg_t* list, tb_size_t size);
+
+/*! usendm the batched datagrams for udp
+ *
+ * it will send them by sendmmsg() in one syscall if be supported, otherwise send them one by one
+ *
+ * @param sock      the socket
+ * @param list      the message list, the real size will be saved
+ * @param size      the message count
+ *
+ * @return          the sent message count, 0: no space, -1: failed
+ */
+tb_long_t           tb_socket_usendm(tb_socket_ref_t sock, tb_socket_umsg_t* list, tb_size_t size);
+
 /*! wait socket events
  *
  * @note we can wait for socket events in the coroutine
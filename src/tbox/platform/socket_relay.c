@@ -0,0 +1,389 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        socket_relay.c
+ * @ingroup     platform
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME                "socket_relay"
+#define TB_TRACE_MODULE_DEBUG               (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "socket_relay.h"
+#include "spinlock.h"
+#include "impl/socket.h"
+#include "../libc/libc.h"
+#include "../utils/utils.h"
+#ifdef TB_CONFIG_POSIX_HAVE_SPLICE
+#   include <fcntl.h>
+#   include <unistd.h>
+#   include <errno.h>
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the pipe size for splice, it's also the maximum size of each relay
+#ifdef __tb_small__
+#   define TB_SOCKET_RELAY_PIPE_SIZE        (1 << 16)
+#else
+#   define TB_SOCKET_RELAY_PIPE_SIZE        (1 << 18)
+#endif
+
+// the maximum count of the pooled pipes
+#define TB_SOCKET_RELAY_POOL_MAXN           (16)
+
+// the buffer size if splice is not supported
+#define TB_SOCKET_RELAY_DATA_SIZE           (8192 << 3)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the socket relay type
+typedef struct __tb_socket_relay_t
+{
+    // the input socket
+    tb_socket_ref_t         isock;
+
+    // the output socket
+    tb_socket_ref_t         osock;
+
+#ifdef TB_CONFIG_POSIX_HAVE_SPLICE
+    // the pipe for splice
+    tb_int_t                pipe[2];
+
+    // the pipe size
+    tb_size_t               pipe_size;
+#else
+    // the buffer data
+    tb_byte_t*              data;
+
+    // the offset of the pending data in the buffer
+    tb_size_t               offset;
+
+    // has waited for the input socket?
+    tb_bool_t               bwait;
+#endif
+
+    // the pending size in the pipe or buffer
+    tb_size_t               pending;
+
+    // the total relayed size
+    tb_hize_t               total;
+
+    // the input socket is closed?
+    tb_bool_t               bend;
+
+}tb_socket_relay_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+#ifdef TB_CONFIG_POSIX_HAVE_SPLICE
+// the pipe pool lock
+static tb_spinlock_t        g_pipes_lock = TB_SPINLOCK_INIT;
+
+// the pooled pipes
+static tb_int_t             g_pipes[TB_SOCKET_RELAY_POOL_MAXN][2];
+
+// the pooled pipe count
+static tb_size_t            g_pipes_count = 0;
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+#ifdef TB_CONFIG_POSIX_HAVE_SPLICE
+static tb_bool_t tb_socket_relay_pipe_get(tb_int_t pipe[2], tb_size_t* pipe_size)
+{
+    // get a pooled pipe
+    tb_bool_t ok = tb_false;
+    tb_spinlock_enter(&g_pipes_lock);
+    if (g_pipes_count)
+    {
+        g_pipes_count--;
+        pipe[0] = g_pipes[g_pipes_count][0];
+        pipe[1] = g_pipes[g_pipes_count][1];
+        ok = tb_true;
+    }
+    tb_spinlock_leave(&g_pipes_lock);
+
+    // make a new pipe
+    if (!ok)
+    {
+        if (pipe2(pipe, O_NONBLOCK | O_CLOEXEC) < 0) return tb_false;
+#ifdef F_SETPIPE_SZ
+        // attempt to enlarge it for relaying more data in one splice
+        fcntl(pipe[1], F_SETPIPE_SZ, TB_SOCKET_RELAY_PIPE_SIZE);
+#endif
+    }
+
+    // get the pipe size
+    tb_long_t size = -1;
+#ifdef F_GETPIPE_SZ
+    size = fcntl(pipe[1], F_GETPIPE_SZ);
+#endif
+    *pipe_size = size > 0? (tb_size_t)size : (1 << 16);
+    return tb_true;
+}
+static tb_void_t tb_socket_relay_pipe_put(tb_int_t pipe[2], tb_bool_t clean)
+{
+    // put it to the pool if the pipe is clean
+    tb_bool_t ok = tb_false;
+    if (clean)
+    {
+        tb_spinlock_enter(&g_pipes_lock);
+        if (g_pipes_count < TB_SOCKET_RELAY_POOL_MAXN)
+        {
+            g_pipes[g_pipes_count][0] = pipe[0];
+            g_pipes[g_pipes_count][1] = pipe[1];
+            g_pipes_count++;
+            ok = tb_true;
+        }
+        tb_spinlock_leave(&g_pipes_lock);
+    }
+
+    // close it
+    if (!ok)
+    {
+        close(pipe[0]);
+        close(pipe[1]);
+    }
+}
+static tb_long_t tb_socket_relay_recv(tb_socket_relay_t* relay)
+{
+    // move data from the input socket to the pipe
+    tb_long_t real = splice(tb_sock2fd(relay->isock), tb_null, relay->pipe[1], tb_null, relay->pipe_size, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+
+    // trace
+    tb_trace_d("splice: recv %ld, errno: %d", real, errno);
+
+    // ok?
+    if (real > 0) return real;
+
+    // closed?
+    if (!real)
+    {
+        relay->bend = tb_true;
+        return -1;
+    }
+
+    // continue?
+    if (errno == EINTR || errno == EAGAIN) return 0;
+
+    // error
+    return -1;
+}
+static tb_long_t tb_socket_relay_send(tb_socket_relay_t* relay)
+{
+    // move data from the pipe to the output socket
+    tb_long_t real = splice(relay->pipe[0], tb_null, tb_sock2fd(relay->osock), tb_null, relay->pending, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+
+    // trace
+    tb_trace_d("splice: send %ld, errno: %d", real, errno);
+
+    // ok?
+    if (real > 0) return real;
+
+    // continue?
+    if (!real || errno == EINTR || errno == EAGAIN) return 0;
+
+    // error
+    return -1;
+}
+#else
+static tb_long_t tb_socket_relay_recv(tb_socket_relay_t* relay)
+{
+    // recv data to the buffer
+    tb_long_t real = tb_socket_recv(relay->isock, relay->data, TB_SOCKET_RELAY_DATA_SIZE);
+    if (real > 0)
+    {
+        relay->offset = 0;
+        relay->bwait = tb_false;
+        return real;
+    }
+
+    /* no data after waiting? the socket is closed or the edge-triggered event was cached before reading,
+     * so we poll it directly to distinguish them
+     */
+    if (!real && relay->bwait && tb_socket_wait(relay->isock, TB_SOCKET_EVENT_RECV, 0) > 0)
+    {
+        real = tb_socket_recv(relay->isock, relay->data, TB_SOCKET_RELAY_DATA_SIZE);
+        if (real > 0)
+        {
+            relay->offset = 0;
+            relay->bwait = tb_false;
+            return real;
+        }
+        relay->bend = !real;
+        return -1;
+    }
+    return real;
+}
+static tb_long_t tb_socket_relay_send(tb_socket_relay_t* relay)
+{
+    // send the pending data
+    tb_long_t real = tb_socket_send(relay->osock, relay->data + relay->offset, relay->pending);
+    if (real > 0) relay->offset += real;
+    return real;
+}
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_void_t tb_socket_relay_exit_env()
+{
+#ifdef TB_CONFIG_POSIX_HAVE_SPLICE
+    // close all pooled pipes
+    tb_spinlock_enter(&g_pipes_lock);
+    while (g_pipes_count)
+    {
+        g_pipes_count--;
+        close(g_pipes[g_pipes_count][0]);
+        close(g_pipes[g_pipes_count][1]);
+    }
+    tb_spinlock_leave(&g_pipes_lock);
+#endif
+}
+tb_socket_relay_ref_t tb_socket_relay_init(tb_socket_ref_t isock, tb_socket_ref_t osock)
+{
+    // check
+    tb_assert_and_check_return_val(isock && osock, tb_null);
+
+    // make relay
+    tb_socket_relay_t* relay = tb_malloc0_type(tb_socket_relay_t);
+    tb_assert_and_check_return_val(relay, tb_null);
+
+    // init relay
+    relay->isock = isock;
+    relay->osock = osock;
+
+    // init pipe or buffer
+#ifdef TB_CONFIG_POSIX_HAVE_SPLICE
+    if (!tb_socket_relay_pipe_get(relay->pipe, &relay->pipe_size))
+#else
+    if (!(relay->data = tb_malloc_bytes(TB_SOCKET_RELAY_DATA_SIZE)))
+#endif
+    {
+        tb_free(relay);
+        return tb_null;
+    }
+    return (tb_socket_relay_ref_t)relay;
+}
+tb_void_t tb_socket_relay_exit(tb_socket_relay_ref_t self)
+{
+    // check
+    tb_socket_relay_t* relay = (tb_socket_relay_t*)self;
+    tb_assert_and_check_return(relay);
+
+    // exit pipe or buffer, the pipe with the pending data cannot be reused
+#ifdef TB_CONFIG_POSIX_HAVE_SPLICE
+    tb_socket_relay_pipe_put(relay->pipe, !relay->pending);
+#else
+    tb_free(relay->data);
+#endif
+
+    // exit it
+    tb_free(relay);
+}
+tb_long_t tb_socket_relay_spak(tb_socket_relay_ref_t self, tb_socket_ref_t* sock, tb_size_t* events)
+{
+    // check
+    tb_socket_relay_t* relay = (tb_socket_relay_t*)self;
+    tb_assert_and_check_return_val(relay && sock && events, -1);
+
+    // no pending data? recv it
+    if (!relay->pending)
+    {
+        // end?
+        tb_check_return_val(!relay->bend, -1);
+
+        // recv it
+        tb_long_t real = tb_socket_relay_recv(relay);
+        tb_check_return_val(real >= 0, -1);
+
+        // no data? wait the input socket
+        if (!real)
+        {
+#ifndef TB_CONFIG_POSIX_HAVE_SPLICE
+            relay->bwait = tb_true;
+#endif
+            *sock   = relay->isock;
+            *events = TB_SOCKET_EVENT_RECV;
+            return 0;
+        }
+        relay->pending = real;
+    }
+
+    // send the pending data
+    tb_long_t real = tb_socket_relay_send(relay);
+    tb_check_return_val(real >= 0, -1);
+
+    // no space? wait the output socket
+    if (!real)
+    {
+        *sock   = relay->osock;
+        *events = TB_SOCKET_EVENT_SEND;
+        return 0;
+    }
+
+    // update the relayed size
+    relay->pending -= real;
+    relay->total += real;
+    return real;
+}
+tb_hong_t tb_socket_relay_done(tb_socket_relay_ref_t self, tb_long_t timeout)
+{
+    // check
+    tb_socket_relay_t* relay = (tb_socket_relay_t*)self;
+    tb_assert_and_check_return_val(relay, -1);
+
+    // relay all data
+    tb_long_t       real = 0;
+    tb_size_t       events = 0;
+    tb_socket_ref_t sock = tb_null;
+    while ((real = tb_socket_relay_spak(self, &sock, &events)) >= 0)
+    {
+        // wait it, it will only block the current coroutine if be in the coroutine
+        if (!real && tb_socket_wait(sock, events, timeout) <= 0) return -1;
+    }
+
+    // ok?
+    return (relay->bend && !relay->pending)? (tb_hong_t)relay->total : -1;
+}
+tb_hong_t tb_socket_relay(tb_socket_ref_t isock, tb_socket_ref_t osock, tb_long_t timeout)
+{
+    // init relay
+    tb_socket_relay_ref_t relay = tb_socket_relay_init(isock, osock);
+    tb_check_return_val(relay, -1);
+
+    // relay all data
+    tb_hong_t size = tb_socket_relay_done(relay, timeout);
+
+    // exit relay
+    tb_socket_relay_exit(relay);
+    return size;
+}
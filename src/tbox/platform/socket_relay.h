@@ -0,0 +1,114 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        socket_relay.h
+ * @ingroup     platform
+ *
+ */
+#ifndef TB_PLATFORM_SOCKET_RELAY_H
+#define TB_PLATFORM_SOCKET_RELAY_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "socket.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the socket relay ref type
+typedef __tb_typeref__(socket_relay);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init the socket relay which moves the data from one socket to another socket
+ *
+ * it uses splice() through a pooled pipe on linux and the data will not be copied to the user space,
+ * otherwise it will copy the data by a user buffer.
+ *
+ * @param isock     the input socket
+ * @param osock     the output socket
+ *
+ * @return          the relay
+ */
+tb_socket_relay_ref_t   tb_socket_relay_init(tb_socket_ref_t isock, tb_socket_ref_t osock);
+
+/*! exit the socket relay, the sockets will not be closed
+ *
+ * @param relay     the relay
+ */
+tb_void_t               tb_socket_relay_exit(tb_socket_relay_ref_t relay);
+
+/*! relay the data once with the non-blocking mode
+ *
+ * @code
+    tb_socket_ref_t sock = tb_null;
+    tb_size_t       events = 0;
+    tb_long_t       real = 0;
+    while ((real = tb_socket_relay_spak(relay, &sock, &events)) >= 0)
+    {
+        // wait the input or output socket events, we can also add them to the poller
+        if (!real && tb_socket_wait(sock, events, -1) <= 0) break;
+    }
+ * @endcode
+ *
+ * @param relay     the relay
+ * @param sock      the socket which need be waited if no data was relayed
+ * @param events    the socket events which need be waited if no data was relayed
+ *
+ * @return          the relayed size, 0: need wait the socket events, -1: end or failed
+ */
+tb_long_t               tb_socket_relay_spak(tb_socket_relay_ref_t relay, tb_socket_ref_t* sock, tb_size_t* events);
+
+/*! relay all data until the input socket is closed
+ *
+ * @note it will block the current coroutine if be called in the coroutine
+ *
+ * @param relay     the relay
+ * @param timeout   the timeout of each waiting, infinity: -1
+ *
+ * @return          the total relayed size, -1: failed or timeout
+ */
+tb_hong_t               tb_socket_relay_done(tb_socket_relay_ref_t relay, tb_long_t timeout);
+
+/*! relay all data from one socket to another socket until the input socket is closed
+ *
+ * @note it will block the current coroutine if be called in the coroutine
+ *
+ * @param isock     the input socket
+ * @param osock     the output socket
+ * @param timeout   the timeout of each waiting, infinity: -1
+ *
+ * @return          the total relayed size, -1: failed or timeout
+ */
+tb_hong_t               tb_socket_relay(tb_socket_ref_t isock, tb_socket_ref_t osock, tb_long_t timeout);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
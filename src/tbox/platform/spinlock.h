@@ -67,6 +67,42 @@ static __tb_inline_force__ tb_void_t tb_spinlock_exit(tb_spinlock_ref_t lock)
     tb_atomic_flag_clear_explicit(lock, TB_ATOMIC_RELAXED);
 }
 
+/*! enter spinlock without the lock profiler
+ *
+ * @param lock      the lock
+ */
+static __tb_inline_force__ tb_void_t tb_spinlock_enter_without_profiler(tb_spinlock_ref_t lock)
+{
+    // check
+    tb_assert(lock);
+
+    // lock it
+#if defined(tb_cpu_pause) && !defined(TB_CONFIG_MICRO_ENABLE)
+    tb_size_t ncpu = tb_cpu_count();
+#endif
+    while (1)
+    {
+        if (!tb_atomic_flag_test_noatomic(lock) && !tb_atomic_flag_test_and_set(lock))
+            return ;
+
+#if defined(tb_cpu_pause) && !defined(TB_CONFIG_MICRO_ENABLE)
+        if (ncpu > 1)
+        {
+            tb_size_t i, n;
+            for (n = 1; n < 2048; n <<= 1)
+            {
+                for (i = 0; i < n; i++)
+                    tb_cpu_pause();
+
+                if (!tb_atomic_flag_test_noatomic(lock) && !tb_atomic_flag_test_and_set(lock))
+                    return ;
+            }
+        }
+#endif
+        tb_sched_yield();
+    }
+}
+
 /*! enter spinlock
  *
  * @param lock      the lock
@@ -76,6 +112,24 @@ static __tb_inline_force__ tb_void_t tb_spinlock_enter(tb_spinlock_ref_t lock)
     // check
     tb_assert(lock);
 
+#ifdef TB_LOCK_PROFILER_SAMPLE_ENABLE
+    // sample it for the lock profiler, it's only a predictable branch if it's not sampling
+    if (tb_lock_profiler_sampling())
+    {
+        tb_hong_t wait = 0;
+        if (tb_atomic_flag_test_noatomic(lock) || tb_atomic_flag_test_and_set(lock))
+        {
+#ifdef TB_LOCK_PROFILER_ENABLE
+            tb_lock_profiler_occupied(tb_lock_profiler(), (tb_pointer_t)lock);
+#endif
+            wait = tb_lock_profiler_contended((tb_pointer_t)lock);
+            tb_spinlock_enter_without_profiler(lock);
+        }
+        tb_lock_profiler_acquired((tb_pointer_t)lock, wait);
+        return ;
+    }
+#endif
+
     // init occupied
 #ifdef TB_LOCK_PROFILER_ENABLE
     tb_bool_t occupied = tb_false;
@@ -142,42 +196,6 @@ static __tb_inline_force__ tb_void_t tb_spinlock_enter(tb_spinlock_ref_t lock)
     }
 }
 
-/*! enter spinlock without the lock profiler
- *
- * @param lock      the lock
- */
-static __tb_inline_force__ tb_void_t tb_spinlock_enter_without_profiler(tb_spinlock_ref_t lock)
-{
-    // check
-    tb_assert(lock);
-
-    // lock it
-#if defined(tb_cpu_pause) && !defined(TB_CONFIG_MICRO_ENABLE)
-    tb_size_t ncpu = tb_cpu_count();
-#endif
-    while (1)
-    {
-        if (!tb_atomic_flag_test_noatomic(lock) && !tb_atomic_flag_test_and_set(lock))
-            return ;
-
-#if defined(tb_cpu_pause) && !defined(TB_CONFIG_MICRO_ENABLE)
-        if (ncpu > 1)
-        {
-            tb_size_t i, n;
-            for (n = 1; n < 2048; n <<= 1)
-            {
-                for (i = 0; i < n; i++)
-                    tb_cpu_pause();
-
-                if (!tb_atomic_flag_test_noatomic(lock) && !tb_atomic_flag_test_and_set(lock))
-                    return ;
-            }
-        }
-#endif
-        tb_sched_yield();
-    }
-}
-
 /*! try to enter spinlock
  *
  * @param lock      the lock
@@ -189,19 +207,21 @@ static __tb_inline_force__ tb_bool_t tb_spinlock_enter_try(tb_spinlock_ref_t loc
     // check
     tb_assert(lock);
 
-#ifndef TB_LOCK_PROFILER_ENABLE
-    // try locking it
-    return !tb_atomic_flag_test_and_set(lock);
-#else
     // try locking it
     tb_bool_t ok = !tb_atomic_flag_test_and_set(lock);
 
+#ifdef TB_LOCK_PROFILER_ENABLE
     // occupied?
     if (!ok) tb_lock_profiler_occupied(tb_lock_profiler(), (tb_pointer_t)lock);
+#endif
+
+#ifdef TB_LOCK_PROFILER_SAMPLE_ENABLE
+    // sample it for the lock profiler
+    if (ok && tb_lock_profiler_sampling()) tb_lock_profiler_acquired((tb_pointer_t)lock, 0);
+#endif
 
     // ok?
     return ok;
-#endif
 }
 
 /*! try to enter spinlock without the lock profiler
@@ -228,6 +248,11 @@ static __tb_inline_force__ tb_void_t tb_spinlock_leave(tb_spinlock_ref_t lock)
     // check
     tb_assert(lock);
 
+#ifdef TB_LOCK_PROFILER_SAMPLE_ENABLE
+    // sample the hold time for the lock profiler
+    if (tb_lock_profiler_sampling()) tb_lock_profiler_released((tb_pointer_t)lock);
+#endif
+
     // leave
     tb_atomic_flag_clear(lock);
 }
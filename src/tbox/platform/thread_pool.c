@@ -100,6 +100,11 @@ typedef struct __tb_thread_pool_job_t
     // the entry
     tb_list_entry_t                     entry;
 
+#ifdef TB_METRICS_ENABLE
+    // the post time (us)
+    tb_hong_t                           time;
+#endif
+
 }tb_thread_pool_job_t;
 
 // the thread pool job stats type
@@ -505,6 +510,11 @@ static tb_int_t tb_thread_pool_worker_loop(tb_cpointer_t priv)
                 tb_int32_t state = TB_STATE_WAITING;
                 if (tb_atomic32_compare_and_swap(&job->state, &state, TB_STATE_WORKING))
                 {
+                    // the job has left the queue
+#ifdef TB_METRICS_ENABLE
+                    tb_metrics_add(tb_metrics_builtin(TB_METRICS_BUILTIN_THREAD_POOL_QUEUE_DEPTH), -1);
+#endif
+
                     // trace
                     tb_trace_d("worker[%lu]: done: task[%p:%s]: ..", worker->id, job->task.done, job->task.name);
 
@@ -560,6 +570,12 @@ static tb_int_t tb_thread_pool_worker_loop(tb_cpointer_t priv)
                     tb_trace_d("worker[%lu]: done: task[%p:%s]: time: %lld ms, average: %lld ms, count: %lu", worker->id, job->task.done, job->task.name, time, (total_time / (tb_hize_t)done_count), done_count);
 #endif
 
+                    // record the task latency from posting it to finishing it
+#ifdef TB_METRICS_ENABLE
+                    tb_hong_t latency = tb_uclock() - job->time;
+                    tb_metrics_record(tb_metrics_builtin(TB_METRICS_BUILTIN_THREAD_POOL_TASK_LATENCY), latency > 0? (tb_hize_t)latency : 0);
+#endif
+
                     // update the job state
                     tb_atomic32_set(&job->state, TB_STATE_FINISHED);
                 }
@@ -618,6 +634,27 @@ static tb_int_t tb_thread_pool_worker_loop(tb_cpointer_t priv)
 /* //////////////////////////////////////////////////////////////////////////////////////
  * jobs implementation
  */
+static tb_void_t tb_thread_pool_job_kill(tb_thread_pool_job_t* job)
+{
+    // kill it if be waiting
+#ifdef TB_METRICS_ENABLE
+    if (tb_atomic32_fetch_and_cmpset(&job->state, TB_STATE_WAITING, TB_STATE_KILLING) == TB_STATE_WAITING)
+        tb_metrics_add(tb_metrics_builtin(TB_METRICS_BUILTIN_THREAD_POOL_QUEUE_DEPTH), -1);
+#else
+    tb_atomic32_fetch_and_cmpset(&job->state, TB_STATE_WAITING, TB_STATE_KILLING);
+#endif
+}
+#ifdef TB_METRICS_ENABLE
+static tb_bool_t tb_thread_pool_jobs_pred_waiting(tb_iterator_ref_t iterator, tb_cpointer_t item, tb_cpointer_t value)
+{
+    // the job
+    tb_thread_pool_job_t* job = (tb_thread_pool_job_t*)item;
+    tb_assert_and_check_return_val(job, tb_false);
+
+    // is waiting?
+    return tb_atomic32_get(&job->state) == TB_STATE_WAITING;
+}
+#endif
 static tb_bool_t tb_thread_pool_jobs_walk_kill_all(tb_pointer_t item, tb_cpointer_t priv)
 {
     // check
@@ -628,7 +665,7 @@ static tb_bool_t tb_thread_pool_jobs_walk_kill_all(tb_pointer_t item, tb_cpointe
     tb_trace_d("task[%p:%s]: kill: ..", job->task.done, job->task.name);
 
     // kill it if be waiting
-    tb_atomic32_fetch_and_cmpset(&job->state, TB_STATE_WAITING, TB_STATE_KILLING);
+    tb_thread_pool_job_kill(job);
 
     // ok
     return tb_true;
@@ -678,6 +715,9 @@ static tb_thread_pool_job_t* tb_thread_pool_jobs_post_task(tb_thread_pool_impl_t
         tb_atomic32_init(&job->refn, 1);
         tb_atomic32_init(&job->state, TB_STATE_WAITING);
         job->task   = *task;
+#ifdef TB_METRICS_ENABLE
+        job->time   = tb_uclock();
+#endif
 
         // non-urgent job?
         if (!task->urgent)
@@ -691,6 +731,11 @@ static tb_thread_pool_job_t* tb_thread_pool_jobs_post_task(tb_thread_pool_impl_t
             tb_list_entry_insert_tail(&impl->jobs_urgent, &job->entry);
         }
 
+        // the job has entered the queue
+#ifdef TB_METRICS_ENABLE
+        tb_metrics_add(tb_metrics_builtin(TB_METRICS_BUILTIN_THREAD_POOL_QUEUE_DEPTH), 1);
+#endif
+
         // the waiting jobs count
         tb_size_t jobs_waiting_count = tb_list_entry_size(&impl->jobs_waiting) + tb_list_entry_size(&impl->jobs_urgent);
         tb_assert_and_check_break(jobs_waiting_count);
@@ -793,7 +838,7 @@ tb_thread_pool_ref_t tb_thread_pool_init(tb_size_t worker_maxn, tb_size_t stack)
         tb_assert_and_check_break(impl->semaphore);
 
         // register lock profiler
-#ifdef TB_LOCK_PROFILER_ENABLE
+#ifdef TB_LOCK_PROFILER_REGISTER_ENABLE
         tb_lock_profiler_register(tb_lock_profiler(), (tb_pointer_t)&impl->lock, TB_TRACE_MODULE_NAME);
 #endif
 
@@ -864,6 +909,15 @@ tb_bool_t tb_thread_pool_exit(tb_thread_pool_ref_t pool)
     // enter
     tb_spinlock_enter(&impl->lock);
 
+    // the waiting jobs will be never done, remove them from the queue depth
+#ifdef TB_METRICS_ENABLE
+    tb_size_t jobs_waiting_count = 0;
+    jobs_waiting_count += tb_count_all_if(tb_list_entry_itor(&impl->jobs_pending), tb_thread_pool_jobs_pred_waiting, tb_null);
+    jobs_waiting_count += tb_count_all_if(tb_list_entry_itor(&impl->jobs_waiting), tb_thread_pool_jobs_pred_waiting, tb_null);
+    jobs_waiting_count += tb_count_all_if(tb_list_entry_itor(&impl->jobs_urgent), tb_thread_pool_jobs_pred_waiting, tb_null);
+    if (jobs_waiting_count) tb_metrics_add(tb_metrics_builtin(TB_METRICS_BUILTIN_THREAD_POOL_QUEUE_DEPTH), -(tb_long_t)jobs_waiting_count);
+#endif
+
     // exit pending jobs
     tb_list_entry_exit(&impl->jobs_pending);
 
@@ -1127,7 +1181,7 @@ tb_void_t tb_thread_pool_task_kill(tb_thread_pool_ref_t pool, tb_thread_pool_tas
     tb_trace_d("task[%p:%s]: kill: state: %s: ..", job->task.done, job->task.name, tb_state_cstr(tb_atomic32_get(&job->state)));
 
     // kill it if be waiting
-    tb_atomic32_fetch_and_cmpset(&job->state, TB_STATE_WAITING, TB_STATE_KILLING);
+    tb_thread_pool_job_kill(job);
 }
 tb_void_t tb_thread_pool_task_kill_all(tb_thread_pool_ref_t pool)
 {
@@ -240,7 +240,7 @@ tb_timer_ref_t tb_timer_init(tb_size_t grow, tb_bool_t ctime)
         tb_assert_and_check_break(timer->heap);
 
         // register lock profiler
-#ifdef TB_LOCK_PROFILER_ENABLE
+#ifdef TB_LOCK_PROFILER_REGISTER_ENABLE
         tb_lock_profiler_register(tb_lock_profiler(), (tb_pointer_t)&timer->lock, TB_TRACE_MODULE_NAME);
 #endif
         // ok
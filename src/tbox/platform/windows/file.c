@@ -42,6 +42,17 @@
 /* //////////////////////////////////////////////////////////////////////////////////////
  * private implementation
  */
+static tb_size_t tb_file_mmap_granularity()
+{
+    static tb_size_t s_granularity = 0;
+    if (!s_granularity)
+    {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        s_granularity = info.dwAllocationGranularity;
+    }
+    return s_granularity;
+}
 static tb_void_t tb_file_mkdir(tb_wchar_t const* path)
 {
     // make directory
@@ -384,6 +395,62 @@ tb_hize_t tb_file_size(tb_file_ref_t file)
     LARGE_INTEGER p = {{0}};
     return pGetFileSizeEx((HANDLE)file, &p)? (tb_hong_t)p.QuadPart : 0;
 }
+tb_byte_t* tb_file_mmap(tb_file_ref_t file, tb_hize_t offset, tb_size_t size, tb_size_t flags)
+{
+    // check
+    tb_assert_and_check_return_val(file && size, tb_null);
+
+    // the offset must be aligned by the allocation granularity
+    tb_size_t granularity = tb_file_mmap_granularity();
+    tb_assert_and_check_return_val(granularity, tb_null);
+    tb_size_t delta = (tb_size_t)(offset & (granularity - 1));
+    offset -= delta;
+
+    // the protection and access
+    DWORD protect = PAGE_READONLY;
+    DWORD access = FILE_MAP_READ;
+    if (flags & TB_FILE_MMAP_WRITE)
+    {
+        protect = (flags & TB_FILE_MMAP_PRIVATE)? PAGE_WRITECOPY : PAGE_READWRITE;
+        access = (flags & TB_FILE_MMAP_PRIVATE)? FILE_MAP_COPY : FILE_MAP_WRITE;
+    }
+
+    // create the file mapping
+    HANDLE mapping = CreateFileMappingW((HANDLE)file, tb_null, protect, 0, 0, tb_null);
+    tb_check_return_val(mapping, tb_null);
+
+    // map it, @note the view will hold the file mapping, so we can close it directly
+    tb_byte_t* base = (tb_byte_t*)MapViewOfFile(mapping, access, (DWORD)(offset >> 32), (DWORD)offset, size + delta);
+    CloseHandle(mapping);
+
+    // ok?
+    return base? base + delta : tb_null;
+}
+tb_bool_t tb_file_munmap(tb_byte_t* data, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(data && size, tb_false);
+
+    // the view address is always aligned by the allocation granularity
+    tb_size_t granularity = tb_file_mmap_granularity();
+    return UnmapViewOfFile((tb_pointer_t)((tb_size_t)data & ~(granularity - 1)))? tb_true : tb_false;
+}
+tb_bool_t tb_file_madvise(tb_byte_t* data, tb_size_t size, tb_size_t advice)
+{
+    // check
+    tb_assert_and_check_return_val(data && size, tb_false);
+
+    // it is only a hint and not supported now, so we ignore it
+    return tb_true;
+}
+tb_bool_t tb_file_msync(tb_byte_t* data, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(data && size, tb_false);
+
+    // flush it
+    return FlushViewOfFile(data, size)? tb_true : tb_false;
+}
 tb_bool_t tb_file_info(tb_char_t const* path, tb_file_info_t* info)
 {
     // check
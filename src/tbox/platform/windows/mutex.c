@@ -75,6 +75,24 @@ tb_void_t tb_mutex_exit(tb_mutex_ref_t mutex)
 }
 tb_bool_t tb_mutex_enter(tb_mutex_ref_t mutex)
 {
+#ifdef TB_LOCK_PROFILER_SAMPLE_ENABLE
+    // sample it for the lock profiler, it's only a predictable branch if it's not sampling
+    if (tb_lock_profiler_sampling())
+    {
+        tb_hong_t wait = 0;
+        if (!tb_mutex_entry_try_without_profiler(mutex))
+        {
+#ifdef TB_LOCK_PROFILER_ENABLE
+            tb_lock_profiler_occupied(tb_lock_profiler(), (tb_handle_t)mutex);
+#endif
+            wait = tb_lock_profiler_contended((tb_pointer_t)mutex);
+            if (!tb_mutex_enter_without_profiler(mutex)) return tb_false;
+        }
+        tb_lock_profiler_acquired((tb_pointer_t)mutex, wait);
+        return tb_true;
+    }
+#endif
+
     // try to enter for profiler
 #ifdef TB_LOCK_PROFILER_ENABLE
     if (tb_mutex_enter_try(mutex)) return tb_true;
@@ -92,10 +110,19 @@ tb_bool_t tb_mutex_enter_try(tb_mutex_ref_t mutex)
 #endif
         return tb_false;
     }
+
+#ifdef TB_LOCK_PROFILER_SAMPLE_ENABLE
+    // sample it for the lock profiler
+    if (tb_lock_profiler_sampling()) tb_lock_profiler_acquired((tb_pointer_t)mutex, 0);
+#endif
     return tb_true;
 }
 tb_bool_t tb_mutex_leave(tb_mutex_ref_t mutex)
 {
+#ifdef TB_LOCK_PROFILER_SAMPLE_ENABLE
+    // sample the hold time for the lock profiler
+    if (mutex && tb_lock_profiler_sampling()) tb_lock_profiler_released((tb_pointer_t)mutex);
+#endif
     if (mutex) return ReleaseMutex((HANDLE)mutex)? tb_true : tb_false;
     return tb_false;
 }
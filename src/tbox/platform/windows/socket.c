@@ -712,6 +712,16 @@ tb_long_t tb_socket_send(tb_socket_ref_t sock, tb_byte_t const* data, tb_size_t
     // error
     return -1;
 }
+tb_long_t tb_socket_send_zerocopy(tb_socket_ref_t sock, tb_byte_t const* data, tb_size_t size)
+{
+    // not supported, we send it directly
+    return tb_socket_send(sock, data, size);
+}
+tb_long_t tb_socket_zerocopy_reap(tb_socket_ref_t sock, tb_uint32_t* last, tb_bool_t* copied)
+{
+    // not supported, no completion
+    return 0;
+}
 tb_hong_t tb_socket_sendf(tb_socket_ref_t sock, tb_file_ref_t file, tb_hize_t offset, tb_hize_t size)
 {
     // check
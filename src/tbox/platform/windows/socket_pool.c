@@ -65,7 +65,7 @@ static tb_spinlock_t        g_lock = TB_SPINLOCK_INIT;
 tb_bool_t tb_socket_pool_init()
 {
     // register lock profiler
-#ifdef TB_LOCK_PROFILER_ENABLE
+#ifdef TB_LOCK_PROFILER_REGISTER_ENABLE
     tb_lock_profiler_register(tb_lock_profiler(), (tb_pointer_t)&g_lock, TB_TRACE_MODULE_NAME);
 #endif
 
@@ -63,6 +63,8 @@ typedef enum __tb_filter_ctrl_e
 ,   TB_FILTER_CTRL_ZIP_GET_ACTION        = TB_FILTER_CTRL(TB_FILTER_TYPE_ZIP, 2)
 ,   TB_FILTER_CTRL_ZIP_SET_ALGO          = TB_FILTER_CTRL(TB_FILTER_TYPE_ZIP, 3)
 ,   TB_FILTER_CTRL_ZIP_SET_ACTION        = TB_FILTER_CTRL(TB_FILTER_TYPE_ZIP, 4)
+,   TB_FILTER_CTRL_ZIP_GET_OPTION        = TB_FILTER_CTRL(TB_FILTER_TYPE_ZIP, 5)
+,   TB_FILTER_CTRL_ZIP_SET_OPTION        = TB_FILTER_CTRL(TB_FILTER_TYPE_ZIP, 6)
 
 ,   TB_FILTER_CTRL_CHARSET_GET_FTYPE     = TB_FILTER_CTRL(TB_FILTER_TYPE_CHARSET, 1)
 ,   TB_FILTER_CTRL_CHARSET_GET_TTYPE     = TB_FILTER_CTRL(TB_FILTER_TYPE_CHARSET, 2)
@@ -98,7 +100,7 @@ tb_filter_ref_t         tb_filter_init_from_charset(tb_size_t fr, tb_size_t to);
 
 /*! init filter from chunked
  *
- * @param dechunked decode the chunked data?
+ * @param dechunked decode the chunked data? or encode data to the chunked data
  *
  * @return              the filter
  */
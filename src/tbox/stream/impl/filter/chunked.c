@@ -48,6 +48,9 @@ typedef struct __tb_filter_chunked_t
     // the cache line
     tb_string_t                 line;
 
+    // the end chunk has been encoded?
+    tb_bool_t                   bended;
+
 }tb_filter_chunked_t;
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -202,6 +205,65 @@ static tb_long_t tb_filter_chunked_spak(tb_filter_t* filter, tb_static_stream_re
     // ok
     return (op - ob);
 }
+/* encode chunked data
+ *
+ * ea5\r\n ..........\r\n e65\r\n..............\r\n 0\r\n\r\n
+ */
+static tb_long_t tb_filter_chunked_spak_encode(tb_filter_t* filter, tb_static_stream_ref_t istream, tb_static_stream_ref_t ostream, tb_long_t sync)
+{
+    // check
+    tb_filter_chunked_t* cfilter = tb_filter_chunked_cast(filter);
+    tb_assert_and_check_return_val(cfilter && istream && ostream, -1);
+    tb_assert_and_check_return_val(tb_static_stream_valid(ostream), -1);
+
+    // the idata, @note istream maybe null for sync the end data
+    tb_byte_t const*    ip = tb_static_stream_valid(istream)? tb_static_stream_pos(istream) : tb_null;
+    tb_byte_t const*    ie = tb_static_stream_valid(istream)? tb_static_stream_end(istream) : tb_null;
+
+    // the odata
+    tb_byte_t*          op = (tb_byte_t*)tb_static_stream_pos(ostream);
+    tb_byte_t*          oe = (tb_byte_t*)tb_static_stream_end(ostream);
+    tb_byte_t*          ob = op;
+
+    // encode one chunk, we reserve 20 bytes for the chunk head and tail
+    if (ip < ie && oe - op > 20)
+    {
+        // the chunk size
+        tb_size_t size = tb_min(ie - ip, oe - op - 20);
+
+        // make chunk head
+        op += tb_snprintf((tb_char_t*)op, 20, "%lx\r\n", size);
+
+        // copy chunk data
+        tb_memcpy(op, ip, size);
+        ip += size;
+        op += size;
+
+        // make chunk tail
+        *op++ = '\r';
+        *op++ = '\n';
+
+        // update istream
+        tb_static_stream_goto(istream, (tb_byte_t*)ip);
+    }
+
+    // end? make the end chunk after all data has been encoded
+    if (sync < 0 && ip == ie && !cfilter->bended && oe - op >= 5)
+    {
+        tb_memcpy(op, "0\r\n\r\n", 5);
+        op += 5;
+        cfilter->bended = tb_true;
+    }
+
+    // update ostream
+    tb_static_stream_goto(ostream, op);
+
+    // trace
+    tb_trace_d("[%p]: encode: %lu, bended: %d", cfilter, op - ob, cfilter->bended);
+
+    // ok?
+    return (op > ob || !cfilter->bended)? (op - ob) : -1;
+}
 static tb_void_t tb_filter_chunked_clos(tb_filter_t* filter)
 {
     // check
@@ -216,6 +278,9 @@ static tb_void_t tb_filter_chunked_clos(tb_filter_t* filter)
 
     // clear line
     tb_string_clear(&cfilter->line);
+
+    // clear the end state
+    cfilter->bended = tb_false;
 }
 static tb_void_t tb_filter_chunked_exit(tb_filter_t* filter)
 {
@@ -237,20 +302,13 @@ tb_filter_ref_t tb_filter_init_from_chunked(tb_bool_t dechunked)
     tb_filter_chunked_t* filter = tb_null;
     do
     {
-        // noimpl for encoding chunked
-        if (!dechunked)
-        {
-            tb_trace_noimpl();
-            break;
-        }
-
         // make filter
         filter = tb_malloc0_type(tb_filter_chunked_t);
         tb_assert_and_check_break(filter);
 
         // init filter
         if (!tb_filter_init((tb_filter_t*)filter, TB_FILTER_TYPE_CHUNKED)) break;
-        filter->base.spak = tb_filter_chunked_spak;
+        filter->base.spak = dechunked? tb_filter_chunked_spak : tb_filter_chunked_spak_encode;
         filter->base.clos = tb_filter_chunked_clos;
         filter->base.exit = tb_filter_chunked_exit;
 
@@ -41,6 +41,9 @@ typedef struct __tb_filter_zip_t
     // the action
     tb_size_t                   action;
 
+    // the option
+    tb_zip_option_t             option;
+
     // the zip
     tb_zip_ref_t                zip;
 
@@ -62,7 +65,7 @@ static tb_bool_t tb_filter_zip_open(tb_filter_t* filter)
     tb_assert_and_check_return_val(zfilter && !zfilter->zip, tb_false);
 
     // init zip
-    zfilter->zip = tb_zip_init(zfilter->algo, zfilter->action);
+    zfilter->zip = tb_zip_init_with_option(zfilter->algo, zfilter->action, &zfilter->option);
     tb_assert_and_check_return_val(zfilter->zip, tb_false);
 
     // ok
@@ -143,6 +146,30 @@ static tb_bool_t tb_filter_zip_ctrl(tb_filter_t* filter, tb_size_t ctrl, tb_va_l
             // set action
             zfilter->action = (tb_size_t)tb_va_arg(args, tb_size_t);
 
+            // ok
+            return tb_true;
+        }
+    case TB_FILTER_CTRL_ZIP_GET_OPTION:
+        {
+            // the poption
+            tb_zip_option_t* poption = (tb_zip_option_t*)tb_va_arg(args, tb_zip_option_t*);
+            tb_assert_and_check_break(poption);
+
+            // get option
+            *poption = zfilter->option;
+
+            // ok
+            return tb_true;
+        }
+    case TB_FILTER_CTRL_ZIP_SET_OPTION:
+        {
+            // the option
+            tb_zip_option_t const* option = (tb_zip_option_t const*)tb_va_arg(args, tb_zip_option_t const*);
+            tb_assert_and_check_break(option);
+
+            // set option, it will be used after opening the filter
+            zfilter->option = *option;
+
             // ok
             return tb_true;
         }
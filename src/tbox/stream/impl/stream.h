@@ -109,6 +109,15 @@ typedef struct __tb_stream_t
     // kill
     tb_void_t           (*kill)(tb_stream_ref_t stream);
 
+    /* peek the contiguous data at the current offset without copying it to the cache, optional
+     *
+     * it will be used by tb_stream_peek() and tb_stream_need() if the cache is empty,
+     * and tb_stream_read() will also bypass the cache, e.g. the file stream with mmap mode
+     *
+     * @return          the real size, 0: no data, -1: end or failed
+     */
+    tb_long_t           (*peek)(tb_stream_ref_t stream, tb_byte_t** data, tb_size_t size);
+
 }tb_stream_t;
 
 
@@ -23,6 +23,7 @@
  * includes
  */
 #include "prefix.h"
+#include "../stream.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * macros
@@ -53,6 +54,15 @@ typedef struct __tb_stream_file_t
     // is stream file?
     tb_bool_t           bstream;
 
+    // enable mmap mode?
+    tb_bool_t           bmmap;
+
+    // the mapped data
+    tb_byte_t*          mdata;
+
+    // the mapped size
+    tb_size_t           msize;
+
 }tb_stream_file_t;
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -66,6 +76,64 @@ static __tb_inline__ tb_stream_file_t* tb_stream_file_cast(tb_stream_ref_t strea
     // ok?
     return (tb_stream_file_t*)stream;
 }
+#ifndef __tb_debug__
+static tb_long_t tb_stream_file_mmap_peek(tb_stream_ref_t stream, tb_byte_t** data, tb_size_t size)
+{
+    // check
+    tb_stream_file_t* stream_file = tb_stream_file_cast(stream);
+    tb_assert_and_check_return_val(stream_file && stream_file->mdata && data, -1);
+
+    // end?
+    tb_check_return_val(stream_file->offset < stream_file->msize, -1);
+
+    // peek the mapped data directly
+    *data = stream_file->mdata + stream_file->offset;
+    return (tb_long_t)tb_min(size, stream_file->msize - (tb_size_t)stream_file->offset);
+}
+#endif
+static tb_void_t tb_stream_file_mmap_init(tb_stream_ref_t stream)
+{
+    // check
+    tb_stream_file_t* stream_file = tb_stream_file_cast(stream);
+    tb_assert_and_check_return(stream_file && stream_file->file && !stream_file->mdata);
+
+    // only map the readonly and seekable file
+    tb_check_return(stream_file->bmmap && !stream_file->bstream);
+    tb_check_return(!(stream_file->mode & (TB_FILE_MODE_WO | TB_FILE_MODE_RW)));
+
+    // the file size, we do not map the empty or too large file
+    tb_hize_t filesize = tb_file_size(stream_file->file);
+    tb_check_return(filesize && filesize == (tb_hize_t)(tb_size_t)filesize);
+
+    // map it, we will read it with the normal mode if failed
+    stream_file->mdata = tb_file_mmap(stream_file->file, 0, (tb_size_t)filesize, TB_FILE_MMAP_READ);
+    tb_check_return(stream_file->mdata);
+    stream_file->msize = (tb_size_t)filesize;
+
+    // we always read it sequentially for stream
+    tb_file_madvise(stream_file->mdata, stream_file->msize, TB_FILE_MADVISE_SEQUENTIAL);
+
+    /* peek the mapped data directly
+     *
+     * @note the mapped data is not allocated by the allocator, and the peeked data may be copied by the checked tb_memcpy()
+     * in the debug mode, it will access the data head before the mapped pages, so we peek it from the read cache in the debug mode
+     */
+#ifndef __tb_debug__
+    tb_stream_cast(stream)->peek = tb_stream_file_mmap_peek;
+#endif
+}
+static tb_void_t tb_stream_file_mmap_exit(tb_stream_ref_t stream)
+{
+    // check
+    tb_stream_file_t* stream_file = tb_stream_file_cast(stream);
+    tb_assert_and_check_return(stream_file);
+
+    // unmap it
+    if (stream_file->mdata) tb_file_munmap(stream_file->mdata, stream_file->msize);
+    stream_file->mdata = tb_null;
+    stream_file->msize = 0;
+    tb_stream_cast(stream)->peek = tb_null;
+}
 static tb_bool_t tb_stream_file_open(tb_stream_ref_t stream)
 {
     // check
@@ -93,6 +161,9 @@ static tb_bool_t tb_stream_file_open(tb_stream_ref_t stream)
     // init offset
     stream_file->offset = 0;
 
+    // map the file data if mmap mode is enabled
+    tb_stream_file_mmap_init(stream);
+
     // ok
     return tb_true;
 }
@@ -102,6 +173,9 @@ static tb_bool_t tb_stream_file_clos(tb_stream_ref_t stream)
     tb_stream_file_t* stream_file = tb_stream_file_cast(stream);
     tb_assert_and_check_return_val(stream_file, tb_false);
 
+    // unmap the file data
+    tb_stream_file_mmap_exit(stream);
+
     // exit file
     if (stream_file->file && !tb_file_exit(stream_file->file)) return tb_false;
     stream_file->file = tb_null;
@@ -122,6 +196,19 @@ static tb_long_t tb_stream_file_read(tb_stream_ref_t stream, tb_byte_t* data, tb
     tb_check_return_val(data, -1);
     tb_check_return_val(size, 0);
 
+    // read the mapped data
+    if (stream_file->mdata)
+    {
+        tb_size_t left = stream_file->offset < stream_file->msize? stream_file->msize - (tb_size_t)stream_file->offset : 0;
+        stream_file->read = (tb_long_t)tb_min(size, left);
+        if (stream_file->read > 0)
+        {
+            tb_memcpy_(data, stream_file->mdata + stream_file->offset, stream_file->read);
+            stream_file->offset += stream_file->read;
+        }
+        return stream_file->read;
+    }
+
     // read
     stream_file->read = tb_file_read(stream_file->file, data, size);
     if (stream_file->read > 0)
@@ -169,6 +256,14 @@ static tb_bool_t tb_stream_file_seek(tb_stream_ref_t stream, tb_hize_t offset)
     // is stream file?
     tb_check_return_val(!stream_file->bstream, tb_false);
 
+    // seek the mapped data
+    if (stream_file->mdata)
+    {
+        tb_check_return_val(offset <= stream_file->msize, tb_false);
+        stream_file->offset = offset;
+        return tb_true;
+    }
+
     // seek
     if (tb_file_seek(stream_file->file, offset, TB_FILE_SEEK_BEG) == offset)
     {
@@ -257,6 +352,21 @@ static tb_bool_t tb_stream_file_ctrl(tb_stream_ref_t stream, tb_size_t ctrl, tb_
             stream_file->bstream = (tb_bool_t)tb_va_arg(args, tb_bool_t);
             return tb_true;
         }
+    case TB_STREAM_CTRL_FILE_SET_MMAP:
+        {
+            stream_file->bmmap = (tb_bool_t)tb_va_arg(args, tb_bool_t);
+            return tb_true;
+        }
+    case TB_STREAM_CTRL_FILE_GET_MMAP:
+        {
+            // the pbmmap
+            tb_bool_t* pbmmap = (tb_bool_t*)tb_va_arg(args, tb_bool_t*);
+            tb_assert_and_check_return_val(pbmmap, tb_false);
+
+            // is mapped now?
+            *pbmmap = stream_file->mdata? tb_true : tb_false;
+            return tb_true;
+        }
     case TB_STREAM_CTRL_FILE_GET_FILE:
         {
             // the pfile
@@ -301,6 +411,7 @@ tb_stream_ref_t tb_stream_init_file()
         // init it
         stream_file->mode      = TB_FILE_MODE_RO;
         stream_file->bstream   = tb_false;
+        stream_file->bmmap     = tb_false;
         stream_file->read      = 0;
     }
 
@@ -324,6 +324,17 @@ static tb_bool_t tb_stream_http_ctrl(tb_stream_ref_t stream, tb_size_t ctrl, tb_
             return tb_http_ctrl(stream_http->http, TB_HTTP_OPTION_GET_HEAD_PRIV, phead_priv);
         }
         break;
+    case TB_STREAM_CTRL_HTTP_GET_STATUS:
+        {
+            // pstatus
+            tb_http_status_t const** pstatus = (tb_http_status_t const**)tb_va_arg(args, tb_http_status_t const**);
+            tb_assert_and_check_return_val(pstatus, tb_false);
+
+            // get status
+            *pstatus = tb_http_status(stream_http->http);
+            return *pstatus? tb_true : tb_false;
+        }
+        break;
     case TB_STREAM_CTRL_HTTP_SET_RANGE:
         {
             tb_hize_t bof = (tb_hize_t)tb_va_arg(args, tb_hize_t);
@@ -107,6 +107,8 @@ typedef enum __tb_stream_ctrl_e
 ,   TB_STREAM_CTRL_FILE_SET_MODE            = TB_STREAM_CTRL(TB_STREAM_TYPE_FILE, 2)
 ,   TB_STREAM_CTRL_FILE_AS_STREAM           = TB_STREAM_CTRL(TB_STREAM_TYPE_FILE, 3)
 ,   TB_STREAM_CTRL_FILE_GET_FILE            = TB_STREAM_CTRL(TB_STREAM_TYPE_FILE, 4)
+,   TB_STREAM_CTRL_FILE_GET_MMAP            = TB_STREAM_CTRL(TB_STREAM_TYPE_FILE, 5)
+,   TB_STREAM_CTRL_FILE_SET_MMAP            = TB_STREAM_CTRL(TB_STREAM_TYPE_FILE, 6)
 
     // the stream for sock
 ,   TB_STREAM_CTRL_SOCK_GET_TYPE            = TB_STREAM_CTRL(TB_STREAM_TYPE_SOCK, 1)
@@ -129,6 +131,7 @@ typedef enum __tb_stream_ctrl_e
 ,   TB_STREAM_CTRL_HTTP_GET_POST_FUNC       = TB_STREAM_CTRL(TB_STREAM_TYPE_HTTP, 12)
 ,   TB_STREAM_CTRL_HTTP_GET_POST_PRIV       = TB_STREAM_CTRL(TB_STREAM_TYPE_HTTP, 13)
 ,   TB_STREAM_CTRL_HTTP_GET_POST_LRATE      = TB_STREAM_CTRL(TB_STREAM_TYPE_HTTP, 14)
+,   TB_STREAM_CTRL_HTTP_GET_STATUS          = TB_STREAM_CTRL(TB_STREAM_TYPE_HTTP, 15)
 
 ,   TB_STREAM_CTRL_HTTP_SET_HEAD            = TB_STREAM_CTRL(TB_STREAM_TYPE_HTTP, 20)
 ,   TB_STREAM_CTRL_HTTP_SET_RANGE           = TB_STREAM_CTRL(TB_STREAM_TYPE_HTTP, 21)
@@ -622,8 +622,17 @@ tb_bool_t tb_stream_open(tb_stream_ref_t self)
     stream->state = TB_STATE_OK;
 
     // open it
+#ifdef TB_METRICS_ENABLE
+    tb_hong_t time = tb_uclock();
+#endif
     tb_bool_t ok = stream->open(self);
 
+    // record the open time
+#ifdef TB_METRICS_ENABLE
+    time = tb_uclock() - time;
+    tb_metrics_record(tb_metrics_builtin(TB_METRICS_BUILTIN_STREAM_OPEN_LATENCY), time > 0? (tb_hize_t)time : 0);
+#endif
+
     // opened
     if (ok) tb_atomic32_set(&stream->istate, TB_STATE_OPENED);
 
@@ -678,6 +687,13 @@ tb_bool_t tb_stream_need(tb_stream_ref_t self, tb_byte_t** data, tb_size_t size)
     // check the cache mode, must be read cache
     tb_assert_and_check_return_val(!stream->bwrited, tb_false);
 
+    // need the data directly without cache? e.g. the mapped file data
+    if (stream->peek && tb_queue_buffer_null(&stream->cache))
+    {
+        tb_long_t real = stream->peek(self, data, size);
+        return (real > 0 && (tb_size_t)real == size)? tb_true : tb_false;
+    }
+
     // not enough? grow the cache first
     if (tb_queue_buffer_maxn(&stream->cache) < size) tb_queue_buffer_resize(&stream->cache, size);
 
@@ -765,6 +781,10 @@ tb_long_t tb_stream_peek(tb_stream_ref_t self, tb_byte_t** data, tb_size_t size)
     // check the cache mode, must be read cache
     tb_assert_and_check_return_val(!stream->bwrited, -1);
 
+    // peek the data directly without cache? e.g. the mapped file data
+    if (stream->peek && tb_queue_buffer_null(&stream->cache))
+        return stream->peek(self, data, size);
+
     // not enough? grow the cache first
     if (tb_queue_buffer_maxn(&stream->cache) < size) tb_queue_buffer_resize(&stream->cache, size);
 
@@ -821,7 +841,10 @@ tb_long_t tb_stream_read(tb_stream_ref_t self, tb_byte_t* data, tb_size_t size)
     tb_long_t read = 0;
     do
     {
-        if (tb_queue_buffer_maxn(&stream->cache))
+        /* we need not cache it if the stream data can be peeked directly, e.g. the mapped file data,
+         * because it will copy data twice
+         */
+        if (tb_queue_buffer_maxn(&stream->cache) && !(stream->peek && !stream->bwrited && tb_queue_buffer_null(&stream->cache)))
         {
             // switch to the read cache mode
             if (stream->bwrited && tb_queue_buffer_null(&stream->cache)) stream->bwrited = 0;
@@ -875,6 +898,11 @@ tb_long_t tb_stream_read(tb_stream_ref_t self, tb_byte_t* data, tb_size_t size)
     // update offset
     stream->offset += read;
 
+    // update the read bytes
+#ifdef TB_METRICS_ENABLE
+    if (read) tb_metrics_add(tb_metrics_builtin(TB_METRICS_BUILTIN_STREAM_READ_BYTES), read);
+#endif
+
 //  tb_trace_d("read: %d", read);
     return read;
 }
@@ -947,6 +975,11 @@ tb_long_t tb_stream_writ(tb_stream_ref_t self, tb_byte_t const* data, tb_size_t
     // update offset
     stream->offset += writ;
 
+    // update the written bytes
+#ifdef TB_METRICS_ENABLE
+    if (writ) tb_metrics_add(tb_metrics_builtin(TB_METRICS_BUILTIN_STREAM_WRIT_BYTES), writ);
+#endif
+
 //  tb_trace_d("writ: %d", writ);
     return writ;
 }
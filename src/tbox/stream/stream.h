@@ -321,6 +321,15 @@ tb_stream_ref_t         tb_stream_init_from_url(tb_char_t const* url);
 tb_stream_ref_t         tb_stream_init_from_data(tb_byte_t const* data, tb_size_t size);
 
 /*! init stream from file
+ *
+ * we can enable the mmap mode for the readonly file before opening it, e.g.
+ *
+ * @code
+ * tb_stream_ctrl(stream, TB_STREAM_CTRL_FILE_SET_MMAP, tb_true);
+ * @endcode
+ *
+ * then tb_stream_peek() and tb_stream_need() will return the mapped file data directly without copying,
+ * but they still return the copied data in the read cache for the debug mode.
  *
  * @param path          the file path
  * @param mode          the file mode, using the default ro mode if zero
@@ -31,8 +31,386 @@
  */
 #include "stream.h"
 #include "transfer.h"
+#include "impl/stream.h"
 #include "../network/network.h"
 #include "../platform/platform.h"
+#if defined(TB_CONFIG_MODULE_HAVE_COROUTINE) \
+        && !defined(TB_CONFIG_MICRO_ENABLE)
+#   include "../coroutine/coroutine.h"
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the maximum size of transferring data in the kernel at once
+#define TB_TRANSFER_FAST_MAXN               (1 << 20)
+
+// the block size of the parallel transfer
+#define TB_TRANSFER_PARALLEL_BLOCK          (1 << 17)
+
+// the minimum range size of the parallel transfer
+#define TB_TRANSFER_PARALLEL_RANGE_MINN     (1 << 20)
+
+// the default connection count of the parallel transfer
+#define TB_TRANSFER_PARALLEL_COUNT          (4)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the token bucket type for limiting rate
+typedef struct __tb_transfer_bucket_t
+{
+    // the limit rate, bytes/s, no limit if 0
+    tb_size_t               rate;
+
+    // the bucket capacity
+    tb_hong_t               burst;
+
+    // the current tokens, it will be negative if we have taken more data than tokens
+    tb_hong_t               tokens;
+
+    // the last refilled time
+    tb_hong_t               time;
+
+}tb_transfer_bucket_t;
+
+// the fast transfer type, we transfer data in the kernel without copying it to the user space
+typedef struct __tb_transfer_fast_t
+{
+    // the input file
+    tb_file_ref_t           ifile;
+
+    // the output file
+    tb_file_ref_t           ofile;
+
+    // the output socket
+    tb_socket_ref_t         osock;
+
+}tb_transfer_fast_t;
+
+#if defined(TB_CONFIG_MODULE_HAVE_COROUTINE) \
+        && !defined(TB_CONFIG_MICRO_ENABLE)
+// the parallel transfer block type
+typedef struct __tb_transfer_block_t
+{
+    // the output file offset
+    tb_hize_t                   offset;
+
+    // the data size
+    tb_size_t                   size;
+
+    // the data
+    tb_byte_t                   data[TB_TRANSFER_PARALLEL_BLOCK];
+
+}tb_transfer_block_t;
+
+// the parallel transfer type
+typedef struct __tb_transfer_parallel_t
+{
+    // the input url
+    tb_char_t const*            iurl;
+
+    // the probed input stream, it will be used to fetch the first range
+    tb_stream_ref_t             istream;
+
+    // the output file
+    tb_file_ref_t               ofile;
+
+    // the filled blocks, coroutines -> writer thread
+    tb_co_thread_channel_ref_t  filled;
+
+    // the free blocks, writer thread -> coroutines
+    tb_co_thread_channel_ref_t  freed;
+
+    // the token bucket, it is shared by all range coroutines
+    tb_transfer_bucket_t        bucket;
+
+    // the document size
+    tb_hize_t                   size;
+
+    // the received size, it is only used in the scheduler thread
+    tb_hize_t                   read;
+
+    // the written size, it is only used in the writer thread
+    tb_hize_t                   writ;
+
+    // is failed?
+    tb_atomic32_t               failed;
+
+    // the func
+    tb_transfer_func_t          func;
+
+    // the func private data
+    tb_cpointer_t               priv;
+
+    // the base time
+    tb_hong_t                   base;
+
+    // the base time for the current rate
+    tb_hong_t                   base1s;
+
+    // the received size in the current 1s
+    tb_size_t                   read1s;
+
+}tb_transfer_parallel_t;
+
+// the parallel transfer range type
+typedef struct __tb_transfer_range_t
+{
+    // the parallel transfer
+    tb_transfer_parallel_t*     parallel;
+
+    // the begin offset
+    tb_hize_t                   bof;
+
+    // the end offset, not included
+    tb_hize_t                   eof;
+
+}tb_transfer_range_t;
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_void_t tb_transfer_bucket_init(tb_transfer_bucket_t* bucket, tb_size_t rate)
+{
+    // the capacity is the tokens of 100ms, so the burst data will not exceed the rate too much
+    bucket->rate    = rate;
+    bucket->burst   = tb_max(rate / 10, 1);
+    bucket->tokens  = bucket->burst;
+    bucket->time    = tb_mclock();
+}
+static tb_void_t tb_transfer_bucket_take(tb_transfer_bucket_t* bucket, tb_size_t size)
+{
+    // no limit?
+    tb_check_return(bucket->rate);
+
+    // refill tokens
+    tb_hong_t time = tb_mclock();
+    tb_hong_t fill = ((time - bucket->time) * bucket->rate) / 1000;
+    if (fill > 0)
+    {
+        bucket->tokens += fill;
+        if (bucket->tokens > bucket->burst) bucket->tokens = bucket->burst;
+        bucket->time = time;
+    }
+
+    // take tokens
+    bucket->tokens -= size;
+
+    /* wait until the debt is paid off
+     *
+     * @note tb_msleep() will only suspend the current coroutine if we are in coroutine
+     */
+    if (bucket->tokens < 0) tb_msleep((tb_size_t)((-bucket->tokens * 1000) / bucket->rate));
+}
+static tb_bool_t tb_transfer_fast_init(tb_transfer_fast_t* fast, tb_stream_ref_t istream, tb_stream_ref_t ostream)
+{
+    // init it
+    tb_memset(fast, 0, sizeof(tb_transfer_fast_t));
+
+    // the input stream must be a seekable file without the cached data
+    tb_stream_t* stream = tb_stream_cast(istream);
+    tb_check_return_val(stream && tb_stream_type(istream) == TB_STREAM_TYPE_FILE && tb_stream_size(istream) >= 0, tb_false);
+    tb_check_return_val(!stream->bwrited && tb_queue_buffer_null(&stream->cache), tb_false);
+    if (!tb_stream_ctrl(istream, TB_STREAM_CTRL_FILE_GET_FILE, &fast->ifile) || !fast->ifile) return tb_false;
+
+    // the output stream is file or tcp socket?
+    switch (tb_stream_type(ostream))
+    {
+    case TB_STREAM_TYPE_FILE:
+        {
+            // the output file must be seekable
+            tb_check_return_val(tb_stream_size(ostream) >= 0, tb_false);
+            if (!tb_stream_ctrl(ostream, TB_STREAM_CTRL_FILE_GET_FILE, &fast->ofile) || !fast->ofile) return tb_false;
+        }
+        break;
+    case TB_STREAM_TYPE_SOCK:
+        {
+            // we cannot send the file data directly for ssl
+            tb_bool_t bssl = tb_false;
+            if (!tb_stream_ctrl(ostream, TB_STREAM_CTRL_GET_SSL, &bssl) || bssl) return tb_false;
+
+            // only for tcp
+            tb_size_t type = 0;
+            if (!tb_stream_ctrl(ostream, TB_STREAM_CTRL_SOCK_GET_TYPE, &type) || type != TB_SOCKET_TYPE_TCP) return tb_false;
+            if (!tb_stream_ctrl(ostream, TB_STREAM_CTRL_SOCK_GET_SOCK, &fast->osock) || !fast->osock) return tb_false;
+        }
+        break;
+    default:
+        return tb_false;
+    }
+
+    // flush the cached data of the output stream first
+    return tb_stream_sync(ostream, tb_false);
+}
+static tb_long_t tb_transfer_fast_done(tb_transfer_fast_t* fast, tb_stream_ref_t istream, tb_stream_ref_t ostream, tb_size_t size)
+{
+    // transfer it in the kernel, e.g. copy_file_range, sendfile
+    tb_hize_t offset = tb_stream_offset(istream);
+    tb_hong_t real = fast->ofile? tb_file_writf(fast->ofile, fast->ifile, offset, size) : tb_socket_sendf(fast->osock, fast->ifile, offset, size);
+    if (real > 0)
+    {
+        // update the input offset, it will also update the file offset
+        if (!tb_stream_seek(istream, offset + real)) return -1;
+
+        // update the output offset, the file offset has been updated by the kernel
+        if (fast->ofile)
+        {
+            if (!tb_stream_seek(ostream, tb_stream_offset(ostream) + real)) return -1;
+        }
+        else tb_stream_cast(ostream)->offset += real;
+    }
+    return (tb_long_t)real;
+}
+
+#if defined(TB_CONFIG_MODULE_HAVE_COROUTINE) \
+        && !defined(TB_CONFIG_MICRO_ENABLE)
+static tb_int_t tb_transfer_parallel_writer(tb_cpointer_t priv)
+{
+    // check
+    tb_transfer_parallel_t* parallel = (tb_transfer_parallel_t*)priv;
+    tb_assert_and_check_return_val(parallel, -1);
+
+    // writ all filled blocks to the output file until the channel is closed
+    tb_pointer_t data = tb_null;
+    while (tb_co_thread_channel_recv(parallel->filled, &data, -1))
+    {
+        // the block
+        tb_transfer_block_t* block = (tb_transfer_block_t*)data;
+        tb_assert_and_check_break(block);
+
+        // writ it if not failed
+        if (!tb_atomic32_get(&parallel->failed))
+        {
+            tb_size_t writ = 0;
+            while (writ < block->size)
+            {
+                tb_long_t real = tb_file_pwrit(parallel->ofile, block->data + writ, block->size - writ, block->offset + writ);
+                tb_check_break(real > 0);
+                writ += real;
+            }
+            if (writ == block->size) parallel->writ += writ;
+            else tb_atomic32_set(&parallel->failed, 1);
+        }
+
+        // give back this block
+        if (!tb_co_thread_channel_send(parallel->freed, block, -1)) break;
+    }
+    return 0;
+}
+static tb_void_t tb_transfer_parallel_done(tb_transfer_parallel_t* parallel, tb_size_t size)
+{
+    // save read
+    parallel->read += size;
+
+    // has func?
+    tb_check_return(parallel->func);
+
+    // done func for each 1s
+    tb_hong_t time = tb_cache_time_spak();
+    parallel->read1s += size;
+    if (time >= parallel->base1s + 1000)
+    {
+        // the current rate
+        tb_size_t crate = (tb_size_t)(((tb_hize_t)parallel->read1s * 1000) / (time - parallel->base1s));
+
+        // reset it
+        parallel->base1s = time;
+        parallel->read1s = 0;
+
+        // done func
+        parallel->func(TB_STATE_OK, parallel->read, parallel->size, parallel->read, crate, parallel->priv);
+    }
+}
+static tb_void_t tb_transfer_parallel_range(tb_cpointer_t priv)
+{
+    // check
+    tb_transfer_range_t*    range = (tb_transfer_range_t*)priv;
+    tb_transfer_parallel_t* parallel = range? range->parallel : tb_null;
+    tb_assert_and_check_return(range && parallel);
+
+    // done
+    tb_bool_t       ok = tb_false;
+    tb_hize_t       offset = range->bof;
+    tb_stream_ref_t stream = tb_null;
+    do
+    {
+        // the first range uses the probed stream directly, we only read the front data of it
+        if (!range->bof)
+        {
+            stream = parallel->istream;
+            parallel->istream = tb_null;
+            tb_assert_and_check_break(stream);
+        }
+        else
+        {
+            // init stream
+            stream = tb_stream_init_from_url(parallel->iurl);
+            tb_assert_and_check_break(stream);
+
+            // set range
+            if (!tb_stream_ctrl(stream, TB_STREAM_CTRL_HTTP_SET_RANGE, range->bof, range->eof - 1)) break;
+
+            // open stream
+            if (!tb_stream_open(stream)) break;
+
+            // the server must respond the partial content
+            tb_http_status_t const* status = tb_null;
+            if (!tb_stream_ctrl(stream, TB_STREAM_CTRL_HTTP_GET_STATUS, &status) || !status) break;
+            if (status->code != TB_HTTP_CODE_PARTIAL_CONTENT)
+            {
+                // trace
+                tb_trace_e("parallel: the range(%llu-%llu) is not supported, code: %u", range->bof, range->eof - 1, status->code);
+                break;
+            }
+        }
+
+        // read all data of this range
+        while (offset < range->eof && !tb_atomic32_get(&parallel->failed))
+        {
+            // get a free block
+            tb_pointer_t data = tb_null;
+            if (!tb_co_thread_channel_recv(parallel->freed, &data, -1)) break;
+
+            // the block
+            tb_transfer_block_t* block = (tb_transfer_block_t*)data;
+            tb_assert_and_check_break(block);
+
+            // read data to this block
+            block->offset = offset;
+            block->size = (tb_size_t)tb_min(range->eof - offset, TB_TRANSFER_PARALLEL_BLOCK);
+            if (!tb_stream_bread(stream, block->data, block->size))
+            {
+                tb_co_thread_channel_send(parallel->freed, block, -1);
+                break;
+            }
+
+            // post it to the writer thread, and we can read the next block at the same time
+            if (!tb_co_thread_channel_send(parallel->filled, block, -1)) break;
+            offset += block->size;
+
+            // limit rate
+            tb_transfer_bucket_take(&parallel->bucket, block->size);
+
+            // done func
+            tb_transfer_parallel_done(parallel, block->size);
+        }
+
+        // ok?
+        ok = offset == range->eof;
+
+    } while (0);
+
+    // failed? stop all ranges
+    if (!ok) tb_atomic32_set(&parallel->failed, 1);
+
+    // exit stream
+    if (stream) tb_stream_exit(stream);
+}
+#endif
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
@@ -51,6 +429,10 @@ tb_hong_t tb_transfer(tb_stream_ref_t istream, tb_stream_ref_t ostream, tb_size_
     // done func
     if (func) func(TB_STATE_OK, tb_stream_offset(istream), tb_stream_size(istream), 0, 0, priv);
 
+    // init the token bucket for limit rate
+    tb_transfer_bucket_t bucket;
+    tb_transfer_bucket_init(&bucket, lrate);
+
     // writ data
     tb_byte_t data[TB_STREAM_BLOCK_MAXN];
     tb_hize_t writ = 0;
@@ -59,73 +441,107 @@ tb_hong_t tb_transfer(tb_stream_ref_t istream, tb_stream_ref_t ostream, tb_size_
     tb_hong_t base1s = base;
     tb_hong_t time = 0;
     tb_size_t crate = 0;
-    tb_long_t delay = 0;
     tb_size_t writ1s = 0;
+
+    // can we transfer data in the kernel?
+    tb_transfer_fast_t fast;
+    tb_bool_t bfast = left && tb_transfer_fast_init(&fast, istream, ostream);
     do
     {
-        // the need
-        tb_size_t need = lrate? tb_min(lrate, TB_STREAM_BLOCK_MAXN) : TB_STREAM_BLOCK_MAXN;
-
-        // read data
-        tb_long_t real = tb_stream_read(istream, data, need);
-        if (real > 0)
+        // transfer data in the kernel
+        tb_long_t real = 0;
+        if (bfast)
         {
-            // writ data
-            if (!tb_stream_bwrit(ostream, data, real)) break;
+            // the need
+            tb_size_t need = lrate? tb_min(lrate, TB_TRANSFER_FAST_MAXN) : TB_TRANSFER_FAST_MAXN;
+            if (need > left - writ) need = (tb_size_t)(left - writ);
 
-            // save writ
-            writ += real;
+            // transfer it
+            real = tb_transfer_fast_done(&fast, istream, ostream, need);
 
-            // has func or limit rate?
-            if (func || lrate)
+            // failed? we attempt to transfer the left data in the user space
+            if (real < 0)
             {
-                // the time
-                time = tb_cache_time_spak();
-
-                // < 1s?
-                if (time < base1s + 1000)
+                bfast = tb_false;
+                continue;
+            }
+            // no data?
+            else if (!real)
+            {
+                /* the input file may have been truncated, or the copy has been interrupted,
+                 * we transfer the left data in the user space, it will find the real end of the input
+                 */
+                if (fast.ofile)
                 {
-                    // save writ1s
-                    writ1s += real;
-
-                    // save current rate if < 1s from base
-                    if (time < base + 1000) crate = writ1s;
-
-                    // compute the delay for limit rate
-                    if (lrate) delay = writ1s >= lrate? (tb_size_t)(base1s + 1000 - time) : 0;
+                    bfast = tb_false;
+                    continue;
                 }
-                else
-                {
-                    // save current rate
-                    crate = writ1s;
-
-                    // update base1s
-                    base1s = time;
 
-                    // reset writ1s
-                    writ1s = 0;
+                // wait the socket
+                tb_long_t wait = tb_stream_wait(ostream, TB_STREAM_WAIT_WRIT, tb_stream_timeout(ostream));
+                tb_check_break(wait > 0);
 
-                    // reset delay
-                    delay = 0;
+                // has writ?
+                tb_assert_and_check_break(wait & TB_STREAM_WAIT_WRIT);
+                continue;
+            }
+        }
+        else
+        {
+            // the need
+            tb_size_t need = lrate? tb_min(lrate, TB_STREAM_BLOCK_MAXN) : TB_STREAM_BLOCK_MAXN;
 
-                    // done func
-                    if (func) func(TB_STATE_OK, tb_stream_offset(istream), tb_stream_size(istream), writ, crate, priv);
-                }
+            // read data
+            real = tb_stream_read(istream, data, need);
+            if (real > 0)
+            {
+                // writ data
+                if (!tb_stream_bwrit(ostream, data, real)) break;
+            }
+            else if (!real)
+            {
+                // wait
+                tb_long_t wait = tb_stream_wait(istream, TB_STREAM_WAIT_READ, tb_stream_timeout(istream));
+                tb_check_break(wait > 0);
 
-                // wait some time for limit rate
-                if (delay) tb_msleep(delay);
+                // has read?
+                tb_assert_and_check_break(wait & TB_STREAM_WAIT_READ);
+                continue;
             }
+            else break;
         }
-        else if (!real)
+
+        // save writ
+        writ += real;
+
+        // limit rate
+        tb_transfer_bucket_take(&bucket, real);
+
+        // has func?
+        if (func)
         {
-            // wait
-            tb_long_t wait = tb_stream_wait(istream, TB_STREAM_WAIT_READ, tb_stream_timeout(istream));
-            tb_check_break(wait > 0);
+            // the time
+            time = tb_cache_time_spak();
+
+            // save writ1s
+            writ1s += real;
+
+            // update the current rate and done func for each 1s
+            if (time >= base1s + 1000)
+            {
+                // save current rate
+                crate = (tb_size_t)(((tb_hize_t)writ1s * 1000) / (time - base1s));
 
-            // has writ?
-            tb_assert_and_check_break(wait & TB_STREAM_WAIT_READ);
+                // update base1s
+                base1s = time;
+
+                // reset writ1s
+                writ1s = 0;
+
+                // done func
+                func(TB_STATE_OK, tb_stream_offset(istream), tb_stream_size(istream), writ, crate, priv);
+            }
         }
-        else break;
 
         // is end?
         if (writ >= left) break;
@@ -400,4 +816,170 @@ tb_hong_t tb_transfer_data_to_stream(tb_byte_t const* idata, tb_size_t isize, tb
     // ok?
     return size;
 }
+tb_hong_t tb_transfer_url_parallel(tb_char_t const* iurl, tb_char_t const* ourl, tb_size_t count, tb_size_t lrate, tb_transfer_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_assert_and_check_return_val(iurl && ourl, -1);
+
+#if defined(TB_CONFIG_MODULE_HAVE_COROUTINE) \
+        && !defined(TB_CONFIG_MICRO_ENABLE)
+    /* we only split the http input to the file output,
+     * and we cannot run a new scheduler in the coroutine
+     */
+    if (    tb_coroutine_self()
+        ||  tb_url_protocol_probe(iurl) != TB_URL_PROTOCOL_HTTP
+        ||  tb_url_protocol_probe(ourl) != TB_URL_PROTOCOL_FILE)
+        return tb_transfer_url(iurl, ourl, lrate, func, priv);
+
+    // done
+    tb_bool_t               ok = tb_false;
+    tb_hong_t               size = -1;
+    tb_thread_ref_t         writer = tb_null;
+    tb_co_scheduler_ref_t   scheduler = tb_null;
+    tb_transfer_block_t*    blocks = tb_null;
+    tb_transfer_range_t*    ranges = tb_null;
+    tb_transfer_parallel_t  parallel;
+    tb_memset(&parallel, 0, sizeof(tb_transfer_parallel_t));
+    do
+    {
+        // probe the input stream
+        parallel.istream = tb_stream_init_from_url(iurl);
+        tb_assert_and_check_break(parallel.istream);
+        if (!tb_stream_open(parallel.istream)) break;
+
+        // can we split it to ranges? the document size must be known and the server must support range
+        tb_hong_t               isize = tb_stream_size(parallel.istream);
+        tb_http_status_t const* status = tb_null;
+        if (!count) count = TB_TRANSFER_PARALLEL_COUNT;
+        if (isize > 0 && tb_stream_ctrl(parallel.istream, TB_STREAM_CTRL_HTTP_GET_STATUS, &status) && status && status->bseeked)
+            count = (tb_size_t)tb_min(count, isize / TB_TRANSFER_PARALLEL_RANGE_MINN);
+        else count = 1;
+
+        // transfer it serially
+        if (count <= 1)
+        {
+            size = tb_transfer_to_url(parallel.istream, ourl, lrate, func, priv);
+            break;
+        }
+
+        // init the output file
+        parallel.ofile = tb_file_init(ourl, TB_FILE_MODE_RW | TB_FILE_MODE_CREAT | TB_FILE_MODE_TRUNC);
+        tb_check_break(parallel.ofile);
+
+        // init the parallel transfer
+        parallel.iurl   = iurl;
+        parallel.size   = isize;
+        parallel.func   = func;
+        parallel.priv   = priv;
+        parallel.base   = tb_cache_time_spak();
+        parallel.base1s = parallel.base;
+        tb_atomic32_init(&parallel.failed, 0);
+        tb_transfer_bucket_init(&parallel.bucket, lrate);
+
+        // init channels
+        parallel.filled = tb_co_thread_channel_init(0, tb_null, tb_null);
+        parallel.freed = tb_co_thread_channel_init(0, tb_null, tb_null);
+        tb_assert_and_check_break(parallel.filled && parallel.freed);
+
+        // init blocks, each range has two blocks for double-buffering, one is being received and the other is being written
+        tb_size_t i;
+        blocks = tb_nalloc_type(count << 1, tb_transfer_block_t);
+        tb_assert_and_check_break(blocks);
+        for (i = 0; i < (count << 1); i++)
+        {
+            if (!tb_co_thread_channel_send(parallel.freed, &blocks[i], -1)) break;
+        }
+        tb_assert_and_check_break(i == (count << 1));
+
+        // init ranges
+        ranges = tb_nalloc0_type(count, tb_transfer_range_t);
+        tb_assert_and_check_break(ranges);
+        for (i = 0; i < count; i++)
+        {
+            ranges[i].parallel  = &parallel;
+            ranges[i].bof       = (isize / count) * i;
+            ranges[i].eof       = (i + 1 < count)? (isize / count) * (i + 1) : isize;
+        }
+
+        // init the writer thread
+        writer = tb_thread_init(tb_null, tb_transfer_parallel_writer, &parallel, 0);
+        tb_assert_and_check_break(writer);
+
+        // init scheduler
+        scheduler = tb_co_scheduler_init();
+        tb_assert_and_check_break(scheduler);
+
+        // start all ranges
+        for (i = 0; i < count; i++)
+        {
+            if (!tb_coroutine_start(scheduler, tb_transfer_parallel_range, &ranges[i], 0)) break;
+        }
+        tb_assert_and_check_break(i == count);
 
+        // done func
+        if (func) func(TB_STATE_OK, 0, isize, 0, 0, priv);
+
+        // run scheduler until all ranges have been finished
+        tb_co_scheduler_loop(scheduler, tb_true);
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // exit the writer thread after writing all filled blocks
+    if (writer)
+    {
+        tb_co_thread_channel_close(parallel.filled);
+        tb_thread_wait(writer, -1, tb_null);
+        tb_thread_exit(writer);
+        writer = tb_null;
+    }
+
+    // all data have been written?
+    if (ok && !tb_atomic32_get(&parallel.failed) && parallel.writ == parallel.size && tb_file_sync(parallel.ofile))
+    {
+        // save size
+        size = parallel.writ;
+
+        // done func
+        if (func)
+        {
+            tb_hong_t time = tb_cache_time_spak();
+            tb_size_t trate = (time > parallel.base)? (tb_size_t)((parallel.writ * 1000) / (time - parallel.base)) : (tb_size_t)parallel.writ;
+            func(TB_STATE_CLOSED, parallel.read, parallel.size, parallel.writ, trate, priv);
+        }
+    }
+
+    // exit scheduler
+    if (scheduler) tb_co_scheduler_exit(scheduler);
+    scheduler = tb_null;
+
+    // exit channels
+    if (parallel.filled) tb_co_thread_channel_exit(parallel.filled);
+    if (parallel.freed) tb_co_thread_channel_exit(parallel.freed);
+    parallel.filled = tb_null;
+    parallel.freed = tb_null;
+
+    // exit blocks
+    if (blocks) tb_free(blocks);
+    blocks = tb_null;
+
+    // exit ranges
+    if (ranges) tb_free(ranges);
+    ranges = tb_null;
+
+    // exit the probed stream if it has been not used
+    if (parallel.istream) tb_stream_exit(parallel.istream);
+    parallel.istream = tb_null;
+
+    // exit the output file
+    if (parallel.ofile) tb_file_exit(parallel.ofile);
+    parallel.ofile = tb_null;
+
+    // ok?
+    return size;
+#else
+    return tb_transfer_url(iurl, ourl, lrate, func, priv);
+#endif
+}
@@ -102,6 +102,27 @@ tb_hong_t           tb_transfer_to_data(tb_stream_ref_t istream, tb_byte_t* odat
  */
 tb_hong_t           tb_transfer_url(tb_char_t const* iurl, tb_char_t const* ourl, tb_size_t lrate, tb_transfer_func_t func, tb_cpointer_t priv);
 
+/*! transfer url to url in parallel
+ *
+ * we split the http input to some byte ranges and fetch them concurrently in coroutines,
+ * and the received blocks will be written to the output file by a writer thread at the same time.
+ *
+ * it will transfer it serially if the server does not support range or the document size is unknown,
+ * and it is same as tb_transfer_url() if the input is not http or the output is not file.
+ *
+ * @note we cannot call it in coroutine, because it need run a new scheduler
+ *
+ * @param iurl      the input url
+ * @param ourl      the output file url
+ * @param count     the connection count, using the default count if 0
+ * @param lrate     the limit rate of all connections and no limit if 0, bytes/s
+ * @param func      the save func and be optional
+ * @param priv      the func private data
+ *
+ * @return          the saved size, failed: -1
+ */
+tb_hong_t           tb_transfer_url_parallel(tb_char_t const* iurl, tb_char_t const* ourl, tb_size_t count, tb_size_t lrate, tb_transfer_func_t func, tb_cpointer_t priv);
+
 /*! transfer url to stream
  *
  * @param iurl      the input url
@@ -32,6 +32,9 @@
 #include "lock_profiler.h"
 #include "singleton.h"
 #include "../platform/platform.h"
+#ifdef TB_CONFIG_MODULE_HAVE_OBJECT
+#   include "../object/object.h"
+#endif
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * macros
@@ -44,6 +47,18 @@
 #   define TB_LOCK_PROFILER_MAXN            (512)
 #endif
 
+// the sampled lock maxn of each thread
+#define TB_LOCK_PROFILER_SAMPLE_MAXN        (64)
+
+// the held lock maxn of each thread for computing the hold time
+#define TB_LOCK_PROFILER_HELD_MAXN          (8)
+
+// the call site maxn of each lock
+#define TB_LOCK_PROFILER_CALLSITE_MAXN      (4)
+
+// the frame count of each call site
+#define TB_LOCK_PROFILER_CALLSITE_FRAMES    (4)
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
@@ -70,6 +85,559 @@ typedef struct __tb_lock_profiler_t
 
 }tb_lock_profiler_t;
 
+#ifdef TB_LOCK_PROFILER_SAMPLE_ENABLE
+// the call site type
+typedef struct __tb_lock_profiler_callsite_t
+{
+    // the frames of the lock owner
+    tb_pointer_t                    frames[TB_LOCK_PROFILER_CALLSITE_FRAMES];
+
+    // the frame count
+    tb_size_t                       nframe;
+
+    // the sampled count
+    tb_size_t                       count;
+
+    // the total hold time (us)
+    tb_hong_t                       hold;
+
+}tb_lock_profiler_callsite_t;
+
+// the sampled lock type
+typedef struct __tb_lock_profiler_sample_t
+{
+    // the lock address, it will be published after initializing this sample
+    tb_atomic_t                     lock;
+
+    // the estimated acquired count
+    tb_hize_t                       acquired;
+
+    // the contended count
+    tb_hize_t                       contended;
+
+    // the sampled count of the hold time
+    tb_hize_t                       sampled;
+
+    // the total wait time of all contended acquisitions (us)
+    tb_hong_t                       wait;
+
+    // the total hold time of the sampled acquisitions (us)
+    tb_hong_t                       hold;
+
+    // the log2 histogram of the wait time
+    tb_uint32_t                     wait_histogram[TB_LOCK_PROFILER_HISTOGRAM_MAXN];
+
+    // the log2 histogram of the hold time
+    tb_uint32_t                     hold_histogram[TB_LOCK_PROFILER_HISTOGRAM_MAXN];
+
+    // the hottest call sites of the lock owner
+    tb_lock_profiler_callsite_t     callsites[TB_LOCK_PROFILER_CALLSITE_MAXN];
+
+}tb_lock_profiler_sample_t;
+
+// the held lock type
+typedef struct __tb_lock_profiler_held_t
+{
+    // the lock address
+    tb_pointer_t                    lock;
+
+    // the sampled lock
+    tb_lock_profiler_sample_t*      sample;
+
+    // the call site
+    tb_lock_profiler_callsite_t*    callsite;
+
+    // the acquired time
+    tb_hong_t                       time;
+
+}tb_lock_profiler_held_t;
+
+/* the thread record type
+ *
+ * the counters are only written by the owner thread and be merged on dump without lock,
+ * the records are never freed before exiting tbox, the record of the exited thread will be reused.
+ */
+typedef struct __tb_lock_profiler_record_t
+{
+    // the next record in the global record list, it will not be changed after inserting it
+    struct __tb_lock_profiler_record_t* next;
+
+    // is owned by a thread?
+    tb_atomic_t                     owned;
+
+    // the sampling session, the held locks of the previous session are invalid
+    tb_size_t                       session;
+
+    // the data generation, the samples of the previous generation have been cleared
+    tb_atomic_t                     generation;
+
+    // the acquisition count until the next sampling
+    tb_size_t                       countdown;
+
+    // the dropped count if the samples are full
+    tb_size_t                       dropped;
+
+    // the held locks
+    tb_lock_profiler_held_t         held[TB_LOCK_PROFILER_HELD_MAXN];
+
+    // the held lock count
+    tb_size_t                       held_count;
+
+    // the sampled locks
+    tb_lock_profiler_sample_t       samples[TB_LOCK_PROFILER_SAMPLE_MAXN];
+
+}tb_lock_profiler_record_t;
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the sample rate
+tb_atomic32_t                                           g_lock_profiler_sample_rate = 0;
+
+#ifdef TB_LOCK_PROFILER_SAMPLE_ENABLE
+// the sampling session
+static tb_atomic_t                                      g_lock_profiler_session = 0;
+
+// the data generation
+static tb_atomic_t                                      g_lock_profiler_generation = 0;
+
+// the global record list
+static tb_atomic_t                                      g_lock_profiler_records = 0;
+
+// the thread local record, it will be released after the thread exited
+static tb_thread_local_t                                g_lock_profiler_local = TB_THREAD_LOCAL_INIT;
+
+// the cached thread local record for the fast path
+static __tb_thread_local__ tb_lock_profiler_record_t*   g_lock_profiler_record = tb_null;
+
+// is profiling now? we need avoid to sample the locks used by the profiler itself
+static __tb_thread_local__ tb_bool_t                    g_lock_profiler_busy = tb_false;
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * declaration
+ */
+__tb_extern_c_enter__
+tb_void_t tb_lock_profiler_exit_env(tb_noarg_t);
+__tb_extern_c_leave__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+#ifdef TB_LOCK_PROFILER_SAMPLE_ENABLE
+static __tb_inline__ tb_size_t tb_lock_profiler_hash(tb_pointer_t lock)
+{
+    // compile the hash value of the lock address
+    tb_size_t addr = (tb_size_t)lock;
+    return addr ^ (addr >> 8) ^ (addr >> 16);
+}
+static tb_char_t const* tb_lock_profiler_name(tb_lock_profiler_t* profiler, tb_pointer_t lock)
+{
+    // check
+    tb_check_return_val(profiler && lock, tb_null);
+
+    // find the registered name
+    tb_size_t i = 0;
+    tb_size_t addr = tb_lock_profiler_hash(lock);
+    for (i = 0; i < 16; i++, addr++)
+    {
+        tb_lock_profiler_item_t* item = &profiler->list[addr & (TB_LOCK_PROFILER_MAXN - 1)];
+        if (lock == (tb_pointer_t)tb_atomic_get(&item->lock))
+            return (tb_char_t const*)tb_atomic_get(&item->name);
+    }
+    return tb_null;
+}
+static __tb_inline__ tb_size_t tb_lock_profiler_bucket(tb_hong_t time)
+{
+    // bucket 0: [0, 1us), bucket i: [2^(i - 1)us, 2^i us)
+    tb_size_t i = 0;
+    for (; time > 0 && i < TB_LOCK_PROFILER_HISTOGRAM_MAXN - 1; time >>= 1) i++;
+    return i;
+}
+static tb_lock_profiler_callsite_t* tb_lock_profiler_callsite(tb_lock_profiler_sample_t* sample, tb_pointer_t* frames, tb_size_t nframe, tb_size_t count)
+{
+    /* find or insert the call site
+     *
+     * we only keep the hottest call sites, the coldest one will be replaced if it's full (space-saving),
+     * so the count of the new call site is overestimated.
+     */
+    tb_size_t                       i = 0;
+    tb_lock_profiler_callsite_t*    coldest = tb_null;
+    for (i = 0; i < TB_LOCK_PROFILER_CALLSITE_MAXN; i++)
+    {
+        tb_lock_profiler_callsite_t* callsite = &sample->callsites[i];
+        if (callsite->nframe == nframe && !tb_memcmp(callsite->frames, frames, nframe * sizeof(tb_pointer_t)))
+        {
+            callsite->count += count;
+            return callsite;
+        }
+        if (!coldest || callsite->count < coldest->count) coldest = callsite;
+    }
+    tb_assert_and_check_return_val(coldest, tb_null);
+    tb_memcpy(coldest->frames, frames, nframe * sizeof(tb_pointer_t));
+    coldest->nframe = nframe;
+    coldest->count += count;
+    return coldest;
+}
+static tb_lock_profiler_sample_t* tb_lock_profiler_sample_find(tb_lock_profiler_sample_t* samples, tb_size_t maxn, tb_pointer_t lock)
+{
+    // find or insert the sampled lock, we need not insert it atomically because it will be only inserted by the owner
+    tb_size_t i = 0;
+    tb_size_t addr = tb_lock_profiler_hash(lock);
+    for (i = 0; i < 16; i++, addr++)
+    {
+        tb_lock_profiler_sample_t*  sample = &samples[addr & (maxn - 1)];
+        tb_pointer_t                key = (tb_pointer_t)tb_atomic_get_explicit(&sample->lock, TB_ATOMIC_RELAXED);
+        if (key == lock) return sample;
+        else if (!key)
+        {
+            tb_atomic_set_explicit(&sample->lock, (tb_long_t)lock, TB_ATOMIC_RELEASE);
+            return sample;
+        }
+    }
+    return tb_null;
+}
+static tb_void_t tb_lock_profiler_record_free(tb_cpointer_t priv)
+{
+    // the record
+    tb_lock_profiler_record_t* record = (tb_lock_profiler_record_t*)priv;
+    tb_assert_and_check_return(record);
+
+    // release this record, the samples will be inherited by the next owner
+    record->held_count = 0;
+    g_lock_profiler_record = tb_null;
+    tb_atomic_set_explicit(&record->owned, 0, TB_ATOMIC_RELEASE);
+}
+static tb_lock_profiler_record_t* tb_lock_profiler_record_init()
+{
+    /* the thread local has been not inited?
+     *
+     * @note we cannot init it here, because the sampled lock may be the lock of the thread local itself
+     */
+    tb_check_return_val(g_lock_profiler_local.inited, tb_null);
+
+    // reuse the released record first
+    tb_lock_profiler_record_t* record = (tb_lock_profiler_record_t*)tb_atomic_get(&g_lock_profiler_records);
+    for (; record; record = record->next)
+    {
+        tb_long_t owned = 0;
+        if (!tb_atomic_get_explicit(&record->owned, TB_ATOMIC_RELAXED) && tb_atomic_compare_and_swap(&record->owned, &owned, 1))
+            break;
+    }
+
+    // make a new record and insert it to the head of the record list
+    if (!record)
+    {
+        record = (tb_lock_profiler_record_t*)tb_native_memory_malloc0(sizeof(tb_lock_profiler_record_t));
+        tb_check_return_val(record, tb_null);
+
+        record->owned = 1;
+        record->generation = tb_atomic_get(&g_lock_profiler_generation);
+        tb_long_t head = tb_atomic_get(&g_lock_profiler_records);
+        do
+        {
+            record->next = (tb_lock_profiler_record_t*)head;
+
+        } while (!tb_atomic_compare_and_swap(&g_lock_profiler_records, &head, (tb_long_t)record));
+    }
+
+    // save it to the current thread
+    if (!tb_thread_local_set(&g_lock_profiler_local, record))
+    {
+        tb_atomic_set(&record->owned, 0);
+        return tb_null;
+    }
+    g_lock_profiler_record = record;
+    return record;
+}
+static tb_lock_profiler_record_t* tb_lock_profiler_record_self()
+{
+    // get the record of the current thread
+    tb_lock_profiler_record_t* record = g_lock_profiler_record;
+    if (!record) record = tb_lock_profiler_record_init();
+    tb_check_return_val(record, tb_null);
+
+    // the samples have been cleared? clear the samples of this record
+    tb_long_t generation = tb_atomic_get_explicit(&g_lock_profiler_generation, TB_ATOMIC_RELAXED);
+    if (tb_atomic_get_explicit(&record->generation, TB_ATOMIC_RELAXED) != generation)
+    {
+        tb_memset(record->samples, 0, sizeof(record->samples));
+        record->held_count = 0;
+        record->dropped = 0;
+        tb_atomic_set_explicit(&record->generation, generation, TB_ATOMIC_RELEASE);
+    }
+
+    // enter a new sampling session? the held locks of the previous session are invalid
+    tb_size_t session = (tb_size_t)tb_atomic_get_explicit(&g_lock_profiler_session, TB_ATOMIC_RELAXED);
+    if (record->session != session)
+    {
+        record->session = session;
+        record->held_count = 0;
+        record->countdown = 0;
+    }
+    return record;
+}
+static tb_void_t tb_lock_profiler_merge_sample(tb_lock_profiler_sample_t* merged, tb_lock_profiler_sample_t const* sample)
+{
+    // merge counters
+    tb_size_t i = 0;
+    merged->acquired    += sample->acquired;
+    merged->contended   += sample->contended;
+    merged->sampled     += sample->sampled;
+    merged->wait        += sample->wait;
+    merged->hold        += sample->hold;
+    for (i = 0; i < TB_LOCK_PROFILER_HISTOGRAM_MAXN; i++)
+    {
+        merged->wait_histogram[i] += sample->wait_histogram[i];
+        merged->hold_histogram[i] += sample->hold_histogram[i];
+    }
+
+    // merge call sites
+    for (i = 0; i < TB_LOCK_PROFILER_CALLSITE_MAXN; i++)
+    {
+        tb_lock_profiler_callsite_t const* callsite = &sample->callsites[i];
+        if (callsite->count && callsite->nframe <= TB_LOCK_PROFILER_CALLSITE_FRAMES)
+        {
+            tb_lock_profiler_callsite_t* merged_callsite = tb_lock_profiler_callsite(merged, (tb_pointer_t*)callsite->frames, callsite->nframe, callsite->count);
+            if (merged_callsite) merged_callsite->hold += callsite->hold;
+        }
+    }
+}
+static tb_lock_profiler_sample_t* tb_lock_profiler_merge(tb_size_t* pcount, tb_size_t* pdropped)
+{
+    // make the merged samples
+    tb_lock_profiler_sample_t* samples = (tb_lock_profiler_sample_t*)tb_native_memory_nalloc0(TB_LOCK_PROFILER_MAXN, sizeof(tb_lock_profiler_sample_t));
+    tb_assert_and_check_return_val(samples, tb_null);
+
+    /* merge the samples of all records
+     *
+     * the counters may be being updated by the owners, so it's only a snapshot.
+     */
+    tb_size_t                   dropped = 0;
+    tb_long_t                   generation = tb_atomic_get(&g_lock_profiler_generation);
+    tb_lock_profiler_record_t*  record = (tb_lock_profiler_record_t*)tb_atomic_get(&g_lock_profiler_records);
+    for (; record; record = record->next)
+    {
+        // skip the cleared samples
+        if (tb_atomic_get(&record->generation) != generation) continue;
+
+        // merge them
+        tb_size_t i = 0;
+        for (i = 0; i < TB_LOCK_PROFILER_SAMPLE_MAXN; i++)
+        {
+            tb_lock_profiler_sample_t*          sample = &record->samples[i];
+            tb_pointer_t                        lock = (tb_pointer_t)tb_atomic_get_explicit(&sample->lock, TB_ATOMIC_ACQUIRE);
+            if (lock)
+            {
+                tb_lock_profiler_sample_t* merged = tb_lock_profiler_sample_find(samples, TB_LOCK_PROFILER_MAXN, lock);
+                if (merged) tb_lock_profiler_merge_sample(merged, sample);
+                else dropped++;
+            }
+        }
+        dropped += record->dropped;
+    }
+
+    // compact them
+    tb_size_t i = 0;
+    tb_size_t count = 0;
+    for (i = 0; i < TB_LOCK_PROFILER_MAXN; i++)
+    {
+        if (tb_atomic_get_explicit(&samples[i].lock, TB_ATOMIC_RELAXED))
+        {
+            // the acquired count is estimated, but it cannot be less than the contended count
+            if (samples[i].acquired < samples[i].contended) samples[i].acquired = samples[i].contended;
+            if (count != i) samples[count] = samples[i];
+            count++;
+        }
+    }
+
+    // sort them by the total wait time and the acquired count, the most contended lock is first
+    for (i = 1; i < count; i++)
+    {
+        tb_size_t                   j = i;
+        tb_lock_profiler_sample_t   sample = samples[i];
+        while (j && (samples[j - 1].wait < sample.wait || (samples[j - 1].wait == sample.wait && samples[j - 1].acquired < sample.acquired)))
+        {
+            samples[j] = samples[j - 1];
+            j--;
+        }
+        if (j != i) samples[j] = sample;
+    }
+
+    // ok
+    if (pcount) *pcount = count;
+    if (pdropped) *pdropped = dropped;
+    return samples;
+}
+static tb_size_t tb_lock_profiler_histogram_cstr(tb_uint32_t const* histogram, tb_char_t* data, tb_size_t maxn)
+{
+    // format the non-empty buckets, e.g. <1us: 10, <2us: 3, >=4194304us: 1
+    tb_size_t i = 0;
+    tb_size_t size = 0;
+    tb_check_return_val(data && maxn, 0);
+    data[0] = '\0';
+    for (i = 0; i < TB_LOCK_PROFILER_HISTOGRAM_MAXN && size + 1 < maxn; i++)
+    {
+        if (!histogram[i]) continue;
+        tb_long_t n = 0;
+        if (i + 1 < TB_LOCK_PROFILER_HISTOGRAM_MAXN)
+            n = tb_snprintf(data + size, maxn - size, "%s<%luus: %u", size? ", " : "", (tb_size_t)1 << i, histogram[i]);
+        else n = tb_snprintf(data + size, maxn - size, "%s>=%luus: %u", size? ", " : "", (tb_size_t)1 << (i - 1), histogram[i]);
+        if (n <= 0) break;
+        size = tb_min(size + n, maxn - 1);
+    }
+    return size;
+}
+static tb_void_t tb_lock_profiler_dump_samples(tb_lock_profiler_t* profiler)
+{
+    // merge samples
+    tb_size_t                   count = 0;
+    tb_size_t                   dropped = 0;
+    tb_lock_profiler_sample_t*  samples = tb_lock_profiler_merge(&count, &dropped);
+    tb_check_return(samples);
+
+    // dump them
+    tb_size_t i = 0;
+    tb_char_t line[1024];
+    if (count) tb_trace_i("sampled locks: %lu, rate: %d, dropped: %lu", count, tb_atomic32_get(&g_lock_profiler_sample_rate), dropped);
+    for (i = 0; i < count; i++)
+    {
+        // dump the lock
+        tb_lock_profiler_sample_t* sample = &samples[i];
+        tb_pointer_t lock = (tb_pointer_t)tb_atomic_get(&sample->lock);
+        tb_trace_i("lock: %p, name: %s, acquired: ~%llu, contended: %llu, wait: %lld us, avg wait: %lld us, avg hold: %lld us"
+                   , lock, tb_lock_profiler_name(profiler, lock), sample->acquired, sample->contended, sample->wait
+                   , sample->contended? sample->wait / (tb_hong_t)sample->contended : 0
+                   , sample->sampled? sample->hold / (tb_hong_t)sample->sampled : 0);
+
+        // dump the histograms
+        if (tb_lock_profiler_histogram_cstr(sample->wait_histogram, line, sizeof(line))) tb_trace_i("    wait: %s", line);
+        if (tb_lock_profiler_histogram_cstr(sample->hold_histogram, line, sizeof(line))) tb_trace_i("    hold: %s", line);
+
+        // dump the call sites
+        tb_size_t j = 0;
+        for (j = 0; j < TB_LOCK_PROFILER_CALLSITE_MAXN; j++)
+        {
+            tb_lock_profiler_callsite_t* callsite = &sample->callsites[j];
+            tb_check_continue(callsite->count && callsite->nframe);
+
+            tb_trace_i("    owner: sampled: %lu, hold: %lld us", callsite->count, callsite->hold);
+            tb_handle_t symbols = tb_backtrace_symbols_init(callsite->frames, callsite->nframe);
+            tb_size_t   k = 0;
+            for (k = 0; k < callsite->nframe; k++)
+            {
+                tb_char_t const* name = symbols? tb_backtrace_symbols_name(symbols, callsite->frames, callsite->nframe, k) : tb_null;
+                tb_trace_i("        [%p]: %s", callsite->frames[k], name? name : "");
+            }
+            if (symbols) tb_backtrace_symbols_exit(symbols);
+        }
+    }
+
+    // exit samples
+    tb_native_memory_free(samples);
+}
+#   ifdef TB_CONFIG_MODULE_HAVE_OBJECT
+static tb_object_ref_t tb_lock_profiler_histogram_object(tb_uint32_t const* histogram)
+{
+    // make the histogram array
+    tb_object_ref_t array = tb_oc_array_init(TB_LOCK_PROFILER_HISTOGRAM_MAXN, tb_false);
+    if (array)
+    {
+        tb_size_t i = 0;
+        for (i = 0; i < TB_LOCK_PROFILER_HISTOGRAM_MAXN; i++)
+            tb_oc_array_append(array, tb_oc_number_init_from_uint32(histogram[i]));
+    }
+    return array;
+}
+static tb_object_ref_t tb_lock_profiler_object(tb_lock_profiler_t* profiler)
+{
+    // merge samples
+    tb_size_t                   count = 0;
+    tb_lock_profiler_sample_t*  samples = tb_lock_profiler_merge(&count, tb_null);
+    tb_check_return_val(samples, tb_null);
+
+    /* make the lock array
+     *
+     * [{"lock": "0x...", "name": "...", "acquired": 100, "contended": 10, "wait": 20, "hold": 5, "sampled": 4
+     *  , "wait_histogram": [...], "hold_histogram": [...], "owners": [{"sampled": 1, "hold": 2, "frames": ["..."]}]}]
+     */
+    tb_size_t       i = 0;
+    tb_char_t       data[64];
+    tb_object_ref_t array = tb_oc_array_init(count? count : 16, tb_false);
+    for (i = 0; i < count && array; i++)
+    {
+        tb_object_ref_t dictionary = tb_oc_dictionary_init(TB_OC_DICTIONARY_SIZE_MICRO, tb_false);
+        tb_check_continue(dictionary);
+
+        // the lock and name
+        tb_lock_profiler_sample_t*          sample = &samples[i];
+        tb_pointer_t                        lock = (tb_pointer_t)tb_atomic_get(&sample->lock);
+        tb_char_t const*                    name = tb_lock_profiler_name(profiler, lock);
+        tb_snprintf(data, sizeof(data), "%p", lock);
+        tb_oc_dictionary_insert(dictionary, "lock", tb_oc_string_init_from_cstr(data));
+        if (name) tb_oc_dictionary_insert(dictionary, "name", tb_oc_string_init_from_cstr(name));
+
+        // the counters
+        tb_oc_dictionary_insert(dictionary, "acquired", tb_oc_number_init_from_uint64(sample->acquired));
+        tb_oc_dictionary_insert(dictionary, "contended", tb_oc_number_init_from_uint64(sample->contended));
+        tb_oc_dictionary_insert(dictionary, "sampled", tb_oc_number_init_from_uint64(sample->sampled));
+        tb_oc_dictionary_insert(dictionary, "wait", tb_oc_number_init_from_sint64(sample->wait));
+        tb_oc_dictionary_insert(dictionary, "hold", tb_oc_number_init_from_sint64(sample->hold));
+        tb_oc_dictionary_insert(dictionary, "wait_histogram", tb_lock_profiler_histogram_object(sample->wait_histogram));
+        tb_oc_dictionary_insert(dictionary, "hold_histogram", tb_lock_profiler_histogram_object(sample->hold_histogram));
+
+        // the owner call sites
+        tb_size_t       j = 0;
+        tb_object_ref_t owners = tb_oc_array_init(TB_LOCK_PROFILER_CALLSITE_MAXN, tb_false);
+        for (j = 0; j < TB_LOCK_PROFILER_CALLSITE_MAXN && owners; j++)
+        {
+            tb_lock_profiler_callsite_t* callsite = &sample->callsites[j];
+            tb_check_continue(callsite->count && callsite->nframe);
+
+            tb_object_ref_t owner = tb_oc_dictionary_init(TB_OC_DICTIONARY_SIZE_MICRO, tb_false);
+            tb_object_ref_t frames = tb_oc_array_init(TB_LOCK_PROFILER_CALLSITE_FRAMES, tb_false);
+            if (owner && frames)
+            {
+                tb_handle_t symbols = tb_backtrace_symbols_init(callsite->frames, callsite->nframe);
+                tb_size_t   k = 0;
+                for (k = 0; k < callsite->nframe; k++)
+                {
+                    tb_char_t const* frame = symbols? tb_backtrace_symbols_name(symbols, callsite->frames, callsite->nframe, k) : tb_null;
+                    if (!frame)
+                    {
+                        tb_snprintf(data, sizeof(data), "%p", callsite->frames[k]);
+                        frame = data;
+                    }
+                    tb_oc_array_append(frames, tb_oc_string_init_from_cstr(frame));
+                }
+                if (symbols) tb_backtrace_symbols_exit(symbols);
+
+                tb_oc_dictionary_insert(owner, "sampled", tb_oc_number_init_from_uint64(callsite->count));
+                tb_oc_dictionary_insert(owner, "hold", tb_oc_number_init_from_sint64(callsite->hold));
+                tb_oc_dictionary_insert(owner, "frames", frames);
+                tb_oc_array_append(owners, owner);
+            }
+            else
+            {
+                if (owner) tb_object_exit(owner);
+                if (frames) tb_object_exit(frames);
+            }
+        }
+        if (owners) tb_oc_dictionary_insert(dictionary, "owners", owners);
+
+        // append this lock
+        tb_oc_array_append(array, dictionary);
+    }
+
+    // exit samples
+    tb_native_memory_free(samples);
+    return array;
+}
+#   endif
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * instance implementation
  */
@@ -79,13 +647,39 @@ static tb_handle_t tb_lock_profiler_instance_init(tb_cpointer_t* ppriv)
 }
 static tb_void_t tb_lock_profiler_instance_exit(tb_handle_t handle, tb_cpointer_t priv)
 {
+    // it's also be used to register the lock names for the sampled profiler in the release mode, so we only dump it for the debug mode
+#ifdef TB_LOCK_PROFILER_ENABLE
     tb_lock_profiler_dump((tb_lock_profiler_ref_t)handle);
+#endif
+
+    // stop sampling, the lock names will be unavailable
+#ifdef TB_LOCK_PROFILER_SAMPLE_ENABLE
+    tb_lock_profiler_sample(0);
+#endif
     tb_lock_profiler_exit((tb_lock_profiler_ref_t)handle);
 }
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
+tb_void_t tb_lock_profiler_exit_env()
+{
+#ifdef TB_LOCK_PROFILER_SAMPLE_ENABLE
+    /* stop sampling and free all records
+     *
+     * @note all other threads have exited now
+     */
+    tb_atomic32_set(&g_lock_profiler_sample_rate, 0);
+    tb_lock_profiler_record_t* record = (tb_lock_profiler_record_t*)tb_atomic_fetch_and_set(&g_lock_profiler_records, 0);
+    while (record)
+    {
+        tb_lock_profiler_record_t* next = record->next;
+        tb_native_memory_free(record);
+        record = next;
+    }
+    g_lock_profiler_record = tb_null;
+#endif
+}
 tb_lock_profiler_ref_t tb_lock_profiler()
 {
     return (tb_lock_profiler_ref_t)tb_singleton_instance(TB_SINGLETON_TYPE_LOCK_PROFILER, tb_lock_profiler_instance_init, tb_lock_profiler_instance_exit, tb_null, tb_null);
@@ -123,6 +717,11 @@ tb_void_t tb_lock_profiler_dump(tb_lock_profiler_ref_t self)
             tb_trace_i("lock: %p, name: %s, occupied: %d", lock, (tb_char_t const*)tb_atomic_get(&item->name), tb_atomic32_get(&item->size));
         }
     }
+
+    // dump the sampled locks
+#ifdef TB_LOCK_PROFILER_SAMPLE_ENABLE
+    tb_lock_profiler_dump_samples(profiler);
+#endif
 }
 tb_void_t tb_lock_profiler_register(tb_lock_profiler_ref_t self, tb_pointer_t lock, tb_char_t const* name)
 {
@@ -200,3 +799,160 @@ tb_void_t tb_lock_profiler_occupied(tb_lock_profiler_ref_t self, tb_pointer_t lo
     }
 }
 
+#ifdef TB_LOCK_PROFILER_SAMPLE_ENABLE
+tb_void_t tb_lock_profiler_sample(tb_size_t rate)
+{
+    // init the thread local of records before sampling
+    if (rate && !tb_thread_local_init(&g_lock_profiler_local, tb_lock_profiler_record_free)) return;
+
+    // enter a new session, the held locks of the previous session will be discarded
+    if (rate) tb_atomic_fetch_and_add(&g_lock_profiler_session, 1);
+    tb_atomic32_set(&g_lock_profiler_sample_rate, (tb_int32_t)tb_min(rate, TB_MAXS32));
+}
+tb_void_t tb_lock_profiler_sample_clear()
+{
+    // clear all samples, the owners will clear their records lazily
+    tb_atomic_fetch_and_add(&g_lock_profiler_generation, 1);
+}
+tb_hong_t tb_lock_profiler_contended(tb_pointer_t lock)
+{
+    // get the start time of waiting, it cannot be zero
+    tb_hong_t time = tb_uclock();
+    return time > 0? time : 1;
+}
+tb_void_t tb_lock_profiler_acquired(tb_pointer_t lock, tb_hong_t wait)
+{
+    // check, we cannot sample the locks used by the profiler itself
+    tb_check_return(lock && !g_lock_profiler_busy);
+
+    // the sample rate, it has been stopped?
+    tb_size_t rate = (tb_size_t)tb_atomic32_get_explicit(&g_lock_profiler_sample_rate, TB_ATOMIC_RELAXED);
+    tb_check_return(rate);
+
+    // enter the profiler
+    g_lock_profiler_busy = tb_true;
+    do
+    {
+        // get the record of the current thread
+        tb_lock_profiler_record_t* record = tb_lock_profiler_record_self();
+        tb_check_break(record);
+
+        // sample one of every rate acquisitions, but we always record the wait time of all contended acquisitions
+        tb_bool_t sampled = tb_false;
+        if (!record->countdown)
+        {
+            record->countdown = rate;
+            sampled = tb_true;
+        }
+        record->countdown--;
+        tb_check_break(sampled || wait);
+
+        // get the sampled lock
+        tb_lock_profiler_sample_t* sample = tb_lock_profiler_sample_find(record->samples, TB_LOCK_PROFILER_SAMPLE_MAXN, lock);
+        if (!sample)
+        {
+            record->dropped++;
+            break;
+        }
+
+        // record the wait time
+        if (wait)
+        {
+            tb_hong_t now = tb_uclock();
+            tb_hong_t time = now > wait? now - wait : 0;
+            sample->contended++;
+            sample->wait += time;
+            sample->wait_histogram[tb_lock_profiler_bucket(time)]++;
+        }
+        tb_check_break(sampled);
+
+        // estimate the acquired count
+        sample->acquired += rate;
+
+        // hold this lock and record the call site of the owner, we skip tb_backtrace_frames and this function
+        if (record->held_count < TB_LOCK_PROFILER_HELD_MAXN)
+        {
+            tb_pointer_t                frames[TB_LOCK_PROFILER_CALLSITE_FRAMES];
+            tb_size_t                   nframe = tb_backtrace_frames(frames, tb_arrayn(frames), 2);
+            tb_lock_profiler_held_t*    held = &record->held[record->held_count++];
+            held->lock      = lock;
+            held->sample    = sample;
+            held->callsite  = nframe? tb_lock_profiler_callsite(sample, frames, nframe, 1) : tb_null;
+            held->time      = tb_uclock();
+        }
+
+    } while (0);
+
+    // leave the profiler
+    g_lock_profiler_busy = tb_false;
+}
+tb_void_t tb_lock_profiler_released(tb_pointer_t lock)
+{
+    // check
+    tb_check_return(lock && !g_lock_profiler_busy);
+
+    // no held locks?
+    tb_lock_profiler_record_t* record = g_lock_profiler_record;
+    tb_check_return(record && record->held_count);
+
+    // the held locks of the previous session are invalid
+    if (record->session != (tb_size_t)tb_atomic_get_explicit(&g_lock_profiler_session, TB_ATOMIC_RELAXED))
+    {
+        record->held_count = 0;
+        return ;
+    }
+
+    // find this lock, the last held lock is released first generally
+    tb_size_t i = record->held_count;
+    while (i && record->held[i - 1].lock != lock) i--;
+    tb_check_return(i);
+
+    // record the hold time
+    tb_lock_profiler_held_t*    held = &record->held[i - 1];
+    tb_hong_t                   now = tb_uclock();
+    tb_hong_t                   time = now > held->time? now - held->time : 0;
+    held->sample->sampled++;
+    held->sample->hold += time;
+    held->sample->hold_histogram[tb_lock_profiler_bucket(time)]++;
+    if (held->callsite) held->callsite->hold += time;
+
+    // remove it
+    for (; i < record->held_count; i++)
+        record->held[i - 1] = record->held[i];
+    record->held_count--;
+}
+#   ifdef TB_CONFIG_MODULE_HAVE_OBJECT
+tb_long_t tb_lock_profiler_writ_to_url(tb_lock_profiler_ref_t self, tb_char_t const* url, tb_size_t format)
+{
+    // check
+    tb_assert_and_check_return_val(url, -1);
+
+    // make object
+    tb_object_ref_t object = tb_lock_profiler_object((tb_lock_profiler_t*)self);
+    tb_check_return_val(object, -1);
+
+    // write it
+    tb_long_t size = tb_object_writ_to_url(object, url, format);
+
+    // exit object
+    tb_object_exit(object);
+    return size;
+}
+tb_long_t tb_lock_profiler_writ_to_data(tb_lock_profiler_ref_t self, tb_byte_t* data, tb_size_t size, tb_size_t format)
+{
+    // check
+    tb_assert_and_check_return_val(data && size, -1);
+
+    // make object
+    tb_object_ref_t object = tb_lock_profiler_object((tb_lock_profiler_t*)self);
+    tb_check_return_val(object, -1);
+
+    // write it
+    tb_long_t writ = tb_object_writ_to_data(object, data, size, format);
+
+    // exit object
+    tb_object_exit(object);
+    return writ;
+}
+#   endif
+#endif
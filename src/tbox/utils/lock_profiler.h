@@ -26,6 +26,7 @@
  * includes
  */
 #include "prefix.h"
+#include "../platform/atomic.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
@@ -42,6 +43,28 @@ __tb_extern_c_enter__
 #   define TB_LOCK_PROFILER_ENABLE
 #endif
 
+/* enable the sampled lock profiler
+ *
+ * it's compiled for the release mode too, but it does nothing until tb_lock_profiler_sample() is called,
+ * the lock only checks a global flag with a predictable branch if it's not sampling.
+ */
+#undef TB_LOCK_PROFILER_SAMPLE_ENABLE
+#if !defined(TB_CONFIG_MICRO_ENABLE) && defined(__tb_thread_local__)
+#   define TB_LOCK_PROFILER_SAMPLE_ENABLE
+#endif
+
+// enable to register the lock name for the lock profilers
+#undef TB_LOCK_PROFILER_REGISTER_ENABLE
+#if defined(TB_LOCK_PROFILER_ENABLE) || defined(TB_LOCK_PROFILER_SAMPLE_ENABLE)
+#   define TB_LOCK_PROFILER_REGISTER_ENABLE
+#endif
+
+/*! the log2 histogram bucket count of the wait and hold time
+ *
+ * bucket 0: [0, 1us), bucket 1: [1us, 2us), bucket 2: [2us, 4us), ..., the last bucket: [2^22us, +oo)
+ */
+#define TB_LOCK_PROFILER_HISTOGRAM_MAXN     (24)
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
@@ -49,6 +72,13 @@ __tb_extern_c_enter__
 /// the lock profiler ref type
 typedef __tb_typeref__(lock_profiler);
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the sample rate of the sampled lock profiler, it's disabled if it's zero
+extern tb_atomic32_t    g_lock_profiler_sample_rate;
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
@@ -94,6 +124,102 @@ tb_void_t               tb_lock_profiler_register(tb_lock_profiler_ref_t profile
  */
 tb_void_t               tb_lock_profiler_occupied(tb_lock_profiler_ref_t profiler, tb_pointer_t lock);
 
+#ifdef TB_LOCK_PROFILER_SAMPLE_ENABLE
+/*! start or stop the sampled lock profiler
+ *
+ * it will record the acquired count, the contended count, the histograms of the wait and hold time
+ * and the owner call sites of all spinlocks, mutexes, coroutine locks and allocator locks.
+ *
+ * all contended acquisitions will be recorded, but only one of the uncontended acquisitions per rate
+ * will be recorded, and the acquired count is estimated from them.
+ *
+ * @code
+ * tb_lock_profiler_sample(100);
+ * ...
+ * tb_lock_profiler_dump(tb_lock_profiler());
+ * tb_lock_profiler_sample(0);
+ * @endcode
+ *
+ * @param rate          the sample rate, e.g. 100: sample one of every 100 acquisitions, 0: stop it
+ */
+tb_void_t               tb_lock_profiler_sample(tb_size_t rate);
+
+/*! clear all sampled data
+ */
+tb_void_t               tb_lock_profiler_sample_clear(tb_noarg_t);
+
+/*! the lock has been contended, we will wait for it
+ *
+ * @note it's only called by the lock implementation when it's sampling
+ *
+ * @param lock          the lock address
+ *
+ * @return              the start time of waiting
+ */
+tb_hong_t               tb_lock_profiler_contended(tb_pointer_t lock);
+
+/*! the lock has been acquired
+ *
+ * @note it's only called by the lock implementation when it's sampling
+ *
+ * @param lock          the lock address
+ * @param wait          the start time of waiting returned by tb_lock_profiler_contended(), 0 if it's not contended
+ */
+tb_void_t               tb_lock_profiler_acquired(tb_pointer_t lock, tb_hong_t wait);
+
+/*! the lock will be released
+ *
+ * @note it's only called by the lock implementation when it's sampling
+ *
+ * @param lock          the lock address
+ */
+tb_void_t               tb_lock_profiler_released(tb_pointer_t lock);
+
+#   ifdef TB_CONFIG_MODULE_HAVE_OBJECT
+/*! write the merged sampled data to the given url
+ *
+ * @code
+ * tb_lock_profiler_writ_to_url(tb_lock_profiler(), "/tmp/locks.json", TB_OBJECT_FORMAT_JSON);
+ * @endcode
+ *
+ * @param profiler      the lock profiler, it's used to get the lock names
+ * @param url           the url
+ * @param format        the object format, e.g. TB_OBJECT_FORMAT_JSON, TB_OBJECT_FORMAT_XML, ...
+ *
+ * @return              the writed size, failed: -1
+ */
+tb_long_t               tb_lock_profiler_writ_to_url(tb_lock_profiler_ref_t profiler, tb_char_t const* url, tb_size_t format);
+
+/*! write the merged sampled data to the given data buffer
+ *
+ * @param profiler      the lock profiler, it's used to get the lock names
+ * @param data          the data buffer
+ * @param size          the buffer size
+ * @param format        the object format, e.g. TB_OBJECT_FORMAT_JSON, TB_OBJECT_FORMAT_XML, ...
+ *
+ * @return              the writed size, failed: -1
+ */
+tb_long_t               tb_lock_profiler_writ_to_data(tb_lock_profiler_ref_t profiler, tb_byte_t* data, tb_size_t size, tb_size_t format);
+#   endif
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * inline implementation
+ */
+
+/*! is sampling now?
+ *
+ * @return              tb_true or tb_false
+ */
+static __tb_inline_force__ tb_bool_t tb_lock_profiler_sampling()
+{
+#ifdef TB_LOCK_PROFILER_SAMPLE_ENABLE
+    return __tb_unlikely__(tb_atomic32_get_explicit(&g_lock_profiler_sample_rate, TB_ATOMIC_RELAXED) != 0);
+#else
+    return tb_false;
+#endif
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
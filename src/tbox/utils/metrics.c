@@ -0,0 +1,710 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        metrics.c
+ * @ingroup     utils
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME                "metrics"
+#define TB_TRACE_MODULE_DEBUG               (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "metrics.h"
+#include "bits.h"
+#include "../libc/libc.h"
+#include "../platform/platform.h"
+#ifdef TB_CONFIG_MODULE_HAVE_OBJECT
+#   include "../object/object.h"
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the metrics maxn, the first metric is unused because the metric ref cannot be zero
+#ifdef __tb_small__
+#   define TB_METRICS_MAXN                  (64)
+#else
+#   define TB_METRICS_MAXN                  (128)
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the metric item type
+typedef struct __tb_metrics_item_t
+{
+    // the type
+    tb_size_t                       type;
+
+    // the name
+    tb_char_t                       name[TB_METRICS_NAME_MAXN];
+
+}tb_metrics_item_t;
+
+#ifdef TB_METRICS_ENABLE
+// the histogram shard type
+typedef struct __tb_metrics_histogram_t
+{
+    // the recorded count
+    tb_atomic64_t                   count;
+
+    // the sum of all recorded values
+    tb_atomic64_t                   sum;
+
+    // the minimum and maximum values
+    tb_atomic64_t                   min;
+    tb_atomic64_t                   max;
+
+    // the buckets, they are only written by the owner thread
+    tb_uint32_t                     buckets[TB_METRICS_HISTOGRAM_MAXN];
+
+}tb_metrics_histogram_t;
+
+/* the metrics record type of each thread
+ *
+ * all values are only written by the owner thread with the relaxed load and store (no lock prefix),
+ * and the readers will sum them up, so the read value may be a little stale.
+ *
+ * the records are never freed before exiting tbox, the record of the exited thread will be reused
+ * and the values will be inherited by the next owner.
+ */
+typedef struct __tb_metrics_record_t
+{
+    // the next record
+    struct __tb_metrics_record_t*   next;
+
+    // is owned by a thread?
+    tb_atomic_t                     owned;
+
+    // the values of the counters and gauges
+    tb_atomic64_t                   values[TB_METRICS_MAXN];
+
+    // the histogram shards, they will be allocated when recording the first value
+    tb_atomic_t                     histograms[TB_METRICS_MAXN];
+
+}tb_metrics_record_t;
+#endif
+
+// the merged histogram type
+typedef struct __tb_metrics_snapshot_t
+{
+    // the recorded count
+    tb_hize_t                       count;
+
+    // the sum of all recorded values
+    tb_hize_t                       sum;
+
+    // the minimum and maximum values
+    tb_hize_t                       min;
+    tb_hize_t                       max;
+
+    // the buckets
+    tb_hize_t                       buckets[TB_METRICS_HISTOGRAM_MAXN];
+
+}tb_metrics_snapshot_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the registered metrics, the builtin metrics are registered at the fixed indices
+static tb_metrics_item_t                            g_metrics_items[TB_METRICS_MAXN] =
+{
+    {TB_METRIC_TYPE_NONE,       ""                          }
+,   {TB_METRIC_TYPE_GAUGE,      "thread_pool.queue_depth"   }
+,   {TB_METRIC_TYPE_HISTOGRAM,  "thread_pool.task_latency"  }
+,   {TB_METRIC_TYPE_HISTOGRAM,  "poller.events_per_wait"    }
+,   {TB_METRIC_TYPE_HISTOGRAM,  "allocator.malloc_size"     }
+,   {TB_METRIC_TYPE_COUNTER,    "stream.read_bytes"         }
+,   {TB_METRIC_TYPE_COUNTER,    "stream.writ_bytes"         }
+,   {TB_METRIC_TYPE_HISTOGRAM,  "stream.open_latency"       }
+,   {TB_METRIC_TYPE_COUNTER,    "coroutine.switches"        }
+,   {TB_METRIC_TYPE_GAUGE,      "coroutine.ready"           }
+};
+
+// the registered metric count
+static tb_atomic_t                                  g_metrics_size = TB_METRICS_BUILTIN_MAXN;
+
+// the registry lock
+static tb_spinlock_t                                g_metrics_lock = TB_SPINLOCK_INIT;
+
+#ifdef TB_METRICS_ENABLE
+// the base values of the gauges, they are only changed by tb_metrics_set()
+static tb_atomic64_t                                g_metrics_bases[TB_METRICS_MAXN];
+
+// the global record list
+static tb_atomic_t                                  g_metrics_records = 0;
+
+// the thread local record, it will be released after the thread exited
+static tb_thread_local_t                            g_metrics_local = TB_THREAD_LOCAL_INIT;
+
+// the cached thread local record for the fast path
+static __tb_thread_local__ tb_metrics_record_t*     g_metrics_record = tb_null;
+
+// have been exited? we cannot make new records after exiting the platform environment
+static tb_bool_t                                    g_metrics_exited = tb_false;
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * declaration
+ */
+__tb_extern_c_enter__
+tb_void_t tb_metrics_init_env(tb_noarg_t);
+tb_void_t tb_metrics_exit_env(tb_noarg_t);
+__tb_extern_c_leave__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static __tb_inline__ tb_metrics_item_t* tb_metrics_item(tb_metric_ref_t metric)
+{
+    tb_size_t id = (tb_size_t)metric;
+    return (id && id < (tb_size_t)tb_atomic_get(&g_metrics_size))? &g_metrics_items[id] : tb_null;
+}
+static tb_metric_ref_t tb_metrics_register(tb_char_t const* name, tb_size_t type)
+{
+    // check
+    tb_assert_and_check_return_val(name && *name, tb_null);
+
+    // enter
+    tb_spinlock_enter(&g_metrics_lock);
+
+    // find or register it
+    tb_size_t id = 0;
+    tb_size_t i = 1;
+    tb_size_t n = (tb_size_t)tb_atomic_get(&g_metrics_size);
+    for (i = 1; i < n; i++)
+    {
+        if (!tb_strcmp(g_metrics_items[i].name, name))
+        {
+            if (g_metrics_items[i].type == type) id = i;
+            break;
+        }
+    }
+    if (i == n && n < TB_METRICS_MAXN)
+    {
+        g_metrics_items[n].type = type;
+        tb_strlcpy(g_metrics_items[n].name, name, sizeof(g_metrics_items[n].name));
+        tb_atomic_set(&g_metrics_size, n + 1);
+        id = n;
+    }
+
+    // leave
+    tb_spinlock_leave(&g_metrics_lock);
+
+    // trace
+    tb_assertf(id, "register metric(%s) failed, the type is mismatched or too many metrics!", name);
+    return (tb_metric_ref_t)id;
+}
+static __tb_inline__ tb_size_t tb_metrics_bucket(tb_hize_t value)
+{
+    // [0, 16) => [0, 16), [2^e, 2^(e + 1)) => (e - 3) * 16 + the sub-bucket
+    if (value < 16) return (tb_size_t)value;
+    tb_size_t e = 63 - tb_bits_cl0_u64_be(value);
+    return ((e - 3) << 4) + (tb_size_t)((value >> (e - 4)) & 15);
+}
+static __tb_inline__ tb_hize_t tb_metrics_bucket_upper(tb_size_t index)
+{
+    if (index < 16) return index;
+    tb_size_t e = (index >> 4) + 3;
+    return (((tb_hize_t)(16 + (index & 15)) << (e - 4)) - 1) + ((tb_hize_t)1 << (e - 4));
+}
+#ifdef TB_METRICS_ENABLE
+static tb_void_t tb_metrics_record_free(tb_cpointer_t priv)
+{
+    // the record
+    tb_metrics_record_t* record = (tb_metrics_record_t*)priv;
+    tb_assert_and_check_return(record);
+
+    // release this record, the values will be inherited by the next owner
+    g_metrics_record = tb_null;
+    tb_atomic_set_explicit(&record->owned, 0, TB_ATOMIC_RELEASE);
+}
+static tb_metrics_record_t* tb_metrics_record_init()
+{
+    // have been exited?
+    tb_check_return_val(!g_metrics_exited, tb_null);
+
+    // init the thread local
+    if (!tb_thread_local_init(&g_metrics_local, tb_metrics_record_free)) return tb_null;
+
+    // reuse the released record first
+    tb_metrics_record_t* record = (tb_metrics_record_t*)tb_atomic_get(&g_metrics_records);
+    for (; record; record = record->next)
+    {
+        tb_long_t owned = 0;
+        if (!tb_atomic_get_explicit(&record->owned, TB_ATOMIC_RELAXED) && tb_atomic_compare_and_swap(&record->owned, &owned, 1))
+            break;
+    }
+
+    // make a new record and insert it to the head of the record list
+    if (!record)
+    {
+        record = (tb_metrics_record_t*)tb_native_memory_malloc0(sizeof(tb_metrics_record_t));
+        tb_check_return_val(record, tb_null);
+
+        record->owned = 1;
+        tb_long_t head = tb_atomic_get(&g_metrics_records);
+        do
+        {
+            record->next = (tb_metrics_record_t*)head;
+
+        } while (!tb_atomic_compare_and_swap(&g_metrics_records, &head, (tb_long_t)record));
+    }
+
+    // save it to the current thread
+    if (!tb_thread_local_set(&g_metrics_local, record))
+    {
+        tb_atomic_set(&record->owned, 0);
+        return tb_null;
+    }
+    g_metrics_record = record;
+    return record;
+}
+static __tb_inline__ tb_metrics_record_t* tb_metrics_record_self()
+{
+    tb_metrics_record_t* record = g_metrics_record;
+    return __tb_likely__(record != tb_null)? record : tb_metrics_record_init();
+}
+static tb_metrics_histogram_t* tb_metrics_histogram_init(tb_metrics_record_t* record, tb_size_t id)
+{
+    // make a new histogram shard
+    tb_metrics_histogram_t* histogram = (tb_metrics_histogram_t*)tb_native_memory_malloc0(sizeof(tb_metrics_histogram_t));
+    tb_check_return_val(histogram, tb_null);
+
+    // init the minimum value
+    tb_atomic64_set_explicit(&histogram->min, -1, TB_ATOMIC_RELAXED);
+
+    // publish it to the readers
+    tb_atomic_set_explicit(&record->histograms[id], (tb_long_t)histogram, TB_ATOMIC_RELEASE);
+    return histogram;
+}
+static tb_hong_t tb_metrics_shards_value(tb_size_t id)
+{
+    tb_hong_t               value = 0;
+    tb_metrics_record_t*    record = (tb_metrics_record_t*)tb_atomic_get(&g_metrics_records);
+    for (; record; record = record->next)
+        value += tb_atomic64_get_explicit(&record->values[id], TB_ATOMIC_RELAXED);
+    return value;
+}
+#endif
+static tb_bool_t tb_metrics_snapshot(tb_size_t id, tb_metrics_snapshot_t* snapshot)
+{
+    // check
+    tb_assert_and_check_return_val(snapshot, tb_false);
+
+    // init snapshot
+    tb_memset(snapshot, 0, sizeof(tb_metrics_snapshot_t));
+    snapshot->min = (tb_hize_t)-1;
+
+#ifdef TB_METRICS_ENABLE
+    // merge all histogram shards
+    tb_metrics_record_t* record = (tb_metrics_record_t*)tb_atomic_get(&g_metrics_records);
+    for (; record; record = record->next)
+    {
+        tb_metrics_histogram_t* histogram = (tb_metrics_histogram_t*)tb_atomic_get_explicit(&record->histograms[id], TB_ATOMIC_ACQUIRE);
+        tb_check_continue(histogram);
+
+        tb_size_t i = 0;
+        tb_hize_t min = (tb_hize_t)tb_atomic64_get_explicit(&histogram->min, TB_ATOMIC_RELAXED);
+        tb_hize_t max = (tb_hize_t)tb_atomic64_get_explicit(&histogram->max, TB_ATOMIC_RELAXED);
+        snapshot->count += (tb_hize_t)tb_atomic64_get_explicit(&histogram->count, TB_ATOMIC_RELAXED);
+        snapshot->sum   += (tb_hize_t)tb_atomic64_get_explicit(&histogram->sum, TB_ATOMIC_RELAXED);
+        if (min < snapshot->min) snapshot->min = min;
+        if (max > snapshot->max) snapshot->max = max;
+        for (i = 0; i < TB_METRICS_HISTOGRAM_MAXN; i++)
+            snapshot->buckets[i] += histogram->buckets[i];
+    }
+#endif
+
+    // no values?
+    if (!snapshot->count) snapshot->min = 0;
+    return tb_true;
+}
+static tb_hize_t tb_metrics_snapshot_percentile(tb_metrics_snapshot_t const* snapshot, tb_size_t percent)
+{
+    // check
+    tb_assert_and_check_return_val(snapshot && percent <= 10000, 0);
+    tb_check_return_val(snapshot->count, 0);
+
+    // the rank of the percentile
+    tb_hize_t rank = (snapshot->count * percent + 9999) / 10000;
+    if (!rank) rank = 1;
+
+    // find the bucket of this rank
+    tb_size_t i = 0;
+    tb_hize_t total = 0;
+    for (i = 0; i < TB_METRICS_HISTOGRAM_MAXN; i++)
+    {
+        total += snapshot->buckets[i];
+        if (total >= rank) break;
+    }
+
+    // the buckets may be updated when merging them, so we need clamp it
+    tb_hize_t value = i < TB_METRICS_HISTOGRAM_MAXN? tb_metrics_bucket_upper(i) : snapshot->max;
+    if (value > snapshot->max) value = snapshot->max;
+    if (value < snapshot->min) value = snapshot->min;
+    return value;
+}
+static tb_void_t tb_metrics_snapshot_summary(tb_metrics_snapshot_t const* snapshot, tb_metrics_summary_ref_t summary)
+{
+    summary->count  = snapshot->count;
+    summary->sum    = snapshot->sum;
+    summary->min    = snapshot->min;
+    summary->max    = snapshot->max;
+    summary->p50    = tb_metrics_snapshot_percentile(snapshot, 5000);
+    summary->p90    = tb_metrics_snapshot_percentile(snapshot, 9000);
+    summary->p99    = tb_metrics_snapshot_percentile(snapshot, 9900);
+    summary->p999   = tb_metrics_snapshot_percentile(snapshot, 9990);
+}
+#ifdef TB_CONFIG_MODULE_HAVE_OBJECT
+static tb_object_ref_t tb_metrics_object()
+{
+    // make the snapshot
+    tb_metrics_snapshot_t* snapshot = (tb_metrics_snapshot_t*)tb_native_memory_malloc(sizeof(tb_metrics_snapshot_t));
+    tb_assert_and_check_return_val(snapshot, tb_null);
+
+    /* make object
+     *
+     * {"stream.read_bytes": 1024, "stream.open_latency": {"count": 2, "sum": 100, "min": 40, "max": 60, "p50": 40, ...}, ...}
+     */
+    tb_size_t       i = 1;
+    tb_size_t       n = (tb_size_t)tb_atomic_get(&g_metrics_size);
+    tb_object_ref_t dictionary = tb_oc_dictionary_init(TB_OC_DICTIONARY_SIZE_MICRO, tb_false);
+    for (i = 1; i < n && dictionary; i++)
+    {
+        tb_metrics_item_t const* item = &g_metrics_items[i];
+        if (item->type == TB_METRIC_TYPE_HISTOGRAM)
+        {
+            tb_object_ref_t object = tb_oc_dictionary_init(TB_OC_DICTIONARY_SIZE_MICRO, tb_false);
+            if (object && tb_metrics_snapshot(i, snapshot))
+            {
+                tb_metrics_summary_t summary;
+                tb_metrics_snapshot_summary(snapshot, &summary);
+                tb_oc_dictionary_insert(object, "count", tb_oc_number_init_from_uint64(summary.count));
+                tb_oc_dictionary_insert(object, "sum", tb_oc_number_init_from_uint64(summary.sum));
+                tb_oc_dictionary_insert(object, "min", tb_oc_number_init_from_uint64(summary.min));
+                tb_oc_dictionary_insert(object, "max", tb_oc_number_init_from_uint64(summary.max));
+                tb_oc_dictionary_insert(object, "p50", tb_oc_number_init_from_uint64(summary.p50));
+                tb_oc_dictionary_insert(object, "p90", tb_oc_number_init_from_uint64(summary.p90));
+                tb_oc_dictionary_insert(object, "p99", tb_oc_number_init_from_uint64(summary.p99));
+                tb_oc_dictionary_insert(object, "p999", tb_oc_number_init_from_uint64(summary.p999));
+                tb_oc_dictionary_insert(dictionary, item->name, object);
+            }
+            else if (object) tb_object_exit(object);
+        }
+        else tb_oc_dictionary_insert(dictionary, item->name, tb_oc_number_init_from_sint64(tb_metrics_value((tb_metric_ref_t)i)));
+    }
+
+    // exit snapshot
+    tb_native_memory_free(snapshot);
+    return dictionary;
+}
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_void_t tb_metrics_init_env()
+{
+#ifdef TB_METRICS_ENABLE
+    g_metrics_exited = tb_false;
+#endif
+}
+tb_void_t tb_metrics_exit_env()
+{
+#ifdef TB_METRICS_ENABLE
+    /* free all records and stop making new records
+     *
+     * @note all other threads have exited now
+     */
+    g_metrics_exited = tb_true;
+    tb_metrics_record_t* record = (tb_metrics_record_t*)tb_atomic_fetch_and_set(&g_metrics_records, 0);
+    while (record)
+    {
+        tb_size_t i = 0;
+        for (i = 0; i < TB_METRICS_MAXN; i++)
+        {
+            tb_pointer_t histogram = (tb_pointer_t)tb_atomic_get(&record->histograms[i]);
+            if (histogram) tb_native_memory_free(histogram);
+        }
+        tb_metrics_record_t* next = record->next;
+        tb_native_memory_free(record);
+        record = next;
+    }
+    g_metrics_record = tb_null;
+
+    // clear the gauges
+    tb_size_t i = 0;
+    for (i = 0; i < TB_METRICS_MAXN; i++)
+        tb_atomic64_set(&g_metrics_bases[i], 0);
+#endif
+}
+tb_metric_ref_t tb_metrics_counter(tb_char_t const* name)
+{
+    return tb_metrics_register(name, TB_METRIC_TYPE_COUNTER);
+}
+tb_metric_ref_t tb_metrics_gauge(tb_char_t const* name)
+{
+    return tb_metrics_register(name, TB_METRIC_TYPE_GAUGE);
+}
+tb_metric_ref_t tb_metrics_histogram(tb_char_t const* name)
+{
+    return tb_metrics_register(name, TB_METRIC_TYPE_HISTOGRAM);
+}
+tb_char_t const* tb_metrics_name(tb_metric_ref_t metric)
+{
+    tb_metrics_item_t* item = tb_metrics_item(metric);
+    return item? item->name : tb_null;
+}
+tb_size_t tb_metrics_type(tb_metric_ref_t metric)
+{
+    tb_metrics_item_t* item = tb_metrics_item(metric);
+    return item? item->type : TB_METRIC_TYPE_NONE;
+}
+tb_void_t tb_metrics_add(tb_metric_ref_t metric, tb_long_t value)
+{
+#ifdef TB_METRICS_ENABLE
+    // check
+    tb_size_t id = (tb_size_t)metric;
+    tb_assert_and_check_return(id && id < TB_METRICS_MAXN);
+    tb_assert(tb_metrics_type(metric) == TB_METRIC_TYPE_COUNTER || tb_metrics_type(metric) == TB_METRIC_TYPE_GAUGE);
+
+    // get the record of the current thread
+    tb_metrics_record_t* record = tb_metrics_record_self();
+    tb_check_return(record);
+
+    // update it, only the current thread will write it
+    tb_atomic64_t* pvalue = &record->values[id];
+    tb_atomic64_set_explicit(pvalue, tb_atomic64_get_explicit(pvalue, TB_ATOMIC_RELAXED) + value, TB_ATOMIC_RELAXED);
+#else
+    tb_used(metric);
+    tb_used(value);
+#endif
+}
+tb_void_t tb_metrics_set(tb_metric_ref_t metric, tb_hong_t value)
+{
+#ifdef TB_METRICS_ENABLE
+    // check
+    tb_size_t id = (tb_size_t)metric;
+    tb_assert_and_check_return(id && id < TB_METRICS_MAXN);
+    tb_assert(tb_metrics_type(metric) == TB_METRIC_TYPE_GAUGE);
+
+    // gauge = base + the sum of all shards
+    tb_atomic64_set(&g_metrics_bases[id], value - tb_metrics_shards_value(id));
+#else
+    tb_used(metric);
+    tb_used(value);
+#endif
+}
+tb_void_t tb_metrics_record(tb_metric_ref_t metric, tb_hize_t value)
+{
+#ifdef TB_METRICS_ENABLE
+    // check
+    tb_size_t id = (tb_size_t)metric;
+    tb_assert_and_check_return(id && id < TB_METRICS_MAXN);
+    tb_assert(tb_metrics_type(metric) == TB_METRIC_TYPE_HISTOGRAM);
+
+    // get the record of the current thread
+    tb_metrics_record_t* record = tb_metrics_record_self();
+    tb_check_return(record);
+
+    // get the histogram shard of the current thread
+    tb_metrics_histogram_t* histogram = (tb_metrics_histogram_t*)tb_atomic_get_explicit(&record->histograms[id], TB_ATOMIC_RELAXED);
+    if (__tb_unlikely__(!histogram))
+    {
+        histogram = tb_metrics_histogram_init(record, id);
+        tb_check_return(histogram);
+    }
+
+    // record it, only the current thread will write it
+    histogram->buckets[tb_metrics_bucket(value)]++;
+    tb_atomic64_set_explicit(&histogram->count, tb_atomic64_get_explicit(&histogram->count, TB_ATOMIC_RELAXED) + 1, TB_ATOMIC_RELAXED);
+    tb_atomic64_set_explicit(&histogram->sum, tb_atomic64_get_explicit(&histogram->sum, TB_ATOMIC_RELAXED) + value, TB_ATOMIC_RELAXED);
+    if (value < (tb_hize_t)tb_atomic64_get_explicit(&histogram->min, TB_ATOMIC_RELAXED))
+        tb_atomic64_set_explicit(&histogram->min, (tb_hong_t)value, TB_ATOMIC_RELAXED);
+    if (value > (tb_hize_t)tb_atomic64_get_explicit(&histogram->max, TB_ATOMIC_RELAXED))
+        tb_atomic64_set_explicit(&histogram->max, (tb_hong_t)value, TB_ATOMIC_RELAXED);
+#else
+    tb_used(metric);
+    tb_used(value);
+#endif
+}
+tb_hong_t tb_metrics_value(tb_metric_ref_t metric)
+{
+    // check
+    tb_size_t id = (tb_size_t)metric;
+    tb_metrics_item_t* item = tb_metrics_item(metric);
+    tb_assert_and_check_return_val(item, 0);
+
+#ifdef TB_METRICS_ENABLE
+    // the histogram? get the recorded count
+    if (item->type == TB_METRIC_TYPE_HISTOGRAM)
+    {
+        tb_hong_t               count = 0;
+        tb_metrics_record_t*    record = (tb_metrics_record_t*)tb_atomic_get(&g_metrics_records);
+        for (; record; record = record->next)
+        {
+            tb_metrics_histogram_t* histogram = (tb_metrics_histogram_t*)tb_atomic_get_explicit(&record->histograms[id], TB_ATOMIC_ACQUIRE);
+            if (histogram) count += tb_atomic64_get_explicit(&histogram->count, TB_ATOMIC_RELAXED);
+        }
+        return count;
+    }
+
+    // sum up all shards
+    return tb_atomic64_get(&g_metrics_bases[id]) + tb_metrics_shards_value(id);
+#else
+    tb_used(id);
+    return 0;
+#endif
+}
+tb_hize_t tb_metrics_percentile(tb_metric_ref_t metric, tb_size_t percent)
+{
+    // check
+    tb_assert_and_check_return_val(tb_metrics_type(metric) == TB_METRIC_TYPE_HISTOGRAM && percent <= 10000, 0);
+
+    // make the snapshot
+    tb_metrics_snapshot_t* snapshot = (tb_metrics_snapshot_t*)tb_native_memory_malloc(sizeof(tb_metrics_snapshot_t));
+    tb_assert_and_check_return_val(snapshot, 0);
+
+    // get the percentile
+    tb_hize_t value = tb_metrics_snapshot((tb_size_t)metric, snapshot)? tb_metrics_snapshot_percentile(snapshot, percent) : 0;
+
+    // exit snapshot
+    tb_native_memory_free(snapshot);
+    return value;
+}
+tb_bool_t tb_metrics_summary(tb_metric_ref_t metric, tb_metrics_summary_ref_t summary)
+{
+    // check
+    tb_assert_and_check_return_val(tb_metrics_type(metric) == TB_METRIC_TYPE_HISTOGRAM && summary, tb_false);
+
+    // make the snapshot
+    tb_metrics_snapshot_t* snapshot = (tb_metrics_snapshot_t*)tb_native_memory_malloc(sizeof(tb_metrics_snapshot_t));
+    tb_assert_and_check_return_val(snapshot, tb_false);
+
+    // get the summary
+    tb_bool_t ok = tb_metrics_snapshot((tb_size_t)metric, snapshot);
+    if (ok) tb_metrics_snapshot_summary(snapshot, summary);
+
+    // exit snapshot
+    tb_native_memory_free(snapshot);
+    return ok;
+}
+tb_void_t tb_metrics_clear()
+{
+#ifdef TB_METRICS_ENABLE
+    // clear the counters and histograms, the gauges are kept because they are the current states
+    tb_size_t               i = 1;
+    tb_size_t               n = (tb_size_t)tb_atomic_get(&g_metrics_size);
+    tb_metrics_record_t*    record = (tb_metrics_record_t*)tb_atomic_get(&g_metrics_records);
+    for (; record; record = record->next)
+    {
+        for (i = 1; i < n; i++)
+        {
+            tb_size_t type = g_metrics_items[i].type;
+            if (type == TB_METRIC_TYPE_COUNTER)
+                tb_atomic64_set_explicit(&record->values[i], 0, TB_ATOMIC_RELAXED);
+            else if (type == TB_METRIC_TYPE_HISTOGRAM)
+            {
+                tb_metrics_histogram_t* histogram = (tb_metrics_histogram_t*)tb_atomic_get_explicit(&record->histograms[i], TB_ATOMIC_ACQUIRE);
+                if (histogram)
+                {
+                    tb_memset(histogram->buckets, 0, sizeof(histogram->buckets));
+                    tb_atomic64_set_explicit(&histogram->count, 0, TB_ATOMIC_RELAXED);
+                    tb_atomic64_set_explicit(&histogram->sum, 0, TB_ATOMIC_RELAXED);
+                    tb_atomic64_set_explicit(&histogram->min, -1, TB_ATOMIC_RELAXED);
+                    tb_atomic64_set_explicit(&histogram->max, 0, TB_ATOMIC_RELAXED);
+                }
+            }
+        }
+    }
+#endif
+}
+tb_void_t tb_metrics_dump()
+{
+    // make the snapshot
+    tb_metrics_snapshot_t* snapshot = (tb_metrics_snapshot_t*)tb_native_memory_malloc(sizeof(tb_metrics_snapshot_t));
+    tb_assert_and_check_return(snapshot);
+
+    // trace
+    tb_trace_i("");
+
+    // dump all metrics
+    tb_size_t i = 1;
+    tb_size_t n = (tb_size_t)tb_atomic_get(&g_metrics_size);
+    for (i = 1; i < n; i++)
+    {
+        tb_metrics_item_t const* item = &g_metrics_items[i];
+        if (item->type == TB_METRIC_TYPE_HISTOGRAM)
+        {
+            tb_metrics_summary_t summary;
+            if (tb_metrics_snapshot(i, snapshot))
+            {
+                tb_metrics_snapshot_summary(snapshot, &summary);
+                tb_trace_i("%-28s: count: %llu, sum: %llu, min: %llu, max: %llu, p50: %llu, p90: %llu, p99: %llu, p99.9: %llu"
+                           , item->name, summary.count, summary.sum, summary.min, summary.max, summary.p50, summary.p90, summary.p99, summary.p999);
+            }
+        }
+        else tb_trace_i("%-28s: %lld", item->name, tb_metrics_value((tb_metric_ref_t)i));
+    }
+
+    // exit snapshot
+    tb_native_memory_free(snapshot);
+}
+#ifdef TB_CONFIG_MODULE_HAVE_OBJECT
+tb_long_t tb_metrics_writ_to_url(tb_char_t const* url, tb_size_t format)
+{
+    // check
+    tb_assert_and_check_return_val(url, -1);
+
+    // make object
+    tb_object_ref_t object = tb_metrics_object();
+    tb_check_return_val(object, -1);
+
+    // write it
+    tb_long_t size = tb_object_writ_to_url(object, url, format);
+
+    // exit object
+    tb_object_exit(object);
+    return size;
+}
+tb_long_t tb_metrics_writ_to_data(tb_byte_t* data, tb_size_t size, tb_size_t format)
+{
+    // check
+    tb_assert_and_check_return_val(data && size, -1);
+
+    // make object
+    tb_object_ref_t object = tb_metrics_object();
+    tb_check_return_val(object, -1);
+
+    // write it
+    tb_long_t writ = tb_object_writ_to_data(object, data, size, format);
+
+    // exit object
+    tb_object_exit(object);
+    return writ;
+}
+#endif
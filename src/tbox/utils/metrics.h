@@ -0,0 +1,261 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        metrics.h
+ * @ingroup     utils
+ *
+ */
+#ifndef TB_UTILS_METRICS_H
+#define TB_UTILS_METRICS_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+/* enable the metrics
+ *
+ * all updates are written to the shard of the current thread without any atomic read-modify-write operation,
+ * so we need the native thread local storage.
+ */
+#undef TB_METRICS_ENABLE
+#if !defined(TB_CONFIG_MICRO_ENABLE) && defined(__tb_thread_local__)
+#   define TB_METRICS_ENABLE
+#endif
+
+/// the metric name maxn
+#define TB_METRICS_NAME_MAXN                    (64)
+
+/*! the bucket count of the hdr histogram
+ *
+ * values in [0, 16) have their own buckets, and each power of two range [2^e, 2^(e + 1)) is split to 16 linear sub-buckets,
+ * so the relative error of all recorded values is less than 1/16.
+ */
+#define TB_METRICS_HISTOGRAM_MAXN               (976)
+
+/// get the builtin metric
+#define tb_metrics_builtin(id)                  ((tb_metric_ref_t)(tb_size_t)(id))
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the metric ref type
+typedef __tb_typeref__(metric);
+
+/// the metric type enum
+typedef enum __tb_metric_type_e
+{
+    TB_METRIC_TYPE_NONE                         = 0
+,   TB_METRIC_TYPE_COUNTER                      = 1 //!< the monotonic counter
+,   TB_METRIC_TYPE_GAUGE                        = 2 //!< the gauge, it can be increased and decreased
+,   TB_METRIC_TYPE_HISTOGRAM                    = 3 //!< the hdr histogram
+
+}tb_metric_type_e;
+
+/// the builtin metric enum, we can get it by tb_metrics_builtin(id)
+typedef enum __tb_metrics_builtin_e
+{
+    TB_METRICS_BUILTIN_THREAD_POOL_QUEUE_DEPTH  = 1 //!< the gauge of the waiting jobs in all thread pools
+,   TB_METRICS_BUILTIN_THREAD_POOL_TASK_LATENCY = 2 //!< the histogram of the time (us) from posting a task to finishing it
+,   TB_METRICS_BUILTIN_POLLER_EVENTS_PER_WAIT   = 3 //!< the histogram of the event count returned by each poller wait
+,   TB_METRICS_BUILTIN_ALLOCATOR_MALLOC_SIZE    = 4 //!< the histogram of the allocated size, the buckets are the size classes and the sum is the total bytes
+,   TB_METRICS_BUILTIN_STREAM_READ_BYTES        = 5 //!< the counter of the read bytes of all streams
+,   TB_METRICS_BUILTIN_STREAM_WRIT_BYTES        = 6 //!< the counter of the written bytes of all streams
+,   TB_METRICS_BUILTIN_STREAM_OPEN_LATENCY      = 7 //!< the histogram of the open time (us) of all streams
+,   TB_METRICS_BUILTIN_COROUTINE_SWITCHES       = 8 //!< the counter of the coroutine switches
+,   TB_METRICS_BUILTIN_COROUTINE_READY          = 9 //!< the gauge of the ready coroutines in all schedulers
+,   TB_METRICS_BUILTIN_MAXN                     = 10
+
+}tb_metrics_builtin_e;
+
+/// the histogram summary type
+typedef struct __tb_metrics_summary_t
+{
+    /// the recorded count
+    tb_hize_t               count;
+
+    /// the sum of all recorded values
+    tb_hize_t               sum;
+
+    /// the minimum value
+    tb_hize_t               min;
+
+    /// the maximum value
+    tb_hize_t               max;
+
+    /// the percentiles: p50, p90, p99 and p99.9
+    tb_hize_t               p50;
+    tb_hize_t               p90;
+    tb_hize_t               p99;
+    tb_hize_t               p999;
+
+}tb_metrics_summary_t, *tb_metrics_summary_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! get or register the counter with the given name
+ *
+ * the metrics are never unregistered, so we should cache the returned metric.
+ *
+ * @code
+ * static tb_metric_ref_t s_requests = tb_null;
+ * if (!s_requests) s_requests = tb_metrics_counter("http.requests");
+ * tb_metrics_add(s_requests, 1);
+ * @endcode
+ *
+ * @param name          the metric name, e.g. "http.requests"
+ *
+ * @return              the metric, tb_null if the name has been registered with another type or the registry is full
+ */
+tb_metric_ref_t         tb_metrics_counter(tb_char_t const* name);
+
+/*! get or register the gauge with the given name
+ *
+ * @param name          the metric name
+ *
+ * @return              the metric
+ */
+tb_metric_ref_t         tb_metrics_gauge(tb_char_t const* name);
+
+/*! get or register the histogram with the given name
+ *
+ * @param name          the metric name
+ *
+ * @return              the metric
+ */
+tb_metric_ref_t         tb_metrics_histogram(tb_char_t const* name);
+
+/*! the metric name
+ *
+ * @param metric        the metric
+ *
+ * @return              the metric name
+ */
+tb_char_t const*        tb_metrics_name(tb_metric_ref_t metric);
+
+/*! the metric type
+ *
+ * @param metric        the metric
+ *
+ * @return              the metric type
+ */
+tb_size_t               tb_metrics_type(tb_metric_ref_t metric);
+
+/*! add the given value to the counter or the gauge
+ *
+ * it only updates the shard of the current thread, so it's very cheap.
+ *
+ * @param metric        the counter or the gauge
+ * @param value         the added value, it can be negative for the gauge
+ */
+tb_void_t               tb_metrics_add(tb_metric_ref_t metric, tb_long_t value);
+
+/*! set the gauge value
+ *
+ * @note it's slower than tb_metrics_add(), because it need read all shards
+ *
+ * @param metric        the gauge
+ * @param value         the gauge value
+ */
+tb_void_t               tb_metrics_set(tb_metric_ref_t metric, tb_hong_t value);
+
+/*! record the given value to the histogram
+ *
+ * @param metric        the histogram
+ * @param value         the recorded value, e.g. the latency (us) or the size
+ */
+tb_void_t               tb_metrics_record(tb_metric_ref_t metric, tb_hize_t value);
+
+/*! get the aggregated value of all threads
+ *
+ * @param metric        the metric
+ *
+ * @return              the value of the counter or the gauge, the recorded count of the histogram
+ */
+tb_hong_t               tb_metrics_value(tb_metric_ref_t metric);
+
+/*! get the percentile of the histogram
+ *
+ * @param metric        the histogram
+ * @param percent       the percent in 1/100 percent, e.g. 5000: p50, 9990: p99.9
+ *
+ * @return              the percentile, it's the upper bound of the bucket and is clamped to the maximum value
+ */
+tb_hize_t               tb_metrics_percentile(tb_metric_ref_t metric, tb_size_t percent);
+
+/*! get the summary of the histogram
+ *
+ * @param metric        the histogram
+ * @param summary       the summary
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_metrics_summary(tb_metric_ref_t metric, tb_metrics_summary_ref_t summary);
+
+/*! clear all values of all metrics
+ *
+ * @note the values will be lost if they are being updated by other threads at the same time
+ */
+tb_void_t               tb_metrics_clear(tb_noarg_t);
+
+/*! dump all metrics
+ */
+tb_void_t               tb_metrics_dump(tb_noarg_t);
+
+#ifdef TB_CONFIG_MODULE_HAVE_OBJECT
+/*! write all metrics to the given url
+ *
+ * @code
+ * tb_metrics_writ_to_url("/tmp/metrics.json", TB_OBJECT_FORMAT_JSON);
+ * @endcode
+ *
+ * @param url           the url
+ * @param format        the object format, e.g. TB_OBJECT_FORMAT_JSON, TB_OBJECT_FORMAT_XML, ...
+ *
+ * @return              the writed size, failed: -1
+ */
+tb_long_t               tb_metrics_writ_to_url(tb_char_t const* url, tb_size_t format);
+
+/*! write all metrics to the given data buffer
+ *
+ * @param data          the data buffer
+ * @param size          the buffer size
+ * @param format        the object format, e.g. TB_OBJECT_FORMAT_JSON, TB_OBJECT_FORMAT_XML, ...
+ *
+ * @return              the writed size, failed: -1
+ */
+tb_long_t               tb_metrics_writ_to_data(tb_byte_t* data, tb_size_t size, tb_size_t format);
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -36,5 +36,6 @@
 #include "option.h"
 #include "singleton.h"
 #include "lock_profiler.h"
+#include "metrics.h"
 
 #endif
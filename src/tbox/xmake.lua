@@ -49,7 +49,7 @@ target("tbox")
 
     -- add the common source files
     add_files("*.c")
-    add_files("hash/bkdr.c", "hash/fnv32.c", "hash/adler32.c")
+    add_files("hash/bkdr.c", "hash/fnv32.c", "hash/adler32.c", "hash/xxhash.c", "hash/wyhash.c")
     add_files("math/**.c")
     add_files("libc/**.c|string/impl/**.c")
     add_files("utils/*.c|option.c")
@@ -123,12 +123,13 @@ target("tbox")
 
     -- add the source files for the zip module
     if has_config("zip") then
-        add_files("zip/**.c|gzip.c|zlib.c|zlibraw.c|lzsw.c")
+        add_files("zip/**.c|gzip.c|zlib.c|zlibraw.c|lzsw.c|parallel.c")
         add_files("stream/impl/filter/zip.c")
         if has_config("zlib") then
             add_files("zip/gzip.c")
             add_files("zip/zlib.c")
             add_files("zip/zlibraw.c")
+            add_files("zip/parallel.c")
         end
     end
 
@@ -47,6 +47,9 @@ static tb_long_t tb_zip_gzip_spak_deflate(tb_zip_ref_t zip, tb_static_stream_ref
     tb_zip_gzip_t* gzip = tb_zip_gzip_cast(zip);
     tb_assert_and_check_return_val(gzip && ist && ost, -1);
 
+    // deflate it in parallel?
+    if (gzip->parallel) return tb_zip_parallel_spak(gzip->parallel, ist, ost, sync);
+
     // the input stream, @note maybe null for flush the end data
     tb_byte_t* ip = ist->p;
     tb_byte_t* ie = ist->e;
@@ -101,11 +104,36 @@ static tb_long_t tb_zip_gzip_spak_inflate(tb_zip_ref_t zip, tb_static_stream_ref
     gzip->zstream.next_out = (Bytef*)op;
     gzip->zstream.avail_out = (uInt)(oe - op);
 
+    // the previous member has been finished? only the next gzip member can follow it, the trailing garbage will be ignored
+    if (gzip->member_end)
+    {
+        tb_check_return_val(*ip == 0x1f, -1);
+        gzip->member_end = tb_false;
+    }
+
     // inflate
     tb_int_t r = inflate(&gzip->zstream, !sync? Z_NO_FLUSH : Z_SYNC_FLUSH);
     tb_assertf_and_check_return_val(r == Z_OK || r == Z_STREAM_END, -1, "sync: %ld, error: %d", sync, r);
     tb_trace_d("inflate: %u => %u, sync: %ld", ie - ip, (tb_byte_t*)gzip->zstream.next_out - op, sync);
 
+    // the member has been finished? reset it for inflating the next member, e.g. the output of the parallel gzip or cat a.gz b.gz
+    while (r == Z_STREAM_END)
+    {
+        // no more input now? reset it later
+        if (!gzip->zstream.avail_in)
+        {
+            if (inflateReset(&gzip->zstream) == Z_OK) gzip->member_end = tb_true;
+            break;
+        }
+
+        // not the next member? ignore the trailing garbage
+        tb_check_break(*gzip->zstream.next_in == 0x1f && inflateReset(&gzip->zstream) == Z_OK);
+
+        // inflate the next member
+        r = inflate(&gzip->zstream, !sync? Z_NO_FLUSH : Z_SYNC_FLUSH);
+        tb_assertf_and_check_return_val(r == Z_OK || r == Z_STREAM_END || r == Z_BUF_ERROR, -1, "sync: %ld, error: %d", sync, r);
+    }
+
     // update
     ist->p = (tb_byte_t*)gzip->zstream.next_in;
     ost->p = (tb_byte_t*)gzip->zstream.next_out;
@@ -120,7 +148,7 @@ static tb_long_t tb_zip_gzip_spak_inflate(tb_zip_ref_t zip, tb_static_stream_ref
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
-tb_zip_ref_t tb_zip_gzip_init(tb_size_t action)
+tb_zip_ref_t tb_zip_gzip_init(tb_size_t action, tb_zip_option_t const* option)
 {
     // done
     tb_bool_t       ok = tb_false;
@@ -148,8 +176,14 @@ tb_zip_ref_t tb_zip_gzip_init(tb_size_t action)
             // init spak
             zip->base.spak = tb_zip_gzip_spak_deflate;
 
+            // init the parallel deflater if the threads count is specified
+            if (option && option->parallel > 1)
+            {
+                zip->parallel = tb_zip_parallel_init(TB_ZIP_ALGO_GZIP, option);
+                tb_assert_and_check_break(zip->parallel);
+            }
             // init zstream
-            if (deflateInit2(&((tb_zip_gzip_t*)zip)->zstream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) break;
+            else if (deflateInit2(&((tb_zip_gzip_t*)zip)->zstream, option && option->level? option->level : Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS + 16, 8, option? option->strategy : Z_DEFAULT_STRATEGY) != Z_OK) break;
         }
 
         // init action after initializing zstream
@@ -179,7 +213,11 @@ tb_void_t tb_zip_gzip_exit(tb_zip_ref_t zip)
 
     // exit zstream
     if (zip->action == TB_ZIP_ACTION_INFLATE) inflateEnd(&(gzip->zstream));
-    else if (zip->action == TB_ZIP_ACTION_DEFLATE) deflateEnd(&(gzip->zstream));
+    else if (zip->action == TB_ZIP_ACTION_DEFLATE)
+    {
+        if (gzip->parallel) tb_zip_parallel_exit(gzip->parallel);
+        else deflateEnd(&(gzip->zstream));
+    }
 
     // free it
     tb_free(gzip);
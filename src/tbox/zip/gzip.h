@@ -28,6 +28,7 @@
 #include "prefix.h"
 #ifdef TB_CONFIG_PACKAGE_HAVE_ZLIB
 #   include <zlib.h>
+#   include "parallel.h"
 #endif
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -48,6 +49,12 @@ typedef struct __tb_zip_gzip_t
     // the zstream
 #ifdef TB_CONFIG_PACKAGE_HAVE_ZLIB
     z_stream        zstream;
+
+    // the parallel deflater
+    tb_zip_parallel_ref_t parallel;
+
+    // the current member has been finished?
+    tb_bool_t       member_end;
 #endif
 
 }tb_zip_gzip_t;
@@ -59,10 +66,11 @@ typedef struct __tb_zip_gzip_t
 /* init gzip
  *
  * @param action    the action
+ * @param option    the zip option, maybe null
  *
  * @return          the zip
  */
-tb_zip_ref_t        tb_zip_gzip_init(tb_size_t action);
+tb_zip_ref_t        tb_zip_gzip_init(tb_size_t action, tb_zip_option_t const* option);
 
 /* exit gzip
  *
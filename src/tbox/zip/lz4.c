@@ -0,0 +1,781 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        lz4.c
+ * @ingroup     zip
+ *
+ */
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME                "lz4"
+#define TB_TRACE_MODULE_DEBUG               (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "lz4.h"
+#include "../utils/bits.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the frame magic
+#define TB_ZIP_LZ4_MAGIC                    (0x184d2204)
+
+// the skippable frame magic, 0x184d2a50 - 0x184d2a5f
+#define TB_ZIP_LZ4_MAGIC_SKIPPABLE          (0x184d2a50)
+
+// the frame flags
+#define TB_ZIP_LZ4_FLAG_VERSION             (0x40)
+#define TB_ZIP_LZ4_FLAG_BLOCK_INDEPENDENT   (0x20)
+#define TB_ZIP_LZ4_FLAG_BLOCK_CHECKSUM      (0x10)
+#define TB_ZIP_LZ4_FLAG_CONTENT_SIZE        (0x08)
+#define TB_ZIP_LZ4_FLAG_CONTENT_CHECKSUM    (0x04)
+#define TB_ZIP_LZ4_FLAG_DICTID              (0x01)
+
+// the block size id of deflating, 4: 64K
+#define TB_ZIP_LZ4_BLOCK_ID                 (4)
+
+// the block maxn of the given block size id, 4: 64K, 5: 256K, 6: 1M, 7: 4M
+#define TB_ZIP_LZ4_BLOCK_MAXN(id)           ((tb_size_t)1 << (8 + ((id) << 1)))
+
+// the uncompressed block flag of the block size
+#define TB_ZIP_LZ4_BLOCK_RAW                (0x80000000)
+
+// the history size of the dependent blocks
+#define TB_ZIP_LZ4_HISTORY                  (64 * 1024)
+
+// the hash bits
+#define TB_ZIP_LZ4_HASH_BITS                (12)
+
+// the minimum match size
+#define TB_ZIP_LZ4_MINMATCH                 (4)
+
+// the last literals size, the last 5 bytes are always literals
+#define TB_ZIP_LZ4_LASTLITERALS             (5)
+
+// the last match must start at least 12 bytes before the end of block
+#define TB_ZIP_LZ4_MFLIMIT                  (12)
+
+// the bound size of the compressed block
+#define TB_ZIP_LZ4_BOUND(size)              ((size) + ((size) / 255) + 16)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the lz4 frame state type
+typedef enum __tb_zip_lz4_state_e
+{
+    TB_ZIP_LZ4_STATE_MAGIC      = 0     //!< read the frame magic
+,   TB_ZIP_LZ4_STATE_DESC       = 1     //!< read the frame descriptor
+,   TB_ZIP_LZ4_STATE_SKIPSIZE   = 2     //!< read the size of the skippable frame
+,   TB_ZIP_LZ4_STATE_BSIZE      = 3     //!< read the block size
+,   TB_ZIP_LZ4_STATE_BDATA      = 4     //!< read the block data
+,   TB_ZIP_LZ4_STATE_FLUSH      = 5     //!< flush the output data
+,   TB_ZIP_LZ4_STATE_SKIP       = 6     //!< skip the checksum or the skippable frame
+,   TB_ZIP_LZ4_STATE_HEAD       = 7     //!< write the frame header
+,   TB_ZIP_LZ4_STATE_DATA       = 8     //!< write the blocks
+,   TB_ZIP_LZ4_STATE_END        = 9     //!< the end mark has been written
+
+}tb_zip_lz4_state_e;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static __tb_inline__ tb_zip_lz4_t* tb_zip_lz4_cast(tb_zip_ref_t zip)
+{
+    // check
+    tb_assert_and_check_return_val(zip && zip->algo == TB_ZIP_ALGO_LZ4, tb_null);
+
+    // cast it
+    return (tb_zip_lz4_t*)zip;
+}
+static __tb_inline__ tb_uint32_t tb_zip_lz4_rotl(tb_uint32_t x, tb_size_t r)
+{
+    return (x << r) | (x >> (32 - r));
+}
+static tb_uint32_t tb_zip_lz4_xxh32(tb_byte_t const* p, tb_size_t n)
+{
+    /* the xxh32 with zero seed, only for the frame descriptor
+     *
+     * the descriptor is less than 16 bytes, so we need not process the 16 bytes stripes
+     */
+    tb_assert(n < 16);
+    tb_uint32_t h = 0x165667b1 + (tb_uint32_t)n;
+    for (; n >= 4; p += 4, n -= 4)
+        h = tb_zip_lz4_rotl(h + tb_bits_get_u32_le(p) * 0xc2b2ae3d, 17) * 0x27d4eb2f;
+    for (; n; p++, n--)
+        h = tb_zip_lz4_rotl(h + *p * 0x165667b1, 11) * 0x9e3779b1;
+    h ^= h >> 15;
+    h *= 0x85ebca77;
+    h ^= h >> 13;
+    h *= 0xc2b2ae3d;
+    h ^= h >> 16;
+    return h;
+}
+static __tb_inline__ tb_size_t tb_zip_lz4_hash(tb_byte_t const* p)
+{
+    return (tb_size_t)((tb_bits_get_u32_le(p) * 2654435761U) >> (32 - TB_ZIP_LZ4_HASH_BITS));
+}
+static __tb_inline__ tb_byte_t* tb_zip_lz4_length(tb_byte_t* op, tb_size_t size)
+{
+    // write the extended length bytes
+    for (; size >= 255; size -= 255) *op++ = 255;
+    *op++ = (tb_byte_t)size;
+    return op;
+}
+static tb_size_t tb_zip_lz4_compress(tb_uint32_t* table, tb_size_t skip, tb_byte_t const* src, tb_size_t size, tb_byte_t* dst)
+{
+    // init
+    tb_byte_t const*    ip = src;
+    tb_byte_t const*    ie = src + size;
+    tb_byte_t const*    anchor = src;
+    tb_byte_t*          op = dst;
+
+    // too small? only literals
+    if (size > TB_ZIP_LZ4_MFLIMIT)
+    {
+        // the search limit and the match limit
+        tb_byte_t const* mflimit = ie - TB_ZIP_LZ4_MFLIMIT;
+        tb_byte_t const* matchlimit = ie - TB_ZIP_LZ4_LASTLITERALS;
+
+        // clear the hash table, all blocks are independent
+        tb_memset(table, 0, sizeof(tb_uint32_t) << TB_ZIP_LZ4_HASH_BITS);
+
+        // the first byte has not any match
+        table[tb_zip_lz4_hash(ip)] = 0;
+        ip++;
+
+        // done
+        tb_byte_t const* match;
+        while (1)
+        {
+            /* find a match
+             *
+             * the step will be increased after (1 << skip) failed attempts,
+             * so the uncompressible data can be skipped quickly
+             */
+            tb_size_t attempts = (tb_size_t)1 << skip;
+            while (1)
+            {
+                // no more match?
+                if (ip > mflimit) goto end;
+
+                // get the match candidate and update the hash table
+                tb_size_t h = tb_zip_lz4_hash(ip);
+                match = src + table[h];
+                table[h] = (tb_uint32_t)(ip - src);
+
+                // found?
+                if (match < ip && ip - match <= 0xffff && tb_bits_get_u32_ne(match) == tb_bits_get_u32_ne(ip)) break;
+
+                // next
+                ip += attempts++ >> skip;
+            }
+
+            // extend the match backward
+            while (ip > anchor && match > src && ip[-1] == match[-1])
+            {
+                ip--;
+                match--;
+            }
+
+            // write the literals length
+            tb_size_t   length = ip - anchor;
+            tb_byte_t*  token = op++;
+            if (length >= 15)
+            {
+                *token = 15 << 4;
+                op = tb_zip_lz4_length(op, length - 15);
+            }
+            else *token = (tb_byte_t)(length << 4);
+
+            // write the literals
+            tb_memcpy(op, anchor, length);
+            op += length;
+
+            // write the offset
+            tb_bits_set_u16_le(op, (tb_uint16_t)(ip - match));
+            op += 2;
+
+            // extend the match forward, compare 8 bytes at once
+            tb_byte_t const* start = ip;
+            ip += TB_ZIP_LZ4_MINMATCH;
+            match += TB_ZIP_LZ4_MINMATCH;
+            while (ip + 8 <= matchlimit)
+            {
+                tb_uint64_t diff = tb_bits_get_u64_le(ip) ^ tb_bits_get_u64_le(match);
+                if (diff)
+                {
+                    ip += tb_bits_cl0_u64_le(diff) >> 3;
+                    break;
+                }
+                ip += 8;
+                match += 8;
+            }
+            if (ip + 8 > matchlimit)
+            {
+                while (ip < matchlimit && *ip == *match)
+                {
+                    ip++;
+                    match++;
+                }
+            }
+
+            // write the match length
+            length = ip - start - TB_ZIP_LZ4_MINMATCH;
+            if (length >= 15)
+            {
+                *token |= 15;
+                op = tb_zip_lz4_length(op, length - 15);
+            }
+            else *token |= (tb_byte_t)length;
+
+            // next
+            anchor = ip;
+            if (ip > mflimit) break;
+
+            // update the hash table for the skipped position
+            table[tb_zip_lz4_hash(ip - 2)] = (tb_uint32_t)(ip - 2 - src);
+        }
+    }
+
+end:
+    {
+        // write the last literals
+        tb_size_t length = ie - anchor;
+        if (length >= 15)
+        {
+            *op++ = 15 << 4;
+            op = tb_zip_lz4_length(op, length - 15);
+        }
+        else *op++ = (tb_byte_t)(length << 4);
+        tb_memcpy(op, anchor, length);
+        op += length;
+    }
+
+    // ok
+    return op - dst;
+}
+static tb_long_t tb_zip_lz4_decompress(tb_byte_t const* ip, tb_size_t size, tb_byte_t const* base, tb_byte_t* op, tb_byte_t* oe)
+{
+    // init
+    tb_byte_t const*    ie = ip + size;
+    tb_byte_t*          ob = op;
+
+    // done
+    while (ip < ie)
+    {
+        // the token
+        tb_size_t token = *ip++;
+
+        // the literals length
+        tb_size_t n = token >> 4;
+        if (n == 15)
+        {
+            tb_size_t b;
+            do
+            {
+                tb_check_return_val(ip < ie, -1);
+                b = *ip++;
+                n += b;
+
+            } while (b == 255);
+        }
+
+        // copy the literals, copy 16 bytes directly for the short literals
+        if (n <= 16 && ie - ip >= 16 && oe - op >= 16) tb_memcpy(op, ip, 16);
+        else
+        {
+            tb_check_return_val(n <= (tb_size_t)(ie - ip) && n <= (tb_size_t)(oe - op), -1);
+            tb_memcpy(op, ip, n);
+        }
+        tb_check_return_val(n <= (tb_size_t)(ie - ip), -1);
+        ip += n;
+        op += n;
+
+        // the last sequence only has the literals
+        if (ip == ie) break;
+
+        // the offset
+        tb_check_return_val(ie - ip >= 2, -1);
+        tb_size_t offset = tb_bits_get_u16_le(ip);
+        ip += 2;
+        tb_check_return_val(offset && offset <= (tb_size_t)(op - base), -1);
+
+        // the match length
+        n = token & 15;
+        if (n == 15)
+        {
+            tb_size_t b;
+            do
+            {
+                tb_check_return_val(ip < ie, -1);
+                b = *ip++;
+                n += b;
+
+            } while (b == 255);
+        }
+        n += TB_ZIP_LZ4_MINMATCH;
+
+        // copy the match
+        tb_byte_t const* match = op - offset;
+        if (n <= 16 && offset >= 16 && oe - op >= 16) tb_memcpy(op, match, 16);
+        else
+        {
+            tb_check_return_val(n <= (tb_size_t)(oe - op), -1);
+            if (offset >= n) tb_memcpy(op, match, n);
+            else if (offset == 1) tb_memset(op, *match, n);
+            else
+            {
+                // the overlapped match, e.g. the repeated pattern
+                tb_size_t i;
+                for (i = 0; i < n; i++) op[i] = match[i];
+            }
+        }
+        op += n;
+    }
+
+    // ok
+    return op - ob;
+}
+static tb_void_t tb_zip_lz4_deflate_block(tb_zip_lz4_t* lz4)
+{
+    // compress the block
+    tb_size_t size = tb_zip_lz4_compress(lz4->table, lz4->skip, lz4->bdata, lz4->bsize, lz4->wdata + 4);
+
+    // uncompressible? store it directly
+    if (size >= lz4->bsize)
+    {
+        tb_bits_set_u32_le(lz4->wdata, (tb_uint32_t)lz4->bsize | TB_ZIP_LZ4_BLOCK_RAW);
+        tb_memcpy(lz4->wdata + 4, lz4->bdata, lz4->bsize);
+        size = lz4->bsize;
+    }
+    else tb_bits_set_u32_le(lz4->wdata, (tb_uint32_t)size);
+
+    // pending the output
+    lz4->wsize = 4 + size;
+    lz4->wpos  = 0;
+    lz4->bsize = 0;
+}
+static tb_long_t tb_zip_lz4_spak_deflate(tb_zip_ref_t zip, tb_static_stream_ref_t ist, tb_static_stream_ref_t ost, tb_long_t sync)
+{
+    // check
+    tb_zip_lz4_t* lz4 = tb_zip_lz4_cast(zip);
+    tb_assert_and_check_return_val(lz4 && ist && ost, -1);
+
+    // the output stream
+    tb_byte_t* op = ost->p;
+    tb_byte_t* oe = ost->e;
+    tb_assert_and_check_return_val(op && oe, -1);
+
+    // done
+    while (1)
+    {
+        // flush the pending output
+        if (lz4->wpos < lz4->wsize)
+        {
+            tb_size_t size = tb_min(lz4->wsize - lz4->wpos, (tb_size_t)(ost->e - ost->p));
+            tb_memcpy(ost->p, lz4->wdata + lz4->wpos, size);
+            ost->p += size;
+            lz4->wpos += size;
+            tb_check_break(lz4->wpos == lz4->wsize);
+        }
+
+        // end?
+        tb_check_break(lz4->state != TB_ZIP_LZ4_STATE_END);
+
+        // write the frame header: magic, flags, block size id and header checksum
+        if (lz4->state == TB_ZIP_LZ4_STATE_HEAD)
+        {
+            tb_byte_t* p = lz4->wdata;
+            tb_bits_set_u32_le(p, TB_ZIP_LZ4_MAGIC);
+            p[4] = TB_ZIP_LZ4_FLAG_VERSION | TB_ZIP_LZ4_FLAG_BLOCK_INDEPENDENT;
+            p[5] = TB_ZIP_LZ4_BLOCK_ID << 4;
+            p[6] = (tb_byte_t)(tb_zip_lz4_xxh32(p + 4, 2) >> 8);
+            lz4->wsize = 7;
+            lz4->wpos  = 0;
+            lz4->state = TB_ZIP_LZ4_STATE_DATA;
+            continue ;
+        }
+
+        // fill the input data to the block
+        tb_size_t left = ist->p? (tb_size_t)(ist->e - ist->p) : 0;
+        if (left)
+        {
+            tb_size_t size = tb_min(left, lz4->block_maxn - lz4->bsize);
+            tb_memcpy(lz4->bdata + lz4->bsize, ist->p, size);
+            ist->p += size;
+            lz4->bsize += size;
+
+            // compress it if the block is full
+            if (lz4->bsize == lz4->block_maxn) tb_zip_lz4_deflate_block(lz4);
+            continue ;
+        }
+
+        // no more input data now
+        tb_check_break(sync);
+
+        // sync or end? compress the left data
+        if (lz4->bsize)
+        {
+            tb_zip_lz4_deflate_block(lz4);
+            continue ;
+        }
+
+        // end? write the end mark
+        tb_check_break(sync < 0);
+        tb_bits_set_u32_le(lz4->wdata, 0);
+        lz4->wsize = 4;
+        lz4->wpos  = 0;
+        lz4->state = TB_ZIP_LZ4_STATE_END;
+    }
+
+    // end?
+    tb_check_return_val(lz4->state != TB_ZIP_LZ4_STATE_END || lz4->wpos < lz4->wsize || ost->p > op, -1);
+
+    // ok?
+    return (ost->p - op);
+}
+static tb_bool_t tb_zip_lz4_inflate_desc(tb_zip_lz4_t* lz4)
+{
+    // check the version and the header checksum
+    tb_byte_t const*    p = lz4->head;
+    tb_size_t           n = lz4->head_size;
+    tb_assertf_and_check_return_val((p[0] & 0xc0) == TB_ZIP_LZ4_FLAG_VERSION, tb_false, "invalid lz4 version: %x", p[0]);
+    tb_assertf_and_check_return_val(p[n - 1] == (tb_byte_t)(tb_zip_lz4_xxh32(p, n - 1) >> 8), tb_false, "invalid lz4 header checksum");
+
+    // get the block maxn
+    tb_size_t id = (p[1] >> 4) & 0x7;
+    tb_assertf_and_check_return_val(id >= 4, tb_false, "invalid lz4 block size id: %lu", id);
+    tb_size_t maxn = TB_ZIP_LZ4_BLOCK_MAXN(id);
+
+    // the dependent blocks need the 64K history data
+    lz4->flags = p[0];
+    tb_size_t wmaxn = (lz4->flags & TB_ZIP_LZ4_FLAG_BLOCK_INDEPENDENT)? maxn : TB_ZIP_LZ4_HISTORY + maxn;
+
+    // grow the block data
+    if (maxn > lz4->block_maxn)
+    {
+        lz4->bdata = (tb_byte_t*)tb_ralloc(lz4->bdata, maxn);
+        tb_assert_and_check_return_val(lz4->bdata, tb_false);
+        lz4->block_maxn = maxn;
+    }
+
+    // grow the window data
+    if (wmaxn > lz4->wmaxn)
+    {
+        lz4->wdata = (tb_byte_t*)tb_ralloc(lz4->wdata, wmaxn);
+        tb_assert_and_check_return_val(lz4->wdata, tb_false);
+        lz4->wmaxn = wmaxn;
+    }
+
+    // clear the history data of the previous frame
+    lz4->wsize = 0;
+    lz4->wpos  = 0;
+
+    // ok
+    return tb_true;
+}
+static tb_bool_t tb_zip_lz4_inflate_block(tb_zip_lz4_t* lz4, tb_byte_t const* data, tb_size_t size)
+{
+    // the independent blocks need not the history data
+    if (lz4->flags & TB_ZIP_LZ4_FLAG_BLOCK_INDEPENDENT) lz4->wsize = 0;
+    // keep the last 64K history data if no enough space
+    else if (lz4->wsize + lz4->block_maxn > lz4->wmaxn)
+    {
+        tb_memmov(lz4->wdata, lz4->wdata + lz4->wsize - TB_ZIP_LZ4_HISTORY, TB_ZIP_LZ4_HISTORY);
+        lz4->wsize = TB_ZIP_LZ4_HISTORY;
+    }
+
+    // decompress the block to the window
+    tb_byte_t* op = lz4->wdata + lz4->wsize;
+    if (lz4->block_raw) tb_memcpy(op, data, size);
+    else
+    {
+        tb_long_t real = tb_zip_lz4_decompress(data, size, lz4->wdata, op, op + lz4->block_maxn);
+        tb_assertf_and_check_return_val(real >= 0, tb_false, "invalid lz4 block data");
+        size = (tb_size_t)real;
+    }
+
+    // flush the decompressed data
+    lz4->wpos   = lz4->wsize;
+    lz4->wsize += size;
+    lz4->state  = TB_ZIP_LZ4_STATE_FLUSH;
+    return tb_true;
+}
+static tb_long_t tb_zip_lz4_spak_inflate(tb_zip_ref_t zip, tb_static_stream_ref_t ist, tb_static_stream_ref_t ost, tb_long_t sync)
+{
+    // check
+    tb_zip_lz4_t* lz4 = tb_zip_lz4_cast(zip);
+    tb_assert_and_check_return_val(lz4 && ist && ost, -1);
+
+    // the output stream
+    tb_byte_t* op = ost->p;
+    tb_byte_t* oe = ost->e;
+    tb_assert_and_check_return_val(op && oe, -1);
+
+    // done
+    while (1)
+    {
+        // flush the decompressed data
+        if (lz4->state == TB_ZIP_LZ4_STATE_FLUSH)
+        {
+            tb_size_t size = tb_min(lz4->wsize - lz4->wpos, (tb_size_t)(ost->e - ost->p));
+            tb_memcpy(ost->p, lz4->wdata + lz4->wpos, size);
+            ost->p += size;
+            lz4->wpos += size;
+            tb_check_break(lz4->wpos == lz4->wsize);
+
+            // skip the block checksum
+            if (lz4->flags & TB_ZIP_LZ4_FLAG_BLOCK_CHECKSUM)
+            {
+                lz4->state      = TB_ZIP_LZ4_STATE_SKIP;
+                lz4->state_next = TB_ZIP_LZ4_STATE_BSIZE;
+                lz4->need       = 4;
+            }
+            else
+            {
+                lz4->state      = TB_ZIP_LZ4_STATE_BSIZE;
+                lz4->need       = 4;
+            }
+            continue ;
+        }
+
+        // no more input data?
+        tb_size_t left = ist->p? (tb_size_t)(ist->e - ist->p) : 0;
+        tb_check_break(left);
+
+        // skip data
+        if (lz4->state == TB_ZIP_LZ4_STATE_SKIP)
+        {
+            tb_size_t size = tb_min(left, lz4->need);
+            ist->p += size;
+            lz4->need -= size;
+            if (!lz4->need)
+            {
+                lz4->state = lz4->state_next;
+                lz4->need  = 4;
+            }
+            continue ;
+        }
+
+        // read the block data
+        if (lz4->state == TB_ZIP_LZ4_STATE_BDATA)
+        {
+            // decompress it from the input data directly if the whole block is available
+            if (!lz4->bsize && left >= lz4->need)
+            {
+                if (!tb_zip_lz4_inflate_block(lz4, ist->p, lz4->need)) return -1;
+                ist->p += lz4->need;
+                continue ;
+            }
+
+            // cache the block data
+            tb_size_t size = tb_min(left, lz4->need - lz4->bsize);
+            tb_memcpy(lz4->bdata + lz4->bsize, ist->p, size);
+            ist->p += size;
+            lz4->bsize += size;
+            if (lz4->bsize == lz4->need)
+            {
+                lz4->bsize = 0;
+                if (!tb_zip_lz4_inflate_block(lz4, lz4->bdata, lz4->need)) return -1;
+            }
+            continue ;
+        }
+
+        // read the header data
+        tb_size_t size = tb_min(left, lz4->need - lz4->head_size);
+        tb_memcpy(lz4->head + lz4->head_size, ist->p, size);
+        ist->p += size;
+        lz4->head_size += size;
+        tb_check_continue(lz4->head_size == lz4->need);
+
+        // parse the header data
+        switch (lz4->state)
+        {
+        case TB_ZIP_LZ4_STATE_MAGIC:
+            {
+                // the frame magic
+                tb_uint32_t magic = tb_bits_get_u32_le(lz4->head);
+                if (magic == TB_ZIP_LZ4_MAGIC)
+                {
+                    lz4->state = TB_ZIP_LZ4_STATE_DESC;
+                    lz4->need  = 2;
+                }
+                // the skippable frame
+                else if ((magic & 0xfffffff0) == TB_ZIP_LZ4_MAGIC_SKIPPABLE)
+                {
+                    lz4->state = TB_ZIP_LZ4_STATE_SKIPSIZE;
+                    lz4->need  = 4;
+                }
+                else
+                {
+                    tb_trace_e("invalid lz4 magic: %x", magic);
+                    return -1;
+                }
+                lz4->head_size = 0;
+            }
+            break;
+        case TB_ZIP_LZ4_STATE_DESC:
+            {
+                // read the content size, dictionary id and header checksum after the flags and block descriptor
+                if (lz4->need == 2)
+                {
+                    tb_byte_t flags = lz4->head[0];
+                    lz4->need += ((flags & TB_ZIP_LZ4_FLAG_CONTENT_SIZE)? 8 : 0) + ((flags & TB_ZIP_LZ4_FLAG_DICTID)? 4 : 0) + 1;
+                    break;
+                }
+
+                // parse the frame descriptor
+                if (!tb_zip_lz4_inflate_desc(lz4)) return -1;
+                lz4->state      = TB_ZIP_LZ4_STATE_BSIZE;
+                lz4->need       = 4;
+                lz4->head_size  = 0;
+            }
+            break;
+        case TB_ZIP_LZ4_STATE_SKIPSIZE:
+            {
+                // skip the skippable frame
+                lz4->state      = TB_ZIP_LZ4_STATE_SKIP;
+                lz4->state_next = TB_ZIP_LZ4_STATE_MAGIC;
+                lz4->need       = tb_bits_get_u32_le(lz4->head);
+                lz4->head_size  = 0;
+                if (!lz4->need)
+                {
+                    lz4->state = TB_ZIP_LZ4_STATE_MAGIC;
+                    lz4->need  = 4;
+                }
+            }
+            break;
+        case TB_ZIP_LZ4_STATE_BSIZE:
+            {
+                // the end mark? skip the content checksum and read the next frame
+                tb_uint32_t bsize = tb_bits_get_u32_le(lz4->head);
+                lz4->head_size = 0;
+                if (!bsize)
+                {
+                    if (lz4->flags & TB_ZIP_LZ4_FLAG_CONTENT_CHECKSUM)
+                    {
+                        lz4->state      = TB_ZIP_LZ4_STATE_SKIP;
+                        lz4->state_next = TB_ZIP_LZ4_STATE_MAGIC;
+                    }
+                    else lz4->state = TB_ZIP_LZ4_STATE_MAGIC;
+                    lz4->need = 4;
+                    break;
+                }
+
+                // read the block data
+                lz4->block_raw  = (bsize & TB_ZIP_LZ4_BLOCK_RAW)? 1 : 0;
+                lz4->need       = bsize & ~TB_ZIP_LZ4_BLOCK_RAW;
+                lz4->bsize      = 0;
+                lz4->state      = TB_ZIP_LZ4_STATE_BDATA;
+                tb_assertf_and_check_return_val(lz4->need && lz4->need <= lz4->block_maxn, -1, "invalid lz4 block size: %lu", lz4->need);
+            }
+            break;
+        default:
+            tb_assert(0);
+            return -1;
+        }
+    }
+
+    // ok?
+    return (ost->p - op);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+tb_zip_ref_t tb_zip_lz4_init(tb_size_t action, tb_zip_option_t const* option)
+{
+    // done
+    tb_bool_t       ok = tb_false;
+    tb_zip_lz4_t*   zip = tb_null;
+    do
+    {
+        // make zip
+        zip = tb_malloc0_type(tb_zip_lz4_t);
+        tb_assert_and_check_break(zip);
+
+        // init algo
+        zip->base.algo = TB_ZIP_ALGO_LZ4;
+
+        // init it
+        if (action == TB_ZIP_ACTION_INFLATE)
+        {
+            // init spak
+            zip->base.spak = tb_zip_lz4_spak_inflate;
+
+            // init state, the block and window data will be allocated after reading the frame descriptor
+            zip->state = TB_ZIP_LZ4_STATE_MAGIC;
+            zip->need  = 4;
+        }
+        else if (action == TB_ZIP_ACTION_DEFLATE)
+        {
+            // init spak
+            zip->base.spak = tb_zip_lz4_spak_deflate;
+
+            // init state
+            zip->state      = TB_ZIP_LZ4_STATE_HEAD;
+            zip->skip       = (option && option->level == TB_ZIP_LEVEL_FASTEST)? 5 : 6;
+            zip->block_maxn = TB_ZIP_LZ4_BLOCK_MAXN(TB_ZIP_LZ4_BLOCK_ID);
+            zip->wmaxn      = 4 + TB_ZIP_LZ4_BOUND(zip->block_maxn);
+
+            // init the block data, the window data and the hash table
+            zip->bdata = tb_malloc_bytes(zip->block_maxn);
+            zip->wdata = tb_malloc_bytes(zip->wmaxn);
+            zip->table = tb_nalloc_type((tb_size_t)1 << TB_ZIP_LZ4_HASH_BITS, tb_uint32_t);
+            tb_assert_and_check_break(zip->bdata && zip->wdata && zip->table);
+        }
+        else break;
+
+        // init action
+        zip->base.action = (tb_uint16_t)action;
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        // exit it
+        if (zip) tb_zip_lz4_exit((tb_zip_ref_t)zip);
+        zip = tb_null;
+    }
+
+    // ok?
+    return (tb_zip_ref_t)zip;
+}
+tb_void_t tb_zip_lz4_exit(tb_zip_ref_t zip)
+{
+    // check
+    tb_zip_lz4_t* lz4 = tb_zip_lz4_cast(zip);
+    tb_assert_and_check_return(lz4);
+
+    // exit data
+    if (lz4->bdata) tb_free(lz4->bdata);
+    if (lz4->wdata) tb_free(lz4->wdata);
+    if (lz4->table) tb_free(lz4->table);
+
+    // free it
+    tb_free(lz4);
+}
@@ -0,0 +1,121 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        lz4.h
+ * @ingroup     zip
+ *
+ */
+#ifndef TB_ZIP_LZ4_H
+#define TB_ZIP_LZ4_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the lz4 zip type
+typedef struct __tb_zip_lz4_t
+{
+    // the zip base
+    tb_zip_t            base;
+
+    // the frame state
+    tb_uint16_t         state;
+
+    // the next state after skipping data
+    tb_uint16_t         state_next;
+
+    // the frame flags
+    tb_uint8_t          flags;
+
+    // the skip step of searching match, the smaller it is, the faster the uncompressible data is skipped
+    tb_uint8_t          skip;
+
+    // is the uncompressed block?
+    tb_uint8_t          block_raw;
+
+    // the header data
+    tb_byte_t           head[20];
+
+    // the header size
+    tb_size_t           head_size;
+
+    // the need size of the current state
+    tb_size_t           need;
+
+    // the maximum block size
+    tb_size_t           block_maxn;
+
+    // the block data, the input block for deflating and the compressed block for inflating
+    tb_byte_t*          bdata;
+
+    // the block size
+    tb_size_t           bsize;
+
+    // the window data, the output of the block and the 64K history data for the dependent blocks
+    tb_byte_t*          wdata;
+
+    // the window size
+    tb_size_t           wsize;
+
+    // the window maxn
+    tb_size_t           wmaxn;
+
+    // the pending output position in the window data
+    tb_size_t           wpos;
+
+    // the hash table for deflating
+    tb_uint32_t*        table;
+
+}tb_zip_lz4_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/* init lz4
+ *
+ * it writes and reads the standard lz4 frame format, so the output can be decompressed by the lz4 tool
+ *
+ * @param action    the action
+ * @param option    the zip option, maybe null
+ *
+ * @return          the zip
+ */
+tb_zip_ref_t        tb_zip_lz4_init(tb_size_t action, tb_zip_option_t const* option);
+
+/* exit lz4
+ *
+ * @param zip       the zip
+ */
+tb_void_t           tb_zip_lz4_exit(tb_zip_ref_t zip);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -0,0 +1,570 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        parallel.c
+ * @ingroup     zip
+ *
+ */
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME                "zip_parallel"
+#define TB_TRACE_MODULE_DEBUG               (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "parallel.h"
+#include "../platform/atomic.h"
+#include "../platform/semaphore.h"
+#include "../platform/thread_pool.h"
+#include <zlib.h>
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the default block size
+#ifdef __tb_small__
+#   define TB_ZIP_PARALLEL_BLOCK_SIZE       (64 * 1024)
+#else
+#   define TB_ZIP_PARALLEL_BLOCK_SIZE       (128 * 1024)
+#endif
+
+// the dictionary size, it is the maximum window size of deflate
+#define TB_ZIP_PARALLEL_DICT_SIZE           (32 * 1024)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the parallel block job type
+typedef struct __tb_zip_parallel_job_t
+{
+    // the input data, the dictionary data + the block data
+    tb_byte_t*                  idata;
+
+    // the dictionary size
+    tb_size_t                   dictsize;
+
+    // the block size
+    tb_size_t                   isize;
+
+    // the output data
+    tb_byte_t*                  odata;
+
+    // the output size
+    tb_size_t                   osize;
+
+    // the emitted output size
+    tb_size_t                   opos;
+
+    // the crc32 or adler32 of the block data
+    tb_uint32_t                 check;
+
+    // is the last block?
+    tb_bool_t                   last;
+
+    // the level
+    tb_int_t                    level;
+
+    // the strategy
+    tb_int_t                    strategy;
+
+    // is gzip? compute crc32 instead of adler32
+    tb_bool_t                   gzip;
+
+    // is ok?
+    tb_bool_t                   ok;
+
+    // is finished?
+    tb_atomic32_t               finished;
+
+    // the semaphore of the parallel deflater
+    tb_semaphore_ref_t          semaphore;
+
+}tb_zip_parallel_job_t;
+
+// the parallel deflater type
+typedef struct __tb_zip_parallel_t
+{
+    // the output format
+    tb_size_t                   algo;
+
+    // the level
+    tb_int_t                    level;
+
+    // the strategy
+    tb_int_t                    strategy;
+
+    // the block size
+    tb_size_t                   blocksize;
+
+    // the thread pool
+    tb_thread_pool_ref_t        pool;
+
+    // the semaphore to notify the finished jobs
+    tb_semaphore_ref_t          semaphore;
+
+    // the deflating jobs in order
+    tb_zip_parallel_job_t**     jobs;
+
+    // the first job index
+    tb_size_t                   jobs_head;
+
+    // the jobs count
+    tb_size_t                   jobs_size;
+
+    // the jobs maxn
+    tb_size_t                   jobs_maxn;
+
+    // the filling job
+    tb_zip_parallel_job_t*      filling;
+
+    // the dictionary, the last data of the previous block
+    tb_byte_t                   dict[TB_ZIP_PARALLEL_DICT_SIZE];
+
+    // the dictionary size
+    tb_size_t                   dictsize;
+
+    // the header or trailer data
+    tb_byte_t                   pending[16];
+
+    // the pending data size
+    tb_size_t                   pending_size;
+
+    // the emitted pending data size
+    tb_size_t                   pending_pos;
+
+    // the crc32 or adler32 of all emitted blocks
+    tb_uint32_t                 check;
+
+    // the total input size
+    tb_hize_t                   total;
+
+    // the last block has been posted?
+    tb_bool_t                   posted_last;
+
+    // all data have been emitted?
+    tb_bool_t                   finished;
+
+    // is failed?
+    tb_bool_t                   failed;
+
+}tb_zip_parallel_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_void_t tb_zip_parallel_job_done(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // check
+    tb_zip_parallel_job_t* job = (tb_zip_parallel_job_t*)priv;
+    tb_assert_and_check_return(job);
+
+    // init raw deflate stream
+    z_stream zstream;
+    tb_memset(&zstream, 0, sizeof(z_stream));
+    if (deflateInit2(&zstream, job->level, Z_DEFLATED, -MAX_WBITS, 8, job->strategy) != Z_OK) return ;
+
+    // done
+    do
+    {
+        // use the last data of the previous block as the dictionary
+        if (job->dictsize && deflateSetDictionary(&zstream, job->idata, (uInt)job->dictsize) != Z_OK) break;
+
+        // make the output data, the sync flush marker needs some more bytes
+        tb_size_t omaxn = deflateBound(&zstream, (uLong)job->isize) + 64;
+        job->odata = tb_malloc_bytes(omaxn);
+        tb_assert_and_check_break(job->odata);
+
+        // deflate it, the last block ends the stream and the other blocks are aligned to the byte by the sync flush
+        zstream.next_in     = (Bytef*)job->idata + job->dictsize;
+        zstream.avail_in    = (uInt)job->isize;
+        zstream.next_out    = (Bytef*)job->odata;
+        zstream.avail_out   = (uInt)omaxn;
+        tb_int_t r = deflate(&zstream, job->last? Z_FINISH : Z_SYNC_FLUSH);
+        tb_assertf_and_check_break(job->last? r == Z_STREAM_END : (r == Z_OK && !zstream.avail_in), "deflate block failed: %d", r);
+        job->osize = (tb_byte_t*)zstream.next_out - job->odata;
+
+        // compute the check value of the block data
+        tb_byte_t const* data = job->idata + job->dictsize;
+        job->check = job->gzip? (tb_uint32_t)crc32(0, data, (uInt)job->isize) : (tb_uint32_t)adler32(1, data, (uInt)job->isize);
+
+        // ok
+        job->ok = tb_true;
+
+    } while (0);
+
+    // exit zstream
+    deflateEnd(&zstream);
+}
+static tb_void_t tb_zip_parallel_job_exit(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // check
+    tb_zip_parallel_job_t* job = (tb_zip_parallel_job_t*)priv;
+    tb_assert_and_check_return(job);
+
+    // notify it, the job may be killed without done
+    tb_atomic32_set(&job->finished, 1);
+    tb_semaphore_post(job->semaphore, 1);
+}
+static tb_void_t tb_zip_parallel_job_free(tb_zip_parallel_job_t* job)
+{
+    if (job->idata) tb_free(job->idata);
+    if (job->odata) tb_free(job->odata);
+    tb_free(job);
+}
+static tb_bool_t tb_zip_parallel_job_make(tb_zip_parallel_t* parallel)
+{
+    // make job
+    tb_zip_parallel_job_t* job = tb_malloc0_type(tb_zip_parallel_job_t);
+    tb_assert_and_check_return_val(job, tb_false);
+
+    // make the input data
+    job->idata = tb_malloc_bytes(parallel->dictsize + parallel->blocksize);
+    if (!job->idata)
+    {
+        tb_free(job);
+        return tb_false;
+    }
+
+    // init job
+    job->dictsize   = parallel->dictsize;
+    job->level      = parallel->level;
+    job->strategy   = parallel->strategy;
+    job->gzip       = parallel->algo == TB_ZIP_ALGO_GZIP;
+    job->semaphore  = parallel->semaphore;
+    tb_atomic32_init(&job->finished, 0);
+    if (job->dictsize) tb_memcpy(job->idata, parallel->dict, job->dictsize);
+
+    // fill it
+    parallel->filling = job;
+    return tb_true;
+}
+static tb_void_t tb_zip_parallel_job_post(tb_zip_parallel_t* parallel, tb_bool_t last)
+{
+    // the filling job
+    tb_zip_parallel_job_t* job = parallel->filling;
+    tb_assert_and_check_return(job && parallel->jobs_size < parallel->jobs_maxn);
+    parallel->filling = tb_null;
+
+    // save the last data as the dictionary of the next block
+    tb_size_t size = job->dictsize + job->isize;
+    parallel->dictsize = tb_min(size, TB_ZIP_PARALLEL_DICT_SIZE);
+    tb_memcpy(parallel->dict, job->idata + size - parallel->dictsize, parallel->dictsize);
+
+    // append it to the jobs queue
+    job->last = last;
+    parallel->jobs[(parallel->jobs_head + parallel->jobs_size) % parallel->jobs_maxn] = job;
+    parallel->jobs_size++;
+    if (last) parallel->posted_last = tb_true;
+
+    // post it to the thread pool, deflate it directly if failed
+    if (!tb_thread_pool_task_post(parallel->pool, "zip_parallel", tb_zip_parallel_job_done, tb_zip_parallel_job_exit, job, tb_false))
+    {
+        tb_zip_parallel_job_done(tb_null, job);
+        tb_zip_parallel_job_exit(tb_null, job);
+    }
+}
+static tb_void_t tb_zip_parallel_job_wait(tb_zip_parallel_t* parallel)
+{
+    // wait the first job
+    tb_zip_parallel_job_t* job = parallel->jobs[parallel->jobs_head];
+    while (!tb_atomic32_get(&job->finished))
+        tb_semaphore_wait(parallel->semaphore, -1);
+}
+static tb_void_t tb_zip_parallel_trailer(tb_zip_parallel_t* parallel)
+{
+    // make the trailer
+    tb_byte_t* p = parallel->pending;
+    if (parallel->algo == TB_ZIP_ALGO_GZIP)
+    {
+        // crc32 and isize, little-endian
+        tb_bits_set_u32_le(p, parallel->check);
+        tb_bits_set_u32_le(p + 4, (tb_uint32_t)parallel->total);
+        parallel->pending_size = 8;
+    }
+    else
+    {
+        // adler32, big-endian
+        tb_bits_set_u32_be(p, parallel->check);
+        parallel->pending_size = 4;
+    }
+    parallel->pending_pos = 0;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_zip_parallel_ref_t tb_zip_parallel_init(tb_size_t algo, tb_zip_option_t const* option)
+{
+    // check
+    tb_assert_and_check_return_val(option && (algo == TB_ZIP_ALGO_GZIP || algo == TB_ZIP_ALGO_ZLIB), tb_null);
+
+    // done
+    tb_bool_t           ok = tb_false;
+    tb_zip_parallel_t*  parallel = tb_null;
+    do
+    {
+        // make parallel
+        parallel = tb_malloc0_type(tb_zip_parallel_t);
+        tb_assert_and_check_break(parallel);
+
+        // init parallel
+        parallel->algo      = algo;
+        parallel->level     = option->level? option->level : Z_DEFAULT_COMPRESSION;
+        parallel->strategy  = option->strategy;
+        parallel->blocksize = option->blocksize? tb_max(option->blocksize, TB_ZIP_PARALLEL_DICT_SIZE) : TB_ZIP_PARALLEL_BLOCK_SIZE;
+        parallel->jobs_maxn = tb_max(option->parallel, 1) << 1;
+        parallel->check     = algo == TB_ZIP_ALGO_GZIP? (tb_uint32_t)crc32(0, tb_null, 0) : (tb_uint32_t)adler32(0, tb_null, 0);
+
+        // init thread pool
+        parallel->pool = tb_thread_pool();
+        tb_assert_and_check_break(parallel->pool);
+
+        // init semaphore
+        parallel->semaphore = tb_semaphore_init(0);
+        tb_assert_and_check_break(parallel->semaphore);
+
+        // init jobs
+        parallel->jobs = tb_nalloc0_type(parallel->jobs_maxn, tb_zip_parallel_job_t*);
+        tb_assert_and_check_break(parallel->jobs);
+
+        // init header
+        tb_byte_t* p = parallel->pending;
+        if (algo == TB_ZIP_ALGO_GZIP)
+        {
+            // magic, deflate, no flags, no mtime, xfl and unix
+            p[0] = 0x1f;
+            p[1] = 0x8b;
+            p[2] = 8;
+            p[3] = 0;
+            tb_bits_set_u32_le(p + 4, 0);
+            p[8] = parallel->level == 9? 2 : (parallel->level == 1? 4 : 0);
+            p[9] = 3;
+            parallel->pending_size = 10;
+        }
+        else
+        {
+            // deflate with 32K window and the level flags
+            tb_size_t level = parallel->level < 0? 6 : parallel->level;
+            tb_size_t flags = level < 2? 0 : (level < 6? 1 : (level == 6? 2 : 3));
+            tb_uint16_t header = (tb_uint16_t)((0x78 << 8) | (flags << 6));
+            header += 31 - (header % 31);
+            tb_bits_set_u16_be(p, header);
+            parallel->pending_size = 2;
+        }
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        // exit it
+        if (parallel) tb_zip_parallel_exit((tb_zip_parallel_ref_t)parallel);
+        parallel = tb_null;
+    }
+
+    // ok?
+    return (tb_zip_parallel_ref_t)parallel;
+}
+tb_void_t tb_zip_parallel_exit(tb_zip_parallel_ref_t self)
+{
+    // check
+    tb_zip_parallel_t* parallel = (tb_zip_parallel_t*)self;
+    tb_assert_and_check_return(parallel);
+
+    // wait and free all posted jobs
+    while (parallel->jobs_size)
+    {
+        tb_zip_parallel_job_wait(parallel);
+        tb_zip_parallel_job_free(parallel->jobs[parallel->jobs_head]);
+        parallel->jobs_head = (parallel->jobs_head + 1) % parallel->jobs_maxn;
+        parallel->jobs_size--;
+    }
+
+    // free the filling job
+    if (parallel->filling) tb_zip_parallel_job_free(parallel->filling);
+    parallel->filling = tb_null;
+
+    // exit jobs
+    if (parallel->jobs) tb_free(parallel->jobs);
+    parallel->jobs = tb_null;
+
+    // exit semaphore
+    if (parallel->semaphore) tb_semaphore_exit(parallel->semaphore);
+    parallel->semaphore = tb_null;
+
+    // exit it
+    tb_free(parallel);
+}
+tb_long_t tb_zip_parallel_spak(tb_zip_parallel_ref_t self, tb_static_stream_ref_t ist, tb_static_stream_ref_t ost, tb_long_t sync)
+{
+    // check
+    tb_zip_parallel_t* parallel = (tb_zip_parallel_t*)self;
+    tb_assert_and_check_return_val(parallel && ist && ost && !parallel->failed, -1);
+
+    // the output stream
+    tb_byte_t* op = ost->p;
+    tb_byte_t* oe = ost->e;
+    tb_assert_and_check_return_val(op && oe, -1);
+
+    // end?
+    tb_check_return_val(!parallel->finished, -1);
+
+    // done
+    while (1)
+    {
+        // emit the header or trailer
+        if (parallel->pending_pos < parallel->pending_size)
+        {
+            tb_size_t size = tb_min(parallel->pending_size - parallel->pending_pos, (tb_size_t)(ost->e - ost->p));
+            tb_memcpy(ost->p, parallel->pending + parallel->pending_pos, size);
+            ost->p += size;
+            parallel->pending_pos += size;
+            tb_check_break(parallel->pending_pos == parallel->pending_size);
+
+            // the trailer has been emitted?
+            if (parallel->posted_last && !parallel->jobs_size)
+            {
+                parallel->finished = tb_true;
+                break;
+            }
+        }
+
+        // emit the finished jobs in order
+        tb_bool_t full = tb_false;
+        while (parallel->jobs_size)
+        {
+            // finished?
+            tb_zip_parallel_job_t* job = parallel->jobs[parallel->jobs_head];
+            tb_check_break(tb_atomic32_get(&job->finished));
+
+            // failed?
+            if (!job->ok)
+            {
+                parallel->failed = tb_true;
+                return -1;
+            }
+
+            // emit it
+            tb_size_t size = tb_min(job->osize - job->opos, (tb_size_t)(ost->e - ost->p));
+            tb_memcpy(ost->p, job->odata + job->opos, size);
+            ost->p += size;
+            job->opos += size;
+            if (job->opos < job->osize)
+            {
+                full = tb_true;
+                break;
+            }
+
+            // combine the check value
+            if (parallel->algo == TB_ZIP_ALGO_GZIP)
+                parallel->check = (tb_uint32_t)crc32_combine(parallel->check, job->check, (z_off_t)job->isize);
+            else parallel->check = (tb_uint32_t)adler32_combine(parallel->check, job->check, (z_off_t)job->isize);
+            parallel->total += job->isize;
+
+            // free it
+            tb_zip_parallel_job_free(job);
+            parallel->jobs_head = (parallel->jobs_head + 1) % parallel->jobs_maxn;
+            parallel->jobs_size--;
+        }
+        tb_check_break(!full);
+
+        // all blocks have been emitted? emit the trailer
+        if (parallel->posted_last)
+        {
+            if (!parallel->jobs_size)
+            {
+                tb_zip_parallel_trailer(parallel);
+                continue ;
+            }
+
+            // wait the remaining blocks
+            tb_zip_parallel_job_wait(parallel);
+            continue ;
+        }
+
+        // fill the input data to the block
+        tb_size_t left = ist->p? (tb_size_t)(ist->e - ist->p) : 0;
+        if (left)
+        {
+            // too many deflating blocks? wait the first block
+            if (!parallel->filling && parallel->jobs_size == parallel->jobs_maxn)
+            {
+                tb_zip_parallel_job_wait(parallel);
+                continue ;
+            }
+
+            // make the filling job
+            if (!parallel->filling && !tb_zip_parallel_job_make(parallel))
+            {
+                parallel->failed = tb_true;
+                return -1;
+            }
+
+            // fill it
+            tb_zip_parallel_job_t* job = parallel->filling;
+            tb_size_t size = tb_min(left, parallel->blocksize - job->isize);
+            tb_memcpy(job->idata + job->dictsize + job->isize, ist->p, size);
+            ist->p += size;
+            job->isize += size;
+
+            // post it if the block is full
+            if (job->isize == parallel->blocksize)
+            {
+                if (parallel->jobs_size == parallel->jobs_maxn) tb_zip_parallel_job_wait(parallel);
+                else tb_zip_parallel_job_post(parallel, tb_false);
+            }
+            continue ;
+        }
+
+        // no more input data now
+        tb_check_break(sync);
+
+        // sync or end? post the filling block
+        if (parallel->filling || sync < 0)
+        {
+            // too many deflating blocks? wait the first block
+            if (parallel->jobs_size == parallel->jobs_maxn)
+            {
+                tb_zip_parallel_job_wait(parallel);
+                continue ;
+            }
+
+            // post the filling block, it may be empty for ending the stream
+            if (!parallel->filling && !tb_zip_parallel_job_make(parallel))
+            {
+                parallel->failed = tb_true;
+                return -1;
+            }
+            tb_zip_parallel_job_post(parallel, sync < 0);
+            continue ;
+        }
+
+        // sync, wait all deflating blocks
+        tb_check_break(parallel->jobs_size);
+        tb_zip_parallel_job_wait(parallel);
+    }
+
+    // ok?
+    return (ost->p - op);
+}
@@ -0,0 +1,81 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        parallel.h
+ * @ingroup     zip
+ *
+ */
+#ifndef TB_ZIP_PARALLEL_H
+#define TB_ZIP_PARALLEL_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the parallel deflater ref type
+typedef __tb_typeref__(zip_parallel);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/* init the parallel deflater
+ *
+ * the input data is split to the blocks and they are deflated in the thread pool,
+ * each block uses the last 32K data of the previous block as the dictionary,
+ * and ends with the sync flush, so all blocks can be concatenated to a valid deflate stream.
+ *
+ * @param algo      the output format, TB_ZIP_ALGO_GZIP or TB_ZIP_ALGO_ZLIB
+ * @param option    the zip option
+ *
+ * @return          the parallel deflater
+ */
+tb_zip_parallel_ref_t   tb_zip_parallel_init(tb_size_t algo, tb_zip_option_t const* option);
+
+/* exit the parallel deflater, it will wait all deflating blocks
+ *
+ * @param parallel  the parallel deflater
+ */
+tb_void_t               tb_zip_parallel_exit(tb_zip_parallel_ref_t parallel);
+
+/* spak the parallel deflater
+ *
+ * @param parallel  the parallel deflater
+ * @param ist       the input stream
+ * @param ost       the output stream
+ * @param sync      sync? 1: sync, 0: no sync, -1: end
+ *
+ * @return          > 0: the output size, 0: continue, -1: end
+ */
+tb_long_t               tb_zip_parallel_spak(tb_zip_parallel_ref_t parallel, tb_static_stream_ref_t ist, tb_static_stream_ref_t ost, tb_long_t sync);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
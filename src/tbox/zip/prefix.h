@@ -48,9 +48,47 @@ typedef enum __tb_zip_algo_t
 ,   TB_ZIP_ALGO_ZLIBRAW     = 1     //!< zlib: raw inflate & deflate
 ,   TB_ZIP_ALGO_ZLIB        = 2     //!< zlib
 ,   TB_ZIP_ALGO_GZIP        = 3     //!< gnu zip
+,   TB_ZIP_ALGO_LZ4         = 4     //!< lz4 frame, the fast codec without zlib
 
 }tb_zip_algo_t;
 
+/// the zip level type
+typedef enum __tb_zip_level_t
+{
+    TB_ZIP_LEVEL_DEFAULT    = 0     //!< the default level of the algorithm
+,   TB_ZIP_LEVEL_FASTEST    = 1     //!< the fastest level
+,   TB_ZIP_LEVEL_BEST       = 9     //!< the best compression level
+
+}tb_zip_level_t;
+
+/// the zip strategy type, only for zlib
+typedef enum __tb_zip_strategy_t
+{
+    TB_ZIP_STRATEGY_DEFAULT = 0     //!< the default strategy
+,   TB_ZIP_STRATEGY_FILTERED= 1     //!< for the data produced by a filter or predictor
+,   TB_ZIP_STRATEGY_HUFFMAN = 2     //!< huffman only, no string match
+,   TB_ZIP_STRATEGY_RLE     = 3     //!< limit match distances to one, run-length encoding
+,   TB_ZIP_STRATEGY_FIXED   = 4     //!< use the fixed huffman codes
+
+}tb_zip_strategy_t;
+
+/// the zip option type
+typedef struct __tb_zip_option_t
+{
+    /// the compression level, 1 .. 9 or TB_ZIP_LEVEL_DEFAULT, lz4 only skips the uncompressible data faster for TB_ZIP_LEVEL_FASTEST
+    tb_uint8_t              level;
+
+    /// the compression strategy, e.g. TB_ZIP_STRATEGY_RLE
+    tb_uint8_t              strategy;
+
+    /// the threads count of the parallel deflating, 0 or 1: disable, only for zlib and gzip
+    tb_uint16_t             parallel;
+
+    /// the block size of the parallel deflating, 0: default
+    tb_uint32_t             blocksize;
+
+}tb_zip_option_t;
+
 // the zip type
 typedef struct __tb_zip_t
 {
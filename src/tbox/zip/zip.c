@@ -26,15 +26,20 @@
 #include "gzip.h"
 #include "zlib.h"
 #include "zlibraw.h"
+#include "lz4.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
 
 tb_zip_ref_t tb_zip_init(tb_size_t algo, tb_size_t action)
+{
+    return tb_zip_init_with_option(algo, action, tb_null);
+}
+tb_zip_ref_t tb_zip_init_with_option(tb_size_t algo, tb_size_t action, tb_zip_option_t const* option)
 {
     // table
-    static tb_zip_ref_t (*s_init[])(tb_size_t action) =
+    static tb_zip_ref_t (*s_init[])(tb_size_t action, tb_zip_option_t const* option) =
     {
         tb_null
 #ifdef TB_CONFIG_PACKAGE_HAVE_ZLIB
@@ -46,11 +51,12 @@ tb_zip_ref_t tb_zip_init(tb_size_t algo, tb_size_t action)
     ,   tb_null
     ,   tb_null
 #endif
+    ,   tb_zip_lz4_init
     };
     tb_assert_and_check_return_val(algo < tb_arrayn(s_init) && s_init[algo], tb_null);
 
     // init
-    return s_init[algo](action);
+    return s_init[algo](action, option);
 }
 tb_void_t tb_zip_exit(tb_zip_ref_t zip)
 {
@@ -70,6 +76,7 @@ tb_void_t tb_zip_exit(tb_zip_ref_t zip)
     ,   tb_null
     ,   tb_null
 #endif
+    ,   tb_zip_lz4_exit
     };
     tb_assert_and_check_return(zip->algo < tb_arrayn(s_exit) && s_exit[zip->algo]);
 
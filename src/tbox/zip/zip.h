@@ -44,6 +44,23 @@ __tb_extern_c_enter__
  */
 tb_zip_ref_t        tb_zip_init(tb_size_t algo, tb_size_t action);
 
+/*! init zip with the given option
+ *
+ * @code
+ *  tb_zip_option_t option = {0};
+ *  option.level    = TB_ZIP_LEVEL_FASTEST;
+ *  option.parallel = (tb_uint16_t)tb_cpu_count();
+ *  tb_zip_ref_t zip = tb_zip_init_with_option(TB_ZIP_ALGO_GZIP, TB_ZIP_ACTION_DEFLATE, &option);
+ * @endcode
+ *
+ * @param algo      the zip zlgo
+ * @param action    the zip action
+ * @param option    the zip option, use the default option if be null
+ *
+ * @return          the zip
+ */
+tb_zip_ref_t        tb_zip_init_with_option(tb_size_t algo, tb_size_t action, tb_zip_option_t const* option);
+
 /*! exit zip
  *
  * @param zip       the zip
@@ -44,6 +44,9 @@ static tb_long_t tb_zip_zlib_spak_deflate(tb_zip_ref_t zip, tb_static_stream_ref
     tb_zip_zlib_t* zlib = tb_zip_zlib_cast(zip);
     tb_assert_and_check_return_val(zlib && ist && ost, -1);
 
+    // deflate it in parallel?
+    if (zlib->parallel) return tb_zip_parallel_spak(zlib->parallel, ist, ost, sync);
+
     // the input stream
     tb_byte_t* ip = ist->p;
     tb_byte_t* ie = ist->e;
@@ -117,7 +120,7 @@ static tb_long_t tb_zip_zlib_spak_inflate(tb_zip_ref_t zip, tb_static_stream_ref
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
-tb_zip_ref_t tb_zip_zlib_init(tb_size_t action)
+tb_zip_ref_t tb_zip_zlib_init(tb_size_t action, tb_zip_option_t const* option)
 {
     // done
     tb_bool_t       ok = tb_false;
@@ -146,7 +149,12 @@ tb_zip_ref_t tb_zip_zlib_init(tb_size_t action)
             zip->base.spak = tb_zip_zlib_spak_deflate;
 
             // init zstream
-            if (deflateInit(&((tb_zip_zlib_t*)zip)->zstream, Z_DEFAULT_COMPRESSION) != Z_OK) break;
+            if (option && option->parallel > 1)
+            {
+                zip->parallel = tb_zip_parallel_init(TB_ZIP_ALGO_ZLIB, option);
+                tb_assert_and_check_break(zip->parallel);
+            }
+            else if (deflateInit2(&((tb_zip_zlib_t*)zip)->zstream, option && option->level? option->level : Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS, 8, option? option->strategy : Z_DEFAULT_STRATEGY) != Z_OK) break;
         }
 
         // init action after initializing zstream
@@ -176,7 +184,11 @@ tb_void_t tb_zip_zlib_exit(tb_zip_ref_t zip)
 
     // exit zstream
     if (zip->action == TB_ZIP_ACTION_INFLATE) inflateEnd(&(zlib->zstream));
-    else if (zip->action == TB_ZIP_ACTION_DEFLATE) deflateEnd(&(zlib->zstream));
+    else if (zip->action == TB_ZIP_ACTION_DEFLATE)
+    {
+        if (zlib->parallel) tb_zip_parallel_exit(zlib->parallel);
+        else deflateEnd(&(zlib->zstream));
+    }
 
     // free it
     tb_free(zlib);
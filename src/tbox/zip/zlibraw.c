@@ -116,7 +116,7 @@ static tb_long_t tb_zip_zlibraw_spak_inflate(tb_zip_ref_t zip, tb_static_stream_
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
-tb_zip_ref_t tb_zip_zlibraw_init(tb_size_t action)
+tb_zip_ref_t tb_zip_zlibraw_init(tb_size_t action, tb_zip_option_t const* option)
 {
     // done
     tb_bool_t           ok = tb_false;
@@ -145,7 +145,7 @@ tb_zip_ref_t tb_zip_zlibraw_init(tb_size_t action)
             zip->base.spak = tb_zip_zlibraw_spak_deflate;
 
             // init zstream
-            if (deflateInit(&((tb_zip_zlibraw_t*)zip)->zstream, Z_DEFAULT_COMPRESSION) != Z_OK) break;
+            if (deflateInit2(&((tb_zip_zlibraw_t*)zip)->zstream, option && option->level? option->level : Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS, 8, option? option->strategy : Z_DEFAULT_STRATEGY) != Z_OK) break;
         }
 
         // init action after initializing zstream
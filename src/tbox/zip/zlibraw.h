@@ -59,10 +59,11 @@ typedef struct __tb_zip_zlibraw_t
 /* init zlibraw
  *
  * @param action    the action
+ * @param option    the zip option, maybe null
  *
  * @return          the zip
  */
-tb_zip_ref_t        tb_zip_zlibraw_init(tb_size_t action);
+tb_zip_ref_t        tb_zip_zlibraw_init(tb_size_t action, tb_zip_option_t const* option);
 
 /* exit zlibraw
  *
@@ -265,7 +265,9 @@ function check_interfaces()
             "pthread_key_delete",
             "pthread_setaffinity_np") -- need _GNU_SOURCE
         check_module_cfuncs("posix", {"sys/socket.h", "fcntl.h"},        "socket")
+        check_module_cfuncs("posix", "sys/socket.h",                     "sendmmsg", "recvmmsg") -- need _GNU_SOURCE
         check_module_cfuncs("posix", "dirent.h",                         "opendir")
+        check_module_cfuncs("posix", {"sys/stat.h", "fcntl.h", "dirent.h"}, "openat", "fstatat", "fstatat64", "fdopendir")
         check_module_cfuncs("posix", "dlfcn.h",                          "dlopen")
         check_module_cfuncs("posix", {"sys/stat.h", "fcntl.h"},          "open", "stat64")
         check_module_cfuncs("posix", "unistd.h",                         "gethostname")
@@ -279,7 +281,10 @@ function check_interfaces()
         check_module_cfuncs("posix", "unistd.h",                         "fdatasync")
         check_module_cfuncs("posix", "copyfile.h",                       "copyfile")
         check_module_cfuncs("posix", "sys/sendfile.h",                   "sendfile")
+        check_module_cfuncs("posix", "unistd.h",                         "copy_file_range") -- need _GNU_SOURCE
+        check_module_cfuncs("posix", "fcntl.h",                          "splice") -- need _GNU_SOURCE
         check_module_cfuncs("posix", "sys/epoll.h",                      "epoll_create", "epoll_wait")
+        check_module_cfuncs("posix", "sys/eventfd.h",                    "eventfd")
         check_module_cfuncs("posix", "spawn.h",                          "posix_spawnp", "posix_spawn_file_actions_addchdir_np")
         check_module_cfuncs("posix", "unistd.h",                         "execvp", "execvpe", "fork", "vfork")
         check_module_cfuncs("posix", "sys/wait.h",                       "waitpid")
@@ -289,7 +294,7 @@ function check_interfaces()
         check_module_cfuncs("posix", "fcntl.h",                          "fcntl")
         check_module_cfuncs("posix", "unistd.h",                         "pipe", "pipe2")
         check_module_cfuncs("posix", "sys/stat.h",                       "mkfifo")
-        check_module_cfuncs("posix", "sys/mman.h",                       "mmap")
+        check_module_cfuncs("posix", "sys/mman.h",                       "mmap", "madvise")
     end
 
     -- add the interfaces for windows/msvc